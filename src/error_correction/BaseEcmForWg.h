@@ -106,6 +106,10 @@ class BaseEcmForWg
       // corresponds to the score of a complete correction of the
       // prefix.
 
+  virtual Score obtainLastScrFromEsi(const EcmScoreInfo& esi)=0;
+      // Returns the last score of the vector returned by
+      // obtainScrVecFromEsi() without building the vector
+
   virtual void updateEsiPositions(const EcmScoreInfo& esi1,
                                   const std::vector<unsigned int>& posVec,
                                   EcmScoreInfo& esi2)=0;
@@ -119,6 +123,22 @@ class BaseEcmForWg
 
   virtual void removeLastPosFromEsi(EcmScoreInfo& esi)=0;
       // Removes last position from the EcmScoreInfo object "esi".
+
+  virtual void getLastPosFromEsi(const EcmScoreInfo& esi,
+                                 EcmScoreInfo& lastPosEsi)=0;
+      // Stores the last position of the EcmScoreInfo object "esi" in
+      // "lastPosEsi", so that it can be appended later by means of the
+      // appendPosToEsi() function
+
+  virtual void appendPosToEsi(const EcmScoreInfo& lastPosEsi,
+                              EcmScoreInfo& esi)=0;
+      // Appends the position stored by getLastPosFromEsi() to the
+      // EcmScoreInfo object "esi"
+
+  virtual void appendPrunedPosToEsi(EcmScoreInfo& esi)=0;
+      // Appends a position to the EcmScoreInfo object "esi" for a
+      // hypothesis that has been pruned. The score of the new position
+      // is equal to SMALL_SCORE
   
       // Destructor
   virtual ~BaseEcmForWg(){};
@@ -31,6 +31,15 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- BaseErrorCorrectionModel template class method definitions
 
+//---------------------------------
+Score BaseErrorCorrectionModel::similarityGivenPrefixCorr(const std::vector<std::string>& x,
+                                                          const std::vector<std::string>& y,
+                                                          std::vector<std::string>& correctedStrVec)
+{
+  correctStrGivenPref(x,y,correctedStrVec);
+  return similarityGivenPrefix(x,y);
+}
+
 //---------------------------------
 int BaseErrorCorrectionModel::trainStrPair(const char* /*x*/,
                                            const char* /*y*/,
@@ -84,6 +84,13 @@ class BaseErrorCorrectionModel
                                    std::vector<std::string>& correctedStrVec)=0;
       // Corrects string 'uncorrStrVec' given the prefix 'prefStrVec'
       // storing the results in 'correctedStrVec'
+  virtual Score similarityGivenPrefixCorr(const std::vector<std::string>& x,
+                                          const std::vector<std::string>& y,
+                                          std::vector<std::string>& correctedStrVec);
+      // Calculates similarity between x and y, where y is taken as a
+      // prefix, and corrects x given y storing the results in
+      // 'correctedStrVec'. Derived classes may obtain both results
+      // from a single alignment
   
       // Model weights functions
   virtual void setWeights(std::vector<float> wVec)=0;
@@ -18,12 +18,91 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
  
 #include "EditDistForVecString.h"
 
+//--------------- Global variables -----------------------------------
+
+namespace
+{
+  pthread_once_t calcDataKeyOnce=PTHREAD_ONCE_INIT;
+  pthread_key_t calcDataKey;
+
+      // Live instances given their identifiers, they are protected by
+      // calcDataRegistryMut together with the calcDataSet member of
+      // each instance
+  pthread_mutex_t calcDataRegistryMut=PTHREAD_MUTEX_INITIALIZER;
+  std::map<unsigned long,EditDistForVecString*> instanceMap;
+  unsigned long nextInstanceId=1;
+}
 
 //--------------- EditDistForVecString function definitions
 
 //---------------------------------------
 EditDistForVecString::EditDistForVecString(void):EditDistForVec<std::string>()
 {
+  errorModelVersion=1;
+  pthread_once(&calcDataKeyOnce,EditDistForVecString::createKey);
+
+  pthread_mutex_lock(&calcDataRegistryMut);
+  instanceId=nextInstanceId++;
+  instanceMap[instanceId]=this;
+  pthread_mutex_unlock(&calcDataRegistryMut);
+}
+
+//---------------------------------------
+void EditDistForVecString::createKey(void)
+{
+      // A single key is used for all the instances
+  pthread_key_create(&calcDataKey,EditDistForVecString::destroyThreadCalcData);
+}
+
+//---------------------------------------
+void EditDistForVecString::destroyThreadCalcData(void* threadCalcDataPtr)
+{
+  ThreadCalcDataMap* tcdMapPtr=static_cast<ThreadCalcDataMap*>(threadCalcDataPtr);
+
+      // The data of the instances that were already destroyed was
+      // deleted by their destructors
+  pthread_mutex_lock(&calcDataRegistryMut);
+  for(ThreadCalcDataMap::iterator iter=tcdMapPtr->begin();iter!=tcdMapPtr->end();++iter)
+  {
+    std::map<unsigned long,EditDistForVecString*>::iterator instIter=instanceMap.find(iter->first);
+    if(instIter!=instanceMap.end())
+    {
+      instIter->second->calcDataSet.erase(iter->second);
+      delete iter->second;
+    }
+  }
+  pthread_mutex_unlock(&calcDataRegistryMut);
+  delete tcdMapPtr;
+}
+
+//---------------------------------------
+EditDistForVecString::CalcData& EditDistForVecString::getCalcData(void)
+{
+  ThreadCalcDataMap* tcdMapPtr=static_cast<ThreadCalcDataMap*>(pthread_getspecific(calcDataKey));
+  if(tcdMapPtr==NULL)
+  {
+    tcdMapPtr=new ThreadCalcDataMap;
+    pthread_setspecific(calcDataKey,tcdMapPtr);
+  }
+
+  CalcData*& calcDataPtr=(*tcdMapPtr)[instanceId];
+  if(calcDataPtr==NULL)
+  {
+    calcDataPtr=new CalcData;
+    pthread_mutex_lock(&calcDataRegistryMut);
+    calcDataSet.insert(calcDataPtr);
+    pthread_mutex_unlock(&calcDataRegistryMut);
+  }
+  
+      // Cached costs are no longer valid if the error model changed
+  unsigned int currVersion=errorModelVersion;
+  if(calcDataPtr->errorModelVersion!=currVersion)
+  {
+    calcDataPtr->substCostCache.clear();
+    calcDataPtr->prefSubstCostCache.clear();
+    calcDataPtr->errorModelVersion=currVersion;
+  }
+  return *calcDataPtr;
 }
 
 //---------------------------------------
@@ -42,7 +121,27 @@ Score EditDistForVecString::calculateEditDist(const std::vector<std::string>& x,
   addBlankCharacters(yVec);
 #endif
 
-  return EditDistForVec<std::string>::calculateEditDist(xVec,yVec,verbose);
+  CalcData& cd=getCalcData();
+  clearCachesIfRequired(cd);
+  
+      // Obtain word identifiers
+  std::vector<unsigned int> xIdVec;
+  std::vector<unsigned int> yIdVec;
+  wordVecToIdVec(cd,xVec,xIdVec);
+  wordVecToIdVec(cd,yVec,yIdVec);
+
+      // Fill edit distance matrix
+  Score dist=fillDistMatrix(cd,xIdVec,yIdVec,true,DONT_USE_PREF_DEL_OP);
+
+      // If verbose, print distance matrix
+  if(verbose)
+  {
+    DistMatrix dm;
+    obtainDistMatrix(cd,xVec.size(),yVec.size(),dm);
+    printDistMatrix(xVec,yVec,dm,std::cerr);
+  }
+
+  return dist;
 }
 
 //---------------------------------------
@@ -109,25 +208,21 @@ Score EditDistForVecString::calculateEditDistPrefixOpsAux(const std::vector<std:
   addBlankCharacters(yVec);
 #endif
 
-  DistMatrix dm;
-  initDm(xVec,yVec,dm);
+  CalcData& cd=getCalcData();
+  clearCachesIfRequired(cd);
+  
+      // Obtain word identifiers
+  std::vector<unsigned int> xIdVec;
+  std::vector<unsigned int> yIdVec;
+  wordVecToIdVec(cd,xVec,xIdVec);
+  wordVecToIdVec(cd,yVec,yIdVec);
 
       // Fill edit distance matrix
-  SubstCostMap substCostMap;
-  int pred_i;
-  int pred_j;
-  int op_id;
-  for (unsigned int i=0; i<=xVec.size(); i++)
-  {
-    for (unsigned int j=0; j<=yVec.size(); j++) 
-    {
-      dm[i][j]=processMatrixCellPref(xVec,yVec,dm,substCostMap,lastWordIsComplete,usePrefDelOp,i,j,pred_i,pred_j,op_id);
-    }
-  }
+  Score dist=fillDistMatrix(cd,xIdVec,yIdVec,lastWordIsComplete,usePrefDelOp);
 
       // Retrieve word level operations
   std::vector<Score> opCosts;
-  obtainOperationsPref(xVec,yVec,dm,lastWordIsComplete,usePrefDelOp,x.size(),y.size(),opsWordLevel,opsCharLevel,opCosts);
+  obtainOperationsPref(cd,xIdVec,yIdVec,lastWordIsComplete,usePrefDelOp,opsWordLevel,opsCharLevel,opCosts);
 
       // Obtain costs per operation type
   std::vector<unsigned int> opsPerType;
@@ -137,7 +232,12 @@ Score EditDistForVecString::calculateEditDistPrefixOpsAux(const std::vector<std:
       // Print verbose information
 
       // If verbose, print distance matrix
-  if(verbose) printDistMatrix(xVec,yVec,dm,std::cerr);
+  if(verbose)
+  {
+    DistMatrix dm;
+    obtainDistMatrix(cd,xVec.size(),yVec.size(),dm);
+    printDistMatrix(xVec,yVec,dm,std::cerr);
+  }
 
       // If verbose, print operation costs per type
   if(verbose)
@@ -147,7 +247,7 @@ Score EditDistForVecString::calculateEditDistPrefixOpsAux(const std::vector<std:
   }
 
       // return edit distance
-  return dm[x.size()][y.size()];	
+  return dist;
 }
 
 //---------------------------------------
@@ -162,7 +262,7 @@ void EditDistForVecString::addBlankCharacters(std::vector<std::string> strVec)
 
 //---------------------------------------
 void EditDistForVecString::incrEditDistPrefixFirstRow(const std::vector<std::string>& incr_y,
-                                                      const std::vector<Score> prevScoreVec,
+                                                      const std::vector<Score>& prevScoreVec,
                                                       std::vector<Score>& newScoreVec)
 {
   newScoreVec=prevScoreVec; 
@@ -180,69 +280,48 @@ void EditDistForVecString::incrEditDistPrefixFirstRow(const std::vector<std::str
 //---------------------------------------
 void EditDistForVecString::incrEditDistPrefix(const std::string& xWord,
                                               const std::vector<std::string>& incr_y,
-                                              const std::vector<Score> prevScoreVec,
+                                              const std::vector<Score>& prevScoreVec,
                                               std::vector<Score>& newScoreVec,
                                               std::vector<int>& opIdVec)
-{
-  SubstCostMap substCostMap;
-  
-  incrEditDistPrefixCached(xWord,
-                           incr_y,
-                           prevScoreVec,
-                           substCostMap,
-                           newScoreVec,
-                           opIdVec);
-}
-
-//---------------------------------------
-void EditDistForVecString::incrEditDistPrefixCached(const std::string& xWord,
-                                                    const std::vector<std::string>& incr_y,
-                                                    const std::vector<Score> prevScoreVec,
-                                                    SubstCostMap& substCostMap,
-                                                    std::vector<Score>& newScoreVec,
-                                                    std::vector<int>& opIdVec)
 {
       // Execute typical edit distance algorithm except for the specific
       // substitution cost for the last word (note: y is the incomplete
       // prefix)
 
-      // A blank character in the last word of y means that this word
-      // should not be treated as a prefix
-  std::string lasty=incr_y[incr_y.size()-1];
-  std::string lastyWithoutBlanks;
-  bool lastWordIsComplete=StrProcUtils::lastCharIsBlank(lasty);
-  if(lastWordIsComplete)
-    lastyWithoutBlanks=StrProcUtils::removeLastBlank(lasty);
-  else lastyWithoutBlanks=lasty;
+  CalcData& cd=getCalcData();
+  clearCachesIfRequired(cd);
 
-      // Init x vector
-  std::vector<std::string> xVec;
-  xVec.push_back(xWord);
+      // Obtain identifiers of the words of incr_y if they changed
+      // since the last call
+  if(incr_y!=cd.lastIncrYVec)
+  {
+        // A blank character in the last word of y means that this word
+        // should not be treated as a prefix
+    std::string lasty=incr_y[incr_y.size()-1];
+    std::string lastyWithoutBlanks;
+    bool lastWordIsComplete=StrProcUtils::lastCharIsBlank(lasty);
+    if(lastWordIsComplete)
+      lastyWithoutBlanks=StrProcUtils::removeLastBlank(lasty);
+    else lastyWithoutBlanks=lasty;
 
-      // Init y vector
-  std::vector<std::string> yVec;
-  yVec.insert(yVec.begin(),prevScoreVec.size()-1,"");
-  for(unsigned int i=0;i<incr_y.size();++i)
-    yVec[prevScoreVec.size()-incr_y.size()-1+i]=incr_y[i];
-  yVec[yVec.size()-1]=lastyWithoutBlanks;
+    cd.lastIncrYVec=incr_y;
+    cd.lastIncrYIdVec.clear();
+    for(unsigned int i=0;i<incr_y.size()-1;++i)
+      cd.lastIncrYIdVec.push_back(wordToId(cd,incr_y[i]));
+    cd.lastIncrYIdVec.push_back(wordToId(cd,lastyWithoutBlanks));
+    cd.lastIncrYIsComplete=lastWordIsComplete;
+  }
 
-#ifndef EDIT_DIST_WITHOUT_BLANKS
-      // Calculate edit distance taking into account the blank
-      // characters
-  addBlankCharacters(xVec);
-  addBlankCharacters(yVec);
-#endif
+      // Init x vector
+  cd.incrXIdVec.resize(1);
+  cd.incrXIdVec[0]=wordToId(cd,xWord);
 
-      // Initialize data structures
-  DistMatrix dm;
-  initDm(xVec,yVec,dm);
+      // Init y vector, only the positions of the words of incr_y are
+      // accessed to calculate the new cells
+  cd.incrYIdVec.resize(prevScoreVec.size()-1);
+  for(unsigned int i=0;i<cd.lastIncrYIdVec.size();++i)
+    cd.incrYIdVec[prevScoreVec.size()-cd.lastIncrYIdVec.size()-1+i]=cd.lastIncrYIdVec[i];
 
-      // Fill dm
-  for(unsigned int j=0;j<prevScoreVec.size();++j)
-    dm[0][j]=prevScoreVec[j];
-  for(unsigned int j=0;j<newScoreVec.size();++j)
-    dm[1][j]=newScoreVec[j];
-  
       // Make room for newScoreVec
   while(newScoreVec.size()<prevScoreVec.size())
     newScoreVec.push_back(0);
@@ -253,24 +332,32 @@ void EditDistForVecString::incrEditDistPrefixCached(const std::string& xWord,
       // Fill newScoreVec and opIdVec with the
       // appropriate values
   opIdVec.clear();
-  int pred_i;
-  int pred_j;
-  int op_id;
   for (unsigned int j=0; j<incr_y.size(); j++)
   {
-    Score dist=processMatrixCellPref(xVec,
-                                     yVec,
-                                     dm,
-                                     substCostMap,
-                                     lastWordIsComplete,
-                                     DONT_USE_PREF_DEL_OP,
-                                     1,
-                                     startyPos+j,
-                                     pred_i,
-                                     pred_j,
-                                     op_id);
-    newScoreVec[startyPos+j]=dist;
-    dm[1][startyPos+j]=dist;
+    unsigned int col=startyPos+j;
+    Score dist;
+    int op_id;
+    if(col==0)
+    {
+      dist=prevScoreVec[0]+deletionCost(xWord);
+      op_id=DEL_OP;
+    }
+    else
+    {
+      dist=processMatrixCellIds(cd,
+                                cd.incrXIdVec,
+                                cd.incrYIdVec,
+                                cd.lastIncrYIsComplete,
+                                DONT_USE_PREF_DEL_OP,
+                                prevScoreVec[col-1],
+                                prevScoreVec[col],
+                                newScoreVec[col-1],
+                                1,
+                                col,
+                                true,
+                                op_id);
+    }
+    newScoreVec[col]=dist;
     opIdVec.push_back(op_id);
   }
 }
@@ -289,6 +376,9 @@ void EditDistForVecString::setErrorModel(Score _hitCost,
 
       // Set character-level costs
   editDistForStr.setErrorModel(hitCost,insCost,substCost,delCost);
+
+      // Cached costs are no longer valid
+  ++errorModelVersion;
 }
 
 //---------------------------------------
@@ -370,41 +460,116 @@ Score EditDistForVecString::processMatrixCell(const std::vector<std::string>& x,
 }
 
 //---------------------------------------
-Score EditDistForVecString::processMatrixCellPref(const std::vector<std::string>& x,
-                                                  const std::vector<std::string>& y,
-                                                  const DistMatrix& dm,
-                                                  SubstCostMap& substCostMap,
-                                                  bool lastWordIsComplete,
-                                                  bool usePrefDelOp,
-                                                  int i,
-                                                  int j,
-                                                  int& pred_i,
-                                                  int& pred_j,
-                                                  int& op_id)
+unsigned int EditDistForVecString::wordToId(CalcData& cd,
+                                            const std::string& word)
 {
-  if(i!=0 && j!=0)
+  std::unordered_map<std::string,unsigned int>::const_iterator mapIter=cd.wordToIdMap.find(word);
+  if(mapIter!=cd.wordToIdMap.end())
   {
-    Score min;
-    Score subst_cost;
-    Score ins_cost;
-    Score del_cost;
-        
-    pred_i=i-1;
-    pred_j=j-1;
-    
-        // Treat substitution operation
-    if(j==(int)y.size() && !lastWordIsComplete)
-    {
-      subst_cost=cachedPrefSubstCost(x[i-1],y[j-1],substCostMap);
-    }
-    else
+    return mapIter->second;
+  }
+  else
+  {
+    unsigned int id=cd.idToWordVec.size();
+    cd.wordToIdMap[word]=id;
+    cd.idToWordVec.push_back(word);
+    return id;
+  }
+}
+
+//---------------------------------------
+void EditDistForVecString::wordVecToIdVec(CalcData& cd,
+                                          const std::vector<std::string>& wordVec,
+                                          std::vector<unsigned int>& idVec)
+{
+  idVec.clear();
+  for(unsigned int i=0;i<wordVec.size();++i)
+    idVec.push_back(wordToId(cd,wordVec[i]));
+}
+
+//---------------------------------------
+void EditDistForVecString::clearCachesIfRequired(CalcData& cd)
+{
+      // Word identifiers are only released together with the cached
+      // costs, since the latter are indexed by the former
+  if(cd.idToWordVec.size()>EDIT_DIST_VECSTR_MAX_CACHED_WORDS ||
+     cd.substCostCache.size()>EDIT_DIST_VECSTR_MAX_CACHED_WORDS ||
+     cd.prefSubstCostCache.size()>EDIT_DIST_VECSTR_MAX_CACHED_WORDS)
+  {
+    cd.wordToIdMap.clear();
+    cd.idToWordVec.clear();
+    cd.substCostCache.clear();
+    cd.prefSubstCostCache.clear();
+    cd.lastIncrYVec.clear();
+  }
+}
+
+//---------------------------------------
+Score EditDistForVecString::fillDistMatrix(CalcData& cd,
+                                           const std::vector<unsigned int>& xIdVec,
+                                           const std::vector<unsigned int>& yIdVec,
+                                           bool lastWordIsComplete,
+                                           bool usePrefDelOp)
+{
+  unsigned int numCols=yIdVec.size()+1;
+  cd.dmVec.resize((xIdVec.size()+1)*numCols);
+
+      // Fill first row
+  cd.dmVec[0]=0;
+  for(unsigned int j=1;j<numCols;++j)
+    cd.dmVec[j]=cd.dmVec[j-1]+insertionCost(cd.idToWordVec[yIdVec[j-1]]);
+
+      // Fill the rest of rows
+  int op_id;
+  for(unsigned int i=1;i<=xIdVec.size();++i)
+  {
+    Score* prevRow=&cd.dmVec[(i-1)*numCols];
+    Score* row=&cd.dmVec[i*numCols];
+    row[0]=prevRow[0]+deletionCost(cd.idToWordVec[xIdVec[i-1]]);
+    for(unsigned int j=1;j<numCols;++j)
     {
-      subst_cost=cachedSubstCost(x[i-1],y[j-1],substCostMap);
+      row[j]=processMatrixCellIds(cd,xIdVec,yIdVec,lastWordIsComplete,usePrefDelOp,prevRow[j-1],prevRow[j],row[j-1],i,j,false,op_id);
     }
-    min = dm[i-1][j-1] + subst_cost;
-        // Substitution cost is the edit distance between string
-        // xVec[i-1] and yVec[j-1]
-    if(x[i-1]==y[j-1] || (!lastWordIsComplete && StrProcUtils::isPrefix(y[j-1],x[i-1])))
+  }
+  return cd.dmVec[xIdVec.size()*numCols+yIdVec.size()];
+}
+
+//---------------------------------------
+Score EditDistForVecString::processMatrixCellIds(CalcData& cd,
+                                                 const std::vector<unsigned int>& xIdVec,
+                                                 const std::vector<unsigned int>& yIdVec,
+                                                 bool lastWordIsComplete,
+                                                 bool usePrefDelOp,
+                                                 Score diagScore,
+                                                 Score upScore,
+                                                 Score leftScore,
+                                                 int i,
+                                                 int j,
+                                                 bool obtainOpId,
+                                                 int& op_id)
+{
+  unsigned int xId=xIdVec[i-1];
+  unsigned int yId=yIdVec[j-1];
+  Score min;
+  Score subst_cost;
+  Score ins_cost;
+  Score del_cost;
+
+      // Treat substitution operation
+  if(j==(int)yIdVec.size() && !lastWordIsComplete)
+  {
+    subst_cost=cachedPrefSubstCost(cd,xId,yId);
+  }
+  else
+  {
+    subst_cost=cachedSubstCost(cd,xId,yId);
+  }
+  min = diagScore + subst_cost;
+      // Substitution cost is the edit distance between the words
+      // given by xId and yId
+  if(obtainOpId)
+  {
+    if(xId==yId || (!lastWordIsComplete && StrProcUtils::isPrefix(cd.idToWordVec[yId],cd.idToWordVec[xId])))
     {
       op_id=HIT_OP;
     }
@@ -412,106 +577,160 @@ Score EditDistForVecString::processMatrixCellPref(const std::vector<std::string>
     {
       op_id=SUBST_OP;       
     }
+  }
 
-        // Treat deletion operation
+      // Treat deletion operation
 
-        // If the last word has already been introduced, the deletion is
-        // done with no cost
-    if(usePrefDelOp && j==(int)y.size())
-      del_cost=0;
-    else
-      del_cost=deletionCost(x[i-1]);
+      // If the last word has already been introduced, the deletion is
+      // done with no cost
+  if(usePrefDelOp && j==(int)yIdVec.size())
+    del_cost=0;
+  else
+    del_cost=deletionCost(cd.idToWordVec[xId]);
 
-    if(dm[i-1][j]+del_cost< min)
-    {
-      min = dm[i-1][j]+del_cost;
-      pred_i=i-1;
-      pred_j=j;
-      if(del_cost==0) op_id=PREF_DEL_OP;
-      else op_id=DEL_OP;
-    }
+  if(upScore+del_cost< min)
+  {
+    min = upScore+del_cost;
+    if(del_cost==0) op_id=PREF_DEL_OP;
+    else op_id=DEL_OP;
+  }
 
-        // Treat insertion operation
-    ins_cost=insertionCost(y[j-1]);
-    if (dm[i][j-1]+ins_cost < min)
-    {
-      min = dm[i][j-1]+ins_cost;
-      pred_i=i;
-      pred_j=j-1;
-      op_id=INS_OP;
-    }
-    return min;
+      // Treat insertion operation
+  ins_cost=insertionCost(cd.idToWordVec[yId]);
+  if (leftScore+ins_cost < min)
+  {
+    min = leftScore+ins_cost;
+    op_id=INS_OP;
   }
-  else
+  return min;
+}
+
+//---------------------------------------
+Score EditDistForVecString::cachedPrefSubstCost(CalcData& cd,
+                                                unsigned int xId,
+                                                unsigned int yId)
+{
+  Score subst_cost;
+  if(!cd.prefSubstCostCache.find(xId,yId,subst_cost))
   {
-    if(i==0 && j==0)
-    {
-      pred_i=0;
-      pred_j=0;
-      op_id=NONE_OP;
-      return 0;
-    }
-    else
-    {
-      if(i==0)
-      {
-        pred_i=0;
-        pred_j=j-1;
-        op_id=INS_OP;
-        return dm[0][j-1] + insertionCost(y[j-1]);
-      }
-      else
-      {
-        pred_i=i-1;
-        pred_j=0;
-        op_id=DEL_OP;
-        return dm[i-1][0] + deletionCost(x[i-1]);
-      }
-    }
+    subst_cost=prefSubstitutionCost(cd.idToWordVec[xId],cd.idToWordVec[yId]);
+    cd.prefSubstCostCache.insert(xId,yId,subst_cost);
   }
+  return subst_cost;
 }
 
 //---------------------------------------
-Score EditDistForVecString::cachedPrefSubstCost(std::string xWord,
-                                                std::string yWord,
-                                                SubstCostMap& substCostMap)
+Score EditDistForVecString::cachedSubstCost(CalcData& cd,
+                                            unsigned int xId,
+                                            unsigned int yId)
 {
-  std::string xWordAdapted=xWord+" pref";
-  SubstCostMap::const_iterator scmConstIter=substCostMap.find(std::make_pair(xWordAdapted,yWord));
-  if(scmConstIter!=substCostMap.end())
-    return scmConstIter->second;
-  else
+  Score subst_cost;
+  if(!cd.substCostCache.find(xId,yId,subst_cost))
   {
-    Score subst_cost=prefSubstitutionCost(xWord,yWord);
-    substCostMap[std::make_pair(xWordAdapted,yWord)]=subst_cost;
-    return subst_cost;
+    subst_cost=substitutionCost(cd.idToWordVec[xId],cd.idToWordVec[yId]);
+    cd.substCostCache.insert(xId,yId,subst_cost);
   }
+  return subst_cost;
 }
 
 //---------------------------------------
-Score EditDistForVecString::cachedSubstCost(std::string xWord,
-                                            std::string yWord,
-                                            SubstCostMap& substCostMap)
+Score EditDistForVecString::charLevelEditCost(const std::string& x,
+                                              const std::string& y,
+                                              bool yIsPrefix)
 {
-  SubstCostMap::const_iterator scmConstIter=substCostMap.find(std::make_pair(xWord,yWord));
-  if(scmConstIter!=substCostMap.end())
-    return scmConstIter->second;
-  else
+      // Treat empty strings
+  if(y.empty())
+    return delCost*x.size();
+  if(x.empty())
+    return insCost*y.size();
+
+      // Calculate edit distance matrix by rows, each cell stores the
+      // number of operations of each type of the best path reaching
+      // it. Ties are broken in the same way as in EditDistForStr
+  struct CellData
   {
-    Score subst_cost=substitutionCost(xWord,yWord);
-    substCostMap[std::make_pair(xWord,yWord)]=subst_cost;
-    return subst_cost;
+    Score dist;
+    unsigned int opCount[4];
+  };
+  std::vector<CellData> prevRow(y.size()+1);
+  std::vector<CellData> row(y.size()+1);
+
+  prevRow[0].dist=0;
+  for(unsigned int k=0;k<4;++k)
+    prevRow[0].opCount[k]=0;
+  for(unsigned int j=1;j<=y.size();++j)
+  {
+    prevRow[j]=prevRow[j-1];
+    prevRow[j].dist+=insCost;
+    ++prevRow[j].opCount[INS_OP];
   }
+
+  for(unsigned int i=1;i<=x.size();++i)
+  {
+    row[0]=prevRow[0];
+    row[0].dist+=delCost;
+    ++row[0].opCount[DEL_OP];
+    for(unsigned int j=1;j<=y.size();++j)
+    {
+          // Treat substitution operation
+      const CellData* predPtr=&prevRow[j-1];
+      int op_id;
+      Score min;
+      if(x[i-1]==y[j-1])
+      {
+        min=prevRow[j-1].dist+hitCost;
+        op_id=HIT_OP;
+      }
+      else
+      {
+        min=prevRow[j-1].dist+substCost;
+        op_id=SUBST_OP;
+      }
+
+          // Treat deletion operation
+      Score del_cost;
+      if(yIsPrefix && j==y.size())
+        del_cost=0;
+      else
+        del_cost=delCost;
+      if(prevRow[j].dist+del_cost < min)
+      {
+        min=prevRow[j].dist+del_cost;
+        predPtr=&prevRow[j];
+        if(del_cost==0) op_id=PREF_DEL_OP;
+        else op_id=DEL_OP;
+      }
+
+          // Treat insertion operation
+      if(row[j-1].dist+insCost < min)
+      {
+        min=row[j-1].dist+insCost;
+        predPtr=&row[j-1];
+        op_id=INS_OP;
+      }
+
+      row[j]=*predPtr;
+      row[j].dist=min;
+      if(op_id!=PREF_DEL_OP)
+        ++row[j].opCount[op_id];
+    }
+    row.swap(prevRow);
+  }
+
+      // Return cost of the operations
+  const CellData& last=prevRow[y.size()];
+  return hitCost*last.opCount[HIT_OP]+
+    insCost*last.opCount[INS_OP]+
+    substCost*last.opCount[SUBST_OP]+
+    delCost*last.opCount[DEL_OP];
 }
 
 //---------------------------------------
-void EditDistForVecString::obtainOperationsPref(const std::vector<std::string>& x,
-                                                const std::vector<std::string>& y,
-                                                const DistMatrix& dm,
+void EditDistForVecString::obtainOperationsPref(CalcData& cd,
+                                                const std::vector<unsigned int>& xIdVec,
+                                                const std::vector<unsigned int>& yIdVec,
                                                 bool lastWordIsComplete,
                                                 bool usePrefDelOp,
-                                                int i,
-                                                int j,
                                                 std::vector<unsigned int> &opsWordLevel,
                                                 std::vector<unsigned int> &opsCharLevel,
                                                 std::vector<Score>& opCosts)
@@ -519,31 +738,65 @@ void EditDistForVecString::obtainOperationsPref(const std::vector<std::string>&
       // Init variables
   std::vector<unsigned int> vuiaux;
   std::vector<Score> vscraux;
-  int op_id;
+  unsigned int numCols=yIdVec.size()+1;
+  int i=xIdVec.size();
+  int j=yIdVec.size();
 
       // Trace back edit distance path
   while(i>0 || j>0)
   {
         // Obtain next word level operation
-    SubstCostMap substCostMap;
-    Score dist=processMatrixCellPref(x,y,dm,substCostMap,lastWordIsComplete,usePrefDelOp,i,j,i,j,op_id);
+    int op_id;
+    Score dist;
+    if(i>0 && j>0)
+    {
+      dist=processMatrixCellIds(cd,xIdVec,yIdVec,lastWordIsComplete,usePrefDelOp,
+                                cd.dmVec[(i-1)*numCols+j-1],cd.dmVec[(i-1)*numCols+j],cd.dmVec[i*numCols+j-1],
+                                i,j,true,op_id);
+    }
+    else
+    {
+      if(i==0)
+      {
+        dist=cd.dmVec[j-1]+insertionCost(cd.idToWordVec[yIdVec[j-1]]);
+        op_id=INS_OP;
+      }
+      else
+      {
+        dist=cd.dmVec[(i-1)*numCols]+deletionCost(cd.idToWordVec[xIdVec[i-1]]);
+        op_id=DEL_OP;
+      }
+    }
+
+        // Move to predecessor
+    switch(op_id)
+    {
+      case INS_OP: --j;
+        break;
+      case DEL_OP:
+      case PREF_DEL_OP: --i;
+        break;
+      default: --i;
+        --j;
+        break;
+    }
     if(op_id!=PREF_DEL_OP)
     {
       vuiaux.push_back(op_id);
-      vscraux.push_back(dist-dm[i][j]);
+      vscraux.push_back(dist-cd.dmVec[i*numCols+j]);
     }
     
         // Check whether to calculate char level operations
-    if(j+1==(int)y.size() && !lastWordIsComplete)
+    if(j+1==(int)yIdVec.size() && !lastWordIsComplete)
     {
       if(op_id==HIT_OP)
       {
 #ifdef EDIT_DIST_FAST_ED_VECSTR
         opsCharLevel.clear();
-        for(unsigned int k=0;k<y.back().size();++k)
+        for(unsigned int k=0;k<cd.idToWordVec[yIdVec.back()].size();++k)
           opsCharLevel.push_back(HIT_OP);
 #else
-        editDistForStr.calculateEditDistPrefixOps(x[i],y.back(),opsCharLevel);
+        editDistForStr.calculateEditDistPrefixOps(cd.idToWordVec[xIdVec[i]],cd.idToWordVec[yIdVec.back()],opsCharLevel);
 #endif
       }
     }
@@ -552,14 +805,42 @@ void EditDistForVecString::obtainOperationsPref(const std::vector<std::string>&
       // Fill opsWordLevel and opCosts
   opsWordLevel.clear();
   opCosts.clear();
-  for(unsigned int i=0;i<vuiaux.size();++i)
+  for(unsigned int k=0;k<vuiaux.size();++k)
   {
-    opsWordLevel.push_back(vuiaux[vuiaux.size()-1-i]);
-    opCosts.push_back(vscraux[vscraux.size()-1-i]);
+    opsWordLevel.push_back(vuiaux[vuiaux.size()-1-k]);
+    opCosts.push_back(vscraux[vscraux.size()-1-k]);
   }  
 }
 
+//---------------------------------------
+void EditDistForVecString::obtainDistMatrix(const CalcData& cd,
+                                            unsigned int xSize,
+                                            unsigned int ySize,
+                                            DistMatrix& dm)
+{
+  dm.clear();
+  for(unsigned int i=0;i<=xSize;++i)
+  {
+    std::vector<Score> row(cd.dmVec.begin()+i*(ySize+1),cd.dmVec.begin()+(i+1)*(ySize+1));
+    dm.push_back(row);
+  }
+}
+
 //---------------------------------------
 EditDistForVecString::~EditDistForVecString(void)
 {
+      // The data created by all the threads for this instance is
+      // released, the entries of the threads are not used again since
+      // instance identifiers are never reused
+  pthread_mutex_lock(&calcDataRegistryMut);
+  for(std::set<CalcData*>::iterator iter=calcDataSet.begin();iter!=calcDataSet.end();++iter)
+    delete *iter;
+  calcDataSet.clear();
+  instanceMap.erase(instanceId);
+  pthread_mutex_unlock(&calcDataRegistryMut);
+
+      // Remove the entry of the calling thread
+  ThreadCalcDataMap* tcdMapPtr=static_cast<ThreadCalcDataMap*>(pthread_getspecific(calcDataKey));
+  if(tcdMapPtr!=NULL)
+    tcdMapPtr->erase(instanceId);
 }
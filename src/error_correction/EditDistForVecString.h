@@ -43,16 +43,22 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "EditDistForStr.h"
 #include "EditDistForVec.h"
+#include "IdPairCostCache.h"
 #include <string>
+#include <unordered_map>
 #include <map>
+#include <set>
+#include <atomic>
+#include <pthread.h>
 #include <StrProcUtils.h>
 
 //--------------- Constants ------------------------------------------
 
-
-//--------------- Type definitions -----------------------------------
-
-typedef std::map<std::pair<std::string,std::string>,Score> SubstCostMap;
+#define EDIT_DIST_VECSTR_MAX_CACHED_WORDS 1000000   // Maximum number
+                                                    // of interned words
+                                                    // and cached costs
+                                                    // before the caches
+                                                    // are cleared
 
 //--------------- Classes --------------------------------------------
 
@@ -95,30 +101,20 @@ class EditDistForVecString: public EditDistForVec<std::string>
       // operation is not allowed
 
   void incrEditDistPrefixFirstRow(const std::vector<std::string>& incr_y,
-                                  const std::vector<Score> prevScoreVec,
+                                  const std::vector<Score>& prevScoreVec,
                                   std::vector<Score>& newScoreVec);
       // Incrementally calculates the first row of the edit distance
       // matrix
   
   void incrEditDistPrefix(const std::string& xWord,
                           const std::vector<std::string>& incr_y,
-                          const std::vector<Score> prevScoreVec,
+                          const std::vector<Score>& prevScoreVec,
                           std::vector<Score>& newScoreVec,
                           std::vector<int>& opIdVec);
       // Incrementally calculates edit distance given xWord, incr_y,
       // previous vector of costs and new partially calculated vector of
       // costs
 
-  void incrEditDistPrefixCached(const std::string& xWord,
-                                const std::vector<std::string>& incr_y,
-                                const std::vector<Score> prevScoreVec,
-                                SubstCostMap& substCostMap,
-                                std::vector<Score>& newScoreVec,
-                                std::vector<int>& opIdVec);
-      // Incrementally calculates edit distance given xWord, incr_y,
-      // previous vector of costs and new partially calculated vector of
-      // costs (uses substCostMap to cache subsitution costs)
-
   void setErrorModel(Score _hitCost,
                      Score _insCost,
                      Score _substCost,
@@ -131,6 +127,51 @@ class EditDistForVecString: public EditDistForVec<std::string>
  protected:
 
   EditDistForStr editDistForStr;
+
+      // Data used to speed up the calculations. Words are interned to
+      // identifiers, and the substitution costs between words are
+      // cached for the pairs of identifiers. Each thread has its own
+      // copy of the data for each instance, so no locking is required
+      // to use it. The copies are registered in the instance and
+      // deleted when either the thread exits or the instance is
+      // destroyed
+  struct CalcData
+  {
+    std::unordered_map<std::string,unsigned int> wordToIdMap;
+    std::vector<std::string> idToWordVec;
+    IdPairCostCache substCostCache;
+    IdPairCostCache prefSubstCostCache;
+    std::vector<Score> dmVec;
+    unsigned int errorModelVersion;
+    
+        // Data used by incrEditDistPrefix(). The identifiers of the
+        // prefix words are kept between calls, since the function is
+        // called with the same prefix for all the words of a word-graph
+    std::vector<std::string> lastIncrYVec;
+    std::vector<unsigned int> lastIncrYIdVec;
+    bool lastIncrYIsComplete;
+    std::vector<unsigned int> incrXIdVec;
+    std::vector<unsigned int> incrYIdVec;
+
+    CalcData(void):errorModelVersion(0),lastIncrYIsComplete(false){}
+  };
+  typedef std::map<unsigned long,CalcData*> ThreadCalcDataMap;
+      // Data of a thread given the identifiers of the instances, it is
+      // stored in a single process-wide key
+
+  unsigned long instanceId;
+  std::set<CalcData*> calcDataSet;
+      // Data created by the threads for this instance, protected by a
+      // process-wide mutex
+  std::atomic<unsigned int> errorModelVersion;
+      // Incremented each time the error model changes, the cached
+      // costs of a thread are cleared when they were obtained with a
+      // different version
+
+  CalcData& getCalcData(void);
+      // Returns the data of the calling thread
+  static void createKey(void);
+  static void destroyThreadCalcData(void* threadCalcDataPtr);
   
   Score processMatrixCell(const std::vector<std::string>& x,
                           const std::vector<std::string>& y,
@@ -142,31 +183,52 @@ class EditDistForVecString: public EditDistForVec<std::string>
                           int& op_id);
       // Basic function to calculate edit distance
 
-  Score processMatrixCellPref(const std::vector<std::string>& x,
-                              const std::vector<std::string>& y,
-                              const DistMatrix& dm,
-                              SubstCostMap& substCostMap,
-                              bool lastWordIsComplete,
-                              bool usePrefDelOp,
-                              int i,
-                              int j,
-                              int& pred_i,
-                              int& pred_j,
-                              int& op_id);
-      // Basic function to calculate edit distance given a prefix
-
-  void obtainOperationsPref(const std::vector<std::string>& x,
-                            const std::vector<std::string>& y,
-                            const DistMatrix& dm,
+      // Functions working on word identifiers
+  unsigned int wordToId(CalcData& cd,
+                        const std::string& word);
+  void wordVecToIdVec(CalcData& cd,
+                      const std::vector<std::string>& wordVec,
+                      std::vector<unsigned int>& idVec);
+  void clearCachesIfRequired(CalcData& cd);
+  Score fillDistMatrix(CalcData& cd,
+                       const std::vector<unsigned int>& xIdVec,
+                       const std::vector<unsigned int>& yIdVec,
+                       bool lastWordIsComplete,
+                       bool usePrefDelOp);
+      // Fills the edit distance matrix stored in cd.dmVec by rows
+  Score processMatrixCellIds(CalcData& cd,
+                             const std::vector<unsigned int>& xIdVec,
+                             const std::vector<unsigned int>& yIdVec,
+                             bool lastWordIsComplete,
+                             bool usePrefDelOp,
+                             Score diagScore,
+                             Score upScore,
+                             Score leftScore,
+                             int i,
+                             int j,
+                             bool obtainOpId,
+                             int& op_id);
+      // Basic function to calculate edit distance given a prefix, the
+      // scores of the diagonal, upper and left neighbouring cells are
+      // given as parameters. If lastWordIsComplete is true and
+      // usePrefDelOp is false, the cell is processed as in a regular
+      // edit distance calculation. op_id is only set if obtainOpId is
+      // true
+  void obtainOperationsPref(CalcData& cd,
+                            const std::vector<unsigned int>& xIdVec,
+                            const std::vector<unsigned int>& yIdVec,
                             bool lastWordIsComplete,
                             bool usePrefDelOp,
-                            int i,
-                            int j,
                             std::vector<unsigned int> &opsWordLevel,
                             std::vector<unsigned int> &opsCharLevel,
                             std::vector<Score>& opCosts);
       // After an edit distance calculation given a prefix, this
       // function obtains the optimal sequence of operations.
+  void obtainDistMatrix(const CalcData& cd,
+                        unsigned int xSize,
+                        unsigned int ySize,
+                        DistMatrix& dm);
+      // Copies cd.dmVec into dm (used in verbose mode)
   
   void addBlankCharacters(std::vector<std::string> strVec);
 
@@ -188,9 +250,9 @@ class EditDistForVecString: public EditDistForVec<std::string>
 #endif
     }
 
-  Score cachedSubstCost(std::string xWord,
-                        std::string yWord,
-                        SubstCostMap& substCostMap);
+  Score cachedSubstCost(CalcData& cd,
+                        unsigned int xId,
+                        unsigned int yId);
   
   inline Score substitutionCost(const std::string& x,
                                 const std::string& y)
@@ -199,19 +261,13 @@ class EditDistForVecString: public EditDistForVec<std::string>
       if(x==y) return hitCost;
       else return substCost;
 #else
-      unsigned int hCount;
-      unsigned int iCount;
-      unsigned int sCount;
-      unsigned int dCount;
-
-      editDistForStr.calculateEditDistOps(x,y,hCount,iCount,sCount,dCount);
-      return hitCost*hCount+insCost*iCount+substCost*sCount+delCost*dCount;
+      return charLevelEditCost(x,y,false);
 #endif
     }
 
-  Score cachedPrefSubstCost(std::string xWord,
-                            std::string yWord,
-                            SubstCostMap& substCostMap);
+  Score cachedPrefSubstCost(CalcData& cd,
+                            unsigned int xId,
+                            unsigned int yId);
 
   inline Score prefSubstitutionCost(const std::string& x,
                                     const std::string& y)
@@ -220,26 +276,19 @@ class EditDistForVecString: public EditDistForVec<std::string>
       if(StrProcUtils::isPrefix(y,x)) return hitCost;
       else return substCost;
 #else
-          // Obtain edit distance for prefix
-      std::vector<unsigned int> ops;
-      editDistForStr.calculateEditDistPrefixOps(x,y,ops);
-
-          // Obtain operation counts
-      std::vector<unsigned int> opsPerType;
-      countOpsGivenOpVec(ops,opsPerType);
-      unsigned int hCount=opsPerType[HIT_OP];
-      unsigned int iCount=opsPerType[INS_OP];
-      unsigned int sCount=opsPerType[SUBST_OP];
-      unsigned int dCount=opsPerType[DEL_OP];
-
-          // Return substitution cost
-      return hitCost*hCount+
-        insCost*iCount+
-        substCost*sCount+
-        delCost*dCount;
+      return charLevelEditCost(x,y,true);
 #endif
     }
 
+  Score charLevelEditCost(const std::string& x,
+                          const std::string& y,
+                          bool yIsPrefix);
+      // Returns the cost of the character-level operations of the
+      // optimal edit path between x and y. If yIsPrefix is true, the
+      // characters of x after the end of y are deleted at no cost.
+      // The result is the same obtained by tracing back the path of
+      // the character-level edit distance matrix
+
   Score calculateEditDistPrefixOpsAux(const std::vector<std::string>& x,
                                       const std::vector<std::string>& y,
                                       std::vector<unsigned int>& opsWordLevel,
@@ -247,6 +296,10 @@ class EditDistForVecString: public EditDistForVec<std::string>
                                       bool usePrefDelOp,
                                       int verbose=0);
       // Auxiliary function for calculateEditDistPrefixOps
+
+      // Copies are not allowed
+  EditDistForVecString(const EditDistForVecString&);
+  void operator=(const EditDistForVecString&);
 };
 
 #endif
@@ -0,0 +1,159 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: IdPairCostCache                                          */
+/*                                                                  */
+/* Prototypes file: IdPairCostCache.h                               */
+/*                                                                  */
+/* Description: Defines the IdPairCostCache class, an open          */
+/*              addressing hash table that stores costs indexed by  */
+/*              pairs of word identifiers.                          */
+/*                                                                  */
+/********************************************************************/
+
+#ifndef _IdPairCostCache_h
+#define _IdPairCostCache_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "Score.h"
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define ID_PAIR_COST_CACHE_INIT_BUCKETS 1024
+
+//--------------- Classes --------------------------------------------
+
+
+//--------------- IdPairCostCache class declaration
+
+class IdPairCostCache
+{
+ public:
+
+  IdPairCostCache(void)
+    {
+      clear();
+    }
+
+  inline bool find(unsigned int xId,
+                   unsigned int yId,
+                   Score& cost)const
+    {
+      unsigned long long key=makeKey(xId,yId);
+      size_t idx=bucketIdx(key);
+      while(bucketVec[idx].key!=0)
+      {
+        if(bucketVec[idx].key==key)
+        {
+          cost=bucketVec[idx].cost;
+          return true;
+        }
+        idx=(idx+1)&(bucketVec.size()-1);
+      }
+      return false;
+    }
+
+  inline void insert(unsigned int xId,
+                     unsigned int yId,
+                     Score cost)
+    {
+          // Keep the load factor below one half
+      if(2*(numEntries+1)>bucketVec.size())
+        grow();
+
+      unsigned long long key=makeKey(xId,yId);
+      size_t idx=bucketIdx(key);
+      while(bucketVec[idx].key!=0)
+      {
+        if(bucketVec[idx].key==key)
+        {
+          bucketVec[idx].cost=cost;
+          return;
+        }
+        idx=(idx+1)&(bucketVec.size()-1);
+      }
+      bucketVec[idx].key=key;
+      bucketVec[idx].cost=cost;
+      ++numEntries;
+    }
+
+  size_t size(void)const
+    {
+      return numEntries;
+    }
+
+  void clear(void)
+    {
+      bucketVec.clear();
+      bucketVec.resize(ID_PAIR_COST_CACHE_INIT_BUCKETS);
+      numEntries=0;
+    }
+
+ private:
+
+      // Buckets store keys built from the identifiers plus one in the
+      // high half, zero keys denote empty buckets
+  struct Bucket
+  {
+    unsigned long long key;
+    Score cost;
+    Bucket(void):key(0),cost(0){}
+  };
+
+  std::vector<Bucket> bucketVec;
+  size_t numEntries;
+
+  inline unsigned long long makeKey(unsigned int xId,
+                                    unsigned int yId)const
+    {
+      return (((unsigned long long)xId+1)<<32) | yId;
+    }
+
+  inline size_t bucketIdx(unsigned long long key)const
+    {
+          // Fibonacci hashing, the number of buckets is a power of two
+      return (size_t)((key*0x9E3779B97F4A7C15ULL)>>17) & (bucketVec.size()-1);
+    }
+
+  void grow(void)
+    {
+      std::vector<Bucket> oldBucketVec;
+      oldBucketVec.swap(bucketVec);
+      bucketVec.resize(2*oldBucketVec.size());
+      for(size_t i=0;i<oldBucketVec.size();++i)
+      {
+        if(oldBucketVec[i].key!=0)
+        {
+          size_t idx=bucketIdx(oldBucketVec[i].key);
+          while(bucketVec[idx].key!=0)
+            idx=(idx+1)&(bucketVec.size()-1);
+          bucketVec[idx]=oldBucketVec[i];
+        }
+      }
+    }
+};
+
+#endif
@@ -106,8 +106,8 @@ NonPbEcModelForNbUcat::nonPhraseBasedAlign(const std::vector<std::string>& _outp
     WordAndCharLevelOps wcOps;
     PrefAlignInfo prefAlignInfo;
 
-        // Obtain similarity
-    sim=ecm_ptr->similarityGivenPrefix(_outputSentVec,_prefixVec);
+        // Obtain similarity and correction using a single alignment
+    sim=ecm_ptr->similarityGivenPrefixCorr(_outputSentVec,_prefixVec,correctedOutputVec);
 
         // Store alignment in the n-best corrections list
     prefAlignInfo.transCuts.push_back(_outputSentVec.size()-1);
@@ -211,9 +211,14 @@ std::vector<std::string> NonPbEcModelForNbUcat::correctedSent(PrefAlignInfo& pre
   }
   if(l>0)
   {
-        // Obtain corrected last segment
+        // Obtain corrected last segment, the alignment covers the whole
+        // output sentence and prefix, so it was already corrected when
+        // obtaining their similarity
     getLastOutSegm(outputSentVec,prefAlignInfo.transCuts,lastOutSegm);
-    ecm_ptr->correctStrGivenPref(lastOutSegm,lastPrefSegm,correctedLastSegm);
+    if(lastOutSegm==outputSentVec && lastPrefSegm==prefixVec)
+      correctedLastSegm=correctedOutputVec;
+    else
+      ecm_ptr->correctStrGivenPref(lastOutSegm,lastPrefSegm,correctedLastSegm);
         // Add corrected last segment
     for(unsigned int i=0;i<correctedLastSegm.size();++i)
     {
@@ -269,6 +274,7 @@ void NonPbEcModelForNbUcat::clear(void)
   sourceCuts.clear();
   outputSegmVec.clear();
   prefixVec.clear();
+  correctedOutputVec.clear();
   monolingSegmNbest.clear();
 }
 
@@ -108,6 +108,9 @@ class NonPbEcModelForNbUcat: public BaseEcModelForNbUcat
   std::vector<unsigned int> sourceCuts;
   std::vector<std::vector<std::string> > outputSegmVec;
   std::vector<std::string> prefixVec;
+  std::vector<std::string> correctedOutputVec;
+      // Correction of outputSentVec given prefixVec, it is obtained
+      // together with their similarity
   unsigned int maxMapSize;
   MonolingSegmNbest monolingSegmNbest;
 
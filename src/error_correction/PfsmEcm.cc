@@ -65,6 +65,20 @@ void PfsmEcm::correctStrGivenPref(std::vector<std::string> uncorrStrVec,
   correctStrGivenPrefOps(wcOps,uncorrStrVec,prefStrVec,correctedStrVec);
 }
 
+//---------------------------------------
+Score PfsmEcm::similarityGivenPrefixCorr(const std::vector<std::string>& x,
+                                         const std::vector<std::string>& y,
+                                         std::vector<std::string>& correctedStrVec)
+{
+  WordAndCharLevelOps wcOps;
+  
+  Score sim=-editDistForVecStr.calculateEditDistPrefixOps(x,y,wcOps.first,wcOps.second);
+  
+  correctStrGivenPrefOps(wcOps,x,y,correctedStrVec);
+
+  return sim;
+}
+
 //---------------------------------------
 void PfsmEcm::setWeights(std::vector<float> wVec)
 {
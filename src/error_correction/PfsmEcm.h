@@ -91,6 +91,11 @@ class PfsmEcm: public _editDistBasedEcm
                            std::vector<std::string>& correctedStrVec);
       // Corrects string 'uncorrStrVec' given the prefix 'prefStrVec'
       // storing the results in 'correctedStrVec'
+  Score similarityGivenPrefixCorr(const std::vector<std::string>& x,
+                                  const std::vector<std::string>& y,
+                                  std::vector<std::string>& correctedStrVec);
+      // Obtains the similarity and the correction using a single edit
+      // distance calculation
 
       // Model weights functions
   void setWeights(std::vector<float> wVec);
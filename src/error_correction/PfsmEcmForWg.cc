@@ -28,6 +28,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "PfsmEcmForWg.h"
+#include <WordGraph.h>
 
 //--------------- PfsmEcmForWg class functions
 //
@@ -120,6 +121,12 @@ std::vector<Score> PfsmEcmForWg::obtainScrVecFromEsi(const EcmScoreInfo& esi)
   return scrVec;
 }
 
+//---------------------------------------
+Score PfsmEcmForWg::obtainLastScrFromEsi(const EcmScoreInfo& esi)
+{
+  return -esi.scrVec.back();
+}
+
 //---------------------------------------
 std::vector<int> PfsmEcmForWg::obtainLastInsPrefWordVecFromEsi(const EcmScoreInfo& esi)
 {
@@ -195,6 +202,41 @@ void PfsmEcmForWg::removeLastPosFromEsi(EcmScoreInfo& esi)
   }
 }
 
+//---------------------------------------
+void PfsmEcmForWg::getLastPosFromEsi(const EcmScoreInfo& esi,
+                                     EcmScoreInfo& lastPosEsi)
+{
+      // The buffers of lastPosEsi are reused
+  lastPosEsi.scrVec.clear();
+  lastPosEsi.opIdVec.clear();
+  if(!esi.scrVec.empty())
+    lastPosEsi.scrVec.push_back(esi.scrVec.back());
+
+      // The esi object of the initial state has no predecessors
+  if(!esi.opIdVec.empty() && esi.opIdVec.size()==esi.scrVec.size())
+    lastPosEsi.opIdVec.push_back(esi.opIdVec.back());
+}
+
+//---------------------------------------
+void PfsmEcmForWg::appendPosToEsi(const EcmScoreInfo& lastPosEsi,
+                                  EcmScoreInfo& esi)
+{
+  for(unsigned int i=0;i<lastPosEsi.scrVec.size();++i)
+    esi.scrVec.push_back(lastPosEsi.scrVec[i]);
+  for(unsigned int i=0;i<lastPosEsi.opIdVec.size();++i)
+    esi.opIdVec.push_back(lastPosEsi.opIdVec[i]);
+}
+
+//---------------------------------------
+void PfsmEcmForWg::appendPrunedPosToEsi(EcmScoreInfo& esi)
+{
+      // Scores are stored as costs, obtainScrVecFromEsi() returns
+      // SMALL_SCORE for the new position
+  esi.scrVec.push_back(-SMALL_SCORE);
+  if(!esi.opIdVec.empty())
+    esi.opIdVec.push_back(NONE_OP);
+}
+
 //---------------------------------------
 PfsmEcmForWg::~PfsmEcmForWg()
 {
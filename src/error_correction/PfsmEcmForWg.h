@@ -95,6 +95,7 @@ class PfsmEcmForWg: public PfsmEcm, public BaseEcmForWg<PfsmEcmForWgEsi>
 
       // Functions to extract data from a given esi
   std::vector<Score> obtainScrVecFromEsi(const EcmScoreInfo& esi);
+  Score obtainLastScrFromEsi(const EcmScoreInfo& esi);
   std::vector<int> obtainLastInsPrefWordVecFromEsi(const EcmScoreInfo& esi);
 
   void updateEsiPositions(const EcmScoreInfo& esi1,
@@ -111,6 +112,20 @@ class PfsmEcmForWg: public PfsmEcm, public BaseEcmForWg<PfsmEcmForWgEsi>
   void removeLastPosFromEsi(EcmScoreInfo& esi);
       // Removes last position from the EcmScoreInfo object "esi".
 
+  void getLastPosFromEsi(const EcmScoreInfo& esi,
+                         EcmScoreInfo& lastPosEsi);
+      // Stores the last position of the EcmScoreInfo object "esi" in
+      // "lastPosEsi"
+
+  void appendPosToEsi(const EcmScoreInfo& lastPosEsi,
+                      EcmScoreInfo& esi);
+      // Appends the position stored by getLastPosFromEsi() to the
+      // EcmScoreInfo object "esi"
+
+  void appendPrunedPosToEsi(EcmScoreInfo& esi);
+      // Appends a position for a pruned hypothesis to the
+      // EcmScoreInfo object "esi"
+
       // Destructor
   ~PfsmEcmForWg();
 
@@ -54,6 +54,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Constants ------------------------------------------
 
+#define WGP_UNLIMITED_BEAM   0
 
 //--------------- Functions ------------------------------------------
 
@@ -87,6 +88,12 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
 
   void set_ecmw(float _ecmWeight);
       // Set error correcting model weight
+
+  void set_beam(float _beamWidth);
+      // Set beam width. When a new prefix is processed, the states
+      // whose score is worse than the score of the best state by more
+      // than the beam width are not extended. If the beam width is
+      // equal to WGP_UNLIMITED_BEAM, all states are extended
   
   NbestCorrections correct(std::string prefix,
                            unsigned int n,
@@ -113,6 +120,17 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
   typedef std::pair<WordGraphArcId,unsigned int> HypSubStateIdx;
   typedef std::multimap<float,HypSubStateIdx,std::greater<float> > NbestHypSubStates;
   typedef std::set<HypStateIndex> StatesInvolvedInArcs;
+
+      // Last position of the word-graph processor variables obtained
+      // for the prefix of length prefixLen (in characters)
+  struct ColCacheEntry
+  {
+    unsigned int prefixLen;
+    std::vector<EcmScoreInfo> stateEsiVec;
+    std::vector<Score> stateBestScoreVec;
+    std::vector<WordGraphArcId> stateBestPredVec;
+    std::vector<EcmScoreInfo> arcEsiVec;
+  };
     
   std::vector<std::string> previousPrefixVec;
   
@@ -124,6 +142,9 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
   
   float ecmWeight; // Weight assigned to error correcting model scores
 
+  float beamWidth; // Beam width used to prune the states that are
+                   // extended
+
   bool initVarsExecuted; // This variable is set to true if wg
                          // processor variables has been
                          // initialized for current word-graph
@@ -147,6 +168,16 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
                                                      // for each state
 
   StatesInvolvedInArcs statesInvolvedInArcs; // List of states involved in arcs
+
+      // Cache of the last positions of the variables, the first
+      // colCacheNumEntries entries of colCacheVec are sorted by prefix
+      // length and store the positions obtained for the prefixes of
+      // colCachePrefix. The cache is extended when a keystroke extends
+      // the prefix and truncated when a keystroke deletes characters,
+      // so the positions can be restored after a backspace
+  std::string colCachePrefix;
+  std::vector<ColCacheEntry> colCacheVec;
+  unsigned int colCacheNumEntries;
   
   // Auxiliary functions
 
@@ -167,6 +198,9 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
                                             const std::vector<std::string>& prefixVec);
   void procWgGivenPrefDiff(std::vector<std::string> prefixDiffVec,
                            unsigned int verbose=0);
+  void obtainStatesWithinBeam(std::vector<bool>& withinBeamVec);
+      // Marks the states whose score for the last position is within
+      // the beam
   NbestHypStates obtainNbestHypStates(unsigned int n,
                                       const RejectedWordsSet& rejectedWords,
                                       unsigned int verbose=0);
@@ -193,6 +227,11 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
   void updateEcmScoreInfoForArc(const std::vector<std::string>& prefixDiffVec,
                                 WordGraphArcId wgArcId,
                                 unsigned int verbose=0);
+  void pruneWgpInfoForArc(const std::vector<std::string>& prefixDiffVec,
+                          WordGraphArcId wgArcId);
+      // Auxiliar function of the procWgGivenPrefDiff() function, it
+      // adds pruned positions to the information of the word-processor
+      // for an arc whose predecessor state is out of the beam
   NbestCorrections obtainNbestCorrections(std::vector<std::string> prefixVec,
                                           unsigned int n,
                                           const RejectedWordsSet& rejectedWords,
@@ -219,6 +258,18 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
   void removeLastFromNbestHypSubStates(NbestHypSubStates &nbestHypSubStates);
   void removeLastFromNbestCorrs(NbestCorrections &nbestCorrections);
 
+  // Functions to handle the cache of last positions
+  std::string prefixVecToStr(const std::vector<std::string>& prefixVec)const;
+  void clearColCache(void);
+  void updateColCache(const std::vector<std::string>& prefixVec,
+                      const std::vector<std::string>& validProcPrefixVec);
+      // Truncates the cache to the prefixes of prefixVec, and stores
+      // the last position of the variables if the previous prefix is
+      // one of them and its last word is not valid any more
+  bool retrieveLastPosFromColCache(const std::vector<std::string>& prefixDiffVec);
+      // Appends the last position stored for the current prefix if
+      // available, returns true if the position was found
+
   // Functions to update best scores
   void updateBestScoresForInitState(unsigned int verbose=0);
   void updateBestScoresForState(WordGraphArcId wgArcId,
@@ -249,7 +300,11 @@ WgProcessorForAnlp<ECM_FOR_WG>::WgProcessorForAnlp()
 {
   wg_ptr=NULL;
   ecm_wg_ptr=NULL;
+  wgWeight=0;
+  ecmWeight=0;
   initVarsExecuted=false;
+  beamWidth=WGP_UNLIMITED_BEAM;
+  colCacheNumEntries=0;
 }
 
 //---------------------------------------
@@ -279,6 +334,9 @@ bool WgProcessorForAnlp<ECM_FOR_WG>::link_ecm_wg(BaseErrorCorrectionModel* _ecm_
 template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::set_wgw(float _wgWeight)
 {
+      // Cached positions were obtained using the previous weight
+  if(wgWeight!=_wgWeight)
+    clearColCache();
   wgWeight=_wgWeight;
 }
 
@@ -286,9 +344,21 @@ void WgProcessorForAnlp<ECM_FOR_WG>::set_wgw(float _wgWeight)
 template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::set_ecmw(float _ecmWeight)
 {
+  if(ecmWeight!=_ecmWeight)
+    clearColCache();
   ecmWeight=_ecmWeight;  
 }
 
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::set_beam(float _beamWidth)
+{
+  beamWidth=_beamWidth;
+
+      // Cached positions were obtained using the previous beam width
+  clearColCache();
+}
+
 //---------------------------------------
 template<class ECM_FOR_WG>
 NbestCorrections
@@ -358,6 +428,7 @@ WgProcessorForAnlp<ECM_FOR_WG>::correct(std::string prefix,
       for(unsigned int i=0;i<validProcPrefixVec.size();++i) std::cerr<<" "<<validProcPrefixVec[i];
       std::cerr<<"|"<<std::endl;
     }
+    updateColCache(prefixVec,validProcPrefixVec);
     updateSizeOfVars(validProcPrefixVec);
 
         // Obtain difference between prefixVec and valid portion of the
@@ -378,7 +449,14 @@ WgProcessorForAnlp<ECM_FOR_WG>::correct(std::string prefix,
     double total_time=0,elapsed_ant,elapsed,ucpu,scpu;  
     ctimer(&elapsed_ant,&ucpu,&scpu);
 
-    procWgGivenPrefDiff(prefixDiffVec,verbose);
+    if(retrieveLastPosFromColCache(prefixDiffVec))
+    {
+      if(verbose) std::cerr<<" - Last position retrieved from cache"<<std::endl;
+    }
+    else
+    {
+      procWgGivenPrefDiff(prefixDiffVec,verbose);
+    }
 
         // Get final time
     ctimer(&elapsed,&ucpu,&scpu);
@@ -488,8 +566,18 @@ WgProcessorForAnlp<ECM_FOR_WG>::getValidProcPrefixVec(const std::vector<std::str
   for(unsigned int i=0;i<previousPrefixVec.size();++i)
   {
     if(i>=prefixVec.size()) break;
-    if(previousPrefixVec[i]==prefixVec[i])
-      result.push_back(previousPrefixVec[i]);
+
+        // The last word of the prefix is processed as an incomplete
+        // word unless it ends with a blank character, the rest of
+        // words are complete
+    bool prevWordIsComplete=(i!=previousPrefixVec.size()-1 ||
+                             StrProcUtils::lastCharIsBlank(previousPrefixVec[i]));
+    bool wordIsComplete=(i!=prefixVec.size()-1 ||
+                         StrProcUtils::lastCharIsBlank(prefixVec[i]));
+    if(prevWordIsComplete!=wordIsComplete) break;
+    if(previousPrefixVec[i]!=prefixVec[i]) break;
+    
+    result.push_back(prefixVec[i]);
   }
   return result;
 }
@@ -519,10 +607,31 @@ template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::procWgGivenPrefDiff(std::vector<std::string> prefixDiffVec,
                                                          unsigned int verbose/*=0*/)
 {
+      // The beam is applied to each position of the prefix, so the
+      // words are processed one by one if it is used (the blank
+      // character marks the words that are complete)
+  if(beamWidth!=WGP_UNLIMITED_BEAM && prefixDiffVec.size()>1)
+  {
+    for(unsigned int i=0;i<prefixDiffVec.size();++i)
+    {
+      std::vector<std::string> wordVec;
+      wordVec.push_back(prefixDiffVec[i]);
+      if(i<prefixDiffVec.size()-1)
+        wordVec[0]+=" ";
+      procWgGivenPrefDiff(wordVec,verbose);
+    }
+    return;
+  }
+
       // Declare and initialize variables
          
       // Obtain arc range
   std::pair<WordGraphArcId,WordGraphArcId> arcIdxRange=wg_ptr->getArcIndexRange();
+
+      // Obtain states within the beam before extending them
+  std::vector<bool> withinBeamVec;
+  if(prefixDiffVec.size()!=0)
+    obtainStatesWithinBeam(withinBeamVec);
   
       // Process initial state
   if(prefixDiffVec.size()!=0)
@@ -539,13 +648,60 @@ void WgProcessorForAnlp<ECM_FOR_WG>::procWgGivenPrefDiff(std::vector<std::string
   
   if(prefixDiffVec.size()!=0)
   {
+    unsigned int numPrunedArcs=0;
     for(unsigned int aIdx=arcIdxRange.first;aIdx<=arcIdxRange.second;++aIdx)
     {    
           // Update info for arcs
       if(!wg_ptr->arcPruned(aIdx))
-        updateWgpInfoForArc(prefixDiffVec,
-                            aIdx,
-                            verbose);
+      {
+        if(withinBeamVec[wg_ptr->wordGraphArcId2WordGraphArc(aIdx).predStateIndex])
+        {
+          updateWgpInfoForArc(prefixDiffVec,
+                              aIdx,
+                              verbose);
+        }
+        else
+        {
+          pruneWgpInfoForArc(prefixDiffVec,aIdx);
+          ++numPrunedArcs;
+        }
+      }
+    }
+    if(verbose && beamWidth!=WGP_UNLIMITED_BEAM)
+      std::cerr<<"Number of arcs out of the beam: "<<numPrunedArcs<<std::endl;
+  }
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::obtainStatesWithinBeam(std::vector<bool>& withinBeamVec)
+{
+  withinBeamVec.clear();
+  if(beamWidth==WGP_UNLIMITED_BEAM)
+  {
+    withinBeamVec.insert(withinBeamVec.begin(),bestScoresForState.size(),true);
+  }
+  else
+  {
+    withinBeamVec.insert(withinBeamVec.begin(),bestScoresForState.size(),false);
+
+        // Obtain score of the best state, scores are obtained as in
+        // the obtainNbestHypStates() function
+    Score bestScore=SMALL_SCORE;
+    StatesInvolvedInArcs::iterator iter;
+    for(iter=statesInvolvedInArcs.begin();iter!=statesInvolvedInArcs.end();++iter)
+    {
+      Score score=bestScoresForState[*iter].back()+(wgWeight*restScores[*iter]);
+      if(bestScore<score)
+        bestScore=score;
+    }
+
+        // Mark states within the beam
+    for(iter=statesInvolvedInArcs.begin();iter!=statesInvolvedInArcs.end();++iter)
+    {
+      Score score=bestScoresForState[*iter].back()+(wgWeight*restScores[*iter]);
+      if(bestScoresForState[*iter].back()!=SMALL_SCORE && score>=bestScore-beamWidth)
+        withinBeamVec[*iter]=true;
     }
   }
 }
@@ -570,6 +726,10 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypStates(unsigned int n,
         // set of rejected words, calculate rest score for state.
     Score restScore=restScores[hsIdx];
     bool hypStateOk=true;
+
+        // States that were not reached due to the beam are discarded
+    if(bestScoresForState[hsIdx].back()==SMALL_SCORE)
+      continue;
     if(!rejectedWords.empty())
     {
           // Obtain successors
@@ -600,6 +760,8 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypStates(unsigned int n,
 
           // Insert state in the n-best list
       Score score=bestScoresForState[hsIdx].back()+(wgWeight*restScore);
+      if(!nbestHypStates.empty() && nbestHypStates.size()>=n && (float)score<=nbestHypStates.rbegin()->first)
+        continue;
       nbestHypStates.insert(std::make_pair(score,hsIdx));
     
           // Prune list if necessary
@@ -658,10 +820,19 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypSubStates(unsigned int n,
                 // The sub-state satisfies the constraints imposed by
                 // the set of rejected words
             
-                // Obtain ecm score vector for w'th word of current arc
-            std::vector<Score> ecmScrVec=ecm_wg_ptr->obtainScrVecFromEsi(ecmScrInfoForArcVec[wgArcId][w]);
+                // Obtain ecm score for w'th word of current arc
+            Score ecmScr=ecm_wg_ptr->obtainLastScrFromEsi(ecmScrInfoForArcVec[wgArcId][w]);
+                // Sub-states that were pruned due to the beam are
+                // discarded
+            if(ecmScr<=SMALL_SCORE)
+              continue;
                 // Calculate score of the sub-state
-            Score score=wgWeight*wgScr+ecmWeight*ecmScrVec.back()+(wgWeight*restScores[wgArc.predStateIndex]);
+            Score score=wgWeight*wgScr+ecmWeight*ecmScr+(wgWeight*restScores[wgArc.predStateIndex]);
+
+                // Sub-states that would be removed from a full n-best
+                // list are discarded without inserting them
+            if(!nbestHypSubStates.empty() && nbestHypSubStates.size()>=n && (float)score<=nbestHypSubStates.rbegin()->first)
+              continue;
             
                 // Create sub-state object
             HypSubStateIdx hssIdx;
@@ -763,7 +934,7 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateEcmScoreInfoForArc(const std::vector<
   HypStateIndex idx=wgArc.predStateIndex;
 
       // Update ecm score info for each word of the arc
-  EcmScoreInfo prevEsi=ecmScrInfoForState[idx];
+  const EcmScoreInfo* prevEsiPtr=&ecmScrInfoForState[idx];
   
       // Grow new esi for arc if necessary
   while(ecmScrInfoForArcVec[wgArcId].size()<wgArc.words.size())
@@ -776,13 +947,46 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateEcmScoreInfoForArc(const std::vector<
   {
         // Extend ecm score info
     ecm_wg_ptr->extendEsi(prefixDiffVec,
-                          prevEsi,
+                          *prevEsiPtr,
                           wgArc.words[w],
                           ecmScrInfoForArcVec[wgArcId][w]);
-    prevEsi=ecmScrInfoForArcVec[wgArcId][w];
+    prevEsiPtr=&ecmScrInfoForArcVec[wgArcId][w];
   }
 }
 
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::pruneWgpInfoForArc(const std::vector<std::string>& prefixDiffVec,
+                                                        WordGraphArcId wgArcId)
+{
+      // Obtain arc from arc identifier
+  WordGraphArc wgArc=wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
+
+      // Add pruned positions to the ecm score info of each word of the
+      // arc
+  for(unsigned int w=0;w<ecmScrInfoForArcVec[wgArcId].size();++w)
+  {
+    for(unsigned int i=0;i<prefixDiffVec.size();++i)
+      ecm_wg_ptr->appendPrunedPosToEsi(ecmScrInfoForArcVec[wgArcId][w]);
+  }
+
+      // Add pruned positions to the successor state if it has not been
+      // reached by other arcs. All states have as many positions as
+      // the initial state, which is always extended
+  HypStateIndex succIdx=wgArc.succStateIndex;
+  unsigned int numPos=bestScoresForState[INITIAL_STATE].size();
+  while(bestScoresForState[succIdx].size()<numPos)
+  {
+    bestScoresForState[succIdx].push_back(SMALL_SCORE);
+    bestPredsForState[succIdx].push_back(INVALID_ARCID);
+  }
+  while(ecm_wg_ptr->numberOfPosInEsi(ecmScrInfoForState[succIdx])<numPos)
+    ecm_wg_ptr->appendPrunedPosToEsi(ecmScrInfoForState[succIdx]);
+
+      // Update wg score for succIdx
+  wgScoreForState[succIdx]=wgScoreForState[wgArc.predStateIndex]+wgArc.arcScore;
+}
+
 //---------------------------------------
 template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::updateBestScoresForInitState(unsigned int /*verbose*//*=0*/)
@@ -1284,6 +1488,7 @@ void WgProcessorForAnlp<ECM_FOR_WG>::clear(void)
   wgScoreForState.clear();
   bestScoresForState.clear();
   bestPredsForState.clear();
+  clearColCache();
 }
 
 //---------------------------------------
@@ -1298,6 +1503,7 @@ void WgProcessorForAnlp<ECM_FOR_WG>::initVars(unsigned int verbose/*=0*/)
 {
       // Clear previous prefix vector
   previousPrefixVec.clear();
+  clearColCache();
 
       // Generate rest scores for word-graph
   restScores.clear();
@@ -1376,7 +1582,7 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateSizeOfVars(const std::vector<std::str
 {
       // Obtain diff size
   unsigned int diffSize=previousPrefixVec.size()-validProcPrefixVec.size();
-    
+
       // Adjust size of ecm score info for arcs
   for(unsigned int aIdx=0;aIdx<ecmScrInfoForArcVec.size();++aIdx)
   {
@@ -1408,6 +1614,131 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateSizeOfVars(const std::vector<std::str
   }
 }
 
+//---------------------------------------
+template<class ECM_FOR_WG>
+std::string WgProcessorForAnlp<ECM_FOR_WG>::prefixVecToStr(const std::vector<std::string>& prefixVec)const
+{
+      // The last word keeps its blank character if it is complete
+  std::string str;
+  for(unsigned int i=0;i<prefixVec.size();++i)
+  {
+    if(i>0) str+=" ";
+    str+=prefixVec[i];
+  }
+  return str;
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::clearColCache(void)
+{
+      // The entries are kept to reuse their buffers
+  colCachePrefix.clear();
+  colCacheNumEntries=0;
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::updateColCache(const std::vector<std::string>& prefixVec,
+                                                    const std::vector<std::string>& validProcPrefixVec)
+{
+  std::string prefix=prefixVecToStr(prefixVec);
+
+      // Obtain length of the common part of the prefixes
+  unsigned int commonLen=0;
+  while(commonLen<prefix.size() && commonLen<colCachePrefix.size() &&
+        prefix[commonLen]==colCachePrefix[commonLen])
+    ++commonLen;
+
+      // Truncate cache, the remaining entries are prefixes of the
+      // current one
+  while(colCacheNumEntries>0 && colCacheVec[colCacheNumEntries-1].prefixLen>commonLen)
+    --colCacheNumEntries;
+  colCachePrefix=prefix;
+
+      // Store the last position of the previous prefix if it is going
+      // to be removed and the current prefix extends it
+  if(previousPrefixVec.size()==validProcPrefixVec.size() ||
+     statesInvolvedInArcs.find(INITIAL_STATE)==statesInvolvedInArcs.end())
+    return;
+  std::string prevPrefix=prefixVecToStr(previousPrefixVec);
+  if(prevPrefix.size()>commonLen)
+    return;
+  if(colCacheNumEntries>0 && colCacheVec[colCacheNumEntries-1].prefixLen==prevPrefix.size())
+    return;
+  
+  ++colCacheNumEntries;
+  if(colCacheVec.size()<colCacheNumEntries)
+    colCacheVec.push_back(ColCacheEntry());
+  ColCacheEntry& entry=colCacheVec[colCacheNumEntries-1];
+  entry.prefixLen=prevPrefix.size();
+
+      // Store last position for states
+  entry.stateEsiVec.resize(statesInvolvedInArcs.size());
+  entry.stateBestScoreVec.resize(statesInvolvedInArcs.size());
+  entry.stateBestPredVec.resize(statesInvolvedInArcs.size());
+  unsigned int k=0;
+  StatesInvolvedInArcs::iterator iter;
+  for(iter=statesInvolvedInArcs.begin();iter!=statesInvolvedInArcs.end();++iter)
+  {
+    HypStateIndex idx=*iter;
+    ecm_wg_ptr->getLastPosFromEsi(ecmScrInfoForState[idx],entry.stateEsiVec[k]);
+    entry.stateBestScoreVec[k]=bestScoresForState[idx].back();
+    entry.stateBestPredVec[k]=bestPredsForState[idx].back();
+    ++k;
+  }
+
+      // Store last position for the words of the arcs
+  k=0;
+  for(unsigned int aIdx=0;aIdx<ecmScrInfoForArcVec.size();++aIdx)
+  {
+    for(unsigned int j=0;j<ecmScrInfoForArcVec[aIdx].size();++j)
+    {
+      if(entry.arcEsiVec.size()<=k)
+        entry.arcEsiVec.push_back(EcmScoreInfo());
+      ecm_wg_ptr->getLastPosFromEsi(ecmScrInfoForArcVec[aIdx][j],entry.arcEsiVec[k]);
+      ++k;
+    }
+  }
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+bool WgProcessorForAnlp<ECM_FOR_WG>::retrieveLastPosFromColCache(const std::vector<std::string>& prefixDiffVec)
+{
+      // Only the last word of the prefix can be restored, the entry
+      // should have been obtained for the whole current prefix
+  if(prefixDiffVec.size()!=1 || colCacheNumEntries==0 ||
+     colCacheVec[colCacheNumEntries-1].prefixLen!=colCachePrefix.size())
+    return false;
+  
+  const ColCacheEntry& entry=colCacheVec[colCacheNumEntries-1];
+
+      // Append last position for states
+  unsigned int k=0;
+  StatesInvolvedInArcs::iterator iter;
+  for(iter=statesInvolvedInArcs.begin();iter!=statesInvolvedInArcs.end();++iter)
+  {
+    HypStateIndex idx=*iter;
+    ecm_wg_ptr->appendPosToEsi(entry.stateEsiVec[k],ecmScrInfoForState[idx]);
+    bestScoresForState[idx].push_back(entry.stateBestScoreVec[k]);
+    bestPredsForState[idx].push_back(entry.stateBestPredVec[k]);
+    ++k;
+  }
+
+      // Append last position for the words of the arcs
+  k=0;
+  for(unsigned int aIdx=0;aIdx<ecmScrInfoForArcVec.size();++aIdx)
+  {
+    for(unsigned int j=0;j<ecmScrInfoForArcVec[aIdx].size();++j)
+    {
+      ecm_wg_ptr->appendPosToEsi(entry.arcEsiVec[k],ecmScrInfoForArcVec[aIdx][j]);
+      ++k;
+    }
+  }
+  return true;
+}
+
 //---------------------------------------
 template<class ECM_FOR_WG>
 bool WgProcessorForAnlp<ECM_FOR_WG>::print(const char* filename)const
@@ -30,12 +30,19 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "WgProcessorForAnlp.h"
 #include "PfsmEcmForWg.h"
 #include <string>
+#include <stdlib.h>
 
 //--------------- Function definitions
 
-extern "C" BaseWgProcessorForAnlp* create(std::string /*str*/)
+extern "C" BaseWgProcessorForAnlp* create(std::string str)
 {
-  return new WgProcessorForAnlp<PfsmEcmForWg>;
+  WgProcessorForAnlp<PfsmEcmForWg>* wgpPtr=new WgProcessorForAnlp<PfsmEcmForWg>;
+
+      // The initialization string, if given, contains the beam width
+  if(!str.empty())
+    wgpPtr->set_beam(atof(str.c_str()));
+  
+  return wgpPtr;
 }
 
 //---------------
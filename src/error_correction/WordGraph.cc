@@ -217,6 +217,16 @@ WordGraphArc WordGraph::wordGraphArcId2WordGraphArc(WordGraphArcId wordGraphArcI
   }
 }
 
+//---------------------------------------
+void WordGraph::getArcScrComps(WordGraphArcId wordGraphArcId,
+                               std::vector<Score>& scrComps)const
+{
+  if(wordGraphArcId<scrCompsVec.size())
+    scrComps=scrCompsVec[wordGraphArcId];
+  else
+    scrComps.clear();
+}
+
 //---------------------------------------
 void WordGraph::getArcsToPredStates(HypStateIndex hypStateIndex,
                                     std::vector<WordGraphArc>& wgArcs)const
@@ -365,245 +375,274 @@ void WordGraph::obtainNbestList(unsigned int len,
                                 std::vector<std::vector<Score> >& scoreCompsVec,
                                 int verbosity/*=false*/)
 {
+      // Clear nblist and scoreCompsVec output variables
+  nblist.clear();
+  scoreCompsVec.clear();
+
       // Check if word-graph is empty
   if(wordGraphArcs.empty())
+    return;
+
+      // Obtain best derivation for each state
+  KbestInfo kbInfo;
+  initKbestInfo(kbInfo);
+
+  if(verbosity>=1)
   {
-        // clear nblist and scoreCompsVec output variables
-    nblist.clear();
-    scoreCompsVec.clear();
-  }
-  else
-  {
-        // Word-graph is not empty
-        // Obtain heuristic values
-    std::vector<Score> heurForEachState;
-    obtainNbSearchHeurInfo(heurForEachState);
-  
-        // Execute A-star search
-    nbSearch(len,heurForEachState,nblist,scoreCompsVec,verbosity);
+    std::cerr<<"* Verbose info about complete hypotheses..."<<std::endl;
   }
-}
 
-//---------------------------------------
-void WordGraph::obtainNbSearchHeurInfo(std::vector<Score>& heurForEachState)
-{
-      // Clear vector
-  heurForEachState.clear();
-      // Initialize costs
-  heurForEachState.insert(heurForEachState.begin(),wordGraphStates.size(),SMALL_SCORE);
-      // Set zero cost for final states
-  FinalStateSet::const_iterator iter;
-  for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
-    heurForEachState[*iter]=0;
-      
-      // Explore arcs in reverse order
-      // WARNING: arcs must be topologically ordered
-  if(!wordGraphArcs.empty())
+      // Obtain derivations of the goal state
+  HypStateIndex goalStateIndex=wordGraphStates.size();
+  for(unsigned int k=0;k<len;++k)
   {
-    for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+    lazyKthBest(goalStateIndex,k,kbInfo);
+    if(kbInfo.derivsForState[goalStateIndex].size()<=k)
+      break;
+
+        // Obtain arcs of the derivation
+    const KbestDeriv& kbDeriv=kbInfo.derivsForState[goalStateIndex][k];
+    NbSearchHyp nbSearchHyp;
+    obtainHypForKbestDeriv(kbDeriv,kbInfo,nbSearchHyp);
+    
+        // Obtain string from hyp
+    std::vector<Score> scoreComps;
+    std::string translation=stringAssociatedToHyp(nbSearchHyp,scoreComps);
+    if(!scoreComps.empty()) scoreCompsVec.push_back(scoreComps);
+
+        // Add to vector
+    nblist.push_back(make_pair(kbDeriv.score,translation));
+
+        // Print verbose information
+    if(verbosity>=1)
     {
-      WordGraphArcId reverseWgArcId=wordGraphArcs.size()-wgArcId-1;
-      if(!arcPruned(reverseWgArcId))
+      std::cerr<<kbDeriv.score<<" ||| "<<translation<<" |||";
+      for(unsigned int j=0;j<nbSearchHyp.size();++j)
       {
-        WordGraphArc wgArc=wordGraphArcId2WordGraphArc(reverseWgArcId);
-        Score scr=wgArc.arcScore+heurForEachState[wgArc.succStateIndex];
-        if(heurForEachState[wgArc.predStateIndex]<scr)
-          heurForEachState[wgArc.predStateIndex]=scr;
+        HypStateIndex hidx=wordGraphArcs[nbSearchHyp[j]].succStateIndex;
+        std::cerr<<" "<<hidx;
       }
+      std::cerr<<std::endl;
     }
   }
 }
 
 //---------------------------------------
-void WordGraph::nbSearch(unsigned int len,
-                         const std::vector<Score>& heurForEachState,
-                         std::vector<std::pair<Score,std::string> >& nblist,
-                         std::vector<std::vector<Score> >& scoreCompsVec,
-                         int verbosity/*=false*/)
+void WordGraph::initKbestInfo(KbestInfo& kbInfo)const
 {
-  // Perform A-star search
-
-      // Create null hypothesis
-  NbSearchHyp nbSearchHyp;
-
-      // Declare stack and set maximum size
-  NbSearchStack nbSearchStack;
-  nbSearchStack.setMaxStackSize(NBEST_MAX_STACK_SIZE);
-
-      // Push null hypothesis
-  nbSearchStack.push(initialStateScore+heurForEachState[INITIAL_STATE],nbSearchHyp);
-
-      // Declare stack to store complete hyps
-  NbSearchStack completeHypStack;
+      // Make room for the derivations of the states plus the goal
+      // state
+  HypStateIndex goalStateIndex=wordGraphStates.size();
+  kbInfo.derivsForState.clear();
+  kbInfo.derivsForState.resize(wordGraphStates.size()+1);
+  kbInfo.candsForState.clear();
+  kbInfo.candsForState.resize(wordGraphStates.size()+1);
+  kbInfo.candsInitialized.clear();
+  kbInfo.candsInitialized.resize(wordGraphStates.size()+1,false);
+
+      // The initial state has only one derivation, which contains no
+      // arcs
+  KbestDeriv kbDeriv;
+  kbDeriv.score=initialStateScore;
+  kbDeriv.arcId=INVALID_ARCID;
+  kbDeriv.predStateIndex=INVALID_STATE;
+  kbDeriv.predRank=0;
+  kbInfo.derivsForState[INITIAL_STATE].push_back(kbDeriv);
+  kbInfo.candsInitialized[INITIAL_STATE]=true;
   
-      // Iterate
-  unsigned int numIters=0;
-  bool end=false;
-  while(!end)
+      // Obtain best derivations in topological order
+      // WARNING: arcs must be topologically ordered
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
   {
-    if(verbosity>=1)
-      std::cerr<<"* Iteration "<<numIters<<std::endl;
-    
-        // Check if there are "len" complete hypotheses
-    if(completeHypStack.size()>=len)
-    {
-      end=true;
-    }
-    else
+    if(!arcPruned(wgArcId))
     {
-          // Check if stack is empty
-      if(!nbSearchStack.empty())
+      const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
+      std::vector<KbestDeriv>& predDerivs=kbInfo.derivsForState[wgArc.predStateIndex];
+      std::vector<KbestDeriv>& succDerivs=kbInfo.derivsForState[wgArc.succStateIndex];
+      if(!predDerivs.empty() && wgArc.succStateIndex!=INITIAL_STATE)
       {
-            // Pop top of the stack
-        std::pair<Score,NbSearchHyp> scrHypPair=nbSearchStack.top();
-        nbSearchStack.pop();
-
-            // Obtain index of last state
-        HypStateIndex lastHypStateIndex;
-        if(scrHypPair.second.empty())
-          lastHypStateIndex=INITIAL_STATE;
+        kbDeriv.score=predDerivs[0].score+wgArc.arcScore;
+        kbDeriv.arcId=wgArcId;
+        kbDeriv.predStateIndex=wgArc.predStateIndex;
+        kbDeriv.predRank=0;
+        if(succDerivs.empty())
+          succDerivs.push_back(kbDeriv);
         else
         {
-          WordGraphArc wgArc=wordGraphArcId2WordGraphArc(scrHypPair.second.back());
-          lastHypStateIndex=wgArc.succStateIndex;
-        }
-        
-            // Subtract heuristic
-        scrHypPair.first-=heurForEachState[lastHypStateIndex];
-
-        if(verbosity>=1)
-        {
-          std::cerr<<"- Top of the stack: "<<scrHypPair.first<<" ;";
-          for(unsigned int j=0;j<scrHypPair.second.size();++j)
-            std::cerr<<" "<<scrHypPair.second[j];
-          std::cerr<<std::endl;
-        }
-
-            // Check if hyp is complete
-        if(hypIsComplete(scrHypPair.second))
-        {
-          completeHypStack.push(scrHypPair.first,scrHypPair.second);
-        }
-        else
-        {
-          if(verbosity>=1)
-            std::cerr<<"- Expanding top of the stack..."<<std::endl;
-
-            // Expand hypothesis
-          std::vector<WordGraphArcId> wgArcIds;
-          getArcIdsToSuccStates(lastHypStateIndex,wgArcIds);
-
-          std::vector<std::pair<Score,NbSearchHyp> > scrHypPairVec;
-          for(unsigned int i=0;i<wgArcIds.size();++i)
-          {
-            if(!arcPruned(wgArcIds[i]))
-            {
-              WordGraphArc wgArc=wordGraphArcId2WordGraphArc(wgArcIds[i]);
-              std::pair<Score,NbSearchHyp> newScrHypPair;
-              newScrHypPair=scrHypPair;
-                  // Obtain new score
-              newScrHypPair.first+=wgArc.arcScore;
-                  // Add heuristic
-              newScrHypPair.first+=heurForEachState[wgArc.succStateIndex];   
-                  // Add new arc
-              newScrHypPair.second.push_back(wgArcIds[i]);
-                  // Push into vector
-              scrHypPairVec.push_back(newScrHypPair);
-
-              if(verbosity>=1)
-              {
-                std::cerr<<"  Adding extension, score contribution: "<<wgArc.arcScore<<" ; successor state: "<<wgArc.succStateIndex<<std::endl;
-              }
-            }
-          }
-          
-            // Push results into the stack
-          for(unsigned int i=0;i<scrHypPairVec.size();++i)
-          {
-            nbSearchStack.push(scrHypPairVec[i].first,scrHypPairVec[i].second);
-          }
+          if(succDerivs[0].score<kbDeriv.score)
+            succDerivs[0]=kbDeriv;
         }
       }
+    }
+  }
+
+      // Obtain best derivation of the goal state. Derivations without
+      // arcs are not considered
+  FinalStateSet::const_iterator iter;
+  for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
+  {
+    std::vector<KbestDeriv>& finalDerivs=kbInfo.derivsForState[*iter];
+    std::vector<KbestDeriv>& goalDerivs=kbInfo.derivsForState[goalStateIndex];
+    if(*iter!=INITIAL_STATE && !finalDerivs.empty())
+    {
+      kbDeriv.score=finalDerivs[0].score;
+      kbDeriv.arcId=INVALID_ARCID;
+      kbDeriv.predStateIndex=*iter;
+      kbDeriv.predRank=0;
+      if(goalDerivs.empty())
+        goalDerivs.push_back(kbDeriv);
       else
       {
-            // Stack is empty
-        end=true;
+        if(goalDerivs[0].score<kbDeriv.score)
+          goalDerivs[0]=kbDeriv;
       }
     }
-    ++numIters;
-    if(verbosity>=1) std::cerr<<std::endl;
-  }          
-      // Obtain result
-  nblist.clear();
-  scoreCompsVec.clear();
-  if(verbosity>=1)
-  {
-    std::cerr<<"* Verbose info about complete hypotheses..."<<std::endl;
   }
-  
-  while(!completeHypStack.empty())
+}
+
+//---------------------------------------
+void WordGraph::lazyKthBest(HypStateIndex hypStateIndex,
+                            unsigned int k,
+                            KbestInfo& kbInfo)const
+{
+      // States without derivations are not reachable from the initial
+      // state
+  if(kbInfo.derivsForState[hypStateIndex].empty())
+    return;
+
+      // Initialize candidates if necessary
+  if(!kbInfo.candsInitialized[hypStateIndex])
+    getKbestCandidates(hypStateIndex,kbInfo);
+
+  std::vector<KbestDeriv>& derivs=kbInfo.derivsForState[hypStateIndex];
+  std::priority_queue<KbestDeriv>& cands=kbInfo.candsForState[hypStateIndex];
+  while(derivs.size()<=k)
   {
-        // Pop top of the stack
-    std::pair<Score,NbSearchHyp> scrHypPair=completeHypStack.top();
-    completeHypStack.pop();
+        // Add the successors of the last derivation to the candidates.
+        // NOTE: a copy of the derivation is passed since the
+        // recursive calls do not modify the derivations of this state
+    KbestDeriv lastDeriv=derivs.back();
+    lazyNext(hypStateIndex,lastDeriv,kbInfo);
+
+        // Obtain next best derivation
+    if(cands.empty())
+      break;
+    derivs.push_back(cands.top());
+    cands.pop();
+  }
+}
 
-        // Obtain string from hyp
-    std::vector<Score> scoreComps;
-    std::string translation=stringAssociatedToHyp(scrHypPair.second,scoreComps);
-    if(!scoreComps.empty()) scoreCompsVec.push_back(scoreComps);
-      
-        // Add to vector
-    nblist.push_back(make_pair(scrHypPair.first,translation));
+//---------------------------------------
+void WordGraph::getKbestCandidates(HypStateIndex hypStateIndex,
+                                   KbestInfo& kbInfo)const
+{
+  const KbestDeriv& bestDeriv=kbInfo.derivsForState[hypStateIndex][0];
+  std::priority_queue<KbestDeriv>& cands=kbInfo.candsForState[hypStateIndex];
+  KbestDeriv kbDeriv;
+  kbDeriv.predRank=0;
 
-        // Print verbose information
-    if(verbosity>=1)
+  if(hypStateIndex==wordGraphStates.size())
+  {
+        // Goal state, the candidates are given by the best derivations
+        // of the final states
+    FinalStateSet::const_iterator iter;
+    for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
     {
-      std::cerr<<scrHypPair.first<<" ||| "<<translation<<" |||";
-      for(unsigned int j=0;j<scrHypPair.second.size();++j)
+      const std::vector<KbestDeriv>& finalDerivs=kbInfo.derivsForState[*iter];
+      if(*iter!=INITIAL_STATE && !finalDerivs.empty() && *iter!=bestDeriv.predStateIndex)
       {
-        WordGraphArc wgArc=wordGraphArcId2WordGraphArc(scrHypPair.second[j]);
-        HypStateIndex hidx=wgArc.succStateIndex;
-        std::cerr<<" "<<hidx;
+        kbDeriv.score=finalDerivs[0].score;
+        kbDeriv.arcId=INVALID_ARCID;
+        kbDeriv.predStateIndex=*iter;
+        cands.push(kbDeriv);
+      }
+    }
+  }
+  else
+  {
+        // The candidates are given by the best derivations of the
+        // predecessor states
+    const std::vector<WordGraphArcId>& arcIds=wordGraphStates[hypStateIndex].arcsToPredStates;
+    for(unsigned int i=0;i<arcIds.size();++i)
+    {
+      if(!arcPruned(arcIds[i]) && arcIds[i]!=bestDeriv.arcId)
+      {
+        const WordGraphArc& wgArc=wordGraphArcs[arcIds[i]];
+        const std::vector<KbestDeriv>& predDerivs=kbInfo.derivsForState[wgArc.predStateIndex];
+        if(!predDerivs.empty())
+        {
+          kbDeriv.score=predDerivs[0].score+wgArc.arcScore;
+          kbDeriv.arcId=arcIds[i];
+          kbDeriv.predStateIndex=wgArc.predStateIndex;
+          cands.push(kbDeriv);
+        }
       }
-      std::cerr<<std::endl;
     }
   }
+  kbInfo.candsInitialized[hypStateIndex]=true;
 }
 
 //---------------------------------------
-bool WordGraph::hypIsComplete(const NbSearchHyp& nbSearchHyp)
+void WordGraph::lazyNext(HypStateIndex hypStateIndex,
+                         const KbestDeriv& kbDeriv,
+                         KbestInfo& kbInfo)const
 {
-  if(nbSearchHyp.empty()) return false;
-  else
+      // The derivation of the initial state has no predecessor
+  if(kbDeriv.predStateIndex==INVALID_STATE)
+    return;
+
+      // Obtain next derivation of the predecessor state
+  unsigned int nextRank=kbDeriv.predRank+1;
+  lazyKthBest(kbDeriv.predStateIndex,nextRank,kbInfo);
+  const std::vector<KbestDeriv>& predDerivs=kbInfo.derivsForState[kbDeriv.predStateIndex];
+  if(predDerivs.size()>nextRank)
   {
-    WordGraphArc wgArc=wordGraphArcId2WordGraphArc(nbSearchHyp.back());
-    HypStateIndex hidx=wgArc.succStateIndex;
-    if(stateIsFinal(hidx))
-      return true;
-    else
-      return false;
+    KbestDeriv newDeriv=kbDeriv;
+    newDeriv.score=predDerivs[nextRank].score;
+    if(kbDeriv.arcId!=INVALID_ARCID)
+      newDeriv.score+=wordGraphArcs[kbDeriv.arcId].arcScore;
+    newDeriv.predRank=nextRank;
+    kbInfo.candsForState[hypStateIndex].push(newDeriv);
+  }
+}
+
+//---------------------------------------
+void WordGraph::obtainHypForKbestDeriv(const KbestDeriv& kbDeriv,
+                                       const KbestInfo& kbInfo,
+                                       NbSearchHyp& nbSearchHyp)const
+{
+  nbSearchHyp.clear();
+
+      // Follow the derivations of the predecessor states
+  const KbestDeriv* kbDerivPtr=&kbDeriv;
+  while(kbDerivPtr->predStateIndex!=INVALID_STATE)
+  {
+    if(kbDerivPtr->arcId!=INVALID_ARCID)
+      nbSearchHyp.push_back(kbDerivPtr->arcId);
+    kbDerivPtr=&kbInfo.derivsForState[kbDerivPtr->predStateIndex][kbDerivPtr->predRank];
   }
+  std::reverse(nbSearchHyp.begin(),nbSearchHyp.end());
 }
 
 //---------------------------------------
 std::string WordGraph::stringAssociatedToHyp(const NbSearchHyp& nbSearchHyp,
-                                             std::vector<Score>& scoreComps)
+                                             std::vector<Score>& scoreComps)const
 {
   std::string str;
   for(unsigned int i=0;i<nbSearchHyp.size();++i)
   {
     WordGraphArcId wgArcId=nbSearchHyp[i];
-    WordGraphArc wgArc=wordGraphArcId2WordGraphArc(wgArcId);
+    const WordGraphArc& wgArc=wordGraphArcs[wgArcId];
 
         // Add words to str
     if(i!=0)
-      str=str+" ";
+      str+=" ";
     
     for(unsigned int k=0;k<wgArc.words.size();++k)
     {
-      str=str+wgArc.words[k];
+      str+=wgArc.words[k];
       if(k!=wgArc.words.size()-1)
-        str=str+" ";
+        str+=" ";
     }
 
         // Sum score components
@@ -1226,7 +1265,7 @@ bool WordGraph::load(const char * filename)
     awk.getln();
     
         // Check if first line has component weights
-    if(awk.dollar(1)=="#")
+    if(awk.dollarEquals(1,"#"))
     {
           // Read weights
       std::vector<std::pair<std::string,float> > _compWeights;
@@ -1234,7 +1273,7 @@ bool WordGraph::load(const char * filename)
       {
         std::pair<std::string,float> compWeight;
         compWeight.first=awk.dollar(i);
-        compWeight.second=atof(awk.dollar(i+1).c_str());  
+        compWeight.second=awk.dollarAtof(i+1);  
         _compWeights.push_back(compWeight);
       }
       compWeights=_compWeights;
@@ -1248,7 +1287,7 @@ bool WordGraph::load(const char * filename)
     for(unsigned int i=1;i<=awk.NF;++i)
     {
       HypStateIndex finalState;
-      finalState=atoi(awk.dollar(i).c_str());
+      finalState=awk.dollarAtoi(i);
       finalStateSet.insert(finalState);
     }
 
@@ -1258,21 +1297,21 @@ bool WordGraph::load(const char * filename)
       if(awk.NF>=3)
       {
             // Read state indices
-        HypStateIndex predStateIndex=atoi(awk.dollar(1).c_str());
-        HypStateIndex succStateIndex=atoi(awk.dollar(2).c_str());
+        HypStateIndex predStateIndex=awk.dollarAtoi(1);
+        HypStateIndex succStateIndex=awk.dollarAtoi(2);
 
             // Read arcScore
-        Score arcScore=atof(awk.dollar(3).c_str());
+        Score arcScore=awk.dollarAtof(3);
 
             // Read score components if given
         std::vector<Score> scrVec;
         unsigned int col=4;
-        if(awk.dollar(4)=="|||")
+        if(awk.dollarEquals(4,"|||"))
         {
           col=5;
-          while(awk.dollar(col)!="|||" && col<=awk.NF)
+          while(!awk.dollarEquals(col,"|||") && col<=awk.NF)
           {
-            scrVec.push_back(atof(awk.dollar(col).c_str()));
+            scrVec.push_back(awk.dollarAtof(col));
             ++col;
           }
           ++col;
@@ -55,8 +55,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "WordGraphArcId.h"
 #include "WordGraphStateData.h"
 #include "NbSearchHyp.h"
-#include "NbSearchStack.h"
 #include <algorithm>
+#include <queue>
 #include <limits.h>
 
 //--------------- Constants ------------------------------------------
@@ -67,7 +67,6 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define UNLIMITED_DENSITY   -1
 #define DISABLE_WORDGRAPH    2
 #define SMALL_SCORE          -999999999
-#define NBEST_MAX_STACK_SIZE 10000
 
 //--------------- Classes --------------------------------------------
 
@@ -124,6 +123,10 @@ class WordGraph
       // should be called first
   WordGraphStateData getWordGraphStateData(HypStateIndex hypStateIndex)const;
   WordGraphArc wordGraphArcId2WordGraphArc(WordGraphArcId wordGraphArcId)const;
+  void getArcScrComps(WordGraphArcId wordGraphArcId,
+                      std::vector<Score>& scrComps)const;
+      // Obtains the unweighted score components of an arc, the vector
+      // is empty if they were not stored
   void getArcsToPredStates(HypStateIndex hypStateIndex,
                            std::vector<WordGraphArc>& wgArcs)const;
   void getArcIdsToPredStates(HypStateIndex hypStateIndex,
@@ -201,6 +204,13 @@ class WordGraph
                        std::vector<std::pair<Score,std::string> >& nblist,
                        std::vector<std::vector<Score> >& scoreCompsVec,
                        int verbosity=false);
+      // The n-best list is obtained by means of the lazy k-best
+      // algorithm described in [Huang and Chiang 2005] ("Better k-best
+      // parsing", Algorithm 3). Derivations are shared between the
+      // states and strings are only built for the paths returned.
+      //
+      // IMPORTANT NOTE: this function works correctly if and only if
+      // the arcs are topologically ordered
   
       // Function to obtain a wordgraph composed of useful states
       // (if wordgraph has been pruned, this function obtains a pruned
@@ -252,15 +262,49 @@ class WordGraph
       // Miscelaneous functions
   void rescoreArcsGivenWeights(const std::vector<std::pair<std::string,float> >& _compWeights);
   bool checkIfAltWeightsAppliable(const std::vector<float>& altCompWeights)const;
-  void obtainNbSearchHeurInfo(std::vector<Score>& heurForEachState);
-  void nbSearch(unsigned int len,
-                const std::vector<Score>& heurForEachState,
-                std::vector<std::pair<Score,std::string> >& nblist,
-                std::vector<std::vector<Score> >& scoreCompsVec,
-                int verbosity=false);
-  bool hypIsComplete(const NbSearchHyp& nbSearchHyp);
   std::string stringAssociatedToHyp(const NbSearchHyp& nbSearchHyp,
-                                    std::vector<Score>& scoreComps);
+                                    std::vector<Score>& scoreComps)const;
+
+      // Data structures for lazy k-best extraction. A derivation of a
+      // state is a path from the initial state to it, it is represented
+      // by its last arc and the rank of the derivation of the
+      // predecessor state. The derivations of an additional goal state
+      // (whose index is equal to the number of states) are linked to
+      // the final states by means of arcs with index INVALID_ARCID
+  struct KbestDeriv
+  {
+    Score score;
+    WordGraphArcId arcId;
+    HypStateIndex predStateIndex;
+    unsigned int predRank;
+    bool operator<(const KbestDeriv& right)const
+    {
+      return score<right.score;
+    }
+  };
+  struct KbestInfo
+  {
+    std::vector<std::vector<KbestDeriv> > derivsForState;
+    std::vector<std::priority_queue<KbestDeriv> > candsForState;
+    std::vector<bool> candsInitialized;
+  };
+
+      // Auxiliary functions for lazy k-best extraction
+  void initKbestInfo(KbestInfo& kbInfo)const;
+      // Obtains the best derivation of each state
+  void lazyKthBest(HypStateIndex hypStateIndex,
+                   unsigned int k,
+                   KbestInfo& kbInfo)const;
+      // Obtains the k-th best derivation of a state (k starts at
+      // zero) if it exists
+  void getKbestCandidates(HypStateIndex hypStateIndex,
+                          KbestInfo& kbInfo)const;
+  void lazyNext(HypStateIndex hypStateIndex,
+                const KbestDeriv& kbDeriv,
+                KbestInfo& kbInfo)const;
+  void obtainHypForKbestDeriv(const KbestDeriv& kbDeriv,
+                              const KbestInfo& kbInfo,
+                              NbSearchHyp& nbSearchHyp)const;
   Score bestPathFromFinalStateToIdxAux(HypStateIndex hypStateIndex,
                                        const std::vector<Score>& prevScores,
                                        const std::vector<WordGraphArc>& bestPredArcForStateVec,
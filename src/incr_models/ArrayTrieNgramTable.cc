@@ -0,0 +1,1048 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: ArrayTrieNgramTable                                      */
+/*                                                                  */
+/* Definitions file: ArrayTrieNgramTable.cc                         */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "ArrayTrieNgramTable.h"
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//--------------- Global variables -----------------------------------
+
+
+//--------------- Function declarations
+
+
+//--------------- Constants
+
+namespace
+{
+      // Header of the binary files. It is followed by the number of
+      // entries of each order (unsigned long long values) and by the
+      // array of each order (including its sentinel entry)
+  struct ArrayTrieFileHeader
+  {
+    char magic[8];
+    unsigned int version;
+    unsigned int numLevels;
+    unsigned long long numNgrams;
+    float srcInfoNull;
+    unsigned int reserved;
+  };
+
+  struct EntryWordLess
+  {
+    bool operator()(const ArrayTrieNgramTable::Entry& entry,WordIndex w)const
+    {
+      return entry.word<w;
+    }
+  };
+
+  float addCounts(float frozenCount,
+                  bool frozenFound,
+                  float deltaCount,
+                  bool deltaFound)
+  {
+    if(!frozenFound && !deltaFound)
+      return ARRAY_TRIE_ABSENT_COUNT;
+    float c=0;
+    if(frozenFound) c+=frozenCount;
+    if(deltaFound) c+=deltaCount;
+    return c;
+  }
+}
+
+//--------------- Classes --------------------------------------------
+
+//-------------------------
+ArrayTrieNgramTable::ArrayTrieNgramTable(void)
+{
+  numFrozenNgrams=0;
+  frozenSrcInfoNull=0;
+  mappedAddr=NULL;
+  mappedSize=0;
+  deltaSrcInfoNull=0;
+  maxDeltaSize=ARRAY_TRIE_MAX_DELTA_SIZE_DEF;
+}
+
+//-------------------------
+void ArrayTrieNgramTable::addTableEntry(const std::vector<WordIndex>& s,
+                                        const WordIndex& t,
+                                        im_pair<Count,Count> inf)
+{
+  addSrcInfo(s,inf.first);
+  addSrcTrgInfo(s,t,inf.second);
+}
+
+//-------------------------
+void ArrayTrieNgramTable::addSrcInfo(const std::vector<WordIndex>& s,
+                                     Count s_inf)
+{
+  if(s.size()!=0)
+  {
+        // Store the difference with respect to the frozen count
+    bool found;
+    const Entry* entryPtr=findFrozen(s);
+    found=(entryPtr!=NULL && entryPtr->srcCount!=ARRAY_TRIE_ABSENT_COUNT);
+    DeltaData& deltaData=deltaTable[s];
+    deltaData.srcCount=(float)s_inf-(found? entryPtr->srcCount : 0);
+    deltaData.srcCountFound=true;
+    mergeDeltaIfRequired();
+  }
+  else
+  {
+    deltaSrcInfoNull=(float)s_inf-frozenSrcInfoNull;
+  }
+}
+
+//-------------------------
+void ArrayTrieNgramTable::addSrcTrgInfo(const std::vector<WordIndex>& s,
+                                        const WordIndex& t,
+                                        Count st_inf)
+{
+  std::vector<WordIndex> ngram=s;
+  ngram.push_back(t);
+  bool oldFound;
+  float oldCount=getSrcTrgCount(ngram,oldFound);
+
+      // Store the difference with respect to the frozen count
+  const Entry* entryPtr=findFrozen(ngram);
+  bool found=(entryPtr!=NULL && entryPtr->srcTrgCount!=ARRAY_TRIE_ABSENT_COUNT);
+  DeltaData& deltaData=deltaTable[ngram];
+  deltaData.srcTrgCount=(float)st_inf-(found? entryPtr->srcTrgCount : 0);
+  deltaData.srcTrgFound=true;
+  updateTrgCount(ngram,oldCount,oldFound);
+  mergeDeltaIfRequired();
+}
+
+//-------------------------
+void ArrayTrieNgramTable::incrCountsOfEntryLog(const std::vector<WordIndex>& s,
+                                               const WordIndex& t,
+                                               LogCount lc)
+{
+  std::vector<WordIndex> ngram=s;
+  ngram.push_back(t);
+  bool oldFound;
+  float oldCount=getSrcTrgCount(ngram,oldFound);
+
+  DeltaData& ngramDeltaData=deltaTable[ngram];
+  ngramDeltaData.srcTrgCount.incr_logcount((float)lc);
+  ngramDeltaData.srcTrgFound=true;
+  updateTrgCount(ngram,oldCount,oldFound);
+
+  if(s.size()!=0)
+  {
+    DeltaData& srcDeltaData=deltaTable[s];
+    srcDeltaData.srcCount.incr_logcount((float)lc);
+    srcDeltaData.srcCountFound=true;
+  }
+  else
+  {
+    deltaSrcInfoNull.incr_logcount((float)lc);
+  }
+  mergeDeltaIfRequired();
+}
+
+//-------------------------
+im_pair<Count,Count> ArrayTrieNgramTable::infSrcTrg(const std::vector<WordIndex>& s,
+                                                   const WordIndex& t,
+                                                   bool& found)
+{
+  im_pair<Count,Count> psst;
+  bool srcFound;
+
+  psst.first=getSrcInfo(s,srcFound);
+  psst.second=getSrcTrgInfo(s,t,found);
+  return psst;
+}
+
+//-------------------------
+void ArrayTrieNgramTable::infSrcTrgBatch(const std::vector<std::vector<WordIndex> >& sVec,
+                                         const std::vector<WordIndex>& tVec,
+                                         std::vector<im_pair<Count,Count> >& infVec,
+                                         std::vector<bool>& foundVec)
+{
+  std::vector<std::vector<WordIndex> > ngramVec(sVec.size());
+  std::vector<const Entry*> srcEntryPtrVec;
+  std::vector<const Entry*> ngramEntryPtrVec;
+
+  for(unsigned int i=0;i<sVec.size();++i)
+  {
+    ngramVec[i]=sVec[i];
+    ngramVec[i].push_back(tVec[i]);
+  }
+
+      // The node of the source is visited when walking to the node of
+      // the n-gram, so a single walk per entry is required
+  findFrozenBatch(ngramVec,srcEntryPtrVec,ngramEntryPtrVec);
+
+  infVec.assign(sVec.size(),im_pair<Count,Count>());
+  foundVec.assign(sVec.size(),false);
+  for(unsigned int i=0;i<sVec.size();++i)
+  {
+    bool found;
+    if(sVec[i].size()!=0)
+    {
+      float c=getSrcCount(sVec[i],srcEntryPtrVec[i],found);
+      if(!found) infVec[i].first=0;
+      else infVec[i].first=c;
+    }
+    else
+    {
+      infVec[i].first=(float)frozenSrcInfoNull+(float)deltaSrcInfoNull;
+    }
+
+    float c=getSrcTrgCount(ngramVec[i],ngramEntryPtrVec[i],found);
+    if(!found) infVec[i].second=0;
+    else infVec[i].second=c;
+    foundVec[i]=found;
+  }
+}
+
+//-------------------------
+Count ArrayTrieNgramTable::getSrcInfo(const std::vector<WordIndex>& s,
+                                      bool& found)
+{
+  if(s.size()!=0)
+  {
+    float c=getSrcCount(s,found);
+    if(!found) return 0;
+    else return c;
+  }
+  else
+  {
+    found=true;
+    return (float)frozenSrcInfoNull+(float)deltaSrcInfoNull;
+  }
+}
+
+//-------------------------
+Count ArrayTrieNgramTable::getSrcTrgInfo(const std::vector<WordIndex>& s,
+                                         const WordIndex& t,
+                                         bool& found)
+{
+  std::vector<WordIndex> ngram=s;
+  ngram.push_back(t);
+  float c=getSrcTrgCount(ngram,found);
+  if(!found) return 0;
+  else return c;
+}
+
+//-------------------------
+Prob ArrayTrieNgramTable::pTrgGivenSrc(const std::vector<WordIndex>& s,
+                                       const WordIndex& t)
+{
+  im_pair<Count,Count> psst;
+  bool found;
+
+  psst=infSrcTrg(s,t,found);
+  if(!found)
+  {
+    return 0;
+  }
+  else
+  {
+    if((float)psst.first==0) return 0;
+    else
+    {
+      return (float)psst.second.get_c_st()/(float)psst.first.get_c_s();
+    }
+  }
+}
+
+//-------------------------
+LgProb ArrayTrieNgramTable::logpTrgGivenSrc(const std::vector<WordIndex>& s,
+                                            const WordIndex& t)
+{
+  im_pair<Count,Count> psst;
+  bool found;
+
+  psst=infSrcTrg(s,t,found);
+  if(!found)
+  {
+    return SMALL_LG_NUM;
+  }
+  else
+  {
+    if((float)psst.first<=SMALL_LG_NUM) return SMALL_LG_NUM;
+    else
+    {
+      return (float)psst.second.get_lc_st()-(float)psst.first.get_lc_s();
+    }
+  }
+}
+
+//-------------------------
+Prob ArrayTrieNgramTable::pSrcGivenTrg(const std::vector<WordIndex>& s,
+                                       const WordIndex& t)
+{
+  return logpSrcGivenTrg(s,t).get_p();
+}
+
+//-------------------------
+LgProb ArrayTrieNgramTable::logpSrcGivenTrg(const std::vector<WordIndex>& s,
+                                            const WordIndex& t)
+{
+  LogCount lc_st;
+  LogCount lc_t;
+
+  lc_t=lcTrg(t);
+  if((float)lc_t<=SMALL_LG_NUM)
+  {
+    return SMALL_LG_NUM;
+  }
+  else
+  {
+    lc_st=lcSrcTrg(s,t);
+    return (float)lc_st-(float)lc_t;
+  }
+}
+
+//-------------------------
+bool ArrayTrieNgramTable::getEntriesForSource(const std::vector<WordIndex>& s,
+                                              TrgTableNode& trgtn)
+{
+  trgtn.clear();
+  if(s.size()==0)
+    return false;
+
+  bool found;
+  Count srcInfo=getSrcInfo(s,found);
+  std::vector<WordIndex> ngram=s;
+  ngram.push_back(0);
+
+      // The entries of the frozen trie are given by the children of
+      // the node for s
+  unsigned int childLevel=s.size();
+  const Entry* entryPtr=findFrozen(s);
+  if(entryPtr!=NULL && childLevel<levelPtrVec.size())
+  {
+    for(unsigned int i=entryPtr->childBegin;i<(entryPtr+1)->childBegin;++i)
+    {
+      const Entry& entry=levelPtrVec[childLevel][i];
+      ngram.back()=entry.word;
+      float c=getSrcTrgCount(ngram,&entry,found);
+      if(found && c!=0)
+      {
+        std::pair<WordIndex,im_pair<Count,Count> > pdp;
+        pdp.first=entry.word;
+        pdp.second.first=srcInfo;
+        pdp.second.second=c;
+        trgtn.insert(pdp);
+      }
+    }
+  }
+
+      // Add the entries that are only stored in the delta table (the
+      // n-grams starting with s are contiguous in it)
+  DeltaTable::const_iterator deltaIter;
+  for(deltaIter=deltaTable.lower_bound(s);deltaIter!=deltaTable.end();++deltaIter)
+  {
+    const std::vector<WordIndex>& deltaNgram=deltaIter->first;
+    if(deltaNgram.size()<s.size() || !std::equal(s.begin(),s.end(),deltaNgram.begin()))
+      break;
+    if(deltaNgram.size()==ngram.size() && trgtn.find(deltaNgram.back())==trgtn.end())
+    {
+      float c=getSrcTrgCount(deltaNgram,found);
+      if(found && c!=0)
+      {
+        std::pair<WordIndex,im_pair<Count,Count> > pdp;
+        pdp.first=deltaNgram.back();
+        pdp.second.first=srcInfo;
+        pdp.second.second=c;
+        trgtn.insert(pdp);
+      }
+    }
+  }
+  if(trgtn.size()>0) return true;
+  else return false;
+}
+
+//-------------------------
+bool ArrayTrieNgramTable::getEntriesForTarget(const WordIndex& t,
+                                              SrcTableNode& tnode)
+{
+  tnode.clear();
+
+      // Traverse the frozen trie
+  bool found;
+  std::vector<unsigned int> pathIdxVec;
+  std::vector<WordIndex> ngram;
+  while(nextFrozenNode(pathIdxVec,ngram))
+  {
+    if(ngram.size()>1 && ngram.back()==t)
+    {
+      const Entry& entry=levelPtrVec[ngram.size()-1][pathIdxVec.back()];
+      float c=getSrcTrgCount(ngram,&entry,found);
+      if(found && c!=0)
+      {
+        std::pair<std::vector<WordIndex>,im_pair<Count,Count> > pdp;
+        pdp.first.assign(ngram.begin(),ngram.end()-1);
+        pdp.second.first=getSrcInfo(pdp.first,found);
+        pdp.second.second=c;
+        tnode.insert(pdp);
+      }
+    }
+  }
+
+      // Add the entries that are only stored in the delta table
+  DeltaTable::const_iterator deltaIter;
+  for(deltaIter=deltaTable.begin();deltaIter!=deltaTable.end();++deltaIter)
+  {
+    const std::vector<WordIndex>& deltaNgram=deltaIter->first;
+    if(deltaNgram.size()>1 && deltaNgram.back()==t && deltaIter->second.srcTrgFound)
+    {
+      std::pair<std::vector<WordIndex>,im_pair<Count,Count> > pdp;
+      pdp.first.assign(deltaNgram.begin(),deltaNgram.end()-1);
+      if(tnode.find(pdp.first)!=tnode.end())
+        continue;
+      float c=getSrcTrgCount(deltaNgram,found);
+      if(found && c!=0)
+      {
+        pdp.second.first=getSrcInfo(pdp.first,found);
+        pdp.second.second=c;
+        tnode.insert(pdp);
+      }
+    }
+  }
+  if(tnode.size()>0) return true;
+  else return false;
+}
+
+//-------------------------
+bool ArrayTrieNgramTable::getNbestForSrc(const std::vector<WordIndex>& s,
+                                         NbestTableNode<WordIndex>& nbt)
+{
+  TrgTableNode tnode;
+  TrgTableNode::iterator tNodeIter;
+  bool ret;
+
+  nbt.clear();
+  ret=getEntriesForSource(s,tnode);
+  for(tNodeIter=tnode.begin();tNodeIter!=tnode.end();++tNodeIter)
+  {
+    nbt.insert((float)tNodeIter->second.second.get_lc_st()-(float)tNodeIter->second.first.get_lc_s(),tNodeIter->first);
+  }
+  return ret;
+}
+
+//-------------------------
+bool ArrayTrieNgramTable::getNbestForTrg(const WordIndex& t,
+                                         NbestTableNode<std::vector<WordIndex> >& nbt,
+                                         int N)
+{
+  SrcTableNode tnode;
+  SrcTableNode::iterator tNodeIter;
+  bool ret;
+
+  nbt.clear();
+  ret=getEntriesForTarget(t,tnode);
+  for(tNodeIter=tnode.begin();tNodeIter!=tnode.end();++tNodeIter)
+  {
+    nbt.insert((float)tNodeIter->second.second.get_lc_st()-(float)tNodeIter->second.first.get_lc_s(),tNodeIter->first);
+  }
+
+  if(N>=0)
+    while(nbt.size()>(unsigned int) N) nbt.removeLastElement();
+
+  return ret;
+}
+
+//-------------------------
+Count ArrayTrieNgramTable::cSrcTrg(const std::vector<WordIndex>& s,
+                                   const WordIndex& t)
+{
+  bool found;
+  return getSrcTrgInfo(s,t,found);
+}
+
+//-------------------------
+Count ArrayTrieNgramTable::cSrc(const std::vector<WordIndex>& s)
+{
+  bool found;
+  return getSrcInfo(s,found);
+}
+
+//-------------------------
+Count ArrayTrieNgramTable::cTrg(const WordIndex& t)
+{
+  Count c_t=SMALL_LG_NUM;
+
+  TrgCountMap::const_iterator trgCountIter=trgCountMap.find(t);
+  if(trgCountIter!=trgCountMap.end() && trgCountIter->second>0)
+    c_t=(float)c_t+(float)trgCountIter->second;
+  return c_t;
+}
+
+//-------------------------
+LogCount ArrayTrieNgramTable::lcSrcTrg(const std::vector<WordIndex>& s,
+                                       const WordIndex& t)
+{
+  bool found;
+  Count c=getSrcTrgInfo(s,t,found);
+  if(!found) return SMALL_LG_NUM;
+  else return c.get_lc_st();
+}
+
+//-------------------------
+LogCount ArrayTrieNgramTable::lcSrc(const std::vector<WordIndex>& s)
+{
+  bool found;
+  Count c=getSrcInfo(s,found);
+  if(!found) return SMALL_LG_NUM;
+  else return c.get_lc_s();
+}
+
+//-------------------------
+LogCount ArrayTrieNgramTable::lcTrg(const WordIndex& t)
+{
+  LogCount lc_t=SMALL_LG_NUM;
+
+  TrgCountMap::const_iterator trgCountIter=trgCountMap.find(t);
+  if(trgCountIter!=trgCountMap.end() && trgCountIter->second>0)
+    lc_t=MathFuncs::lns_sumlog(lc_t,log(trgCountIter->second));
+  return lc_t;
+}
+
+//-------------------------
+void ArrayTrieNgramTable::freeze(void)
+{
+  if(deltaTable.empty())
+  {
+    frozenSrcInfoNull+=(float)deltaSrcInfoNull;
+    deltaSrcInfoNull=0;
+    return;
+  }
+
+      // Merge the n-grams of the frozen trie and the delta table
+      // (both of them are visited in lexicographic order)
+  std::vector<std::vector<Entry> > newLevelVec;
+  std::vector<WordIndex> lastNgram;
+  std::vector<unsigned int> pathIdxVec;
+  std::vector<WordIndex> frozenNgram;
+  bool frozenValid=nextFrozenNode(pathIdxVec,frozenNgram);
+  DeltaTable::const_iterator deltaIter=deltaTable.begin();
+  size_t newNumNgrams=0;
+  while(frozenValid || deltaIter!=deltaTable.end())
+  {
+    float srcTrgCount;
+    float srcCount;
+    if(frozenValid && (deltaIter==deltaTable.end() || frozenNgram<deltaIter->first))
+    {
+          // Entry only in frozen trie
+      const Entry& entry=levelPtrVec[frozenNgram.size()-1][pathIdxVec.back()];
+      srcTrgCount=entry.srcTrgCount;
+      srcCount=entry.srcCount;
+      appendNgram(newLevelVec,lastNgram,frozenNgram,srcTrgCount,srcCount);
+      frozenValid=nextFrozenNode(pathIdxVec,frozenNgram);
+    }
+    else if(!frozenValid || deltaIter->first<frozenNgram)
+    {
+          // Entry only in delta table
+      const DeltaData& deltaData=deltaIter->second;
+      srcTrgCount=addCounts(0,false,deltaData.srcTrgCount,deltaData.srcTrgFound);
+      srcCount=addCounts(0,false,deltaData.srcCount,deltaData.srcCountFound);
+      appendNgram(newLevelVec,lastNgram,deltaIter->first,srcTrgCount,srcCount);
+      ++deltaIter;
+    }
+    else
+    {
+          // Entry in both tables
+      const Entry& entry=levelPtrVec[frozenNgram.size()-1][pathIdxVec.back()];
+      const DeltaData& deltaData=deltaIter->second;
+      srcTrgCount=addCounts(entry.srcTrgCount,entry.srcTrgCount!=ARRAY_TRIE_ABSENT_COUNT,deltaData.srcTrgCount,deltaData.srcTrgFound);
+      srcCount=addCounts(entry.srcCount,entry.srcCount!=ARRAY_TRIE_ABSENT_COUNT,deltaData.srcCount,deltaData.srcCountFound);
+      appendNgram(newLevelVec,lastNgram,frozenNgram,srcTrgCount,srcCount);
+      frozenValid=nextFrozenNode(pathIdxVec,frozenNgram);
+      ++deltaIter;
+    }
+    if(srcTrgCount!=ARRAY_TRIE_ABSENT_COUNT)
+      ++newNumNgrams;
+  }
+
+      // Add sentinel entries
+  for(unsigned int l=0;l<newLevelVec.size();++l)
+  {
+    Entry sentinel;
+    sentinel.word=0;
+    sentinel.childBegin=(l+1<newLevelVec.size())? newLevelVec[l+1].size() : 0;
+    sentinel.srcTrgCount=ARRAY_TRIE_ABSENT_COUNT;
+    sentinel.srcCount=ARRAY_TRIE_ABSENT_COUNT;
+    newLevelVec[l].push_back(sentinel);
+  }
+
+      // Replace frozen trie
+  float newSrcInfoNull=frozenSrcInfoNull+(float)deltaSrcInfoNull;
+  clearFrozen();
+  ownedLevelVec.swap(newLevelVec);
+  for(unsigned int l=0;l<ownedLevelVec.size();++l)
+  {
+    levelPtrVec.push_back(&ownedLevelVec[l][0]);
+    levelSizeVec.push_back(ownedLevelVec[l].size()-1);
+  }
+  numFrozenNgrams=newNumNgrams;
+  frozenSrcInfoNull=newSrcInfoNull;
+  deltaTable.clear();
+  deltaSrcInfoNull=0;
+
+      // Recompute target counts so as to discard the rounding errors
+      // of the incremental updates
+  computeTrgCounts();
+}
+
+//-------------------------
+void ArrayTrieNgramTable::setMaxDeltaSize(size_t _maxDeltaSize)
+{
+  maxDeltaSize=_maxDeltaSize;
+}
+
+//-------------------------
+size_t ArrayTrieNgramTable::getDeltaSize(void)const
+{
+  return deltaTable.size();
+}
+
+//-------------------------
+size_t ArrayTrieNgramTable::size(void)
+{
+  size_t numNgrams=numFrozenNgrams;
+  DeltaTable::const_iterator deltaIter;
+  for(deltaIter=deltaTable.begin();deltaIter!=deltaTable.end();++deltaIter)
+  {
+    if(deltaIter->second.srcTrgFound)
+    {
+      const Entry* entryPtr=findFrozen(deltaIter->first);
+      if(entryPtr==NULL || entryPtr->srcTrgCount==ARRAY_TRIE_ABSENT_COUNT)
+        ++numNgrams;
+    }
+  }
+  return numNgrams;
+}
+
+//-------------------------
+void ArrayTrieNgramTable::clear(void)
+{
+  clearFrozen();
+  frozenSrcInfoNull=0;
+  deltaTable.clear();
+  deltaSrcInfoNull=0;
+  trgCountMap.clear();
+}
+
+//-------------------------
+bool ArrayTrieNgramTable::load(const char *fileName)
+{
+  clear();
+
+      // Map file
+  int fd=open(fileName,O_RDONLY);
+  if(fd==-1)
+  {
+    std::cerr<<"Error while opening array trie file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  struct stat fileStat;
+  if(fstat(fd,&fileStat)==-1 || (size_t)fileStat.st_size<sizeof(ArrayTrieFileHeader))
+  {
+    std::cerr<<"Error, array trie file "<<fileName<<" is not valid"<<std::endl;
+    close(fd);
+    return THOT_ERROR;
+  }
+  void* addr=mmap(NULL,fileStat.st_size,PROT_READ,MAP_SHARED,fd,0);
+  close(fd);
+  if(addr==MAP_FAILED)
+  {
+    std::cerr<<"Error while mapping array trie file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  mappedAddr=addr;
+  mappedSize=fileStat.st_size;
+
+      // Check header
+  const ArrayTrieFileHeader* headerPtr=(const ArrayTrieFileHeader*) mappedAddr;
+  size_t expectedSize=sizeof(ArrayTrieFileHeader)+headerPtr->numLevels*sizeof(unsigned long long);
+  if(strncmp(headerPtr->magic,ARRAY_TRIE_MAGIC,sizeof(headerPtr->magic))!=0 || headerPtr->version!=ARRAY_TRIE_FORMAT_VERSION || expectedSize>mappedSize)
+  {
+    std::cerr<<"Error, array trie file "<<fileName<<" has an unknown format"<<std::endl;
+    unmapFile();
+    return THOT_ERROR;
+  }
+
+      // Set pointers to the arrays of each order
+  const unsigned long long* levelSizePtr=(const unsigned long long*) (headerPtr+1);
+  const char* dataPtr=(const char*) (levelSizePtr+headerPtr->numLevels);
+  for(unsigned int l=0;l<headerPtr->numLevels;++l)
+  {
+    levelPtrVec.push_back((const Entry*) dataPtr);
+    levelSizeVec.push_back(levelSizePtr[l]);
+    expectedSize+=(levelSizePtr[l]+1)*sizeof(Entry);
+    dataPtr+=(levelSizePtr[l]+1)*sizeof(Entry);
+  }
+  if(expectedSize!=mappedSize)
+  {
+    std::cerr<<"Error, array trie file "<<fileName<<" is truncated"<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+  numFrozenNgrams=headerPtr->numNgrams;
+  frozenSrcInfoNull=headerPtr->srcInfoNull;
+  computeTrgCounts();
+
+  std::cerr<<"Array trie file "<<fileName<<" mapped ("<<numFrozenNgrams<<" n-grams)"<<std::endl;
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool ArrayTrieNgramTable::print(const char *fileName)
+{
+  freeze();
+
+      // Write to temporary file first, the current file may be mapped
+  std::string tmpFileName=fileName;
+  tmpFileName+=".tmp";
+  FILE* filePtr=fopen(tmpFileName.c_str(),"wb");
+  if(filePtr==NULL)
+  {
+    std::cerr<<"Error while printing array trie file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  ArrayTrieFileHeader header;
+  memset(&header,0,sizeof(header));
+  memcpy(header.magic,ARRAY_TRIE_MAGIC,sizeof(header.magic));
+  header.version=ARRAY_TRIE_FORMAT_VERSION;
+  header.numLevels=levelPtrVec.size();
+  header.numNgrams=numFrozenNgrams;
+  header.srcInfoNull=frozenSrcInfoNull;
+  bool ok=(fwrite(&header,sizeof(header),1,filePtr)==1);
+  for(unsigned int l=0;l<levelSizeVec.size();++l)
+  {
+    unsigned long long levelSize=levelSizeVec[l];
+    ok=ok && (fwrite(&levelSize,sizeof(levelSize),1,filePtr)==1);
+  }
+  for(unsigned int l=0;l<levelPtrVec.size();++l)
+    ok=ok && (fwrite(levelPtrVec[l],sizeof(Entry),levelSizeVec[l]+1,filePtr)==levelSizeVec[l]+1);
+  if(fclose(filePtr)!=0) ok=false;
+
+  if(!ok || rename(tmpFileName.c_str(),fileName)!=0)
+  {
+    std::cerr<<"Error while printing array trie file "<<fileName<<std::endl;
+    remove(tmpFileName.c_str());
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+const ArrayTrieNgramTable::Entry* ArrayTrieNgramTable::findFrozen(const std::vector<WordIndex>& ngram)const
+{
+  if(ngram.empty() || ngram.size()>levelPtrVec.size())
+    return NULL;
+
+      // Walk the trie with binary searches over contiguous ranges
+  unsigned int begin=0;
+  unsigned int end=levelSizeVec[0];
+  for(unsigned int l=0;l<ngram.size();++l)
+  {
+    const Entry* levelPtr=levelPtrVec[l];
+    const Entry* entryPtr=std::lower_bound(levelPtr+begin,levelPtr+end,ngram[l],EntryWordLess());
+    if(entryPtr==levelPtr+end || entryPtr->word!=ngram[l])
+      return NULL;
+    if(l+1==ngram.size())
+      return entryPtr;
+    begin=entryPtr->childBegin;
+    end=(entryPtr+1)->childBegin;
+  }
+  return NULL;
+}
+
+//-------------------------
+void ArrayTrieNgramTable::findFrozenBatch(const std::vector<std::vector<WordIndex> >& ngramVec,
+                                          std::vector<const Entry*>& prefixEntryPtrVec,
+                                          std::vector<const Entry*>& entryPtrVec)const
+{
+  unsigned int numLevels=levelPtrVec.size();
+  std::vector<unsigned int> beginVec(ngramVec.size(),0);
+  std::vector<unsigned int> endVec(ngramVec.size(),numLevels>0? levelSizeVec[0] : 0);
+  std::vector<bool> activeVec(ngramVec.size(),false);
+  unsigned int maxLength=0;
+
+  prefixEntryPtrVec.assign(ngramVec.size(),(const Entry*)NULL);
+  entryPtrVec.assign(ngramVec.size(),(const Entry*)NULL);
+  for(unsigned int i=0;i<ngramVec.size();++i)
+  {
+    if(!ngramVec[i].empty() && ngramVec[i].size()<=numLevels)
+    {
+      activeVec[i]=true;
+      if(ngramVec[i].size()>maxLength)
+        maxLength=ngramVec[i].size();
+    }
+  }
+
+      // Advance every walk one level at a time, the child range of a
+      // node is prefetched while the other walks are processed
+  for(unsigned int l=0;l<maxLength;++l)
+  {
+    const Entry* levelPtr=levelPtrVec[l];
+    for(unsigned int i=0;i<ngramVec.size();++i)
+    {
+      if(!activeVec[i])
+        continue;
+
+      const Entry* entryPtr=std::lower_bound(levelPtr+beginVec[i],levelPtr+endVec[i],ngramVec[i][l],EntryWordLess());
+      if(entryPtr==levelPtr+endVec[i] || entryPtr->word!=ngramVec[i][l])
+      {
+        activeVec[i]=false;
+        continue;
+      }
+      if(l+2==ngramVec[i].size())
+        prefixEntryPtrVec[i]=entryPtr;
+      if(l+1==ngramVec[i].size())
+      {
+        entryPtrVec[i]=entryPtr;
+        activeVec[i]=false;
+      }
+      else
+      {
+        beginVec[i]=entryPtr->childBegin;
+        endVec[i]=(entryPtr+1)->childBegin;
+#if __GNUC__>2
+            // The first element accessed by the binary search is the
+            // middle one
+        if(beginVec[i]<endVec[i])
+          __builtin_prefetch(levelPtrVec[l+1]+beginVec[i]+(endVec[i]-beginVec[i])/2);
+#endif
+      }
+    }
+  }
+}
+
+//-------------------------
+const ArrayTrieNgramTable::DeltaData* ArrayTrieNgramTable::findDelta(const std::vector<WordIndex>& ngram)const
+{
+  if(deltaTable.empty())
+    return NULL;
+  DeltaTable::const_iterator deltaIter=deltaTable.find(ngram);
+  if(deltaIter==deltaTable.end())
+    return NULL;
+  else
+    return &deltaIter->second;
+}
+
+//-------------------------
+float ArrayTrieNgramTable::getSrcTrgCount(const std::vector<WordIndex>& ngram,
+                                          bool& found)const
+{
+  return getSrcTrgCount(ngram,findFrozen(ngram),found);
+}
+
+//-------------------------
+float ArrayTrieNgramTable::getSrcTrgCount(const std::vector<WordIndex>& ngram,
+                                          const Entry* entryPtr,
+                                          bool& found)const
+{
+  const DeltaData* deltaDataPtr=findDelta(ngram);
+  bool frozenFound=(entryPtr!=NULL && entryPtr->srcTrgCount!=ARRAY_TRIE_ABSENT_COUNT);
+  bool deltaFound=(deltaDataPtr!=NULL && deltaDataPtr->srcTrgFound);
+  found=(frozenFound || deltaFound);
+  return addCounts(frozenFound? entryPtr->srcTrgCount : 0,frozenFound,
+                   deltaFound? (float)deltaDataPtr->srcTrgCount : 0,deltaFound);
+}
+
+//-------------------------
+float ArrayTrieNgramTable::getSrcCount(const std::vector<WordIndex>& s,
+                                       bool& found)const
+{
+  return getSrcCount(s,findFrozen(s),found);
+}
+
+//-------------------------
+float ArrayTrieNgramTable::getSrcCount(const std::vector<WordIndex>& s,
+                                       const Entry* entryPtr,
+                                       bool& found)const
+{
+  const DeltaData* deltaDataPtr=findDelta(s);
+  bool frozenFound=(entryPtr!=NULL && entryPtr->srcCount!=ARRAY_TRIE_ABSENT_COUNT);
+  bool deltaFound=(deltaDataPtr!=NULL && deltaDataPtr->srcCountFound);
+  found=(frozenFound || deltaFound);
+  return addCounts(frozenFound? entryPtr->srcCount : 0,frozenFound,
+                   deltaFound? (float)deltaDataPtr->srcCount : 0,deltaFound);
+}
+
+//-------------------------
+void ArrayTrieNgramTable::updateTrgCount(const std::vector<WordIndex>& ngram,
+                                         float oldCount,
+                                         bool oldFound)
+{
+  if(ngram.size()<2)
+    return;
+
+  bool found;
+  float newCount=getSrcTrgCount(ngram,found);
+  double incr=0;
+  if(oldFound && oldCount>0) incr-=oldCount;
+  if(found && newCount>0) incr+=newCount;
+  if(incr!=0)
+    trgCountMap[ngram[0]]+=incr;
+}
+
+//-------------------------
+void ArrayTrieNgramTable::computeTrgCounts(void)
+{
+  trgCountMap.clear();
+  std::vector<unsigned int> pathIdxVec;
+  std::vector<WordIndex> ngram;
+  while(nextFrozenNode(pathIdxVec,ngram))
+  {
+    const Entry& entry=levelPtrVec[ngram.size()-1][pathIdxVec.back()];
+    if(ngram.size()>1 && entry.srcTrgCount>0)
+      trgCountMap[ngram[0]]+=entry.srcTrgCount;
+  }
+}
+
+//-------------------------
+void ArrayTrieNgramTable::mergeDeltaIfRequired(void)
+{
+  if(maxDeltaSize>0 && deltaTable.size()>maxDeltaSize)
+    freeze();
+}
+
+//-------------------------
+bool ArrayTrieNgramTable::nextFrozenNode(std::vector<unsigned int>& pathIdxVec,
+                                         std::vector<WordIndex>& ngram)const
+{
+  if(pathIdxVec.empty())
+  {
+        // Start traversal
+    ngram.clear();
+    if(levelPtrVec.empty() || levelSizeVec[0]==0)
+      return false;
+    pathIdxVec.push_back(0);
+    ngram.push_back(levelPtrVec[0][0].word);
+    return true;
+  }
+
+      // Go to the first child if there is one
+  unsigned int l=pathIdxVec.size()-1;
+  if(l+1<levelPtrVec.size())
+  {
+    const Entry* entryPtr=levelPtrVec[l]+pathIdxVec[l];
+    if(entryPtr->childBegin<(entryPtr+1)->childBegin)
+    {
+      pathIdxVec.push_back(entryPtr->childBegin);
+      ngram.push_back(levelPtrVec[l+1][entryPtr->childBegin].word);
+      return true;
+    }
+  }
+
+      // Otherwise, go to the next sibling of the node or of its
+      // ancestors
+  while(!pathIdxVec.empty())
+  {
+    l=pathIdxVec.size()-1;
+    unsigned int end;
+    if(l==0)
+      end=levelSizeVec[0];
+    else
+      end=levelPtrVec[l-1][pathIdxVec[l-1]+1].childBegin;
+    ++pathIdxVec[l];
+    if(pathIdxVec[l]<end)
+    {
+      ngram[l]=levelPtrVec[l][pathIdxVec[l]].word;
+      return true;
+    }
+    pathIdxVec.pop_back();
+    ngram.pop_back();
+  }
+  return false;
+}
+
+//-------------------------
+void ArrayTrieNgramTable::appendNgram(std::vector<std::vector<Entry> >& newLevelVec,
+                                      std::vector<WordIndex>& lastNgram,
+                                      const std::vector<WordIndex>& ngram,
+                                      float srcTrgCount,
+                                      float srcCount)const
+{
+  if(newLevelVec.size()<ngram.size())
+    newLevelVec.resize(ngram.size());
+
+      // Obtain length of common prefix with the previous n-gram
+  unsigned int common=0;
+  while(common<lastNgram.size() && common<ngram.size() && lastNgram[common]==ngram[common])
+    ++common;
+
+      // Create nodes for the remaining words (intermediate nodes
+      // only exist if some of their descendants is stored)
+  for(unsigned int l=common;l<ngram.size();++l)
+  {
+    Entry entry;
+    entry.word=ngram[l];
+    entry.childBegin=(l+1<newLevelVec.size())? newLevelVec[l+1].size() : 0;
+    entry.srcTrgCount=ARRAY_TRIE_ABSENT_COUNT;
+    entry.srcCount=ARRAY_TRIE_ABSENT_COUNT;
+    newLevelVec[l].push_back(entry);
+  }
+  Entry& entry=newLevelVec[ngram.size()-1].back();
+  entry.srcTrgCount=srcTrgCount;
+  entry.srcCount=srcCount;
+  lastNgram=ngram;
+}
+
+//-------------------------
+void ArrayTrieNgramTable::unmapFile(void)
+{
+  if(mappedAddr!=NULL)
+  {
+    munmap(mappedAddr,mappedSize);
+    mappedAddr=NULL;
+    mappedSize=0;
+  }
+}
+
+//-------------------------
+void ArrayTrieNgramTable::clearFrozen(void)
+{
+  levelPtrVec.clear();
+  levelSizeVec.clear();
+  ownedLevelVec.clear();
+  numFrozenNgrams=0;
+  unmapFile();
+}
+
+//-------------------------
+ArrayTrieNgramTable::~ArrayTrieNgramTable()
+{
+  clearFrozen();
+}
@@ -0,0 +1,245 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: ArrayTrieNgramTable                                      */
+/*                                                                  */
+/* Prototype file: ArrayTrieNgramTable.h                            */
+/*                                                                  */
+/* Description: Read-optimized n-gram count table. N-grams are      */
+/*              stored in a trie that is frozen into one            */
+/*              contiguous sorted array per order, incremental      */
+/*              updates are stored in a small mutable delta table   */
+/*              that is periodically merged.                        */
+/*                                                                  */
+/********************************************************************/
+
+#ifndef _ArrayTrieNgramTable
+#define _ArrayTrieNgramTable
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BaseIncrCondProbTable.h"
+#include "MathFuncs.h"
+#include "ErrorDefs.h"
+#include <string>
+#include <vector>
+#include <map>
+
+//--------------- Constants ------------------------------------------
+
+#define ARRAY_TRIE_MAGIC                "THOTATRI"
+#define ARRAY_TRIE_FORMAT_VERSION       1
+#define ARRAY_TRIE_ABSENT_COUNT         -1.0f
+#define ARRAY_TRIE_MAX_DELTA_SIZE_DEF   100000
+
+//--------------- typedefs -------------------------------------------
+
+
+//--------------- function declarations ------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- ArrayTrieNgramTable class
+
+/**
+ * @brief N-gram count table optimized for lookups. The n-grams are
+ * stored in a trie that is frozen into one sorted array per order,
+ * the children of each node being a contiguous range of the array of
+ * the next order. The frozen trie can be memory-mapped from a binary
+ * file. Updates are stored as count increments in a mutable delta
+ * table, which is merged into the frozen trie when it exceeds a given
+ * size. Count semantics are the same as those of
+ * vecx_x_incr_cptable<WordIndex,Count,Count>. Query functions never
+ * modify the table, so they can be called concurrently as long as no
+ * update is performed at the same time; freeze() should be called once
+ * after the table has been loaded or built.
+ */
+
+class ArrayTrieNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>,WordIndex,Count,Count>
+{
+ public:
+
+  typedef BaseIncrCondProbTable<std::vector<WordIndex>,WordIndex,Count,Count>::SrcTableNode SrcTableNode;
+  typedef BaseIncrCondProbTable<std::vector<WordIndex>,WordIndex,Count,Count>::TrgTableNode TrgTableNode;
+
+      // Node of the frozen trie. srcTrgCount stores the count of the
+      // n-gram given by the path to the node, and srcCount its count
+      // as history. ARRAY_TRIE_ABSENT_COUNT is used for counts that are
+      // not stored. The children of the node are stored in the range
+      // [childBegin,childBegin of the next node) of the next order
+  struct Entry
+  {
+    WordIndex word;
+    unsigned int childBegin;
+    float srcTrgCount;
+    float srcCount;
+  };
+
+      // Constructor
+  ArrayTrieNgramTable(void);
+
+      // Basic functions
+  void addTableEntry(const std::vector<WordIndex>& s,
+                     const WordIndex& t,
+                     im_pair<Count,Count> inf);
+  void addSrcInfo(const std::vector<WordIndex>& s,Count s_inf);
+  void addSrcTrgInfo(const std::vector<WordIndex>& s,const WordIndex& t,Count st_inf);
+  void incrCountsOfEntryLog(const std::vector<WordIndex>& s,
+                            const WordIndex& t,
+                            LogCount lc);
+  im_pair<Count,Count> infSrcTrg(const std::vector<WordIndex>& s,
+                                 const WordIndex& t,
+                                 bool& found);
+  void infSrcTrgBatch(const std::vector<std::vector<WordIndex> >& sVec,
+                      const std::vector<WordIndex>& tVec,
+                      std::vector<im_pair<Count,Count> >& infVec,
+                      std::vector<bool>& foundVec);
+  Count getSrcInfo(const std::vector<WordIndex>& s,bool& found);
+  Count getSrcTrgInfo(const std::vector<WordIndex>& s,const WordIndex& t,bool& found);
+  Prob pTrgGivenSrc(const std::vector<WordIndex>& s,const WordIndex& t);
+  LgProb logpTrgGivenSrc(const std::vector<WordIndex>& s,const WordIndex& t);
+  Prob pSrcGivenTrg(const std::vector<WordIndex>& s,const WordIndex& t);
+  LgProb logpSrcGivenTrg(const std::vector<WordIndex>& s,const WordIndex& t);
+  bool getEntriesForSource(const std::vector<WordIndex>& s,TrgTableNode& trgtn);
+  bool getEntriesForTarget(const WordIndex& t,SrcTableNode& tnode);
+  bool getNbestForSrc(const std::vector<WordIndex>& s,NbestTableNode<WordIndex>& nbt);
+  bool getNbestForTrg(const WordIndex& t,NbestTableNode<std::vector<WordIndex> >& nbt,int N=-1);
+
+      // Count-related functions
+  Count cSrcTrg(const std::vector<WordIndex>& s,const WordIndex& t);
+  Count cSrc(const std::vector<WordIndex>& s);
+  Count cTrg(const WordIndex& t);
+  LogCount lcSrcTrg(const std::vector<WordIndex>& s,const WordIndex& t);
+  LogCount lcSrc(const std::vector<WordIndex>& s);
+  LogCount lcTrg(const WordIndex& t);
+
+      // Functions to manage the frozen trie
+  void freeze(void);
+      // Merges the delta table into the frozen trie. Updates merge it
+      // when it exceeds the maximum size, but query functions do not
+  void setMaxDeltaSize(size_t _maxDeltaSize);
+      // Sets the maximum number of entries of the delta table before
+      // it is merged. If _maxDeltaSize is zero, the delta table is
+      // only merged by explicit calls to freeze()
+  size_t getDeltaSize(void)const;
+
+      // size, clear functions
+  size_t size(void);
+  void clear(void);
+
+      // load and print functions
+  bool load(const char *fileName);
+      // Maps the frozen trie stored in the binary file fileName
+  bool print(const char *fileName);
+      // Merges the delta table and writes the frozen trie to the
+      // binary file fileName
+
+      // destructor
+  ~ArrayTrieNgramTable();
+
+ protected:
+
+  struct DeltaData
+  {
+    Count srcTrgCount;
+    Count srcCount;
+    bool srcTrgFound;
+    bool srcCountFound;
+    DeltaData(void):srcTrgCount(0),srcCount(0),srcTrgFound(false),srcCountFound(false){}
+  };
+  typedef std::map<std::vector<WordIndex>,DeltaData> DeltaTable;
+  typedef std::map<WordIndex,double> TrgCountMap;
+
+      // Frozen trie, the array of each order includes a final
+      // sentinel entry that is not taken into account in
+      // levelSizeVec. The arrays are either owned by the object or
+      // mapped from a file
+  std::vector<const Entry*> levelPtrVec;
+  std::vector<unsigned int> levelSizeVec;
+  std::vector<std::vector<Entry> > ownedLevelVec;
+  size_t numFrozenNgrams;
+  float frozenSrcInfoNull;
+
+      // Data of the mapped file
+  void* mappedAddr;
+  size_t mappedSize;
+
+      // Delta table
+  DeltaTable deltaTable;
+  Count deltaSrcInfoNull;
+  size_t maxDeltaSize;
+
+      // Sum of the positive counts of the n-grams (of order two or
+      // greater) starting with each word, as returned by cTrg(). It is
+      // recomputed when the trie is frozen or mapped and kept up to
+      // date by the update functions
+  TrgCountMap trgCountMap;
+
+      // Auxiliary functions
+  const Entry* findFrozen(const std::vector<WordIndex>& ngram)const;
+  void findFrozenBatch(const std::vector<std::vector<WordIndex> >& ngramVec,
+                       std::vector<const Entry*>& prefixEntryPtrVec,
+                       std::vector<const Entry*>& entryPtrVec)const;
+      // Batch version of findFrozen(), the walks of the different
+      // n-grams are interleaved level by level and the child range to
+      // be searched next is prefetched. prefixEntryPtrVec[i] stores the
+      // node of ngramVec[i] without its last word
+  const DeltaData* findDelta(const std::vector<WordIndex>& ngram)const;
+  float getSrcTrgCount(const std::vector<WordIndex>& ngram,bool& found)const;
+  float getSrcTrgCount(const std::vector<WordIndex>& ngram,
+                       const Entry* entryPtr,
+                       bool& found)const;
+  float getSrcCount(const std::vector<WordIndex>& s,bool& found)const;
+  float getSrcCount(const std::vector<WordIndex>& s,
+                    const Entry* entryPtr,
+                    bool& found)const;
+      // Versions of the previous functions given the frozen node of
+      // the n-gram (or NULL if it is not stored)
+  void updateTrgCount(const std::vector<WordIndex>& ngram,
+                      float oldCount,
+                      bool oldFound);
+      // Updates trgCountMap after the count of ngram has changed from
+      // oldCount (if oldFound is true)
+  void computeTrgCounts(void);
+      // Obtains trgCountMap from the frozen trie
+  void mergeDeltaIfRequired(void);
+  bool nextFrozenNode(std::vector<unsigned int>& pathIdxVec,
+                      std::vector<WordIndex>& ngram)const;
+      // Advances a depth-first traversal of the frozen trie, which
+      // visits the n-grams in lexicographic order. The traversal
+      // starts when pathIdxVec is empty, returns false when it is
+      // finished
+  void appendNgram(std::vector<std::vector<Entry> >& newLevelVec,
+                   std::vector<WordIndex>& lastNgram,
+                   const std::vector<WordIndex>& ngram,
+                   float srcTrgCount,
+                   float srcCount)const;
+      // Appends an n-gram to the trie being built, n-grams must be
+      // appended in lexicographic order
+  void unmapFile(void);
+  void clearFrozen(void);
+};
+
+#endif
@@ -96,6 +96,14 @@ class BaseIncrCondProbTable
        // SRCTRG_INFO must have a member function called get_c_st() that
        // returns the Count of s and t, and SRC_INFO must have a
        // function called get_c_s() that returns the Count of s
+   virtual void infSrcTrgBatch(const std::vector<SRCDATA>& sVec,
+                               const std::vector<TRGDATA>& tVec,
+                               std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec,
+                               std::vector<bool>& foundVec);
+       // Batch version of infSrcTrg(), infVec[i] and foundVec[i] store
+       // the result for sVec[i] and tVec[i]. Derived classes may
+       // redefine this function to overlap the lookups of the different
+       // entries
    virtual SRC_INFO getSrcInfo(const SRCDATA& s,bool& found)=0;
    virtual SRCTRG_INFO getSrcTrgInfo(const SRCDATA& s,
                                      const TRGDATA& t,
@@ -155,6 +163,23 @@ void BaseIncrCondProbTable<SRCDATA,TRGDATA,SRC_INFO,SRCTRG_INFO>::incrCountsOfEn
   incrCountsOfEntryLog(s,t,log((float)c));
 }
 
+//---------------
+template<class SRCDATA,class TRGDATA,class SRC_INFO,class SRCTRG_INFO>
+void BaseIncrCondProbTable<SRCDATA,TRGDATA,SRC_INFO,SRCTRG_INFO>::infSrcTrgBatch(const std::vector<SRCDATA>& sVec,
+                                                                                 const std::vector<TRGDATA>& tVec,
+                                                                                 std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec,
+                                                                                 std::vector<bool>& foundVec)
+{
+  infVec.clear();
+  foundVec.clear();
+  for(unsigned int i=0;i<sVec.size();++i)
+  {
+    bool found;
+    infVec.push_back(infSrcTrg(sVec[i],tVec[i],found));
+    foundVec.push_back(found);
+  }
+}
+
 //---------------
 template<class SRCDATA,class TRGDATA,class SRC_INFO,class SRCTRG_INFO>
 Count BaseIncrCondProbTable<SRCDATA,TRGDATA,SRC_INFO,SRCTRG_INFO>::cSrcTrg(const SRCDATA& s,const TRGDATA& t)
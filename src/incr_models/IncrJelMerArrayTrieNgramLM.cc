@@ -0,0 +1,123 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: IncrJelMerArrayTrieNgramLM                               */
+/*                                                                  */
+/* Definitions file: IncrJelMerArrayTrieNgramLM.cc                  */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "IncrJelMerArrayTrieNgramLM.h"
+#include <sys/stat.h>
+
+//--------------- Global variables -----------------------------------
+
+//--------------- Function declarations 
+
+//--------------- Constants
+
+
+//--------------- Classes --------------------------------------------
+
+//------------------------------
+void IncrJelMerArrayTrieNgramLM::getWordSeqLgProbGivenState(const std::vector<WordIndex>& wordVec,
+                                                            std::vector<WordIndex>& state,
+                                                            std::vector<LgProb>& lgProbVec)
+{
+  getWordSeqLgProbGivenStateFromTable(wordVec,state,lgProbVec);
+}
+
+//------------------------------
+bool IncrJelMerArrayTrieNgramLM::load(const char *fileName)
+{
+      // Load weights
+  bool retval=loadWeights(fileName);
+  if(retval==THOT_ERROR) return THOT_ERROR;
+
+      // Check whether the binary files exist
+  std::string mainFileName=getMainFileName(fileName);
+  std::string tableFileName=mainFileName+ARRAY_TRIE_LM_TABLE_EXT;
+  std::string vocabFileName=mainFileName+ARRAY_TRIE_LM_VOCAB_EXT;
+  struct stat fileStat;
+  if(stat(tableFileName.c_str(),&fileStat)==0)
+  {
+    std::cerr<<"Loading array trie language model (input: "<<fileName<<")"<<std::endl;
+
+        // Load vocabulary
+    this->clear();
+    retval=this->encPtr->load(vocabFileName.c_str());
+    if(retval==THOT_ERROR) return THOT_ERROR;
+
+        // Map array trie
+    retval=arrayTrieTablePtr->load(tableFileName.c_str());
+    if(retval==THOT_ERROR) return THOT_ERROR;
+    this->modelFileName=mainFileName;
+  }
+  else
+  {
+        // Load n-gram counts and freeze them (the delta table is not
+        // merged during the load process)
+    arrayTrieTablePtr->setMaxDeltaSize(0);
+    retval=_incrNgramLM<Count,Count>::load(fileName);
+    arrayTrieTablePtr->setMaxDeltaSize(ARRAY_TRIE_MAX_DELTA_SIZE_DEF);
+    if(retval==THOT_ERROR) return THOT_ERROR;
+    arrayTrieTablePtr->freeze();
+  }
+  return THOT_OK;
+}
+
+//------------------------------
+bool IncrJelMerArrayTrieNgramLM::print(const char *fileName)
+{
+      // Print weights
+  bool retval=printWeights(fileName);
+  if(retval==THOT_ERROR) return THOT_ERROR;
+
+      // Print vocabulary and array trie
+  std::string mainFileName=getMainFileName(fileName);
+  std::string tableFileName=mainFileName+ARRAY_TRIE_LM_TABLE_EXT;
+  std::string vocabFileName=mainFileName+ARRAY_TRIE_LM_VOCAB_EXT;
+  retval=this->encPtr->print(vocabFileName.c_str());
+  if(retval==THOT_ERROR) return THOT_ERROR;
+
+  return arrayTrieTablePtr->print(tableFileName.c_str());
+}
+
+//------------------------------
+std::string IncrJelMerArrayTrieNgramLM::getMainFileName(const char *fileName)
+{
+  std::string mainFileName;
+  if(fileIsDescriptor(fileName,mainFileName))
+  {
+    std::string descFileName=fileName;
+    return absolutizeModelFileName(descFileName,mainFileName);
+  }
+  else
+    return fileName;
+}
+
+//------------------------------
+IncrJelMerArrayTrieNgramLM::~IncrJelMerArrayTrieNgramLM()
+{
+  
+}
@@ -0,0 +1,108 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: IncrJelMerArrayTrieNgramLM                               */
+/*                                                                  */
+/* Prototype file: IncrJelMerArrayTrieNgramLM.h                     */
+/*                                                                  */
+/* Description: Class to manage encoded incremental                 */
+/*              Jelinek-Mercer ngram language                       */
+/*              models p(x|vector<x>) stored in a                   */
+/*              read-optimized array trie.                          */
+/*                                                                  */
+/********************************************************************/
+
+#ifndef _IncrJelMerArrayTrieNgramLM
+#define _IncrJelMerArrayTrieNgramLM
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "_incrJelMerNgramLM.h"
+#include "ArrayTrieNgramTable.h"
+#include <string>
+
+//--------------- Constants ------------------------------------------
+
+#define ARRAY_TRIE_LM_TABLE_EXT  ".atrie"
+#define ARRAY_TRIE_LM_VOCAB_EXT  ".atrie_vcb"
+
+//--------------- typedefs -------------------------------------------
+
+
+//--------------- function declarations ------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- IncrJelMerArrayTrieNgramLM class
+
+/**
+ * @brief Jelinek-Mercer n-gram language model whose counts are stored
+ * in an ArrayTrieNgramTable. If the binary files <prefix>.atrie and
+ * <prefix>.atrie_vcb exist, they are mapped when the model is loaded;
+ * otherwise, the regular n-gram count file is loaded and frozen into
+ * the array trie. The print() function writes the binary files.
+ */
+
+class IncrJelMerArrayTrieNgramLM: public _incrJelMerNgramLM<Count,Count>
+{
+ public:
+
+  typedef _incrJelMerNgramLM<Count,Count>::SrcTableNode SrcTableNode;
+  typedef _incrJelMerNgramLM<Count,Count>::TrgTableNode TrgTableNode;
+
+      // Constructor
+  IncrJelMerArrayTrieNgramLM():_incrJelMerNgramLM<Count,Count>()
+    {
+          // Set new pointer to table
+      arrayTrieTablePtr=new ArrayTrieNgramTable;
+      this->tablePtr=arrayTrieTablePtr;
+    }
+
+      // Probability functions using states
+  void getWordSeqLgProbGivenState(const std::vector<WordIndex>& wordVec,
+                                  std::vector<WordIndex>& state,
+                                  std::vector<LgProb>& lgProbVec);
+      // Scores the words with a single batch lookup in the table,
+      // classes derived from this one that redefine freqOfNgram() or
+      // pTrgGivenSrc() must redefine this function too
+
+      // Functions to load and print the model (including model weights)
+  bool load(const char *fileName);
+  bool print(const char *fileName);
+
+      // Destructor
+  ~IncrJelMerArrayTrieNgramLM();
+   
+ protected:
+
+  ArrayTrieNgramTable* arrayTrieTablePtr;
+
+  std::string getMainFileName(const char *fileName);
+};
+
+//---------------
+
+
+#endif
@@ -79,6 +79,14 @@ class IncrJelMerLevelDbNgramLM: public _incrJelMerNgramLM<Count,Count>
             tablePtr = new LevelDbNgramTable();
         }
 
+            // Probability functions using states
+        void getWordSeqLgProbGivenState(const std::vector<WordIndex>& wordVec,
+                                        std::vector<WordIndex>& state,
+                                        std::vector<LgProb>& lgProbVec);
+            // Scores the words with a single batch lookup in the table,
+            // classes derived from this one that redefine freqOfNgram() or
+            // pTrgGivenSrc() must redefine this function too
+
             // Functions to load and print the model (including model weights)
         bool load(const char *fileName);
         bool print(const char *fileName);
@@ -38,6 +38,14 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Classes --------------------------------------------
 
+//------------------------------
+void IncrJelMerNgramLM::getWordSeqLgProbGivenState(const std::vector<WordIndex>& wordVec,
+                                                   std::vector<WordIndex>& state,
+                                                   std::vector<LgProb>& lgProbVec)
+{
+  getWordSeqLgProbGivenStateFromTable(wordVec,state,lgProbVec);
+}
+
 //------------------------------
 IncrJelMerNgramLM::~IncrJelMerNgramLM()
 {
@@ -66,6 +66,13 @@ class IncrJelMerNgramLM: public _incrJelMerNgramLM<Count,Count>
       this->tablePtr=new vecx_x_incr_cptable<WordIndex,Count,Count>;
     }
 
+      // Probability functions using states
+  void getWordSeqLgProbGivenState(const std::vector<WordIndex>& wordVec,
+                                  std::vector<WordIndex>& state,
+                                  std::vector<LgProb>& lgProbVec);
+      // Scores the words with a single batch lookup in the table,
+      // classes derived from this one that redefine freqOfNgram() or
+      // pTrgGivenSrc() must redefine this function too
 
       // Destructor
   ~IncrJelMerNgramLM();
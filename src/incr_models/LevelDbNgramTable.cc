@@ -28,6 +28,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "LevelDbNgramTable.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
 
 //--------------- Function definitions
 
@@ -40,49 +43,145 @@ LevelDbNgramTable::LevelDbNgramTable(void)
     options.block_cache = leveldb::NewLRUCache(100 * 1048576);  // 100 MB for cache
     db = NULL;
     dbName = "";
-    // Key for null info - use the maximum allowed value as the key
-    std::vector<WordIndex> null_vec;
-    for (unsigned int i = 0; i < WORD_INDEX_MODULO_BYTES; i++)
+    bulkMaxMemBytes = EXT_SORTER_DEFAULT_MAX_MEM_BYTES;
+    bulkLoading = false;
+
+    // Metadata keys start with a zero byte, n-gram keys start with the
+    // order of the n-gram
+    std::string metadataPrefix(1, '\0');
+    dbNullKey = metadataPrefix + "null";
+    dbVersionKey = metadataPrefix + "version";
+    dbSizeKey = metadataPrefix + "size";
+    dbTrgMarginalPrefix = metadataPrefix + "trg_marginal";
+    dbTrgIndexPrefix = metadataPrefix + "trg_index";
+}
+
+//-------------------------
+std::string LevelDbNgramTable::vectorToString(const std::vector<WordIndex>& vec)const
+{
+    std::string s;
+    s.reserve(1 + 4 * vec.size());
+    s.push_back((char) vec.size());
+
+    for(size_t i = 0; i < vec.size(); i++)
     {
-        null_vec.push_back(WORD_INDEX_MODULO_BASE);
+        // Big-endian encoding keeps the numerical order of the indices
+        s.push_back((char) ((vec[i] >> 24) & 0xff));
+        s.push_back((char) ((vec[i] >> 16) & 0xff));
+        s.push_back((char) ((vec[i] >> 8) & 0xff));
+        s.push_back((char) (vec[i] & 0xff));
     }
 
-    std::string null_str(null_vec.begin(), null_vec.end());
-    dbNullKey = null_str;
+    return s;
 }
 
 //-------------------------
-std::string LevelDbNgramTable::vectorToString(const std::vector<WordIndex>& vec)const
+std::vector<WordIndex> LevelDbNgramTable::stringToVector(const std::string s)const
 {
-    std::vector<WordIndex> str;
-    str.push_back(vec.size() + 1);  // Add 1 to avoid string with leading \0
+    std::vector<WordIndex> vec;
 
-    for(size_t i = 0; i < vec.size(); i++) {
-        // Use WORD_INDEX_MODULO_BYTES bytes to encode index
-        for(int j = WORD_INDEX_MODULO_BYTES - 1; j >= 0; j--)
-        {
-            str.push_back(1 + (vec[i] / (unsigned int) pow(WORD_INDEX_MODULO_BASE, j) % WORD_INDEX_MODULO_BASE));
-        }
+    // A string length is 4 * n + 1, skip the byte storing n
+    for(size_t i = 1; i + 4 <= s.size(); i += 4)
+    {
+        WordIndex wi = ((WordIndex) (unsigned char) s[i] << 24) |
+                       ((WordIndex) (unsigned char) s[i + 1] << 16) |
+                       ((WordIndex) (unsigned char) s[i + 2] << 8) |
+                       (WordIndex) (unsigned char) s[i + 3];
+        vec.push_back(wi);
     }
 
-    std::string s(str.begin(), str.end());
+    return vec;
+}
+
+//-------------------------
+std::string LevelDbNgramTable::countToString(float count)const
+{
+    unsigned int bits;
+    memcpy(&bits, &count, sizeof(bits));
+
+    std::string s(4, '\0');
+    s[0] = (char) ((bits >> 24) & 0xff);
+    s[1] = (char) ((bits >> 16) & 0xff);
+    s[2] = (char) ((bits >> 8) & 0xff);
+    s[3] = (char) (bits & 0xff);
 
     return s;
 }
 
 //-------------------------
-std::vector<WordIndex> LevelDbNgramTable::stringToVector(const std::string s)const
+float LevelDbNgramTable::stringToCount(const leveldb::Slice& s)const
+{
+    if (s.size() != 4)
+        return 0;
+
+    const unsigned char* data = (const unsigned char*) s.data();
+    unsigned int bits = ((unsigned int) data[0] << 24) |
+                        ((unsigned int) data[1] << 16) |
+                        ((unsigned int) data[2] << 8) |
+                        (unsigned int) data[3];
+    float count;
+    memcpy(&count, &bits, sizeof(count));
+
+    return count;
+}
+
+//-------------------------
+std::string LevelDbNgramTable::sizeToString(unsigned long long size)const
+{
+    std::string s(8, '\0');
+    for(int i = 7; i >= 0; i--)
+    {
+        s[i] = (char) (size & 0xff);
+        size >>= 8;
+    }
+
+    return s;
+}
+
+//-------------------------
+unsigned long long LevelDbNgramTable::stringToSize(const leveldb::Slice& s)const
+{
+    unsigned long long size = 0;
+    const unsigned char* data = (const unsigned char*) s.data();
+    for(size_t i = 0; i < s.size(); i++)
+    {
+        size = (size << 8) | data[i];
+    }
+
+    return size;
+}
+
+//-------------------------
+std::string LevelDbNgramTable::trgMarginalKey(const WordIndex& t)const
+{
+    std::vector<WordIndex> t_vec;
+    t_vec.push_back(t);
+
+    return dbTrgMarginalPrefix + vectorToString(t_vec);
+}
+
+//-------------------------
+std::string LevelDbNgramTable::trgIndexKey(const WordIndex& t)const
+{
+    std::vector<WordIndex> t_vec;
+    t_vec.push_back(t);
+
+    return dbTrgIndexPrefix + vectorToString(t_vec);
+}
+
+//-------------------------
+std::vector<WordIndex> LevelDbNgramTable::legacyStringToVector(const std::string& s)const
 {
     std::vector<WordIndex> vec;
 
     // A string length is WORD_INDEX_MODULO_BYTES * n + 1
     // Count from 1 to skip n value (technically, n+1)
-    for(size_t i = 1; i < s.size();)
+    for(size_t i = 1; i + WORD_INDEX_MODULO_BYTES <= s.size();)
     {
         unsigned int wi = 0;
-        for(int j = WORD_INDEX_MODULO_BYTES - 1; j >= 0; j--, i++)
+        for(int j = 0; j < WORD_INDEX_MODULO_BYTES; j++, i++)
         {
-            wi += (((unsigned char) s[i]) - 1) * (unsigned int) pow(WORD_INDEX_MODULO_BASE, j);
+            wi = wi * WORD_INDEX_MODULO_BASE + (((unsigned char) s[i]) - 1);
         }
 
         vec.push_back(wi);
@@ -90,18 +189,13 @@ std::vector<WordIndex> LevelDbNgramTable::stringToVector(const std::string s)con
 
     return vec;
 }
+
 //-------------------------
 std::string LevelDbNgramTable::getDbNullKey(void)const
 {
     return dbNullKey;
 }
 
-//-------------------------
-std::vector<WordIndex> LevelDbNgramTable::getVectorDbNullKey(void)const
-{
-    return stringToVector(dbNullKey);
-}
-
 //-------------------------
 std::string LevelDbNgramTable::vectorToKey(const std::vector<WordIndex>& vec)const
 {
@@ -124,7 +218,7 @@ bool LevelDbNgramTable::retrieveData(const std::string key, float &count)const
 
     if (result.ok())
     {
-        count = atof(value_str.c_str());
+        count = stringToCount(value_str);
         return true;
     }
     else
@@ -150,14 +244,49 @@ bool LevelDbNgramTable::retrieveData(const std::vector<WordIndex>& phrase, float
 }
 
 //-------------------------
-bool LevelDbNgramTable::storeData(const std::string key, float count)
+void LevelDbNgramTable::retrieveDataBatch(const std::vector<std::string>& keyVec,
+                                          std::vector<float>& countVec,
+                                          std::vector<bool>& foundVec)const
 {
-    std::stringstream ss;
-    ss << count;
-    std::string count_str = ss.str();
+    countVec.assign(keyVec.size(), 0);
+    foundVec.assign(keyVec.size(), false);
+
+    // Sort the keys so that the database is traversed in a single pass
+    std::vector<std::pair<std::string, size_t> > sortedKeyVec;
+    for(size_t i = 0; i < keyVec.size(); i++)
+    {
+        sortedKeyVec.push_back(std::make_pair(keyVec[i], i));
+    }
+    std::sort(sortedKeyVec.begin(), sortedKeyVec.end());
+
+    leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+    for(size_t i = 0; i < sortedKeyVec.size(); i++)
+    {
+        size_t idx = sortedKeyVec[i].second;
+        if (i > 0 && sortedKeyVec[i].first == sortedKeyVec[i - 1].first)
+        {
+            // Repeated key
+            size_t prevIdx = sortedKeyVec[i - 1].second;
+            countVec[idx] = countVec[prevIdx];
+            foundVec[idx] = foundVec[prevIdx];
+            continue;
+        }
+
+        it->Seek(sortedKeyVec[i].first);
+        if (it->Valid() && it->key() == leveldb::Slice(sortedKeyVec[i].first))
+        {
+            countVec[idx] = stringToCount(it->value());
+            foundVec[idx] = true;
+        }
+    }
+    delete it;
+}
 
+//-------------------------
+bool LevelDbNgramTable::storeData(const std::string key, float count)
+{
     leveldb::WriteBatch batch;
-    batch.Put(key, count_str);
+    batch.Put(key, countToString(count));
     leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
 
     if(!s.ok())
@@ -169,19 +298,110 @@ bool LevelDbNgramTable::storeData(const std::string key, float count)
 //-------------------------
 bool LevelDbNgramTable::storeData(const std::vector<WordIndex>& phrase, float count)
 {
-    std::string key;
-
     if (phrase.size() == 0)
     {
         srcInfoNull = count;
-        key = dbNullKey;
+        return storeData(dbNullKey, count);
     }
-    else
+
+    std::string key = vectorToString(phrase);
+    float prev_count;
+    bool found = retrieveData(key, prev_count);
+
+    leveldb::WriteBatch batch;
+    batch.Put(key, countToString(count));
+
+    // Update the number of entries
+    if (!found)
+    {
+        std::string size_str;
+        unsigned long long size = 0;
+        if (db->Get(leveldb::ReadOptions(), dbSizeKey, &size_str).ok())
+            size = stringToSize(size_str);
+        batch.Put(dbSizeKey, sizeToString(size + 1));
+    }
+
+    // Update the marginal and the index of the last word (only
+    // n-grams with a non-empty history are taken into account)
+    if (phrase.size() > 1)
     {
-        key = vectorToString(phrase);
+        std::string marginal_key = trgMarginalKey(phrase.back());
+        float marginal;
+        retrieveData(marginal_key, marginal);
+        marginal += count - ((found) ? prev_count : 0);
+        batch.Put(marginal_key, countToString(marginal));
+
+        if (!found)
+            batch.Put(trgIndexKey(phrase.back()) + key, leveldb::Slice());
     }
 
-    return storeData(key, count);
+    leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
+
+    if(!s.ok())
+        std::cerr << "Storing data status: " << s.ToString() << std::endl;
+
+    return s.ok();
+}
+
+//-------------------------
+bool LevelDbNgramTable::initMetadata(void)
+{
+    leveldb::WriteBatch batch;
+    std::string version_str = sizeToString(LEVELDB_NGRAM_TABLE_FORMAT_VERSION);
+    batch.Put(dbVersionKey, version_str);
+    batch.Put(dbSizeKey, sizeToString(0));
+    batch.Put(dbNullKey, countToString(0));
+    leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
+
+    if(!s.ok())
+        std::cerr << "Storing metadata status: " << s.ToString() << std::endl;
+
+    return s.ok();
+}
+
+//-------------------------
+bool LevelDbNgramTable::checkFormatVersion(void)
+{
+    std::string version_str;
+    leveldb::Status s = db->Get(leveldb::ReadOptions(), dbVersionKey, &version_str);
+
+    if (s.ok())
+    {
+        unsigned long long version = stringToSize(version_str);
+        if (version != LEVELDB_NGRAM_TABLE_FORMAT_VERSION)
+        {
+            std::cerr << "Unsupported format version of LevelDB n-gram table: " << version << std::endl;
+            return THOT_ERROR;
+        }
+
+        return THOT_OK;
+    }
+    else if (s.IsNotFound())
+    {
+        // Databases without version are either new or stored in the
+        // legacy format
+        leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+        it->SeekToFirst();
+        bool empty = !it->Valid();
+        delete it;
+
+        if (!empty)
+        {
+            std::cerr << "LevelDB n-gram table " << dbName << " is stored in the legacy format," << std::endl;
+            std::cerr << "it can be converted with thot_convert_leveldb_ngram_table" << std::endl;
+            return THOT_ERROR;
+        }
+
+        if (!initMetadata())
+            return THOT_ERROR;
+
+        return THOT_OK;
+    }
+    else
+    {
+        std::cerr << "Reading format version status: " << s.ToString() << std::endl;
+        return THOT_ERROR;
+    }
 }
 
 //-------------------------
@@ -195,8 +415,15 @@ bool LevelDbNgramTable::init(std::string levelDbPath)
         db = NULL;
     }
 
-    if(load(levelDbPath.c_str()) != THOT_OK)
+    // Open the database without checking its format, as it is
+    // recreated
+    dbName = levelDbPath;
+    leveldb::Status status = leveldb::DB::Open(options, dbName, &db);
+    if(!status.ok())
+    {
+        std::cerr << status.ToString() << std::endl;
         return THOT_ERROR;
+    }
 
     clear();
 
@@ -242,11 +469,16 @@ bool LevelDbNgramTable::load(const char *fileName)
 
     if(status.ok())
     {
+        if(checkFormatVersion() != THOT_OK)
+        {
+            delete db;
+            db = NULL;
+            return THOT_ERROR;
+        }
+
         // Restore null count
         float null_count;
         retrieveData(dbNullKey, null_count);
-        if (null_count == 0)  // Add key if it doesn't exist
-            storeData(dbNullKey, null_count);
         srcInfoNull = null_count;
 
         return THOT_OK;
@@ -259,6 +491,217 @@ bool LevelDbNgramTable::load(const char *fileName)
     }
 }
 
+//-------------------------
+bool LevelDbNgramTable::convertLegacyDb(const char *legacyDbName)
+{
+    leveldb::DB* legacyDb;
+    leveldb::Options legacyOptions;
+    legacyOptions.create_if_missing = false;
+
+    leveldb::Status status = leveldb::DB::Open(legacyOptions, legacyDbName, &legacyDb);
+    if(!status.ok())
+    {
+        std::cerr << status.ToString() << std::endl;
+        return THOT_ERROR;
+    }
+
+    // The null key of the legacy format uses the maximum allowed value
+    std::string legacyNullKey(WORD_INDEX_MODULO_BYTES, (char) WORD_INDEX_MODULO_BASE);
+
+    leveldb::Iterator* it = legacyDb->NewIterator(leveldb::ReadOptions());
+    bool ret = THOT_OK;
+    size_t numEntries = 0;
+    for(it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        std::string key = it->key().ToString();
+        float count = atof(it->value().ToString().c_str());
+        std::vector<WordIndex> phrase;
+        if (key != legacyNullKey)
+            phrase = legacyStringToVector(key);
+
+        if (!storeData(phrase, count))
+        {
+            ret = THOT_ERROR;
+            break;
+        }
+
+        numEntries++;
+        if (numEntries % 100000 == 0)
+            std::cerr << "Converted " << numEntries << " entries" << std::endl;
+    }
+
+    if (ret == THOT_OK && !it->status().ok())
+    {
+        std::cerr << it->status().ToString() << std::endl;
+        ret = THOT_ERROR;
+    }
+
+    delete it;
+    delete legacyDb;
+
+    return ret;
+}
+
+//-------------------------
+bool LevelDbNgramTable::startBulkLoad(size_t maxMemBytes)
+{
+    if(db == NULL)
+    {
+        std::cerr << "Database must be initialized before bulk loading" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // A larger write buffer reduces the number of level-0 files. Since
+    // the keys are written in order, the files generated when flushing
+    // the buffer do not overlap and can be moved to the next level
+    // without merging them
+    options.write_buffer_size = LEVELDB_NGRAM_TABLE_BULK_WRITE_BUFFER_SIZE;
+    clear();
+
+    bulkMaxMemBytes = maxMemBytes;
+    bulkSorter.init(dbName + ".bulk_tmp_", bulkMaxMemBytes, ExternalCountSorter::KEEP_LAST);
+    bulkLoading = true;
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool LevelDbNgramTable::bulkAddTableEntry(const std::vector<WordIndex>& s,
+                                          const WordIndex& t,
+                                          im_pair<Count,Count> inf)
+{
+    if(!bulkLoading)
+    {
+        std::cerr << "Bulk loading has not been started" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // The empty n-gram is encoded as a single zero byte, as the null
+    // info key
+    if(bulkSorter.add(vectorToString(s), (float) inf.first.get_c_s()) == THOT_ERROR)
+        return THOT_ERROR;
+
+    return bulkSorter.add(vectorToString(getSrcTrg(s, t)), (float) inf.second.get_c_st());
+}
+
+//-------------------------
+bool LevelDbNgramTable::writeBulkBatch(leveldb::WriteBatch& batch,
+                                       size_t& batchSize,
+                                       bool force)
+{
+    if(batchSize == 0 || (!force && batchSize < LEVELDB_NGRAM_TABLE_BULK_BATCH_SIZE))
+        return THOT_OK;
+
+    leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
+    batch.Clear();
+    batchSize = 0;
+
+    if(!s.ok())
+    {
+        std::cerr << "Storing data status: " << s.ToString() << std::endl;
+        return THOT_ERROR;
+    }
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool LevelDbNgramTable::finishBulkLoad(void)
+{
+    if(!bulkLoading)
+    {
+        std::cerr << "Bulk loading has not been started" << std::endl;
+        return THOT_ERROR;
+    }
+    bulkLoading = false;
+
+    if(bulkSorter.sort() == THOT_ERROR)
+    {
+        bulkSorter.clear();
+        return THOT_ERROR;
+    }
+
+    // The keys of the index are generated in a different order, so they
+    // are also sorted externally
+    ExternalCountSorter indexSorter;
+    indexSorter.init(dbName + ".bulk_idx_tmp_", bulkMaxMemBytes, ExternalCountSorter::KEEP_LAST);
+
+    std::string emptyKey = vectorToString(std::vector<WordIndex>());
+    std::map<WordIndex, float> marginals;
+    unsigned long long numEntries = 0;
+    float null_count = 0;
+    leveldb::WriteBatch batch;
+    size_t batchSize = 0;
+    bool ret = THOT_OK;
+
+    // Write the n-grams in key order
+    std::string key;
+    double count;
+    while(ret == THOT_OK && bulkSorter.next(key, count))
+    {
+        if(key == emptyKey)
+        {
+            null_count = count;
+            continue;
+        }
+
+        std::string count_str = countToString(count);
+        batch.Put(key, count_str);
+        batchSize += key.size() + count_str.size();
+        numEntries++;
+
+        std::vector<WordIndex> vec = stringToVector(key);
+        if(vec.size() > 1)
+        {
+            marginals[vec.back()] += (float) count;
+            ret = indexSorter.add(trgIndexKey(vec.back()) + key, 0);
+        }
+
+        if(ret == THOT_OK)
+            ret = writeBulkBatch(batch, batchSize, false);
+
+        if(numEntries % 1000000 == 0)
+            std::cerr << "Written " << numEntries << " entries" << std::endl;
+    }
+    bulkSorter.clear();
+
+    // Write the index and the marginals
+    if(ret == THOT_OK)
+        ret = indexSorter.sort();
+    while(ret == THOT_OK && indexSorter.next(key, count))
+    {
+        batch.Put(key, leveldb::Slice());
+        batchSize += key.size();
+        ret = writeBulkBatch(batch, batchSize, false);
+    }
+    indexSorter.clear();
+
+    for(std::map<WordIndex, float>::const_iterator iter = marginals.begin();
+        ret == THOT_OK && iter != marginals.end(); ++iter)
+    {
+        std::string marginal_key = trgMarginalKey(iter->first);
+        batch.Put(marginal_key, countToString(iter->second));
+        batchSize += marginal_key.size() + sizeof(float);
+        ret = writeBulkBatch(batch, batchSize, false);
+    }
+
+    // Write the metadata
+    if(ret == THOT_OK)
+    {
+        batch.Put(dbSizeKey, sizeToString(numEntries));
+        batch.Put(dbNullKey, countToString(null_count));
+        batchSize += 1;
+        ret = writeBulkBatch(batch, batchSize, true);
+    }
+    srcInfoNull = null_count;
+
+    // Compact the database once all the data has been written
+    if(ret == THOT_OK)
+        db->CompactRange(NULL, NULL);
+
+    return ret;
+}
+
 //-------------------------
 std::vector<WordIndex> LevelDbNgramTable::getSrcTrg(const std::vector<WordIndex>& s,
                                                const WordIndex& t)const
@@ -373,6 +816,59 @@ im_pair<Count, Count> LevelDbNgramTable::infSrcTrg(const std::vector<WordIndex>&
     }
 }
 
+//-------------------------
+void LevelDbNgramTable::infSrcTrgBatch(const std::vector<std::vector<WordIndex> >& sVec,
+                                       const std::vector<WordIndex>& tVec,
+                                       std::vector<im_pair<Count,Count> >& infVec,
+                                       std::vector<bool>& foundVec)
+{
+    // Collect the keys of the sources and of the n-grams (the count of
+    // the empty source is not stored in the database)
+    std::vector<std::string> keyVec;
+    std::vector<size_t> srcKeyIdxVec;
+    std::vector<size_t> srcTrgKeyIdxVec;
+    for(size_t i = 0; i < sVec.size(); i++)
+    {
+        srcKeyIdxVec.push_back(keyVec.size());
+        if (sVec[i].size() != 0)
+            keyVec.push_back(vectorToString(sVec[i]));
+        srcTrgKeyIdxVec.push_back(keyVec.size());
+        keyVec.push_back(vectorToString(getSrcTrg(sVec[i], tVec[i])));
+    }
+
+    std::vector<float> countVec;
+    std::vector<bool> keyFoundVec;
+    retrieveDataBatch(keyVec, countVec, keyFoundVec);
+
+    infVec.assign(sVec.size(), im_pair<Count,Count>());
+    foundVec.assign(sVec.size(), false);
+    for(size_t i = 0; i < sVec.size(); i++)
+    {
+        bool found;
+        if (sVec[i].size() != 0)
+        {
+            found = keyFoundVec[srcKeyIdxVec[i]];
+            infVec[i].first = (found) ? Count(countVec[srcKeyIdxVec[i]]) : Count();
+        }
+        else
+        {
+            found = true;
+            infVec[i].first = srcInfoNull.get_c_s();
+        }
+
+        if (!found)
+        {
+            infVec[i].second = 0;
+        }
+        else
+        {
+            found = keyFoundVec[srcTrgKeyIdxVec[i]];
+            infVec[i].second = (found) ? Count(countVec[srcTrgKeyIdxVec[i]]) : Count();
+        }
+        foundVec[i] = found;
+    }
+}
+
 //-------------------------
 Count LevelDbNgramTable::getInfo(const std::vector<WordIndex>& key,
                                  bool &found)
@@ -470,28 +966,33 @@ LgProb LevelDbNgramTable::logpSrcGivenTrg(const std::vector<WordIndex>& s,
 bool LevelDbNgramTable::getEntriesForTarget(const WordIndex& t,
                                             LevelDbNgramTable::SrcTableNode& tnode)
 {
-    // Method shouldn't be widely used as it requires to
-    // iterate over the whole database
+    // The n-grams ending with t are obtained from the index of t
     std::pair<std::vector<WordIndex>, im_pair<Count, Count> > pdp;
+    std::string prefix = trgIndexKey(t);
 
     tnode.clear();  // Make sure that structure does not keep old values
-    
-    for(LevelDbNgramTable::const_iterator iter = begin(); iter != end(); iter++)
+
+    leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+    for(it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next())
     {
-        std::pair<std::vector<WordIndex>, Count> x = *iter;
+        std::string key = it->key().ToString().substr(prefix.size());
+        std::vector<WordIndex> vec = keyToVector(key);
+        float count;
 
-        if (x.first.size() > 1 && x.first.back() == t)
+        if (vec.size() > 1 && retrieveData(key, count))
         {
-            std::vector<WordIndex> src(x.first.begin(), x.first.end() - 1);
+            std::vector<WordIndex> src(vec.begin(), vec.end() - 1);
 
             pdp.first = src;
             pdp.second.first = cSrc(src);
-            pdp.second.second = x.second;
+            pdp.second.second = Count(count);
 
             tnode.insert(pdp);
         }
     }
 
+    delete it;
+
     return tnode.size() > 0;
 }
 
@@ -504,26 +1005,19 @@ bool LevelDbNgramTable::getEntriesForSource(const std::vector<WordIndex>& s,
 
     Count s_count = cSrc(s);  // Retrieve count(s)
 
-    // Define key range in which we look for target phrases
+    // The keys of the n-grams (s, t) are contiguous, since they start
+    // with the order of the n-gram followed by s
     std::vector<WordIndex> start_vec = s;
     start_vec.push_back(0);
-
-    std::vector<WordIndex> end_vec = s;
-    end_vec[end_vec.size() - 1] += 1;
-    end_vec.push_back(0);
-
     std::string start_str = vectorToKey(start_vec);
-    std::string end_str = vectorToKey(end_vec);
-
-    leveldb::Slice start = start_str;
-    leveldb::Slice end = end_str;
+    std::string prefix = start_str.substr(0, start_str.size() - 4);
 
     // Iterate over the defined key range and populate valid results
     leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
     
     trgtn.clear();  // Make sure that structure does not keep old values
     
-    for(it->Seek(start); it->Valid() && it->key().ToString() < end.ToString(); it->Next())
+    for(it->Seek(start_str); it->Valid() && it->key().starts_with(prefix); it->Next())
     {
         std::vector<WordIndex> vec = keyToVector(it->key().ToString());
 
@@ -531,7 +1025,7 @@ bool LevelDbNgramTable::getEntriesForSource(const std::vector<WordIndex>& s,
         {
             pdp.first = vec.back();  // t
             pdp.second.first = s_count;  // count(s)
-            pdp.second.second = Count(atof(it->value().ToString().c_str()));  // sount(s, t)
+            pdp.second.second = Count(stringToCount(it->value()));  // sount(s, t)
 
             if ((int) pdp.second.second.get_c_st() == 0)
                 continue;
@@ -566,21 +1060,11 @@ Count LevelDbNgramTable::cSrc(const std::vector<WordIndex>& s)
 //-------------------------
 Count LevelDbNgramTable::cTrg(const WordIndex& t)
 {
-    // Method shouldn't be widely used as it requires to
-    // iterate over the whole database
-    Count t_count = Count(0);
-
-    for(LevelDbNgramTable::const_iterator iter = begin(); iter != end(); iter++)
-    {
-        std::pair<std::vector<WordIndex>, Count> x = *iter;
-
-        if (x.first.size() > 1 && x.first.back() == t)
-        {
-            t_count += x.second;
-        }
-    }
+    // The marginal is maintained when storing the n-grams
+    float count;
+    retrieveData(trgMarginalKey(t), count);
 
-    return t_count;
+    return Count(count);
 }
 
 //-------------------------
@@ -598,22 +1082,19 @@ LogCount LevelDbNgramTable::lcSrc(const std::vector<WordIndex>& s)
 //-------------------------
 LogCount LevelDbNgramTable::lcTrg(const WordIndex& t)
 {
-    // Method shouldn't be widely used as it requires to
-    // iterate over the whole database
     return LogCount(cTrg(t).get_lc_s());
 }
 
 //-------------------------
 size_t LevelDbNgramTable::size(void)
 {
-    size_t len = 0;  // It counts also null info entry
-
-    for(LevelDbNgramTable::const_iterator iter = begin(); iter != end(); iter++, len++)
-    {
-        // Do nothing; iterates only over the elements in DB
-    }
-
-    return len;
+    // The number of entries is maintained when storing the n-grams
+    // (the null info entry is not counted)
+    std::string size_str;
+    if (db->Get(leveldb::ReadOptions(), dbSizeKey, &size_str).ok())
+        return stringToSize(size_str);
+    else
+        return 0;
 }
 
 //-------------------------
@@ -657,8 +1138,8 @@ void LevelDbNgramTable::clear(void)
             exit(3);
         }
 
-        // Clear empty key counter
-        storeData(dbNullKey, 0);
+        // Initialize metadata, including the empty key counter
+        initMetadata();
         srcInfoNull = Count();
     }
 }
@@ -680,13 +1161,10 @@ LevelDbNgramTable::~LevelDbNgramTable(void)
 LevelDbNgramTable::const_iterator LevelDbNgramTable::begin(void)const
 {
     leveldb::Iterator *local_iter = db->NewIterator(leveldb::ReadOptions());
-    local_iter->SeekToFirst();
 
-    // Skip item, if it stores nullInfo, to be compatible with other implementations
-    if (local_iter->Valid() && local_iter->key().ToString() == getDbNullKey())
-    {
-        local_iter->Next();
-    }
+    // Skip metadata (including nullInfo, to be compatible with other
+    // implementations), metadata keys start with a zero byte
+    local_iter->Seek(std::string(1, '\1'));
 
     // Check if iterator is ready to read data from it
     if(!local_iter->Valid())
@@ -714,12 +1192,6 @@ bool LevelDbNgramTable::const_iterator::operator++(void) //prefix
 {
     internalIter->Next();
 
-    // Skip item, if it stores nullInfo, to be compatible with other implementations
-    if (internalIter->Valid() && internalIter->key().ToString() == ptPtr->getDbNullKey())
-    {
-        internalIter->Next();
-    }
-
     bool isValid = internalIter->Valid();
 
     if(!isValid)
@@ -762,7 +1234,7 @@ LevelDbNgramTable::const_iterator::operator->(void)
     std::string key = internalIter->key().ToString();
     std::vector<WordIndex> key_vec = ptPtr->keyToVector(key);
 
-    float count = atof(internalIter->value().ToString().c_str());
+    float count = ptPtr->stringToCount(internalIter->value());
 
     dataItem = make_pair(key_vec, Count(count));
 
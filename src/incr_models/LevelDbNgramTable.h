@@ -31,9 +31,18 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #ifndef _LevelDbNgramTable
 #define _LevelDbNgramTable
 
+// Key encoding used by the legacy (text) format
 #define WORD_INDEX_MODULO_BASE 254
 #define WORD_INDEX_MODULO_BYTES 3
 
+// Version of the on-disk format. Version 1 is the legacy format, which
+// stored the counts as decimal text
+#define LEVELDB_NGRAM_TABLE_FORMAT_VERSION 2
+
+// Parameters of the bulk loading
+#define LEVELDB_NGRAM_TABLE_BULK_WRITE_BUFFER_SIZE (64 * 1048576)
+#define LEVELDB_NGRAM_TABLE_BULK_BATCH_SIZE (4 * 1048576)
+
 //--------------- Include files --------------------------------------
 
 #if HAVE_CONFIG_H
@@ -47,6 +56,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <sstream>
 
 #include "BaseIncrCondProbTable.h"
+#include "ExternalCountSorter.h"
 #include "ErrorDefs.h"
 
 //--------------- Constants ------------------------------------------
@@ -69,15 +79,54 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
         std::string dbName;
         std::string dbNullKey;
 
-            // Converters
+            // Keys of the metadata. Metadata keys start with a zero byte,
+            // so they are stored before the n-grams
+        std::string dbVersionKey;
+        std::string dbSizeKey;
+        std::string dbTrgMarginalPrefix;
+        std::string dbTrgIndexPrefix;
+
+            // Converters. N-gram keys store the order of the n-gram in
+            // the first byte followed by the word indices as 4-byte
+            // big-endian numbers, counts are stored as 4-byte
+            // big-endian IEEE floats
         std::string vectorToString(const std::vector<WordIndex>& vec)const;
         std::vector<WordIndex> stringToVector(const std::string s)const;
+        std::string countToString(float count)const;
+        float stringToCount(const leveldb::Slice& s)const;
+        std::string sizeToString(unsigned long long size)const;
+        unsigned long long stringToSize(const leveldb::Slice& s)const;
+        std::string trgMarginalKey(const WordIndex& t)const;
+        std::string trgIndexKey(const WordIndex& t)const;
+            // Prefix of the keys of the index of the n-grams ending
+            // with t, the key of each n-gram is appended to the prefix
+        std::vector<WordIndex> legacyStringToVector(const std::string& s)const;
         
             // Read and write data
         bool retrieveData(const std::string key, float &count)const;
         bool retrieveData(const std::vector<WordIndex>& phrase, float &count)const;
+        void retrieveDataBatch(const std::vector<std::string>& keyVec,
+                               std::vector<float>& countVec,
+                               std::vector<bool>& foundVec)const;
+            // Retrieves the data of several keys, the keys are sorted and
+            // looked up with a single iterator
         bool storeData(const std::string key, float count);
         bool storeData(const std::vector<WordIndex>& phrase, float count);
+            // Stores the count of an n-gram. The number of entries and the
+            // marginal and the index of the last word of the n-gram are
+            // updated in the same write batch
+        bool initMetadata(void);
+        bool checkFormatVersion(void);
+
+            // Data of the bulk loading
+        ExternalCountSorter bulkSorter;
+        size_t bulkMaxMemBytes;
+        bool bulkLoading;
+        bool writeBulkBatch(leveldb::WriteBatch& batch,
+                            size_t& batchSize,
+                            bool force);
+            // Writes the batch if its size exceeds the bulk batch size
+            // or force is true
 
             // Returns information related to a given key.
         Count getInfo(const std::vector<WordIndex>& key, bool &found);
@@ -101,8 +150,20 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
         bool drop();
             // Wrapper for loading existing levelDB
         bool load(const char *fileName);
+            // Adds the entries of a database stored in the legacy format
+        bool convertLegacyDb(const char *legacyDbName);
         //bool load(std::string fileName);
 
+          // Bulk loading. The entries added between startBulkLoad() and
+          // finishBulkLoad() replace the contents of the table. They are
+          // sorted and aggregated externally using at most maxMemBytes
+          // bytes of memory and written in key order in large batches
+        bool startBulkLoad(size_t maxMemBytes = EXT_SORTER_DEFAULT_MAX_MEM_BYTES);
+        bool bulkAddTableEntry(const std::vector<WordIndex>& s, const WordIndex& t, im_pair<Count,Count> inf);
+            // Equivalent to addTableEntry(), if an entry is added more
+            // than once the last counts are kept
+        bool finishBulkLoad(void);
+
           // Basic functions
           // TODO Ordering by n-gram value
 
@@ -118,6 +179,10 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
         im_pair<Count,Count> infSrcTrg(const std::vector<WordIndex>& s,
                                       const WordIndex& t,
                                       bool& found);
+        void infSrcTrgBatch(const std::vector<std::vector<WordIndex> >& sVec,
+                            const std::vector<WordIndex>& tVec,
+                            std::vector<im_pair<Count,Count> >& infVec,
+                            std::vector<bool>& foundVec);
         Count getSrcInfo(const std::vector<WordIndex>& s, bool& found);
         Count getSrcTrgInfo(const std::vector<WordIndex>& s, const WordIndex& t, bool& found);
         Prob pTrgGivenSrc(const std::vector<WordIndex>& s, const WordIndex& t);
@@ -189,7 +254,6 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
 
         // Key and getter for nullInfo
         std::string getDbNullKey(void)const;
-        std::vector<WordIndex> getVectorDbNullKey(void)const;
 
 };
 
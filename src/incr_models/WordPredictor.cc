@@ -103,7 +103,7 @@ bool WordPredictor::loadFileWithAdditionalInfo(const char *fileName)
     {
       if(fileStream.NF==1)
       {
-        numSentsToRetain=atoi(fileStream.dollar(1).c_str());
+        numSentsToRetain=fileStream.dollarAtoi(1);
         std::cerr<<"numSentsToRetain= "<<numSentsToRetain<<std::endl;
         fileStream.close();
         return THOT_OK;
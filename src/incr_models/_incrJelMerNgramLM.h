@@ -109,11 +109,28 @@ class _incrJelMerNgramLM: public _incrNgramLM<SRC_INFO,SRCTRG_INFO>
       // Weights related functions
   double getJelMerWeight(const std::vector<WordIndex>& s,
                          const WordIndex& t);
+  double getJelMerWeightGivenFreq(unsigned int histLength,
+                                 double c);
   virtual double freqOfNgram(const std::vector<WordIndex>& s);
 
+      // Function to score word sequences with batch lookups
+  void getWordSeqLgProbGivenStateFromTable(const std::vector<WordIndex>& wordVec,
+                                           std::vector<WordIndex>& state,
+                                           std::vector<LgProb>& lgProbVec);
+      // Obtains the counts required by all the words with a single
+      // batch lookup in the table and interpolates them as
+      // pTrgGivenSrc() does, taking the frequencies used to select the
+      // weights from the source counts of the table, as freqOfNgram()
+      // does. Since it does not call these virtual functions, it is
+      // only used by the classes that do not redefine them
+
       // Recursive function to interpolate models
   Prob pTrgGivenSrcRec(const std::vector<WordIndex>& s,
                        const WordIndex& t);
+
+      // Auxiliary functions
+  void removeExtraBosSymbols(const std::vector<WordIndex>& s,
+                             std::vector<WordIndex>& aux_s);
 };
 
 //--------------- Template function definitions
@@ -124,8 +141,72 @@ Prob _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::pTrgGivenSrc(const std::vector<Wo
                                                             const WordIndex& t)
 {
       // Remove extra BOS symbols
-  bool found;
   std::vector<WordIndex> aux_s;
+  removeExtraBosSymbols(s,aux_s);
+
+      // Calculate interpolated probability
+  Prob p=pTrgGivenSrcRec(aux_s,t);
+  return p;
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+void _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getWordSeqLgProbGivenStateFromTable(const std::vector<WordIndex>& wordVec,
+                                                                                   std::vector<WordIndex>& state,
+                                                                                   std::vector<LgProb>& lgProbVec)
+{
+      // Collect the histories of every order for each word, from the
+      // longest one to the empty one, the state of each word is
+      // obtained by shifting the previous one
+  std::vector<std::vector<WordIndex> > histVec;
+  std::vector<WordIndex> trgVec;
+  std::vector<unsigned int> firstHistIdxVec;
+  for(unsigned int i=0;i<wordVec.size();++i)
+  {
+    std::vector<WordIndex> aux_s;
+    removeExtraBosSymbols(state,aux_s);
+    firstHistIdxVec.push_back(histVec.size());
+    for(unsigned int k=0;k<=aux_s.size();++k)
+    {
+      histVec.push_back(std::vector<WordIndex>(aux_s.begin()+k,aux_s.end()));
+      trgVec.push_back(wordVec[i]);
+    }
+    _incrNgramLM<SRC_INFO,SRCTRG_INFO>::addNextWordToState(wordVec[i],state);
+  }
+  firstHistIdxVec.push_back(histVec.size());
+
+      // Look up all the entries at once
+  std::vector<im_pair<SRC_INFO,SRCTRG_INFO> > infVec;
+  std::vector<bool> foundVec;
+  this->tablePtr->infSrcTrgBatch(histVec,trgVec,infVec,foundVec);
+
+      // Interpolate the probabilities of each query starting from the
+      // empty history, as done by pTrgGivenSrcRec()
+  lgProbVec.clear();
+  double zerogramprob=(double)1.0/(double)this->getVocabSize();
+  for(unsigned int i=0;i<wordVec.size();++i)
+  {
+    double p=zerogramprob;
+    for(unsigned int j=firstHistIdxVec[i+1];j>firstHistIdxVec[i];--j)
+    {
+      unsigned int idx=j-1;
+      Prob ptable=0;
+      if(foundVec[idx] && (float)infVec[idx].first!=0)
+        ptable=(float)infVec[idx].second.get_c_st()/(float)infVec[idx].first.get_c_s();
+      double weight=getJelMerWeightGivenFreq(histVec[idx].size(),(double)infVec[idx].first.get_c_s());
+      p=weight * (double) ptable + (1-weight) * p;
+    }
+    lgProbVec.push_back(log(p));
+  }
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+void _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::removeExtraBosSymbols(const std::vector<WordIndex>& s,
+                                                                     std::vector<WordIndex>& aux_s)
+{
+  bool found;
+  aux_s.clear();
   if(s.size()>=2)
   {
     unsigned int i=0;
@@ -138,10 +219,6 @@ Prob _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::pTrgGivenSrc(const std::vector<Wo
       aux_s.push_back(s[i]);
   }
   else aux_s=s;
-
-      // Calculate interpolated probability
-  Prob p=pTrgGivenSrcRec(aux_s,t);
-  return p;
 }
 
 //---------------
@@ -308,10 +385,24 @@ double _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getJelMerWeight(const std::vect
     return weights[s.size()];
   }
   else
+  {
+    return getJelMerWeightGivenFreq(s.size(),freqOfNgram(s));
+  }
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+double _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getJelMerWeightGivenFreq(unsigned int histLength,
+                                                                          double c)
+{
+  if(numBucketsPerOrder==1)
+  {
+    return weights[histLength];
+  }
+  else
   {
         // Init variables
-    unsigned int order=s.size()+1;
-    double c=freqOfNgram(s);
+    unsigned int order=histLength+1;
     unsigned int bucketIdx=(unsigned int) trunc(c/sizeOfBucket);
     if(bucketIdx>numBucketsPerOrder-1)
       bucketIdx=numBucketsPerOrder-1;
@@ -379,12 +470,12 @@ bool _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::loadWeights(const char *prefixOfL
     std::cerr<<"Loading weights from "<<weightFileName<<std::endl;
     if(awk.getln())
     {
-      this->ngramOrder=atoi(awk.dollar(1).c_str());
-      numBucketsPerOrder=atoi(awk.dollar(2).c_str());
-      sizeOfBucket=(double)atof(awk.dollar(3).c_str());
+      this->ngramOrder=awk.dollarAtoi(1);
+      numBucketsPerOrder=awk.dollarAtoi(2);
+      sizeOfBucket=(double)awk.dollarAtof(3);
       for(unsigned int i=4;i<=awk.NF;++i)
       {
-        weights.push_back((double)atof(awk.dollar(i).c_str()));
+        weights.push_back((double)awk.dollarAtof(i));
       }
       awk.close();
       return THOT_OK;
@@ -507,8 +507,8 @@ bool _incrNgramLM<SRC_INFO,SRCTRG_INFO>::load_ngrams(const char *fileName)
           }
         }
         ht=awk.dollar(awk.NF-2);
-        inf.first=atof(awk.dollar(awk.NF-1).c_str());
-        inf.second=atof(awk.dollar(awk.NF).c_str());       
+        inf.first=awk.dollarAtof(awk.NF-1);
+        inf.second=awk.dollarAtof(awk.NF);       
         addTableEntryHigh(hs,ht,inf);
       }
     }
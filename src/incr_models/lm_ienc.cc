@@ -28,13 +28,17 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "lm_ienc.h"
+#include <fstream>
+#include <iostream>
 
 //--------------- lm_ienc class functions
 //
 
 //---------------
-lm_ienc::lm_ienc():vecx_x_incr_enc<std::string,WordIndex>()
+lm_ienc::lm_ienc()
 {
+  clear();
+  
       // Introduce standard symbols
   addHTrgCode(UNK_SYMBOL_STR,UNK_SYMBOL);
   addHTrgCode(BOS_STR,S_BEGIN);
@@ -54,22 +58,21 @@ lm_ienc::lm_ienc():vecx_x_incr_enc<std::string,WordIndex>()
 bool lm_ienc::HighSrc_to_Src(const std::vector<std::string>& hs,
                              std::vector<WordIndex>& s)
 {
-  std::map<std::string,WordIndex>::iterator iter;
   unsigned int i;
   bool retval=true;
   
   s.clear();
   for(i=0;i<hs.size();++i)
   {
-    iter=hx_to_x.find(hs[i]);
-    if(iter==hx_to_x.end())
+    WordIndex x;
+    if(!vocab.find(hs[i],x))
     {
       retval=false;
       s.push_back(UNK_SYMBOL);
     }
     else
     {
-      s.push_back(iter->second);
+      s.push_back(x);
     }
   }
   return retval;
@@ -79,17 +82,178 @@ bool lm_ienc::HighSrc_to_Src(const std::vector<std::string>& hs,
 bool lm_ienc::HighTrg_to_Trg(const std::string& ht,
                              WordIndex& t)
 {
-  std::map<std::string,WordIndex>::iterator iter;
-
-  iter=hx_to_x.find(ht);
-  if(iter==hx_to_x.end())
+  if(!vocab.find(ht,t))
   {
     t=UNK_SYMBOL;
     return false;
   }
   else
   {
-    t=iter->second;
     return true;
   }
 }
+
+//---------------
+bool lm_ienc::Src_to_HighSrc(const std::vector<WordIndex>& s,
+                             std::vector<std::string>& hs)
+{
+  unsigned int i;
+
+  hs.clear();
+  for(i=0;i<s.size();++i)
+  {
+    const char* word=vocab.getWord(s[i]);
+    if(word==NULL)
+    {
+      return false;
+    }
+    else
+    {
+      hs.push_back(word);
+    }
+  }
+  return true;
+}
+
+//---------------
+bool lm_ienc::Trg_to_HighTrg(const WordIndex& t,
+                             std::string& ht)
+{
+  const char* word=vocab.getWord(t);
+  if(word==NULL)
+  {
+    return false;
+  }
+  else
+  {
+    ht=word;
+    return true;
+  }  
+}
+
+//---------------
+std::vector<WordIndex> lm_ienc::genHSrcCode(const std::vector<std::string> &hs)
+{
+  std::vector<WordIndex> vecx;
+  unsigned int i;
+
+  for(i=0;i<hs.size();++i)
+  {
+    WordIndex x;
+    if(!vocab.find(hs[i],x))
+    {
+      ++x_object;
+      vecx.push_back(x_object);
+    }
+    else
+    {
+      vecx.push_back(x);
+    }
+  }
+  return vecx;
+}
+
+//---------------
+WordIndex lm_ienc::genHTrgCode(const std::string &ht)
+{
+  WordIndex x;
+  if(!vocab.find(ht,x))
+  {
+    ++x_object;
+    return x_object;
+  }
+  else
+  {
+    return x;
+  }
+}
+
+//---------------
+void lm_ienc::addHSrcCode(const std::vector<std::string> &hs,
+                          const std::vector<WordIndex> &s)
+{
+  unsigned int i;
+
+  if(hs.size()==s.size())
+  {
+    for(i=0;i<hs.size();++i)
+    {
+      vocab.add(hs[i],s[i]);
+    }
+  }
+}
+
+//---------------
+void lm_ienc::addHTrgCode(const std::string &ht,
+                          const WordIndex &t)
+{
+  vocab.add(ht,t);
+}
+
+//---------------
+bool lm_ienc::load(const char *prefixFileName)
+{
+  WordIndex x;
+  std::string hx;
+  std::ifstream ifile;
+
+  ifile.open(prefixFileName);
+  if(!ifile)
+  {
+    std::cerr<< "Error in target vocabulary file "<<prefixFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  else
+  {
+    while(ifile>>hx>>x)
+    {
+      vocab.add(hx,x);
+          // Codes generated later must not collide with loaded ones
+      if(x_object<x) x_object=x;
+    }
+    return THOT_OK;
+  }  
+}
+
+//---------------
+bool lm_ienc::print(const char *prefixFileName)
+{
+  std::vector<std::pair<std::string,WordIndex> > entries;
+  std::ofstream ofile;
+
+  ofile.open(prefixFileName,std::ios::out);
+  if(!ofile)
+  {
+    std::cerr<< "Error while opening target vocabulary file "<<prefixFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  else
+  {
+    vocab.getEntries(entries);
+    for(unsigned int i=0;i<entries.size();++i)
+    {
+      ofile<<entries[i].first<<" "<<entries[i].second<<std::endl;
+    }
+    ofile.close();
+    return THOT_OK;
+  }  
+}
+
+//---------------
+unsigned int lm_ienc::sizeSrc(void)
+{
+  return vocab.size();
+}
+
+//---------------
+unsigned int lm_ienc::sizeTrg(void)
+{
+  return vocab.size();
+}
+
+//---------------
+void lm_ienc::clear(void)
+{
+  x_object=0;
+  vocab.clear();
+}
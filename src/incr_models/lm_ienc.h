@@ -35,9 +35,11 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #  include <thot_config.h>
 #endif /* HAVE_CONFIG_H */
 
-#include "vecx_x_incr_enc.h"
+#include "BaseIncrEncoder.h"
+#include "ArenaWordVocab.h"
 #include <LM_Defs.h>
 #include <string>
+#include <vector>
 
 //--------------- Constants ------------------------------------------
 
@@ -52,13 +54,14 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- lm_ienc class
 
-class lm_ienc: public vecx_x_incr_enc<std::string,WordIndex>
+class lm_ienc: public BaseIncrEncoder<std::vector<std::string>,std::string,std::vector<WordIndex>,WordIndex>
 {
   public:
 
        // Constructor
    lm_ienc();
 
+       // Basic functions
    bool HighSrc_to_Src(const std::vector<std::string>& hs,
                        std::vector<WordIndex>& s);
        // Given a HSRCDATA object "hs" obtains its corresponding encoded
@@ -67,7 +70,39 @@ class lm_ienc: public vecx_x_incr_enc<std::string,WordIndex>
        // code if exists, or a not valid one otherwise
    bool HighTrg_to_Trg(const std::string& ht,WordIndex& t);
        // The same for HX objects
+   bool Src_to_HighSrc(const std::vector<WordIndex>& s,
+                       std::vector<std::string>& hs);
+       // Performs the inverse process (s -> hs)
+   bool Trg_to_HighTrg(const WordIndex& t,std::string& ht);
+       // The same for X objects (t -> ht)
+
+   std::vector<WordIndex> genHSrcCode(const std::vector<std::string> &hs);
+       // Generates a code for a given std::vector<HX> object
+   WordIndex genHTrgCode(const std::string &ht);
+       // The same for HX objects
+
+   void addHSrcCode(const std::vector<std::string> &hs,
+                    const std::vector<WordIndex> &s);
+       // sets the codification for hs (hs->s)
+   void addHTrgCode(const std::string &ht,const WordIndex &t);
+       // sets the codifcation for ht (ht->t)
+
+       // Functions to load and print the model
+   bool load(const char *prefixFileName);
+       // Loads encoding information given a prefix file name
+   bool print(const char *prefixFileName);
+       // Prints encoding information
+
+       // size and clear functions
+   unsigned int sizeSrc(void);
+   unsigned int sizeTrg(void);
+   void clear(void);
+
+  protected:
 
+   ArenaWordVocab vocab;
+   WordIndex x_object;
+       // Last code generated
 };
 
 #endif
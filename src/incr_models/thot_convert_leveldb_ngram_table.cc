@@ -0,0 +1,139 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2017 Adam Harasimowicz
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: thot_convert_leveldb_ngram_table.cc                      */
+/*                                                                  */
+/* Definitions file: thot_convert_leveldb_ngram_table.cc            */
+/*                                                                  */
+/* Description: Converts a LevelDB n-gram table stored in the       */
+/*              legacy (text) format to the current format.         */
+/*                                                                  */   
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "LevelDbNgramTable.h"
+#include <iostream>
+#include "options.h"
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Function Declarations ------------------------------
+
+int TakeParameters(int argc, char *argv[]);
+void printUsage(void);
+int convert_table(void);
+
+//--------------- Type definitions -----------------------------------
+
+
+//--------------- Global variables -----------------------------------
+
+std::string inputFile;
+std::string outputFile;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc, char *argv[])
+{
+    if(TakeParameters(argc,argv) == THOT_OK)
+        return convert_table();
+    else
+        return THOT_ERROR;
+}
+
+//---------------
+int convert_table(void)
+{
+    LevelDbNgramTable levelDbNt;
+
+    if(levelDbNt.init(outputFile) == THOT_ERROR)
+    {
+        std::cerr << "Cannot create or recreate database (LevelDB) for language model" << std::endl;
+        return THOT_ERROR;
+    }
+
+    if(levelDbNt.convertLegacyDb(inputFile.c_str()) == THOT_ERROR)
+    {
+        std::cerr << "Error while converting database " << inputFile << std::endl;
+        return THOT_ERROR;
+    }
+
+    std::cerr << "levelDB size: " << levelDbNt.size() << std::endl;
+    std::cerr << "The vocabulary file (" << inputFile << ".ldb_vcb) is not modified by the conversion" << std::endl;
+
+    return THOT_OK;
+}
+
+//---------------
+int TakeParameters(int argc, char *argv[])
+{
+    int err;
+
+    // Verify --help option
+    err = readOption(argc, argv, "--help");
+
+    if (err != -1)
+    {
+        printUsage();
+
+        return THOT_ERROR;
+    }
+
+    // Takes the input database
+    err = readSTLstring(argc,argv, "-i", &inputFile);
+
+    if (err == -1)
+    {
+        printUsage();
+
+        return THOT_ERROR;
+    }
+
+    // Takes the output database
+    err = readSTLstring(argc,argv, "-o", &outputFile);
+
+    if (err == -1)
+    {
+        printUsage();
+
+        return THOT_ERROR;
+    }
+
+    return THOT_OK;  
+}
+
+//---------------
+void printUsage(void)
+{
+    printf("Usage: thot_convert_leveldb_ngram_table -i <string> -o <string> [--help]\n\n");
+    printf("-i <string>                  Name of the database in the legacy format.\n\n");
+    printf("-o <string>                  Name of the output database.\n\n");
+    printf("--help                       Display this help and exit.\n\n");
+}
+
+//--------------------------------
@@ -62,6 +62,8 @@ int process_ttable(void);
 //--------------- Global variables -----------------------------------
 
 std::string outputFile;
+bool bulkLoad;
+int maxMemMb;
 
 //--------------- Function Definitions -------------------------------
 
@@ -163,6 +165,9 @@ int process_ttable(void)
         vocab[EOS_STR] = S_END;
         vocab[SP_SYM1_LM_STR] = SP_SYM1_LM;
         
+        if(bulkLoad && levelDbNt.startBulkLoad((size_t) maxMemMb * 1048576) == THOT_ERROR)
+            return THOT_ERROR;
+
         // Process translation table
         for(unsigned int i = 1; awk.getln(); i++)
         {
@@ -174,7 +179,13 @@ int process_ttable(void)
 
             if(ret == THOT_OK)
             {
-                levelDbNt.addTableEntry(src, trg, inf);
+                if(bulkLoad)
+                {
+                    if(levelDbNt.bulkAddTableEntry(src, trg, inf) == THOT_ERROR)
+                        return THOT_ERROR;
+                }
+                else
+                    levelDbNt.addTableEntry(src, trg, inf);
             }
             else
             {
@@ -185,6 +196,16 @@ int process_ttable(void)
                 std::cerr << "Processed " << i << " lines" << std::endl;
         }
 
+        if(bulkLoad)
+        {
+            std::cerr << "Writing sorted entries" << std::endl;
+            if(levelDbNt.finishBulkLoad() == THOT_ERROR)
+            {
+                std::cerr << "Error while writing database" << std::endl;
+                return THOT_ERROR;
+            }
+        }
+
         std::cerr << "levelDB size: " << levelDbNt.size() << std::endl;
 
         // Save vocabulary
@@ -219,14 +240,24 @@ int TakeParameters(int argc, char *argv[])
         return THOT_ERROR;
     }
 
+    // Bulk loading options
+    bulkLoad = (readOption(argc, argv, "-b") != -1);
+    err = readInt(argc, argv, "-m", &maxMemMb);
+    if (err == -1)
+        maxMemMb = EXT_SORTER_DEFAULT_MAX_MEM_BYTES / 1048576;
+
     return THOT_OK;  
 }
 
 //---------------
 void printUsage(void)
 {
-    printf("Usage: thot_ngram_to_leveldb -o <string> [--help]\n\n");
+    printf("Usage: thot_ngram_to_leveldb -o <string> [-b [-m <int>]] [--help]\n\n");
     printf("-o <string>                  Name of output file.\n\n");
+    printf("-b                           Sort the entries externally and write them in\n");
+    printf("                             key order (bulk loading).\n\n");
+    printf("-m <int>                     Memory in MB used to sort the entries when\n");
+    printf("                             bulk loading (%d by default).\n\n", EXT_SORTER_DEFAULT_MAX_MEM_BYTES / 1048576);
     printf("--help                       Display this help and exit.\n\n");
 }
 
@@ -76,6 +76,10 @@ class vecx_x_incr_cptable: public BaseIncrCondProbTable<std::vector<X>,X,SRC_INF
   im_pair<SRC_INFO,SRCTRG_INFO> infSrcTrg(const std::vector<X>& s,
                                           const X& t,
                                           bool& found);
+  void infSrcTrgBatch(const std::vector<std::vector<X> >& sVec,
+                      const std::vector<X>& tVec,
+                      std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec,
+                      std::vector<bool>& foundVec);
   SRC_INFO getSrcInfo(const std::vector<X>& s,bool& found);
   SRCTRG_INFO getSrcTrgInfo(const std::vector<X>& s,const X& t,bool& found);
   Prob pTrgGivenSrc(const std::vector<X>& s,const X& t);
@@ -297,6 +301,48 @@ vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::infSrcTrg(const std::vector<X>& s,
   return psst;
 }
 
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::infSrcTrgBatch(const std::vector<std::vector<X> >& sVec,
+                                                                 const std::vector<X>& tVec,
+                                                                 std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec,
+                                                                 std::vector<bool>& foundVec)
+{
+  std::vector<std::vector<X> > vecxVec(sVec.size());
+  std::vector<SRCTRG_INFO*> stiPtrVec;
+  std::vector<SRC_INFO*> siPtrVec;
+
+  for(unsigned int i=0;i<sVec.size();++i)
+  {
+    vecxVec[i]=sVec[i];
+    vecxVec[i].push_back(tVec[i]);
+  }
+
+      // Search all the entries at once in both tries (empty sources
+      // are not found by the search)
+  srcInfo.findBatch(sVec,siPtrVec);
+  srcTrgInfo.findBatch(vecxVec,stiPtrVec);
+
+  infVec.assign(sVec.size(),im_pair<SRC_INFO,SRCTRG_INFO>());
+  foundVec.assign(sVec.size(),false);
+  for(unsigned int i=0;i<sVec.size();++i)
+  {
+    if(sVec[i].size()==0)
+      infVec[i].first=srcInfoNull;
+    else
+    {
+      if(siPtrVec[i]!=NULL) infVec[i].first=*siPtrVec[i];
+      else infVec[i].first=0;
+    }
+
+    if(stiPtrVec[i]!=NULL)
+    {
+      infVec[i].second=*stiPtrVec[i];
+      foundVec[i]=true;
+    }
+  }
+}
+
 //-------------------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 SRC_INFO vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getSrcInfo(const std::vector<X>& s,
@@ -304,6 +304,8 @@ bool vecx_x_incr_enc<HX,X>::load(const char *prefixFileName)
           //cout<<s<< " ||| " <<t<<" ||| "<<inf<<std::endl;
       this->hx_to_x[hx]=x;
       this->x_to_hx[x]=hx;
+          // Codes generated later must not collide with loaded ones
+      if(x_object<x) x_object=x;
     }
     return THOT_OK;
   }  
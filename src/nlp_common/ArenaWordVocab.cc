@@ -0,0 +1,135 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/*********************************************************************/
+/*                                                                   */
+/* Module: ArenaWordVocab                                            */
+/*                                                                   */
+/* Definitions file: ArenaWordVocab.cc                               */
+/*                                                                   */
+/*********************************************************************/
+
+
+//--------------- Include files ---------------------------------------
+
+#include "ArenaWordVocab.h"
+#include <algorithm>
+
+//--------------- Function definitions
+
+const unsigned long long ArenaWordVocab::ARENA_VOCAB_NO_OFFSET;
+
+//-------------------------
+ArenaWordVocab::ArenaWordVocab(void)
+{
+  clear();
+}
+
+//-------------------------
+void ArenaWordVocab::add(const std::string& word,
+                         WordIndex idx)
+{
+      // Keep the load factor below one half
+  if(2*(numWords+1)>bucketVec.size())
+    grow();
+
+      // Obtain bucket of the word, adding it to the arena if necessary
+  unsigned long long hash=hashWord(word.data(),word.size());
+  size_t bucketIdx;
+  if(!findBucket(word.data(),word.size(),hash,bucketIdx))
+  {
+    bucketVec[bucketIdx].offsetPlusOne=arenaVec.size()+1;
+    bucketVec[bucketIdx].hash=(unsigned int) hash;
+    bucketVec[bucketIdx].len=word.size();
+    arenaVec.insert(arenaVec.end(),word.begin(),word.end());
+    arenaVec.push_back('\0');
+    ++numWords;
+  }
+  bucketVec[bucketIdx].idx=idx;
+
+      // Update reverse direction
+  if(idx>=idxToOffsetVec.size())
+    idxToOffsetVec.resize((size_t)idx+1,ARENA_VOCAB_NO_OFFSET);
+  idxToOffsetVec[idx]=bucketVec[bucketIdx].offsetPlusOne-1;
+}
+
+//-------------------------
+size_t ArenaWordVocab::size(void)const
+{
+  return numWords;
+}
+
+//-------------------------
+WordIndex ArenaWordVocab::getIdxRange(void)const
+{
+  return idxToOffsetVec.size();
+}
+
+//-------------------------
+void ArenaWordVocab::getEntries(std::vector<std::pair<std::string,WordIndex> >& entries)const
+{
+  entries.clear();
+  for(size_t i=0;i<bucketVec.size();++i)
+  {
+    if(bucketVec[i].offsetPlusOne!=0)
+      entries.push_back(std::make_pair(std::string(&arenaVec[bucketVec[i].offsetPlusOne-1]),bucketVec[i].idx));
+  }
+
+      // Sort entries by index
+  std::vector<std::pair<WordIndex,std::string> > sortedEntries;
+  for(size_t i=0;i<entries.size();++i)
+    sortedEntries.push_back(std::make_pair(entries[i].second,entries[i].first));
+  std::sort(sortedEntries.begin(),sortedEntries.end());
+  for(size_t i=0;i<sortedEntries.size();++i)
+  {
+    entries[i].first=sortedEntries[i].second;
+    entries[i].second=sortedEntries[i].first;
+  }
+}
+
+//-------------------------
+void ArenaWordVocab::clear(void)
+{
+  arenaVec.clear();
+  idxToOffsetVec.clear();
+  bucketVec.clear();
+  bucketVec.resize(ARENA_VOCAB_INIT_BUCKETS);
+  numWords=0;
+}
+
+//-------------------------
+void ArenaWordVocab::grow(void)
+{
+  std::vector<Bucket> oldBucketVec;
+  oldBucketVec.swap(bucketVec);
+  bucketVec.resize(2*oldBucketVec.size());
+  size_t numBuckets=bucketVec.size();
+
+      // Reinsert words, the hash of the buckets only keeps the lower
+      // bits, so it is computed again
+  for(size_t i=0;i<oldBucketVec.size();++i)
+  {
+    if(oldBucketVec[i].offsetPlusOne!=0)
+    {
+      const char* word=&arenaVec[oldBucketVec[i].offsetPlusOne-1];
+      size_t bucketIdx=hashWord(word,oldBucketVec[i].len)&(numBuckets-1);
+      while(bucketVec[bucketIdx].offsetPlusOne!=0)
+        bucketIdx=(bucketIdx+1)&(numBuckets-1);
+      bucketVec[bucketIdx]=oldBucketVec[i];
+    }
+  }
+}
@@ -0,0 +1,178 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/*********************************************************************/
+/*                                                                   */
+/* Module: ArenaWordVocab                                            */
+/*                                                                   */
+/* Prototype file: ArenaWordVocab                                    */
+/*                                                                   */
+/* Description: Bidirectional map between words and word indices    */
+/*              whose strings are stored in a contiguous arena.      */
+/*                                                                   */
+/*********************************************************************/
+
+/**
+ * @file ArenaWordVocab.h
+ *
+ * @brief Bidirectional map between words and word indices whose
+ * strings are stored in a contiguous arena.
+ */
+
+#ifndef _ArenaWordVocab
+#define _ArenaWordVocab
+
+//--------------- Include files ---------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "StatModelDefs.h"
+#include <string.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+//--------------- Constants -------------------------------------------
+
+#define ARENA_VOCAB_INIT_BUCKETS     1024
+
+//--------------- typedefs --------------------------------------------
+
+
+//--------------- function declarations -------------------------------
+
+
+//--------------- Classes ---------------------------------------------
+
+//--------------- ArenaWordVocab class
+
+/**
+ * @brief Vocabulary mapping words to word indices and vice versa. The
+ * words are stored one after another in a single character arena, the
+ * words are located by means of an open addressing hash table and the
+ * reverse direction is a vector indexed by word index.
+ */
+
+class ArenaWordVocab
+{
+ public:
+
+      // Constructor
+  ArenaWordVocab(void);
+
+      // Lookup functions
+  inline bool find(const std::string& word,
+                   WordIndex& idx)const
+    {
+      size_t bucketIdx;
+      if(findBucket(word.data(),word.size(),hashWord(word.data(),word.size()),bucketIdx))
+      {
+        idx=bucketVec[bucketIdx].idx;
+        return true;
+      }
+      else
+        return false;
+    }
+  inline const char* getWord(WordIndex idx)const
+    {
+          // Returns NULL if idx has no word
+      if(idx<idxToOffsetVec.size() && idxToOffsetVec[idx]!=ARENA_VOCAB_NO_OFFSET)
+        return &arenaVec[idxToOffsetVec[idx]];
+      else
+        return NULL;
+    }
+
+  void add(const std::string& word,
+           WordIndex idx);
+      // Associates word with idx in both directions. As with a pair of
+      // maps, the previous index of the word and the previous word of
+      // the index are replaced
+
+  size_t size(void)const;
+      // Returns the number of words
+  WordIndex getIdxRange(void)const;
+      // Returns one plus the greatest index that has been added
+  void getEntries(std::vector<std::pair<std::string,WordIndex> >& entries)const;
+      // Obtains the words and their indices sorted by index
+
+  void clear(void);
+
+ private:
+
+  static const unsigned long long ARENA_VOCAB_NO_OFFSET=~0ULL;
+
+      // Buckets store the offset of the word plus one, zero offsets
+      // denote empty buckets, and its length, which is compared before
+      // the characters
+  struct Bucket
+  {
+    unsigned long long offsetPlusOne;
+    unsigned int hash;
+    unsigned int len;
+    WordIndex idx;
+    Bucket(void):offsetPlusOne(0),hash(0),len(0),idx(0){}
+  };
+
+  std::vector<char> arenaVec;
+  std::vector<unsigned long long> idxToOffsetVec;
+  std::vector<Bucket> bucketVec;
+  size_t numWords;
+
+  inline unsigned long long hashWord(const char* word,
+                                     size_t len)const
+    {
+          // 64-bit FNV-1a hash followed by a final mix
+      unsigned long long hash=14695981039346656037ULL;
+      for(size_t i=0;i<len;++i)
+      {
+        hash^=(unsigned char) word[i];
+        hash*=1099511628211ULL;
+      }
+      hash^=hash>>33;
+      hash*=0xff51afd7ed558ccdULL;
+      hash^=hash>>33;
+      return hash;
+    }
+  inline bool findBucket(const char* word,
+                         size_t len,
+                         unsigned long long hash,
+                         size_t& bucketIdx)const
+    {
+          // Returns the bucket of the word or, if the word is not
+          // stored, the empty bucket where it should be inserted
+      size_t numBuckets=bucketVec.size();
+      bucketIdx=hash&(numBuckets-1);
+      while(bucketVec[bucketIdx].offsetPlusOne!=0)
+      {
+        const Bucket& bucket=bucketVec[bucketIdx];
+        if(bucket.hash==(unsigned int) hash && bucket.len==len)
+        {
+          const char* storedWord=&arenaVec[bucket.offsetPlusOne-1];
+          if(memcmp(storedWord,word,len)==0)
+            return true;
+        }
+        bucketIdx=(bucketIdx+1)&(numBuckets-1);
+      }
+      return false;
+    }
+
+  void grow(void);
+};
+
+#endif
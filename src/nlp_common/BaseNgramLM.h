@@ -89,6 +89,15 @@ class BaseNgramLM
   virtual LgProb getLgProbEndGivenState(LM_STATE &state)=0;
       // In these functions, the state is updated once the
       // function is executed
+  virtual void getWordSeqLgProbGivenState(const std::vector<WordIndex>& wordVec,
+                                          LM_STATE& state,
+                                          std::vector<LgProb>& lgProbVec);
+      // Sequence version of getNgramLgProbGivenState(), lgProbVec[i]
+      // stores the log-probability of wordVec[i] given state and the
+      // previous words of wordVec, and state is updated with the whole
+      // sequence. The default implementation calls
+      // getNgramLgProbGivenState() for each word, derived classes may
+      // redefine it to look up all the n-grams at once
    
       // Encoding-related functions
   virtual bool existSymbol(std::string s)const=0;
@@ -164,6 +173,17 @@ void BaseNgramLM<LM_STATE>::addNextWordToState(WordIndex word,
   this->getNgramLgProbGivenState(word,state);
 }
 
+//---------------
+template<class LM_STATE>
+void BaseNgramLM<LM_STATE>::getWordSeqLgProbGivenState(const std::vector<WordIndex>& wordVec,
+                                                       LM_STATE& state,
+                                                       std::vector<LgProb>& lgProbVec)
+{
+  lgProbVec.clear();
+  for(unsigned int i=0;i<wordVec.size();++i)
+    lgProbVec.push_back(this->getNgramLgProbGivenState(wordVec[i],state));
+}
+
 //---------------
 template<class LM_STATE>
 LgProb BaseNgramLM<LM_STATE>::getSentenceLog10ProbStr(std::vector<std::string> s,
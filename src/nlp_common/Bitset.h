@@ -36,42 +36,6 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #  include <thot_config.h>
 #endif /* HAVE_CONFIG_H */
 
-#ifdef THOT_DONT_USE_MY_BITSET
-# include <bitset>
-# define Bitset bitset
-
-template<size_t N>
-bool operator < (const Bitset<N> &left,const Bitset<N> &right);
-
-template<size_t N>
-bool operator > (const Bitset<N> &left,const Bitset<N> &right);
-
-//-------------------------
-template<size_t N>
-bool operator< (const Bitset<N> &left,const Bitset<N> &right)
-{
-  for(unsigned int i=0;i<N;++i)	
-  {
-    if(left.test(i)<right.test(i)) return 1;
-    if(right.test(i)<left.test(i)) return 0;
-  }
-  return 0;
-}
-
-//-------------------------
-template<size_t N>
-bool operator> (const Bitset<N> &left,const Bitset<N> &right)
-{
-  for(unsigned int i=0;i<N;++i)	
-  {
-    if(left.test(i)>right.test(i)) return 1;
-    if(right.test(i)>left.test(i)) return 0;
-  }
-  return 0;
-}
-
-#else
-
 #include <limits.h>
 #include <iostream>
 #include <iomanip>
@@ -129,6 +93,13 @@ class Bitset
   //Bitset<N> operator<<(size_t pos) const;
   void operator++(void);
   size_t count(unsigned int J=N)const;
+  size_t find_next_set(size_t pos)const;
+      // Returns the index of the first bit set to one whose position
+      // is greater or equal than pos (N if there is no such bit)
+  size_t find_next_unset(size_t pos)const;
+      // Returns the index of the first bit set to zero whose position
+      // is greater or equal than pos (N if there is no such bit)
+  size_t hash(void)const;
   unsigned int to_uint(void)const;
   unsigned long to_ulong(void)const;
   friend std::ostream& operator << <N> (std::ostream &outS,const Bitset<N> &bs);
@@ -416,23 +387,70 @@ void Bitset<N>::operator++(void)
 template<size_t N>
 size_t Bitset<N>::count(unsigned int J)const
 {
- unsigned int i,j,w=1;
- size_t c;
+  unsigned int i;
+  unsigned int fullWords=J/(NUM_BITS_INT);
+  unsigned int remBits=J%(NUM_BITS_INT);
+  size_t c=0;
+
+  for(i=0;i<fullWords && i<NUM_WORDS(N);++i)
+    c+=__builtin_popcount(words[i]);
+  if(remBits>0 && i<NUM_WORDS(N))
+    c+=__builtin_popcount(words[i]&((1u<<remBits)-1));
+  return c;
+}
 
- c=0;   
- i=0; j=0;   
- while(j<J)
- {
-  if((words[i]&w)!=0) ++c;
-  w=w<<1;
-  if(w==0) 
+//---------------------------------------
+template<size_t N>
+size_t Bitset<N>::find_next_set(size_t pos)const
+{
+  if(pos>=N) return N;
+  
+  unsigned int i=pos/(NUM_BITS_INT);
+  unsigned int w=words[i]&(UINT_MAX<<(pos%(NUM_BITS_INT)));
+  while(true)
+  {
+    if(w!=0)
+    {
+      size_t result=i*(NUM_BITS_INT)+__builtin_ctz(w);
+      return result<N ? result : N;
+    }
+    ++i;
+    if(i>=NUM_WORDS(N)) return N;
+    w=words[i];
+  }
+}
+
+//---------------------------------------
+template<size_t N>
+size_t Bitset<N>::find_next_unset(size_t pos)const
+{
+  if(pos>=N) return N;
+  
+  unsigned int i=pos/(NUM_BITS_INT);
+  unsigned int w=~words[i]&(UINT_MAX<<(pos%(NUM_BITS_INT)));
+  while(true)
   {
-    w=1;  
-    ++i;   
+    if(w!=0)
+    {
+      size_t result=i*(NUM_BITS_INT)+__builtin_ctz(w);
+      return result<N ? result : N;
+    }
+    ++i;
+    if(i>=NUM_WORDS(N)) return N;
+    w=~words[i];
   }
-  ++j;  
- } 
- return c;
+}
+
+//---------------------------------------
+template<size_t N>
+size_t Bitset<N>::hash(void)const
+{
+  size_t h=0;
+  for(unsigned int i=0;i<NUM_WORDS(N);++i)
+  {
+    h^=(size_t)words[i]+0x9e3779b9+(h<<6)+(h>>2);
+  }
+  return h;
 }
 
 //---------------------------------------
@@ -524,5 +542,3 @@ std::ostream& operator << (std::ostream &outS,const Bitset<N> &bs)
 }
 
 #endif
-
-#endif
@@ -0,0 +1,320 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/*********************************************************************/
+/*                                                                   */
+/* Module: ExternalCountSorter                                       */
+/*                                                                   */
+/* Definitions file: ExternalCountSorter.cc                          */
+/*                                                                   */
+/*********************************************************************/
+
+
+//--------------- Include files ---------------------------------------
+
+#include "ExternalCountSorter.h"
+#include <algorithm>
+
+//--------------- Global variables ------------------------------------
+
+//--------------- Function declarations
+
+//--------------- Constants
+
+//--------------- Classes ---------------------------------------------
+
+//-------------------------
+ExternalCountSorter::ExternalCountSorter(void)
+{
+  maxMemBytes=EXT_SORTER_DEFAULT_MAX_MEM_BYTES;
+  combineMode=SUM_COUNTS;
+  memBytes=0;
+  memPos=0;
+}
+
+//-------------------------
+void ExternalCountSorter::init(const std::string& _tmpFilePrefix,
+                               size_t _maxMemBytes,
+                               CombineMode _combineMode)
+{
+  clear();
+  tmpFilePrefix=_tmpFilePrefix;
+  maxMemBytes=_maxMemBytes;
+  combineMode=_combineMode;
+}
+
+//-------------------------
+bool ExternalCountSorter::add(const std::string& key,
+                              double count)
+{
+  recordVec.push_back(std::make_pair(key,count));
+      // Approximate memory used by the record
+  memBytes+=sizeof(Record)+key.size();
+
+  if(memBytes>=maxMemBytes)
+  {
+    if(writeRun()==THOT_ERROR)
+      return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExternalCountSorter::recordLess(const Record& a,
+                                     const Record& b)
+{
+  return a.first<b.first;
+}
+
+//-------------------------
+void ExternalCountSorter::combine(double& count,
+                                  double newCount)const
+{
+  if(combineMode==SUM_COUNTS)
+    count+=newCount;
+  else
+    count=newCount;
+}
+
+//-------------------------
+void ExternalCountSorter::sortMemRecords(void)
+{
+      // Stable sort preserves the order in which the records of the
+      // same key were added
+  std::stable_sort(recordVec.begin(),recordVec.end(),recordLess);
+
+  size_t last=0;
+  for(size_t i=1;i<recordVec.size();++i)
+  {
+    if(recordVec[i].first==recordVec[last].first)
+      combine(recordVec[last].second,recordVec[i].second);
+    else
+    {
+      ++last;
+      if(last!=i)
+        std::swap(recordVec[last],recordVec[i]);
+    }
+  }
+  if(!recordVec.empty())
+    recordVec.resize(last+1);
+}
+
+//-------------------------
+bool ExternalCountSorter::writeRun(void)
+{
+  sortMemRecords();
+
+  std::ostringstream fileName;
+  fileName<<tmpFilePrefix<<runFileNameVec.size();
+  FILE* file=fopen(fileName.str().c_str(),"wb");
+  if(file==NULL)
+  {
+    std::cerr<<"Error: cannot create temporary file "<<fileName.str()<<std::endl;
+    return THOT_ERROR;
+  }
+  runFileNameVec.push_back(fileName.str());
+
+  bool ok=true;
+  for(size_t i=0;i<recordVec.size() && ok;++i)
+  {
+    unsigned int keySize=recordVec[i].first.size();
+    ok=(fwrite(&keySize,sizeof(keySize),1,file)==1) &&
+       (fwrite(recordVec[i].first.data(),1,keySize,file)==keySize) &&
+       (fwrite(&recordVec[i].second,sizeof(double),1,file)==1);
+  }
+  if(fclose(file)!=0)
+    ok=false;
+
+  recordVec.clear();
+  memBytes=0;
+
+  if(!ok)
+  {
+    std::cerr<<"Error: cannot write temporary file "<<fileName.str()<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExternalCountSorter::sort(void)
+{
+  if(runFileNameVec.empty())
+  {
+        // All the records fit in memory
+    sortMemRecords();
+    memPos=0;
+    return THOT_OK;
+  }
+
+  if(!recordVec.empty())
+  {
+    if(writeRun()==THOT_ERROR)
+      return THOT_ERROR;
+  }
+
+      // Open the runs and read their first record
+  runFileVec.assign(runFileNameVec.size(),NULL);
+  runRecordVec.assign(runFileNameVec.size(),Record());
+  heap.clear();
+  for(unsigned int i=0;i<runFileNameVec.size();++i)
+  {
+    runFileVec[i]=fopen(runFileNameVec[i].c_str(),"rb");
+    if(runFileVec[i]==NULL)
+    {
+      std::cerr<<"Error: cannot read temporary file "<<runFileNameVec[i]<<std::endl;
+      return THOT_ERROR;
+    }
+    if(readRecord(i))
+      heapPush(i);
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+bool ExternalCountSorter::readRecord(unsigned int runIdx)
+{
+  FILE* file=runFileVec[runIdx];
+  unsigned int keySize;
+  if(fread(&keySize,sizeof(keySize),1,file)!=1)
+    return false;
+
+  Record& record=runRecordVec[runIdx];
+  record.first.resize(keySize);
+  if(keySize>0 && fread(&record.first[0],1,keySize,file)!=keySize)
+    return false;
+  if(fread(&record.second,sizeof(double),1,file)!=1)
+    return false;
+
+  return true;
+}
+
+//-------------------------
+bool ExternalCountSorter::heapLess(unsigned int a,
+                                   unsigned int b)const
+{
+  int cmp=runRecordVec[a].first.compare(runRecordVec[b].first);
+  if(cmp!=0)
+    return cmp<0;
+  else
+    return a<b;
+}
+
+//-------------------------
+void ExternalCountSorter::heapPush(unsigned int runIdx)
+{
+  size_t pos=heap.size();
+  heap.push_back(runIdx);
+  while(pos>0)
+  {
+    size_t parent=(pos-1)/2;
+    if(!heapLess(heap[pos],heap[parent]))
+      break;
+    std::swap(heap[pos],heap[parent]);
+    pos=parent;
+  }
+}
+
+//-------------------------
+unsigned int ExternalCountSorter::heapPop(void)
+{
+  unsigned int top=heap[0];
+  heap[0]=heap.back();
+  heap.pop_back();
+
+  size_t pos=0;
+  while(true)
+  {
+    size_t child=2*pos+1;
+    if(child>=heap.size())
+      break;
+    if(child+1<heap.size() && heapLess(heap[child+1],heap[child]))
+      ++child;
+    if(!heapLess(heap[child],heap[pos]))
+      break;
+    std::swap(heap[pos],heap[child]);
+    pos=child;
+  }
+  return top;
+}
+
+//-------------------------
+bool ExternalCountSorter::next(std::string& key,
+                               double& count)
+{
+  if(runFileNameVec.empty())
+  {
+    if(memPos>=recordVec.size())
+      return false;
+    key.swap(recordVec[memPos].first);
+    count=recordVec[memPos].second;
+    ++memPos;
+    return true;
+  }
+
+  if(heap.empty())
+    return false;
+
+      // Retrieve the smallest key and combine the records of the same
+      // key stored in the other runs
+  unsigned int runIdx=heapPop();
+  key=runRecordVec[runIdx].first;
+  count=runRecordVec[runIdx].second;
+  if(readRecord(runIdx))
+    heapPush(runIdx);
+
+  while(!heap.empty() && runRecordVec[heap[0]].first==key)
+  {
+    runIdx=heapPop();
+    combine(count,runRecordVec[runIdx].second);
+    if(readRecord(runIdx))
+      heapPush(runIdx);
+  }
+  return true;
+}
+
+//-------------------------
+size_t ExternalCountSorter::getNumRuns(void)const
+{
+  return runFileNameVec.size();
+}
+
+//-------------------------
+void ExternalCountSorter::clear(void)
+{
+  for(unsigned int i=0;i<runFileVec.size();++i)
+  {
+    if(runFileVec[i]!=NULL)
+      fclose(runFileVec[i]);
+  }
+  for(unsigned int i=0;i<runFileNameVec.size();++i)
+    remove(runFileNameVec[i].c_str());
+
+  runFileVec.clear();
+  runFileNameVec.clear();
+  runRecordVec.clear();
+  heap.clear();
+  recordVec.clear();
+  memBytes=0;
+  memPos=0;
+}
+
+//-------------------------
+ExternalCountSorter::~ExternalCountSorter()
+{
+  clear();
+}
@@ -0,0 +1,158 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/*********************************************************************/
+/*                                                                   */
+/* Module: ExternalCountSorter                                       */
+/*                                                                   */
+/* Prototype file: ExternalCountSorter                               */
+/*                                                                   */
+/* Description: Sorts and aggregates key-count records that may     */
+/*              not fit in memory.                                   */
+/*                                                                   */
+/*********************************************************************/
+
+/**
+ * @file ExternalCountSorter.h
+ *
+ * @brief Sorts and aggregates key-count records that may not fit in
+ * memory.
+ */
+
+#ifndef _ExternalCountSorter
+#define _ExternalCountSorter
+
+//--------------- Include files ---------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ErrorDefs.h"
+#include <stdio.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <utility>
+
+//--------------- Constants -------------------------------------------
+
+#define EXT_SORTER_DEFAULT_MAX_MEM_BYTES  (512*1048576)
+
+//--------------- typedefs --------------------------------------------
+
+
+//--------------- function declarations -------------------------------
+
+
+//--------------- Classes ---------------------------------------------
+
+//--------------- ExternalCountSorter class
+
+/**
+ * @brief Sorts key-count records in byte order of the keys, combining
+ * the counts of repeated keys. Records are accumulated in memory and,
+ * when the memory budget is exceeded, they are sorted, combined and
+ * written to a temporary run file. The runs are merged when the
+ * records are retrieved.
+ */
+
+class ExternalCountSorter
+{
+ public:
+
+  enum CombineMode
+  {
+    SUM_COUNTS,
+        // The counts of repeated keys are added
+    KEEP_LAST
+        // The count of the last added record is kept
+  };
+
+      // Constructor
+  ExternalCountSorter(void);
+
+  void init(const std::string& _tmpFilePrefix,
+            size_t _maxMemBytes,
+            CombineMode _combineMode);
+      // Initializes the sorter, removing previous records. Run files
+      // are named _tmpFilePrefix followed by the run number
+
+  bool add(const std::string& key,
+           double count);
+      // Adds a record, returns THOT_ERROR if a run file cannot be
+      // written
+
+  bool sort(void);
+      // Finishes the addition of records and prepares their retrieval
+  bool next(std::string& key,
+            double& count);
+      // Retrieves the next record in key order, returns false when
+      // there are no more records
+
+  size_t getNumRuns(void)const;
+  void clear(void);
+      // Removes the records and the run files
+
+      // Destructor
+  ~ExternalCountSorter();
+
+ private:
+
+  typedef std::pair<std::string,double> Record;
+
+  std::string tmpFilePrefix;
+  size_t maxMemBytes;
+  CombineMode combineMode;
+
+      // Records stored in memory
+  std::vector<Record> recordVec;
+  size_t memBytes;
+  size_t memPos;
+
+      // Run files and the record read from each one during the
+      // merge. The heap stores the indices of the runs whose current
+      // record has not been retrieved
+  std::vector<std::string> runFileNameVec;
+  std::vector<FILE*> runFileVec;
+  std::vector<Record> runRecordVec;
+  std::vector<unsigned int> heap;
+
+  static bool recordLess(const Record& a,
+                         const Record& b);
+  void combine(double& count,
+               double newCount)const;
+  void sortMemRecords(void);
+      // Sorts the records stored in memory and combines repeated keys
+  bool writeRun(void);
+  bool readRecord(unsigned int runIdx);
+      // Reads the next record of a run, returns false at the end of
+      // the run
+  bool heapLess(unsigned int a,
+                unsigned int b)const;
+      // Ordering of the heap, ties are solved by the index of the
+      // run so that the records of older runs are retrieved first
+  void heapPush(unsigned int runIdx);
+  unsigned int heapPop(void);
+
+      // Copies are not allowed
+  ExternalCountSorter(const ExternalCountSorter&);
+  void operator=(const ExternalCountSorter&);
+};
+
+#endif
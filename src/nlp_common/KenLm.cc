@@ -109,6 +109,14 @@ void KenLm::getStateForBeginOfSentence(std::vector<WordIndex>& state)
   }
 }
 
+//-------------------------
+void KenLm::addNextWordToState(WordIndex word,
+                               std::vector<WordIndex>& state)
+{
+  for(unsigned int i=1;i<state.size();++i) state[i-1]=state[i];
+  if(state.size()>0) state[state.size()-1]=word;
+}
+
 //-------------------------
 LgProb KenLm::getNgramLgProbGivenState(WordIndex w,
                                        std::vector<WordIndex>& state)
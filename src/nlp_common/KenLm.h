@@ -76,6 +76,8 @@ class KenLm: public BaseNgramLM<std::vector<WordIndex> >
   bool getStateForWordSeq(const std::vector<WordIndex>& wordSeq,
                           std::vector<WordIndex>& state);
   void getStateForBeginOfSentence(std::vector<WordIndex> &state);
+  void addNextWordToState(WordIndex word,
+                          std::vector<WordIndex>& state);
   LgProb getNgramLgProbGivenState(WordIndex w,
                                   std::vector<WordIndex> &state);
   LgProb getNgramLgProbGivenStateStr(std::string s,
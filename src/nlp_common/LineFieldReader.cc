@@ -0,0 +1,329 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/*********************************************************************/
+/*                                                                   */
+/* Module: LineFieldReader                                           */
+/*                                                                   */
+/* Definitions file: LineFieldReader.cc                              */
+/*                                                                   */
+/*********************************************************************/
+
+
+//--------------- Include files ---------------------------------------
+
+#include "LineFieldReader.h"
+#include "getline.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+//--------------- Function definitions
+
+//-------------------------
+LineFieldReader::LineFieldReader(void)
+{
+  filePtr=NULL;
+  fopenCalled=false;
+  blockReads=false;
+  eofReached=false;
+  getlineBuff=NULL;
+  getlineBuffLen=0;
+  fieldSep=' ';
+  fnr=0;
+  resetBlock();
+}
+
+//-------------------------
+bool LineFieldReader::open(const char *fileName)
+{
+  close();
+  FILE* stream=fopen(fileName,"r");
+  if(stream==NULL)
+    return THOT_ERROR;
+
+  open_stream(stream);
+  fopenCalled=true;
+
+      // Only regular files opened by the reader are read in blocks
+  struct stat fileStat;
+  blockReads=(fstat(fileno(stream),&fileStat)==0 && S_ISREG(fileStat.st_mode));
+  if(blockReads && blockVec.size()<LINE_FIELD_READER_BLOCK_SIZE+1)
+    blockVec.resize(LINE_FIELD_READER_BLOCK_SIZE+1);
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool LineFieldReader::open_stream(FILE *stream)
+{
+  close();
+  if(stream==NULL)
+    return THOT_ERROR;
+
+  filePtr=stream;
+  fnr=0;
+  eofReached=false;
+  resetBlock();
+
+      // Streams given by the caller (such as stdin) may be shared with
+      // other readers, they are read one line at a time so that the
+      // position of the stream is always the end of the current line
+  blockReads=false;
+
+  return THOT_OK;
+}
+
+//-------------------------
+void LineFieldReader::close(void)
+{
+  if(fopenCalled)
+    fclose(filePtr);
+  filePtr=NULL;
+  fopenCalled=false;
+  resetBlock();
+}
+
+//-------------------------
+bool LineFieldReader::rwd(void)
+{
+  if(filePtr==NULL)
+    return THOT_ERROR;
+
+  rewind(filePtr);
+  fnr=0;
+  eofReached=false;
+  resetBlock();
+  return THOT_OK;
+}
+
+//-------------------------
+bool LineFieldReader::isOpen(void)const
+{
+  return filePtr!=NULL;
+}
+
+//-------------------------
+void LineFieldReader::setFieldSep(char fs)
+{
+  fieldSep=fs;
+}
+
+//-------------------------
+char LineFieldReader::getFieldSep(void)const
+{
+  return fieldSep;
+}
+
+//-------------------------
+bool LineFieldReader::getln(void)
+{
+  if(filePtr==NULL)
+    return false;
+
+  while(true)
+  {
+        // Look for the end of the next line in the buffered data
+    char* beginPtr=&blockVec[0]+blockBegin;
+    char* eolPtr=(char*) memchr(beginPtr,'\n',blockEnd-blockBegin);
+    if(eolPtr!=NULL)
+    {
+      *eolPtr='\0';
+      linePtr=beginPtr;
+      lineLength=eolPtr-beginPtr;
+      blockBegin+=lineLength+1;
+      break;
+    }
+
+        // The last line may not have an end of line character
+    if(eofReached)
+    {
+      if(blockBegin<blockEnd)
+      {
+        blockVec[blockEnd]='\0';
+        linePtr=beginPtr;
+        lineLength=blockEnd-blockBegin;
+        blockBegin=blockEnd;
+        break;
+      }
+      else
+        return false;
+    }
+
+    if(!fillBlock())
+      eofReached=true;
+  }
+
+  ++fnr;
+  splitLine();
+  return true;
+}
+
+//-------------------------
+unsigned int LineFieldReader::numFields(void)const
+{
+  return fieldVec.size();
+}
+
+//-------------------------
+unsigned int LineFieldReader::lineNumber(void)const
+{
+  return fnr;
+}
+
+//-------------------------
+const char* LineFieldReader::line(void)const
+{
+  return linePtr;
+}
+
+//-------------------------
+size_t LineFieldReader::lineLen(void)const
+{
+  return lineLength;
+}
+
+//-------------------------
+bool LineFieldReader::fieldToFloat(unsigned int n,
+                                   float& f)const
+{
+  double d;
+  if(fieldToDouble(n,d))
+  {
+    f=(float) d;
+    return true;
+  }
+  else
+    return false;
+}
+
+//-------------------------
+bool LineFieldReader::fieldToDouble(unsigned int n,
+                                    double& d)const
+{
+      // Fields are followed by a separator or by the end of the line,
+      // so that they can be parsed in place
+  FieldSpan span=field(n);
+  if(span.len==0)
+    return false;
+  char* endPtr;
+  d=strtod(span.ptr,&endPtr);
+  return endPtr==span.ptr+span.len;
+}
+
+//-------------------------
+bool LineFieldReader::fieldToLong(unsigned int n,
+                                  long& l)const
+{
+  FieldSpan span=field(n);
+  if(span.len==0)
+    return false;
+  char* endPtr;
+  l=strtol(span.ptr,&endPtr,10);
+  return endPtr==span.ptr+span.len;
+}
+
+//-------------------------
+bool LineFieldReader::fieldToULong(unsigned int n,
+                                   unsigned long& ul)const
+{
+  FieldSpan span=field(n);
+  if(span.len==0)
+    return false;
+  char* endPtr;
+  ul=strtoul(span.ptr,&endPtr,10);
+  return endPtr==span.ptr+span.len;
+}
+
+//-------------------------
+bool LineFieldReader::fillBlock(void)
+{
+      // Move the data that has not been returned to the beginning of
+      // the block
+  size_t pending=blockEnd-blockBegin;
+  if(blockBegin>0 && pending>0)
+    memmove(&blockVec[0],&blockVec[0]+blockBegin,pending);
+  blockBegin=0;
+  blockEnd=pending;
+
+  if(blockReads)
+  {
+        // Grow the block if it is full, one byte is reserved to
+        // terminate the last line
+    if(blockEnd+1>=blockVec.size())
+      blockVec.resize(2*blockVec.size());
+    size_t numRead=fread(&blockVec[0]+blockEnd,1,blockVec.size()-blockEnd-1,filePtr);
+    blockEnd+=numRead;
+    return numRead>0;
+  }
+  else
+  {
+    ssize_t numRead=getline(&getlineBuff,&getlineBuffLen,filePtr);
+    if(numRead<=0)
+      return false;
+    if(blockEnd+numRead+1>blockVec.size())
+      blockVec.resize(blockEnd+numRead+1);
+    memcpy(&blockVec[0]+blockEnd,getlineBuff,numRead);
+    blockEnd+=numRead;
+    return true;
+  }
+}
+
+//-------------------------
+void LineFieldReader::splitLine(void)
+{
+  fieldVec.clear();
+  const char* ptr=linePtr;
+  const char* endPtr=linePtr+lineLength;
+  while(ptr<endPtr)
+  {
+        // Skip separators
+    while(ptr<endPtr && *ptr==fieldSep)
+      ++ptr;
+    if(ptr==endPtr)
+      break;
+
+        // Obtain field
+    FieldSpan span;
+    span.ptr=ptr;
+    while(ptr<endPtr && *ptr!=fieldSep)
+      ++ptr;
+    span.len=ptr-span.ptr;
+    fieldVec.push_back(span);
+  }
+}
+
+//-------------------------
+void LineFieldReader::resetBlock(void)
+{
+  if(blockVec.empty())
+    blockVec.resize(1);
+  blockBegin=0;
+  blockEnd=0;
+  blockVec[0]='\0';
+  linePtr=&blockVec[0];
+  lineLength=0;
+  fieldVec.clear();
+}
+
+//-------------------------
+LineFieldReader::~LineFieldReader()
+{
+  close();
+  if(getlineBuff!=NULL)
+    free(getlineBuff);
+}
@@ -0,0 +1,195 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/*********************************************************************/
+/*                                                                   */
+/* Module: LineFieldReader                                           */
+/*                                                                   */
+/* Prototype file: LineFieldReader                                   */
+/*                                                                   */
+/* Description: Reads text files line by line, splitting each line  */
+/*              into fields in a single pass.                        */
+/*                                                                   */
+/*********************************************************************/
+
+/**
+ * @file LineFieldReader.h
+ *
+ * @brief Reads text files line by line, splitting each line into
+ * fields in a single pass.
+ */
+
+#ifndef _LineFieldReader
+#define _LineFieldReader
+
+//--------------- Include files ---------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#ifdef THOT__LARGEFILE_SOURCE
+#ifndef _LARGEFILE_SOURCE
+#define _LARGEFILE_SOURCE 1
+#endif
+#endif
+
+#ifdef THOT__FILE_OFFSET_BITS
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS  THOT__FILE_OFFSET_BITS
+#endif
+#endif
+
+#ifdef THOT__LARGE_FILES
+#ifndef _LARGE_FILES
+#define _LARGE_FILES
+#endif
+#endif
+
+#include "ErrorDefs.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+//--------------- Constants -------------------------------------------
+
+#define LINE_FIELD_READER_BLOCK_SIZE   (1<<20)
+
+//--------------- Classes ---------------------------------------------
+
+//--------------- LineFieldReader class
+
+/**
+ * @brief Line reader for text files. The file is read in large
+ * blocks and each line is split once into spans pointing to the
+ * fields, which are separated by one or more occurrences of the field
+ * separator. The fields can be compared and converted to numbers
+ * without being copied. Only regular files opened by means of open()
+ * are read in blocks; streams given to open_stream() are read one line
+ * at a time, so that interactive streams are not blocked and the
+ * stream is not consumed beyond the current line.
+ */
+
+class LineFieldReader
+{
+ public:
+
+  struct FieldSpan
+  {
+    const char* ptr;
+    size_t len;
+  };
+
+      // Constructor
+  LineFieldReader(void);
+
+      // Functions to open and close files
+  bool open(const char *fileName);
+  bool open_stream(FILE *stream);
+      // The stream is read line by line and it is not closed by
+      // close(). After each call to getln(), the stream is positioned
+      // at the beginning of the next line
+  void close(void);
+  bool rwd(void);
+  bool isOpen(void)const;
+  void setFieldSep(char fs);
+  char getFieldSep(void)const;
+
+      // Functions to read lines
+  bool getln(void);
+      // Reads the next line and splits it into fields, returns false
+      // at the end of the file
+  unsigned int numFields(void)const;
+  unsigned int lineNumber(void)const;
+  const char* line(void)const;
+      // Returns the current line without the end of line character
+  size_t lineLen(void)const;
+
+      // Functions to access fields, field 0 is the whole line and the
+      // rest are numbered from 1 to numFields(). Fields out of range
+      // are empty
+  inline FieldSpan field(unsigned int n)const
+    {
+      if(n==0)
+      {
+        FieldSpan span={linePtr,lineLength};
+        return span;
+      }
+      else if(n<=fieldVec.size())
+        return fieldVec[n-1];
+      else
+      {
+        FieldSpan span={"",0};
+        return span;
+      }
+    }
+  inline std::string fieldStr(unsigned int n)const
+    {
+      FieldSpan span=field(n);
+      return std::string(span.ptr,span.len);
+    }
+  inline bool fieldEquals(unsigned int n,
+                          const char* str)const
+    {
+      FieldSpan span=field(n);
+      return strncmp(span.ptr,str,span.len)==0 && str[span.len]=='\0';
+    }
+
+      // Functions to convert fields to numbers. They return false if
+      // the field is not a number
+  bool fieldToFloat(unsigned int n,
+                    float& f)const;
+  bool fieldToDouble(unsigned int n,
+                     double& d)const;
+  bool fieldToLong(unsigned int n,
+                   long& l)const;
+  bool fieldToULong(unsigned int n,
+                    unsigned long& ul)const;
+
+      // Destructor
+  ~LineFieldReader();
+
+ private:
+
+      // File data
+  FILE* filePtr;
+  bool fopenCalled;
+  bool blockReads;
+  bool eofReached;
+
+      // Buffered data, the bytes in [blockBegin,blockEnd) have not
+      // been returned yet
+  std::vector<char> blockVec;
+  size_t blockBegin;
+  size_t blockEnd;
+  char* getlineBuff;
+  size_t getlineBuffLen;
+
+      // Current line
+  const char* linePtr;
+  size_t lineLength;
+  std::vector<FieldSpan> fieldVec;
+  unsigned int fnr;
+  char fieldSep;
+
+  bool fillBlock(void);
+  void splitLine(void);
+  void resetBlock(void);
+};
+
+#endif
@@ -57,6 +57,7 @@ class NbestTransTable
     NbestTableNode<NODEDATA>* insertEntry(const KEY& k,
                                           const NbestTableNode<NODEDATA>& ttNode);
     NbestTableNode<NODEDATA>* getTranslationsForKey(const KEY& k);
+    const NbestTableNode<NODEDATA>* getTranslationsForKey(const KEY& k)const;
  
     bool loadFromFile(char *tTableFileName);
 
@@ -122,6 +123,17 @@ NbestTableNode<NODEDATA>* NbestTransTable<KEY,NODEDATA>::getTranslationsForKey(c
   else return NULL;	
 }
 
+//-------------------------
+template<class KEY,class NODEDATA>
+const NbestTableNode<NODEDATA>* NbestTransTable<KEY,NODEDATA>::getTranslationsForKey(const KEY& key)const
+{
+  typename std::map<KEY,NbestTableNode<NODEDATA> >::const_iterator transTableIterator;
+
+  transTableIterator=tTableMap.find(key);
+  if(transTableIterator!=tTableMap.end())
+    return &transTableIterator->second;
+  else return NULL;
+}
 
 //-------------------------
 template<class KEY,class NODEDATA>
@@ -79,6 +79,10 @@ class OrderedVector
     const std::pair<KEY,DATA>& top(void);
     DATA* findPtr(const KEY& k);
     iterator find(const KEY& k);
+    void prefetch(void)const;
+     // Prefetches the element that is accessed first when searching
+     // the vector, so that interleaved searches can overlap their
+     // cache misses
     DATA& operator[](const KEY& k);
     bool empty(void)const;
 	size_t size(void)const;
@@ -406,6 +410,16 @@ bool OrderedVector<KEY,DATA,KEY_ORDER_REL>::empty(void)const
   else return false;
 }
 
+//-------------------------
+template<class KEY,class DATA,class KEY_ORDER_REL>
+void OrderedVector<KEY,DATA,KEY_ORDER_REL>::prefetch(void)const
+{
+#if __GNUC__>2
+  if(size()>0)
+    __builtin_prefetch(&vec[size()/2]);
+#endif
+}
+
 //-------------------------
 template<class KEY,class DATA,class KEY_ORDER_REL>
 size_t OrderedVector<KEY,DATA,KEY_ORDER_REL>::size(void)const
@@ -33,14 +33,14 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //-------------------------
 std::ostream& operator << (std::ostream &outS,
-                           SingleWordVocab::StrToIdxVocab const &vocab)
+                           ArenaWordVocab const &vocab)
 {
- SingleWordVocab::StrToIdxVocab::const_iterator vocabIter;
- 
- for(vocabIter=vocab.begin();vocabIter!=vocab.end();++vocabIter)
+ std::vector<std::pair<std::string,WordIndex> > entries;
+
+ vocab.getEntries(entries);
+ for(unsigned int i=0;i<entries.size();++i)
  {
-   // outS<< vocabIter->second.first <<" "<< vocabIter->first << " " <<vocabIter->second.second <<std::endl;
-   outS<< vocabIter->second <<" "<< vocabIter->first <<std::endl;
+   outS<< entries[i].second <<" "<< entries[i].first <<std::endl;
  }
  
  return outS;
@@ -59,25 +59,36 @@ bool SingleWordVocab::loadSrcVocab(const char *srcInputVocabFileName)
 }
 
 //-------------------------	
+void SingleWordVocab::getSrcVocabEntries(std::vector<std::pair<std::string,WordIndex> >& entries)const
+{
+ srcVocab.getEntries(entries);
+}
+
+//-------------------------
 SingleWordVocab::StrToIdxVocab SingleWordVocab::getSrcVocab(void)const
 {
- return stringToSrcWordIndexMap;	
+ std::vector<std::pair<std::string,WordIndex> > entries;
+ StrToIdxVocab vocab;
+
+ srcVocab.getEntries(entries);
+ for(unsigned int i=0;i<entries.size();++i)
+   vocab[entries[i].first]=entries[i].second;
+ return vocab;
 }
 
 //-------------------------
 size_t SingleWordVocab::getSrcVocabSize(void)const
 {
- return stringToSrcWordIndexMap.size();	
+ return srcVocab.size();
 }
 //-------------------------
 WordIndex SingleWordVocab::stringToSrcWordIndex(std::string s)const
 {
- StrToIdxVocab::const_iterator strToIdxVocabIter;
-	
- strToIdxVocabIter=stringToSrcWordIndexMap.find(s);
- if(strToIdxVocabIter!=stringToSrcWordIndexMap.end())
+ WordIndex wordIndex;
+
+ if(srcVocab.find(s,wordIndex))
  {
-   return strToIdxVocabIter->second;
+   return wordIndex;
  }
  else return UNK_WORD;
 }
@@ -85,12 +96,11 @@ WordIndex SingleWordVocab::stringToSrcWordIndex(std::string s)const
 //-------------------------
 std::string SingleWordVocab::wordIndexToSrcString(WordIndex w)const
 {
- IdxToStrVocab::const_iterator idxToStrVocabIter;
-	
- idxToStrVocabIter=srcWordIndexMapToString.find(w);
- if(idxToStrVocabIter!=srcWordIndexMapToString.end())
+ const char* word=srcVocab.getWord(w);
+
+ if(word!=NULL)
  {
-   return idxToStrVocabIter->second;
+   return word;
  }
  else return UNK_WORD_STR;
 }
@@ -98,10 +108,9 @@ std::string SingleWordVocab::wordIndexToSrcString(WordIndex w)const
 //-------------------------
 bool SingleWordVocab::existSrcSymbol(std::string s)const
 {
- StrToIdxVocab::const_iterator strToIdxVocabIter;
-	
- strToIdxVocabIter=stringToSrcWordIndexMap.find(s);
- if(strToIdxVocabIter!=stringToSrcWordIndexMap.end())
+ WordIndex wordIndex;
+
+ if(srcVocab.find(s,wordIndex))
  {
    return 1;
  }
@@ -127,18 +136,15 @@ std::vector<WordIndex> SingleWordVocab::strVectorToSrcIndexVector(std::vector<st
 WordIndex SingleWordVocab::addSrcSymbol(std::string s)
 {
  WordIndex wordIndex;	
- StrToIdxVocab::const_iterator strToIdxVocabIter;
 	
- strToIdxVocabIter=stringToSrcWordIndexMap.find(s);
- if(strToIdxVocabIter!=stringToSrcWordIndexMap.end()) 
+ if(srcVocab.find(s,wordIndex)) 
  {
-   return strToIdxVocabIter->second;
+   return wordIndex;
  }
  else
  {
-   wordIndex=stringToSrcWordIndexMap.size();	
-   stringToSrcWordIndexMap[s]=wordIndex;
-   srcWordIndexMapToString[wordIndex]=s; 
+   wordIndex=srcVocab.size();	
+   srcVocab.add(s,wordIndex);
  }
  return wordIndex;
 }
@@ -170,8 +176,7 @@ bool SingleWordVocab::loadGIZASrcVocab(const char *srcInputVocabFileName)
      {
        if(awk.NF==2 || awk.NF==3)
        {
-         stringToSrcWordIndexMap[awk.dollar(2)]=atoi(awk.dollar(1).c_str());
-         srcWordIndexMapToString[atoi(awk.dollar(1).c_str())]=awk.dollar(2);   
+         srcVocab.add(awk.dollar(2),awk.dollarAtoi(1));
        }
        else
        {
@@ -197,7 +202,7 @@ bool SingleWordVocab::printGIZASrcVocab(const char *outputFileName)
    std::cerr<<"Error while printing source vocabulary."<<std::endl;
    return THOT_ERROR;
  }
- outF<<stringToSrcWordIndexMap;
+ outF<<srcVocab;
  outF.close();
  return THOT_OK;
 }
@@ -208,27 +213,38 @@ bool SingleWordVocab::loadTrgVocab(const char *trgInputVocabFileName)
   return loadGIZATrgVocab(trgInputVocabFileName);
 }
 
+//-------------------------
+void SingleWordVocab::getTrgVocabEntries(std::vector<std::pair<std::string,WordIndex> >& entries)const
+{
+ trgVocab.getEntries(entries);
+}
+
 //-------------------------
 SingleWordVocab::StrToIdxVocab SingleWordVocab::getTrgVocab(void)const
 {
- return stringToTrgWordIndexMap;	
+ std::vector<std::pair<std::string,WordIndex> > entries;
+ StrToIdxVocab vocab;
+
+ trgVocab.getEntries(entries);
+ for(unsigned int i=0;i<entries.size();++i)
+   vocab[entries[i].first]=entries[i].second;
+ return vocab;
 }
 
 //-------------------------
 size_t SingleWordVocab::getTrgVocabSize(void)const
 {
- return stringToTrgWordIndexMap.size();	
+ return trgVocab.size();
 }
 
 //-------------------------
 WordIndex SingleWordVocab::stringToTrgWordIndex(std::string t)const
 {
- StrToIdxVocab::const_iterator trgVocabIter;
-	
- trgVocabIter=stringToTrgWordIndexMap.find(t);
- if(trgVocabIter!=stringToTrgWordIndexMap.end())
+ WordIndex wordIndex;
+
+ if(trgVocab.find(t,wordIndex))
  {
-   return trgVocabIter->second;
+   return wordIndex;
  }
  else return UNK_WORD;
 }
@@ -236,12 +252,11 @@ WordIndex SingleWordVocab::stringToTrgWordIndex(std::string t)const
 //-------------------------
 std::string SingleWordVocab::wordIndexToTrgString(WordIndex w)const
 {
-  IdxToStrVocab::const_iterator trgVocabIter;
-	
-  trgVocabIter=trgWordIndexMapToString.find(w);
-  if(trgVocabIter!=trgWordIndexMapToString.end())
+  const char* word=trgVocab.getWord(w);
+
+  if(word!=NULL)
   {
-	return trgVocabIter->second;
+	return word;
   }
   else return UNK_WORD_STR;
 }
@@ -249,10 +264,9 @@ std::string SingleWordVocab::wordIndexToTrgString(WordIndex w)const
 //-------------------------
 bool SingleWordVocab::existTrgSymbol(std::string t)const
 {
- StrToIdxVocab::const_iterator trgVocabIter;
-	
- trgVocabIter=stringToTrgWordIndexMap.find(t);
- if(trgVocabIter!=stringToTrgWordIndexMap.end())
+ WordIndex wordIndex;
+
+ if(trgVocab.find(t,wordIndex))
  {
    return 1;
  }
@@ -277,18 +291,15 @@ std::vector<WordIndex> SingleWordVocab::strVectorToTrgIndexVector(std::vector<st
 WordIndex SingleWordVocab::addTrgSymbol(std::string t)
 {
  WordIndex wordIndex;	
- StrToIdxVocab::const_iterator trgVocabIter;
 	
- trgVocabIter=stringToTrgWordIndexMap.find(t);
- if(trgVocabIter!=stringToTrgWordIndexMap.end()) 
+ if(trgVocab.find(t,wordIndex)) 
  {
-   return trgVocabIter->second;
+   return wordIndex;
  }
  else
  {
-  wordIndex=stringToTrgWordIndexMap.size();	
-  stringToTrgWordIndexMap[t]=wordIndex;
-  trgWordIndexMapToString[wordIndex]=t; 
+  wordIndex=trgVocab.size();	
+  trgVocab.add(t,wordIndex);
  }
  return wordIndex;
 }
@@ -320,8 +331,7 @@ bool SingleWordVocab::loadGIZATrgVocab(const char *trgInputVocabFileName)
      {
        if(awk.NF==2 || awk.NF==3)
        {
-         stringToTrgWordIndexMap[awk.dollar(2)]=atoi(awk.dollar(1).c_str());
-         trgWordIndexMapToString[atoi(awk.dollar(1).c_str())]=awk.dollar(2);    
+         trgVocab.add(awk.dollar(2),awk.dollarAtoi(1));
        }
        else
        {
@@ -347,7 +357,7 @@ bool SingleWordVocab::printGIZATrgVocab(const char *outputFileName)
    std::cerr<<"Error while printing target vocabulary."<<std::endl;
    return THOT_ERROR;
  }
- outF<<stringToTrgWordIndexMap;
+ outF<<trgVocab;
  outF.close();
  return THOT_OK;
 }
@@ -355,8 +365,7 @@ bool SingleWordVocab::printGIZATrgVocab(const char *outputFileName)
 //-------------------------
 void SingleWordVocab::clearSrcVocab(void)
 {
-  stringToSrcWordIndexMap.clear();
-  srcWordIndexMapToString.clear();
+  srcVocab.clear();
 
   add_null_word_to_srcvoc();
   add_unk_word_to_srcvoc();
@@ -366,8 +375,7 @@ void SingleWordVocab::clearSrcVocab(void)
 //-------------------------
 void SingleWordVocab::clearTrgVocab(void)
 {
-  stringToTrgWordIndexMap.clear();
-  trgWordIndexMapToString.clear();
+  trgVocab.clear();
 
   add_null_word_to_trgvoc();
   add_unk_word_to_trgvoc();
@@ -384,43 +392,37 @@ void SingleWordVocab::clear(void)
 //-------------------------
 void SingleWordVocab::add_null_word_to_srcvoc(void)
 {
-  stringToSrcWordIndexMap[NULL_WORD_STR]=NULL_WORD;
-  srcWordIndexMapToString[NULL_WORD]=NULL_WORD_STR;
+  srcVocab.add(NULL_WORD_STR,NULL_WORD);
 }
 
 //-------------------------
 void SingleWordVocab::add_null_word_to_trgvoc(void)
 {
-  stringToTrgWordIndexMap[NULL_WORD_STR]=NULL_WORD;
-  trgWordIndexMapToString[NULL_WORD]=NULL_WORD_STR;
+  trgVocab.add(NULL_WORD_STR,NULL_WORD);
 }
 
 //-------------------------
 void SingleWordVocab::add_unk_word_to_srcvoc(void)
 {
-  stringToSrcWordIndexMap[UNK_WORD_STR]=UNK_WORD;
-  srcWordIndexMapToString[UNK_WORD]=UNK_WORD_STR;
+  srcVocab.add(UNK_WORD_STR,UNK_WORD);
 }
 
 //-------------------------
 void SingleWordVocab::add_unk_word_to_trgvoc(void)
 {
-  stringToTrgWordIndexMap[UNK_WORD_STR]=UNK_WORD;
-  trgWordIndexMapToString[UNK_WORD]=UNK_WORD_STR;
+  trgVocab.add(UNK_WORD_STR,UNK_WORD);
 }
 
 //-------------------------
 void SingleWordVocab::add_unused_word_to_srcvoc(void)
 {
-  stringToSrcWordIndexMap[UNUSED_WORD_STR]=UNUSED_WORD;
-  srcWordIndexMapToString[UNUSED_WORD]=UNUSED_WORD_STR;
+  srcVocab.add(UNUSED_WORD_STR,UNUSED_WORD);
 }
 
 //-------------------------
 void SingleWordVocab::add_unused_word_to_trgvoc(void)
 {
-  stringToTrgWordIndexMap[UNUSED_WORD_STR]=UNUSED_WORD;
-  trgWordIndexMapToString[UNUSED_WORD]=UNUSED_WORD_STR;
+  trgVocab.add(UNUSED_WORD_STR,UNUSED_WORD);
 }
 
 //-------------------------
@@ -51,9 +51,11 @@ using __gnu_cxx::hash_map;
 #endif
 
 #include "StatModelDefs.h"
+#include "ArenaWordVocab.h"
 #include "awkInputStream.h"
 #include <string>
 #include <vector>
+#include <utility>
 
 //--------------- Constants -------------------------------------------
 
@@ -101,6 +103,12 @@ class SingleWordVocab
    
    // Functions related to the source vocabulary
    StrToIdxVocab getSrcVocab(void)const;
+       // Returns a copy of the source vocabulary, which is built by
+       // inserting every word into a new map; getSrcVocabEntries()
+       // should be used when only the entries are required
+   void getSrcVocabEntries(std::vector<std::pair<std::string,WordIndex> >& entries)const;
+       // Obtains the words of the source vocabulary and their indices
+       // sorted by index
    size_t getSrcVocabSize(void)const; // Returns the source vocabulary size
    WordIndex stringToSrcWordIndex(std::string s)const;
    std::string wordIndexToSrcString(WordIndex w)const;
@@ -118,6 +126,12 @@ class SingleWordVocab
 
    // Functions related to the target vocabulary
    StrToIdxVocab getTrgVocab(void)const;
+       // Returns a copy of the target vocabulary, which is built by
+       // inserting every word into a new map; getTrgVocabEntries()
+       // should be used when only the entries are required
+   void getTrgVocabEntries(std::vector<std::pair<std::string,WordIndex> >& entries)const;
+       // Obtains the words of the target vocabulary and their indices
+       // sorted by index
    size_t getTrgVocabSize(void)const; // Returns the target vocabulary size
    WordIndex stringToTrgWordIndex(std::string t)const;
    std::string wordIndexToTrgString(WordIndex w)const;
@@ -140,10 +154,8 @@ class SingleWordVocab
    ~SingleWordVocab();
 
   protected:
-   StrToIdxVocab stringToSrcWordIndexMap;
-   IdxToStrVocab srcWordIndexMapToString;
-   StrToIdxVocab stringToTrgWordIndexMap;
-   IdxToStrVocab trgWordIndexMapToString;
+   ArenaWordVocab srcVocab;
+   ArenaWordVocab trgVocab;
       
    void clearSrcVocab(void);
    void clearTrgVocab(void);
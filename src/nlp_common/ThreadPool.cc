@@ -0,0 +1,197 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*********************************************************************/
+/*                                                                   */
+/* Module: ThreadPool                                                */
+/*                                                                   */
+/* Definitions file: ThreadPool.cc                                   */
+/*                                                                   */
+/*********************************************************************/
+
+
+//--------------- Include files ---------------------------------------
+
+#include "ThreadPool.h"
+
+//--------------- Global variables ------------------------------------
+
+//--------------- Function declarations
+
+//--------------- Constants
+
+//--------------- Classes ---------------------------------------------
+
+//-------------------------
+ThreadPool::ThreadPool(void)
+{
+  numWorkers=1;
+  taskFunc=NULL;
+  taskData=NULL;
+  numTasks=0;
+  nextTask=0;
+  pendingTasks=0;
+  batchId=0;
+  finish=false;
+  pthread_mutex_init(&mut,NULL);
+  pthread_cond_init(&workCond,NULL);
+  pthread_cond_init(&doneCond,NULL);
+}
+
+//-------------------------
+int ThreadPool::init(unsigned int _numWorkers)
+{
+  release();
+
+  if(_numWorkers==0)
+    _numWorkers=1;
+
+      // Reserve memory for the arguments of the threads so as to avoid
+      // reallocations while the threads are being created
+  workerArgVec.clear();
+  workerArgVec.reserve(_numWorkers);
+  numWorkers=1;
+
+      // Create threads (the calling thread is the worker number zero)
+  for(unsigned int i=1;i<_numWorkers;++i)
+  {
+    pthread_t thread;
+    workerArgVec.push_back(std::make_pair(this,i));
+    if(pthread_create(&thread,NULL,&ThreadPool::workerEntry,(void*)&workerArgVec.back())!=0)
+    {
+      std::cerr<<"Error while creating worker threads"<<std::endl;
+      release();
+      return THOT_ERROR;
+    }
+    threadVec.push_back(thread);
+    ++numWorkers;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+unsigned int ThreadPool::getNumWorkers(void)const
+{
+  return numWorkers;
+}
+
+//-------------------------
+void ThreadPool::run(task_func_t* _taskFunc,
+                     void* _taskData,
+                     unsigned int _numTasks)
+{
+  if(_numTasks==0)
+    return;
+
+  pthread_mutex_lock(&mut);
+  /////////// begin of mutex
+
+      // Publish new batch of tasks
+  taskFunc=_taskFunc;
+  taskData=_taskData;
+  numTasks=_numTasks;
+  nextTask=0;
+  pendingTasks=_numTasks;
+  ++batchId;
+  pthread_cond_broadcast(&workCond);
+
+      // Take part in the execution of the tasks
+  execTasks(0);
+
+      // Wait until the tasks being executed by other workers finish
+  while(pendingTasks>0)
+    pthread_cond_wait(&doneCond,&mut);
+
+  /////////// end of mutex
+  pthread_mutex_unlock(&mut);
+}
+
+//-------------------------
+void ThreadPool::release(void)
+{
+  pthread_mutex_lock(&mut);
+  finish=true;
+  pthread_cond_broadcast(&workCond);
+  pthread_mutex_unlock(&mut);
+
+  for(unsigned int i=0;i<threadVec.size();++i)
+    pthread_join(threadVec[i],NULL);
+  threadVec.clear();
+  workerArgVec.clear();
+  numWorkers=1;
+  finish=false;
+}
+
+//-------------------------
+void* ThreadPool::workerEntry(void* arg)
+{
+  std::pair<ThreadPool*,unsigned int>* workerArgPtr=(std::pair<ThreadPool*,unsigned int>*) arg;
+  workerArgPtr->first->workerLoop(workerArgPtr->second);
+  return NULL;
+}
+
+//-------------------------
+void ThreadPool::workerLoop(unsigned int workerIdx)
+{
+  pthread_mutex_lock(&mut);
+  /////////// begin of mutex
+
+  unsigned long lastBatchId=batchId;
+  while(true)
+  {
+        // Wait for a new batch of tasks
+    while(!finish && lastBatchId==batchId)
+      pthread_cond_wait(&workCond,&mut);
+    if(finish)
+      break;
+
+    lastBatchId=batchId;
+    execTasks(workerIdx);
+  }
+
+  /////////// end of mutex
+  pthread_mutex_unlock(&mut);
+}
+
+//-------------------------
+void ThreadPool::execTasks(unsigned int workerIdx)
+{
+  while(nextTask<numTasks)
+  {
+    unsigned int taskIdx=nextTask;
+    ++nextTask;
+
+        // Execute task outside of the critical section
+    pthread_mutex_unlock(&mut);
+    taskFunc(taskData,taskIdx,workerIdx);
+    pthread_mutex_lock(&mut);
+
+    --pendingTasks;
+    if(pendingTasks==0)
+      pthread_cond_broadcast(&doneCond);
+  }
+}
+
+//-------------------------
+ThreadPool::~ThreadPool()
+{
+  release();
+  pthread_mutex_destroy(&mut);
+  pthread_cond_destroy(&workCond);
+  pthread_cond_destroy(&doneCond);
+}
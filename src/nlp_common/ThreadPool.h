@@ -0,0 +1,135 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*********************************************************************/
+/*                                                                   */
+/* Module: ThreadPool                                                */
+/*                                                                   */
+/* Prototype file: ThreadPool                                        */
+/*                                                                   */
+/* Description: Implements a pool of persistent worker threads       */
+/*              that execute batches of indexed tasks.               */
+/*                                                                   */
+/*********************************************************************/
+
+/**
+ * @file ThreadPool.h
+ *
+ * @brief Implements a pool of persistent worker threads that execute
+ * batches of indexed tasks.
+ */
+
+#ifndef _ThreadPool
+#define _ThreadPool
+
+//--------------- Include files ---------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ErrorDefs.h"
+#include <pthread.h>
+#include <iostream>
+#include <vector>
+#include <utility>
+
+//--------------- Constants -------------------------------------------
+
+
+//--------------- typedefs --------------------------------------------
+
+
+//--------------- function declarations -------------------------------
+
+
+//--------------- Classes ---------------------------------------------
+
+//--------------- ThreadPool class
+
+/**
+ * @brief Pool of persistent worker threads. Each call to run() executes
+ * a batch of tasks identified by consecutive indices and blocks until
+ * all of them have finished. The calling thread takes part in the
+ * execution as worker number zero.
+ */
+
+class ThreadPool
+{
+ public:
+
+  typedef void task_func_t(void* taskData,
+                           unsigned int taskIdx,
+                           unsigned int workerIdx);
+      // Type of the functions executed by the pool. workerIdx is in the
+      // range [0,getNumWorkers()) and allows the function to access
+      // per-worker data without locking
+
+      // Constructor
+  ThreadPool(void);
+
+  int init(unsigned int _numWorkers);
+      // Starts the pool with _numWorkers workers (including the calling
+      // thread). Previously created threads are released
+  unsigned int getNumWorkers(void)const;
+
+  void run(task_func_t* _taskFunc,
+           void* _taskData,
+           unsigned int _numTasks);
+      // Executes _taskFunc(_taskData,i,workerIdx) for each i in the
+      // range [0,_numTasks). The function returns when every task has
+      // been completed
+
+  void release(void);
+      // Stops and joins the worker threads
+
+      // Destructor
+  ~ThreadPool();
+
+ private:
+
+  std::vector<pthread_t> threadVec;
+  std::vector<std::pair<ThreadPool*,unsigned int> > workerArgVec;
+  unsigned int numWorkers;
+
+  pthread_mutex_t mut;
+  pthread_cond_t workCond;
+  pthread_cond_t doneCond;
+
+      // Data of the batch of tasks being executed
+  task_func_t* taskFunc;
+  void* taskData;
+  unsigned int numTasks;
+  unsigned int nextTask;
+  unsigned int pendingTasks;
+  unsigned long batchId;
+  bool finish;
+
+  static void* workerEntry(void* arg);
+  void workerLoop(unsigned int workerIdx);
+  void execTasks(unsigned int workerIdx);
+      // Executes tasks of the current batch until there are no more
+      // tasks to assign. The mutex must be locked when calling this
+      // function
+
+      // Copies are not allowed
+  ThreadPool(const ThreadPool&);
+  void operator=(const ThreadPool&);
+};
+
+#endif
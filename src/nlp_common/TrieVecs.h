@@ -63,6 +63,11 @@ class TrieVecs
      // Inserts a sequence of elements of class key. The last element 
      // of vector keySeq is the first element of the sequence.
    DATA_TYPE* find(const std::vector<KEY>& keySeq);
+   void findBatch(const std::vector<std::vector<KEY> >& keySeqVec,
+                  std::vector<DATA_TYPE*>& dataPtrVec);
+     // Batch version of find(), dataPtrVec[i] stores the result for
+     // keySeqVec[i]. The searches are interleaved level by level and
+     // the nodes to be visited next are prefetched
 
    size_t size(void)const;
    unsigned int height(void)const;
@@ -200,6 +205,44 @@ DATA_TYPE* TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::find(const std::vector<KE
   return ((DATA_TYPE*)&(t->data));
 }
 
+//---------------
+template<class KEY,class DATA_TYPE,class KEY_SORT_CRITERION>
+void TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::findBatch(const std::vector<std::vector<KEY> >& keySeqVec,
+                                                           std::vector<DATA_TYPE*>& dataPtrVec)
+{
+  std::vector<TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>*> nodePtrVec(keySeqVec.size(),this);
+  unsigned int maxLength=0;
+
+  dataPtrVec.assign(keySeqVec.size(),(DATA_TYPE*)NULL);
+  for(unsigned int i=0;i<keySeqVec.size();++i)
+  {
+    if(keySeqVec[i].size()>maxLength)
+      maxLength=keySeqVec[i].size();
+  }
+
+      // Advance every search one level at a time, so that the
+      // children of a node are prefetched while the other searches
+      // are processed
+  for(unsigned int l=0;l<maxLength;++l)
+  {
+    for(unsigned int i=0;i<keySeqVec.size();++i)
+    {
+      if(nodePtrVec[i]!=NULL && l<keySeqVec[i].size())
+      {
+        TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION> *childrenPos=nodePtrVec[i]->children.findPtr(keySeqVec[i][l]);
+        nodePtrVec[i]=childrenPos;
+        if(childrenPos!=NULL)
+        {
+          if(l+1==keySeqVec[i].size())
+            dataPtrVec[i]=&(childrenPos->data);
+          else
+            childrenPos->children.prefetch();
+        }
+      }
+    }
+  }
+}
+
 //---------------
 template<class KEY,class DATA_TYPE,class KEY_SORT_CRITERION>
 size_t TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::size(void)const
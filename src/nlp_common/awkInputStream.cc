@@ -35,9 +35,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 awkInputStream::awkInputStream(void)
 {
  FS=0;
- buff=NULL;
- buftlen=0;
- fopen_called=false;
+ NF=0;
+ FNR=0;
 }
 
 //----------
@@ -58,14 +57,11 @@ bool awkInputStream::getln(void)
 {
   if(FS!=0)
   {
-    ssize_t read;
-
-    read=getline(&buff,&buftlen,filePtr);
-    if(read!=-1)
+    reader.setFieldSep(FS);
+    if(reader.getln())
     {
-      buff[read-1]='\0';
       ++FNR;   
-      NF=get_NF();   
+      NF=reader.numFields();
       return true;   
     }
     else return false;	
@@ -78,38 +74,24 @@ std::string awkInputStream::dollar(unsigned int n)
 {
  if(FS!=0)
  {
-  if(n==0)
-  {
-    return buff;
-  }
-  else 
-  {
-    if(n>NF) return "";
-    else
-    {
-      retrieveField(n-1);
-      return fieldStr;
-    }
-  }
+   return reader.fieldStr(n);
  }
- else return NULL;
+ else return "";
 }
 
 //----------
 bool awkInputStream::open(const char *str)
 {	
- if(fopen_called) close();
- filePtr=fopen(str,"r");
- if(filePtr==NULL)
+ if(reader.open(str)==THOT_ERROR)
  {
    FS=0;
    return THOT_ERROR;
  }
  else
  {
-   fopen_called=true;
    fileName=str;
    FNR=0;
+   NF=0;
    FS=' ';
    return THOT_OK;
  }
@@ -118,9 +100,7 @@ bool awkInputStream::open(const char *str)
 //----------
 bool awkInputStream::open_stream(FILE *stream)
 {	
- if(fopen_called) close();
- filePtr=stream;
- if(filePtr==NULL)
+ if(reader.open_stream(stream)==THOT_ERROR)
  {
    FS=0;
    return THOT_ERROR;
@@ -128,6 +108,7 @@ bool awkInputStream::open_stream(FILE *stream)
  else
  {
    FNR=0;
+   NF=0;
    FS=' ';
    return THOT_OK;
  }
@@ -136,11 +117,8 @@ bool awkInputStream::open_stream(FILE *stream)
 //----------
 void awkInputStream::close(void)
 {
-  if(fopen_called)
-    fclose(filePtr);
-  fieldStr="";
+  reader.close();
   FS=0;
-  fopen_called=false;
 }
 
 //----------
@@ -149,8 +127,7 @@ bool awkInputStream::rwd(void)
  if(FS!=0)
  {
    FNR=0;
-   rewind(filePtr);
-   return THOT_OK;
+   return reader.rwd();
  }
  else return THOT_ERROR; 
 }
@@ -162,85 +139,49 @@ void awkInputStream::printFields(void)
 	
  if(FS!=0)
  {
-   for(i=0;i<NF;++i) 	
+   for(i=1;i<=NF;++i) 	
    {
-     retrieveField(i);
-     printf("|%s",fieldStr.c_str());
+     printf("|%s",reader.fieldStr(i).c_str());
    }
  }
  printf("|\n");	 
 }
 
 //----------
-awkInputStream::~awkInputStream()
+LineFieldReader::FieldSpan awkInputStream::dollarSpan(unsigned int n)const
 {
- if(buff!=NULL) free(buff);
- if(fopen_called) close();
+  return reader.field(n);
 }
 
 //----------
-int awkInputStream::get_NF(void)
+bool awkInputStream::dollarEquals(unsigned int n,const char* str)const
 {
- unsigned int i=0;
-
- NF=0;
-	
- while(buff[i]!=0 && buff[i]==FS) ++i;	
- while(buff[i]!=0)
- {
-   if(buff[i]==FS)
-   {
-     ++NF;
-	 while(buff[i]!=0 && buff[i]==FS) ++i;	
-   }
-   else
-   {
-     ++i;
-     if(buff[i]==0) ++NF;
-   }
- }
- return NF;
+  return reader.fieldEquals(n,str);
 }
 
 //----------
-void awkInputStream::retrieveField(unsigned int n)
+double awkInputStream::dollarAtof(unsigned int n)const
 {
- unsigned int numFields=0,i=0;
-
- fieldStr="";
- NF=0;
-	
- while(buff[i]!=0 && buff[i]==FS) ++i;	
- while(buff[i]!=0)
- {
-  if(buff[i]==FS)
-  {
-    ++NF;
-    while(buff[i]!=0 && buff[i]==FS) ++i;	
-  }
+      // Fields end at a separator or at the end of the line, so that
+      // they are converted in place
+  LineFieldReader::FieldSpan span=reader.field(n);
+  if(span.len==0)
+    return 0;
   else
-  {
-    ++i;
-    if(buff[i]==0) ++NF;
-  }
- }
- 
- i=0;
- numFields=0; 
- while(buff[i]!=0 && buff[i]==FS) ++i;
- while(buff[i]!=0)
- {
-   if(buff[i]==FS)
-   {
-	 ++numFields;
-	 while(buff[i]!=0 && buff[i]==FS) ++i;
-   }
+    return strtod(span.ptr,NULL);
+}
+
+//----------
+int awkInputStream::dollarAtoi(unsigned int n)const
+{
+  LineFieldReader::FieldSpan span=reader.field(n);
+  if(span.len==0)
+    return 0;
   else
-  {
-    if(n==numFields) fieldStr+=buff[i];
-    ++i;
-    if(buff[i]==0 && n==numFields) {++numFields;}
-  }
-   if(numFields>n) break;	
- }	
+    return (int) strtol(span.ptr,NULL,10);
+}
+
+//----------
+awkInputStream::~awkInputStream()
+{
 }
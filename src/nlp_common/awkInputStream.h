@@ -49,6 +49,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif
 
 #include "ErrorDefs.h"
+#include "LineFieldReader.h"
 #include "getline.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -59,7 +60,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <fstream>
 
-//--------------- awkInputStream class: awk-like input stream class
+//--------------- awkInputStream class: awk-like input stream class.
+//                Lines are split once by LineFieldReader, so that
+//                accessing a field does not require scanning the line
 
 class awkInputStream
 {
@@ -79,17 +82,19 @@ class awkInputStream
 	void close(void);
 	bool rwd(void);
 	void printFields(void);	
+
+        // Functions to access fields without copying them
+    LineFieldReader::FieldSpan dollarSpan(unsigned int n)const;
+    bool dollarEquals(unsigned int n,const char* str)const;
+        // Returns true if field n is equal to str
+    double dollarAtof(unsigned int n)const;
+    int dollarAtoi(unsigned int n)const;
+        // Equivalent to atof(dollar(n).c_str()) and
+        // atoi(dollar(n).c_str())
 	~awkInputStream();
 	
  protected:        
-	std::string fieldStr;
-    char * buff;
-    size_t buftlen;
-    FILE* filePtr;
-    bool fopen_called;
-    
-	int  get_NF(void);
-	void retrieveField(unsigned int n);
+    LineFieldReader reader;
 };
 
 #endif
@@ -28,27 +28,30 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "HatTriePhraseTable.h"
+#include <string.h>
 
 //--------------- Function definitions
 
 //-------------------------
 HatTriePhraseTable::HatTriePhraseTable(void)
 {
+    phraseTableShards.resize(1);
 }
 
 //-------------------------
 std::string HatTriePhraseTable::vectorToStdString(const std::vector<WordIndex>& vec)const
 {
-    std::vector<WordIndex> str;
+    std::string s(vec.size() * WORD_INDEX_MODULO_BYTES, '\0');
     for(size_t i = 0; i < vec.size(); i++) {
-        // Use WORD_INDEX_MODULO_BYTES bytes to encode index
+        // Use WORD_INDEX_MODULO_BYTES bytes to encode index, the most
+        // significant digit first
+        unsigned int wi = vec[i];
         for(int j = WORD_INDEX_MODULO_BYTES - 1; j >= 0; j--) {
-            str.push_back(1 + (vec[i] / (unsigned int) pow(WORD_INDEX_MODULO_BASE, j) % WORD_INDEX_MODULO_BASE));
+            s[i * WORD_INDEX_MODULO_BYTES + j] = (char) (1 + wi % WORD_INDEX_MODULO_BASE);
+            wi /= WORD_INDEX_MODULO_BASE;
         }
     }
 
-    std::string s(str.begin(), str.end());
-
     return s;
 }
 
@@ -61,7 +64,7 @@ std::vector<WordIndex> HatTriePhraseTable::stringToVector(const std::string s)co
     {
         unsigned int wi = 0;
         for(int j = WORD_INDEX_MODULO_BYTES - 1; j >= 0; j--, i++) {
-            wi += (((unsigned char) s[i]) - 1) * (unsigned int) pow(WORD_INDEX_MODULO_BASE, j);
+            wi = wi * WORD_INDEX_MODULO_BASE + (((unsigned char) s[i]) - 1);
         }
 
         vec.push_back(wi);
@@ -229,8 +232,9 @@ void HatTriePhraseTable::addTableEntry(const std::vector<WordIndex>& s,
 void HatTriePhraseTable::addSrcInfo(const std::vector<WordIndex>& s,
                                     Count s_inf)
 {
-    std::string srcKey = vectorToKey(getSrc(s));
-    phraseTable[srcKey.c_str()] = s_inf;
+    std::vector<WordIndex> srcVec = getSrc(s);
+    std::string srcKey = vectorToKey(srcVec);
+    getShard(srcVec)[srcKey.c_str()] = s_inf;
 }
 
 //-------------------------
@@ -238,7 +242,7 @@ void HatTriePhraseTable::addTrgInfo(const std::vector<WordIndex>& t,
                                     Count t_inf)
 {
     std::string trgKey = vectorToKey(t);
-    phraseTable[trgKey.c_str()] = t_inf;
+    getShard(t)[trgKey.c_str()] = t_inf;
 }
 
 //-------------------------
@@ -246,8 +250,9 @@ void HatTriePhraseTable::addSrcTrgInfo(const std::vector<WordIndex>& s,
                                        const std::vector<WordIndex>& t,
                                        Count st_inf)
 {
-    std::string trgSrcKey = vectorToKey(getTrgSrc(s, t));
-    phraseTable[trgSrcKey.c_str()] = st_inf;
+    std::vector<WordIndex> trgSrcVec = getTrgSrc(s, t);
+    std::string trgSrcKey = vectorToKey(trgSrcVec);
+    getShard(trgSrcVec)[trgSrcKey.c_str()] = st_inf;
 }
 
 //-------------------------
@@ -290,10 +295,12 @@ PhrasePairInfo HatTriePhraseTable::infSrcTrg(const std::vector<WordIndex>& s,
 Count HatTriePhraseTable::getSrcInfo(const std::vector<WordIndex>& s,
                                      bool &found)
 {
-    std::string srcKey = vectorToKey(getSrc(s));
-    PhraseTable::iterator iter = phraseTable.find(srcKey.c_str());
+    std::vector<WordIndex> srcVec = getSrc(s);
+    std::string srcKey = vectorToKey(srcVec);
+    const PhraseTable& shard = getShard(srcVec);
+    PhraseTable::const_iterator iter = shard.find(srcKey.c_str());
 
-    if (iter == phraseTable.end())  // Check if s exists in collection
+    if (iter == shard.end())  // Check if s exists in collection
     {
         found = false;
         return 0;
@@ -310,9 +317,10 @@ Count HatTriePhraseTable::getTrgInfo(const std::vector<WordIndex>& t,
                                      bool &found)
 {
     std::string trgKey = vectorToKey(t);
-    PhraseTable::iterator iter = phraseTable.find(trgKey.c_str());
+    const PhraseTable& shard = getShard(t);
+    PhraseTable::const_iterator iter = shard.find(trgKey.c_str());
 
-    if (iter == phraseTable.end())  // Check if t exists in collection
+    if (iter == shard.end())  // Check if t exists in collection
     {
         found = false;
         return 0;
@@ -329,11 +337,13 @@ Count HatTriePhraseTable::getSrcTrgInfo(const std::vector<WordIndex>& s,
                                         const std::vector<WordIndex>& t,
                                         bool &found)
 {
-    std::string trgSrcKey = vectorToKey(getTrgSrc(s, t));
-    PhraseTable::iterator iter = phraseTable.find(trgSrcKey);
+    std::vector<WordIndex> trgSrcVec = getTrgSrc(s, t);
+    std::string trgSrcKey = vectorToKey(trgSrcVec);
+    const PhraseTable& shard = getShard(trgSrcVec);
+    PhraseTable::const_iterator iter = shard.find(trgSrcKey);
 
     // // Check if entry for (s, t) pair exists
-    if (iter == phraseTable.end())
+    if (iter == shard.end())
     {
         found = false;
         return 0;
@@ -405,7 +415,7 @@ bool HatTriePhraseTable::getEntriesForTarget(const std::vector<WordIndex>& t,
     std::vector<WordIndex> trgSrcPrefix = getTrgSrc(emptyVec, t);
     std::string trgSrcPrefixStr = vectorToKey(trgSrcPrefix);
 
-    auto prefixIterators = phraseTable.equal_prefix_range(trgSrcPrefixStr);
+    auto prefixIterators = getShard(trgSrcPrefix).equal_prefix_range(trgSrcPrefixStr);
 
     for(auto iter = prefixIterators.first; iter != prefixIterators.second; iter++)
     {
@@ -431,7 +441,8 @@ bool HatTriePhraseTable::getEntriesForSource(const std::vector<WordIndex>& s,
     std::vector<WordIndex> srcVec = getSrc(s);  // (UNUSED_WORD, s)
 
     // Scan (s, t) collection to find matching elements for a given s
-    for (auto iter = phraseTable.begin(); iter != phraseTable.end(); iter++)
+    for (size_t shardIdx = 0; shardIdx < phraseTableShards.size(); shardIdx++)
+    for (auto iter = phraseTableShards[shardIdx].begin(); iter != phraseTableShards[shardIdx].end(); iter++)
     {
         std::vector<WordIndex> phrase = keyToVector(iter.key());
 
@@ -484,7 +495,8 @@ void HatTriePhraseTable::print(void)
 {
     size_t i;
 
-    for (PhraseTable::iterator iter = phraseTable.begin(); iter != phraseTable.end(); iter++)
+    for (size_t shardIdx = 0; shardIdx < phraseTableShards.size(); shardIdx++)
+    for (PhraseTable::iterator iter = phraseTableShards[shardIdx].begin(); iter != phraseTableShards[shardIdx].end(); iter++)
     {
         std::vector<WordIndex> s;
         std::vector<WordIndex> t;
@@ -528,12 +540,17 @@ void HatTriePhraseTable::printVector(const std::vector<WordIndex>& vec) const
 //-------------------------
 size_t HatTriePhraseTable::size(void)
 {
-    return phraseTable.size();
+    size_t result = 0;
+    for (size_t i = 0; i < phraseTableShards.size(); i++)
+        result += phraseTableShards[i].size();
+
+    return result;
 }
 //-------------------------
 void HatTriePhraseTable::clear(void)
 {
-    phraseTable.clear();
+    phraseTableShards.clear();
+    phraseTableShards.resize(1);
 }
 
 //-------------------------
@@ -548,6 +565,294 @@ bool HatTriePhraseTable::isTargetPhrase(const std::vector<WordIndex>& vec) const
     return true;
 }
 
+//-------------------------
+size_t HatTriePhraseTable::getShardIdx(const std::vector<WordIndex>& keyVec)const
+{
+    if (phraseTableShards.size() == 1 || keyVec.empty())
+        return 0;
+
+    WordIndex w = keyVec[0];
+    if (w == UNUSED_WORD && keyVec.size() > 1)
+        w = keyVec[1];
+
+    return w % phraseTableShards.size();
+}
+
+//-------------------------
+HatTriePhraseTable::PhraseTable& HatTriePhraseTable::getShard(const std::vector<WordIndex>& keyVec)
+{
+    return phraseTableShards[getShardIdx(keyVec)];
+}
+
+//-------------------------
+const HatTriePhraseTable::PhraseTable& HatTriePhraseTable::getShard(const std::vector<WordIndex>& keyVec)const
+{
+    return phraseTableShards[getShardIdx(keyVec)];
+}
+
+//-------------------------
+void HatTriePhraseTable::initShards(unsigned int numShards)
+{
+    phraseTableShards.clear();
+    phraseTableShards.resize(numShards == 0 ? 1 : numShards);
+}
+
+//-------------------------
+void HatTriePhraseTable::addEntries(const std::vector<TableEntry>& entries,
+                                    ThreadPool& threadPool)
+{
+    // Distribute the entries among the shards of their keys. The target
+    // key and the (target, source) key share the shard of the target
+    // phrase
+    std::vector<std::vector<size_t> > srcBuckets(phraseTableShards.size());
+    std::vector<std::vector<size_t> > trgBuckets(phraseTableShards.size());
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        srcBuckets[getShardIdx(getSrc(entries[i].s))].push_back(i);
+        trgBuckets[getShardIdx(entries[i].t)].push_back(i);
+    }
+
+    // Each task processes the buckets of one shard
+    BuildTaskData taskData;
+    taskData.ptPtr = this;
+    taskData.entriesPtr = &entries;
+    taskData.srcBucketsPtr = &srcBuckets;
+    taskData.trgBucketsPtr = &trgBuckets;
+    threadPool.run(buildShardTask, (void*) &taskData, phraseTableShards.size());
+}
+
+//-------------------------
+void HatTriePhraseTable::buildFromEntries(const std::vector<TableEntry>& entries,
+                                          unsigned int numThreads)
+{
+    if (numThreads == 0)
+        numThreads = 1;
+
+    initShards(numThreads);
+
+    ThreadPool threadPool;
+    threadPool.init(numThreads);
+    addEntries(entries, threadPool);
+    threadPool.release();
+
+    freeze();
+}
+
+//-------------------------
+void HatTriePhraseTable::buildShardTask(void* taskData,
+                                        unsigned int taskIdx,
+                                        unsigned int /*workerIdx*/)
+{
+    BuildTaskData* buildTaskDataPtr = (BuildTaskData*) taskData;
+    HatTriePhraseTable* ptPtr = buildTaskDataPtr->ptPtr;
+    const std::vector<TableEntry>& entries = *buildTaskDataPtr->entriesPtr;
+    const std::vector<size_t>& srcBucket = (*buildTaskDataPtr->srcBucketsPtr)[taskIdx];
+    const std::vector<size_t>& trgBucket = (*buildTaskDataPtr->trgBucketsPtr)[taskIdx];
+    PhraseTable& shard = ptPtr->phraseTableShards[taskIdx];
+
+    // Buckets keep the order of the entries, so the counts are the
+    // same as those obtained by addTableEntry()
+    for (size_t i = 0; i < srcBucket.size(); i++)
+    {
+        const TableEntry& entry = entries[srcBucket[i]];
+        shard[ptPtr->vectorToKey(ptPtr->getSrc(entry.s))] = entry.inf.first.get_c_s();
+    }
+
+    for (size_t i = 0; i < trgBucket.size(); i++)
+    {
+        const TableEntry& entry = entries[trgBucket[i]];
+
+        std::string trgKey = ptPtr->vectorToKey(entry.t);
+        PhraseTable::iterator iter = shard.find(trgKey);
+        Count t_count = (iter == shard.end()) ? Count() : iter.value();
+        shard[trgKey] = (t_count + entry.inf.second).get_c_s();
+
+        shard[ptPtr->vectorToKey(ptPtr->getTrgSrc(entry.s, entry.t))] = entry.inf.second.get_c_st();
+    }
+}
+
+//-------------------------
+void HatTriePhraseTable::freeze(void)
+{
+    for (size_t i = 0; i < phraseTableShards.size(); i++)
+        phraseTableShards[i].shrink_to_fit();
+}
+
+//-------------------------
+bool HatTriePhraseTable::write(FILE* file)const
+{
+    // Write header
+    char magic[8];
+    memcpy(magic, HAT_TRIE_PT_MAGIC, sizeof(magic));
+    unsigned int version = HAT_TRIE_PT_FORMAT_VERSION;
+    unsigned int numShards = phraseTableShards.size();
+    if (fwrite(magic, sizeof(magic), 1, file) != 1 ||
+        fwrite(&version, sizeof(version), 1, file) != 1 ||
+        fwrite(&numShards, sizeof(numShards), 1, file) != 1)
+        return THOT_ERROR;
+
+    // Write shards, each one as a block of records containing the
+    // length of the key, the key and the count
+    std::string key;
+    for (size_t i = 0; i < phraseTableShards.size(); i++)
+    {
+        std::vector<char> blob;
+        for (PhraseTable::const_iterator iter = phraseTableShards[i].begin(); iter != phraseTableShards[i].end(); iter++)
+        {
+            iter.key(key);
+            unsigned int keyLen = key.size();
+            float c = iter.value().get_c_s();
+            blob.insert(blob.end(), (const char*) &keyLen, (const char*) &keyLen + sizeof(keyLen));
+            blob.insert(blob.end(), key.begin(), key.end());
+            blob.insert(blob.end(), (const char*) &c, (const char*) &c + sizeof(c));
+        }
+
+        unsigned long long blobSize = blob.size();
+        if (fwrite(&blobSize, sizeof(blobSize), 1, file) != 1 ||
+            (blobSize > 0 && fwrite(&blob[0], 1, blobSize, file) != blobSize))
+            return THOT_ERROR;
+    }
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool HatTriePhraseTable::read(FILE* file,
+                              unsigned int numThreads)
+{
+    // Read header
+    char magic[8];
+    unsigned int version;
+    unsigned int numShards;
+    if (fread(magic, sizeof(magic), 1, file) != 1 ||
+        fread(&version, sizeof(version), 1, file) != 1 ||
+        fread(&numShards, sizeof(numShards), 1, file) != 1)
+    {
+        std::cerr << "Error, binary phrase table is truncated" << std::endl;
+        return THOT_ERROR;
+    }
+    if (strncmp(magic, HAT_TRIE_PT_MAGIC, sizeof(magic)) != 0 || version != HAT_TRIE_PT_FORMAT_VERSION || numShards == 0)
+    {
+        std::cerr << "Error, binary phrase table has an unknown format" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // Determine the number of bytes left in the file, so that corrupted
+    // sizes are detected before allocating memory for them
+    long pos = ftell(file);
+    if (pos < 0 || fseek(file, 0, SEEK_END) != 0)
+    {
+        std::cerr << "Error, binary phrase table could not be read" << std::endl;
+        return THOT_ERROR;
+    }
+    long end = ftell(file);
+    if (end < pos || fseek(file, pos, SEEK_SET) != 0)
+    {
+        std::cerr << "Error, binary phrase table could not be read" << std::endl;
+        return THOT_ERROR;
+    }
+    unsigned long long remainingSize = end - pos;
+    if ((unsigned long long) numShards * sizeof(unsigned long long) > remainingSize)
+    {
+        std::cerr << "Error, binary phrase table is truncated" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // Read the blocks of the shards
+    std::vector<std::vector<char> > blobs(numShards);
+    for (size_t i = 0; i < numShards; i++)
+    {
+        unsigned long long blobSize;
+        if (fread(&blobSize, sizeof(blobSize), 1, file) != 1)
+        {
+            std::cerr << "Error, binary phrase table is truncated" << std::endl;
+            return THOT_ERROR;
+        }
+        remainingSize -= sizeof(blobSize);
+        if (blobSize > remainingSize)
+        {
+            std::cerr << "Error, binary phrase table is truncated" << std::endl;
+            return THOT_ERROR;
+        }
+        remainingSize -= blobSize;
+        blobs[i].resize(blobSize);
+        if (blobSize > 0 && fread(&blobs[i][0], 1, blobSize, file) != blobSize)
+        {
+            std::cerr << "Error, binary phrase table is truncated" << std::endl;
+            return THOT_ERROR;
+        }
+    }
+
+    // Insert the keys of each shard in parallel
+    phraseTableShards.clear();
+    phraseTableShards.resize(numShards);
+
+    std::vector<char> errorFlags(numShards, false);
+    ReadTaskData taskData;
+    taskData.ptPtr = this;
+    taskData.blobsPtr = &blobs;
+    taskData.errorFlagsPtr = &errorFlags;
+
+    ThreadPool threadPool;
+    threadPool.init(numThreads == 0 ? 1 : numThreads);
+    threadPool.run(readShardTask, (void*) &taskData, numShards);
+    threadPool.release();
+
+    for (size_t i = 0; i < numShards; i++)
+    {
+        if (errorFlags[i])
+        {
+            std::cerr << "Error, binary phrase table contains malformed records" << std::endl;
+            clear();
+            return THOT_ERROR;
+        }
+    }
+
+    freeze();
+
+    return THOT_OK;
+}
+
+//-------------------------
+void HatTriePhraseTable::readShardTask(void* taskData,
+                                       unsigned int taskIdx,
+                                       unsigned int /*workerIdx*/)
+{
+    ReadTaskData* readTaskDataPtr = (ReadTaskData*) taskData;
+    const std::vector<char>& blob = (*readTaskDataPtr->blobsPtr)[taskIdx];
+    PhraseTable& shard = readTaskDataPtr->ptPtr->phraseTableShards[taskIdx];
+    char& error = (*readTaskDataPtr->errorFlagsPtr)[taskIdx];
+
+    size_t pos = 0;
+    while (pos < blob.size())
+    {
+        unsigned int keyLen;
+        if (pos + sizeof(keyLen) > blob.size())
+        {
+            error = true;
+            return;
+        }
+        memcpy(&keyLen, &blob[pos], sizeof(keyLen));
+        pos += sizeof(keyLen);
+        if (keyLen + sizeof(float) > blob.size() - pos)
+        {
+            error = true;
+            return;
+        }
+
+        float c;
+        memcpy(&c, &blob[pos + keyLen], sizeof(c));
+        shard.insert_ks(&blob[pos], keyLen, Count(c));
+        pos += keyLen + sizeof(c);
+    }
+}
+
+//-------------------------
+unsigned int HatTriePhraseTable::getNumShards(void)const
+{
+    return phraseTableShards.size();
+}
+
 //-------------------------
 HatTriePhraseTable::~HatTriePhraseTable(void)
 {
@@ -556,36 +861,54 @@ HatTriePhraseTable::~HatTriePhraseTable(void)
 //-------------------------
 HatTriePhraseTable::const_iterator HatTriePhraseTable::begin(void) const
 {
+    HatTriePhraseTable::const_iterator iter(this, 0, phraseTableShards[0].begin());
+
     // Shift the iterator to the first target phrase
-    PhraseTable::const_iterator iterTrgBegin = phraseTable.begin();
-    while (!isTargetPhrase(keyToVector(iterTrgBegin.key())))
+    if (iter.trgIter == phraseTableShards[0].end() && phraseTableShards.size() > 1)
+        iter.advance();
+    while (!iter.isEnd() && !isTargetPhrase(keyToVector(iter.trgIter.key())))
     {
-        iterTrgBegin++;
+        iter.advance();
     }
 
-    HatTriePhraseTable::const_iterator iter(this, iterTrgBegin);
-
     return iter;
 }
 //-------------------------
 HatTriePhraseTable::const_iterator HatTriePhraseTable::end(void) const
 {
-    HatTriePhraseTable::const_iterator iter(this, phraseTable.end());
+    HatTriePhraseTable::const_iterator iter(this, phraseTableShards.size() - 1, phraseTableShards.back().end());
 
     return iter;
 }
 
 // const_iterator function definitions
 //--------------------------
+bool HatTriePhraseTable::const_iterator::isEnd(void)const
+{
+    return shardIdx + 1 == ptPtr->phraseTableShards.size() && trgIter == ptPtr->phraseTableShards[shardIdx].end();
+}
+//--------------------------
+void HatTriePhraseTable::const_iterator::advance(void)
+{
+    if (trgIter != ptPtr->phraseTableShards[shardIdx].end())
+        trgIter++;
+
+    while (trgIter == ptPtr->phraseTableShards[shardIdx].end() && shardIdx + 1 < ptPtr->phraseTableShards.size())
+    {
+        shardIdx++;
+        trgIter = ptPtr->phraseTableShards[shardIdx].begin();
+    }
+}
+//--------------------------
 bool HatTriePhraseTable::const_iterator::operator++(void) //prefix
 {
-    if (ptPtr != NULL && trgIter != ptPtr->phraseTable.end())
+    if (ptPtr != NULL && !isEnd())
     {
         // Shift iterator to the next target phrase
         do
         {
-            trgIter++;
-            if (trgIter == ptPtr->phraseTable.end())
+            advance();
+            if (isEnd())
                 return false;
         } while(!ptPtr->isTargetPhrase(ptPtr->keyToVector(trgIter.key())) || trgIter.value().get_c_s() == 0);
 
@@ -606,6 +929,7 @@ int HatTriePhraseTable::const_iterator::operator==(const const_iterator& right)
 {
     return (
         ptPtr == right.ptPtr &&
+        shardIdx == right.shardIdx &&
         trgIter == right.trgIter
     );
 }
@@ -628,7 +952,7 @@ HatTriePhraseTable::const_iterator::operator->(void)
     std::vector<WordIndex> t;
     Count c = 0;
 
-    if (ptPtr != NULL && trgIter != ptPtr->phraseTable.end())
+    if (ptPtr != NULL && !isEnd())
     {
         t = ptPtr->keyToVector(trgIter.key());
         c = trgIter.value();
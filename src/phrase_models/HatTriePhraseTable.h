@@ -41,10 +41,15 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif /* HAVE_CONFIG_H */
 
 #include "BasePhraseTable.h"
+#include "ThreadPool.h"
 #include "hat_trie/htrie_map.h"
+#include <stdio.h>
 
 //--------------- Constants ------------------------------------------
 
+#define HAT_TRIE_PT_MAGIC           "THOTHTPT"
+#define HAT_TRIE_PT_FORMAT_VERSION  1
+
 
 //--------------- typedefs -------------------------------------------
 
@@ -57,6 +62,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- HatTriePhraseTable class
 
+/**
+ * @brief Phrase table storing source, target and phrase pair counts in
+ * HAT-tries. The keys are partitioned into shards according to their
+ * first word, so that the shards can be built and loaded in parallel.
+ * Tables created one entry at a time use a single shard.
+ */
+
 class HatTriePhraseTable: public BasePhraseTable
 {
     public:
@@ -74,6 +86,14 @@ class HatTriePhraseTable: public BasePhraseTable
             // Returned result types by iterator
         typedef std::pair<std::vector<WordIndex>, Count> PhraseInfoElement;
 
+            // Entry given to the parallel builder
+        struct TableEntry
+        {
+            std::vector<WordIndex> s;
+            std::vector<WordIndex> t;
+            PhrasePairInfo inf;
+        };
+
             // Constructor
         HatTriePhraseTable(void);
 
@@ -131,6 +151,32 @@ class HatTriePhraseTable: public BasePhraseTable
             // print function
         virtual void print(void);
 
+            // Parallel construction functions
+        void initShards(unsigned int numShards);
+            // Clears the table and partitions it into numShards shards
+        void addEntries(const std::vector<TableEntry>& entries,
+                        ThreadPool& threadPool);
+            // Adds the given entries with the same result as calling
+            // addTableEntry() for each of them. The entries are
+            // distributed among the shards and the shards are updated
+            // in parallel by the tasks of threadPool
+        void buildFromEntries(const std::vector<TableEntry>& entries,
+                              unsigned int numThreads);
+            // Clears the table and adds the given entries using
+            // numThreads shards, which are frozen afterwards
+        void freeze(void);
+            // Shrinks the nodes of the shards once the table has been
+            // built. The table can still be modified afterwards
+
+            // Functions to write and read the shards in binary format
+        bool write(FILE* file)const;
+        bool read(FILE* file,
+                  unsigned int numThreads);
+            // Reads a table written by write(), the shards are inserted
+            // using numThreads threads. Returns THOT_ERROR if the file
+            // has an unknown format, is truncated or is corrupted
+        unsigned int getNumShards(void)const;
+
             // size and clear functions
         virtual size_t size(void);
         virtual void clear(void);
@@ -152,15 +198,24 @@ class HatTriePhraseTable: public BasePhraseTable
         {
             protected:
                 const HatTriePhraseTable* ptPtr;
+                size_t shardIdx;
                 PhraseTable::const_iterator trgIter;
 
                 HatTriePhraseTable::PhraseInfoElement dataItem;
 
+                bool isEnd(void)const;
+                void advance(void);
+                    // Moves to the next key, skipping the end of the
+                    // shards except the last one
+
+                friend class HatTriePhraseTable;
+
             public:
-                const_iterator(void) { ptPtr = NULL; }
+                const_iterator(void) { ptPtr = NULL; shardIdx = 0; }
                 const_iterator(const HatTriePhraseTable* _ptPtr,
+                               size_t _shardIdx,
                                PhraseTable::const_iterator _trgIter
-                            ) : ptPtr(_ptPtr), trgIter(_trgIter) {}
+                            ) : ptPtr(_ptPtr), shardIdx(_shardIdx), trgIter(_trgIter) {}
                 bool operator++(void);  //prefix
                 bool operator++(int);  //postfix
                 int operator==(const const_iterator& right);
@@ -174,7 +229,35 @@ class HatTriePhraseTable: public BasePhraseTable
         HatTriePhraseTable::const_iterator end(void) const;
 
     protected:
-        PhraseTable phraseTable;
+        std::vector<PhraseTable> phraseTableShards;
+
+            // Shard selection, keys are assigned to shards by their
+            // first word (or the second one if the first word is
+            // UNUSED_WORD, as in source phrase keys)
+        size_t getShardIdx(const std::vector<WordIndex>& keyVec)const;
+        PhraseTable& getShard(const std::vector<WordIndex>& keyVec);
+        const PhraseTable& getShard(const std::vector<WordIndex>& keyVec)const;
+
+            // Builder and reader tasks
+        struct BuildTaskData
+        {
+            HatTriePhraseTable* ptPtr;
+            const std::vector<TableEntry>* entriesPtr;
+            const std::vector<std::vector<size_t> >* srcBucketsPtr;
+            const std::vector<std::vector<size_t> >* trgBucketsPtr;
+        };
+        static void buildShardTask(void* taskData,
+                                   unsigned int taskIdx,
+                                   unsigned int workerIdx);
+        struct ReadTaskData
+        {
+            HatTriePhraseTable* ptPtr;
+            const std::vector<std::vector<char> >* blobsPtr;
+            std::vector<char>* errorFlagsPtr;
+        };
+        static void readShardTask(void* taskData,
+                                  unsigned int taskIdx,
+                                  unsigned int workerIdx);
 
             // Check type of phrase in vector
         bool isTargetPhrase(const std::vector<WordIndex>& vec) const;
@@ -29,6 +29,115 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "IncrPhraseModel.h"
 
+#ifdef THOT_HAVE_CXX11
+#include "ThreadPool.h"
+#include <algorithm>
+#include <fstream>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace
+{
+//-------------------------
+bool getRemainingFileSize(FILE* file,
+                          unsigned long long& remainingSize)
+{
+  long pos=ftell(file);
+  if(pos<0 || fseek(file,0,SEEK_END)!=0)
+    return THOT_ERROR;
+  long end=ftell(file);
+  if(end<pos || fseek(file,pos,SEEK_SET)!=0)
+    return THOT_ERROR;
+  remainingSize=end-pos;
+  return THOT_OK;
+}
+
+//-------------------------
+bool writeVocab(FILE* file,
+                const std::vector<std::pair<std::string,WordIndex> >& entries)
+{
+      // Entries are sorted by index
+  unsigned long long numEntries=entries.size();
+  if(fwrite(&numEntries,sizeof(numEntries),1,file)!=1)
+    return THOT_ERROR;
+  for(size_t i=0;i<entries.size();++i)
+  {
+    unsigned int len=entries[i].first.size();
+    if(fwrite(&entries[i].second,sizeof(WordIndex),1,file)!=1 ||
+       fwrite(&len,sizeof(len),1,file)!=1 ||
+       fwrite(entries[i].first.data(),1,len,file)!=len)
+      return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+bool readVocab(FILE* file,
+               std::vector<std::pair<WordIndex,std::string> >& entries)
+{
+  unsigned long long numEntries;
+  unsigned long long remainingSize;
+  entries.clear();
+  if(fread(&numEntries,sizeof(numEntries),1,file)!=1 ||
+     getRemainingFileSize(file,remainingSize)==THOT_ERROR)
+    return THOT_ERROR;
+      // Sizes are checked against the file size before allocating
+      // memory for them
+  unsigned long long minEntrySize=sizeof(WordIndex)+sizeof(unsigned int);
+  if(numEntries>remainingSize/minEntrySize)
+    return THOT_ERROR;
+  for(unsigned long long i=0;i<numEntries;++i)
+  {
+    WordIndex idx;
+    unsigned int len;
+    if(fread(&idx,sizeof(idx),1,file)!=1 || fread(&len,sizeof(len),1,file)!=1)
+      return THOT_ERROR;
+    remainingSize-=minEntrySize;
+    if(len>remainingSize)
+      return THOT_ERROR;
+    remainingSize-=len;
+    std::string word(len,' ');
+    if(len>0 && fread(&word[0],1,len,file)!=len)
+      return THOT_ERROR;
+    entries.push_back(std::make_pair(idx,word));
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+bool binFileIsUpToDate(const char* textFileName,
+                       const char* binFileName)
+{
+  struct stat textStat;
+  struct stat binStat;
+  if(stat(textFileName,&textStat)!=0 || stat(binFileName,&binStat)!=0)
+    return false;
+  return binStat.st_mtime>=textStat.st_mtime;
+}
+
+//-------------------------
+void splitFields(const std::string& line,
+                 std::vector<std::string>& fields)
+{
+      // Fields are separated by blanks as in awkInputStream
+  fields.clear();
+  size_t i=0;
+  while(i<line.size())
+  {
+    while(i<line.size() && (line[i]==' ' || line[i]=='\t' || line[i]=='\r'))
+      ++i;
+    size_t begin=i;
+    while(i<line.size() && line[i]!=' ' && line[i]!='\t' && line[i]!='\r')
+      ++i;
+    if(i>begin)
+      fields.push_back(line.substr(begin,i-begin));
+  }
+}
+
+}
+#endif
+
 
 //--------------- Function definitions
 
@@ -64,6 +173,299 @@ void IncrPhraseModel::printTTable(FILE* file)
   }
 }
 
+//-------------------------
+bool IncrPhraseModel::loadPlainTextTTable(const char *phraseTTableFileName)
+{
+  HatTriePhraseTable* ptPtr=dynamic_cast<HatTriePhraseTable*>(basePhraseTablePtr);
+  if(ptPtr==NULL)
+    return _incrPhraseModel::loadPlainTextTTable(phraseTTableFileName);
+
+      // Read binary table if it is up to date
+  std::string binFileName=phraseTTableFileName;
+  binFileName+=INCR_PM_HAT_TRIE_FILE_EXT;
+  if(binFileIsUpToDate(phraseTTableFileName,binFileName.c_str()))
+  {
+    if(loadHatTrieTTable(binFileName.c_str())==THOT_OK)
+      return THOT_OK;
+    std::cerr<<"Warning: binary phrase table "<<binFileName<<" could not be used, ignoring it"<<std::endl;
+  }
+
+  return parsePlainTextTTable(phraseTTableFileName);
+}
+
+//-------------------------
+bool IncrPhraseModel::parsePlainTextTTable(const char *phraseTTableFileName)
+{
+  HatTriePhraseTable* ptPtr=dynamic_cast<HatTriePhraseTable*>(basePhraseTablePtr);
+  if(ptPtr==NULL)
+    return THOT_ERROR;
+
+  std::cerr<<"Loading phrase ttable from file "<<phraseTTableFileName<<std::endl;
+
+  std::ifstream ifile(phraseTTableFileName);
+  if(!ifile)
+  {
+    std::cerr<<"Error in phrase model file: "<<phraseTTableFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  unsigned int numThreads=getNumLoadThreads();
+  ThreadPool threadPool;
+  threadPool.init(numThreads);
+  ptPtr->initShards(numThreads);
+
+      // Process the file in blocks of lines. The lines of each block
+      // are parsed in parallel and then converted in order, so that
+      // word indices are assigned as in the sequential loader. The
+      // entries of the block are added to the shards in parallel
+  std::vector<HatTriePhraseTable::TableEntry> entries;
+  std::vector<std::string> lines;
+  std::vector<ParsedLine> parsedLines;
+  unsigned int numEntry=1;
+  std::string line;
+  bool endOfFile=false;
+  while(!endOfFile)
+  {
+    lines.clear();
+    while(lines.size()<INCR_PM_LOAD_BLOCK_SIZE)
+    {
+      if(!std::getline(ifile,line))
+      {
+        endOfFile=true;
+        break;
+      }
+      lines.push_back(line);
+    }
+
+    parsedLines.clear();
+    parsedLines.resize(lines.size());
+    ParseTaskData taskData;
+    taskData.linesPtr=&lines;
+    taskData.parsedLinesPtr=&parsedLines;
+    threadPool.run(parseLinesTask,(void*)&taskData,(lines.size()+INCR_PM_PARSE_TASK_SIZE-1)/INCR_PM_PARSE_TASK_SIZE);
+
+    entries.clear();
+    for(size_t i=0;i<parsedLines.size();++i)
+    {
+      if(parsedLines[i].isEntry)
+      {
+        HatTriePhraseTable::TableEntry entry;
+        entry.s=strVectorToSrcIndexVector(parsedLines[i].s);
+        entry.t=strVectorToTrgIndexVector(parsedLines[i].t);
+        entry.inf=parsedLines[i].inf;
+        entries.push_back(entry);
+      }
+      else if(parsedLines[i].isAnomalous)
+      {
+        std::cerr<<"Warning: discarding anomalous phrase table entry at line "<<numEntry<<std::endl;
+      }
+      ++numEntry;
+    }
+    ptPtr->addEntries(entries,threadPool);
+  }
+  threadPool.release();
+
+  ptPtr->freeze();
+
+  return THOT_OK;
+}
+
+//-------------------------
+void IncrPhraseModel::parseLinesTask(void* taskData,
+                                     unsigned int taskIdx,
+                                     unsigned int /*workerIdx*/)
+{
+  ParseTaskData* parseTaskDataPtr=(ParseTaskData*) taskData;
+  const std::vector<std::string>& lines=*parseTaskDataPtr->linesPtr;
+  std::vector<ParsedLine>& parsedLines=*parseTaskDataPtr->parsedLinesPtr;
+  std::vector<std::string> fields;
+
+  size_t end=std::min(lines.size(),(size_t)(taskIdx+1)*INCR_PM_PARSE_TASK_SIZE);
+  for(size_t l=(size_t)taskIdx*INCR_PM_PARSE_TASK_SIZE;l<end;++l)
+  {
+    ParsedLine& parsedLine=parsedLines[l];
+    parsedLine.isEntry=false;
+    parsedLine.isAnomalous=false;
+
+    splitFields(lines[l],fields);
+    if(fields.size()<=1)
+      continue;
+
+        // Read source phrase
+    size_t i=0;
+    while(i<fields.size() && fields[i]!="|||")
+    {
+      parsedLine.s.push_back(fields[i]);
+      ++i;
+    }
+        // Read target phrase
+    ++i;
+    while(i<fields.size() && fields[i]!="|||")
+    {
+      parsedLine.t.push_back(fields[i]);
+      ++i;
+    }
+        // Verify entry
+    if(i+2<fields.size() && !parsedLine.s.empty() && !parsedLine.t.empty())
+    {
+          // Read count information
+      parsedLine.inf.first=atof(fields[i+1].c_str());
+      parsedLine.inf.second=atof(fields[i+2].c_str());
+      parsedLine.isEntry=true;
+    }
+    else
+    {
+      parsedLine.isAnomalous=true;
+    }
+  }
+}
+
+//-------------------------
+bool IncrPhraseModel::buildHatTrieTTable(const char *phraseTTableFileName)
+{
+      // The text table is always parsed, the binary file is
+      // replaced if it already exists
+  basePhraseTablePtr->clear();
+  if(parsePlainTextTTable(phraseTTableFileName)==THOT_ERROR)
+    return THOT_ERROR;
+
+  std::string binFileName=phraseTTableFileName;
+  binFileName+=INCR_PM_HAT_TRIE_FILE_EXT;
+  return printHatTrieTTable(binFileName.c_str());
+}
+
+//-------------------------
+bool IncrPhraseModel::loadHatTrieTTable(const char *binFileName)
+{
+  HatTriePhraseTable* ptPtr=dynamic_cast<HatTriePhraseTable*>(basePhraseTablePtr);
+  FILE* file=fopen(binFileName,"rb");
+  if(ptPtr==NULL || file==NULL)
+    return THOT_ERROR;
+
+  std::cerr<<"Loading phrase ttable from binary file "<<binFileName<<std::endl;
+
+      // Check that the vocabularies stored in the file are compatible
+      // with the current ones. Unknown words must receive the same
+      // index they had when the file was printed
+  std::vector<std::pair<WordIndex,std::string> > srcEntries;
+  std::vector<std::pair<WordIndex,std::string> > trgEntries;
+  if(readVocab(file,srcEntries)==THOT_ERROR || readVocab(file,trgEntries)==THOT_ERROR)
+  {
+    fclose(file);
+    return THOT_ERROR;
+  }
+  WordIndex nextIdx=getSrcVocabSize();
+  for(size_t i=0;i<srcEntries.size();++i)
+  {
+    if(existSrcSymbol(srcEntries[i].second))
+    {
+      if(stringToSrcWordIndex(srcEntries[i].second)!=srcEntries[i].first)
+      {
+        fclose(file);
+        return THOT_ERROR;
+      }
+    }
+    else if(srcEntries[i].first!=nextIdx++)
+    {
+      fclose(file);
+      return THOT_ERROR;
+    }
+  }
+  nextIdx=getTrgVocabSize();
+  for(size_t i=0;i<trgEntries.size();++i)
+  {
+    if(existTrgSymbol(trgEntries[i].second))
+    {
+      if(stringToTrgWordIndex(trgEntries[i].second)!=trgEntries[i].first)
+      {
+        fclose(file);
+        return THOT_ERROR;
+      }
+    }
+    else if(trgEntries[i].first!=nextIdx++)
+    {
+      fclose(file);
+      return THOT_ERROR;
+    }
+  }
+
+      // Read table
+  bool ret=ptPtr->read(file,getNumLoadThreads());
+  fclose(file);
+  if(ret==THOT_ERROR)
+  {
+    basePhraseTablePtr->clear();
+    return THOT_ERROR;
+  }
+
+      // Add words
+  for(size_t i=0;i<srcEntries.size();++i)
+    addSrcSymbol(srcEntries[i].second);
+  for(size_t i=0;i<trgEntries.size();++i)
+    addTrgSymbol(trgEntries[i].second);
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool IncrPhraseModel::printHatTrieTTable(const char *binFileName)
+{
+  HatTriePhraseTable* ptPtr=dynamic_cast<HatTriePhraseTable*>(basePhraseTablePtr);
+  if(ptPtr==NULL)
+    return THOT_ERROR;
+
+      // Write to a unique temporary file that is renamed once complete
+  std::string tmpFileName=binFileName;
+  tmpFileName+=".XXXXXX";
+  int fd=mkstemp(&tmpFileName[0]);
+  if(fd!=-1)
+  {
+        // mkstemp() creates the file only readable by the owner, give
+        // it the permissions of regular files
+    mode_t mask=umask(0);
+    umask(mask);
+    fchmod(fd,0666&~mask);
+  }
+  FILE* file=(fd==-1) ? NULL : fdopen(fd,"wb");
+  if(file==NULL)
+  {
+    std::cerr<<"Error: binary phrase table "<<binFileName<<" could not be printed"<<std::endl;
+    if(fd!=-1)
+    {
+      close(fd);
+      remove(tmpFileName.c_str());
+    }
+    return THOT_ERROR;
+  }
+  std::vector<std::pair<std::string,WordIndex> > srcEntries;
+  std::vector<std::pair<std::string,WordIndex> > trgEntries;
+  singleWordVocab.getSrcVocabEntries(srcEntries);
+  singleWordVocab.getTrgVocabEntries(trgEntries);
+  bool ok=(writeVocab(file,srcEntries)==THOT_OK &&
+           writeVocab(file,trgEntries)==THOT_OK &&
+           ptPtr->write(file)==THOT_OK);
+  if(fclose(file)!=0) ok=false;
+  if(!ok || rename(tmpFileName.c_str(),binFileName)!=0)
+  {
+    std::cerr<<"Error: binary phrase table "<<binFileName<<" could not be printed"<<std::endl;
+    remove(tmpFileName.c_str());
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+unsigned int IncrPhraseModel::getNumLoadThreads(void)const
+{
+  long numProcs=sysconf(_SC_NPROCESSORS_ONLN);
+  if(numProcs<1)
+    return 1;
+  else if(numProcs>INCR_PM_MAX_LOAD_THREADS)
+    return INCR_PM_MAX_LOAD_THREADS;
+  else
+    return numProcs;
+}
+
 #else
 //-------------------------
 void IncrPhraseModel::printTTable(FILE* file)
@@ -47,6 +47,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Constants ------------------------------------------
 
+#define INCR_PM_HAT_TRIE_FILE_EXT    ".htrie"
+#define INCR_PM_MAX_LOAD_THREADS     8
+#define INCR_PM_LOAD_BLOCK_SIZE      100000
+#define INCR_PM_PARSE_TASK_SIZE      1000
 	 
 //--------------- function declarations ------------------------------
 
@@ -75,6 +79,16 @@ class IncrPhraseModel: public _incrPhraseModel
 
       }
 
+#ifdef THOT_HAVE_CXX11
+        // Binary phrase table building
+    bool buildHatTrieTTable(const char *phraseTTableFileName);
+        // Parses the plain text table phraseTTableFileName and stores
+        // it in binary format in phraseTTableFileName.htrie, which is
+        // used by the loading functions while it is up to date. The
+        // words are added to the current vocabularies, so they should
+        // be loaded first as done when the model is used
+#endif
+
         // Destructor
 	~IncrPhraseModel();
 	
@@ -82,6 +96,37 @@ class IncrPhraseModel: public _incrPhraseModel
 
         // Functions to print models using standard C library
     void printTTable(FILE* file);
+
+#ifdef THOT_HAVE_CXX11
+        // Functions to load the HAT-trie phrase table
+    bool loadPlainTextTTable(const char *phraseTTableFileName);
+        // Reads the binary file phraseTTableFileName.htrie instead of
+        // the text file if it is up to date. No files are written
+    bool parsePlainTextTTable(const char *phraseTTableFileName);
+        // The lines of the table are parsed and the HAT-trie is built
+        // in parallel
+    bool loadHatTrieTTable(const char *binFileName);
+    bool printHatTrieTTable(const char *binFileName);
+    unsigned int getNumLoadThreads(void)const;
+
+        // Phrase table line parsing
+    struct ParsedLine
+    {
+      std::vector<std::string> s;
+      std::vector<std::string> t;
+      PhrasePairInfo inf;
+      bool isEntry;
+      bool isAnomalous;
+    };
+    struct ParseTaskData
+    {
+      const std::vector<std::string>* linesPtr;
+      std::vector<ParsedLine>* parsedLinesPtr;
+    };
+    static void parseLinesTask(void* taskData,
+                               unsigned int taskIdx,
+                               unsigned int workerIdx);
+#endif
 };
 
 #endif
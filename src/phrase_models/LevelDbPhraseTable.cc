@@ -39,6 +39,7 @@ LevelDbPhraseTable::LevelDbPhraseTable(void)
     options.block_cache = leveldb::NewLRUCache(100 * 1048576);  // 100 MB for cache
     db = NULL;
     dbName = "";
+    bulkLoading = false;
 }
 
 //-------------------------
@@ -186,6 +187,117 @@ bool LevelDbPhraseTable::load(std::string levelDbPath)
     }
 }
 
+//-------------------------
+bool LevelDbPhraseTable::startBulkLoad(size_t maxMemBytes)
+{
+    if(db == NULL)
+    {
+        std::cerr << "Database must be initialized before bulk loading" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // A larger write buffer reduces the number of level-0 files. Since
+    // the keys are written in order, the files generated when flushing
+    // the buffer do not overlap and can be moved to the next level
+    // without merging them
+    options.write_buffer_size = LEVELDB_PHRASE_TABLE_BULK_WRITE_BUFFER_SIZE;
+    clear();
+
+    bulkSorter.init(dbName + ".bulk_tmp_", maxMemBytes, ExternalCountSorter::SUM_COUNTS);
+    bulkLoading = true;
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool LevelDbPhraseTable::bulkIncrCountsOfEntry(const std::vector<WordIndex>& s,
+                                               const std::vector<WordIndex>& t,
+                                               Count c)
+{
+    if(!bulkLoading)
+    {
+        std::cerr << "Bulk loading has not been started" << std::endl;
+        return THOT_ERROR;
+    }
+
+    if(bulkSorter.add(vectorToString(getSrc(s)), (float) c) == THOT_ERROR)  // (USUSED_WORD, s)
+        return THOT_ERROR;
+    if(bulkSorter.add(vectorToString(t), (float) c) == THOT_ERROR)  // (t)
+        return THOT_ERROR;
+
+    return bulkSorter.add(vectorToString(getTrgSrc(s, t)), (float) c);  // (t, UNUSED_WORD, s)
+}
+
+//-------------------------
+bool LevelDbPhraseTable::writeBulkBatch(leveldb::WriteBatch& batch,
+                                        size_t& batchSize,
+                                        bool force)
+{
+    if(batchSize == 0 || (!force && batchSize < LEVELDB_PHRASE_TABLE_BULK_BATCH_SIZE))
+        return THOT_OK;
+
+    leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
+    batch.Clear();
+    batchSize = 0;
+
+    if(!s.ok())
+    {
+        std::cerr << "Storing data status: " << s.ToString() << std::endl;
+        return THOT_ERROR;
+    }
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool LevelDbPhraseTable::finishBulkLoad(void)
+{
+    if(!bulkLoading)
+    {
+        std::cerr << "Bulk loading has not been started" << std::endl;
+        return THOT_ERROR;
+    }
+    bulkLoading = false;
+
+    if(bulkSorter.sort() == THOT_ERROR)
+    {
+        bulkSorter.clear();
+        return THOT_ERROR;
+    }
+
+    // Write the entries in key order
+    leveldb::WriteBatch batch;
+    size_t batchSize = 0;
+    size_t numEntries = 0;
+    bool ret = THOT_OK;
+    std::string key;
+    double count;
+    while(ret == THOT_OK && bulkSorter.next(key, count))
+    {
+        std::stringstream ss;
+        ss << (int) count;
+        std::string count_str = ss.str();
+
+        batch.Put(key, count_str);
+        batchSize += key.size() + count_str.size();
+        ret = writeBulkBatch(batch, batchSize, false);
+
+        numEntries++;
+        if(numEntries % 1000000 == 0)
+            std::cerr << "Written " << numEntries << " entries" << std::endl;
+    }
+    bulkSorter.clear();
+
+    if(ret == THOT_OK)
+        ret = writeBulkBatch(batch, batchSize, true);
+
+    // Compact the database once all the data has been written
+    if(ret == THOT_OK)
+        db->CompactRange(NULL, NULL);
+
+    return ret;
+}
+
 //-------------------------
 std::vector<WordIndex> LevelDbPhraseTable::getSrc(const std::vector<WordIndex>& s)
 {
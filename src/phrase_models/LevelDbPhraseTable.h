@@ -46,11 +46,16 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "leveldb/write_batch.h"
 
 #include "BasePhraseTable.h"
+#include "ExternalCountSorter.h"
 #include "ErrorDefs.h"
 
 
 //--------------- Constants ------------------------------------------
 
+// Parameters of the bulk loading
+#define LEVELDB_PHRASE_TABLE_BULK_WRITE_BUFFER_SIZE (64 * 1048576)
+#define LEVELDB_PHRASE_TABLE_BULK_BATCH_SIZE (4 * 1048576)
+
 
 //--------------- typedefs -------------------------------------------
 
@@ -77,6 +82,15 @@ class LevelDbPhraseTable: public BasePhraseTable
     virtual bool retrieveData(const std::vector<WordIndex>& phrase, int &count)const;
     virtual bool storeData(const std::vector<WordIndex>& phrase, int count)const;
 
+        // Data of the bulk loading
+    ExternalCountSorter bulkSorter;
+    bool bulkLoading;
+    bool writeBulkBatch(leveldb::WriteBatch& batch,
+                        size_t& batchSize,
+                        bool force);
+        // Writes the batch if its size exceeds the bulk batch size or
+        // force is true
+
   
   public:
 
@@ -96,6 +110,16 @@ class LevelDbPhraseTable: public BasePhraseTable
     virtual bool drop();
         // Wrapper for loading existing levelDB
     virtual bool load(std::string levelDbPath);
+        // Bulk loading. The counts added between startBulkLoad() and
+        // finishBulkLoad() replace the contents of the table. They are
+        // sorted and added up externally using at most maxMemBytes bytes
+        // of memory and written in key order in large batches
+    virtual bool startBulkLoad(size_t maxMemBytes = EXT_SORTER_DEFAULT_MAX_MEM_BYTES);
+    virtual bool bulkIncrCountsOfEntry(const std::vector<WordIndex>& s,
+                                       const std::vector<WordIndex>& t,
+                                       Count c);
+        // Equivalent to incrCountsOfEntry()
+    virtual bool finishBulkLoad(void);
         // Returns s as (UNUSED_WORD, s)
     virtual std::vector<WordIndex> getSrc(const std::vector<WordIndex>& s);
         // Returns concatenated s and t as (UNUSED_WORD, s, UNUSED_WORD, t)
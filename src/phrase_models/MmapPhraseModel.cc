@@ -0,0 +1,133 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: MmapPhraseModel                                          */
+/*                                                                  */
+/* Definitions file: MmapPhraseModel.cc                             */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "MmapPhraseModel.h"
+#include <sys/stat.h>
+
+
+//--------------- Function definitions
+
+//-------------------------
+bool MmapPhraseModel::load_ttable(const char *phraseTTableFileName)
+{
+  std::string ttableFileName=phraseTTableFileName;
+  std::string binFileName=ttableFileName+MMAP_PT_FILE_EXT;
+
+      // The binary file is not compiled here, several processes may
+      // be loading the same table
+  struct stat binStat;
+  if(stat(binFileName.c_str(),&binStat)!=0)
+  {
+    std::cerr<<"Error, binary phrase table "<<binFileName<<" does not exist, it can be obtained by means of: thot_ttable_to_mmap -i "<<ttableFileName<<" -o "<<binFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  struct stat ttableStat;
+  if(stat(ttableFileName.c_str(),&ttableStat)==0 && binStat.st_mtime<ttableStat.st_mtime)
+  {
+    std::cerr<<"Error, binary phrase table "<<binFileName<<" is older than "<<ttableFileName<<", it can be updated by means of: thot_ttable_to_mmap -i "<<ttableFileName<<" -o "<<binFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Map binary file
+  if(mmapPhraseTablePtr->load(binFileName.c_str())==THOT_ERROR)
+    return THOT_ERROR;
+
+  loadVocabFromTable();
+  return THOT_OK;
+}
+
+//-------------------------
+void MmapPhraseModel::loadVocabFromTable(void)
+{
+      // The words of the table are added to the vocabulary of the
+      // model, which may have been loaded before
+  for(size_t pos=0;pos<mmapPhraseTablePtr->getSrcVocabSize();++pos)
+  {
+    WordIndex w=singleWordVocab.addSrcSymbol(mmapPhraseTablePtr->getSrcWord(pos));
+    mmapPhraseTablePtr->setSrcWordIndex(pos,w);
+  }
+  for(size_t pos=0;pos<mmapPhraseTablePtr->getTrgVocabSize();++pos)
+  {
+    WordIndex w=singleWordVocab.addTrgSymbol(mmapPhraseTablePtr->getTrgWord(pos));
+    mmapPhraseTablePtr->setTrgWordIndex(pos,w);
+  }
+}
+
+//-------------------------
+bool MmapPhraseModel::printTTable(const char *outputFileName)
+{
+  FILE *outf;
+
+  outf=fopen(outputFileName,"w");
+  if(outf==NULL)
+  {
+    std::cerr<<"Error while printing phrase model to file."<<std::endl;
+    return THOT_ERROR;
+  }
+  printTTable(outf);
+  fclose(outf);
+
+      // The binary table is compiled from the printed one
+  std::string binFileName=outputFileName;
+  binFileName+=MMAP_PT_FILE_EXT;
+  return MmapPhraseTable::build(outputFileName,binFileName.c_str());
+}
+
+//-------------------------
+void MmapPhraseModel::printTTable(FILE* file)
+{
+  std::vector<WordIndex> s;
+  for(size_t i=0;i<mmapPhraseTablePtr->getNumSrcPhrases();++i)
+  {
+    MmapPhraseTable::TrgTableNode trgtn;
+    MmapPhraseTable::TrgTableNode::iterator trgtnIter;
+    mmapPhraseTablePtr->getSrcPhrase(i,s);
+    mmapPhraseTablePtr->getEntriesForSource(s,trgtn);
+    float c_s=(float)mmapPhraseTablePtr->cSrc(s);
+
+    for(trgtnIter=trgtn.begin();trgtnIter!=trgtn.end();++trgtnIter)
+    {
+      std::vector<WordIndex>::const_iterator vectorWordIndexIter;
+      for(vectorWordIndexIter=s.begin();vectorWordIndexIter!=s.end();++vectorWordIndexIter)
+        fprintf(file,"%s ",wordIndexToSrcString(*vectorWordIndexIter).c_str());
+      fprintf(file,"|||");
+      for(vectorWordIndexIter=trgtnIter->first.begin();vectorWordIndexIter!=trgtnIter->first.end();++vectorWordIndexIter)
+        fprintf(file," %s",wordIndexToTrgString(*vectorWordIndexIter).c_str());
+      fprintf(file," ||| %.8f %.8f\n",c_s,(float)trgtnIter->second.second.get_c_st());
+    }
+  }
+}
+
+//-------------------------
+MmapPhraseModel::~MmapPhraseModel()
+{
+  delete basePhraseTablePtr;  
+}
+
+//-------------------------
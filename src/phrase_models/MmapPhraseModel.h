@@ -0,0 +1,97 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: MmapPhraseModel                                          */
+/*                                                                  */
+/* Prototype file: MmapPhraseModel.h                                */
+/*                                                                  */
+/* Description: Defines the MmapPhraseModel class.                  */
+/*              MmapPhraseModel implements a phrase model derived   */
+/*              from _incrPhraseModel class whose translation table */
+/*              is stored in a memory-mapped binary file.           */
+/*                                                                  */
+/********************************************************************/
+
+#ifndef _MmapPhraseModel_h
+#define _MmapPhraseModel_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "MmapPhraseTable.h"
+#include "_incrPhraseModel.h"
+
+//--------------- Constants ------------------------------------------
+
+#define MMAP_PT_FILE_EXT ".bin"
+	 
+//--------------- function declarations ------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+
+//--------------- MmapPhraseModel class
+
+class MmapPhraseModel: public _incrPhraseModel
+{
+ public:
+
+    typedef _incrPhraseModel::SrcTableNode SrcTableNode;
+    typedef _incrPhraseModel::TrgTableNode TrgTableNode;
+
+        // Constructor
+    MmapPhraseModel(void):_incrPhraseModel()
+      {
+        mmapPhraseTablePtr = new MmapPhraseTable;
+        basePhraseTablePtr = mmapPhraseTablePtr;
+      }
+
+        // Loading functions
+    bool load_ttable(const char *phraseTTableFileName);
+        // Maps the binary file phraseTTableFileName+MMAP_PT_FILE_EXT,
+        // which should have been compiled from the plain text table
+        // with thot_ttable_to_mmap. An error is returned if the
+        // binary file does not exist or it is older than the plain
+        // text table
+
+        // Printing functions
+    bool printTTable(const char *outputFileName);
+        // Prints the translation table in plain text format and
+        // compiles it into the corresponding binary file
+
+        // Destructor
+	~MmapPhraseModel();
+	
+ protected:
+
+    MmapPhraseTable* mmapPhraseTablePtr;
+
+        // Functions to print models using standard C library
+    void printTTable(FILE* file);
+
+        // Auxiliary functions
+    void loadVocabFromTable(void);
+};
+
+#endif
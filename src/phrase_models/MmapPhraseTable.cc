@@ -0,0 +1,1069 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: MmapPhraseTable                                          */
+/*                                                                  */
+/* Definitions file: MmapPhraseTable.cc                             */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "MmapPhraseTable.h"
+#include "SingleWordVocab.h"
+#include "awkInputStream.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <limits.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//--------------- Constants
+
+namespace
+{
+      // Position of the words that are not in the vocabulary of the
+      // file
+  const WordIndex MMAP_PT_NO_POSITION=UINT_MAX;
+
+      // Header of the binary files. It is followed by the following
+      // arrays, each one padded to a multiple of eight bytes:
+      //  - source vocabulary offsets and characters
+      //  - target vocabulary offsets and characters
+      //  - source phrase offsets, words, counts and entry offsets
+      //  - target phrase offsets, words, counts and entry offsets
+      //  - target phrase and count of each entry
+      //  - source phrase and entry of each element of the target
+      //    index
+  struct MmapPtFileHeader
+  {
+    char magic[8];
+    unsigned int version;
+    unsigned int reserved;
+    unsigned long long srcVocabSize;
+    unsigned long long srcVocabCharsSize;
+    unsigned long long trgVocabSize;
+    unsigned long long trgVocabCharsSize;
+    unsigned long long numSrcPhrases;
+    unsigned long long numSrcPhraseWords;
+    unsigned long long numTrgPhrases;
+    unsigned long long numTrgPhraseWords;
+    unsigned long long numEntries;
+  };
+
+      // Entry used while building binary files
+  struct MmapPtBuildEntry
+  {
+    unsigned int srcIdx;
+    unsigned int trgIdx;
+    float count;
+  };
+
+  struct MmapPtBuildEntryLess
+  {
+    bool operator()(const MmapPtBuildEntry& left,const MmapPtBuildEntry& right)const
+    {
+      if(left.srcIdx!=right.srcIdx)
+        return left.srcIdx<right.srcIdx;
+      else
+        return left.trgIdx<right.trgIdx;
+    }
+  };
+
+//-------------------------
+int comparePhrase(const WordIndex* words,
+                  unsigned long long len,
+                  const std::vector<WordIndex>& phrase)
+{
+      // Lexicographical comparison, consistent with the ordering of
+      // std::vector
+  for(unsigned long long i=0;i<len && i<phrase.size();++i)
+  {
+    if(words[i]<phrase[i]) return -1;
+    if(words[i]>phrase[i]) return 1;
+  }
+  if(len<phrase.size()) return -1;
+  if(len>phrase.size()) return 1;
+  return 0;
+}
+
+//-------------------------
+bool writeBlock(FILE* filePtr,
+                const void* data,
+                size_t elemSize,
+                size_t numElems)
+{
+  size_t size=elemSize*numElems;
+  if(size>0 && fwrite(data,elemSize,numElems,filePtr)!=numElems)
+    return false;
+
+      // Pad block
+  char padding[8];
+  memset(padding,0,sizeof(padding));
+  size_t paddingSize=((size+7)&~((size_t)7))-size;
+  if(paddingSize>0 && fwrite(padding,1,paddingSize,filePtr)!=paddingSize)
+    return false;
+
+  return true;
+}
+
+//-------------------------
+const void* mapBlock(const char*& ptr,
+                     const char* endPtr,
+                     size_t elemSize,
+                     unsigned long long numElems)
+{
+      // Check that the block fits in the rest of the file, the number
+      // of elements is read from the file and elemSize*numElems may
+      // overflow
+  if(ptr>endPtr)
+    return NULL;
+  unsigned long long availSize=endPtr-ptr;
+  if(numElems>availSize/elemSize)
+    return NULL;
+  unsigned long long size=elemSize*numElems;
+  unsigned long long paddedSize=(size+7)&~((unsigned long long)7);
+  if(paddedSize>availSize)
+    return NULL;
+  const void* blockPtr=ptr;
+  ptr+=paddedSize;
+  return blockPtr;
+}
+
+}
+
+//--------------- Function definitions
+
+//-------------------------
+MmapPhraseTable::MmapPhraseTable(void)
+{
+  mappedAddr=NULL;
+  mappedSize=0;
+  readOnlyWarningPrinted=false;
+  clear();
+}
+
+//-------------------------
+void MmapPhraseTable::addTableEntry(const std::vector<WordIndex>& /*s*/,
+                                    const std::vector<WordIndex>& /*t*/,
+                                    PhrasePairInfo /*inf*/)
+{
+  printReadOnlyWarning();
+}
+
+//-------------------------
+void MmapPhraseTable::addSrcInfo(const std::vector<WordIndex>& /*s*/,
+                                 Count /*s_inf*/)
+{
+  printReadOnlyWarning();
+}
+
+//-------------------------
+void MmapPhraseTable::addSrcTrgInfo(const std::vector<WordIndex>& /*s*/,
+                                    const std::vector<WordIndex>& /*t*/,
+                                    Count /*st_inf*/)
+{
+  printReadOnlyWarning();
+}
+
+//-------------------------
+void MmapPhraseTable::incrCountsOfEntry(const std::vector<WordIndex>& /*s*/,
+                                        const std::vector<WordIndex>& /*t*/,
+                                        Count /*c*/)
+{
+  printReadOnlyWarning();
+}
+
+//-------------------------
+PhrasePairInfo MmapPhraseTable::infSrcTrg(const std::vector<WordIndex>& s,
+                                          const std::vector<WordIndex>& t,
+                                          bool& found)
+{
+  PhrasePairInfo ppi;
+
+  ppi.first=getSrcInfo(s,found);
+  if(!found)
+  {
+    ppi.second=0;
+    return ppi;
+  }
+  else
+  {
+    ppi.second=getSrcTrgInfo(s,t,found);
+    return ppi;
+  }
+}
+
+//-------------------------
+Count MmapPhraseTable::getSrcInfo(const std::vector<WordIndex>& s,
+                                  bool &found)
+{
+  unsigned int srcIdx;
+  found=findSrcPhrase(s,srcIdx);
+  if(found)
+    return srcPhraseCounts[srcIdx];
+  else
+    return 0;
+}
+
+//-------------------------
+Count MmapPhraseTable::getTrgInfo(const std::vector<WordIndex>& t,
+                                  bool &found)
+{
+  unsigned int trgIdx;
+  found=findTrgPhrase(t,trgIdx);
+  if(found)
+    return trgPhraseCounts[trgIdx];
+  else
+    return 0;
+}
+
+//-------------------------
+Count MmapPhraseTable::getSrcTrgInfo(const std::vector<WordIndex>& s,
+                                     const std::vector<WordIndex>& t,
+                                     bool &found)
+{
+  unsigned int srcIdx;
+  unsigned int trgIdx;
+  unsigned long long entryIdx;
+  found=(findSrcPhrase(s,srcIdx) && findTrgPhrase(t,trgIdx) && findEntry(srcIdx,trgIdx,entryIdx));
+  if(found)
+    return entryCounts[entryIdx];
+  else
+    return 0;
+}
+
+//-------------------------
+Prob MmapPhraseTable::pTrgGivenSrc(const std::vector<WordIndex>& s,
+                                   const std::vector<WordIndex>& t)
+{
+  Count st_count=cSrcTrg(s,t);
+  if((float) st_count>0)
+  {
+    Count s_count=cSrc(s);
+    if((float) s_count>0)
+      return ((float) st_count)/((float) s_count);
+    else
+      return PHRASE_PROB_SMOOTH;
+  }
+  else return PHRASE_PROB_SMOOTH;
+}
+
+//-------------------------
+LgProb MmapPhraseTable::logpTrgGivenSrc(const std::vector<WordIndex>& s,
+                                        const std::vector<WordIndex>& t)
+{
+  return log((double) pTrgGivenSrc(s,t));
+}
+
+//-------------------------
+Prob MmapPhraseTable::pSrcGivenTrg(const std::vector<WordIndex>& s,
+                                   const std::vector<WordIndex>& t)
+{
+  Count st_count=cSrcTrg(s,t);
+  if((float) st_count>0)
+  {
+    Count t_count=cTrg(t);
+    if((float) t_count>0)
+      return ((float) st_count)/((float) t_count);
+    else
+      return PHRASE_PROB_SMOOTH;
+  }
+  else return PHRASE_PROB_SMOOTH;
+}
+
+//-------------------------
+LgProb MmapPhraseTable::logpSrcGivenTrg(const std::vector<WordIndex>& s,
+                                        const std::vector<WordIndex>& t)
+{
+  return log((double) pSrcGivenTrg(s,t));
+}
+
+//-------------------------
+bool MmapPhraseTable::getEntriesForTarget(const std::vector<WordIndex>& t,
+                                          SrcTableNode& srctn)
+{
+  srctn.clear();
+
+  unsigned int trgIdx;
+  if(!findTrgPhrase(t,trgIdx))
+    return false;
+
+      // Traverse the target index
+  std::vector<WordIndex> s;
+  for(unsigned long long i=trgEntryOffsets[trgIdx];i<trgEntryOffsets[trgIdx+1];++i)
+  {
+    unsigned int srcIdx=trgIndexSrcPhrases[i];
+    PhrasePairInfo ppi;
+    ppi.first=srcPhraseCounts[srcIdx];
+    ppi.second=entryCounts[trgIndexEntries[i]];
+
+        // Entries with zero counts are discarded as in the rest of
+        // phrase tables
+    if((int) ppi.first.get_c_s()==0 || (int) ppi.second.get_c_s()==0)
+      continue;
+
+    getSrcPhrase(srcIdx,s);
+    srctn.insert(std::make_pair(s,ppi));
+  }
+
+  return !srctn.empty();
+}
+
+//-------------------------
+bool MmapPhraseTable::getEntriesForSource(const std::vector<WordIndex>& s,
+                                          TrgTableNode& trgtn)
+{
+  trgtn.clear();
+
+  unsigned int srcIdx;
+  if(!findSrcPhrase(s,srcIdx))
+    return false;
+
+      // Traverse the entries of the source phrase
+  std::vector<WordIndex> t;
+  for(unsigned long long i=srcEntryOffsets[srcIdx];i<srcEntryOffsets[srcIdx+1];++i)
+  {
+    unsigned int trgIdx=entryTrgPhrases[i];
+    PhrasePairInfo ppi;
+    ppi.first=trgPhraseCounts[trgIdx];
+    ppi.second=entryCounts[i];
+
+        // Entries with zero counts are discarded as in the rest of
+        // phrase tables
+    if((int) ppi.first.get_c_s()==0 || (int) ppi.second.get_c_s()==0)
+      continue;
+
+    getTrgPhrase(trgIdx,t);
+    trgtn.insert(std::make_pair(t,ppi));
+  }
+
+  return !trgtn.empty();
+}
+
+//-------------------------
+bool MmapPhraseTable::getNbestForSrc(const std::vector<WordIndex>& s,
+                                     NbestTableNode<PhraseTransTableNodeData>& nbt)
+{
+  TrgTableNode node;
+  TrgTableNode::iterator iter;
+
+      // Make sure that collection does not contain any old elements
+  nbt.clear();
+
+  bool found=getEntriesForSource(s,node);
+  Count s_count=cSrc(s);
+
+  if(found)
+  {
+        // Generate transTableNode
+    for(iter=node.begin();iter!=node.end();++iter)
+    {
+      float c_st=(float) iter->second.second.get_c_st();
+      LgProb lgProb=log(c_st/(float) s_count);
+      nbt.insert(lgProb,iter->first);
+    }
+
+#   ifdef DO_STABLE_SORT_ON_NBEST_TABLE
+        // Performs stable sort on n-best table, this is done to ensure
+        // that the n-best lists generated by cache models and
+        // conventional models are identical. However this process is
+        // time consuming and must be avoided if possible
+    nbt.stableSort();
+#   endif
+    return true;
+  }
+  else
+  {
+        // Cannot find the source phrase
+    return false;
+  }
+}
+
+//-------------------------
+bool MmapPhraseTable::getNbestForTrg(const std::vector<WordIndex>& t,
+                                     NbestTableNode<PhraseTransTableNodeData>& nbt,
+                                     int N)
+{
+  SrcTableNode node;
+  SrcTableNode::iterator iter;
+
+      // Make sure that collection does not contain any old elements
+  nbt.clear();
+
+  bool found=getEntriesForTarget(t,node);
+  Count t_count=cTrg(t);
+
+  if(found)
+  {
+        // Generate transTableNode
+    for(iter=node.begin();iter!=node.end();++iter)
+    {
+      float c_st=(float) iter->second.second.get_c_st();
+      LgProb lgProb=log(c_st/(float) t_count);
+      nbt.insert(lgProb,iter->first);
+    }
+
+#   ifdef DO_STABLE_SORT_ON_NBEST_TABLE
+        // Performs stable sort on n-best table, this is done to ensure
+        // that the n-best lists generated by cache models and
+        // conventional models are identical. However this process is
+        // time consuming and must be avoided if possible
+    nbt.stableSort();
+#   endif
+
+    while(nbt.size()>(unsigned int) N && N>=0)
+    {
+          // node contains N inverse translations, remove last element
+      nbt.removeLastElement();
+    }
+
+    return true;
+  }
+  else
+  {
+        // Cannot find the target phrase
+    return false;
+  }
+}
+
+//-------------------------
+Count MmapPhraseTable::cSrcTrg(const std::vector<WordIndex>& s,
+                               const std::vector<WordIndex>& t)
+{
+  bool found;
+  return getSrcTrgInfo(s,t,found).get_c_st();
+}
+
+//-------------------------
+Count MmapPhraseTable::cSrc(const std::vector<WordIndex>& s)
+{
+  bool found;
+  return getSrcInfo(s,found).get_c_s();
+}
+
+//-------------------------
+Count MmapPhraseTable::cTrg(const std::vector<WordIndex>& t)
+{
+  bool found;
+  return getTrgInfo(t,found).get_c_st();
+}
+
+//-------------------------
+size_t MmapPhraseTable::getSrcVocabSize(void)const
+{
+  return srcVocabSize;
+}
+
+//-------------------------
+std::string MmapPhraseTable::getSrcWord(size_t pos)const
+{
+  if(pos<srcVocabSize)
+    return srcVocabChars+srcVocabOffsets[pos];
+  else
+    return UNK_WORD_STR;
+}
+
+//-------------------------
+void MmapPhraseTable::setSrcWordIndex(size_t pos,
+                                      WordIndex w)
+{
+  setWordIndex(srcIdxToPos,srcPosToIdx,srcVocabSize,pos,w);
+}
+
+//-------------------------
+size_t MmapPhraseTable::getTrgVocabSize(void)const
+{
+  return trgVocabSize;
+}
+
+//-------------------------
+std::string MmapPhraseTable::getTrgWord(size_t pos)const
+{
+  if(pos<trgVocabSize)
+    return trgVocabChars+trgVocabOffsets[pos];
+  else
+    return UNK_WORD_STR;
+}
+
+//-------------------------
+void MmapPhraseTable::setTrgWordIndex(size_t pos,
+                                      WordIndex w)
+{
+  setWordIndex(trgIdxToPos,trgPosToIdx,trgVocabSize,pos,w);
+}
+
+//-------------------------
+size_t MmapPhraseTable::getNumSrcPhrases(void)const
+{
+  return numSrcPhrases;
+}
+
+//-------------------------
+void MmapPhraseTable::getSrcPhrase(size_t idx,
+                                   std::vector<WordIndex>& s)const
+{
+  positionsToWords(srcPosToIdx,srcPhraseWords+srcPhraseOffsets[idx],srcPhraseWords+srcPhraseOffsets[idx+1],s);
+}
+
+//-------------------------
+void MmapPhraseTable::getTrgPhrase(size_t idx,
+                                   std::vector<WordIndex>& t)const
+{
+  positionsToWords(trgPosToIdx,trgPhraseWords+trgPhraseOffsets[idx],trgPhraseWords+trgPhraseOffsets[idx+1],t);
+}
+
+//-------------------------
+bool MmapPhraseTable::wordsToPositions(const std::vector<WordIndex>& idxToPos,
+                                       const std::vector<WordIndex>& phrase,
+                                       std::vector<WordIndex>& posPhrase)const
+{
+  if(idxToPos.empty())
+  {
+    posPhrase=phrase;
+    return true;
+  }
+
+  posPhrase.resize(phrase.size());
+  for(size_t i=0;i<phrase.size();++i)
+  {
+        // Words that are not in the vocabulary of the file cannot be
+        // part of any phrase
+    if(phrase[i]>=idxToPos.size() || idxToPos[phrase[i]]==MMAP_PT_NO_POSITION)
+      return false;
+    posPhrase[i]=idxToPos[phrase[i]];
+  }
+  return true;
+}
+
+//-------------------------
+void MmapPhraseTable::positionsToWords(const std::vector<WordIndex>& posToIdx,
+                                       const WordIndex* beginPtr,
+                                       const WordIndex* endPtr,
+                                       std::vector<WordIndex>& phrase)const
+{
+  if(posToIdx.empty())
+  {
+    phrase.assign(beginPtr,endPtr);
+  }
+  else
+  {
+    phrase.clear();
+    for(const WordIndex* ptr=beginPtr;ptr!=endPtr;++ptr)
+      phrase.push_back(posToIdx[*ptr]);
+  }
+}
+
+//-------------------------
+void MmapPhraseTable::setWordIndex(std::vector<WordIndex>& idxToPos,
+                                   std::vector<WordIndex>& posToIdx,
+                                   size_t vocabSize,
+                                   size_t pos,
+                                   WordIndex w)
+{
+  if(pos>=vocabSize)
+    return;
+
+      // Initialize maps to the identity
+  if(posToIdx.empty())
+  {
+    posToIdx.resize(vocabSize);
+    idxToPos.resize(vocabSize);
+    for(size_t i=0;i<vocabSize;++i)
+    {
+      posToIdx[i]=i;
+      idxToPos[i]=i;
+    }
+  }
+
+      // Update maps
+  if(idxToPos[posToIdx[pos]]==pos)
+    idxToPos[posToIdx[pos]]=MMAP_PT_NO_POSITION;
+  posToIdx[pos]=w;
+  if(w>=idxToPos.size())
+    idxToPos.resize(w+1,MMAP_PT_NO_POSITION);
+  idxToPos[w]=pos;
+}
+
+//-------------------------
+bool MmapPhraseTable::findSrcPhrase(const std::vector<WordIndex>& s,
+                                    unsigned int& srcIdx)const
+{
+  std::vector<WordIndex> posPhrase;
+  if(!wordsToPositions(srcIdxToPos,s,posPhrase))
+    return false;
+
+  unsigned long long left=0;
+  unsigned long long right=numSrcPhrases;
+  while(left<right)
+  {
+    unsigned long long mid=left+(right-left)/2;
+    int cmp=comparePhrase(srcPhraseWords+srcPhraseOffsets[mid],srcPhraseOffsets[mid+1]-srcPhraseOffsets[mid],posPhrase);
+    if(cmp==0)
+    {
+      srcIdx=mid;
+      return true;
+    }
+    if(cmp<0) left=mid+1;
+    else right=mid;
+  }
+  return false;
+}
+
+//-------------------------
+bool MmapPhraseTable::findTrgPhrase(const std::vector<WordIndex>& t,
+                                    unsigned int& trgIdx)const
+{
+  std::vector<WordIndex> posPhrase;
+  if(!wordsToPositions(trgIdxToPos,t,posPhrase))
+    return false;
+
+  unsigned long long left=0;
+  unsigned long long right=numTrgPhrases;
+  while(left<right)
+  {
+    unsigned long long mid=left+(right-left)/2;
+    int cmp=comparePhrase(trgPhraseWords+trgPhraseOffsets[mid],trgPhraseOffsets[mid+1]-trgPhraseOffsets[mid],posPhrase);
+    if(cmp==0)
+    {
+      trgIdx=mid;
+      return true;
+    }
+    if(cmp<0) left=mid+1;
+    else right=mid;
+  }
+  return false;
+}
+
+//-------------------------
+bool MmapPhraseTable::findEntry(unsigned int srcIdx,
+                                unsigned int trgIdx,
+                                unsigned long long& entryIdx)const
+{
+      // The entries of each source phrase are sorted by target phrase
+  const unsigned int* beginPtr=entryTrgPhrases+srcEntryOffsets[srcIdx];
+  const unsigned int* endPtr=entryTrgPhrases+srcEntryOffsets[srcIdx+1];
+  const unsigned int* ptr=std::lower_bound(beginPtr,endPtr,trgIdx);
+  if(ptr!=endPtr && *ptr==trgIdx)
+  {
+    entryIdx=ptr-entryTrgPhrases;
+    return true;
+  }
+  else
+    return false;
+}
+
+//-------------------------
+bool MmapPhraseTable::load(const char *fileName)
+{
+  clear();
+
+      // Map file
+  int fd=open(fileName,O_RDONLY);
+  if(fd==-1)
+  {
+    std::cerr<<"Error while opening binary phrase table "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  struct stat fileStat;
+  if(fstat(fd,&fileStat)==-1 || (size_t)fileStat.st_size<sizeof(MmapPtFileHeader))
+  {
+    std::cerr<<"Error, binary phrase table "<<fileName<<" is not valid"<<std::endl;
+    close(fd);
+    return THOT_ERROR;
+  }
+  void* addr=mmap(NULL,fileStat.st_size,PROT_READ,MAP_SHARED,fd,0);
+  close(fd);
+  if(addr==MAP_FAILED)
+  {
+    std::cerr<<"Error while mapping binary phrase table "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  mappedAddr=addr;
+  mappedSize=fileStat.st_size;
+
+      // Check header
+  const MmapPtFileHeader* headerPtr=(const MmapPtFileHeader*) mappedAddr;
+  if(strncmp(headerPtr->magic,MMAP_PT_MAGIC,sizeof(headerPtr->magic))!=0 || headerPtr->version!=MMAP_PT_FORMAT_VERSION)
+  {
+    std::cerr<<"Error, binary phrase table "<<fileName<<" has an unknown format or version, it should be compiled again with thot_ttable_to_mmap"<<std::endl;
+    unmapFile();
+    return THOT_ERROR;
+  }
+
+      // Sizes cannot be greater than the size of the file (this also
+      // prevents overflows when the number of offsets is obtained)
+  if(headerPtr->srcVocabSize>=mappedSize || headerPtr->srcVocabCharsSize>mappedSize ||
+     headerPtr->trgVocabSize>=mappedSize || headerPtr->trgVocabCharsSize>mappedSize ||
+     headerPtr->numSrcPhrases>=mappedSize || headerPtr->numSrcPhraseWords>mappedSize ||
+     headerPtr->numTrgPhrases>=mappedSize || headerPtr->numTrgPhraseWords>mappedSize ||
+     headerPtr->numEntries>mappedSize || headerPtr->numEntries>UINT_MAX)
+  {
+    std::cerr<<"Error, binary phrase table "<<fileName<<" is not valid"<<std::endl;
+    unmapFile();
+    return THOT_ERROR;
+  }
+
+      // Set pointers to the arrays
+  const char* ptr=(const char*) (headerPtr+1);
+  const char* endPtr=(const char*) mappedAddr+mappedSize;
+  srcVocabOffsets=(const unsigned long long*) mapBlock(ptr,endPtr,sizeof(unsigned long long),headerPtr->srcVocabSize+1);
+  srcVocabChars=(const char*) mapBlock(ptr,endPtr,sizeof(char),headerPtr->srcVocabCharsSize);
+  trgVocabOffsets=(const unsigned long long*) mapBlock(ptr,endPtr,sizeof(unsigned long long),headerPtr->trgVocabSize+1);
+  trgVocabChars=(const char*) mapBlock(ptr,endPtr,sizeof(char),headerPtr->trgVocabCharsSize);
+  srcPhraseOffsets=(const unsigned long long*) mapBlock(ptr,endPtr,sizeof(unsigned long long),headerPtr->numSrcPhrases+1);
+  srcPhraseWords=(const WordIndex*) mapBlock(ptr,endPtr,sizeof(WordIndex),headerPtr->numSrcPhraseWords);
+  srcPhraseCounts=(const float*) mapBlock(ptr,endPtr,sizeof(float),headerPtr->numSrcPhrases);
+  srcEntryOffsets=(const unsigned long long*) mapBlock(ptr,endPtr,sizeof(unsigned long long),headerPtr->numSrcPhrases+1);
+  trgPhraseOffsets=(const unsigned long long*) mapBlock(ptr,endPtr,sizeof(unsigned long long),headerPtr->numTrgPhrases+1);
+  trgPhraseWords=(const WordIndex*) mapBlock(ptr,endPtr,sizeof(WordIndex),headerPtr->numTrgPhraseWords);
+  trgPhraseCounts=(const float*) mapBlock(ptr,endPtr,sizeof(float),headerPtr->numTrgPhrases);
+  trgEntryOffsets=(const unsigned long long*) mapBlock(ptr,endPtr,sizeof(unsigned long long),headerPtr->numTrgPhrases+1);
+  entryTrgPhrases=(const unsigned int*) mapBlock(ptr,endPtr,sizeof(unsigned int),headerPtr->numEntries);
+  entryCounts=(const float*) mapBlock(ptr,endPtr,sizeof(float),headerPtr->numEntries);
+  trgIndexSrcPhrases=(const unsigned int*) mapBlock(ptr,endPtr,sizeof(unsigned int),headerPtr->numEntries);
+  trgIndexEntries=(const unsigned int*) mapBlock(ptr,endPtr,sizeof(unsigned int),headerPtr->numEntries);
+  if(srcVocabOffsets==NULL || srcVocabChars==NULL || trgVocabOffsets==NULL || trgVocabChars==NULL ||
+     srcPhraseOffsets==NULL || srcPhraseWords==NULL || srcPhraseCounts==NULL || srcEntryOffsets==NULL ||
+     trgPhraseOffsets==NULL || trgPhraseWords==NULL || trgPhraseCounts==NULL || trgEntryOffsets==NULL ||
+     entryTrgPhrases==NULL || entryCounts==NULL || trgIndexSrcPhrases==NULL || trgIndexEntries==NULL ||
+     ptr!=endPtr)
+  {
+    std::cerr<<"Error, binary phrase table "<<fileName<<" is truncated"<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+
+      // The last offset of each array should be equal to the size of
+      // the array it refers to
+  if(srcVocabOffsets[headerPtr->srcVocabSize]!=headerPtr->srcVocabCharsSize ||
+     trgVocabOffsets[headerPtr->trgVocabSize]!=headerPtr->trgVocabCharsSize ||
+     (headerPtr->srcVocabCharsSize>0 && srcVocabChars[headerPtr->srcVocabCharsSize-1]!='\0') ||
+     (headerPtr->trgVocabCharsSize>0 && trgVocabChars[headerPtr->trgVocabCharsSize-1]!='\0') ||
+     srcPhraseOffsets[headerPtr->numSrcPhrases]!=headerPtr->numSrcPhraseWords ||
+     trgPhraseOffsets[headerPtr->numTrgPhrases]!=headerPtr->numTrgPhraseWords ||
+     srcEntryOffsets[headerPtr->numSrcPhrases]!=headerPtr->numEntries ||
+     trgEntryOffsets[headerPtr->numTrgPhrases]!=headerPtr->numEntries)
+  {
+    std::cerr<<"Error, binary phrase table "<<fileName<<" is not valid"<<std::endl;
+    clear();
+    return THOT_ERROR;
+  }
+  srcVocabSize=headerPtr->srcVocabSize;
+  trgVocabSize=headerPtr->trgVocabSize;
+  numSrcPhrases=headerPtr->numSrcPhrases;
+  numTrgPhrases=headerPtr->numTrgPhrases;
+  numEntries=headerPtr->numEntries;
+
+  std::cerr<<"Binary phrase table "<<fileName<<" mapped ("<<numEntries<<" phrase pairs)"<<std::endl;
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool MmapPhraseTable::build(const char *ttableFileName,
+                            const char *fileName)
+{
+  typedef std::map<std::vector<WordIndex>,unsigned int> PhraseIdxMap;
+
+  awkInputStream awk;
+  if(awk.open(ttableFileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error in phrase model file: "<<ttableFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  std::cerr<<"Compiling phrase ttable from file "<<ttableFileName<<std::endl;
+
+      // Read entries, source and target phrases are identified by
+      // their order of appearance
+  SingleWordVocab vocab;
+  PhraseIdxMap srcPhraseIdxMap;
+  PhraseIdxMap trgPhraseIdxMap;
+  std::vector<float> srcCountVec;
+  std::vector<MmapPtBuildEntry> entryVec;
+  std::vector<std::string> s;
+  std::vector<std::string> t;
+  unsigned int numEntry=1;
+  while(awk.getln())
+  {
+    if(awk.FNR>=1 && awk.NF>1)
+    {
+          // Read source phrase
+      unsigned int i=1;
+      s.clear();
+      while(i<=awk.NF && !awk.dollarEquals(i,"|||"))
+      {
+        s.push_back(awk.dollar(i));
+        ++i;
+      }
+          // Read target phrase
+      ++i;
+      t.clear();
+      while(i<=awk.NF && !awk.dollarEquals(i,"|||"))
+      {
+        t.push_back(awk.dollar(i));
+        ++i;
+      }
+          // Verify entry
+      if(i<awk.NF-1 && awk.dollarEquals(i,"|||") && !s.empty() && !t.empty())
+      {
+            // Read count information
+        float count_s_=awk.dollarAtof(i+1);
+        float count_s_t_=awk.dollarAtof(i+2);
+
+            // Obtain indices of the phrases
+        std::pair<PhraseIdxMap::iterator,bool> srcRet=srcPhraseIdxMap.insert(std::make_pair(vocab.strVectorToSrcIndexVector(s),(unsigned int)srcCountVec.size()));
+        if(srcRet.second) srcCountVec.push_back(0);
+        std::pair<PhraseIdxMap::iterator,bool> trgRet=trgPhraseIdxMap.insert(std::make_pair(vocab.strVectorToTrgIndexVector(t),(unsigned int)trgPhraseIdxMap.size()));
+        if(entryVec.size()==UINT_MAX)
+        {
+          std::cerr<<"Error, too many entries in phrase model file: "<<ttableFileName<<std::endl;
+          return THOT_ERROR;
+        }
+
+            // Update counts, the source count of the last entry is
+            // kept. Target counts are obtained once the repeated
+            // entries have been merged
+        srcCountVec[srcRet.first->second]=count_s_;
+        MmapPtBuildEntry entry;
+        entry.srcIdx=srcRet.first->second;
+        entry.trgIdx=trgRet.first->second;
+        entry.count=count_s_t_;
+        entryVec.push_back(entry);
+      }
+      else
+      {
+        std::cerr<<"Warning: discarding anomalous phrase table entry at line "<<numEntry<<std::endl;
+      }
+    }
+    ++numEntry;
+  }
+  awk.close();
+
+      // Obtain sorted source phrases
+  std::vector<unsigned int> srcRankVec(srcCountVec.size());
+  std::vector<unsigned long long> srcPhraseOffsetVec(1,0);
+  std::vector<WordIndex> srcPhraseWordVec;
+  std::vector<float> srcPhraseCountVec;
+  for(PhraseIdxMap::const_iterator iter=srcPhraseIdxMap.begin();iter!=srcPhraseIdxMap.end();++iter)
+  {
+    srcRankVec[iter->second]=srcPhraseCountVec.size();
+    srcPhraseWordVec.insert(srcPhraseWordVec.end(),iter->first.begin(),iter->first.end());
+    srcPhraseOffsetVec.push_back(srcPhraseWordVec.size());
+    srcPhraseCountVec.push_back(srcCountVec[iter->second]);
+  }
+  srcPhraseIdxMap.clear();
+
+      // Obtain sorted target phrases
+  std::vector<unsigned int> trgRankVec(trgPhraseIdxMap.size());
+  std::vector<unsigned long long> trgPhraseOffsetVec(1,0);
+  std::vector<WordIndex> trgPhraseWordVec;
+  for(PhraseIdxMap::const_iterator iter=trgPhraseIdxMap.begin();iter!=trgPhraseIdxMap.end();++iter)
+  {
+    trgRankVec[iter->second]=trgPhraseOffsetVec.size()-1;
+    trgPhraseWordVec.insert(trgPhraseWordVec.end(),iter->first.begin(),iter->first.end());
+    trgPhraseOffsetVec.push_back(trgPhraseWordVec.size());
+  }
+  std::vector<float> trgPhraseCountVec(trgPhraseIdxMap.size(),0);
+  trgPhraseIdxMap.clear();
+
+      // Sort entries by source and target phrase, only the last
+      // occurrence of repeated entries is kept. The count of each
+      // target phrase is the sum of the counts of its entries
+  for(size_t i=0;i<entryVec.size();++i)
+  {
+    entryVec[i].srcIdx=srcRankVec[entryVec[i].srcIdx];
+    entryVec[i].trgIdx=trgRankVec[entryVec[i].trgIdx];
+  }
+  std::stable_sort(entryVec.begin(),entryVec.end(),MmapPtBuildEntryLess());
+  std::vector<unsigned long long> srcEntryOffsetVec(srcPhraseCountVec.size()+1,0);
+  std::vector<unsigned int> entryTrgPhraseVec;
+  std::vector<float> entryCountVec;
+  for(size_t i=0;i<entryVec.size();++i)
+  {
+    if(i+1<entryVec.size() && entryVec[i].srcIdx==entryVec[i+1].srcIdx && entryVec[i].trgIdx==entryVec[i+1].trgIdx)
+      continue;
+    entryVec[entryTrgPhraseVec.size()]=entryVec[i];
+    ++srcEntryOffsetVec[entryVec[i].srcIdx+1];
+    entryTrgPhraseVec.push_back(entryVec[i].trgIdx);
+    entryCountVec.push_back(entryVec[i].count);
+    trgPhraseCountVec[entryVec[i].trgIdx]+=entryVec[i].count;
+  }
+  entryVec.resize(entryTrgPhraseVec.size());
+  for(size_t i=1;i<srcEntryOffsetVec.size();++i)
+    srcEntryOffsetVec[i]+=srcEntryOffsetVec[i-1];
+
+      // Obtain target index, the entries of each target phrase are
+      // sorted by source phrase
+  std::vector<unsigned long long> trgEntryOffsetVec(trgPhraseCountVec.size()+1,0);
+  for(size_t i=0;i<entryVec.size();++i)
+    ++trgEntryOffsetVec[entryVec[i].trgIdx+1];
+  for(size_t i=1;i<trgEntryOffsetVec.size();++i)
+    trgEntryOffsetVec[i]+=trgEntryOffsetVec[i-1];
+  std::vector<unsigned long long> trgPosVec(trgEntryOffsetVec.begin(),trgEntryOffsetVec.end()-1);
+  std::vector<unsigned int> trgIndexSrcPhraseVec(entryVec.size());
+  std::vector<unsigned int> trgIndexEntryVec(entryVec.size());
+  for(size_t i=0;i<entryVec.size();++i)
+  {
+    unsigned long long pos=trgPosVec[entryVec[i].trgIdx]++;
+    trgIndexSrcPhraseVec[pos]=entryVec[i].srcIdx;
+    trgIndexEntryVec[pos]=i;
+  }
+
+      // Obtain vocabularies
+  std::vector<unsigned long long> srcVocabOffsetVec(1,0);
+  std::string srcVocabChars;
+  for(WordIndex w=0;w<vocab.getSrcVocabSize();++w)
+  {
+    srcVocabChars+=vocab.wordIndexToSrcString(w);
+    srcVocabChars.push_back('\0');
+    srcVocabOffsetVec.push_back(srcVocabChars.size());
+  }
+  std::vector<unsigned long long> trgVocabOffsetVec(1,0);
+  std::string trgVocabChars;
+  for(WordIndex w=0;w<vocab.getTrgVocabSize();++w)
+  {
+    trgVocabChars+=vocab.wordIndexToTrgString(w);
+    trgVocabChars.push_back('\0');
+    trgVocabOffsetVec.push_back(trgVocabChars.size());
+  }
+
+      // Write to temporary file first, the current file may be mapped
+  std::string tmpFileName=fileName;
+  tmpFileName+=".tmp";
+  FILE* filePtr=fopen(tmpFileName.c_str(),"wb");
+  if(filePtr==NULL)
+  {
+    std::cerr<<"Error while printing binary phrase table "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  MmapPtFileHeader header;
+  memset(&header,0,sizeof(header));
+  memcpy(header.magic,MMAP_PT_MAGIC,sizeof(header.magic));
+  header.version=MMAP_PT_FORMAT_VERSION;
+  header.srcVocabSize=srcVocabOffsetVec.size()-1;
+  header.srcVocabCharsSize=srcVocabChars.size();
+  header.trgVocabSize=trgVocabOffsetVec.size()-1;
+  header.trgVocabCharsSize=trgVocabChars.size();
+  header.numSrcPhrases=srcPhraseCountVec.size();
+  header.numSrcPhraseWords=srcPhraseWordVec.size();
+  header.numTrgPhrases=trgPhraseCountVec.size();
+  header.numTrgPhraseWords=trgPhraseWordVec.size();
+  header.numEntries=entryCountVec.size();
+  bool ok=(fwrite(&header,sizeof(header),1,filePtr)==1);
+  ok=ok && writeBlock(filePtr,&srcVocabOffsetVec[0],sizeof(unsigned long long),srcVocabOffsetVec.size());
+  ok=ok && writeBlock(filePtr,srcVocabChars.data(),sizeof(char),srcVocabChars.size());
+  ok=ok && writeBlock(filePtr,&trgVocabOffsetVec[0],sizeof(unsigned long long),trgVocabOffsetVec.size());
+  ok=ok && writeBlock(filePtr,trgVocabChars.data(),sizeof(char),trgVocabChars.size());
+  ok=ok && writeBlock(filePtr,&srcPhraseOffsetVec[0],sizeof(unsigned long long),srcPhraseOffsetVec.size());
+  ok=ok && writeBlock(filePtr,srcPhraseWordVec.data(),sizeof(WordIndex),srcPhraseWordVec.size());
+  ok=ok && writeBlock(filePtr,srcPhraseCountVec.data(),sizeof(float),srcPhraseCountVec.size());
+  ok=ok && writeBlock(filePtr,&srcEntryOffsetVec[0],sizeof(unsigned long long),srcEntryOffsetVec.size());
+  ok=ok && writeBlock(filePtr,&trgPhraseOffsetVec[0],sizeof(unsigned long long),trgPhraseOffsetVec.size());
+  ok=ok && writeBlock(filePtr,trgPhraseWordVec.data(),sizeof(WordIndex),trgPhraseWordVec.size());
+  ok=ok && writeBlock(filePtr,trgPhraseCountVec.data(),sizeof(float),trgPhraseCountVec.size());
+  ok=ok && writeBlock(filePtr,&trgEntryOffsetVec[0],sizeof(unsigned long long),trgEntryOffsetVec.size());
+  ok=ok && writeBlock(filePtr,entryTrgPhraseVec.data(),sizeof(unsigned int),entryTrgPhraseVec.size());
+  ok=ok && writeBlock(filePtr,entryCountVec.data(),sizeof(float),entryCountVec.size());
+  ok=ok && writeBlock(filePtr,trgIndexSrcPhraseVec.data(),sizeof(unsigned int),trgIndexSrcPhraseVec.size());
+  ok=ok && writeBlock(filePtr,trgIndexEntryVec.data(),sizeof(unsigned int),trgIndexEntryVec.size());
+  if(fclose(filePtr)!=0) ok=false;
+
+  if(!ok || rename(tmpFileName.c_str(),fileName)!=0)
+  {
+    std::cerr<<"Error while printing binary phrase table "<<fileName<<std::endl;
+    remove(tmpFileName.c_str());
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+size_t MmapPhraseTable::size(void)
+{
+  return numSrcPhrases+numTrgPhrases+numEntries;
+}
+
+//-------------------------
+void MmapPhraseTable::clear(void)
+{
+  unmapFile();
+  srcVocabOffsets=NULL;
+  srcVocabChars=NULL;
+  srcVocabSize=0;
+  trgVocabOffsets=NULL;
+  trgVocabChars=NULL;
+  trgVocabSize=0;
+  srcPhraseOffsets=NULL;
+  srcPhraseWords=NULL;
+  srcPhraseCounts=NULL;
+  srcEntryOffsets=NULL;
+  numSrcPhrases=0;
+  trgPhraseOffsets=NULL;
+  trgPhraseWords=NULL;
+  trgPhraseCounts=NULL;
+  trgEntryOffsets=NULL;
+  numTrgPhrases=0;
+  entryTrgPhrases=NULL;
+  entryCounts=NULL;
+  trgIndexSrcPhrases=NULL;
+  trgIndexEntries=NULL;
+  numEntries=0;
+  srcIdxToPos.clear();
+  srcPosToIdx.clear();
+  trgIdxToPos.clear();
+  trgPosToIdx.clear();
+}
+
+//-------------------------
+void MmapPhraseTable::printReadOnlyWarning(void)
+{
+  if(!readOnlyWarningPrinted)
+  {
+    std::cerr<<"Warning: binary phrase tables are read-only, phrase table updates will be ignored"<<std::endl;
+    readOnlyWarningPrinted=true;
+  }
+}
+
+//-------------------------
+void MmapPhraseTable::unmapFile(void)
+{
+  if(mappedAddr!=NULL)
+  {
+    munmap(mappedAddr,mappedSize);
+    mappedAddr=NULL;
+    mappedSize=0;
+  }
+}
+
+//-------------------------
+MmapPhraseTable::~MmapPhraseTable()
+{
+  unmapFile();
+}
@@ -0,0 +1,233 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: MmapPhraseTable                                          */
+/*                                                                  */
+/* Prototype file: MmapPhraseTable.h                                */
+/*                                                                  */
+/* Description: Read-only bilingual phrase table stored in a        */
+/*              compiled binary file that is memory-mapped.         */
+/*                                                                  */
+/********************************************************************/
+
+#ifndef _MmapPhraseTable
+#define _MmapPhraseTable
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BasePhraseTable.h"
+#include "ErrorDefs.h"
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define MMAP_PT_MAGIC             "THOTMMPT"
+#define MMAP_PT_FORMAT_VERSION    2
+
+//--------------- typedefs -------------------------------------------
+
+
+//--------------- function declarations ------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- MmapPhraseTable class
+
+/**
+ * @brief Read-only phrase table served from a compiled binary file
+ * that is memory-mapped, so that several processes can share one
+ * physical copy of the table. The file contains the source and target
+ * vocabularies, the source and target phrases sorted by their word
+ * indices, the phrase pairs sorted by source phrase with an offset
+ * index, and a secondary index of the phrase pairs sorted by target
+ * phrase. The binary file is obtained from a plain text translation
+ * table by means of the build() function. Count semantics are the
+ * same as those of StlPhraseTable when the entries of the text table
+ * are added with addTableEntry(), except for repeated phrase pairs:
+ * only the last occurrence of each pair is kept, and it is counted
+ * once in the count of the target phrase.
+ */
+
+class MmapPhraseTable: public BasePhraseTable
+{
+    public:
+
+        typedef BasePhraseTable::SrcTableNode SrcTableNode;
+        typedef BasePhraseTable::TrgTableNode TrgTableNode;
+
+            // Constructor
+        MmapPhraseTable(void);
+
+            // Functions to modify the table. The table is read-only,
+            // so these functions only print a warning
+        void addTableEntry(const std::vector<WordIndex>& s,
+                           const std::vector<WordIndex>& t,
+                           PhrasePairInfo inf);
+        void addSrcInfo(const std::vector<WordIndex>& s, Count s_inf);
+        void addSrcTrgInfo(const std::vector<WordIndex>& s,
+                           const std::vector<WordIndex>& t,
+                           Count st_inf);
+        void incrCountsOfEntry(const std::vector<WordIndex>& s,
+                               const std::vector<WordIndex>& t,
+                               Count c);
+
+            // Functions to access the table
+        PhrasePairInfo infSrcTrg(const std::vector<WordIndex>& s,
+                                 const std::vector<WordIndex>& t,
+                                 bool& found);
+        Count getSrcInfo(const std::vector<WordIndex>& s, bool &found);
+        Count getSrcTrgInfo(const std::vector<WordIndex>& s,
+                            const std::vector<WordIndex>& t,
+                            bool &found);
+        Prob pTrgGivenSrc(const std::vector<WordIndex>& s,
+                          const std::vector<WordIndex>& t);
+        LgProb logpTrgGivenSrc(const std::vector<WordIndex>& s,
+                               const std::vector<WordIndex>& t);
+        Prob pSrcGivenTrg(const std::vector<WordIndex>& s,
+                          const std::vector<WordIndex>& t);
+        LgProb logpSrcGivenTrg(const std::vector<WordIndex>& s,
+                               const std::vector<WordIndex>& t);
+        bool getEntriesForTarget(const std::vector<WordIndex>& t,
+                                 SrcTableNode& srctn);
+        bool getEntriesForSource(const std::vector<WordIndex>& s,
+                                 TrgTableNode& trgtn);
+        bool getNbestForSrc(const std::vector<WordIndex>& s,
+                            NbestTableNode<PhraseTransTableNodeData>& nbt);
+        bool getNbestForTrg(const std::vector<WordIndex>& t,
+                            NbestTableNode<PhraseTransTableNodeData>& nbt,
+                            int N=-1);
+
+            // Counts-related functions
+        Count cSrcTrg(const std::vector<WordIndex>& s,
+                      const std::vector<WordIndex>& t);
+        Count cSrc(const std::vector<WordIndex>& s);
+        Count cTrg(const std::vector<WordIndex>& t);
+
+            // Vocabulary functions. The words stored in the file are
+            // referred to by their position in the vocabulary of the
+            // file, which is mapped to the word index used in the rest
+            // of functions (by default both indices are the same)
+        size_t getSrcVocabSize(void)const;
+        std::string getSrcWord(size_t pos)const;
+        void setSrcWordIndex(size_t pos,WordIndex w);
+        size_t getTrgVocabSize(void)const;
+        std::string getTrgWord(size_t pos)const;
+        void setTrgWordIndex(size_t pos,WordIndex w);
+
+            // Functions to enumerate the source phrases
+        size_t getNumSrcPhrases(void)const;
+        void getSrcPhrase(size_t idx,
+                          std::vector<WordIndex>& s)const;
+
+            // load and build functions
+        bool load(const char *fileName);
+            // Maps the binary file fileName
+        static bool build(const char *ttableFileName,
+                          const char *fileName);
+            // Compiles the plain text translation table ttableFileName
+            // into the binary file fileName. The words of the table
+            // are indexed in order of appearance after the reserved
+            // words of SingleWordVocab. Repeated phrase pairs are
+            // merged before obtaining the target phrase counts
+
+            // size and clear functions
+        size_t size(void);
+        void clear(void);
+
+            // Destructor
+        ~MmapPhraseTable();
+
+    protected:
+
+            // Pointers to the arrays of the mapped file. The phrases
+            // and the phrase pairs are referred to by their position
+            // in the corresponding arrays
+        const unsigned long long* srcVocabOffsets;
+        const char* srcVocabChars;
+        unsigned long long srcVocabSize;
+        const unsigned long long* trgVocabOffsets;
+        const char* trgVocabChars;
+        unsigned long long trgVocabSize;
+
+        const unsigned long long* srcPhraseOffsets;
+        const WordIndex* srcPhraseWords;
+        const float* srcPhraseCounts;
+        const unsigned long long* srcEntryOffsets;
+        unsigned long long numSrcPhrases;
+
+        const unsigned long long* trgPhraseOffsets;
+        const WordIndex* trgPhraseWords;
+        const float* trgPhraseCounts;
+        const unsigned long long* trgEntryOffsets;
+        unsigned long long numTrgPhrases;
+
+        const unsigned int* entryTrgPhrases;
+        const float* entryCounts;
+        const unsigned int* trgIndexSrcPhrases;
+        const unsigned int* trgIndexEntries;
+        unsigned long long numEntries;
+
+            // Maps between word indices and positions in the
+            // vocabularies of the file
+        std::vector<WordIndex> srcIdxToPos;
+        std::vector<WordIndex> srcPosToIdx;
+        std::vector<WordIndex> trgIdxToPos;
+        std::vector<WordIndex> trgPosToIdx;
+
+            // Data of the mapped file
+        void* mappedAddr;
+        size_t mappedSize;
+
+        bool readOnlyWarningPrinted;
+
+            // Auxiliary functions
+        bool wordsToPositions(const std::vector<WordIndex>& idxToPos,
+                              const std::vector<WordIndex>& phrase,
+                              std::vector<WordIndex>& posPhrase)const;
+        void positionsToWords(const std::vector<WordIndex>& posToIdx,
+                              const WordIndex* beginPtr,
+                              const WordIndex* endPtr,
+                              std::vector<WordIndex>& phrase)const;
+        void setWordIndex(std::vector<WordIndex>& idxToPos,
+                          std::vector<WordIndex>& posToIdx,
+                          size_t vocabSize,
+                          size_t pos,
+                          WordIndex w);
+        bool findSrcPhrase(const std::vector<WordIndex>& s,
+                           unsigned int& srcIdx)const;
+        bool findTrgPhrase(const std::vector<WordIndex>& t,
+                           unsigned int& trgIdx)const;
+        bool findEntry(unsigned int srcIdx,
+                       unsigned int trgIdx,
+                       unsigned long long& entryIdx)const;
+        void getTrgPhrase(size_t idx,
+                          std::vector<WordIndex>& t)const;
+        Count getTrgInfo(const std::vector<WordIndex>& t, bool &found);
+        void printReadOnlyWarning(void);
+        void unmapFile(void);
+};
+
+#endif
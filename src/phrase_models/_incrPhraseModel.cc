@@ -361,7 +361,7 @@ bool _incrPhraseModel::loadPlainTextTTable(const char *phraseTTableFileName)
            // Read source phrase
        i=1; 
        s.clear();	  
-       while(i<=awk.NF && strcmp("|||",awk.dollar(i).c_str())!=0)	
+       while(i<=awk.NF && !awk.dollarEquals(i,"|||"))	
        {
          s.push_back(awk.dollar(i)); 
          ++i;
@@ -369,19 +369,19 @@ bool _incrPhraseModel::loadPlainTextTTable(const char *phraseTTableFileName)
            // Read target phrase
        ++i;
        t.clear();
-       while(i<=awk.NF && strcmp("|||",awk.dollar(i).c_str())!=0)	
+       while(i<=awk.NF && !awk.dollarEquals(i,"|||"))	
        {
          t.push_back(awk.dollar(i));			   
          ++i; 
        }
            // Verify entry
-       if(i<awk.NF-1 && strcmp("|||",awk.dollar(i).c_str())==0 && !s.empty() && !t.empty())
+       if(i<awk.NF-1 && awk.dollarEquals(i,"|||") && !s.empty() && !t.empty())
        {
              // Read count information
          ++i;
-         count_s_=atof(awk.dollar(i).c_str());
+         count_s_=awk.dollarAtof(i);
          ++i;
-         count_s_t_=atof(awk.dollar(i).c_str());  
+         count_s_t_=awk.dollarAtof(i);  
 
              // Add table entry
          phpinfo.first=count_s_;
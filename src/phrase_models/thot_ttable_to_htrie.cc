@@ -0,0 +1,120 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: thot_ttable_to_htrie.cc                                  */
+/*                                                                  */
+/* Definitions file: thot_ttable_to_htrie.cc                        */
+/*                                                                  */
+/* Description: Compiles a translation table into the binary format */
+/*              read by HAT-trie based phrase models.               */
+/*                                                                  */   
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <IncrPhraseModel.h>
+#include <iostream>
+#include "options.h"
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Function Declarations ------------------------------
+
+int TakeParameters(int argc, char *argv[]);
+void printUsage(void);
+
+//--------------- Type definitions -----------------------------------
+
+
+//--------------- Global variables -----------------------------------
+
+std::string modelPrefix;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc, char *argv[])
+{
+  if(TakeParameters(argc,argv) == THOT_OK)
+  {
+#ifdef THOT_HAVE_CXX11
+    IncrPhraseModel incrPhraseModel;
+
+        // Load phrase model vocabularies as done by the decoder, so
+        // that the binary table is compatible with them
+    std::string srcTrainVocabFileName=modelPrefix+"_swm.svcb";
+    std::string trgTrainVocabFileName=modelPrefix+"_swm.tvcb";
+    if(incrPhraseModel.loadSrcVocab(srcTrainVocabFileName.c_str())==THOT_ERROR ||
+       incrPhraseModel.loadTrgVocab(trgTrainVocabFileName.c_str())==THOT_ERROR)
+      return THOT_ERROR;
+
+    std::string ttableFileName=modelPrefix+".ttable";
+    return incrPhraseModel.buildHatTrieTTable(ttableFileName.c_str());
+#else
+    std::cerr<<"Error: HAT-trie phrase tables require C++11 support"<<std::endl;
+    return THOT_ERROR;
+#endif
+  }
+  else return THOT_ERROR;
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  int err;
+
+      /* Verify --help option */
+  err=readOption(argc, argv, "--help");
+  if(err != -1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+      /* Takes the prefix of the phrase model files */
+  err = readSTLstring(argc,argv, "-i", &modelPrefix);
+  if(err == -1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;  
+}
+
+//---------------
+void printUsage(void)
+{
+  printf("Usage: thot_ttable_to_htrie -i <string> [--help]\n\n");
+  printf("-i <string>                   Prefix of the phrase model files. The\n");
+  printf("                              table <prefix>.ttable is stored in\n");
+  printf("                              <prefix>.ttable%s, which is read by phrase\n",".htrie");
+  printf("                              models of type IncrPhraseModel while it is\n");
+  printf("                              up to date.\n\n");
+  printf("--help                        Display this help and exit.\n\n");
+}
+
+//--------------------------------
@@ -60,6 +60,8 @@ int process_ttable(void);
 //--------------- Global variables -----------------------------------
 
 std::string outputFile;
+bool bulkLoad;
+int maxMemMb;
 
 //--------------- Function Definitions -------------------------------
 
@@ -130,6 +132,9 @@ int process_ttable(void)
       std::cerr << "Cannot create or recreate database (LevelDB)" << std::endl;
       return THOT_ERROR;
     }
+
+    if(bulkLoad && levelDbPt.startBulkLoad((size_t) maxMemMb * 1048576) == THOT_ERROR)
+      return THOT_ERROR;
     
         // Process translation table
     int i = 0;
@@ -143,7 +148,15 @@ int process_ttable(void)
       Count jointCount;
       int ret = extractEntryInfo(awk, srcPhr, trgPhr, jointCount);
       if(ret == THOT_OK)
-        levelDbPt.incrCountsOfEntry(srcPhr, trgPhr, jointCount);
+      {
+        if(bulkLoad)
+        {
+          if(levelDbPt.bulkIncrCountsOfEntry(srcPhr, trgPhr, jointCount) == THOT_ERROR)
+            return THOT_ERROR;
+        }
+        else
+          levelDbPt.incrCountsOfEntry(srcPhr, trgPhr, jointCount);
+      }
       else
         std::cerr << "Cannot extract entry info" << std::endl;
       i++;
@@ -152,6 +165,16 @@ int process_ttable(void)
         std::cerr << "Processed " << i << " lines" << std::endl;
     }
 
+    if(bulkLoad)
+    {
+      std::cerr << "Writing sorted entries" << std::endl;
+      if(levelDbPt.finishBulkLoad() == THOT_ERROR)
+      {
+        std::cerr << "Error while writing database" << std::endl;
+        return THOT_ERROR;
+      }
+    }
+
     std::cerr << "levelDB size: " << levelDbPt.size() << std::endl;
     
     return THOT_OK;
@@ -179,14 +202,24 @@ int TakeParameters(int argc,char *argv[])
     return THOT_ERROR;
   }
 
+      /* Bulk loading options */
+  bulkLoad = (readOption(argc, argv, "-b") != -1);
+  err = readInt(argc, argv, "-m", &maxMemMb);
+  if(err == -1)
+    maxMemMb = EXT_SORTER_DEFAULT_MAX_MEM_BYTES / 1048576;
+
   return THOT_OK;  
 }
 
 //---------------
 void printUsage(void)
 {
-  printf("Usage: thot_ttable_to_leveldb -o <string> [--help]\n\n");
+  printf("Usage: thot_ttable_to_leveldb -o <string> [-b [-m <int>]] [--help]\n\n");
   printf("-o <string>                   Name of output file.\n\n");
+  printf("-b                            Sort the entries externally and write them in\n");
+  printf("                              key order (bulk loading).\n\n");
+  printf("-m <int>                      Memory in MB used to sort the entries when\n");
+  printf("                              bulk loading (%d by default).\n\n", EXT_SORTER_DEFAULT_MAX_MEM_BYTES / 1048576);
   printf("--help                        Display this help and exit.\n\n");
 }
 
@@ -0,0 +1,120 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: thot_ttable_to_mmap.cc                                   */
+/*                                                                  */
+/* Definitions file: thot_ttable_to_mmap.cc                         */
+/*                                                                  */
+/* Description: Compiles a translation table into the binary format */
+/*              used by memory-mapped phrase tables.                */
+/*                                                                  */   
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <MmapPhraseTable.h>
+#include <iostream>
+#include "options.h"
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Function Declarations ------------------------------
+
+int TakeParameters(int argc, char *argv[]);
+void printUsage(void);
+
+//--------------- Type definitions -----------------------------------
+
+
+//--------------- Global variables -----------------------------------
+
+std::string inputFile;
+std::string outputFile;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc, char *argv[])
+{
+  if(TakeParameters(argc,argv) == THOT_OK)
+  {
+    if(MmapPhraseTable::build(inputFile.c_str(), outputFile.c_str()) == THOT_ERROR)
+      return THOT_ERROR;
+
+        // Verify the resulting file
+    MmapPhraseTable mmapPt;
+    if(mmapPt.load(outputFile.c_str()) == THOT_ERROR)
+      return THOT_ERROR;
+
+    return THOT_OK;
+  }
+  else return THOT_ERROR;
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  int err;
+
+      /* Verify --help option */
+  err=readOption(argc, argv, "--help");
+  if(err != -1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+      /* Takes the input translation table */
+  err = readSTLstring(argc,argv, "-i", &inputFile);
+  if(err == -1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+      /* Takes the output file */
+  err = readSTLstring(argc,argv, "-o", &outputFile);
+  if(err == -1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;  
+}
+
+//---------------
+void printUsage(void)
+{
+  printf("Usage: thot_ttable_to_mmap -i <string> -o <string> [--help]\n\n");
+  printf("-i <string>                   Plain text translation table.\n\n");
+  printf("-o <string>                   Name of output file. Phrase models of type\n");
+  printf("                              MmapPhraseModel look for the binary table\n");
+  printf("                              in <ttable file>%s.\n\n",".bin");
+  printf("--help                        Display this help and exit.\n\n");
+}
+
+//--------------------------------
@@ -56,7 +56,11 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 /**
  * @brief The BasePrePosProcessor class implements the interface of
- * pre/pos-processing modules
+ * pre/pos-processing modules. Each module keeps the information
+ * required to pos-process the translation of the last sentence
+ * preprocessed with keepPreprocInfo equal to true, so that different
+ * modules can be used concurrently by different threads. A given
+ * module should not be shared by several threads.
  */
 
 class BasePrePosProcessor
@@ -49,6 +49,7 @@ bool EU_PrePosProcessor1::loadCapitInfo(const char* filename)
   caps= new std::ifstream(filename);
   if ( caps )
   {
+    ScannerStateGuard guard;
     EUpostprocInitializeCapitalization(*caps);
     delete caps;
     std::cerr<<"THOT_OK"<<std::endl;
@@ -68,22 +69,22 @@ std::string EU_PrePosProcessor1::preprocLine(std::string str,
                                              bool caseconv,
                                              bool keepPreprocInfo)
 {
-      // Store state info
-  if(keepPreprocInfo)
-    lastPreprocStrKept=str;
+  ScannerStateGuard guard;
+  guard.useTables(pprocTables,EUpprocTables);
 
   return EUpprocLine(str.c_str(),caseconv,keepPreprocInfo);
-      // when last argument of EUpprocLine is true its internal tables
-      // are modified
+      // when last argument of EUpprocLine is true the tables of the
+      // module are modified
 }
 
 //---------------------------------------
 std::string EU_PrePosProcessor1::postprocLine(std::string str,
                                               bool caseconv)
 {
-      // Restore preprocessing info if necessary
-  if(!lastPreprocStrKept.empty())
-    EUpprocLine(lastPreprocStrKept.c_str(),caseconv,true);
+      // Retrieve the labels kept by the last preprocessed sentence
+  ScannerStateGuard guard;
+  pprocTables.resetCounters();
+  guard.useTables(pprocTables,EUpprocTables);
   
   return EUpostprocLine(str.c_str(),caseconv);
 }
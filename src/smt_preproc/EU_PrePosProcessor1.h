@@ -51,6 +51,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "ErrorDefs.h"
 #include "preprocess.h"
 #include "postprocess.h"
+#include "ScannerStateGuard.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -87,6 +88,6 @@ class EU_PrePosProcessor1: public BasePrePosProcessor
 
  private:
   
-  std::string lastPreprocStrKept;
+  Tables pprocTables;
 };
 #endif
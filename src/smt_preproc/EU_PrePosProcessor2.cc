@@ -49,6 +49,7 @@ bool EU_PrePosProcessor2::loadCapitInfo(const char* filename)
   caps= new std::ifstream(filename);
   if ( caps )
   {
+    ScannerStateGuard guard;
     EUpostprocInitializeCapitalization(*caps);
     delete caps;
     std::cerr<<"THOT_OK"<<std::endl;
@@ -68,29 +69,26 @@ std::string EU_PrePosProcessor2::preprocLine(std::string str,
                                              bool caseconv,
                                              bool keepPreprocInfo)
 {
-      // Store state info
-  if(keepPreprocInfo)
-    lastPreprocStrKept=str;
+  ScannerStateGuard guard;
+  guard.useTables(pprocTables,EUpprocTables);
 
   std::string tok_str=XRCEtokLine(str.c_str(),false,false);
       // The tokenization step is the same used for the XRCE corpus (no
       // specific tokenization step was implemented for the EU corpus in
       // the TT2 project)
   return EUpprocLine(tok_str.c_str(),caseconv,keepPreprocInfo);
-      // when last argument of EUpprocLine is true its internal tables
-      // are modified
+      // when last argument of EUpprocLine is true the tables of the
+      // module are modified
 }
 
 //---------------------------------------
 std::string EU_PrePosProcessor2::postprocLine(std::string str,
                                               bool caseconv)
 {
-      // Restore preprocessing info if necessary
-  if(!lastPreprocStrKept.empty())
-  {
-    std::string tok_str=XRCEtokLine(lastPreprocStrKept.c_str(),false,false);
-    EUpprocLine(tok_str.c_str(),caseconv,true);
-  }
+      // Retrieve the labels kept by the last preprocessed sentence
+  ScannerStateGuard guard;
+  pprocTables.resetCounters();
+  guard.useTables(pprocTables,EUpprocTables);
 
   std::string eupostproc_str=EUpostprocLine(str.c_str(),caseconv);
   return XRCEdetokLine(eupostproc_str.c_str(),false);
@@ -52,6 +52,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "ErrorDefs.h"
 #include "preprocess.h"
 #include "postprocess.h"
+#include "ScannerStateGuard.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -89,6 +90,6 @@ class EU_PrePosProcessor2: public BasePrePosProcessor
 
  private:
   
-  std::string lastPreprocStrKept;
+  Tables pprocTables;
 };
 #endif
@@ -0,0 +1,114 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: ScannerStateGuard                                        */
+/*                                                                  */
+/* Prototypes file: ScannerStateGuard.h                             */
+/*                                                                  */
+/* Description: Declares the ScannerStateGuard class, which gives   */
+/*              a pre/pos-processing module access to the XRCE and  */
+/*              EU scanners using its own label tables              */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file ScannerStateGuard.h
+ * 
+ * @brief Defines the ScannerStateGuard class, which gives a
+ * pre/pos-processing module access to the XRCE and EU scanners using
+ * its own label tables
+ */
+
+#ifndef _ScannerStateGuard_h
+#define _ScannerStateGuard_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "preprocess.h"
+#include <pthread.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- ScannerStateGuard class
+
+/**
+ * @brief The scanners keep their label tables and their output
+ * buffers in global variables. A ScannerStateGuard object holds the
+ * scanners while it exists and installs the tables of the module that
+ * created it, which are returned to the module at destruction. This
+ * way, the preprocessing information of each module is kept in the
+ * module itself, and the scanners are only held during the calls to
+ * them instead of during the whole pre/pos-processing of a sentence.
+ */
+
+class ScannerStateGuard
+{
+ public:
+
+      // Constructor, waits until the scanners are available
+  ScannerStateGuard(void)
+    {
+      pthread_mutex_lock(&scannerMutex());
+    }
+
+  void useTables(Tables& moduleTables,
+                 Tables& scannerTables)
+    {
+      std::swap(moduleTables,scannerTables);
+      swappedTablesVec.push_back(std::make_pair(&moduleTables,&scannerTables));
+    }
+      // Installs moduleTables as the tables of the scanner that use
+      // scannerTables until the object is destroyed
+
+      // Destructor, returns the tables to the module and releases the
+      // scanners
+  ~ScannerStateGuard()
+    {
+      for(size_t i=swappedTablesVec.size();i>0;--i)
+        std::swap(*swappedTablesVec[i-1].first,*swappedTablesVec[i-1].second);
+      pthread_mutex_unlock(&scannerMutex());
+    }
+
+ private:
+
+  std::vector<std::pair<Tables*,Tables*> > swappedTablesVec;
+
+  static pthread_mutex_t& scannerMutex(void)
+    {
+      static pthread_mutex_t scanner_mut=PTHREAD_MUTEX_INITIALIZER;
+      return scanner_mut;
+    }
+
+      // Copies are not allowed
+  ScannerStateGuard(const ScannerStateGuard&);
+  void operator=(const ScannerStateGuard&);
+};
+
+#endif
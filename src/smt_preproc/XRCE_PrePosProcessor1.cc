@@ -48,6 +48,7 @@ bool XRCE_PrePosProcessor1::loadCapitInfo(const char* filename)
   caps= new std::ifstream(filename);
   if ( caps )
   {
+    ScannerStateGuard guard;
     XRCEpostprocInitializeCapitalization(*caps);
     delete caps;
     std::cerr<<"THOT_OK"<<std::endl;
@@ -67,23 +68,23 @@ std::string XRCE_PrePosProcessor1::preprocLine(std::string str,
                                                bool caseconv,
                                                bool keepPreprocInfo)
 {
-      // Store state info
-  if(keepPreprocInfo)
-    lastPreprocStrKept=str;
+  ScannerStateGuard guard;
+  guard.useTables(pprocTables,XRCEpprocTables);
 
       // Return preprocessed sentence
   return XRCEpprocLine(str.c_str(),caseconv,keepPreprocInfo);
-      // when last argument of XRCEpprocLine is true its internal tables
-      // are modified
+      // when last argument of XRCEpprocLine is true the tables of the
+      // module are modified
 }
 
 //---------------------------------------
 std::string XRCE_PrePosProcessor1::postprocLine(std::string str,
                                                 bool caseconv)
 {
-      // Restore preprocessing info if necessary
-  if(!lastPreprocStrKept.empty())
-    XRCEpprocLine(lastPreprocStrKept.c_str(),caseconv,true);
+      // Retrieve the labels kept by the last preprocessed sentence
+  ScannerStateGuard guard;
+  pprocTables.resetCounters();
+  guard.useTables(pprocTables,XRCEpprocTables);
   
   return XRCEpostprocLine(str.c_str(),caseconv);
 }
@@ -66,13 +66,15 @@ std::string XRCE_PrePosProcessor2::preprocLine(std::string str,
                                                bool caseconv,
                                                bool keepPreprocInfo)
 {
+  ScannerStateGuard guard;
+  guard.useTables(pprocTables,XRCEpprocTables);
   if(keepPreprocInfo)
     lastPreprocStr="";
   else
     lastPreprocStr=XRCEtokLine(str.c_str(),false);
   return XRCEpprocLine(str.c_str(),caseconv,keepPreprocInfo);
-      // when last argument of XRCEpprocLine is true its internal tables
-      // are modified.
+      // when last argument of XRCEpprocLine is true the tables of the
+      // module are modified.
       // If caseconv==true, then the input string is lowercased.
 }
 
@@ -86,7 +88,11 @@ std::string XRCE_PrePosProcessor2::postprocLine(std::string str,
     pprocResult=capitalize(str);
   else
     pprocResult=str;
-      
+
+      // Retrieve the labels kept by the last preprocessed sentence
+  ScannerStateGuard guard;
+  pprocTables.resetCounters();
+  guard.useTables(pprocTables,XRCEpprocTables);
   pprocResult=XRCEpostprocLine(pprocResult.c_str(),false);
 
   return pprocResult;
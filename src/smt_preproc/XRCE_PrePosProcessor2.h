@@ -56,6 +56,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "awkInputStream.h"
 #include "preprocess.h"
 #include "postprocess.h"
+#include "ScannerStateGuard.h"
 #include <IncrJelMerNgramLM.h>
 
 //--------------- Constants ------------------------------------------
@@ -95,6 +96,7 @@ class XRCE_PrePosProcessor2: public BasePrePosProcessor
  protected:
   
   std::string lastPreprocStr;
+  Tables pprocTables;
 
       // capitMap stores capitalization options
   std::map<std::string,std::vector<std::string> > capitMap;
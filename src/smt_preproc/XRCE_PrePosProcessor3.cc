@@ -52,6 +52,7 @@ std::string XRCE_PrePosProcessor3::preprocLine(std::string str,
                                                bool /*caseconv*/,
                                                bool /*keepPreprocInfo*/)
 {
+  ScannerStateGuard guard;
   return XRCEtokLine(str.c_str(),false,false);
 }
 
@@ -59,6 +60,7 @@ std::string XRCE_PrePosProcessor3::preprocLine(std::string str,
 std::string XRCE_PrePosProcessor3::postprocLine(std::string str,
                                                 bool /*caseconv*/)
 {
+  ScannerStateGuard guard;
   return XRCEdetokLine(str.c_str(),false);
 }
 
@@ -51,9 +51,9 @@ std::string XRCE_PrePosProcessor4::preprocLine(std::string str,
                                                bool /*caseconv*/,
                                                bool keepPreprocInfo)
 {
-      // Store state info
-  if(keepPreprocInfo)
-     lastPreprocStrKept=str;
+  ScannerStateGuard guard;
+  guard.useTables(pprocTables,XRCEpprocTables);
+  guard.useTables(categTables,XRCEcategTables);
 
   const char* tokstr=XRCEtokLine(str.c_str(),false,keepPreprocInfo);
   return XRCEcategLine(tokstr,keepPreprocInfo);
@@ -63,12 +63,12 @@ std::string XRCE_PrePosProcessor4::preprocLine(std::string str,
 std::string XRCE_PrePosProcessor4::postprocLine(std::string str,
                                                 bool /*caseconv*/)
 {
-      // Restore preprocessing info if necessary
-  if(!lastPreprocStrKept.empty())
-  {
-    const char* tokstr=XRCEtokLine(lastPreprocStrKept.c_str(),false,true);
-    XRCEcategLine(tokstr,true);
-  }
+      // Retrieve the labels kept by the last preprocessed sentence
+  ScannerStateGuard guard;
+  pprocTables.resetCounters();
+  categTables.resetCounters();
+  guard.useTables(pprocTables,XRCEpprocTables);
+  guard.useTables(categTables,XRCEcategTables);
   
   const char* decategstr=XRCEdecategLine(str.c_str());
   return XRCEdetokLine(decategstr,false);
@@ -49,6 +49,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "ErrorDefs.h"
 #include "preprocess.h"
 #include "postprocess.h"
+#include "ScannerStateGuard.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -85,6 +86,7 @@ class XRCE_PrePosProcessor4: public BasePrePosProcessor
 
  private:
   
-  std::string lastPreprocStrKept;
+  Tables pprocTables;
+  Tables categTables;
 };
 #endif
@@ -109,6 +109,8 @@ class BasePbTransModel: public _smtModel<HYPOTHESIS>
   void set_A_par(unsigned int A_par);
   void set_E_par(unsigned int E_par);
   void set_U_par(unsigned int U_par);
+  unsigned int get_U_par(void)const;
+      // Returns the maximum number of source words that can be skipped
   bool monotoneSearch(void);
       // Returns true if the search is monotone
 
@@ -291,6 +293,13 @@ void BasePbTransModel<HYPOTHESIS>::set_U_par(unsigned int U_par)
   pbTransModelPars.U=U_par;
 }
 
+//---------------------------------------
+template<class HYPOTHESIS>
+unsigned int BasePbTransModel<HYPOTHESIS>::get_U_par(void)const
+{
+  return pbTransModelPars.U;
+}
+
 //---------------------------------------
 template<class HYPOTHESIS>
 bool BasePbTransModel<HYPOTHESIS>::monotoneSearch(void)
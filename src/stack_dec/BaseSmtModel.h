@@ -117,6 +117,46 @@ class BaseSmtModel
   virtual void expand_prefix(const Hypothesis& hyp,
                              std::vector<Hypothesis>& hypVec,
                              std::vector<std::vector<Score> >& scrCompVec)=0;
+  virtual bool prepareForParallelExpansion(void);
+      // Completes the per-sentence data of the model (translation
+      // options, vocabularies, etc.) after calling pre_trans_actions(),
+      // so that copies obtained with clone() can be used to call
+      // expand() concurrently and generate the same hypotheses as the
+      // original object. Returns false if the model does not support
+      // parallel expansion (currently only the models derived from
+      // _pbTransModel support it)
+  virtual bool updateCopyForParallelExpansion(BaseSmtModel<HYPOTHESIS>* copyPtr);
+      // Copies the data of the current sentence into copyPtr, a model
+      // obtained with clone(), after calling
+      // prepareForParallelExpansion(). The translation options
+      // collected by the latter are shared with copyPtr instead of
+      // copied, so the copy can only be used while the current object
+      // is translating the same sentence. Returns false if the model
+      // does not support parallel expansion
+  virtual void releaseSentenceCaches(void);
+      // Releases the data cached while translating the current
+      // sentence, it will be recomputed if needed
+
+      // Functions for lazy expansion of hypotheses (they are used to
+      // generate the extensions of a hypothesis in best-first order
+      // instead of obtaining all of them with expand())
+  virtual bool getSpansForExpansion(const Hypothesis& hyp,
+                                    std::vector<std::pair<PositionIndex,PositionIndex> >& spanVec);
+      // Obtains the source spans that can be translated to extend hyp
+      // (regular translation). Returns false if lazy expansion is not
+      // supported by the model
+  virtual bool getHypDataVecForSpan(const Hypothesis& hyp,
+                                    PositionIndex srcLeft,
+                                    PositionIndex srcRight,
+                                    std::vector<HypDataType>& hypDataVec);
+      // Obtains the data of the extensions of hyp covering the given
+      // source span, sorted by the score of the translation options
+  virtual bool expandGivenHypData(const Hypothesis& hyp,
+                                  const HypDataType& hypData,
+                                  Hypothesis& extHyp,
+                                  std::vector<Score>& scrComps);
+      // Scores the extension of hyp given by hypData. Returns false if
+      // the extension does not satisfy the translation constraints
       
       // Misc. operations with hypothesis
   virtual Hypothesis nullHypothesis(void)=0;
@@ -214,6 +254,57 @@ void BaseSmtModel<HYPOTHESIS>::subtractHeuristicToHyp(Hypothesis& /*hyp*/)
   
 }
 
+//---------------------------------
+template<class HYPOTHESIS>
+bool BaseSmtModel<HYPOTHESIS>::prepareForParallelExpansion(void)
+{
+  return false;
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+bool BaseSmtModel<HYPOTHESIS>::updateCopyForParallelExpansion(BaseSmtModel<HYPOTHESIS>* /*copyPtr*/)
+{
+  return false;
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+void BaseSmtModel<HYPOTHESIS>::releaseSentenceCaches(void)
+{
+
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+bool BaseSmtModel<HYPOTHESIS>::getSpansForExpansion(const Hypothesis& /*hyp*/,
+                                                    std::vector<std::pair<PositionIndex,PositionIndex> >& spanVec)
+{
+  spanVec.clear();
+  return false;
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+bool BaseSmtModel<HYPOTHESIS>::getHypDataVecForSpan(const Hypothesis& /*hyp*/,
+                                                    PositionIndex /*srcLeft*/,
+                                                    PositionIndex /*srcRight*/,
+                                                    std::vector<HypDataType>& hypDataVec)
+{
+  hypDataVec.clear();
+  return false;
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+bool BaseSmtModel<HYPOTHESIS>::expandGivenHypData(const Hypothesis& /*hyp*/,
+                                                  const HypDataType& /*hypData*/,
+                                                  Hypothesis& /*extHyp*/,
+                                                  std::vector<Score>& /*scrComps*/)
+{
+  return false;
+}
+
 //---------------------------------
 template<class HYPOTHESIS>
 bool BaseSmtModel<HYPOTHESIS>::isComplete(const Hypothesis& hyp)const
@@ -87,6 +87,8 @@ class BaseStackDecoder
   virtual void set_S_par(unsigned int S_par)=0;
   virtual void set_I_par(unsigned int I_par)=0;
   virtual void set_G_par(unsigned int G_par);
+  virtual void set_nt_par(unsigned int nt_par);
+      // Sets the number of threads used to expand hypotheses
   virtual void set_breadthFirst(bool b)=0;
 
       // Basic services
@@ -166,6 +168,14 @@ void BaseStackDecoder<SMT_MODEL>::set_G_par(unsigned int /*G_par*/)
 //  std::cerr<<"Warning: granularity parameter not available"<<std::endl;
 }
 
+//---------------------------------------
+template<class SMT_MODEL>
+void BaseStackDecoder<SMT_MODEL>::set_nt_par(unsigned int nt_par)
+{
+  if(nt_par>1)
+    std::cerr<<"Warning: parallel expansion of hypotheses not available"<<std::endl;
+}
+
 //---------------------------------------
 # ifdef THOT_STATS
 template<class SMT_MODEL>
@@ -61,6 +61,19 @@ class BaseTranslationConstraints
       // between source and target words.  The first index corresponds
       // to source word positions and the second one to target word
       // positions
+  virtual std::string getRawSrcPhrase(std::pair<PositionIndex,PositionIndex> srcPhr)const
+    {
+          // Returns the words of the source phrase srcPhr (whose
+          // positions start at 1) in the format accepted by
+          // obtainTransConstraints(), so that the constraints fully
+          // contained in srcPhr are kept. By default the constraints are
+          // not kept
+      std::vector<std::string> srcSentVec=getSrcSentVec();
+      std::vector<std::string> srcPhrVec;
+      for(PositionIndex j=srcPhr.first;j<=srcPhr.second && j<=srcSentVec.size();++j)
+        srcPhrVec.push_back(srcSentVec[j-1]);
+      return StrProcUtils::stringVectorToString(srcPhrVec);
+    }
   
   virtual void clear(void)=0;
 
@@ -0,0 +1,379 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: DecProfiler                                              */
+/*                                                                  */
+/* Definitions file: DecProfiler.cc                                 */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "DecProfiler.h"
+#include <iomanip>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#if THOT_HAVE_MALLOC_H
+#  include <malloc.h>
+#endif
+
+//--------------- Global variables -----------------------------------
+
+DEC_PROF_THREAD_LOCAL DecProfThreadState decProfThreadState;
+
+//--------------- Function definitions
+
+namespace
+{
+  const char* phaseNames[DEC_PROF_NUM_PHASES]=
+  {
+    "preprocessing",
+    "option_collection",
+    "lm_scoring",
+    "search",
+    "word_graph_output",
+    "postprocessing"
+  };
+
+  const char* counterNames[DEC_PROF_NUM_COUNTERS]=
+  {
+    "trans_opt_cache_hits",
+    "trans_opt_cache_misses",
+    "phrase_score_cache_hits",
+    "phrase_score_cache_misses",
+    "heuristic_cache_hits",
+    "heuristic_cache_misses",
+    "lm_words_scored",
+    "hyps_expanded",
+    "hyps_pushed",
+    "hyps_discarded",
+    "hyps_recombined"
+  };
+
+  //-------------------------
+  void printJsonNumber(std::ostream& outS,
+                       double value)
+  {
+        // JSON does not support infinite or NaN values
+    if(isnan(value) || isinf(value))
+      outS<<"null";
+    else
+      outS<<std::setprecision(9)<<value;
+  }
+
+  //-------------------------
+  void printHitRatio(std::ostream& outS,
+                     unsigned long long hits,
+                     unsigned long long misses)
+  {
+    if(hits+misses==0)
+      outS<<"null";
+    else
+      printJsonNumber(outS,(double)hits/(double)(hits+misses));
+  }
+}
+
+//-------------------------
+void DecProfData::clear(void)
+{
+  totalSecs=0;
+  for(unsigned int i=0;i<DEC_PROF_NUM_PHASES;++i)
+    phaseSecs[i]=0;
+  for(unsigned int i=0;i<DEC_PROF_NUM_COUNTERS;++i)
+    counters[i]=0;
+  heapBytesDelta=0;
+}
+
+//-------------------------
+void DecProfData::add(const DecProfData& profData)
+{
+  totalSecs+=profData.totalSecs;
+  for(unsigned int i=0;i<DEC_PROF_NUM_PHASES;++i)
+    phaseSecs[i]+=profData.phaseSecs[i];
+  for(unsigned int i=0;i<DEC_PROF_NUM_COUNTERS;++i)
+    counters[i]+=profData.counters[i];
+  heapBytesDelta+=profData.heapBytesDelta;
+}
+
+//-------------------------
+void DecProfData::printJson(std::ostream& outS,
+                            double divisor/*=1*/)const
+{
+  outS<<"{\"wall_secs\": ";
+  printJsonNumber(outS,totalSecs/divisor);
+
+      // Print phase times
+  outS<<", \"phase_secs\": {";
+  for(unsigned int i=0;i<DEC_PROF_NUM_PHASES;++i)
+  {
+    if(i>0) outS<<", ";
+    outS<<"\""<<phaseNames[i]<<"\": ";
+    printJsonNumber(outS,phaseSecs[i]/divisor);
+  }
+  outS<<"}";
+
+      // Print counters
+  outS<<", \"counters\": {";
+  for(unsigned int i=0;i<DEC_PROF_NUM_COUNTERS;++i)
+  {
+    if(i>0) outS<<", ";
+    outS<<"\""<<counterNames[i]<<"\": ";
+    printJsonNumber(outS,counters[i]/divisor);
+  }
+  outS<<"}";
+
+      // Print cache hit ratios
+  outS<<", \"cache_hit_ratios\": {\"trans_opts\": ";
+  printHitRatio(outS,counters[DEC_PROF_TRANS_OPT_CACHE_HITS],counters[DEC_PROF_TRANS_OPT_CACHE_MISSES]);
+  outS<<", \"phrase_scores\": ";
+  printHitRatio(outS,counters[DEC_PROF_PHR_SCR_CACHE_HITS],counters[DEC_PROF_PHR_SCR_CACHE_MISSES]);
+  outS<<", \"heuristic\": ";
+  printHitRatio(outS,counters[DEC_PROF_HEUR_CACHE_HITS],counters[DEC_PROF_HEUR_CACHE_MISSES]);
+  outS<<"}";
+
+  outS<<", \"heap_bytes_delta\": ";
+  if(DecProf::heapBytesInUse()<0)
+    outS<<"null";
+  else
+    printJsonNumber(outS,heapBytesDelta/divisor);
+  outS<<"}";
+}
+
+//-------------------------
+double DecProf::now(void)
+{
+#if defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  return (double)ts.tv_sec+(double)ts.tv_nsec*1e-9;
+#else
+  struct timeval tv;
+  gettimeofday(&tv,NULL);
+  return (double)tv.tv_sec+(double)tv.tv_usec*1e-6;
+#endif
+}
+
+//-------------------------
+long long DecProf::heapBytesInUse(void)
+{
+#if THOT_HAVE_MALLINFO2
+  struct mallinfo2 mi=mallinfo2();
+  return (long long)mi.uordblks+(long long)mi.hblkhd;
+#else
+  return -1;
+#endif
+}
+
+//-------------------------
+void DecProf::mergeIntoThread(const DecProfData& profData)
+{
+  if(decProfThreadState.enabled)
+  {
+    for(unsigned int i=0;i<DEC_PROF_NUM_PHASES;++i)
+      decProfThreadState.data.phaseSecs[i]+=profData.phaseSecs[i];
+    for(unsigned int i=0;i<DEC_PROF_NUM_COUNTERS;++i)
+      decProfThreadState.data.counters[i]+=profData.counters[i];
+  }
+}
+
+//-------------------------
+void DecProfPhaseTimer::start(DecProfPhase _phase)
+{
+  phase=_phase;
+  prevPhase=decProfThreadState.currPhase;
+  decProfThreadState.currPhase=phase;
+  startSecs=DecProf::now();
+}
+
+//-------------------------
+void DecProfPhaseTimer::stop(void)
+{
+  double elapsed=DecProf::now()-startSecs;
+  decProfThreadState.data.phaseSecs[phase]+=elapsed;
+      // Keep phase times exclusive
+  if(prevPhase!=DEC_PROF_NO_PHASE)
+    decProfThreadState.data.phaseSecs[prevPhase]-=elapsed;
+  decProfThreadState.currPhase=prevPhase;
+}
+
+//-------------------------
+DecProfRequestScope::DecProfRequestScope(DecProfStats* _statsPtr)
+{
+  statsPtr=_statsPtr;
+  owner=(statsPtr!=NULL && !decProfThreadState.inRequest);
+  active=false;
+  if(owner)
+  {
+    decProfThreadState.inRequest=true;
+    active=statsPtr->sampleRequest();
+    if(active)
+    {
+      decProfThreadState.data.clear();
+      decProfThreadState.currPhase=DEC_PROF_NO_PHASE;
+      decProfThreadState.enabled=true;
+      startHeapBytes=DecProf::heapBytesInUse();
+      startSecs=DecProf::now();
+    }
+  }
+}
+
+//-------------------------
+bool DecProfRequestScope::end(void)
+{
+  bool profiled=active;
+  if(active)
+  {
+    decProfThreadState.data.totalSecs=DecProf::now()-startSecs;
+    if(startHeapBytes>=0)
+      decProfThreadState.data.heapBytesDelta=DecProf::heapBytesInUse()-startHeapBytes;
+    decProfThreadState.enabled=false;
+    statsPtr->addSample(decProfThreadState.data);
+    active=false;
+  }
+  if(owner)
+  {
+    decProfThreadState.inRequest=false;
+    owner=false;
+  }
+  return profiled;
+}
+
+//-------------------------
+DecProfRequestScope::~DecProfRequestScope()
+{
+  end();
+}
+
+//-------------------------
+DecProfWorkerScope::DecProfWorkerScope(bool enable,
+                                       DecProfData& targetData)
+{
+  savedState=decProfThreadState;
+  targetDataPtr=&targetData;
+  decProfThreadState.enabled=enable;
+  decProfThreadState.currPhase=DEC_PROF_NO_PHASE;
+  decProfThreadState.data.clear();
+}
+
+//-------------------------
+DecProfWorkerScope::~DecProfWorkerScope()
+{
+  if(decProfThreadState.enabled)
+    targetDataPtr->add(decProfThreadState.data);
+  decProfThreadState=savedState;
+}
+
+//-------------------------
+DecProfStats::DecProfStats(void)
+{
+  pthread_mutex_init(&mut,NULL);
+  sampleRate=DEC_PROF_DEFAULT_SAMPLE_RATE;
+  clear();
+}
+
+//-------------------------
+void DecProfStats::setSampleRate(unsigned int _sampleRate)
+{
+  pthread_mutex_lock(&mut);
+  sampleRate=_sampleRate;
+  pthread_mutex_unlock(&mut);
+}
+
+//-------------------------
+unsigned int DecProfStats::getSampleRate(void)
+{
+  pthread_mutex_lock(&mut);
+  unsigned int result=sampleRate;
+  pthread_mutex_unlock(&mut);
+  return result;
+}
+
+//-------------------------
+bool DecProfStats::sampleRequest(void)
+{
+  pthread_mutex_lock(&mut);
+  bool sampled=(sampleRate>0 && numRequests%sampleRate==0);
+  ++numRequests;
+  pthread_mutex_unlock(&mut);
+  return sampled;
+}
+
+//-------------------------
+void DecProfStats::addSample(const DecProfData& profData)
+{
+  pthread_mutex_lock(&mut);
+  totalData.add(profData);
+  lastData=profData;
+  if(numSamples==0 || profData.totalSecs>maxTotalSecs)
+    maxTotalSecs=profData.totalSecs;
+  ++numSamples;
+  pthread_mutex_unlock(&mut);
+}
+
+//-------------------------
+bool DecProfStats::getLastSample(DecProfData& profData)
+{
+  pthread_mutex_lock(&mut);
+  bool ret=(numSamples>0);
+  if(ret)
+    profData=lastData;
+  pthread_mutex_unlock(&mut);
+  return ret;
+}
+
+//-------------------------
+void DecProfStats::printJson(std::ostream& outS)
+{
+  pthread_mutex_lock(&mut);
+  outS<<"{\"sample_rate\": "<<sampleRate;
+  outS<<", \"requests\": "<<numRequests;
+  outS<<", \"sampled_requests\": "<<numSamples;
+  outS<<", \"total\": ";
+  totalData.printJson(outS);
+  outS<<", \"mean\": ";
+  if(numSamples==0)
+    outS<<"null";
+  else
+    totalData.printJson(outS,numSamples);
+  outS<<", \"max_wall_secs\": ";
+  printJsonNumber(outS,maxTotalSecs);
+  outS<<"}";
+  pthread_mutex_unlock(&mut);
+}
+
+//-------------------------
+void DecProfStats::clear(void)
+{
+  pthread_mutex_lock(&mut);
+  numRequests=0;
+  numSamples=0;
+  totalData.clear();
+  lastData.clear();
+  maxTotalSecs=0;
+  pthread_mutex_unlock(&mut);
+}
+
+//-------------------------
+DecProfStats::~DecProfStats()
+{
+  pthread_mutex_destroy(&mut);
+}
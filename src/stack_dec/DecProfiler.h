@@ -0,0 +1,327 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: DecProfiler                                              */
+/*                                                                  */
+/* Prototype file: DecProfiler.h                                    */
+/*                                                                  */
+/* Description: Runtime instrumentation of the decoder. The wall    */
+/*              time of the phases of each translation request and  */
+/*              a set of search counters are collected in           */
+/*              thread-local storage.                               */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file DecProfiler.h
+ *
+ * @brief Runtime instrumentation of the decoder. The wall time of the
+ * phases of each translation request and a set of search counters are
+ * collected in thread-local storage.
+ */
+
+#ifndef _DecProfiler_h
+#define _DecProfiler_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ErrorDefs.h"
+#include <pthread.h>
+#include <iostream>
+#include <string>
+
+//--------------- Constants ------------------------------------------
+
+#define DEC_PROF_DEFAULT_SAMPLE_RATE    0 // Profiling is disabled by default
+
+#define DEC_PROF_NO_PHASE              -1
+
+#if defined(__GNUC__)
+#  define DEC_PROF_THREAD_LOCAL __thread
+#else
+#  define DEC_PROF_THREAD_LOCAL thread_local
+#endif
+
+// Phases of a translation request. The time of each phase is
+// exclusive, i.e. the time spent in a phase that is started while
+// another one is being timed is only added to the inner phase
+enum DecProfPhase
+{
+  DEC_PROF_PREPROC=0,           // Pre-processing of the input and
+                                // preparation of the models for the
+                                // sentence
+  DEC_PROF_OPT_COLLECTION,      // Retrieval and scoring of the
+                                // translation options of source
+                                // phrases
+  DEC_PROF_LM_SCORING,          // Language model scoring
+  DEC_PROF_SEARCH,              // Search
+  DEC_PROF_WG_OUTPUT,           // Pruning, printing and n-best
+                                // extraction of word graphs
+  DEC_PROF_POSTPROC,            // Generation of the output and
+                                // post-processing
+  DEC_PROF_NUM_PHASES
+};
+
+// Counters
+enum DecProfCounter
+{
+  DEC_PROF_TRANS_OPT_CACHE_HITS=0,
+  DEC_PROF_TRANS_OPT_CACHE_MISSES,
+  DEC_PROF_PHR_SCR_CACHE_HITS,
+  DEC_PROF_PHR_SCR_CACHE_MISSES,
+  DEC_PROF_HEUR_CACHE_HITS,
+  DEC_PROF_HEUR_CACHE_MISSES,
+  DEC_PROF_LM_WORDS_SCORED,
+  DEC_PROF_HYPS_EXPANDED,
+  DEC_PROF_HYPS_PUSHED,
+  DEC_PROF_HYPS_DISCARDED,      // Push operations that did not insert
+                                // the hypothesis (pruning or
+                                // recombination)
+  DEC_PROF_HYPS_RECOMBINED,
+  DEC_PROF_NUM_COUNTERS
+};
+
+//--------------- Structs --------------------------------------------
+
+/**
+ * @brief Data collected for one or more translation requests. The
+ * struct has no constructor so that it can be stored in thread-local
+ * variables, clear() should be called before using it.
+ */
+struct DecProfData
+{
+  double totalSecs;
+  double phaseSecs[DEC_PROF_NUM_PHASES];
+  unsigned long long counters[DEC_PROF_NUM_COUNTERS];
+  long long heapBytesDelta;     // Variation of the bytes allocated in
+                                // the heap of the process, it is only
+                                // meaningful when requests are not
+                                // executed concurrently
+
+  void clear(void);
+  void add(const DecProfData& profData);
+      // Adds the times and counters of profData
+  void printJson(std::ostream& outS,
+                 double divisor=1)const;
+      // Prints the data as a JSON object, dividing the times and
+      // counters by divisor
+};
+
+struct DecProfThreadState
+{
+  bool enabled;                 // Data is being collected in the
+                                // current thread
+  bool inRequest;               // A request scope is open in the
+                                // current thread
+  int currPhase;                // Phase being timed
+  DecProfData data;
+};
+
+//--------------- Global variables -----------------------------------
+
+extern DEC_PROF_THREAD_LOCAL DecProfThreadState decProfThreadState;
+
+//--------------- Function declarations ------------------------------
+
+namespace DecProf
+{
+  inline bool enabled(void)
+  {
+    return decProfThreadState.enabled;
+  }
+  inline void count(DecProfCounter counter,
+                    unsigned long long n=1)
+  {
+    if(decProfThreadState.enabled)
+      decProfThreadState.data.counters[counter]+=n;
+  }
+  double now(void);
+      // Returns the value of a monotonic clock in seconds
+  long long heapBytesInUse(void);
+      // Returns the number of bytes allocated in the heap of the
+      // process, or -1 if this information is not available
+  void mergeIntoThread(const DecProfData& profData);
+      // Adds the phase times and counters of profData to the data of
+      // the current thread
+}
+
+//--------------- Classes --------------------------------------------
+
+class DecProfStats;
+
+//--------------- DecProfPhaseTimer class
+
+/**
+ * @brief Adds the wall time elapsed between the construction and the
+ * destruction of the object to the given phase. Nothing is done if the
+ * current thread is not collecting data.
+ */
+class DecProfPhaseTimer
+{
+ public:
+
+      // Constructor
+  DecProfPhaseTimer(DecProfPhase _phase)
+    {
+      active=decProfThreadState.enabled;
+      if(active)
+        start(_phase);
+    }
+
+      // Destructor
+  ~DecProfPhaseTimer()
+    {
+      if(active)
+        stop();
+    }
+
+ private:
+
+  bool active;
+  int phase;
+  int prevPhase;
+  double startSecs;
+
+  void start(DecProfPhase _phase);
+  void stop(void);
+
+      // Copies are not allowed
+  DecProfPhaseTimer(const DecProfPhaseTimer&);
+  void operator=(const DecProfPhaseTimer&);
+};
+
+//--------------- DecProfRequestScope class
+
+/**
+ * @brief Delimits a translation request. If the request is chosen by
+ * the sampling policy of the given statistics, the data of the current
+ * thread is collected while the object exists and then added to the
+ * statistics. Scopes opened inside another scope of the same thread
+ * have no effect.
+ */
+class DecProfRequestScope
+{
+ public:
+
+      // Constructor
+  DecProfRequestScope(DecProfStats* _statsPtr);
+
+  bool end(void);
+      // Ends the scope before the destruction of the object, returns
+      // true if the request was profiled
+
+      // Destructor
+  ~DecProfRequestScope();
+
+ private:
+
+  bool owner;
+  bool active;
+  DecProfStats* statsPtr;
+  double startSecs;
+  long long startHeapBytes;
+
+      // Copies are not allowed
+  DecProfRequestScope(const DecProfRequestScope&);
+  void operator=(const DecProfRequestScope&);
+};
+
+//--------------- DecProfWorkerScope class
+
+/**
+ * @brief Used by the tasks that threads other than the one of the
+ * request execute on behalf of it. If enable is true, the data
+ * collected by the current thread while the object exists is added to
+ * targetData, which can be merged into the thread of the request with
+ * DecProf::mergeIntoThread() once the tasks are finished.
+ */
+class DecProfWorkerScope
+{
+ public:
+
+      // Constructor
+  DecProfWorkerScope(bool enable,
+                     DecProfData& targetData);
+
+      // Destructor
+  ~DecProfWorkerScope();
+
+ private:
+
+  DecProfThreadState savedState;
+  DecProfData* targetDataPtr;
+
+      // Copies are not allowed
+  DecProfWorkerScope(const DecProfWorkerScope&);
+  void operator=(const DecProfWorkerScope&);
+};
+
+//--------------- DecProfStats class
+
+/**
+ * @brief Thread-safe accumulator of the data collected for the
+ * translation requests. One out of every sampleRate requests is
+ * profiled (a sample rate equal to zero disables profiling).
+ */
+class DecProfStats
+{
+ public:
+
+      // Constructor
+  DecProfStats(void);
+
+      // Sampling policy
+  void setSampleRate(unsigned int _sampleRate);
+  unsigned int getSampleRate(void);
+  bool sampleRequest(void);
+      // Registers a new request and returns true if it should be
+      // profiled
+
+      // Functions to add and retrieve data
+  void addSample(const DecProfData& profData);
+  bool getLastSample(DecProfData& profData);
+  void printJson(std::ostream& outS);
+      // Prints the number of requests, the total and mean data of the
+      // profiled requests and the maximum wall time of a request
+  void clear(void);
+
+      // Destructor
+  ~DecProfStats();
+
+ private:
+
+  pthread_mutex_t mut;
+  unsigned int sampleRate;
+  unsigned long long numRequests;
+  unsigned long long numSamples;
+  DecProfData totalData;
+  DecProfData lastData;
+  double maxTotalSecs;
+
+      // Copies are not allowed
+  DecProfStats(const DecProfStats&);
+  void operator=(const DecProfStats&);
+};
+
+#endif
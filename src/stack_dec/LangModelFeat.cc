@@ -54,6 +54,8 @@ LangModelFeat<PhrScoreInfo>::extensionScore(const std::vector<std::string>& srcS
                                             const PhrHypDataStr& newHypDataStr,
                                             Score& unweightedScore)
 {
+  DecProfPhaseTimer lmTimer(DEC_PROF_LM_SCORING);
+
       // Obtain score for hypothesis extension
   HypScoreInfo hypScrInf=predHypScrInf;
   unweightedScore=0;
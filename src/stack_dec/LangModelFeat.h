@@ -51,6 +51,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "WordPredictor.h"
 #include "PhraseBasedTmHypRec.h"
 #include "BasePbTransModelFeature.h"
+#include "DecProfiler.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -141,6 +142,7 @@ template<class SCORE_INFO>
 Score LangModelFeat<SCORE_INFO>::scorePhrasePairUnweighted(const std::vector<std::string>& /*srcPhrase*/,
                                                            const std::vector<std::string>& trgPhrase)
 {
+  DecProfPhaseTimer lmTimer(DEC_PROF_LM_SCORING);
   std::vector<WordIndex> hist;
   LM_State state;    
   lModelPtr->getStateForWordSeq(hist,state);
@@ -276,6 +278,7 @@ Score LangModelFeat<SCORE_INFO>::getNgramScoreGivenState(std::vector<std::string
         // Score not present in cache table
   std::vector<WordIndex> trgPhraseIdx;
   Score result=0;
+  DecProf::count(DEC_PROF_LM_WORDS_SCORED,trgphrase.size());
 
       // trgPhraseIdx stores the target sentence using indices of the language model
   for(unsigned int i=0;i<trgphrase.size();++i)
@@ -283,16 +286,27 @@ Score LangModelFeat<SCORE_INFO>::getNgramScoreGivenState(std::vector<std::string
     trgPhraseIdx.push_back(this->stringToWordIndex(trgphrase[i]));
   }
       
+#ifdef WORK_WITH_ZERO_GRAM_PROB
   for(unsigned int i=0;i<trgPhraseIdx.size();++i)
   {
-#ifdef WORK_WITH_ZERO_GRAM_PROB
       Score scr=this->lModelPtr->getZeroGramProb();
-#else
-      Score scr=this->lModelPtr->getNgramLgProbGivenState(trgPhraseIdx[i],lmHist);
-#endif
           // Increase score
       result+=scr;
   }
+#else
+  if(trgPhraseIdx.empty())
+    return result;
+
+      // Score all the words of the phrase with a single query
+  std::vector<LgProb> lgProbVec;
+  this->lModelPtr->getWordSeqLgProbGivenState(trgPhraseIdx,lmHist,lgProbVec);
+  for(unsigned int i=0;i<lgProbVec.size();++i)
+  {
+    Score scr=lgProbVec[i];
+        // Increase score
+    result+=scr;
+  }
+#endif
       // Return result
   return result;
 }
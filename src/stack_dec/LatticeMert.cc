@@ -0,0 +1,344 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: LatticeMert                                              */
+/*                                                                  */
+/* Definitions file: LatticeMert.cc                                 */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "LatticeMert.h"
+
+//--------------- LatticeMert class functions
+
+//---------------------------------------
+LatticeMert::LatticeMert(void)
+{
+  numThreads=1;
+  numRandomDirs=LATTICE_MERT_DEFAULT_NUM_RANDOM_DIRS;
+  maxIters=LATTICE_MERT_DEFAULT_MAX_ITERS;
+}
+
+//---------------------------------------
+void LatticeMert::setNumThreads(unsigned int _numThreads)
+{
+  if(_numThreads==0)
+    numThreads=1;
+  else
+    numThreads=_numThreads;
+}
+
+//---------------------------------------
+void LatticeMert::setNumRandomDirs(unsigned int _numRandomDirs)
+{
+  numRandomDirs=_numRandomDirs;
+}
+
+//---------------------------------------
+void LatticeMert::setMaxIters(unsigned int _maxIters)
+{
+  maxIters=_maxIters;
+}
+
+//---------------------------------------
+void LatticeMert::optimize(const std::vector<std::string>& refSentVec,
+                           const std::vector<std::vector<const MertLattice*> >& latticePtrVecs,
+                           const std::vector<bool>& includeVarBool,
+                           const std::vector<double>& currWeightsVec,
+                           std::vector<double>& newWeightsVec,
+                           double& quality,
+                           int verbose/*=0*/)
+{
+  std::vector<std::vector<std::string> > refTokVec;
+  tokenizeRefs(refSentVec,refTokVec);
+  initThreadPool();
+
+      // Obtain indices of the weights being tuned
+  std::vector<unsigned int> includedIdxVec;
+  for(unsigned int k=0;k<currWeightsVec.size();++k)
+  {
+    if(k>=includeVarBool.size() || includeVarBool[k])
+      includedIdxVec.push_back(k);
+  }
+
+      // Obtain quality of the initial weights
+  newWeightsVec=currWeightsVec;
+  std::vector<double> zeroDirVec(newWeightsVec.size(),0);
+  double gamma;
+  double bestQuality;
+  lineSearch(refTokVec,latticePtrVecs,newWeightsVec,zeroDirVec,gamma,bestQuality,quality);
+  if(verbose)
+    std::cerr<<"Lattice MERT, initial quality: "<<quality<<std::endl;
+  if(includedIdxVec.empty())
+    return;
+
+      // Random directions are the same for each call to the function
+  srand(LATTICE_MERT_RANDOM_SEED);
+
+  for(unsigned int iter=0;iter<maxIters;++iter)
+  {
+        // Obtain search directions
+    std::vector<std::vector<double> > dirVecs;
+    for(unsigned int i=0;i<includedIdxVec.size();++i)
+    {
+      dirVecs.push_back(zeroDirVec);
+      dirVecs.back()[includedIdxVec[i]]=1;
+    }
+    for(unsigned int i=0;i<numRandomDirs;++i)
+    {
+      std::vector<double> dirVec=zeroDirVec;
+      double norm=0;
+      for(unsigned int j=0;j<includedIdxVec.size();++j)
+      {
+        dirVec[includedIdxVec[j]]=2*((double)rand()/RAND_MAX)-1;
+        norm+=dirVec[includedIdxVec[j]]*dirVec[includedIdxVec[j]];
+      }
+      if(norm>0)
+      {
+        norm=sqrt(norm);
+        for(unsigned int j=0;j<includedIdxVec.size();++j)
+          dirVec[includedIdxVec[j]]/=norm;
+        dirVecs.push_back(dirVec);
+      }
+    }
+
+        // Perform line searches
+    bool improved=false;
+    for(unsigned int i=0;i<dirVecs.size();++i)
+    {
+      double zeroQuality;
+      lineSearch(refTokVec,latticePtrVecs,newWeightsVec,dirVecs[i],gamma,bestQuality,zeroQuality);
+      if(gamma!=0 && bestQuality>quality+LATTICE_MERT_MIN_IMPROVEMENT)
+      {
+        for(unsigned int k=0;k<newWeightsVec.size();++k)
+          newWeightsVec[k]+=gamma*dirVecs[i][k];
+        quality=bestQuality;
+        improved=true;
+      }
+    }
+    if(verbose)
+      std::cerr<<"Lattice MERT, iteration "<<iter<<", quality: "<<quality<<std::endl;
+    if(!improved)
+      break;
+  }
+}
+
+//---------------------------------------
+double LatticeMert::obtainQuality(const std::vector<std::string>& refSentVec,
+                                  const std::vector<std::vector<const MertLattice*> >& latticePtrVecs,
+                                  const std::vector<double>& weightVec)
+{
+  std::vector<std::vector<std::string> > refTokVec;
+  tokenizeRefs(refSentVec,refTokVec);
+  initThreadPool();
+
+  std::vector<double> zeroDirVec(weightVec.size(),0);
+  double gamma;
+  double bestQuality;
+  double zeroQuality;
+  lineSearch(refTokVec,latticePtrVecs,weightVec,zeroDirVec,gamma,bestQuality,zeroQuality);
+  return zeroQuality;
+}
+
+//---------------------------------------
+void LatticeMert::lineSearch(const std::vector<std::string>& refSentVec,
+                             const std::vector<std::vector<const MertLattice*> >& latticePtrVecs,
+                             const std::vector<double>& weightVec,
+                             const std::vector<double>& dirVec,
+                             double& gamma,
+                             double& bestQuality,
+                             double& zeroQuality)
+{
+  std::vector<std::vector<std::string> > refTokVec;
+  tokenizeRefs(refSentVec,refTokVec);
+  initThreadPool();
+  lineSearch(refTokVec,latticePtrVecs,weightVec,dirVec,gamma,bestQuality,zeroQuality);
+}
+
+//---------------------------------------
+void LatticeMert::lineSearch(const std::vector<std::vector<std::string> >& refTokVec,
+                             const std::vector<std::vector<const MertLattice*> >& latticePtrVecs,
+                             const std::vector<double>& weightVec,
+                             const std::vector<double>& dirVec,
+                             double& gamma,
+                             double& bestQuality,
+                             double& zeroQuality)
+{
+      // Obtain upper envelopes of each sentence
+  LineSearchData lsData;
+  lsData.latticeMertPtr=this;
+  lsData.refTokVecPtr=&refTokVec;
+  lsData.latticePtrVecsPtr=&latticePtrVecs;
+  lsData.weightVecPtr=&weightVec;
+  lsData.dirVecPtr=&dirVec;
+  lsData.xVecs.resize(refTokVec.size());
+  lsData.statsVecs.resize(refTokVec.size());
+  if(numThreads==1)
+  {
+    for(unsigned int i=0;i<refTokVec.size();++i)
+      lineSearchTask((void*)&lsData,i,0);
+  }
+  else
+    threadPool.run(lineSearchTask,(void*)&lsData,refTokVec.size());
+
+      // Sort the points where the best path of some sentence changes
+  std::vector<std::pair<double,std::pair<unsigned int,unsigned int> > > changeVec;
+  std::vector<unsigned int> totalStats(miraBleu.getNumStats(),0);
+  for(unsigned int i=0;i<lsData.xVecs.size();++i)
+  {
+    for(unsigned int k=0;k<totalStats.size();++k)
+      totalStats[k]+=lsData.statsVecs[i][0][k];
+    for(unsigned int j=1;j<lsData.xVecs[i].size();++j)
+      changeVec.push_back(std::make_pair(lsData.xVecs[i][j],std::make_pair(i,j)));
+  }
+  std::sort(changeVec.begin(),changeVec.end());
+
+      // Sweep the intervals in which corpus BLEU is constant
+  double leftX=-HUGE_VAL;
+  double bestLeftX=0;
+  double bestRightX=0;
+  bool bestContainsZero=false;
+  bestQuality=-HUGE_VAL;
+  zeroQuality=-HUGE_VAL;
+  unsigned int changeIdx=0;
+  while(true)
+  {
+    double rightX=(changeIdx<changeVec.size())? changeVec[changeIdx].first: HUGE_VAL;
+    double intervalQuality=miraBleu.scoreFromStats(totalStats);
+    bool containsZero=(leftX<=0 && 0<rightX);
+    if(containsZero)
+      zeroQuality=intervalQuality;
+    if(intervalQuality>bestQuality ||
+       (containsZero && intervalQuality>=bestQuality))
+    {
+      bestQuality=intervalQuality;
+      bestLeftX=leftX;
+      bestRightX=rightX;
+      bestContainsZero=containsZero;
+    }
+    if(changeIdx==changeVec.size())
+      break;
+
+        // Update statistics of the sentences changing at rightX
+    for(;changeIdx<changeVec.size() && changeVec[changeIdx].first==rightX;++changeIdx)
+    {
+      unsigned int sentIdx=changeVec[changeIdx].second.first;
+      unsigned int lineIdx=changeVec[changeIdx].second.second;
+      const std::vector<unsigned int>& prevStats=lsData.statsVecs[sentIdx][lineIdx-1];
+      const std::vector<unsigned int>& stats=lsData.statsVecs[sentIdx][lineIdx];
+      for(unsigned int k=0;k<totalStats.size();++k)
+        totalStats[k]=totalStats[k]-prevStats[k]+stats[k];
+    }
+    leftX=rightX;
+  }
+
+      // Obtain step within the best interval
+  if(bestContainsZero)
+    gamma=0;
+  else if(bestLeftX==-HUGE_VAL)
+    gamma=bestRightX-LATTICE_MERT_OPEN_INTERVAL_STEP;
+  else if(bestRightX==HUGE_VAL)
+    gamma=bestLeftX+LATTICE_MERT_OPEN_INTERVAL_STEP;
+  else
+    gamma=(bestLeftX+bestRightX)/2;
+}
+
+//---------------------------------------
+void LatticeMert::lineSearchTask(void* taskData,
+                                 unsigned int taskIdx,
+                                 unsigned int /*workerIdx*/)
+{
+  LineSearchData* lsDataPtr=(LineSearchData*) taskData;
+  std::vector<const MertLattice*> emptyLatticePtrVec;
+  const std::vector<const MertLattice*>& latticePtrVec=(taskIdx<lsDataPtr->latticePtrVecsPtr->size())?
+    (*lsDataPtr->latticePtrVecsPtr)[taskIdx]: emptyLatticePtrVec;
+  lsDataPtr->latticeMertPtr->sentenceEnvelope((*lsDataPtr->refTokVecPtr)[taskIdx],
+                                              latticePtrVec,
+                                              *lsDataPtr->weightVecPtr,
+                                              *lsDataPtr->dirVecPtr,
+                                              lsDataPtr->xVecs[taskIdx],
+                                              lsDataPtr->statsVecs[taskIdx]);
+}
+
+//---------------------------------------
+void LatticeMert::sentenceEnvelope(const std::vector<std::string>& refTok,
+                                   const std::vector<const MertLattice*>& latticePtrVec,
+                                   const std::vector<double>& weightVec,
+                                   const std::vector<double>& dirVec,
+                                   std::vector<double>& xVec,
+                                   std::vector<std::vector<unsigned int> >& statsVec)const
+{
+  xVec.clear();
+  statsVec.clear();
+
+      // Merge the envelopes of the lattices of the sentence
+  std::vector<MertLattice::EnvelopeLine> envelope;
+  std::vector<std::vector<std::string> > hypVec;
+  for(unsigned int i=0;i<latticePtrVec.size();++i)
+  {
+    std::vector<MertLattice::EnvelopeLine> latticeEnvelope;
+    std::vector<std::vector<std::string> > latticeHypVec;
+    latticePtrVec[i]->obtainEnvelope(weightVec,dirVec,latticeEnvelope,latticeHypVec);
+    for(unsigned int j=0;j<latticeEnvelope.size();++j)
+    {
+      latticeEnvelope[j].idx+=hypVec.size();
+      envelope.push_back(latticeEnvelope[j]);
+    }
+    hypVec.insert(hypVec.end(),latticeHypVec.begin(),latticeHypVec.end());
+  }
+  MertLattice::upperEnvelope(envelope);
+
+      // Obtain statistics of each interval, sentences without
+      // translations are scored as empty hypotheses
+  if(envelope.empty())
+  {
+    xVec.push_back(-HUGE_VAL);
+    statsVec.push_back(std::vector<unsigned int>());
+    miraBleu.statsForSentence(std::vector<std::string>(),refTok,statsVec.back());
+  }
+  else
+  {
+    for(unsigned int i=0;i<envelope.size();++i)
+    {
+      xVec.push_back(envelope[i].x);
+      statsVec.push_back(std::vector<unsigned int>());
+      miraBleu.statsForSentence(hypVec[envelope[i].idx],refTok,statsVec.back());
+    }
+  }
+}
+
+//---------------------------------------
+void LatticeMert::tokenizeRefs(const std::vector<std::string>& refSentVec,
+                               std::vector<std::vector<std::string> >& refTokVec)const
+{
+  refTokVec.clear();
+  for(unsigned int i=0;i<refSentVec.size();++i)
+    refTokVec.push_back(StrProcUtils::stringToStringVector(refSentVec[i]));
+}
+
+//---------------------------------------
+void LatticeMert::initThreadPool(void)
+{
+  if(numThreads>1 && threadPool.getNumWorkers()!=numThreads)
+    threadPool.init(numThreads);
+}
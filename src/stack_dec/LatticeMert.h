@@ -0,0 +1,163 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: LatticeMert                                              */
+/*                                                                  */
+/* Prototype file: LatticeMert.h                                    */
+/*                                                                  */
+/* Description: Declares the LatticeMert class, which tunes the     */
+/*              weights of a log-linear model by means of lattice   */
+/*              minimum error rate training.                        */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file LatticeMert.h
+ *
+ * @brief Declares the LatticeMert class, which tunes the weights of a
+ * log-linear model by means of lattice minimum error rate training.
+ */
+
+#ifndef _LatticeMert_h
+#define _LatticeMert_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "MertLattice.h"
+#include "MiraBleu.h"
+#include "ThreadPool.h"
+#include "StrProcUtils.h"
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define LATTICE_MERT_DEFAULT_NUM_RANDOM_DIRS  10
+#define LATTICE_MERT_DEFAULT_MAX_ITERS        20
+#define LATTICE_MERT_RANDOM_SEED              31415
+#define LATTICE_MERT_MIN_IMPROVEMENT          1e-6
+#define LATTICE_MERT_OPEN_INTERVAL_STEP       0.1
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LatticeMert class
+
+/**
+ * @brief Minimum error rate training over lattices. Each iteration
+ * performs exact line searches along the coordinate axes of the
+ * weights being tuned and along a set of random directions. The line
+ * searches merge the upper envelopes of the lattices of each sentence
+ * and maximize corpus BLEU, computed from the sufficient statistics
+ * of MiraBleu. Sentences are processed in parallel.
+ */
+
+class LatticeMert
+{
+ public:
+
+      // Constructor
+  LatticeMert(void);
+
+      // Functions to set parameters
+  void setNumThreads(unsigned int _numThreads);
+  void setNumRandomDirs(unsigned int _numRandomDirs);
+  void setMaxIters(unsigned int _maxIters);
+
+      // Functions to tune weights
+  void optimize(const std::vector<std::string>& refSentVec,
+                const std::vector<std::vector<const MertLattice*> >& latticePtrVecs,
+                const std::vector<bool>& includeVarBool,
+                const std::vector<double>& currWeightsVec,
+                std::vector<double>& newWeightsVec,
+                double& quality,
+                int verbose=0);
+      // Obtains new weights given the lattices of each sentence of the
+      // development corpus. Weights whose entry in includeVarBool is
+      // false are not modified. quality is the corpus BLEU of the new
+      // weights
+  double obtainQuality(const std::vector<std::string>& refSentVec,
+                       const std::vector<std::vector<const MertLattice*> >& latticePtrVecs,
+                       const std::vector<double>& weightVec);
+      // Returns the corpus BLEU of the best paths of the lattices
+      // given weightVec
+  void lineSearch(const std::vector<std::string>& refSentVec,
+                  const std::vector<std::vector<const MertLattice*> >& latticePtrVecs,
+                  const std::vector<double>& weightVec,
+                  const std::vector<double>& dirVec,
+                  double& gamma,
+                  double& bestQuality,
+                  double& zeroQuality);
+      // Obtains the step gamma along dirVec that maximizes the corpus
+      // BLEU of the best paths of the lattices, bestQuality. gamma is
+      // zero if weightVec is optimal, otherwise it is the middle of the
+      // best interval (or is LATTICE_MERT_OPEN_INTERVAL_STEP away from
+      // its finite end). zeroQuality is the corpus BLEU of weightVec
+
+ private:
+
+      // Data shared by the line search tasks
+  struct LineSearchData
+  {
+    const LatticeMert* latticeMertPtr;
+    const std::vector<std::vector<std::string> >* refTokVecPtr;
+    const std::vector<std::vector<const MertLattice*> >* latticePtrVecsPtr;
+    const std::vector<double>* weightVecPtr;
+    const std::vector<double>* dirVecPtr;
+        // Output of each sentence: left ends of the intervals of the
+        // upper envelope and BLEU statistics of each interval
+    std::vector<std::vector<double> > xVecs;
+    std::vector<std::vector<std::vector<unsigned int> > > statsVecs;
+  };
+
+  MiraBleu miraBleu;
+  unsigned int numThreads;
+  unsigned int numRandomDirs;
+  unsigned int maxIters;
+  ThreadPool threadPool;
+
+  void lineSearch(const std::vector<std::vector<std::string> >& refTokVec,
+                  const std::vector<std::vector<const MertLattice*> >& latticePtrVecs,
+                  const std::vector<double>& weightVec,
+                  const std::vector<double>& dirVec,
+                  double& gamma,
+                  double& bestQuality,
+                  double& zeroQuality);
+      // Obtains the step gamma along dirVec that maximizes corpus BLEU,
+      // zeroQuality is the corpus BLEU of weightVec
+  static void lineSearchTask(void* taskData,
+                             unsigned int taskIdx,
+                             unsigned int workerIdx);
+  void sentenceEnvelope(const std::vector<std::string>& refTok,
+                        const std::vector<const MertLattice*>& latticePtrVec,
+                        const std::vector<double>& weightVec,
+                        const std::vector<double>& dirVec,
+                        std::vector<double>& xVec,
+                        std::vector<std::vector<unsigned int> >& statsVec)const;
+  void tokenizeRefs(const std::vector<std::string>& refSentVec,
+                    std::vector<std::vector<std::string> >& refTokVec)const;
+  void initThreadPool(void);
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+#ifndef _LlWeightTuningPars_h
+#define _LlWeightTuningPars_h
+
+//--------------- Include files --------------------------------------
+
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define LLWT_DEFAULT_NBEST_SIZE         100
+#define LLWT_DEFAULT_MAX_ITERS          12
+#define LLWT_DEFAULT_TRUST_RADIUS       0.05
+#define LLWT_LONGEST_DECR_STREAK        4
+
+//--------------- LlWeightTuningPars class
+
+class LlWeightTuningPars
+{
+ public:
+
+  unsigned int nbestSize;
+  unsigned int maxIters;
+  unsigned int numWorkers;
+  float trustRadius;
+      // Decoding is repeated only if the relative distance between
+      // the new weights and those used in the last decoding is greater
+      // than trustRadius
+  std::vector<bool> includeVarBool;
+      // Weights that are not included are set to zero, all of them
+      // are included if the vector is empty
+  bool latticeMert;
+      // Weights are tuned by means of lattice MERT over the word graphs
+      // of the development corpus instead of using n-best lists
+  
+  LlWeightTuningPars()
+  {
+    default_values();
+  }
+
+  void default_values(void)
+  {
+    nbestSize=LLWT_DEFAULT_NBEST_SIZE;
+    maxIters=LLWT_DEFAULT_MAX_ITERS;
+    numWorkers=1;
+    trustRadius=LLWT_DEFAULT_TRUST_RADIUS;
+    includeVarBool.clear();
+    latticeMert=false;
+  }
+};
+
+#endif
@@ -0,0 +1,285 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: MertLattice                                              */
+/*                                                                  */
+/* Definitions file: MertLattice.cc                                 */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "MertLattice.h"
+
+//--------------- MertLattice class functions
+
+//---------------------------------------
+MertLattice::MertLattice(void)
+{
+  clear();
+}
+
+//---------------------------------------
+void MertLattice::build(const WordGraph& wg)
+{
+  clear();
+  if(wg.empty())
+    return;
+
+      // Obtain states reachable from the initial state
+  size_t wgNumStates=wg.getHypStateIndexRange().second+1;
+  std::vector<bool> reachableVec(wgNumStates,false);
+  std::vector<HypStateIndex> pendingVec;
+  std::vector<WordGraphArcId> wgArcIds;
+  reachableVec[INITIAL_STATE]=true;
+  pendingVec.push_back(INITIAL_STATE);
+  while(!pendingVec.empty())
+  {
+    HypStateIndex idx=pendingVec.back();
+    pendingVec.pop_back();
+    wg.getArcIdsToSuccStates(idx,wgArcIds);
+    for(unsigned int i=0;i<wgArcIds.size();++i)
+    {
+      HypStateIndex succIdx=wg.wordGraphArcId2WordGraphArc(wgArcIds[i]).succStateIndex;
+      if(!reachableVec[succIdx])
+      {
+        reachableVec[succIdx]=true;
+        pendingVec.push_back(succIdx);
+      }
+    }
+  }
+
+      // Number the reachable states in topological order
+  std::vector<unsigned int> inDegreeVec(wgNumStates,0);
+  for(HypStateIndex idx=0;idx<wgNumStates;++idx)
+  {
+    if(reachableVec[idx])
+    {
+      wg.getArcIdsToSuccStates(idx,wgArcIds);
+      for(unsigned int i=0;i<wgArcIds.size();++i)
+        ++inDegreeVec[wg.wordGraphArcId2WordGraphArc(wgArcIds[i]).succStateIndex];
+    }
+  }
+  std::vector<unsigned int> newIdxVec(wgNumStates,UINT_MAX);
+  std::vector<HypStateIndex> topolOrderVec;
+  pendingVec.push_back(INITIAL_STATE);
+  while(!pendingVec.empty())
+  {
+    HypStateIndex idx=pendingVec.back();
+    pendingVec.pop_back();
+    newIdxVec[idx]=topolOrderVec.size();
+    topolOrderVec.push_back(idx);
+    wg.getArcIdsToSuccStates(idx,wgArcIds);
+    for(unsigned int i=0;i<wgArcIds.size();++i)
+    {
+      HypStateIndex succIdx=wg.wordGraphArcId2WordGraphArc(wgArcIds[i]).succStateIndex;
+      --inDegreeVec[succIdx];
+      if(inDegreeVec[succIdx]==0)
+        pendingVec.push_back(succIdx);
+    }
+  }
+  numStates=topolOrderVec.size();
+
+      // Copy the arcs grouped by successor state
+  std::vector<std::vector<Score> > scrCompsVec;
+  for(unsigned int i=1;i<topolOrderVec.size();++i)
+  {
+    wg.getArcIdsToPredStates(topolOrderVec[i],wgArcIds);
+    for(unsigned int j=0;j<wgArcIds.size();++j)
+    {
+      WordGraphArc wgArc=wg.wordGraphArcId2WordGraphArc(wgArcIds[j]);
+      if(newIdxVec[wgArc.predStateIndex]!=UINT_MAX)
+      {
+        Arc arc;
+        arc.predState=newIdxVec[wgArc.predStateIndex];
+        arc.succState=i;
+        arc.words.swap(wgArc.words);
+        arcVec.push_back(arc);
+        scrCompsVec.push_back(std::vector<Score>());
+        wg.getArcScrComps(wgArcIds[j],scrCompsVec.back());
+        if(scrCompsVec.back().size()>numComps)
+          numComps=scrCompsVec.back().size();
+      }
+    }
+  }
+
+      // Store score components, missing components are equal to zero
+  arcScrComps.resize(arcVec.size()*numComps,0);
+  for(unsigned int i=0;i<scrCompsVec.size();++i)
+  {
+    for(unsigned int k=0;k<scrCompsVec[i].size();++k)
+      arcScrComps[i*numComps+k]=scrCompsVec[i][k];
+  }
+
+      // Obtain final states
+  WordGraph::FinalStateSet finalStateSet=wg.getFinalStateSet();
+  for(WordGraph::FinalStateSet::const_iterator iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
+  {
+    if(*iter<wgNumStates && newIdxVec[*iter]!=UINT_MAX)
+      finalStateVec.push_back(newIdxVec[*iter]);
+  }
+}
+
+//---------------------------------------
+void MertLattice::clear(void)
+{
+  numStates=0;
+  numComps=0;
+  arcVec.clear();
+  arcScrComps.clear();
+  finalStateVec.clear();
+}
+
+//---------------------------------------
+bool MertLattice::empty(void)const
+{
+  return finalStateVec.empty();
+}
+
+//---------------------------------------
+size_t MertLattice::numArcs(void)const
+{
+  return arcVec.size();
+}
+
+//---------------------------------------
+unsigned int MertLattice::getNumComps(void)const
+{
+  return numComps;
+}
+
+//---------------------------------------
+void MertLattice::obtainEnvelope(const std::vector<double>& weightVec,
+                                 const std::vector<double>& dirVec,
+                                 std::vector<EnvelopeLine>& envelope,
+                                 std::vector<std::vector<std::string> >& hypVec)const
+{
+  envelope.clear();
+  hypVec.clear();
+  if(empty())
+    return;
+
+      // Back pointers of the lines, they store the last arc of the path
+      // and the back pointer of the path of the predecessor state
+  std::vector<std::pair<unsigned int,unsigned int> > backPtrVec;
+  std::vector<std::vector<EnvelopeLine> > stateEnvVec(numStates);
+  EnvelopeLine initLine;
+  initLine.slope=0;
+  initLine.intercept=0;
+  initLine.x=-HUGE_VAL;
+  initLine.idx=0;
+  backPtrVec.push_back(std::make_pair(UINT_MAX,UINT_MAX));
+  stateEnvVec[0].push_back(initLine);
+
+      // Obtain the envelope of each state given the envelopes of its
+      // predecessors
+  unsigned int arcIdx=0;
+  while(arcIdx<arcVec.size())
+  {
+    unsigned int succState=arcVec[arcIdx].succState;
+    std::vector<EnvelopeLine>& succEnv=stateEnvVec[succState];
+    for(;arcIdx<arcVec.size() && arcVec[arcIdx].succState==succState;++arcIdx)
+    {
+      double arcSlope=0;
+      double arcIntercept=0;
+      for(unsigned int k=0;k<numComps;++k)
+      {
+        double scrComp=arcScrComps[arcIdx*numComps+k];
+        if(k<dirVec.size()) arcSlope+=dirVec[k]*scrComp;
+        if(k<weightVec.size()) arcIntercept+=weightVec[k]*scrComp;
+      }
+      const std::vector<EnvelopeLine>& predEnv=stateEnvVec[arcVec[arcIdx].predState];
+      for(unsigned int i=0;i<predEnv.size();++i)
+      {
+        EnvelopeLine line;
+        line.slope=predEnv[i].slope+arcSlope;
+        line.intercept=predEnv[i].intercept+arcIntercept;
+        line.idx=backPtrVec.size();
+        backPtrVec.push_back(std::make_pair(arcIdx,predEnv[i].idx));
+        succEnv.push_back(line);
+      }
+    }
+    upperEnvelope(succEnv);
+  }
+
+      // Obtain envelope of the complete paths
+  for(unsigned int i=0;i<finalStateVec.size();++i)
+    envelope.insert(envelope.end(),stateEnvVec[finalStateVec[i]].begin(),stateEnvVec[finalStateVec[i]].end());
+  upperEnvelope(envelope);
+
+      // Obtain the words of the paths
+  std::vector<unsigned int> pathArcVec;
+  for(unsigned int i=0;i<envelope.size();++i)
+  {
+    pathArcVec.clear();
+    for(unsigned int ptr=envelope[i].idx;backPtrVec[ptr].first!=UINT_MAX;ptr=backPtrVec[ptr].second)
+      pathArcVec.push_back(backPtrVec[ptr].first);
+    std::vector<std::string> words;
+    for(unsigned int j=pathArcVec.size();j>0;--j)
+    {
+      const std::vector<std::string>& arcWords=arcVec[pathArcVec[j-1]].words;
+      words.insert(words.end(),arcWords.begin(),arcWords.end());
+    }
+    hypVec.push_back(words);
+    envelope[i].idx=i;
+  }
+}
+
+//---------------------------------------
+void MertLattice::upperEnvelope(std::vector<EnvelopeLine>& lineVec)
+{
+  std::sort(lineVec.begin(),lineVec.end(),slopeLess);
+
+      // Lines are added by increasing slope, removing those that are
+      // not maximum in any interval
+  size_t n=0;
+  for(size_t i=0;i<lineVec.size();++i)
+  {
+    EnvelopeLine line=lineVec[i];
+    if(n>0 && lineVec[n-1].slope==line.slope)
+      --n;
+    line.x=-HUGE_VAL;
+    while(n>0)
+    {
+      line.x=(lineVec[n-1].intercept-line.intercept)/(line.slope-lineVec[n-1].slope);
+      if(line.x<=lineVec[n-1].x)
+      {
+        --n;
+        line.x=-HUGE_VAL;
+      }
+      else
+        break;
+    }
+    lineVec[n]=line;
+    ++n;
+  }
+  lineVec.resize(n);
+}
+
+//---------------------------------------
+bool MertLattice::slopeLess(const EnvelopeLine& left,
+                            const EnvelopeLine& right)
+{
+  if(left.slope!=right.slope)
+    return left.slope<right.slope;
+  else
+    return left.intercept<right.intercept;
+}
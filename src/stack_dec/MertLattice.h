@@ -0,0 +1,131 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: MertLattice                                              */
+/*                                                                  */
+/* Prototypes file: MertLattice.h                                   */
+/*                                                                  */
+/* Description: Declares the MertLattice class, a compact copy of   */
+/*              a word graph used to compute upper envelopes in     */
+/*              lattice MERT.                                       */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file MertLattice.h
+ *
+ * @brief Declares the MertLattice class, a compact copy of a word graph
+ * used to compute upper envelopes in lattice MERT.
+ */
+
+#ifndef _MertLattice_h
+#define _MertLattice_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WordGraph.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- MertLattice class
+
+/**
+ * @brief Compact copy of a word graph that only keeps the arcs
+ * reachable from the initial state, topologically ordered and with
+ * their unweighted score components. For a starting weight vector w
+ * and a direction d, the score of each path is a line
+ * w*h+gamma*(d*h), the class obtains the upper envelope of such lines
+ * by means of the algorithm described in [Macherey et al. 2008]
+ * ("Lattice-based minimum error rate training for statistical machine
+ * translation").
+ */
+
+class MertLattice
+{
+ public:
+
+  struct EnvelopeLine
+  {
+    double slope;
+    double intercept;
+    double x;
+        // Left end of the interval where the line is maximum
+    unsigned int idx;
+        // Index of the data associated to the line
+  };
+
+      // Constructor
+  MertLattice(void);
+
+      // Functions to build the lattice
+  void build(const WordGraph& wg);
+  void clear(void);
+
+      // Functions to access the lattice
+  bool empty(void)const;
+  size_t numArcs(void)const;
+  unsigned int getNumComps(void)const;
+
+      // Function to obtain upper envelopes
+  void obtainEnvelope(const std::vector<double>& weightVec,
+                      const std::vector<double>& dirVec,
+                      std::vector<EnvelopeLine>& envelope,
+                      std::vector<std::vector<std::string> >& hypVec)const;
+      // Obtains the upper envelope of the lines of the complete paths,
+      // sorted by slope. The idx field of each line is the index in
+      // hypVec of the words of its path
+  static void upperEnvelope(std::vector<EnvelopeLine>& lineVec);
+      // Replaces lineVec by its upper envelope
+
+ private:
+
+  struct Arc
+  {
+    unsigned int predState;
+    unsigned int succState;
+    std::vector<std::string> words;
+  };
+
+      // States are numbered in topological order, being zero the
+      // initial state, and arcs are grouped by successor state
+  unsigned int numStates;
+  unsigned int numComps;
+  std::vector<Arc> arcVec;
+  std::vector<double> arcScrComps;
+      // Score components of the arcs, numComps values per arc
+  std::vector<unsigned int> finalStateVec;
+
+  static bool slopeLess(const EnvelopeLine& left,
+                        const EnvelopeLine& right);
+};
+
+#endif
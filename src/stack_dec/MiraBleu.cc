@@ -25,7 +25,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- MiraBleu class functions
 
 //---------------------------------------
-double MiraBleu::scoreFromStats(std::vector<unsigned int>& stats){
+double MiraBleu::scoreFromStats(const std::vector<unsigned int>& stats)const{
   double bp;
   if (stats[0] < stats[1])
     bp = (double)exp((double)1-(double)stats[1]/stats[0]);
@@ -45,7 +45,7 @@ double MiraBleu::scoreFromStats(std::vector<unsigned int>& stats){
 //---------------------------------------
 void MiraBleu::statsForSentence(const std::vector<std::string>& candidate_tokens,
                                 const std::vector<std::string>& reference_tokens,
-                                std::vector<unsigned int>& stats)
+                                std::vector<unsigned int>& stats)const
 {
   stats.clear();
 
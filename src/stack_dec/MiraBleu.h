@@ -66,14 +66,17 @@ public:
                    const std::vector<std::string>& references,
                    double& score);
 
+    // Sufficient statistics of a sentence and score obtained from
+    // statistics accumulated over several sentences
+  void statsForSentence(const std::vector<std::string>& candidate_tokens,
+                        const std::vector<std::string>& reference_tokens,
+                        std::vector<unsigned int>& stats)const;
+  double scoreFromStats(const std::vector<unsigned int>& stats)const;
+  unsigned int getNumStats(void)const { return N_STATS; }
+
 private:
   unsigned int N_STATS;
   std::vector <double> backgroundBleu; // background corpus stats for BLEU
-
-  double scoreFromStats(std::vector<unsigned int>& stats);
-  void statsForSentence(const std::vector<std::string>& candidate_tokens,
-                        const std::vector<std::string>& reference_tokens,
-                        std::vector<unsigned int>& stats);
 };
 
 #endif
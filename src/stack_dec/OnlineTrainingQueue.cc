@@ -0,0 +1,417 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: OnlineTrainingQueue                                      */
+/*                                                                  */
+/* Definitions file: OnlineTrainingQueue.cc                         */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "OnlineTrainingQueue.h"
+#include "DecProfiler.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <iomanip>
+
+//--------------- Function definitions
+
+//-------------------------
+OnlineTrainingQueue::OnlineTrainingQueue(void)
+{
+  pthread_mutex_init(&mut,NULL);
+  pthread_cond_init(&cond,NULL);
+  pthread_mutex_init(&journalMut,NULL);
+  opened=false;
+  closed=false;
+  journalFile=NULL;
+  numJournalDoneEntries=0;
+  numEnqueued=0;
+  numTrained=0;
+  numFailed=0;
+  numBatches=0;
+  lastLagSecs=0;
+  totalLagSecs=0;
+  maxLagSecs=0;
+}
+
+//-------------------------
+int OnlineTrainingQueue::open(const std::string& _journalFileName,
+                              int verbose/*=0*/)
+{
+  pthread_mutex_lock(&journalMut);
+  pthread_mutex_lock(&mut);
+  bool alreadyOpen=(opened && !closed);
+  pthread_mutex_unlock(&mut);
+
+  int ret=THOT_OK;
+  if(alreadyOpen)
+  {
+    std::cerr<<"Error: online training queue already open"<<std::endl;
+    ret=THOT_ERROR;
+  }
+  else
+  {
+    journalFileName=_journalFileName;
+    if(!journalFileName.empty())
+    {
+          // Load pairs of previous executions and rewrite the journal
+      ret=loadJournal(verbose);
+      if(ret==THOT_OK)
+        ret=rewriteJournal();
+    }
+    if(ret==THOT_OK)
+    {
+      pthread_mutex_lock(&mut);
+      opened=true;
+      closed=false;
+      pthread_mutex_unlock(&mut);
+    }
+  }
+  pthread_mutex_unlock(&journalMut);
+  return ret;
+}
+
+//-------------------------
+bool OnlineTrainingQueue::isOpen(void)
+{
+  pthread_mutex_lock(&mut);
+  bool ret=(opened && !closed);
+  pthread_mutex_unlock(&mut);
+  return ret;
+}
+
+//-------------------------
+int OnlineTrainingQueue::loadJournal(int verbose)
+{
+  std::ifstream journalStream(journalFileName.c_str());
+  if(!journalStream)
+  {
+        // The journal does not exist yet
+    return THOT_OK;
+  }
+
+  std::deque<OnlineTrainingQueueEntry> loadedEntries;
+  unsigned int lineNum=0;
+  std::string line;
+  while(std::getline(journalStream,line))
+  {
+    ++lineNum;
+    size_t firstTab=line.find('\t');
+    if(firstTab!=std::string::npos && line.compare(0,firstTab,"done")==0)
+    {
+          // The oldest pairs were already trained
+      unsigned long numDone=strtoul(line.c_str()+firstTab+1,NULL,10);
+      if(numDone>loadedEntries.size())
+      {
+        std::cerr<<"Warning: line "<<lineNum<<" of online training journal "<<journalFileName<<" refers to more pairs than those stored"<<std::endl;
+        numDone=loadedEntries.size();
+      }
+      loadedEntries.erase(loadedEntries.begin(),loadedEntries.begin()+numDone);
+      continue;
+    }
+    size_t secondTab=(firstTab==std::string::npos)? std::string::npos : line.find('\t',firstTab+1);
+    if(secondTab==std::string::npos)
+    {
+      std::cerr<<"Warning: discarding malformed line "<<lineNum<<" of online training journal "<<journalFileName<<std::endl;
+      continue;
+    }
+    OnlineTrainingQueueEntry entry;
+    entry.user_id=atoi(line.substr(0,firstTab).c_str());
+    entry.srcSent=line.substr(firstTab+1,secondTab-firstTab-1);
+    entry.refSent=line.substr(secondTab+1);
+    entry.enqueueSecs=DecProf::now();
+    loadedEntries.push_back(entry);
+  }
+
+  pthread_mutex_lock(&mut);
+  pendingEntries.insert(pendingEntries.end(),loadedEntries.begin(),loadedEntries.end());
+  numEnqueued+=loadedEntries.size();
+  pthread_mutex_unlock(&mut);
+
+  if(verbose)
+    std::cerr<<loadedEntries.size()<<" pending sentence pairs loaded from online training journal "<<journalFileName<<std::endl;
+  return THOT_OK;
+}
+
+//-------------------------
+int OnlineTrainingQueue::appendToJournal(const OnlineTrainingQueueEntry& entry)
+{
+  if(fprintf(journalFile,"%d\t%s\t%s\n",entry.user_id,entry.srcSent.c_str(),entry.refSent.c_str())<0 ||
+     fflush(journalFile)!=0 ||
+     fsync(fileno(journalFile))!=0)
+  {
+        // The journal may contain a partial line, it will be rewritten
+        // before accepting new pairs
+    std::cerr<<"Error while writing online training journal "<<journalFileName<<std::endl;
+    fclose(journalFile);
+    journalFile=NULL;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+int OnlineTrainingQueue::appendDoneToJournal(size_t numDone)
+{
+  if(fprintf(journalFile,"done\t%lu\n",(unsigned long)numDone)<0 ||
+     fflush(journalFile)!=0 ||
+     fsync(fileno(journalFile))!=0)
+  {
+    std::cerr<<"Error while writing online training journal "<<journalFileName<<std::endl;
+    fclose(journalFile);
+    journalFile=NULL;
+    return THOT_ERROR;
+  }
+  numJournalDoneEntries+=numDone;
+  return THOT_OK;
+}
+
+//-------------------------
+int OnlineTrainingQueue::rewriteJournal(void)
+{
+  if(journalFileName.empty())
+    return THOT_OK;
+
+  if(journalFile!=NULL)
+  {
+    fclose(journalFile);
+    journalFile=NULL;
+  }
+
+      // Take the pairs that have not been trained, the journal cannot
+      // change meanwhile since the caller holds journalMut
+  std::vector<OnlineTrainingQueueEntry> entries;
+  pthread_mutex_lock(&mut);
+  entries.reserve(entriesInProgress.size()+pendingEntries.size());
+  entries.insert(entries.end(),entriesInProgress.begin(),entriesInProgress.end());
+  entries.insert(entries.end(),pendingEntries.begin(),pendingEntries.end());
+  pthread_mutex_unlock(&mut);
+
+      // Write them to a temporary file, which replaces the journal once
+      // it is complete
+  std::string tmpFileName=journalFileName+".tmp";
+  FILE* tmpFile=fopen(tmpFileName.c_str(),"w");
+  if(tmpFile==NULL)
+  {
+    std::cerr<<"Error while opening file "<<tmpFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  bool error=false;
+  for(std::vector<OnlineTrainingQueueEntry>::const_iterator iter=entries.begin();iter!=entries.end();++iter)
+  {
+    if(fprintf(tmpFile,"%d\t%s\t%s\n",iter->user_id,iter->srcSent.c_str(),iter->refSent.c_str())<0)
+    {
+      error=true;
+      break;
+    }
+  }
+  if(fflush(tmpFile)!=0 || fsync(fileno(tmpFile))!=0)
+    error=true;
+  fclose(tmpFile);
+  if(error || rename(tmpFileName.c_str(),journalFileName.c_str())!=0)
+  {
+    std::cerr<<"Error while writing online training journal "<<journalFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Reopen journal to append new pairs
+  journalFile=fopen(journalFileName.c_str(),"a");
+  if(journalFile==NULL)
+  {
+    std::cerr<<"Error while opening online training journal "<<journalFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  numJournalDoneEntries=0;
+  return THOT_OK;
+}
+
+//-------------------------
+std::string OnlineTrainingQueue::sanitize(const std::string& sent)
+{
+      // Tabs and line breaks are used as separators in the journal
+  std::string result=sent;
+  for(unsigned int i=0;i<result.size();++i)
+  {
+    if(result[i]=='\t' || result[i]=='\n' || result[i]=='\r')
+      result[i]=' ';
+  }
+  return result;
+}
+
+//-------------------------
+int OnlineTrainingQueue::push(int user_id,
+                              const std::string& srcSent,
+                              const std::string& refSent)
+{
+  OnlineTrainingQueueEntry entry;
+  entry.user_id=user_id;
+  entry.srcSent=sanitize(srcSent);
+  entry.refSent=sanitize(refSent);
+
+      // journalMut is held until the pair is enqueued, so that the
+      // order of the journal is the order of the queue
+  pthread_mutex_lock(&journalMut);
+  pthread_mutex_lock(&mut);
+  bool isOpen=(opened && !closed);
+  pthread_mutex_unlock(&mut);
+
+  int ret=THOT_OK;
+  if(!isOpen)
+  {
+    std::cerr<<"Error: online training queue is not open"<<std::endl;
+    ret=THOT_ERROR;
+  }
+  else if(!journalFileName.empty())
+  {
+        // If a previous write failed, the journal has to be rewritten
+        // before accepting new pairs
+    if(journalFile==NULL)
+      ret=rewriteJournal();
+    if(ret==THOT_OK)
+      ret=appendToJournal(entry);
+  }
+
+  if(ret==THOT_OK)
+  {
+    pthread_mutex_lock(&mut);
+    entry.enqueueSecs=DecProf::now();
+    pendingEntries.push_back(entry);
+    ++numEnqueued;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&mut);
+  }
+  pthread_mutex_unlock(&journalMut);
+  return ret;
+}
+
+//-------------------------
+bool OnlineTrainingQueue::takeBatch(unsigned int maxBatchSize,
+                                    std::vector<OnlineTrainingQueueEntry>& batch)
+{
+  batch.clear();
+  pthread_mutex_lock(&mut);
+  while(pendingEntries.empty() && !closed)
+    pthread_cond_wait(&cond,&mut);
+  while(!pendingEntries.empty() && (maxBatchSize==0 || batch.size()<maxBatchSize))
+  {
+    batch.push_back(pendingEntries.front());
+    pendingEntries.pop_front();
+  }
+  entriesInProgress=batch;
+  pthread_mutex_unlock(&mut);
+  return !batch.empty();
+}
+
+//-------------------------
+int OnlineTrainingQueue::batchDone(const std::vector<OnlineTrainingQueueEntry>& batch,
+                                   unsigned int numBatchFailed)
+{
+  double nowSecs=DecProf::now();
+
+      // journalMut is taken first so that a concurrent rewrite cannot
+      // drop the pairs of the batch before they are marked as done
+  pthread_mutex_lock(&journalMut);
+  pthread_mutex_lock(&mut);
+  entriesInProgress.clear();
+  for(unsigned int i=0;i<batch.size();++i)
+  {
+    double lagSecs=nowSecs-batch[i].enqueueSecs;
+    lastLagSecs=lagSecs;
+    totalLagSecs+=lagSecs;
+    if(lagSecs>maxLagSecs)
+      maxLagSecs=lagSecs;
+  }
+  numTrained+=batch.size()-numBatchFailed;
+  numFailed+=numBatchFailed;
+  ++numBatches;
+  pthread_mutex_unlock(&mut);
+
+      // Record the trained pairs in the journal, which is compacted
+      // only from time to time
+  int ret=THOT_OK;
+  if(!journalFileName.empty())
+  {
+    if(journalFile==NULL || appendDoneToJournal(batch.size())==THOT_ERROR ||
+       numJournalDoneEntries>=OTQ_JOURNAL_REWRITE_INTERVAL)
+      ret=rewriteJournal();
+  }
+  pthread_mutex_unlock(&journalMut);
+  return ret;
+}
+
+//-------------------------
+void OnlineTrainingQueue::close(void)
+{
+  pthread_mutex_lock(&mut);
+  closed=true;
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mut);
+}
+
+//-------------------------
+size_t OnlineTrainingQueue::depth(void)
+{
+  pthread_mutex_lock(&mut);
+  size_t ret=pendingEntries.size();
+  pthread_mutex_unlock(&mut);
+  return ret;
+}
+
+//-------------------------
+void OnlineTrainingQueue::printJson(std::ostream& outS)
+{
+  double nowSecs=DecProf::now();
+  pthread_mutex_lock(&mut);
+  unsigned long long numProcessed=numTrained+numFailed;
+  outS<<std::setprecision(9);
+  outS<<"{\"async\": "<<(opened && !closed? "true" : "false");
+  outS<<", \"depth\": "<<pendingEntries.size();
+  outS<<", \"in_progress\": "<<entriesInProgress.size();
+  outS<<", \"enqueued\": "<<numEnqueued;
+  outS<<", \"trained\": "<<numTrained;
+  outS<<", \"failed\": "<<numFailed;
+  outS<<", \"batches\": "<<numBatches;
+  outS<<", \"oldest_pending_secs\": ";
+  if(pendingEntries.empty())
+    outS<<"null";
+  else
+    outS<<nowSecs-pendingEntries.front().enqueueSecs;
+  outS<<", \"lag_secs\": {\"last\": ";
+  if(numProcessed==0)
+    outS<<"null, \"mean\": null, \"max\": null}";
+  else
+    outS<<lastLagSecs<<", \"mean\": "<<totalLagSecs/numProcessed<<", \"max\": "<<maxLagSecs<<"}";
+  outS<<"}";
+  pthread_mutex_unlock(&mut);
+}
+
+//-------------------------
+OnlineTrainingQueue::~OnlineTrainingQueue()
+{
+  if(journalFile!=NULL)
+    fclose(journalFile);
+  pthread_mutex_destroy(&mut);
+  pthread_cond_destroy(&cond);
+  pthread_mutex_destroy(&journalMut);
+}
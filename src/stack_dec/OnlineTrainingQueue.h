@@ -0,0 +1,181 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: OnlineTrainingQueue                                      */
+/*                                                                  */
+/* Prototype file: OnlineTrainingQueue.h                            */
+/*                                                                  */
+/* Description: Thread-safe queue of the sentence pairs waiting to  */
+/*              be used for online training. The pending pairs can  */
+/*              be stored in a journal file so that they survive a  */
+/*              restart of the process.                             */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file OnlineTrainingQueue.h
+ *
+ * @brief Thread-safe queue of the sentence pairs waiting to be used
+ * for online training. The pending pairs can be stored in a journal
+ * file so that they survive a restart of the process.
+ */
+
+#ifndef _OnlineTrainingQueue_h
+#define _OnlineTrainingQueue_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ErrorDefs.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define OTQ_DEFAULT_MAX_BATCH_SIZE      16
+#define OTQ_JOURNAL_REWRITE_INTERVAL    256  // Number of trained pairs
+                                             // after which the journal
+                                             // is compacted
+
+//--------------- Structs --------------------------------------------
+
+struct OnlineTrainingQueueEntry
+{
+  int user_id;
+  std::string srcSent;
+  std::string refSent;
+  double enqueueSecs;
+};
+
+//--------------- Classes --------------------------------------------
+
+//--------------- OnlineTrainingQueue class
+
+/**
+ * @brief Queue of sentence pairs shared by the threads serving
+ * requests, which add pairs with push(), and a trainer thread, which
+ * takes them in batches with takeBatch() and calls batchDone() once the
+ * models have been updated. If a journal file is given, pairs are
+ * written to it before push() returns, and batchDone() appends a
+ * record with the number of trained pairs, which are the oldest ones.
+ * The journal is compacted, keeping only the pairs that have not been
+ * trained, every OTQ_JOURNAL_REWRITE_INTERVAL trained pairs or after a
+ * write error. Pending pairs of a previous execution are loaded when
+ * the queue is opened. Journal writes are serialized by their own
+ * mutex, so that taking batches or querying the queue does not wait
+ * for them.
+ */
+class OnlineTrainingQueue
+{
+ public:
+
+      // Constructor
+  OnlineTrainingQueue(void);
+
+  int open(const std::string& _journalFileName,
+           int verbose=0);
+      // Opens the queue, if _journalFileName is not empty, the pairs
+      // stored in the journal are loaded
+  bool isOpen(void);
+      // Returns true if the queue is open and has not been closed
+
+      // Functions to add and take pairs
+  int push(int user_id,
+           const std::string& srcSent,
+           const std::string& refSent);
+      // Adds a pair to the queue. Returns THOT_ERROR if the queue is
+      // not open or if the pair could not be written to the journal
+  bool takeBatch(unsigned int maxBatchSize,
+                 std::vector<OnlineTrainingQueueEntry>& batch);
+      // Waits until there are pending pairs and takes up to
+      // maxBatchSize of them (all of them if maxBatchSize is zero).
+      // Returns false if the queue was closed and there are no pending
+      // pairs. Batches must be taken by a single thread, which calls
+      // batchDone() before taking the next one
+  int batchDone(const std::vector<OnlineTrainingQueueEntry>& batch,
+                unsigned int numFailed);
+      // Removes the pairs of the batch from the journal and updates
+      // the statistics of the queue. Returns THOT_ERROR if the journal
+      // could not be updated, in which case push() fails until the
+      // journal is successfully rewritten
+  void close(void);
+      // Wakes up the trainer thread, which will take the remaining
+      // pairs before takeBatch() returns false
+
+      // Statistics
+  size_t depth(void);
+      // Returns the number of pending pairs (not including those of
+      // the batch being trained)
+  void printJson(std::ostream& outS);
+      // Prints the depth of the queue and the lag between the
+      // insertion of the pairs and the publication of the updated
+      // models in JSON format
+
+      // Destructor
+  ~OnlineTrainingQueue();
+
+ private:
+
+  pthread_mutex_t mut;
+  pthread_cond_t cond;
+  bool opened;
+  bool closed;
+  std::deque<OnlineTrainingQueueEntry> pendingEntries;
+  std::vector<OnlineTrainingQueueEntry> entriesInProgress;
+
+      // Journal data, protected by journalMut. If both mutexes are
+      // required, journalMut is locked first
+  pthread_mutex_t journalMut;
+  std::string journalFileName;
+  FILE* journalFile;
+  unsigned long long numJournalDoneEntries;
+      // Trained pairs that are still stored in the journal
+
+      // Statistics
+  unsigned long long numEnqueued;
+  unsigned long long numTrained;
+  unsigned long long numFailed;
+  unsigned long long numBatches;
+  double lastLagSecs;
+  double totalLagSecs;
+  double maxLagSecs;
+
+      // Journal functions, the caller must hold journalMut
+  int loadJournal(int verbose);
+  int appendToJournal(const OnlineTrainingQueueEntry& entry);
+  int appendDoneToJournal(size_t numDone);
+  int rewriteJournal(void);
+      // Writes the pairs in progress and the pending ones to the
+      // journal
+  static std::string sanitize(const std::string& sent);
+
+      // Copies are not allowed
+  OnlineTrainingQueue(const OnlineTrainingQueue&);
+  void operator=(const OnlineTrainingQueue&);
+};
+
+#endif
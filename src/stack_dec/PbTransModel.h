@@ -73,6 +73,7 @@ class PbTransModel: public _pbTransModel<PhraseBasedTmHypRec<EQCLASS_FUNC> >
 
       // Virtual object copy
   BaseSmtModel<PhraseBasedTmHypRec<EQCLASS_FUNC> >* clone(void);
+  bool updateCopyForParallelExpansion(BaseSmtModel<PhraseBasedTmHypRec<EQCLASS_FUNC> >* copyPtr);
 
       // Misc. operations with hypotheses
   HypDataType nullHypothesisHypData(void);
@@ -129,6 +130,21 @@ BaseSmtModel<PhraseBasedTmHypRec<EQCLASS_FUNC> >* PbTransModel<EQCLASS_FUNC>::cl
   return new PbTransModel<EQCLASS_FUNC>(*this);
 }
 
+//---------------------------------
+template<class EQCLASS_FUNC>
+bool PbTransModel<EQCLASS_FUNC>::updateCopyForParallelExpansion(BaseSmtModel<PhraseBasedTmHypRec<EQCLASS_FUNC> >* copyPtr)
+{
+  PbTransModel<EQCLASS_FUNC>* pbtmCopyPtr=dynamic_cast<PbTransModel<EQCLASS_FUNC>*>(copyPtr);
+  if(pbtmCopyPtr==NULL || pbtmCopyPtr==this)
+    return false;
+
+      // Copy the model, the caches are shared instead of copied
+  this->cacheHandle.shareWithCopies(true);
+  *pbtmCopyPtr=*this;
+  this->cacheHandle.shareWithCopies(false);
+  return true;
+}
+
 //---------------------------------
 template<class EQCLASS_FUNC>
 Score PbTransModel<EQCLASS_FUNC>::nullHypothesisScrComps(Hypothesis& nullHyp,
@@ -0,0 +1,179 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: PbTransModelCacheData                                    */
+/*                                                                  */
+/* Definitions file: PbTransModelCacheData.cc                       */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "PbTransModelCacheData.h"
+#include <pthread.h>
+
+//--------------- Global variables -----------------------------------
+
+namespace
+{
+  pthread_mutex_t poolMut=PTHREAD_MUTEX_INITIALIZER;
+      // The free list is never destroyed, so that the models that
+      // are destroyed at exit can still release their caches
+  std::vector<PbTransModelCacheData*>* freeListPtr=NULL;
+}
+
+//--------------- Function definitions
+
+//-------------------------
+void PbTransModelCacheData::clear(void)
+{
+  nbTransCacheData.clear();
+  localTmHeurScoreCache.clear();
+  cachedDirectPhrScoreVecs.clear();
+  cachedInversePhrScoreVecs.clear();
+}
+
+//-------------------------
+PbTransModelCacheData* PbTransModelCachePool::acquire(void)
+{
+  PbTransModelCacheData* cacheDataPtr=NULL;
+  pthread_mutex_lock(&poolMut);
+  if(freeListPtr!=NULL && !freeListPtr->empty())
+  {
+    cacheDataPtr=freeListPtr->back();
+    freeListPtr->pop_back();
+  }
+  pthread_mutex_unlock(&poolMut);
+
+  if(cacheDataPtr==NULL)
+    cacheDataPtr=new PbTransModelCacheData;
+  return cacheDataPtr;
+}
+
+//-------------------------
+void PbTransModelCachePool::release(PbTransModelCacheData* cacheDataPtr)
+{
+  if(cacheDataPtr==NULL)
+    return;
+
+      // Clear data out of the critical section
+  cacheDataPtr->clear();
+
+  pthread_mutex_lock(&poolMut);
+  if(freeListPtr==NULL)
+    freeListPtr=new std::vector<PbTransModelCacheData*>;
+  if(freeListPtr->size()<PBTM_CACHE_POOL_MAX_FREE_ENTRIES)
+  {
+    freeListPtr->push_back(cacheDataPtr);
+    cacheDataPtr=NULL;
+  }
+  pthread_mutex_unlock(&poolMut);
+
+      // Delete data if the pool is full
+  delete cacheDataPtr;
+}
+
+//-------------------------
+size_t PbTransModelCachePool::numFreeEntries(void)
+{
+  pthread_mutex_lock(&poolMut);
+  size_t result=(freeListPtr==NULL)? 0 : freeListPtr->size();
+  pthread_mutex_unlock(&poolMut);
+  return result;
+}
+
+//-------------------------
+PbTransModelCacheHandle::PbTransModelCacheHandle(void)
+{
+  cacheDataPtr=NULL;
+  sharedDataPtr=NULL;
+  shareCopies=false;
+}
+
+//-------------------------
+PbTransModelCacheHandle::PbTransModelCacheHandle(const PbTransModelCacheHandle& cacheHandle)
+{
+  cacheDataPtr=NULL;
+  sharedDataPtr=NULL;
+  shareCopies=false;
+  copyFrom(cacheHandle);
+}
+
+//-------------------------
+PbTransModelCacheHandle& PbTransModelCacheHandle::operator=(const PbTransModelCacheHandle& cacheHandle)
+{
+  if(this!=&cacheHandle)
+    copyFrom(cacheHandle);
+  return *this;
+}
+
+//-------------------------
+void PbTransModelCacheHandle::copyFrom(const PbTransModelCacheHandle& cacheHandle)
+{
+  if(cacheHandle.shareCopies)
+  {
+    release();
+    sharedDataPtr=cacheHandle.cacheDataPtr;
+  }
+  else
+  {
+    if(cacheHandle.cacheDataPtr!=NULL)
+      get()=*cacheHandle.cacheDataPtr;
+    else
+    {
+      PbTransModelCachePool::release(cacheDataPtr);
+      cacheDataPtr=NULL;
+    }
+    sharedDataPtr=cacheHandle.sharedDataPtr;
+  }
+}
+
+//-------------------------
+bool PbTransModelCacheHandle::holdsData(void)const
+{
+  return cacheDataPtr!=NULL;
+}
+
+//-------------------------
+const PbTransModelCacheData* PbTransModelCacheHandle::getSharedData(void)const
+{
+  return sharedDataPtr;
+}
+
+//-------------------------
+void PbTransModelCacheHandle::shareWithCopies(bool share)
+{
+  shareCopies=share;
+}
+
+//-------------------------
+void PbTransModelCacheHandle::release(void)
+{
+  PbTransModelCachePool::release(cacheDataPtr);
+  cacheDataPtr=NULL;
+  sharedDataPtr=NULL;
+}
+
+//-------------------------
+PbTransModelCacheHandle::~PbTransModelCacheHandle()
+{
+  release();
+}
@@ -0,0 +1,174 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: PbTransModelCacheData                                    */
+/*                                                                  */
+/* Prototype file: PbTransModelCacheData.h                          */
+/*                                                                  */
+/* Description: Per-sentence caches of the phrase-based translation */
+/*              models and process-wide pool used to reuse them     */
+/*              among the different model instances.                */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file PbTransModelCacheData.h
+ *
+ * @brief Per-sentence caches of the phrase-based translation models
+ * and process-wide pool used to reuse them among the different model
+ * instances.
+ */
+
+#ifndef _PbTransModelCacheData_h
+#define _PbTransModelCacheData_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "NbestTransCacheData.h"
+#include "SmtDefs.h"
+#include "Bitset.h"
+#include "BitsetHashF.h"
+#include "StatModelDefs.h"
+#include "Score.h"
+#include <map>
+#include <vector>
+
+#if __GNUC__>2
+#include <ext/hash_map>
+using __gnu_cxx::hash_map;
+#else
+#include <hash_map>
+#endif
+
+//--------------- Constants ------------------------------------------
+
+#define PBTM_CACHE_POOL_MAX_FREE_ENTRIES 64
+
+//--------------- Classes --------------------------------------------
+
+//--------------- PbTransModelCacheData class
+
+/**
+ * @brief Data cached by a translation model while translating a
+ * sentence. All of it can be recomputed from the models, so it can be
+ * discarded at any time.
+ */
+class PbTransModelCacheData
+{
+ public:
+
+  typedef hash_map<Bitset<MAX_SENTENCE_LENGTH_ALLOWED>,Score,BitsetHashF<MAX_SENTENCE_LENGTH_ALLOWED> > CoverageHeurScoreCache;
+  typedef std::map<std::pair<std::vector<WordIndex>,std::vector<WordIndex> >,std::vector<Score> > PhrasePairVecScore;
+
+      // Data used to cache n-best translation data
+  NbestTransCacheData nbTransCacheData;
+
+      // Cache of local translation model heuristic scores indexed by
+      // hypothesis coverage
+  CoverageHeurScoreCache localTmHeurScoreCache;
+
+      // Cached phrase model score vectors
+  PhrasePairVecScore cachedDirectPhrScoreVecs;
+  PhrasePairVecScore cachedInversePhrScoreVecs;
+
+      // Function to clear cached data
+  void clear(void);
+};
+
+//--------------- PbTransModelCachePool class
+
+/**
+ * @brief Thread-safe pool of cache data objects shared by all the
+ * translation models of the process. Released objects are cleared and
+ * kept for later requests (up to PBTM_CACHE_POOL_MAX_FREE_ENTRIES), so
+ * the hash tables of the caches are not reallocated for each sentence
+ * or each new model instance.
+ */
+class PbTransModelCachePool
+{
+ public:
+
+  static PbTransModelCacheData* acquire(void);
+      // Returns an empty cache data object
+  static void release(PbTransModelCacheData* cacheDataPtr);
+      // Returns the object to the pool
+  static size_t numFreeEntries(void);
+};
+
+//--------------- PbTransModelCacheHandle class
+
+/**
+ * @brief Cache data owned by a translation model. The data is obtained
+ * from the pool the first time it is accessed, so that a model that is
+ * not translating, such as a copy of the model shared by the users of
+ * the decoder, does not hold any cache. Copying the handle only copies
+ * the caches if the source handle holds them, unless the source shares
+ * them with its copies (see shareWithCopies()).
+ */
+class PbTransModelCacheHandle
+{
+ public:
+
+      // Constructors
+  PbTransModelCacheHandle(void);
+  PbTransModelCacheHandle(const PbTransModelCacheHandle& cacheHandle);
+
+  PbTransModelCacheHandle& operator=(const PbTransModelCacheHandle& cacheHandle);
+
+      // Access to the cache data
+  PbTransModelCacheData& get(void)
+    {
+      if(cacheDataPtr==NULL)
+        cacheDataPtr=PbTransModelCachePool::acquire();
+      return *cacheDataPtr;
+    }
+  bool holdsData(void)const;
+  const PbTransModelCacheData* getSharedData(void)const;
+      // Returns the data of the handle that was copied while sharing
+      // its caches, or NULL
+
+  void shareWithCopies(bool share);
+      // While share is true, the copies of the handle refer to its
+      // cache data instead of copying it, they obtain empty caches of
+      // their own for the data they have to modify. The shared data
+      // must not be modified or released while it is being used by the
+      // copies
+
+  void release(void);
+      // Returns the cache data to the pool and stops using the shared
+      // data
+
+      // Destructor
+  ~PbTransModelCacheHandle();
+
+ private:
+
+  PbTransModelCacheData* cacheDataPtr;
+  const PbTransModelCacheData* sharedDataPtr;
+  bool shareCopies;
+
+  void copyFrom(const PbTransModelCacheHandle& cacheHandle);
+};
+
+#endif
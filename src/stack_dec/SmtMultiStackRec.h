@@ -46,6 +46,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include <_smtMultiStack.h>
 #include "HypStateDict.h"
+#include "DecProfiler.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -322,6 +323,7 @@ bool SmtMultiStackRec<HYPOTHESIS_REC>::pushOnSmtStack(typename MultiContainer::i
 #  ifdef THOT_STATS
     ++this->discardedPushOpsDueToRec;
 #  endif
+    DecProf::count(DEC_PROF_HYPS_RECOMBINED);
 
     return false;
   }
@@ -364,6 +366,7 @@ bool SmtMultiStackRec<HYPOTHESIS_REC>::pushOnSmtStackIdx(typename MultiContainer
         // also removed)
     pos->second.remove(recInfoMapIter->second);
     recInfoMapIter=recInfoMap.end();
+    DecProf::count(DEC_PROF_HYPS_RECOMBINED);
   }
 
       // Keep last hypothesis of the container, and the size of the
@@ -42,6 +42,14 @@ ThotDecoder::ThotDecoder()
     init_translator_feat_impl();
   else
     init_translator_legacy_impl();
+
+      // Initialize data of batch translations
+  nextBatchWorkerUserId=TD_FIRST_BATCH_WORKER_USER_ID;
+
+      // Initialize data of asynchronous online training
+  asyncTrainerRunning=false;
+  asyncTrainingMaxBatchSize=OTQ_DEFAULT_MAX_BATCH_SIZE;
+  asyncTrainingVerbose=0;
 }
 
 //--------------------------
@@ -169,9 +177,10 @@ void ThotDecoder::init_translator_legacy_impl(void)
   pthread_mutex_init(&user_id_to_idx_mut,NULL);
   pthread_mutex_init(&atomic_op_mut,NULL);
   pthread_mutex_init(&non_atomic_op_mut,NULL);
-  pthread_mutex_init(&preproc_mut,NULL);
   pthread_cond_init(&non_atomic_op_cond,NULL);
   non_atomic_ops_running=0;
+  pthread_mutex_init(&async_training_mut,NULL);
+  pthread_mutex_init(&batch_worker_mut,NULL);
 }
 
 //--------------------------
@@ -255,9 +264,10 @@ void ThotDecoder::init_translator_feat_impl(void)
   pthread_mutex_init(&user_id_to_idx_mut,NULL);
   pthread_mutex_init(&atomic_op_mut,NULL);
   pthread_mutex_init(&non_atomic_op_mut,NULL);
-  pthread_mutex_init(&preproc_mut,NULL);
   pthread_cond_init(&non_atomic_op_cond,NULL);
   non_atomic_ops_running=0;
+  pthread_mutex_init(&async_training_mut,NULL);
+  pthread_mutex_init(&batch_worker_mut,NULL);
 }
 
 //--------------------------
@@ -298,10 +308,38 @@ void ThotDecoder::release_user_data(int user_id)
         // Release user data
     release_idx_data(mapIter->second);
   }
+
+      // Release the decoders of the batch workers of the user
+  release_batch_workers(user_id);
+  
   /////////// end of mutex 
   pthread_mutex_unlock(&user_id_to_idx_mut);  
 }
 
+//--------------------------
+void ThotDecoder::release_batch_workers(int user_id)
+{
+  pthread_mutex_lock(&batch_worker_mut);
+  /////////// begin of mutex 
+  std::map<std::pair<int,unsigned int>,int>::iterator workerIter=batchWorkerUserIdMap.lower_bound(std::make_pair(user_id,0));
+  while(workerIter!=batchWorkerUserIdMap.end() && workerIter->first.first==user_id)
+  {
+        // The index of the worker is freed so that it can be used by
+        // new users. Worker identifiers are not reused, so that the
+        // released data is never accessed again through them
+    std::map<int,size_t>::iterator mapIter=userIdToIdx.find(workerIter->second);
+    if(mapIter!=userIdToIdx.end())
+    {
+      release_idx_data(mapIter->second);
+      freeIdxVec.push_back(mapIter->second);
+      userIdToIdx.erase(mapIter);
+    }
+    batchWorkerUserIdMap.erase(workerIter++);
+  }
+  /////////// end of mutex 
+  pthread_mutex_unlock(&batch_worker_mut);
+}
+
 //--------------------------
 int ThotDecoder::init_idx_data(size_t idx)
 {    
@@ -463,7 +501,19 @@ size_t ThotDecoder::get_vecidx_for_user_id(int user_id)
   }
   else
   {
-    idx=tdPerUserVarsVec.size();
+        // Reuse the indices freed by released batch workers
+    if(!freeIdxVec.empty())
+    {
+      idx=freeIdxVec.back();
+      freeIdxVec.pop_back();
+      int ret=init_idx_data(idx);
+      if(ret==THOT_ERROR)
+        exit(1);
+      idxDataReleased[idx]=false;
+      totalPrefixVec[idx].clear();
+    }
+    else
+      idx=tdPerUserVarsVec.size();
     userIdToIdx[user_id]=idx;
   }
 
@@ -495,6 +545,107 @@ size_t ThotDecoder::get_vecidx_for_user_id(int user_id)
   return idx;
 }
 
+//--------------------------
+int ThotDecoder::get_batch_worker_user_ids(int user_id,
+                                           unsigned int numWorkers,
+                                           std::vector<int>& workerUserIdVec,
+                                           int verbose/*=0*/)
+{
+      // The first worker uses the decoder of the user
+  workerUserIdVec.clear();
+  workerUserIdVec.push_back(user_id);
+  
+      // Obtain identifiers of the workers that have already been
+      // initialized
+  bool newWorkers=false;
+  pthread_mutex_lock(&batch_worker_mut);
+  /////////// begin of mutex 
+  for(unsigned int w=1;w<numWorkers && !newWorkers;++w)
+  {
+    std::map<std::pair<int,unsigned int>,int>::const_iterator mapIter=batchWorkerUserIdMap.find(std::make_pair(user_id,w));
+    if(mapIter!=batchWorkerUserIdMap.end())
+      workerUserIdVec.push_back(mapIter->second);
+    else
+      newWorkers=true;
+  }
+  /////////// end of mutex 
+  pthread_mutex_unlock(&batch_worker_mut);
+
+  if(!newWorkers)
+    return THOT_OK;
+
+      // Initialize new workers using the parameters of the user, this
+      // is done as any other atomic operation
+  int ret=THOT_OK;
+  pthread_mutex_lock(&atomic_op_mut);
+  /////////// begin of mutex 
+
+      // Wait until all non-atomic operations have finished
+  wait_on_non_atomic_op_cond();
+
+      // Assign identifiers to the workers (they may have been assigned
+      // by another request in the meantime)
+  std::vector<unsigned int> newWorkerVec;
+  pthread_mutex_lock(&batch_worker_mut);
+  workerUserIdVec.resize(1);
+  for(unsigned int w=1;w<numWorkers;++w)
+  {
+    std::map<std::pair<int,unsigned int>,int>::const_iterator mapIter=batchWorkerUserIdMap.find(std::make_pair(user_id,w));
+    if(mapIter!=batchWorkerUserIdMap.end())
+    {
+      workerUserIdVec.push_back(mapIter->second);
+    }
+    else
+    {
+      workerUserIdVec.push_back(nextBatchWorkerUserId);
+      batchWorkerUserIdMap[std::make_pair(user_id,w)]=nextBatchWorkerUserId;
+      ++nextBatchWorkerUserId;
+      newWorkerVec.push_back(w);
+    }
+  }
+  pthread_mutex_unlock(&batch_worker_mut);
+
+  ThotDecoderUserPars tdup;
+  std::map<int,ThotDecoderUserPars>::const_iterator parsIter=userParsMap.find(user_id);
+  if(parsIter!=userParsMap.end())
+    tdup=parsIter->second;
+
+  for(unsigned int i=0;i<newWorkerVec.size();++i)
+  {
+    if(initUserParsAux(workerUserIdVec[newWorkerVec[i]],tdup,verbose)==THOT_ERROR)
+      ret=THOT_ERROR;
+  }
+
+      // Unlock non_atomic_op_cond mutex
+  pthread_mutex_unlock(&non_atomic_op_mut);
+  
+  /////////// end of mutex 
+  pthread_mutex_unlock(&atomic_op_mut);
+
+  return ret;
+}
+
+//--------------------------
+void ThotDecoder::run_batch_tasks(ThreadPool::task_func_t* taskFunc,
+                                  void* taskData,
+                                  unsigned int numTasks,
+                                  unsigned int numWorkers)
+{
+  if(numWorkers<=1)
+  {
+    for(unsigned int i=0;i<numTasks;++i)
+      taskFunc(taskData,i,0);
+  }
+  else
+  {
+        // Each request uses its own pool, so that the batches of
+        // different requests are executed concurrently
+    ThreadPool threadPool;
+    threadPool.init(numWorkers);
+    threadPool.run(taskFunc,taskData,numTasks);
+  }
+}
+
 //--------------------------
 int ThotDecoder::initUsingCfgFile(std::string cfgFile,
                                   ThotDecoderUserPars& tdup,
@@ -601,6 +752,23 @@ int ThotDecoder::initUsingCfgFile(std::string cfgFile,
       }
     }
 
+        // -I parameter
+    if(argv_stl[i]=="-I" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -I parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        std::cerr<<"-I parameter changed from \""<<tdup.I<<"\" to \""<<argv_stl[i+1]<<"\""<<std::endl;
+        tdup.I=atoi(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
         // -A parameter
     if(argv_stl[i]=="-A" && !matched)
     {
@@ -676,6 +844,23 @@ int ThotDecoder::initUsingCfgFile(std::string cfgFile,
       }
     }
 
+        // -nt parameter
+    if(argv_stl[i]=="-nt" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -nt parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        std::cerr<<"-nt parameter changed from \""<<tdup.nt<<"\" to \""<<argv_stl[i+1]<<"\""<<std::endl;
+        tdup.nt=atoi(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
         // -h parameter
     if(argv_stl[i]=="-h" && !matched)
     {
@@ -973,18 +1158,44 @@ int ThotDecoder::initUserPars(int user_id,
       // Wait until all non-atomic operations have finished
   wait_on_non_atomic_op_cond();
 
+      // Store parameters so as to be used by the batch workers of the
+      // user
+  userParsMap[user_id]=tdup;
+
+  int ret=initUserParsAux(user_id,tdup,verbose);
+
+      // Unlock non_atomic_op_cond mutex
+  pthread_mutex_unlock(&non_atomic_op_mut);
+
+  /////////// end of mutex 
+  pthread_mutex_unlock(&atomic_op_mut);
+
+  return ret;
+}
+
+//--------------------------
+int ThotDecoder::initUserParsAux(int user_id,
+                                 const ThotDecoderUserPars& tdup,
+                                 int verbose)
+{
   if(verbose)
     StdCerrThreadSafe<<"Initializing parameters for user "<<user_id<<" ..."<<std::endl;
 
       // Set S parameter
   set_S(user_id,tdup.S,verbose);
 
+      // Set I parameter
+  set_I(user_id,tdup.I,verbose);
+
       // Set be flag
   set_be(user_id,tdup.be,verbose);
 
       // Set G parameter
   int ret=set_G(user_id,tdup.G,verbose);
 
+      // Set nt parameter
+  set_nt(user_id,tdup.nt,verbose);
+
       // Set np parameter
   ret=set_np(user_id,tdup.np,verbose);
 
@@ -1002,12 +1213,6 @@ int ThotDecoder::initUserPars(int user_id,
       // Set cat weights
   set_catw(user_id,tdup.catWeightsVec,verbose);
 
-      // Unlock non_atomic_op_cond mutex
-  pthread_mutex_unlock(&non_atomic_op_mut);
-
-  /////////// end of mutex 
-  pthread_mutex_unlock(&atomic_op_mut);
-
   return THOT_OK;
 }
 
@@ -1050,6 +1255,20 @@ void ThotDecoder::set_S(int user_id,
   tdPerUserVarsVec[idx].stackDecoderPtr->set_S_par(S_par);
 }
   
+//--------------------------
+void ThotDecoder::set_I(int user_id,
+                        unsigned int I_par,
+                        int verbose/*=0*/)
+{
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+  if(verbose)
+  {
+    StdCerrThreadSafe<<"user_id: "<<user_id<<", I parameter is set to "<<I_par<<std::endl;
+  }
+  tdPerUserVarsVec[idx].stackDecoderPtr->set_I_par(I_par);
+}
+  
 //--------------------------
 void ThotDecoder::set_A(unsigned int A_par,
                         int verbose/*=0*/)
@@ -1101,6 +1320,20 @@ bool ThotDecoder::set_G(int user_id,
 
   return THOT_OK;
 }
+
+//--------------------------
+void ThotDecoder::set_nt(int user_id,
+                         unsigned int nt_par,
+                         int verbose/*=0*/)
+{
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+  if(verbose)
+  {
+    StdCerrThreadSafe<<"user_id: "<<user_id<<", nt parameter is set to "<<nt_par<<std::endl;
+  }
+  tdPerUserVarsVec[idx].stackDecoderPtr->set_nt_par(nt_par);
+}
   
 //--------------------------
 void ThotDecoder::set_h(unsigned int h_par,
@@ -1488,6 +1721,16 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
     StdCerrThreadSafeCond(printTid)<<"Error: one or both of the input sentences to be trained are empty"<<std::endl;
     return THOT_ERROR;
   }
+
+      // In asynchronous mode, the pair is trained by the trainer thread
+  if(onlineTrainingQueue.isOpen())
+  {
+    if(verbose)
+    {
+      StdCerrThreadSafeCond(printTid)<<"Queueing sentence pair for online training (user_id: "<<user_id<<")"<<std::endl;
+    }
+    return onlineTrainingQueue.push(user_id,srcSent,refSent);
+  }
     
   pthread_mutex_lock(&atomic_op_mut);
   /////////// begin of mutex 
@@ -1499,6 +1742,26 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
   size_t idx=get_vecidx_for_user_id(user_id);
   if(verbose) StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
 
+  ret=onlineTrainSentPairAux(idx,srcSent,refSent,verbose);
+
+      // Unlock non_atomic_op_cond mutex
+  pthread_mutex_unlock(&non_atomic_op_mut);
+
+  /////////// end of mutex 
+  pthread_mutex_unlock(&atomic_op_mut);
+
+  return ret;
+}
+
+//--------------------------
+int ThotDecoder::onlineTrainSentPairAux(size_t idx,
+                                        const char *srcSent,
+                                        const char *refSent,
+                                        int verbose/*=0*/)
+{
+  int ret;
+  bool printTid=threadIdShouldBePrinted(verbose);
+
   if(verbose)
   {
     StdCerrThreadSafeCond(printTid)<<"Training sentence pair:"<<std::endl;
@@ -1575,15 +1838,121 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
     if(verbose) StdCerrThreadSafeCond(printTid)<<"Training time: "<<elapsedTime-prevElapsedTime<<std::endl;
   }
 
-      // Unlock non_atomic_op_cond mutex
-  pthread_mutex_unlock(&non_atomic_op_mut);
+  return ret;
+}
+
+//--------------------------
+int ThotDecoder::startAsyncOnlineTraining(std::string journalFileName,
+                                          unsigned int maxBatchSize,
+                                          int verbose/*=0*/)
+{
+  pthread_mutex_lock(&async_training_mut);
+  /////////// begin of mutex 
+
+  int ret=THOT_OK;
+  if(asyncTrainerRunning)
+  {
+    std::cerr<<"Error: asynchronous online training is already enabled"<<std::endl;
+    ret=THOT_ERROR;
+  }
+  else
+  {
+    asyncTrainingMaxBatchSize=maxBatchSize;
+    asyncTrainingVerbose=verbose;
+    ret=onlineTrainingQueue.open(journalFileName,verbose);
+    if(ret==THOT_OK)
+    {
+      if(pthread_create(&asyncTrainerThread,NULL,&ThotDecoder::asyncTrainerEntry,(void*)this)!=0)
+      {
+        std::cerr<<"Error: online training thread could not be created"<<std::endl;
+        onlineTrainingQueue.close();
+        ret=THOT_ERROR;
+      }
+      else
+        asyncTrainerRunning=true;
+    }
+  }
 
   /////////// end of mutex 
-  pthread_mutex_unlock(&atomic_op_mut);
+  pthread_mutex_unlock(&async_training_mut);
 
   return ret;
 }
 
+//--------------------------
+void ThotDecoder::stopAsyncOnlineTraining(void)
+{
+  pthread_mutex_lock(&async_training_mut);
+  /////////// begin of mutex 
+
+  if(asyncTrainerRunning)
+  {
+        // The trainer thread ends once the queue is empty
+    onlineTrainingQueue.close();
+    pthread_join(asyncTrainerThread,NULL);
+    asyncTrainerRunning=false;
+  }
+
+  /////////// end of mutex 
+  pthread_mutex_unlock(&async_training_mut);
+}
+
+//--------------------------
+void ThotDecoder::getOnlineTrainingStats(std::string& jsonStr)
+{
+  std::ostringstream stream;
+  onlineTrainingQueue.printJson(stream);
+  jsonStr=stream.str();
+}
+
+//--------------------------
+void* ThotDecoder::asyncTrainerEntry(void* thotDecoderPtr)
+{
+  ((ThotDecoder*) thotDecoderPtr)->processOnlineTrainingQueue();
+  return NULL;
+}
+
+//--------------------------
+void ThotDecoder::processOnlineTrainingQueue(void)
+{
+  std::vector<OnlineTrainingQueueEntry> batch;
+  while(onlineTrainingQueue.takeBatch(asyncTrainingMaxBatchSize,batch))
+  {
+    unsigned int numFailed=0;
+
+    pthread_mutex_lock(&atomic_op_mut);
+    /////////// begin of mutex 
+
+        // Wait until all non-atomic operations have finished, the
+        // models updated with the whole batch are used by the requests
+        // received after releasing the mutex
+    wait_on_non_atomic_op_cond();
+
+    if(asyncTrainingVerbose)
+      StdCerrThreadSafe<<"Training batch of "<<batch.size()<<" queued sentence pairs..."<<std::endl;
+
+    for(unsigned int i=0;i<batch.size();++i)
+    {
+      size_t idx=get_vecidx_for_user_id(batch[i].user_id);
+      int ret=onlineTrainSentPairAux(idx,batch[i].srcSent.c_str(),batch[i].refSent.c_str(),asyncTrainingVerbose);
+      if(ret==THOT_ERROR)
+      {
+        StdCerrThreadSafe<<"Warning: online training of queued sentence pair failed (user_id: "<<batch[i].user_id<<")"<<std::endl;
+        ++numFailed;
+      }
+    }
+
+        // Unlock non_atomic_op_cond mutex
+    pthread_mutex_unlock(&non_atomic_op_mut);
+
+    /////////// end of mutex 
+    pthread_mutex_unlock(&atomic_op_mut);
+
+    if(onlineTrainingQueue.batchDone(batch,numFailed)==THOT_ERROR)
+      StdCerrThreadSafe<<"Warning: online training journal could not be updated, new sentence pairs will be rejected until it can be written"<<std::endl;
+  }
+}
+
 //--------------------------
 void ThotDecoder::addSentenceToWordPred(std::string sentence,
                                         int verbose/*=0*/)
@@ -1744,62 +2113,1061 @@ int ThotDecoder::trainEcm(int user_id,
 }
 
 //--------------------------
-void ThotDecoder::translateSentence(int user_id,
-                                    const char *sentenceToTranslate,
-                                    std::string& result,
-                                    std::string& bestHypInfo,
-                                    int verbose/*=0*/)
+int ThotDecoder::tuneLogLinearWeights(int user_id,
+                                      const std::vector<std::string>& srcSentVec,
+                                      const std::vector<std::string>& refSentVec,
+                                      const LlWeightTuningPars& tuningPars,
+                                      std::vector<float>& bestWeights,
+                                      double& bestQuality,
+                                      int verbose/*=0*/)
 {
-  bool printTid=threadIdShouldBePrinted(verbose);
-
-      // Increase non_atomic_ops_running variable
-  increase_non_atomic_ops_running();
-  
-      // Obtain index vector given user_id
-  size_t idx=get_vecidx_for_user_id(user_id);
-  if(verbose) StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
-
-  pthread_mutex_lock(&per_user_mut[idx]);
-  /////////// begin of user mutex
+  if(srcSentVec.size()!=refSentVec.size() || srcSentVec.empty())
+  {
+    std::cerr<<"Error: the development corpus is empty or the number of source and reference sentences differ"<<std::endl;
+    return THOT_ERROR;
+  }
 
-  if(verbose)
+      // Obtain initial weights, those that are not included are set to
+      // zero
+  std::vector<std::pair<std::string,float> > compWeights;
+  getLogLinearWeights(compWeights);
+  if(!tuningPars.includeVarBool.empty() && tuningPars.includeVarBool.size()!=compWeights.size())
   {
-    StdCerrThreadSafeCond(printTid)<<"Translating sentence: "<<sentenceToTranslate<<std::endl;
+    std::cerr<<"Error: "<<tuningPars.includeVarBool.size()<<" weights were included or excluded but the model has "<<compWeights.size()<<" weights"<<std::endl;
+    return THOT_ERROR;
   }
-  if(tdState.preprocId)
+  std::vector<unsigned int> inclWeightIdxVec;
+  std::vector<float> currWeights;
+  for(unsigned int i=0;i<compWeights.size();++i)
   {
-    std::string preprocSrcSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,sentenceToTranslate,tdState.caseconv,true);
-    if(verbose)
+    if(tuningPars.includeVarBool.empty() || tuningPars.includeVarBool[i])
     {
-      StdCerrThreadSafeCond(printTid)<<" - preproc. source: "<<preprocSrcSent<<std::endl;
+      inclWeightIdxVec.push_back(i);
+      currWeights.push_back(compWeights[i].second);
     }
+    else
+      currWeights.push_back(0);
+  }
 
-        // Obtain translation using precalculated word-graph or translator
-    std::string aux=translateSentenceAux(idx,preprocSrcSent,bestHypInfo);
-    
-    result=postprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,aux.c_str(),tdState.caseconv);
-    if(verbose)
+      // Merged n-best lists, their score components are restricted to
+      // the included weights
+  std::vector<std::vector<std::string> > mergedNblistVec(srcSentVec.size());
+  std::vector<std::vector<std::vector<double> > > mergedScoreCompsVec(srcSentVec.size());
+  std::vector<std::set<std::pair<std::string,std::vector<double> > > > mergedEntrySetVec(srcSentVec.size());
+
+      // Lattices generated for each sentence when lattice MERT is used,
+      // they are compared with the references after preprocessing them
+  std::vector<std::vector<MertLattice> > mergedLatticeVecs(srcSentVec.size());
+  std::vector<std::string> latticeRefSentVec=refSentVec;
+  LatticeMert latticeMert;
+  if(tuningPars.latticeMert)
+  {
+    latticeMert.setNumThreads(tuningPars.numWorkers);
+    if(tdState.preprocId)
     {
-      StdCerrThreadSafeCond(printTid)<<" - preproc. target: "<<aux<<std::endl;
-      StdCerrThreadSafeCond(printTid)<<" - posproc. target: "<<result<<std::endl;     
+      size_t idx=get_vecidx_for_user_id(user_id);
+      pthread_mutex_lock(&per_user_mut[idx]);
+      for(unsigned int i=0;i<refSentVec.size();++i)
+        latticeRefSentVec[i]=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,refSentVec[i],tdState.caseconv,false);
+      pthread_mutex_unlock(&per_user_mut[idx]);
     }
   }
-  else
-  {
-    result=translateSentenceAux(idx,sentenceToTranslate,bestHypInfo,verbose);
+  
+  std::vector<double> decWeightVec;
+  std::vector<double> qualityVec;
+  bestWeights.clear();
+  bestQuality=0;
+  unsigned int niter=1;
+  while(true)
+  {
+        // Obtain included weights
+    std::vector<double> inclWeightVec;
+    for(unsigned int i=0;i<inclWeightIdxVec.size();++i)
+      inclWeightVec.push_back(currWeights[inclWeightIdxVec[i]]);
+
     if(verbose)
     {
-      StdCerrThreadSafeCond(printTid)<<"- target translation: "<<result<<std::endl;
+      std::cerr<<"*** Iteration "<<niter<<" , current weights:";
+      for(unsigned int i=0;i<currWeights.size();++i)
+        std::cerr<<" "<<compWeights[i].first<<": "<<currWeights[i];
+      std::cerr<<std::endl;
     }
-  }
-
-  /////////// end of user mutex 
+    
+        // Determine if the weights are within the trust region of the
+        // weights used in the last translation
+    bool withinTrustRegion=false;
+    if(!decWeightVec.empty())
+    {
+      double diffNorm=0;
+      double decNorm=0;
+      for(unsigned int i=0;i<inclWeightVec.size();++i)
+      {
+        diffNorm+=(inclWeightVec[i]-decWeightVec[i])*(inclWeightVec[i]-decWeightVec[i]);
+        decNorm+=decWeightVec[i]*decWeightVec[i];
+      }
+      withinTrustRegion=(sqrt(diffNorm)<=tuningPars.trustRadius*std::max(sqrt(decNorm),1.0));
+    }
+    
+    double quality=0;
+    bool translateCorpus=!withinTrustRegion;
+    if(withinTrustRegion)
+    {
+          // Estimate translation quality from merged n-best lists or
+          // lattices
+      if(tuningPars.latticeMert)
+      {
+        std::vector<double> weightVec(currWeights.begin(),currWeights.end());
+        std::vector<std::vector<const MertLattice*> > latticePtrVecs;
+        obtainLatticePtrVecs(mergedLatticeVecs,latticePtrVecs);
+        quality=latticeMert.obtainQuality(latticeRefSentVec,latticePtrVecs,weightVec);
+      }
+      else
+        quality=obtainNbestListsQuality(refSentVec,mergedNblistVec,mergedScoreCompsVec,inclWeightVec);
+      if(verbose)
+        std::cerr<<"* Weights within trust region, estimated translation quality: "<<quality<<std::endl;
+
+          // Estimations improving the best quality are not accepted
+          // until the corpus is translated with the new weights
+      if(bestQuality<quality)
+        translateCorpus=true;
+    }
+    if(translateCorpus)
+    {
+          // Set weights and translate development corpus
+      setLogLinearWeights(currWeights);
+      std::vector<std::vector<std::string> > nblistVec;
+      std::vector<std::vector<std::vector<double> > > scoreCompsVec;
+      std::vector<MertLattice> latticeVec;
+      int ret;
+      if(tuningPars.latticeMert)
+        ret=obtainNbestListBatch(user_id,srcSentVec,1,tuningPars.numWorkers,nblistVec,scoreCompsVec,&latticeVec,verbose);
+      else
+        ret=obtainNbestListBatch(user_id,srcSentVec,tuningPars.nbestSize,tuningPars.numWorkers,nblistVec,scoreCompsVec,NULL,verbose);
+      if(ret==THOT_ERROR)
+        return THOT_ERROR;
+      decWeightVec=inclWeightVec;
+
+          // Obtain translation quality. When lattice MERT is used, it is
+          // measured as the estimations obtained from the lattices (the
+          // BLEU of the best paths of the new lattices, which are
+          // compared with the preprocessed references), so that the
+          // qualities of all the iterations can be compared
+      if(tuningPars.latticeMert)
+      {
+        std::vector<double> weightVec(currWeights.begin(),currWeights.end());
+        std::vector<std::vector<const MertLattice*> > latticePtrVecs(latticeVec.size());
+        for(unsigned int i=0;i<latticeVec.size();++i)
+          latticePtrVecs[i].push_back(&latticeVec[i]);
+        quality=latticeMert.obtainQuality(latticeRefSentVec,latticePtrVecs,weightVec);
+      }
+      else
+      {
+        std::vector<std::string> bestTransVec;
+        for(unsigned int i=0;i<nblistVec.size();++i)
+          bestTransVec.push_back(nblistVec[i].empty()? "": nblistVec[i][0]);
+        tdCommonVars.scorerPtr->corpusScore(bestTransVec,refSentVec,quality);
+      }
+
+          // Merge lattices
+      if(tuningPars.latticeMert)
+      {
+        size_t numArcs=0;
+        for(unsigned int i=0;i<latticeVec.size();++i)
+        {
+          numArcs+=latticeVec[i].numArcs();
+          mergedLatticeVecs[i].push_back(MertLattice());
+          std::swap(mergedLatticeVecs[i].back(),latticeVec[i]);
+        }
+        if(verbose)
+          std::cerr<<"* Current translation quality: "<<quality<<" ("<<numArcs<<" new lattice arcs)"<<std::endl;
+      }
+
+          // Merge n-best lists
+      unsigned int numNewEntries=0;
+      for(unsigned int i=0;i<nblistVec.size() && !tuningPars.latticeMert;++i)
+      {
+        for(unsigned int j=0;j<nblistVec[i].size();++j)
+        {
+          std::vector<double> inclScoreComps;
+          for(unsigned int k=0;k<inclWeightIdxVec.size();++k)
+          {
+            if(inclWeightIdxVec[k]<scoreCompsVec[i][j].size())
+              inclScoreComps.push_back(scoreCompsVec[i][j][inclWeightIdxVec[k]]);
+            else
+              inclScoreComps.push_back(0);
+          }
+          if(mergedEntrySetVec[i].insert(std::make_pair(nblistVec[i][j],inclScoreComps)).second)
+          {
+            mergedNblistVec[i].push_back(nblistVec[i][j]);
+            mergedScoreCompsVec[i].push_back(inclScoreComps);
+            ++numNewEntries;
+          }
+        }
+      }
+      if(verbose && !tuningPars.latticeMert)
+        std::cerr<<"* Current translation quality: "<<quality<<" ("<<numNewEntries<<" new n-best list entries)"<<std::endl;
+    }
+    qualityVec.push_back(quality);
+
+        // Update best quality, only the qualities measured by
+        // translating the development corpus are taken into account
+    if(translateCorpus && (bestWeights.empty() || bestQuality<quality))
+    {
+      bestQuality=quality;
+      bestWeights=currWeights;
+    }
+
+        // Verify ending conditions, the number of iterations without
+        // improving the best quality is limited
+    if(niter>=tuningPars.maxIters)
+      break;
+    double streakBestQuality=qualityVec[0];
+    unsigned int decrStreakLen=1;
+    for(unsigned int i=1;i<qualityVec.size();++i)
+    {
+      if(streakBestQuality<qualityVec[i])
+      {
+        streakBestQuality=qualityVec[i];
+        decrStreakLen=1;
+      }
+      else
+        ++decrStreakLen;
+    }
+    if(decrStreakLen>=LLWT_LONGEST_DECR_STREAK)
+      break;
+    
+    if(tuningPars.latticeMert)
+    {
+          // Update weights given merged lattices
+      std::vector<double> weightVec(currWeights.begin(),currWeights.end());
+      std::vector<double> newWeightVec;
+      std::vector<std::vector<const MertLattice*> > latticePtrVecs;
+      obtainLatticePtrVecs(mergedLatticeVecs,latticePtrVecs);
+      double latticeQuality;
+      latticeMert.optimize(latticeRefSentVec,latticePtrVecs,tuningPars.includeVarBool,weightVec,newWeightVec,latticeQuality,verbose);
+      for(unsigned int i=0;i<inclWeightIdxVec.size();++i)
+        currWeights[inclWeightIdxVec[i]]=newWeightVec[inclWeightIdxVec[i]];
+    }
+    else
+    {
+          // Update weights given merged n-best lists
+      std::vector<double> newInclWeightVec;
+      tdCommonVars.llWeightUpdaterPtr->updateClosedCorpus(refSentVec,
+                                                          mergedNblistVec,
+                                                          mergedScoreCompsVec,
+                                                          inclWeightVec,
+                                                          newInclWeightVec);
+      for(unsigned int i=0;i<inclWeightIdxVec.size() && i<newInclWeightVec.size();++i)
+        currWeights[inclWeightIdxVec[i]]=newInclWeightVec[i];
+    }
+
+    ++niter;
+  }
+
+      // Set best weights
+  setLogLinearWeights(bestWeights,verbose);
+
+  if(verbose)
+  {
+    std::cerr<<"* Best translation quality: "<<bestQuality<<std::endl;
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------
+void ThotDecoder::translateSentence(int user_id,
+                                    const char *sentenceToTranslate,
+                                    std::string& result,
+                                    std::string& bestHypInfo,
+                                    int verbose/*=0*/)
+{
+  DecProfRequestScope profScope(&decProfStats);
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+      // Increase non_atomic_ops_running variable
+  increase_non_atomic_ops_running();
+  
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+  if(verbose) StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
+
+  pthread_mutex_lock(&per_user_mut[idx]);
+  /////////// begin of user mutex
+
+  if(verbose)
+  {
+    StdCerrThreadSafeCond(printTid)<<"Translating sentence: "<<sentenceToTranslate<<std::endl;
+  }
+  if(tdState.preprocId)
+  {
+    std::string preprocSrcSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,sentenceToTranslate,tdState.caseconv,true);
+    if(verbose)
+    {
+      StdCerrThreadSafeCond(printTid)<<" - preproc. source: "<<preprocSrcSent<<std::endl;
+    }
+
+        // Obtain translation using precalculated word-graph or translator
+    std::string aux=translateSentenceAux(idx,preprocSrcSent,bestHypInfo);
+    
+    result=postprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,aux.c_str(),tdState.caseconv);
+    if(verbose)
+    {
+      StdCerrThreadSafeCond(printTid)<<" - preproc. target: "<<aux<<std::endl;
+      StdCerrThreadSafeCond(printTid)<<" - posproc. target: "<<result<<std::endl;     
+    }
+  }
+  else
+  {
+    result=translateSentenceAux(idx,sentenceToTranslate,bestHypInfo,verbose);
+    if(verbose)
+    {
+      StdCerrThreadSafeCond(printTid)<<"- target translation: "<<result<<std::endl;
+    }
+  }
+
+  /////////// end of user mutex 
+  pthread_mutex_unlock(&per_user_mut[idx]);
+
+      // Decrease non_atomic_ops_running variable
+  decrease_non_atomic_ops_running();
+}
+
+//--------------------------
+int ThotDecoder::translateSentenceBatch(int user_id,
+                                        const std::vector<std::string>& sentVec,
+                                        unsigned int numWorkers,
+                                        batch_result_func_t* resultFunc,
+                                        void* resultData,
+                                        int verbose/*=0*/)
+{
+  if(numWorkers==0)
+    numWorkers=1;
+
+  if(verbose)
+  {
+    bool printTid=threadIdShouldBePrinted(verbose);
+    StdCerrThreadSafeCond(printTid)<<"Translating batch of "<<sentVec.size()<<" sentences using "<<numWorkers<<" workers"<<std::endl;
+  }
+  
+      // Obtain the users whose decoders are used by the workers
+  BatchTransData btData;
+  int ret=get_batch_worker_user_ids(user_id,numWorkers,btData.workerUserIdVec,verbose);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Initialize batch data
+  btData.thotDecoderPtr=this;
+  btData.sentVecPtr=&sentVec;
+  btData.resultFunc=resultFunc;
+  btData.resultData=resultData;
+  btData.verbose=verbose;
+  btData.resultVec.resize(sentVec.size());
+  btData.bestHypInfoVec.resize(sentVec.size());
+  btData.doneVec.resize(sentVec.size(),false);
+  btData.nextResult=0;
+  btData.delivering=false;
+  btData.aborted=false;
+  pthread_mutex_init(&btData.result_mut,NULL);
+
+      // Translate sentences
+  run_batch_tasks(translateSentenceBatchTask,(void*)&btData,sentVec.size(),numWorkers);
+  
+  pthread_mutex_destroy(&btData.result_mut);
+  
+  if(btData.aborted)
+    return THOT_ERROR;
+  else
+    return THOT_OK;
+}
+
+//--------------------------
+void ThotDecoder::translateSentenceBatchTask(void* taskData,
+                                             unsigned int taskIdx,
+                                             unsigned int workerIdx)
+{
+  BatchTransData* btDataPtr=(BatchTransData*) taskData;
+
+      // Translate sentence unless the batch has been aborted
+  pthread_mutex_lock(&btDataPtr->result_mut);
+  bool aborted=btDataPtr->aborted;
+  pthread_mutex_unlock(&btDataPtr->result_mut);
+
+  std::string result;
+  std::string bestHypInfo;
+  if(!aborted)
+  {
+    btDataPtr->thotDecoderPtr->translateSentence(btDataPtr->workerUserIdVec[workerIdx],
+                                                 (*btDataPtr->sentVecPtr)[taskIdx].c_str(),
+                                                 result,
+                                                 bestHypInfo,
+                                                 btDataPtr->verbose);
+  }
+  
+  pthread_mutex_lock(&btDataPtr->result_mut);
+  /////////// begin of mutex 
+
+      // Store result
+  btDataPtr->resultVec[taskIdx].swap(result);
+  btDataPtr->bestHypInfoVec[taskIdx].swap(bestHypInfo);
+  btDataPtr->doneVec[taskIdx]=true;
+
+      // Deliver the results that are ready in sentence order, unless
+      // another worker is already doing it (it will find this result
+      // before it stops)
+  if(!btDataPtr->delivering)
+  {
+    btDataPtr->delivering=true;
+    while(true)
+    {
+          // Collect the results that are ready
+      unsigned int firstResult=btDataPtr->nextResult;
+      std::vector<std::string> readyResultVec;
+      std::vector<std::string> readyBestHypInfoVec;
+      while(btDataPtr->nextResult<btDataPtr->doneVec.size() && btDataPtr->doneVec[btDataPtr->nextResult])
+      {
+        unsigned int i=btDataPtr->nextResult;
+        readyResultVec.push_back(std::string());
+        readyResultVec.back().swap(btDataPtr->resultVec[i]);
+        readyBestHypInfoVec.push_back(std::string());
+        readyBestHypInfoVec.back().swap(btDataPtr->bestHypInfoVec[i]);
+        ++btDataPtr->nextResult;
+      }
+      if(readyResultVec.empty())
+        break;
+      bool aborted=btDataPtr->aborted;
+      
+          // Deliver them without holding the mutex
+      pthread_mutex_unlock(&btDataPtr->result_mut);
+      for(unsigned int i=0;i<readyResultVec.size() && !aborted;++i)
+      {
+        int ret=btDataPtr->resultFunc(btDataPtr->resultData,firstResult+i,readyResultVec[i],readyBestHypInfoVec[i]);
+        if(ret==THOT_ERROR)
+          aborted=true;
+      }
+      pthread_mutex_lock(&btDataPtr->result_mut);
+      if(aborted)
+        btDataPtr->aborted=true;
+    }
+    btDataPtr->delivering=false;
+  }
+  
+  /////////// end of mutex 
+  pthread_mutex_unlock(&btDataPtr->result_mut);
+}
+
+//--------------------------
+int ThotDecoder::translateLongSentence(int user_id,
+                                       const char *sentenceToTranslate,
+                                       unsigned int maxSegmLen,
+                                       unsigned int numWorkers,
+                                       std::string& result,
+                                       std::string& bestHypInfo,
+                                       int verbose/*=0*/)
+{
+      // Sentences cannot exceed the length allowed by the decoder
+  if(maxSegmLen==0 || maxSegmLen>=MAX_SENTENCE_LENGTH_ALLOWED)
+    maxSegmLen=MAX_SENTENCE_LENGTH_ALLOWED-1;
+
+      // Sentences whose number of tokens does not exceed maxSegmLen
+      // are translated as usual (source words are a subset of the
+      // tokens, the remaining ones belong to translation constraints)
+  if(StrProcUtils::stringToStringVector(sentenceToTranslate).size()<=maxSegmLen)
+  {
+    translateSentence(user_id,sentenceToTranslate,result,bestHypInfo,verbose);
+    return THOT_OK;
+  }
+
+  DecProfRequestScope profScope(&decProfStats);
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+      // Split sentence
+  std::vector<std::string> segmVec;
+  increase_non_atomic_ops_running();
+  size_t idx=get_vecidx_for_user_id(user_id);
+  pthread_mutex_lock(&per_user_mut[idx]);
+  /////////// begin of user mutex
+  splitLongSentence(idx,sentenceToTranslate,maxSegmLen,segmVec,verbose);
+  /////////// end of user mutex 
+  pthread_mutex_unlock(&per_user_mut[idx]);
+  decrease_non_atomic_ops_running();
+
+      // Translate sentences that do not need to be split as usual
+  if(segmVec.size()<=1)
+  {
+    translateSentence(user_id,sentenceToTranslate,result,bestHypInfo,verbose);
+    return THOT_OK;
+  }
+
+  if(numWorkers==0)
+    numWorkers=1;
+
+  if(verbose)
+  {
+    StdCerrThreadSafeCond(printTid)<<"Translating long sentence as "<<segmVec.size()<<" segments using "<<numWorkers<<" workers"<<std::endl;
+  }
+
+      // Obtain the users whose decoders are used by the workers
+  LongSentTransData lstData;
+  int ret=get_batch_worker_user_ids(user_id,numWorkers,lstData.workerUserIdVec,verbose);
+  if(ret==THOT_ERROR)
+  {
+    result.clear();
+    bestHypInfo.clear();
+    return THOT_ERROR;
+  }
+
+      // Translate segments
+  lstData.thotDecoderPtr=this;
+  lstData.segmVecPtr=&segmVec;
+  lstData.verbose=verbose;
+  lstData.segmTransCandsVec.resize(segmVec.size());
+  lstData.profEnabled=DecProf::enabled();
+  lstData.workerProfDataVec.resize(numWorkers);
+  for(unsigned int w=0;w<numWorkers;++w)
+    lstData.workerProfDataVec[w].clear();
+  run_batch_tasks(translateLongSentSegmTask,(void*)&lstData,segmVec.size(),numWorkers);
+  for(unsigned int w=0;w<lstData.workerProfDataVec.size();++w)
+    DecProf::mergeIntoThread(lstData.workerProfDataVec[w]);
+
+      // Join translations of segments
+  increase_non_atomic_ops_running();
+  joinSegmTranslations(lstData.segmTransCandsVec,result,verbose);
+  decrease_non_atomic_ops_running();
+
+      // Best hypothesis information is given for each segment
+  bestHypInfo.clear();
+  for(unsigned int i=0;i<lstData.segmTransCandsVec.size();++i)
+  {
+    if(i>0)
+      bestHypInfo+=" ||| ";
+    bestHypInfo+=lstData.segmTransCandsVec[i].bestHypInfo;
+  }
+
+  if(verbose)
+  {
+    StdCerrThreadSafeCond(printTid)<<"- target translation: "<<result<<std::endl;
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------
+void ThotDecoder::translateLongSentSegmTask(void* taskData,
+                                            unsigned int taskIdx,
+                                            unsigned int workerIdx)
+{
+  LongSentTransData* lstDataPtr=(LongSentTransData*) taskData;
+
+      // Each task writes its own candidates, no mutex is required.
+      // Worker 0 is executed by the thread of the request
+  if(workerIdx==0)
+  {
+    lstDataPtr->thotDecoderPtr->translateSegment(lstDataPtr->workerUserIdVec[workerIdx],
+                                                 (*lstDataPtr->segmVecPtr)[taskIdx],
+                                                 lstDataPtr->segmTransCandsVec[taskIdx],
+                                                 lstDataPtr->verbose);
+  }
+  else
+  {
+    DecProfWorkerScope profScope(lstDataPtr->profEnabled,
+                                 lstDataPtr->workerProfDataVec[workerIdx]);
+    lstDataPtr->thotDecoderPtr->translateSegment(lstDataPtr->workerUserIdVec[workerIdx],
+                                                 (*lstDataPtr->segmVecPtr)[taskIdx],
+                                                 lstDataPtr->segmTransCandsVec[taskIdx],
+                                                 lstDataPtr->verbose);
+  }
+}
+
+//--------------------------
+void ThotDecoder::translateSegment(int user_id,
+                                   std::string segment,
+                                   SegmTransCands& segmTransCands,
+                                   int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+      // Increase non_atomic_ops_running variable
+  increase_non_atomic_ops_running();
+  
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+
+  pthread_mutex_lock(&per_user_mut[idx]);
+  /////////// begin of user mutex
+
+  if(verbose)
+  {
+    StdCerrThreadSafeCond(printTid)<<"Translating segment: "<<segment<<std::endl;
+  }
+
+  std::string srcSegm=segment;
+  if(tdState.preprocId)
+    srcSegm=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,segment,tdState.caseconv,true);
+
+      // Obtain best translation, the word graph is generated to obtain
+      // alternative translations
+  if(tdPerUserVarsVec[idx].stackDecoderRecPtr)
+    tdPerUserVarsVec[idx].stackDecoderRecPtr->enableWordGraph();
+  
+  SmtModel::Hypothesis hyp=tdPerUserVarsVec[idx].stackDecoderPtr->translate(srcSegm.c_str());
+  DecProfPhaseTimer wgTimer(DEC_PROF_WG_OUTPUT);
+  std::vector<std::pair<Score,std::string> > nblist;
+  nblist.push_back(std::make_pair(hyp.getScore(),tdPerUserVarsVec[idx].smtModelPtr->getTransInPlainText(hyp)));
+  std::ostringstream stream;
+  tdPerUserVarsVec[idx].smtModelPtr->printHyp(hyp,stream);
+  segmTransCands.bestHypInfo=stream.str();
+  segmTransCands.bestHypInfo.erase(std::remove(segmTransCands.bestHypInfo.begin(),segmTransCands.bestHypInfo.end(),'\n'),segmTransCands.bestHypInfo.end());
+
+      // Obtain n-best translations
+  if(tdPerUserVarsVec[idx].stackDecoderRecPtr)
+  {
+    std::vector<std::pair<Score,std::string> > wgNblist;
+    std::vector<std::vector<Score> > scoreCompsVec;
+    tdPerUserVarsVec[idx].stackDecoderRecPtr->getWordGraphPtr()->obtainNbestList(TD_LONG_SENT_NBEST_SIZE,wgNblist,scoreCompsVec);
+    nblist.insert(nblist.end(),wgNblist.begin(),wgNblist.end());
+    tdPerUserVarsVec[idx].stackDecoderRecPtr->disableWordGraph();
+  }
+
+      // Store candidates, postprocessing them if required
+  std::set<std::string> transSet;
+  segmTransCands.trgWordsVec.clear();
+  segmTransCands.resultVec.clear();
+  segmTransCands.scoreVec.clear();
+  for(unsigned int i=0;i<nblist.size();++i)
+  {
+    if(transSet.find(nblist[i].second)==transSet.end())
+    {
+      transSet.insert(nblist[i].second);
+      segmTransCands.trgWordsVec.push_back(StrProcUtils::stringToStringVector(nblist[i].second));
+      if(tdState.preprocId)
+        segmTransCands.resultVec.push_back(postprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,nblist[i].second.c_str(),tdState.caseconv));
+      else
+        segmTransCands.resultVec.push_back(nblist[i].second);
+      segmTransCands.scoreVec.push_back(nblist[i].first);
+    }
+  }
+
+  if(verbose)
+  {
+    StdCerrThreadSafeCond(printTid)<<"- segment translation: "<<segmTransCands.resultVec[0]<<" ("<<segmTransCands.resultVec.size()<<" candidates)"<<std::endl;
+  }
+  
+  /////////// end of user mutex 
   pthread_mutex_unlock(&per_user_mut[idx]);
 
       // Decrease non_atomic_ops_running variable
   decrease_non_atomic_ops_running();
 }
 
+//--------------------------
+int ThotDecoder::obtainNbestListBatch(int user_id,
+                                      const std::vector<std::string>& sentVec,
+                                      unsigned int nbestSize,
+                                      unsigned int numWorkers,
+                                      std::vector<std::vector<std::string> >& nblistVec,
+                                      std::vector<std::vector<std::vector<double> > >& scoreCompsVec,
+                                      std::vector<MertLattice>* latticeVecPtr/*=NULL*/,
+                                      int verbose/*=0*/)
+{
+  if(numWorkers==0)
+    numWorkers=1;
+
+  if(verbose)
+  {
+    bool printTid=threadIdShouldBePrinted(verbose);
+    StdCerrThreadSafeCond(printTid)<<"Obtaining n-best lists for "<<sentVec.size()<<" sentences using "<<numWorkers<<" workers"<<std::endl;
+  }
+
+      // Obtain the users whose decoders are used by the workers
+  NbestBatchData nbData;
+  int ret=get_batch_worker_user_ids(user_id,numWorkers,nbData.workerUserIdVec,verbose);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Obtain n-best lists, each task writes its own list
+  nbData.thotDecoderPtr=this;
+  nbData.sentVecPtr=&sentVec;
+  nbData.nbestSize=nbestSize;
+  nbData.verbose=verbose;
+  nbData.nblistVec.resize(sentVec.size());
+  nbData.scoreCompsVec.resize(sentVec.size());
+  nbData.latticeVecPtr=latticeVecPtr;
+  if(latticeVecPtr)
+  {
+    latticeVecPtr->clear();
+    latticeVecPtr->resize(sentVec.size());
+  }
+  nbData.errorVec.resize(sentVec.size(),false);
+  run_batch_tasks(obtainNbestListBatchTask,(void*)&nbData,sentVec.size(),numWorkers);
+
+  if(std::find(nbData.errorVec.begin(),nbData.errorVec.end(),true)!=nbData.errorVec.end())
+    return THOT_ERROR;
+
+  nblistVec.swap(nbData.nblistVec);
+  scoreCompsVec.swap(nbData.scoreCompsVec);
+  return THOT_OK;
+}
+
+//--------------------------
+void ThotDecoder::obtainNbestListBatchTask(void* taskData,
+                                           unsigned int taskIdx,
+                                           unsigned int workerIdx)
+{
+  NbestBatchData* nbDataPtr=(NbestBatchData*) taskData;
+
+  int ret=nbDataPtr->thotDecoderPtr->obtainNbestList(nbDataPtr->workerUserIdVec[workerIdx],
+                                                     (*nbDataPtr->sentVecPtr)[taskIdx],
+                                                     nbDataPtr->nbestSize,
+                                                     nbDataPtr->nblistVec[taskIdx],
+                                                     nbDataPtr->scoreCompsVec[taskIdx],
+                                                     nbDataPtr->latticeVecPtr? &(*nbDataPtr->latticeVecPtr)[taskIdx]: NULL,
+                                                     nbDataPtr->verbose);
+  nbDataPtr->errorVec[taskIdx]=(ret==THOT_ERROR);
+}
+
+//--------------------------
+int ThotDecoder::obtainNbestList(int user_id,
+                                 std::string sentence,
+                                 unsigned int nbestSize,
+                                 std::vector<std::string>& nblist,
+                                 std::vector<std::vector<double> >& scoreCompsVec,
+                                 MertLattice* latticePtr/*=NULL*/,
+                                 int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+  int ret=THOT_OK;
+  
+      // Increase non_atomic_ops_running variable
+  increase_non_atomic_ops_running();
+  
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+
+  pthread_mutex_lock(&per_user_mut[idx]);
+  /////////// begin of user mutex
+
+  nblist.clear();
+  scoreCompsVec.clear();
+  if(tdPerUserVarsVec[idx].stackDecoderRecPtr)
+  {
+    std::string srcSent=sentence;
+    if(tdState.preprocId)
+      srcSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,sentence,tdState.caseconv,true);
+
+        // Translate sentence generating its word graph
+    tdPerUserVarsVec[idx].stackDecoderRecPtr->enableWordGraph();
+    tdPerUserVarsVec[idx].stackDecoderPtr->translate(srcSent.c_str());
+
+        // Obtain n-best list
+    std::vector<std::pair<Score,std::string> > wgNblist;
+    tdPerUserVarsVec[idx].stackDecoderRecPtr->getWordGraphPtr()->obtainNbestList(nbestSize,wgNblist,scoreCompsVec);
+    if(latticePtr)
+      latticePtr->build(*tdPerUserVarsVec[idx].stackDecoderRecPtr->getWordGraphPtr());
+    tdPerUserVarsVec[idx].stackDecoderRecPtr->disableWordGraph();
+    for(unsigned int i=0;i<wgNblist.size();++i)
+    {
+      if(tdState.preprocId)
+        nblist.push_back(postprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,wgNblist[i].second.c_str(),tdState.caseconv));
+      else
+        nblist.push_back(wgNblist[i].second);
+    }
+
+    if(verbose)
+    {
+      StdCerrThreadSafeCond(printTid)<<"n-best list for sentence: "<<sentence<<" ("<<nblist.size()<<" entries)"<<std::endl;
+    }
+  }
+  else
+  {
+    StdCerrThreadSafeCond(printTid)<<"Error: n-best lists cannot be obtained, the decoder does not generate word graphs"<<std::endl;
+    ret=THOT_ERROR;
+  }
+  
+  /////////// end of user mutex 
+  pthread_mutex_unlock(&per_user_mut[idx]);
+
+      // Decrease non_atomic_ops_running variable
+  decrease_non_atomic_ops_running();
+
+  return ret;
+}
+
+//--------------------------
+double ThotDecoder::obtainNbestListsQuality(const std::vector<std::string>& refSentVec,
+                                            const std::vector<std::vector<std::string> >& nblistVec,
+                                            const std::vector<std::vector<std::vector<double> > >& scoreCompsVec,
+                                            const std::vector<double>& weightVec)
+{
+      // Choose the translations with the best score
+  std::vector<std::string> bestTransVec;
+  for(unsigned int i=0;i<nblistVec.size();++i)
+  {
+    std::string bestTrans;
+    double bestScore=0;
+    for(unsigned int j=0;j<nblistVec[i].size();++j)
+    {
+      double score=0;
+      for(unsigned int k=0;k<weightVec.size() && k<scoreCompsVec[i][j].size();++k)
+        score+=weightVec[k]*scoreCompsVec[i][j][k];
+      if(j==0 || bestScore<score)
+      {
+        bestScore=score;
+        bestTrans=nblistVec[i][j];
+      }
+    }
+    bestTransVec.push_back(bestTrans);
+  }
+
+      // Obtain quality
+  double quality;
+  tdCommonVars.scorerPtr->corpusScore(bestTransVec,refSentVec,quality);
+  return quality;
+}
+
+//--------------------------
+void ThotDecoder::obtainLatticePtrVecs(const std::vector<std::vector<MertLattice> >& latticeVecs,
+                                       std::vector<std::vector<const MertLattice*> >& latticePtrVecs)
+{
+  latticePtrVecs.clear();
+  latticePtrVecs.resize(latticeVecs.size());
+  for(unsigned int i=0;i<latticeVecs.size();++i)
+  {
+    for(unsigned int j=0;j<latticeVecs[i].size();++j)
+      latticePtrVecs[i].push_back(&latticeVecs[i][j]);
+  }
+}
+
+//--------------------------
+void ThotDecoder::splitLongSentence(size_t idx,
+                                    std::string sentence,
+                                    unsigned int maxSegmLen,
+                                    std::vector<std::string>& segmVec,
+                                    int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+      // Obtain source words and translation constraints
+  BaseTranslationConstraints* trConstraintsPtr=tdPerUserVarsVec[idx].trConstraintsPtr;
+  trConstraintsPtr->obtainTransConstraints(sentence);
+  std::vector<std::string> srcSentVec=trConstraintsPtr->getSrcSentVec();
+  std::set<std::pair<PositionIndex,PositionIndex> > constrSrcPhrSet=trConstraintsPtr->getConstrainedSrcPhrases();
+
+  segmVec.clear();
+  if(srcSentVec.size()<=maxSegmLen)
+  {
+    segmVec.push_back(sentence);
+    return;
+  }
+
+      // Sentences cannot be split inside the source phrases of the
+      // constraints
+  unsigned int numWords=srcSentVec.size();
+  std::vector<bool> splitAllowedVec(numWords+1,true);
+  std::set<std::pair<PositionIndex,PositionIndex> >::const_iterator setIter;
+  for(setIter=constrSrcPhrSet.begin();setIter!=constrSrcPhrSet.end();++setIter)
+  {
+    for(PositionIndex j=setIter->first;j<setIter->second;++j)
+      splitAllowedVec[j]=false;
+    if(setIter->second-setIter->first+1>maxSegmLen)
+      maxSegmLen=setIter->second-setIter->first+1;
+  }
+
+      // Segments shorter than the reordering limit are penalized,
+      // since they restrict the reorderings that the decoder is able
+      // to explore
+  unsigned int minSegmLen=tdCommonVars.smtModelPtr->get_U_par()+1;
+  if(minSegmLen>maxSegmLen/2)
+    minSegmLen=maxSegmLen/2;
+  
+      // Obtain split points of minimum cost, costVec[j] stores the cost
+      // of the best segmentation of the first j words
+  std::vector<unsigned int> costVec(numWords+1,UINT_MAX);
+  std::vector<unsigned int> prevSplitVec(numWords+1,0);
+  costVec[0]=0;
+  for(unsigned int j=1;j<=numWords;++j)
+  {
+    if(!splitAllowedVec[j])
+      continue;
+    
+    unsigned int splitCost=(j<numWords)? splitPointCost(srcSentVec[j-1]): 0;
+    for(unsigned int len=1;len<=maxSegmLen && len<=j;++len)
+    {
+      unsigned int i=j-len;
+      if(costVec[i]!=UINT_MAX)
+      {
+        unsigned int cost=costVec[i]+TD_LONG_SENT_SEGM_COST+splitCost;
+        if(len<minSegmLen)
+          cost+=TD_LONG_SENT_SHORT_SEGM_COST;
+        if(cost<costVec[j])
+        {
+          costVec[j]=cost;
+          prevSplitVec[j]=i;
+        }
+      }
+    }
+  }
+
+      // Obtain segments, the constraints that they contain are kept
+  std::vector<std::pair<PositionIndex,PositionIndex> > segmLimitsVec;
+  for(unsigned int j=numWords;j>0;j=prevSplitVec[j])
+    segmLimitsVec.push_back(std::make_pair(prevSplitVec[j]+1,j));
+  for(unsigned int i=segmLimitsVec.size();i>0;--i)
+  {
+    segmVec.push_back(trConstraintsPtr->getRawSrcPhrase(segmLimitsVec[i-1]));
+    if(verbose)
+    {
+      StdCerrThreadSafeCond(printTid)<<"- segment "<<segmLimitsVec.size()-i<<": "<<segmVec.back()<<std::endl;
+    }
+  }
+}
+
+//--------------------------
+unsigned int ThotDecoder::splitPointCost(const std::string& word)
+{
+  if(word.empty())
+    return TD_LONG_SENT_NO_PUNCT_COST;
+
+      // Splitting after punctuation marks ending clauses is preferred
+  char lastChar=word[word.size()-1];
+  switch(lastChar)
+  {
+    case '.':
+    case '!':
+    case '?':
+    case ';':
+    case ':':
+      return 0;
+    case ',':
+    case ')':
+      return TD_LONG_SENT_WEAK_PUNCT_COST;
+    default:
+      return TD_LONG_SENT_NO_PUNCT_COST;
+  }
+}
+
+//--------------------------
+void ThotDecoder::joinSegmTranslations(const std::vector<SegmTransCands>& segmTransCandsVec,
+                                       std::string& result,
+                                       int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+  result.clear();
+  if(segmTransCandsVec.empty())
+    return;
+
+  float lmWeight;
+  BaseNgramLM<LM_State>* lmPtr=getLangModelPtr(lmWeight);
+
+      // Obtain best sequence of candidates. The translations of the
+      // segments were scored as complete sentences, so the language
+      // model scores at the boundaries are replaced by the scores
+      // obtained when the translations are concatenated
+  std::vector<std::vector<unsigned int> > bestPrevCandVec(segmTransCandsVec.size());
+  std::vector<Score> accScoreVec=segmTransCandsVec[0].scoreVec;
+  for(unsigned int k=1;k<segmTransCandsVec.size();++k)
+  {
+    const SegmTransCands& prevCands=segmTransCandsVec[k-1];
+    const SegmTransCands& currCands=segmTransCandsVec[k];
+    std::vector<Score> newAccScoreVec(currCands.scoreVec.size());
+    bestPrevCandVec[k].resize(currCands.scoreVec.size(),0);
+
+    if(lmPtr==NULL)
+    {
+      unsigned int bestPrev=std::max_element(accScoreVec.begin(),accScoreVec.end())-accScoreVec.begin();
+      for(unsigned int c=0;c<currCands.scoreVec.size();++c)
+      {
+        newAccScoreVec[c]=accScoreVec[bestPrev]+currCands.scoreVec[c];
+        bestPrevCandVec[k][c]=bestPrev;
+      }
+    }
+    else
+    {
+          // Obtain language model states after the previous
+          // candidates and the end of sentence scores
+      std::vector<LM_State> prevStateVec(prevCands.scoreVec.size());
+      std::vector<Score> prevEosScoreVec(prevCands.scoreVec.size());
+      for(unsigned int p=0;p<prevCands.scoreVec.size();++p)
+      {
+        lmPtr->getStateForBeginOfSentence(prevStateVec[p]);
+        for(unsigned int i=0;i<prevCands.trgWordsVec[p].size();++i)
+          lmPtr->getNgramLgProbGivenState(lmPtr->stringToWordIndex(prevCands.trgWordsVec[p][i]),prevStateVec[p]);
+        LM_State auxState=prevStateVec[p];
+        prevEosScoreVec[p]=(double)lmPtr->getLgProbEndGivenState(auxState);
+      }
+
+      for(unsigned int c=0;c<currCands.scoreVec.size();++c)
+      {
+        std::vector<WordIndex> currWordIdxVec;
+        for(unsigned int i=0;i<currCands.trgWordsVec[c].size();++i)
+          currWordIdxVec.push_back(lmPtr->stringToWordIndex(currCands.trgWordsVec[c][i]));
+
+            // Obtain score of the current candidate as a sentence
+        Score currBosScore=0;
+        LM_State state;
+        lmPtr->getStateForBeginOfSentence(state);
+        for(unsigned int i=0;i<currWordIdxVec.size();++i)
+          currBosScore+=(double)lmPtr->getNgramLgProbGivenState(currWordIdxVec[i],state);
+
+            // Obtain best previous candidate
+        for(unsigned int p=0;p<prevCands.scoreVec.size();++p)
+        {
+          Score joinedScore=0;
+          state=prevStateVec[p];
+          for(unsigned int i=0;i<currWordIdxVec.size();++i)
+            joinedScore+=(double)lmPtr->getNgramLgProbGivenState(currWordIdxVec[i],state);
+          Score score=accScoreVec[p]+currCands.scoreVec[c]+lmWeight*(joinedScore-currBosScore-prevEosScoreVec[p]);
+          if(p==0 || score>newAccScoreVec[c])
+          {
+            newAccScoreVec[c]=score;
+            bestPrevCandVec[k][c]=p;
+          }
+        }
+      }
+    }
+    accScoreVec.swap(newAccScoreVec);
+  }
+
+      // Obtain result
+  std::vector<unsigned int> bestCandVec(segmTransCandsVec.size());
+  bestCandVec.back()=std::max_element(accScoreVec.begin(),accScoreVec.end())-accScoreVec.begin();
+  for(unsigned int k=segmTransCandsVec.size()-1;k>0;--k)
+    bestCandVec[k-1]=bestPrevCandVec[k][bestCandVec[k]];
+  for(unsigned int k=0;k<segmTransCandsVec.size();++k)
+  {
+    const std::string& segmResult=segmTransCandsVec[k].resultVec[bestCandVec[k]];
+    if(!result.empty() && !segmResult.empty())
+      result+=" ";
+    result+=segmResult;
+    if(verbose)
+    {
+      StdCerrThreadSafeCond(printTid)<<"- candidate "<<bestCandVec[k]<<" chosen for segment "<<k<<std::endl;
+    }
+  }
+}
+
+//--------------------------
+BaseNgramLM<LM_State>* ThotDecoder::getLangModelPtr(float& weight)
+{
+  if(tdCommonVars.featureBasedImplEnabled)
+  {
+        // Use first available language model feature
+    FeaturesInfo<SmtModel::HypScoreInfo>* featsInfoPtr=tdCommonVars.featureHandler.getFeatureInfoPtr();
+    std::vector<LangModelFeat<SmtModel::HypScoreInfo>* > langModelFeatsVec=featsInfoPtr->getLangModelFeatPtrs();
+    if(langModelFeatsVec.empty())
+      return NULL;
+    weight=langModelFeatsVec[0]->getWeight();
+    return langModelFeatsVec[0]->get_lmptr();
+  }
+  else
+  {
+    if(tdCommonVars.langModelInfoPtr==NULL)
+      return NULL;
+    weight=tdCommonVars.langModelInfoPtr->langModelPars.lmScaleFactor;
+    return tdCommonVars.langModelInfoPtr->lModelPtr;
+  }
+}
+
 //--------------------------
 std::string ThotDecoder::translateSentenceAux(size_t idx,
                                               std::string sentenceToTranslate,
@@ -1879,11 +3247,16 @@ std::string ThotDecoder::translateSentenceAux(size_t idx,
       StdCerrThreadSafeCond(printTid)<<"- best hypothesis: "<<std::endl;
       tdPerUserVarsVec[idx].smtModelPtr->printHyp(hyp,StdCerrThreadSafeCond(printTid));
     }
+    DecProfPhaseTimer postprocTimer(DEC_PROF_POSTPROC);
     std::string result=tdPerUserVarsVec[idx].smtModelPtr->getTransInPlainText(hyp);
     std::ostringstream stream;
     tdPerUserVarsVec[idx].smtModelPtr->printHyp(hyp,stream);
     bestHypInfo=stream.str();
     bestHypInfo.erase(std::remove(bestHypInfo.begin(), bestHypInfo.end(), '\n'), bestHypInfo.end());
+
+        // Return the caches of the model to the pool, so that idle users
+        // do not retain them
+    tdPerUserVarsVec[idx].smtModelPtr->releaseSentenceCaches();
       
     return result;
   }
@@ -1953,6 +3326,7 @@ void ThotDecoder::startCat(int user_id,
                            std::string &catResult,
                            int verbose/*=0*/)
 {
+  DecProfRequestScope profScope(&decProfStats);
   bool printTid=threadIdShouldBePrinted(verbose);
 
       // Increase non_atomic_ops_running variable
@@ -2031,6 +3405,7 @@ void ThotDecoder::addStrToPref(int user_id,
                                std::string &catResult,
                                int verbose/*=0*/)
 {
+  DecProfRequestScope profScope(&decProfStats);
   bool printTid=threadIdShouldBePrinted(verbose);
 
       // Increase non_atomic_ops_running variable
@@ -2249,6 +3624,9 @@ int ThotDecoder::use_caseconv(int user_id,
 //--------------------------
 void ThotDecoder::clearTrans(int /*verbose=0*/)
 {
+      // Train the queued sentence pairs before clearing the models
+  stopAsyncOnlineTraining();
+
   pthread_mutex_lock(&atomic_op_mut);
   /////////// begin of mutex 
 
@@ -2268,6 +3646,10 @@ void ThotDecoder::clearTrans(int /*verbose=0*/)
   totalPrefixVec.clear();
   userIdToIdx.clear();
   idxDataReleased.clear();
+  freeIdxVec.clear();
+  pthread_mutex_lock(&batch_worker_mut);
+  batchWorkerUserIdMap.clear();
+  pthread_mutex_unlock(&batch_worker_mut);
 
       // Unlock non_atomic_op_cond mutex
   pthread_mutex_unlock(&non_atomic_op_mut);
@@ -2276,6 +3658,33 @@ void ThotDecoder::clearTrans(int /*verbose=0*/)
   pthread_mutex_unlock(&atomic_op_mut);
 }
 
+//--------------------------
+void ThotDecoder::setProfSampleRate(unsigned int sampleRate)
+{
+      // Profiling statistics are protected by their own mutex
+  decProfStats.setSampleRate(sampleRate);
+}
+
+//--------------------------
+void ThotDecoder::getProfStats(std::string& jsonStr)
+{
+  std::ostringstream stream;
+  decProfStats.printJson(stream);
+  jsonStr=stream.str();
+}
+
+//--------------------------
+void ThotDecoder::clearProfStats(void)
+{
+  decProfStats.clear();
+}
+
+//--------------------------
+bool ThotDecoder::getLastProfSample(DecProfData& profData)
+{
+  return decProfStats.getLastSample(profData);
+}
+
 //--------------------------
 int ThotDecoder::printModels(int verbose/*=0*/)
 {
@@ -2409,6 +3818,38 @@ int ThotDecoder::printModelWeights(void)
   return THOT_OK;
 }
 
+//--------------------------
+void ThotDecoder::getLogLinearWeights(std::vector<std::pair<std::string,float> >& compWeights)
+{
+  pthread_mutex_lock(&atomic_op_mut);
+  /////////// begin of mutex 
+
+  tdCommonVars.smtModelPtr->getWeights(compWeights);
+
+  /////////// end of mutex 
+  pthread_mutex_unlock(&atomic_op_mut);
+}
+
+//--------------------------
+void ThotDecoder::setLogLinearWeights(const std::vector<float>& weightVec,
+                                      int verbose/*=0*/)
+{
+  pthread_mutex_lock(&atomic_op_mut);
+  /////////// begin of mutex 
+
+      // Wait until all non-atomic operations have finished
+  wait_on_non_atomic_op_cond();
+
+      // Weights are shared by the models of all users
+  set_tmw(weightVec,verbose);
+
+      // Unlock non_atomic_op_cond mutex
+  pthread_mutex_unlock(&non_atomic_op_mut);
+
+  /////////// end of mutex 
+  pthread_mutex_unlock(&atomic_op_mut);
+}
+
 //--------------------------
 void ThotDecoder::wait_on_non_atomic_op_cond(void)
 {
@@ -2797,13 +4238,14 @@ std::string ThotDecoder::preprocLine(BasePrePosProcessor* prePosProcessorPtr,
                                      bool caseconv,
                                      bool keepPreprocInfo)
 {
-  pthread_mutex_lock(&preproc_mut);
-  /////////// begin of preproc mutex 
-  std::string result=prePosProcessorPtr->preprocLine(str,caseconv,keepPreprocInfo);
-  /////////// end of preproc mutex 
-  pthread_mutex_unlock(&preproc_mut);
+  DecProfPhaseTimer preprocTimer(DEC_PROF_PREPROC);
 
-  return result;
+      // Each user has its own pre/pos-processing module, which is
+      // protected by the mutex of the user
+  if(prePosProcessorPtr==NULL)
+    return str;
+  else
+    return prePosProcessorPtr->preprocLine(str,caseconv,keepPreprocInfo);
 }
 
 //--------------------------
@@ -2811,13 +4253,11 @@ std::string ThotDecoder::postprocLine(BasePrePosProcessor* prePosProcessorPtr,
                                       std::string str,
                                       bool caseconv)
 {
-  pthread_mutex_lock(&preproc_mut);
-  /////////// begin of preproc mutex
-  std::string result=prePosProcessorPtr->postprocLine(str,caseconv);
-  /////////// end of preproc mutex 
-  pthread_mutex_unlock(&preproc_mut);
-
-  return result;
+  DecProfPhaseTimer postprocTimer(DEC_PROF_POSTPROC);
+  if(prePosProcessorPtr==NULL)
+    return str;
+  else
+    return prePosProcessorPtr->postprocLine(str,caseconv);
 }
 
 //--------------------------
@@ -2849,10 +4289,11 @@ void ThotDecoder::destroy_feat_impl(void)
   pthread_mutex_destroy(&user_id_to_idx_mut);
   pthread_mutex_destroy(&atomic_op_mut);
   pthread_mutex_destroy(&non_atomic_op_mut);
-  pthread_mutex_destroy(&preproc_mut);
   pthread_cond_destroy(&non_atomic_op_cond);
   for(unsigned int i=0;i<per_user_mut.size();++i)
     pthread_mutex_destroy(&per_user_mut[i]);
+  pthread_mutex_destroy(&async_training_mut);
+  pthread_mutex_destroy(&batch_worker_mut);
 }
 
 //--------------------------
@@ -2882,10 +4323,11 @@ void ThotDecoder::destroy_legacy_impl(void)
   pthread_mutex_destroy(&user_id_to_idx_mut);
   pthread_mutex_destroy(&atomic_op_mut);
   pthread_mutex_destroy(&non_atomic_op_mut);
-  pthread_mutex_destroy(&preproc_mut);
   pthread_cond_destroy(&non_atomic_op_cond);
   for(unsigned int i=0;i<per_user_mut.size();++i)
     pthread_mutex_destroy(&per_user_mut[i]);
+  pthread_mutex_destroy(&async_training_mut);
+  pthread_mutex_destroy(&batch_worker_mut);
 }
 
 //--------------------------
@@ -57,12 +57,18 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "ThotDecoderPerUserVars.h"
 #include "ThotDecoderState.h"
 #include "ThotDecoderUserPars.h"
+#include "LlWeightTuningPars.h"
+#include "LatticeMert.h"
 #include "ModelDescriptorUtils.h"
 
 #include "StdCerrThreadSafePrint.h"
 #include "StdCerrThreadSafeTidPrint.h"
+#include "ThreadPool.h"
+#include "DecProfiler.h"
+#include "OnlineTrainingQueue.h"
 #include <options.h>
 #include <pthread.h>
+#include <limits.h>
 #include <sstream>
 
 //--------------- Constants ------------------------------------------
@@ -84,6 +90,29 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define THOTDEC_NORMAL_VERBOSE_MODE           1
 #define THOTDEC_DEBUG_VERBOSE_MODE            2
 
+// User identifiers of the decoders used by the workers of batch
+// translations are assigned starting from this value
+#define TD_FIRST_BATCH_WORKER_USER_ID   INT_MIN
+
+// Parameters of long sentence translation
+#define TD_LONG_SENT_NBEST_SIZE        10  // Number of translations of
+                                           // each segment considered
+                                           // when the segments are
+                                           // joined
+#define TD_LONG_SENT_SEGM_COST          2  // Costs used to choose the
+#define TD_LONG_SENT_SHORT_SEGM_COST    2  // split points of long
+#define TD_LONG_SENT_WEAK_PUNCT_COST    1  // sentences
+#define TD_LONG_SENT_NO_PUNCT_COST      4
+
+//--------------- typedefs -------------------------------------------
+
+typedef int batch_result_func_t(void* resultData,
+                                unsigned int sentIdx,
+                                const std::string& result,
+                                const std::string& bestHypInfo);
+    // Type of the functions receiving the results of batch
+    // translations. Returning THOT_ERROR aborts the batch
+
 //--------------- Classes --------------------------------------------
 
 //--------------- ThotDecoder class
@@ -112,6 +141,23 @@ class ThotDecoder
                           const char *srcSent,
                           const char *refSent,
                           int verbose=0);
+      // Trains the models with a sentence pair. If the asynchronous
+      // mode is enabled, the pair is added to the online training
+      // queue and the function returns immediately
+  int startAsyncOnlineTraining(std::string journalFileName,
+                               unsigned int maxBatchSize,
+                               int verbose=0);
+      // Enables the asynchronous mode of onlineTrainSentPair(). A
+      // trainer thread takes the queued pairs in batches of up to
+      // maxBatchSize pairs (zero means no limit), each batch is
+      // trained as a single atomic operation. If journalFileName is
+      // not empty, queued pairs are stored in that file until they are
+      // trained, the pending pairs of previous executions are loaded
+  void stopAsyncOnlineTraining(void);
+      // Trains the pending pairs and disables the asynchronous mode
+  void getOnlineTrainingStats(std::string& jsonStr);
+      // Obtains the depth and lag of the online training queue in
+      // JSON format
   void updateLogLinearWeights(std::string refSent,
                               WordGraph* wgPtr,
                               int verbose=0);
@@ -119,6 +165,28 @@ class ThotDecoder
                const char *strx,
                const char *stry,
                int verbose=0);
+  int tuneLogLinearWeights(int user_id,
+                           const std::vector<std::string>& srcSentVec,
+                           const std::vector<std::string>& refSentVec,
+                           const LlWeightTuningPars& tuningPars,
+                           std::vector<float>& bestWeights,
+                           double& bestQuality,
+                           int verbose=0);
+      // Tunes the log-linear weights on a development corpus without
+      // reloading the models. At each iteration, the corpus is
+      // translated in parallel and the n-best lists obtained from the
+      // word graphs are merged with those of previous iterations. The
+      // weights are then updated over the merged n-best lists. If they
+      // do not move beyond the trust region of the weights used in the
+      // last translation, the translation quality is estimated from
+      // the merged n-best lists instead of translating the corpus
+      // again, unless the estimation improves the best quality, since
+      // only the qualities obtained by translating the corpus can
+      // update the best weights. The best weights are set at the end.
+      // If lattice MERT is used, the lattices are merged instead of
+      // the n-best lists and every quality, bestQuality included, is
+      // the BLEU of the best paths of the lattices with respect to the
+      // preprocessed references
 
       // Functions to translate sentences
   void translateSentence(int user_id,
@@ -126,6 +194,37 @@ class ThotDecoder
                          std::string& result,
                          std::string& bestHypInfo,
                          int verbose=0);
+  int translateSentenceBatch(int user_id,
+                             const std::vector<std::string>& sentVec,
+                             unsigned int numWorkers,
+                             batch_result_func_t* resultFunc,
+                             void* resultData,
+                             int verbose=0);
+      // Translates the sentences of sentVec using numWorkers threads,
+      // each one with its own decoder. The first worker uses the
+      // decoder of user_id, the rest use decoders created with the
+      // parameters of user_id. resultFunc is called once per sentence
+      // and in sentence order, as soon as the translations of the
+      // sentence and of all the previous ones are available
+  int translateLongSentence(int user_id,
+                            const char *sentenceToTranslate,
+                            unsigned int maxSegmLen,
+                            unsigned int numWorkers,
+                            std::string& result,
+                            std::string& bestHypInfo,
+                            int verbose=0);
+      // Translates a sentence that may be longer than the decoder
+      // allows. Sentences with more than maxSegmLen words (or with
+      // more words than allowed by the decoder if maxSegmLen is zero)
+      // are split at punctuation marks that are not covered by
+      // translation constraints, the segments are translated in
+      // parallel by numWorkers threads and their translations are
+      // joined choosing, among the n-best translations of each
+      // segment, those that obtain the best language model score at
+      // the boundaries. Sentences with at most maxSegmLen tokens are
+      // directly translated by translateSentence(). THOT_ERROR is
+      // returned, with empty result, if the decoders of the workers
+      // could not be obtained
   void sentPairVerCov(int user_id,
                       const char *srcSent,
                       const char *refSent,
@@ -156,11 +255,23 @@ class ThotDecoder
       // Clear translator data structures
   void clearTrans(int verbose=0);
 
+      // Profiling functions
+  void setProfSampleRate(unsigned int sampleRate);
+      // Profiles one out of every sampleRate translation requests
+      // (zero disables profiling)
+  void getProfStats(std::string& jsonStr);
+      // Obtains the profiling data collected so far in JSON format
+  void clearProfStats(void);
+  bool getLastProfSample(DecProfData& profData);
+
       // Function to print the models
   int printModels(int verbose=0);
 
       // Model weights related functions
   int printModelWeights(void);
+  void getLogLinearWeights(std::vector<std::pair<std::string,float> >& compWeights);
+  void setLogLinearWeights(const std::vector<float>& weightVec,
+                           int verbose=0);
   
       // Destructor
   ~ThotDecoder();
@@ -170,19 +281,30 @@ class ThotDecoder
       // Data members
   std::map<int,size_t> userIdToIdx;
   std::vector<bool> idxDataReleased;
+  std::vector<size_t> freeIdxVec;
   ThotDecoderState tdState;
   ThotDecoderCommonVars tdCommonVars;
   std::vector<ThotDecoderPerUserVars> tdPerUserVarsVec;
   std::vector<std::string> totalPrefixVec;
+  std::map<int,ThotDecoderUserPars> userParsMap;
+  std::map<std::pair<int,unsigned int>,int> batchWorkerUserIdMap;
+  int nextBatchWorkerUserId;
+  DecProfStats decProfStats;
+  OnlineTrainingQueue onlineTrainingQueue;
+  pthread_t asyncTrainerThread;
+  bool asyncTrainerRunning;
+  unsigned int asyncTrainingMaxBatchSize;
+  int asyncTrainingVerbose;
 
       // Mutexes and conditions
   pthread_mutex_t user_id_to_idx_mut;
   pthread_mutex_t atomic_op_mut;
   pthread_mutex_t non_atomic_op_mut;
-  pthread_mutex_t preproc_mut;
   pthread_cond_t non_atomic_op_cond;
   unsigned int non_atomic_ops_running;
   std::vector<pthread_mutex_t> per_user_mut;
+  pthread_mutex_t async_training_mut;
+  pthread_mutex_t batch_worker_mut;
   
       // Mutex- and condition-related functions
   void wait_on_non_atomic_op_cond(void);
@@ -194,6 +316,14 @@ class ThotDecoder
   void init_translator_legacy_impl(void);
   void init_translator_feat_impl(void);
   
+      // Functions to initialize user parameters
+  int initUserParsAux(int user_id,
+                      const ThotDecoderUserPars& tdup,
+                      int verbose);
+      // Sets the parameters of user_id, the caller must have locked
+      // the atomic operations mutex and waited for the non-atomic
+      // operations to finish
+
       // Functions to load models
   BasePhraseModel* createPmPtr(std::string modelType);
   bool process_tm_descriptor(std::string tmDescFile,
@@ -231,6 +361,9 @@ class ThotDecoder
   void set_S(int user_id,
              unsigned int S_par,
              int verbose=0);
+  void set_I(int user_id,
+             unsigned int I_par,
+             int verbose=0);
   void set_A(unsigned int A_par,
              int verbose=0);
   void set_E(unsigned int E_par,
@@ -241,6 +374,9 @@ class ThotDecoder
   bool set_G(int user_id,
              unsigned int G_par,
              int verbose=0);
+  void set_nt(int user_id,
+              unsigned int nt_par,
+              int verbose=0);
   void set_h(unsigned int h_par,
              int verbose=0);
   bool set_np(int user_id,
@@ -266,14 +402,152 @@ class ThotDecoder
   size_t get_vecidx_for_user_id(int user_id);
   int init_idx_data(size_t idx);
   void release_idx_data(size_t idx);
+  int get_batch_worker_user_ids(int user_id,
+                                unsigned int numWorkers,
+                                std::vector<int>& workerUserIdVec,
+                                int verbose=0);
+      // Obtains the user identifiers of the decoders used by the
+      // workers of a batch translation requested by user_id. New
+      // workers are initialized as an atomic operation, so this
+      // function cannot be called from within a non-atomic one
+  void release_batch_workers(int user_id);
+      // Releases the decoders of the batch workers of user_id and
+      // frees their indices, the caller must have locked
+      // user_id_to_idx_mut
+  void run_batch_tasks(ThreadPool::task_func_t* taskFunc,
+                       void* taskData,
+                       unsigned int numTasks,
+                       unsigned int numWorkers);
+      // Executes the tasks of a batch using a thread pool created for
+      // the request
 
       // Auxiliary functions for translation
+  struct BatchTransData
+  {
+    ThotDecoder* thotDecoderPtr;
+    const std::vector<std::string>* sentVecPtr;
+    std::vector<int> workerUserIdVec;
+    batch_result_func_t* resultFunc;
+    void* resultData;
+    int verbose;
+    std::vector<std::string> resultVec;
+    std::vector<std::string> bestHypInfoVec;
+    std::vector<bool> doneVec;
+    unsigned int nextResult;
+    bool delivering;
+    bool aborted;
+    pthread_mutex_t result_mut;
+  };
+  static void translateSentenceBatchTask(void* taskData,
+                                         unsigned int taskIdx,
+                                         unsigned int workerIdx);
+      // Translates a sentence of a batch and delivers the results that
+      // are ready in sentence order. Only one worker delivers results
+      // at a time, and it does not hold result_mut while doing so
+  struct SegmTransCands
+  {
+    std::vector<std::vector<std::string> > trgWordsVec;
+    std::vector<std::string> resultVec;
+    std::vector<Score> scoreVec;
+    std::string bestHypInfo;
+  };
+  struct LongSentTransData
+  {
+    ThotDecoder* thotDecoderPtr;
+    const std::vector<std::string>* segmVecPtr;
+    std::vector<int> workerUserIdVec;
+    int verbose;
+    std::vector<SegmTransCands> segmTransCandsVec;
+    bool profEnabled;
+    std::vector<DecProfData> workerProfDataVec;
+  };
+  static void translateLongSentSegmTask(void* taskData,
+                                        unsigned int taskIdx,
+                                        unsigned int workerIdx);
+      // Obtains the candidate translations of a segment of a long
+      // sentence
+  void translateSegment(int user_id,
+                        std::string segment,
+                        SegmTransCands& segmTransCands,
+                        int verbose=0);
+  void splitLongSentence(size_t idx,
+                         std::string sentence,
+                         unsigned int maxSegmLen,
+                         std::vector<std::string>& segmVec,
+                         int verbose=0);
+      // Splits sentence into segments of at most maxSegmLen words
+  unsigned int splitPointCost(const std::string& word);
+      // Returns the cost of splitting a sentence after word
+  void joinSegmTranslations(const std::vector<SegmTransCands>& segmTransCandsVec,
+                            std::string& result,
+                            int verbose=0);
+      // Chooses a translation for each segment taking into account the
+      // language model scores at the boundaries between segments
+  BaseNgramLM<LM_State>* getLangModelPtr(float& weight);
+      // Returns the language model used to join the translations of
+      // segments and its weight, or NULL if no model is available
+  struct NbestBatchData
+  {
+    ThotDecoder* thotDecoderPtr;
+    const std::vector<std::string>* sentVecPtr;
+    std::vector<int> workerUserIdVec;
+    unsigned int nbestSize;
+    int verbose;
+    std::vector<std::vector<std::string> > nblistVec;
+    std::vector<std::vector<std::vector<double> > > scoreCompsVec;
+    std::vector<MertLattice>* latticeVecPtr;
+    std::vector<bool> errorVec;
+  };
+  static void obtainNbestListBatchTask(void* taskData,
+                                       unsigned int taskIdx,
+                                       unsigned int workerIdx);
+      // Obtains the n-best list of a sentence of a batch
+  int obtainNbestListBatch(int user_id,
+                           const std::vector<std::string>& sentVec,
+                           unsigned int nbestSize,
+                           unsigned int numWorkers,
+                           std::vector<std::vector<std::string> >& nblistVec,
+                           std::vector<std::vector<std::vector<double> > >& scoreCompsVec,
+                           std::vector<MertLattice>* latticeVecPtr=NULL,
+                           int verbose=0);
+      // Obtains the n-best lists of the sentences of sentVec using
+      // numWorkers threads, the first entry of each list is the best
+      // translation. The lattices of the sentences are also obtained if
+      // latticeVecPtr is not NULL
+  int obtainNbestList(int user_id,
+                      std::string sentence,
+                      unsigned int nbestSize,
+                      std::vector<std::string>& nblist,
+                      std::vector<std::vector<double> >& scoreCompsVec,
+                      MertLattice* latticePtr=NULL,
+                      int verbose=0);
+      // Obtains the n-best list of sentence from its word graph, which
+      // is also stored in latticePtr if it is not NULL
+  double obtainNbestListsQuality(const std::vector<std::string>& refSentVec,
+                                 const std::vector<std::vector<std::string> >& nblistVec,
+                                 const std::vector<std::vector<std::vector<double> > >& scoreCompsVec,
+                                 const std::vector<double>& weightVec);
+      // Returns the quality of the translations of the n-best lists
+      // that obtain the best score for weightVec
+  void obtainLatticePtrVecs(const std::vector<std::vector<MertLattice> >& latticeVecs,
+                            std::vector<std::vector<const MertLattice*> >& latticePtrVecs);
   std::string translateSentenceAux(size_t idx,
                                    std::string sentenceToTranslate,
                                    std::string& bestHypInfo,
                                    int verbose=0);
 
       // Auxiliary functions for online training
+  int onlineTrainSentPairAux(size_t idx,
+                             const char *srcSent,
+                             const char *refSent,
+                             int verbose=0);
+      // Trains the models with a sentence pair, the caller must have
+      // locked the atomic operations mutex and waited for the
+      // non-atomic operations to finish
+  static void* asyncTrainerEntry(void* thotDecoderPtr);
+  void processOnlineTrainingQueue(void);
+      // Function executed by the trainer thread of the asynchronous
+      // mode
   void addSentenceToWordPred(std::string sentence,
                              int verbose=0);
   int onlineTrainFeats(std::string srcSent,
@@ -324,6 +598,9 @@ class ThotDecoder
   std::string postprocLine(BasePrePosProcessor* prePosProcessorPtr,
                            std::string str,
                            bool caseconv);
+      // Pre/pos-processing functions, the module of the user should
+      // not be used concurrently by other threads. Strings are returned
+      // unchanged if no module is given
 
       // Memory handling related functions
   bool instantiate_swm_info(const char* tmFilesPrefix,
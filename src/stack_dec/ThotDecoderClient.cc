@@ -128,6 +128,58 @@ void ThotDecoderClient::sendSentToTranslate(int user_id,
   }    
 }
 
+//--------------------------
+void ThotDecoderClient::sendSentBatchToTranslate(int user_id,
+                                                 const std::vector<std::string>& sentVec)
+{
+  if(sentVec.size()>MAX_BATCH_SENTS)
+    throw std::runtime_error("Batch translation request with too many sentences");
+
+  if(connected)
+  {
+    BasicSocketUtils::writeInt(fileDesc,TRANSLATE_BATCH);
+    BasicSocketUtils::writeInt(fileDesc,user_id);
+    BasicSocketUtils::writeInt(fileDesc,sentVec.size());
+    for(unsigned int i=0;i<sentVec.size();++i)
+      BasicSocketUtils::writeStr(fileDesc,sentVec[i].c_str());
+  }
+  else
+  {
+    throw std::runtime_error("ThotDecoderClient not connected");        
+  }    
+}
+
+//--------------------------
+void ThotDecoderClient::recvBatchTranslation(std::string& translatedSentence,
+                                             std::string& bestHypInfo)
+{
+  if(connected)
+  {
+    int ret=BasicSocketUtils::recvInt(fileDesc);
+    if(ret!=THOT_OK)
+      throw std::runtime_error("Batch translation request failed");
+    BasicSocketUtils::recvStlStr(fileDesc,translatedSentence);
+    BasicSocketUtils::recvStlStr(fileDesc,bestHypInfo);
+  }
+  else
+  {
+    throw std::runtime_error("ThotDecoderClient not connected");        
+  }    
+}
+
+//--------------------------
+void ThotDecoderClient::translateSentBatch(int user_id,
+                                           const std::vector<std::string>& sentVec,
+                                           std::vector<std::string>& translatedSentVec,
+                                           std::vector<std::string>& bestHypInfoVec)
+{
+  sendSentBatchToTranslate(user_id,sentVec);
+  translatedSentVec.resize(sentVec.size());
+  bestHypInfoVec.resize(sentVec.size());
+  for(unsigned int i=0;i<sentVec.size();++i)
+    recvBatchTranslation(translatedSentVec[i],bestHypInfoVec[i]);
+}
+
 //--------------------------
 void ThotDecoderClient::sendSentPairVerCov(int user_id,
                                            const char *srcSent,
@@ -216,6 +268,38 @@ void ThotDecoderClient::sendPrintRequest(int user_id)
   }    
 }
 
+//--------------------------
+void ThotDecoderClient::getProfStats(int user_id,
+                                     std::string& jsonStr)
+{
+  if(connected)
+  {
+    BasicSocketUtils::writeInt(fileDesc,GET_PROF_STATS);
+    BasicSocketUtils::writeInt(fileDesc,user_id);
+    BasicSocketUtils::recvStlStr(fileDesc,jsonStr);
+  }
+  else
+  {
+    throw std::runtime_error("ThotDecoderClient not connected");        
+  }    
+}
+
+//--------------------------
+void ThotDecoderClient::getOnlineTrainingStats(int user_id,
+                                               std::string& jsonStr)
+{
+  if(connected)
+  {
+    BasicSocketUtils::writeInt(fileDesc,GET_OL_TRAIN_STATS);
+    BasicSocketUtils::writeInt(fileDesc,user_id);
+    BasicSocketUtils::recvStlStr(fileDesc,jsonStr);
+  }
+  else
+  {
+    throw std::runtime_error("ThotDecoderClient not connected");        
+  }    
+}
+
 //--------------------------
 void ThotDecoderClient::sendEndServerRequest(int user_id)
 {
@@ -40,6 +40,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <BasicSocketUtils.h>
 #include <StrProcUtils.h>
 #include <string>
+#include <vector>
 #include <iostream>
 
 //--------------- Constants ------------------------------------------
@@ -73,6 +74,20 @@ class ThotDecoderClient
                              const char *sentenceToTranslate,
                              std::string& translatedSentence,
                              std::string& bestHypInfo);
+    void sendSentBatchToTranslate(int user_id,
+                                  const std::vector<std::string>& sentVec);
+    void recvBatchTranslation(std::string& translatedSentence,
+                              std::string& bestHypInfo);
+        // Sends a batch translation request. The translations are
+        // returned in sentence order, one per call to
+        // recvBatchTranslation(), as soon as the server obtains them.
+        // recvBatchTranslation() throws an exception if the server
+        // reports that the batch failed
+    void translateSentBatch(int user_id,
+                            const std::vector<std::string>& sentVec,
+                            std::vector<std::string>& translatedSentVec,
+                            std::vector<std::string>& bestHypInfoVec);
+        // Translates a batch of sentences using a single request
     void sendSentPairVerCov(int user_id,
                             const char *srcSent,
                             const char *refSent,
@@ -85,6 +100,13 @@ class ThotDecoderClient
                       std::string &translatedSentence);
     void resetPref(int user_id);
     void sendPrintRequest(int user_id);
+    void getProfStats(int user_id,
+                      std::string& jsonStr);
+        // Obtains the profiling data of the server in JSON format
+    void getOnlineTrainingStats(int user_id,
+                                std::string& jsonStr);
+        // Obtains the statistics of the online training queue of the
+        // server in JSON format
     void sendEndServerRequest(int user_id);
     void disconnect(int user_id);
     
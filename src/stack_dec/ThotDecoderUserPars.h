@@ -31,8 +31,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Constants ------------------------------------------
 
 #define TD_USER_S_DEFAULT         10
+#define TD_USER_I_DEFAULT          1
 #define TD_USER_BE_DEFAULT     false
 #define TD_USER_G_DEFAULT          0
+#define TD_USER_NT_DEFAULT         1
 #define TD_USER_NP_DEFAULT        10
 #define TD_USER_WGP_DEFAULT        UNLIMITED_DENSITY
 #define TD_USER_SP_DEFAULT         0
@@ -44,8 +46,10 @@ class ThotDecoderUserPars
  public:
 
   unsigned int S;
+  unsigned int I;
   bool be;
   unsigned int G;
+  unsigned int nt;
   unsigned int np;
   float wgp;
   std::string wgh_str;
@@ -61,8 +65,10 @@ class ThotDecoderUserPars
   void default_values(void)
   {
     S=TD_USER_S_DEFAULT;
+    I=TD_USER_I_DEFAULT;
     be=TD_USER_BE_DEFAULT;
     G=TD_USER_G_DEFAULT;
+    nt=TD_USER_NT_DEFAULT;
     np=TD_USER_NP_DEFAULT;
     wgp=TD_USER_WGP_DEFAULT;
     sp=TD_USER_SP_DEFAULT;
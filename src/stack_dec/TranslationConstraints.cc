@@ -411,6 +411,40 @@ bool TranslationConstraints::translationSatisfiesConstraints(const std::vector<s
   return true;
 }
 
+//---------------------------------------
+std::string TranslationConstraints::getRawSrcPhrase(std::pair<PositionIndex,PositionIndex> srcPhr)const
+{
+  std::vector<std::string> rawSrcPhrVec;
+  PositionIndex j=srcPhr.first;
+  while(j<=srcPhr.second && j<=srcSentVec.size())
+  {
+        // Check if a constraint fully contained in the source phrase
+        // starts at the current position
+    std::map<std::pair<PositionIndex,PositionIndex>,std::vector<std::string> >::const_iterator const_iter;
+    const_iter=srcPhrTransMap.lower_bound(std::make_pair(j,(PositionIndex)0));
+    if(const_iter!=srcPhrTransMap.end() && const_iter->first.first==j && const_iter->first.second<=srcPhr.second)
+    {
+      rawSrcPhrVec.push_back(obtainStartTag(XML_PHR_ANNOT_TAG_NAME));
+      rawSrcPhrVec.push_back(obtainStartTag(XML_SRC_SEGM_TAG_NAME));
+      for(PositionIndex k=const_iter->first.first;k<=const_iter->first.second;++k)
+        rawSrcPhrVec.push_back(srcSentVec[k-1]);
+      rawSrcPhrVec.push_back(obtainEndTag(XML_SRC_SEGM_TAG_NAME));
+      rawSrcPhrVec.push_back(obtainStartTag(XML_TRG_SEGM_TAG_NAME));
+      for(unsigned int k=0;k<const_iter->second.size();++k)
+        rawSrcPhrVec.push_back(const_iter->second[k]);
+      rawSrcPhrVec.push_back(obtainEndTag(XML_TRG_SEGM_TAG_NAME));
+      rawSrcPhrVec.push_back(obtainEndTag(XML_PHR_ANNOT_TAG_NAME));
+      j=const_iter->first.second+1;
+    }
+    else
+    {
+      rawSrcPhrVec.push_back(srcSentVec[j-1]);
+      ++j;
+    }
+  }
+  return StrProcUtils::stringVectorToString(rawSrcPhrVec);
+}
+
 //---------------------------------------
 void TranslationConstraints::clear(void)
 {
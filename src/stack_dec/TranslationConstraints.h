@@ -55,6 +55,7 @@ class TranslationConstraints: public BaseTranslationConstraints
       // between source and target words.  The first index corresponds
       // to source word positions and the second one to target word
       // positions
+  std::string getRawSrcPhrase(std::pair<PositionIndex,PositionIndex> srcPhr)const;
 
   void clear(void);
   
@@ -54,13 +54,22 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "SourceSegmentation.h"
 #include "WordPredictor.h"
 #include "PbTransModelInputVars.h"
-#include "NbestTransCacheData.h"
+#include "PbTransModelCacheData.h"
+#include "DecProfiler.h"
 #include "StatModelDefs.h"
 #include "Prob.h"
+#include "BitsetHashF.h"
 #include <math.h>
 #include <set>
 #include "StrProcUtils.h"
 
+#if __GNUC__>2
+#include <ext/hash_map>
+using __gnu_cxx::hash_map;
+#else
+#include <hash_map>
+#endif
+
 //--------------- Constants ------------------------------------------
 
 #define NO_HEURISTIC            0
@@ -137,6 +146,18 @@ class _pbTransModel: public BasePbTransModel<HYPOTHESIS>
   void expand_prefix(const Hypothesis& hyp,
                      std::vector<Hypothesis>& hypVec,
                      std::vector<std::vector<Score> >& scrCompVec);
+  bool prepareForParallelExpansion(void);
+  void releaseSentenceCaches(void);
+  bool getSpansForExpansion(const Hypothesis& hyp,
+                            std::vector<std::pair<PositionIndex,PositionIndex> >& spanVec);
+  bool getHypDataVecForSpan(const Hypothesis& hyp,
+                            PositionIndex srcLeft,
+                            PositionIndex srcRight,
+                            std::vector<HypDataType>& hypDataVec);
+  bool expandGivenHypData(const Hypothesis& hyp,
+                          const HypDataType& hypData,
+                          Hypothesis& extHyp,
+                          std::vector<Score>& scrComps);
 
       // Heuristic-related functions
   void setHeuristic(unsigned int _heuristicId);
@@ -184,6 +205,12 @@ class _pbTransModel: public BasePbTransModel<HYPOTHESIS>
       // Heuristic probability vector
   std::vector<std::vector<Score> > heuristicScoreVec; 
 
+      // Type of the cache of local translation model heuristic scores,
+      // the score only depends on the coverage of the hypothesis, so it
+      // is shared by all the hypotheses covering the same source
+      // positions
+  typedef PbTransModelCacheData::CoverageHeurScoreCache CoverageHeurScoreCache;
+
       // Additional data structures to store information about heuristics
   std::vector<LgProb> refHeurLmLgProb;
   std::vector<LgProb> prefHeurLmLgProb;
@@ -194,8 +221,10 @@ class _pbTransModel: public BasePbTransModel<HYPOTHESIS>
       // Set of unseen words
   std::set<std::string> unseenWordsSet;
 
-      // Data used to cache n-best translation data
-  NbestTransCacheData nbTransCacheData;
+      // Per-sentence caches (n-best translation data and heuristic
+      // scores), they are taken from a pool shared by all the model
+      // instances when they are first accessed
+  PbTransModelCacheHandle cacheHandle;
   
   ////// Hypotheses-related functions
 
@@ -357,8 +386,12 @@ class _pbTransModel: public BasePbTransModel<HYPOTHESIS>
   Score calcPrefLmHeurScore(const _pbTransModel::Hypothesis& hyp);
   Score heuristicLocalt(const Hypothesis& hyp);
   Score heuristicLocaltd(const Hypothesis& hyp);
-  Score getLocalTmHeurScore(const Hypothesis& hyp);
-  Score getDistortionHeurScore(const Hypothesis& hyp);
+  Score getLocalTmHeurScore(const Hypothesis& hyp,
+                            const std::vector<std::pair<PositionIndex,PositionIndex> >* gapsPtr=NULL);
+      // gapsPtr may point to the gaps of hyp if they were already
+      // extracted by the caller
+  Score getDistortionHeurScore(const Hypothesis& hyp,
+                               const std::vector<std::pair<PositionIndex,PositionIndex> >& gaps);
   PositionIndex getLastSrcPosCovered(const Hypothesis& hyp);
       // Get the index of last source position which was covered
   virtual PositionIndex getLastSrcPosCoveredHypData(const HypDataType& hypd)=0;
@@ -676,30 +709,19 @@ void _pbTransModel<HYPOTHESIS>::extract_gaps(const Bitset<MAX_SENTENCE_LENGTH_AL
 {
       // Extract all uncovered gaps
   std::pair<PositionIndex,PositionIndex> gap;
-  unsigned int srcSentLen=this->numberOfUncoveredSrcWordsHypData(this->nullHypothesisHypData());
-  unsigned int j;
+  size_t srcSentLen=this->numberOfUncoveredSrcWordsHypData(this->nullHypothesisHypData());
+  size_t j=1;
   
-      // Extract gaps
+      // Extract gaps, skipping whole words of covered or uncovered
+      // positions at a time
   gaps.clear();
-  bool crossing_a_gap=false;	
-	
-  for(j=1;j<=srcSentLen;++j)
-  {
-    if(crossing_a_gap==false && hypKey.test(j)==0)
-    {
-      crossing_a_gap=true;
-      gap.first=j;
-    }
-	
-    if(crossing_a_gap==true && hypKey.test(j)==1)
-    {
-      crossing_a_gap=false;
-      gap.second=j-1;
-      gaps.push_back(gap);	
-    }	
-  }
-  if(crossing_a_gap==true)
+  while(true)
   {
+    j=hypKey.find_next_unset(j);
+    if(j>srcSentLen) break;
+    gap.first=j;
+    j=hypKey.find_next_set(j);
+    if(j>srcSentLen+1) j=srcSentLen+1;
     gap.second=j-1;
     gaps.push_back(gap);
   }
@@ -711,32 +733,15 @@ unsigned int _pbTransModel<HYPOTHESIS>::get_num_gaps(const Bitset<MAX_SENTENCE_L
 {
       // Count all uncovered gaps
   unsigned int result=0;
-  unsigned int j;
-  bool crossing_a_gap;
-  unsigned int srcSentLen;
-  HypDataType nullHypData=this->nullHypothesisHypData();
+  size_t srcSentLen=this->numberOfUncoveredSrcWordsHypData(this->nullHypothesisHypData());
+  size_t j=1;
 
-  srcSentLen=this->numberOfUncoveredSrcWordsHypData(nullHypData);
-  
-      // count gaps	
-  crossing_a_gap=false;	
-	
-  for(j=1;j<=srcSentLen;++j)
-  {
-    if(crossing_a_gap==false && hypKey.test(j)==0)
-    {
-      crossing_a_gap=true;
-    }
-	
-    if(crossing_a_gap==true && hypKey.test(j)==1)
-    {
-      crossing_a_gap=false;
-      ++result;	
-    }	
-  }
-  if(crossing_a_gap==true)
+  while(true)
   {
+    j=hypKey.find_next_unset(j);
+    if(j>srcSentLen) break;
     ++result;
+    j=hypKey.find_next_set(j);
   }
   return result;
 }
@@ -758,8 +763,7 @@ void _pbTransModel<HYPOTHESIS>::expand(const Hypothesis& hyp,
                                        std::vector<Hypothesis>& hypVec,
                                        std::vector<std::vector<Score> >& scrCompVec)
 {
-  std::vector<std::pair<PositionIndex,PositionIndex> > gaps;
-  std::vector<WordIndex> srcPhrase;
+  std::vector<std::pair<PositionIndex,PositionIndex> > spanVec;
   Hypothesis extHyp;
   std::vector<HypDataType> hypDataVec;
   std::vector<Score> scoreComponents;
@@ -767,6 +771,36 @@ void _pbTransModel<HYPOTHESIS>::expand(const Hypothesis& hyp,
   hypVec.clear();
   scrCompVec.clear();
   
+      // Obtain source spans that can be translated
+  getSpansForExpansion(hyp,spanVec);
+
+      // Generate new hypotheses translating the spans
+  for(unsigned int k=0;k<spanVec.size();++k)
+  {
+        // Obtain hypothesis data vector
+    getHypDataVecForGap(hyp,spanVec[k].first,spanVec[k].second,hypDataVec,this->pbTransModelPars.W);
+    for(unsigned int i=0;i<hypDataVec.size();++i)
+    {
+          // Create hypothesis extension and check if translation
+          // constraints are satisfied
+      if(expandGivenHypData(hyp,hypDataVec[i],extHyp,scoreComponents))
+      {
+        hypVec.push_back(extHyp);
+        scrCompVec.push_back(scoreComponents);
+      }
+    }
+  }
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+bool _pbTransModel<HYPOTHESIS>::getSpansForExpansion(const Hypothesis& hyp,
+                                                     std::vector<std::pair<PositionIndex,PositionIndex> >& spanVec)
+{
+  std::vector<std::pair<PositionIndex,PositionIndex> > gaps;
+
+  spanVec.clear();
+  
       // Extract gaps
   extract_gaps(hyp,gaps);
   if(this->verbosity>=2)
@@ -774,13 +808,12 @@ void _pbTransModel<HYPOTHESIS>::expand(const Hypothesis& hyp,
     std::cerr<<"  gaps: "<<gaps.size()<<std::endl;
   }
    
-      // Generate new hypotheses completing the gaps
+      // Obtain the spans that can be used to complete the gaps
   for(unsigned int k=0;k<gaps.size();++k)
   {
     unsigned int gap_length=gaps[k].second-gaps[k].first+1;
     for(unsigned int x=0;x<gap_length;++x)
     {
-      srcPhrase.clear();
       if(x<=this->pbTransModelPars.U) // x should be lower than U, which is the maximum
                // number of words that can be jUmped
       {
@@ -794,30 +827,73 @@ void _pbTransModel<HYPOTHESIS>::expand(const Hypothesis& hyp,
               // phrase is affected by a translation constraint
           if((segmRightMostj-segmLeftMostj)+1 > this->pbTransModelPars.A && !srcPhraseIsAffectedByConstraint)
             break;
-              // Obtain hypothesis data vector
-          getHypDataVecForGap(hyp,segmLeftMostj,segmRightMostj,hypDataVec,this->pbTransModelPars.W);
-          if(hypDataVec.size()!=0)
-          {
-            for(unsigned int i=0;i<hypDataVec.size();++i)
-            {
-                  // Create hypothesis extension
-              this->incrScore(hyp,hypDataVec[i],extHyp,scoreComponents);
-                  // Obtain information about hypothesis extension
-              std::vector<std::string> targetWordVec=this->getTransInPlainTextVec(extHyp);
-              std::vector<std::pair<PositionIndex,PositionIndex> > aligPos;
-              this->aligMatrix(extHyp,aligPos);
-                  // Check if translation constraints are satisfied
-              if(this->trConstraintsPtr->translationSatisfiesConstraints(targetWordVec,aligPos))
-              {
-                hypVec.push_back(extHyp);
-                scrCompVec.push_back(scoreComponents);
-              }
-            }
-          }
+          spanVec.push_back(std::make_pair(segmLeftMostj,segmRightMostj));
         }
       }
     }
   }
+  return true;
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+bool _pbTransModel<HYPOTHESIS>::getHypDataVecForSpan(const Hypothesis& hyp,
+                                                     PositionIndex srcLeft,
+                                                     PositionIndex srcRight,
+                                                     std::vector<HypDataType>& hypDataVec)
+{
+  return getHypDataVecForGap(hyp,srcLeft,srcRight,hypDataVec,this->pbTransModelPars.W);
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+bool _pbTransModel<HYPOTHESIS>::expandGivenHypData(const Hypothesis& hyp,
+                                                   const HypDataType& hypData,
+                                                   Hypothesis& extHyp,
+                                                   std::vector<Score>& scrComps)
+{
+      // Create hypothesis extension
+  this->incrScore(hyp,hypData,extHyp,scrComps);
+      // Obtain information about hypothesis extension
+  std::vector<std::string> targetWordVec=this->getTransInPlainTextVec(extHyp);
+  std::vector<std::pair<PositionIndex,PositionIndex> > aligPos;
+  this->aligMatrix(extHyp,aligPos);
+      // Check if translation constraints are satisfied
+  return this->trConstraintsPtr->translationSatisfiesConstraints(targetWordVec,aligPos);
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+bool _pbTransModel<HYPOTHESIS>::prepareForParallelExpansion(void)
+{
+  if(state!=MODEL_TRANS_STATE)
+    return false;
+
+      // Collect the translation options for every source phrase that
+      // can be used by expand(), this way, the cache of translations
+      // and the target vocabulary will not be modified when expanding
+      // hypotheses
+  Hypothesis nullHyp=nullHypothesis();
+  NbestTableNode<PhraseTransTableNodeData> nbt;
+  unsigned int srcSentLen=pbtmInputVars.srcSentVec.size();
+  for(unsigned int x=1;x<=srcSentLen;++x)
+  {
+    for(unsigned int y=x;y<=srcSentLen;++y)
+    {
+      bool srcPhraseIsAffectedByConstraint=this->trConstraintsPtr->srcPhrAffectedByConstraint(std::make_pair(x,y));
+      if((y-x)+1 > this->pbTransModelPars.A && !srcPhraseIsAffectedByConstraint)
+        break;
+      getTransForHypUncovGap(nullHyp,x,y,nbt,this->pbTransModelPars.W);
+    }
+  }
+  return true;
+}
+
+//---------------------------------
+template<class HYPOTHESIS>
+void _pbTransModel<HYPOTHESIS>::releaseSentenceCaches(void)
+{
+  cacheHandle.release();
 }
 
 //---------------------------------
@@ -1010,8 +1086,8 @@ void _pbTransModel<HYPOTHESIS>::clearTempVars(void)
   refHeurLmLgProb.clear();
   prefHeurLmLgProb.clear();
 
-      // Clear n-best translation cache data
-  nbTransCacheData.clear();
+      // Return cached data to the pool
+  cacheHandle.release();
 }
 
 //---------------------------------------
@@ -1376,8 +1452,10 @@ Score _pbTransModel<HYPOTHESIS>::heuristicLocaltd(const Hypothesis& hyp)
 {
   if(state==MODEL_TRANS_STATE)
   {
-    Score result=getLocalTmHeurScore(hyp);
-    result+=getDistortionHeurScore(hyp);
+    std::vector<std::pair<PositionIndex,PositionIndex> > gaps;
+    this->extract_gaps(hyp,gaps);
+    Score result=getLocalTmHeurScore(hyp,&gaps);
+    result+=getDistortionHeurScore(hyp,gaps);
     
     return result;
   }
@@ -1390,28 +1468,47 @@ Score _pbTransModel<HYPOTHESIS>::heuristicLocaltd(const Hypothesis& hyp)
 
 //---------------------------------
 template<class HYPOTHESIS>
-Score _pbTransModel<HYPOTHESIS>::getLocalTmHeurScore(const Hypothesis& hyp)
+Score _pbTransModel<HYPOTHESIS>::getLocalTmHeurScore(const Hypothesis& hyp,
+                                                     const std::vector<std::pair<PositionIndex,PositionIndex> >* gapsPtr)
 {
+  Bitset<MAX_SENTENCE_LENGTH_ALLOWED> hypKey=hyp.getKey();
+  CoverageHeurScoreCache& localTmHeurScoreCache=cacheHandle.get().localTmHeurScoreCache;
+
+      // Check if the score for this coverage was already computed
+  typename CoverageHeurScoreCache::const_iterator cacheIter=localTmHeurScoreCache.find(hypKey);
+  if(cacheIter!=localTmHeurScoreCache.end())
+  {
+    DecProf::count(DEC_PROF_HEUR_CACHE_HITS);
+    return cacheIter->second;
+  }
+  DecProf::count(DEC_PROF_HEUR_CACHE_MISSES);
+  
+  std::vector<std::pair<PositionIndex,PositionIndex> > extractedGaps;
+  if(gapsPtr==NULL)
+  {
+    this->extract_gaps(hypKey,extractedGaps);
+    gapsPtr=&extractedGaps;
+  }
+  const std::vector<std::pair<PositionIndex,PositionIndex> >& gaps=*gapsPtr;
+
   Score result=0;  
   unsigned int J=pbtmInputVars.srcSentVec.size();
-  std::vector<std::pair<PositionIndex,PositionIndex> > gaps;
-  this->extract_gaps(hyp,gaps);
   for(unsigned int i=0;i<gaps.size();++i)
   {
     result+=heuristicScoreVec[gaps[i].second-1][J-gaps[i].first];	
   }
-  
+
+  localTmHeurScoreCache[hypKey]=result;
   return result;
 }
 
 //---------------------------------
 template<class HYPOTHESIS>
-Score _pbTransModel<HYPOTHESIS>::getDistortionHeurScore(const Hypothesis& hyp)
+Score _pbTransModel<HYPOTHESIS>::getDistortionHeurScore(const Hypothesis& hyp,
+                                                        const std::vector<std::pair<PositionIndex,PositionIndex> >& gaps)
 {
       // Initialize variables
   Score result=0;  
-  std::vector<std::pair<PositionIndex,PositionIndex> > gaps;
-  this->extract_gaps(hyp,gaps);
   PositionIndex lastSrcPosCovered=getLastSrcPosCovered(hyp);
 
       // Obtain score
@@ -2025,10 +2122,17 @@ bool _pbTransModel<HYPOTHESIS>::getNbestTransForSrcPhraseCached(PositionIndex sr
                                                                 NbestTableNode<PhraseTransTableNodeData>& nbt,
                                                                 float N)
 {
-  NbestTableNode<PhraseTransTableNodeData>* transTableNodePtr=nbTransCacheData.cPhrNbestTransTable.getTranslationsForKey(std::make_pair(srcLeft,srcRight));
+      // Copies used for parallel expansion look up the translation
+      // options collected by the original model first
+  const NbestTableNode<PhraseTransTableNodeData>* transTableNodePtr=NULL;
+  if(cacheHandle.getSharedData()!=NULL)
+    transTableNodePtr=cacheHandle.getSharedData()->nbTransCacheData.cPhrNbestTransTable.getTranslationsForKey(std::make_pair(srcLeft,srcRight));
+  if(transTableNodePtr==NULL)
+    transTableNodePtr=cacheHandle.get().nbTransCacheData.cPhrNbestTransTable.getTranslationsForKey(std::make_pair(srcLeft,srcRight));
   if(transTableNodePtr!=NULL)
   {
         // translation present in the cache translation table
+    DecProf::count(DEC_PROF_TRANS_OPT_CACHE_HITS);
     nbt=*transTableNodePtr;
     if(nbt.size()==0) return false;
     else return true;
@@ -2036,13 +2140,14 @@ bool _pbTransModel<HYPOTHESIS>::getNbestTransForSrcPhraseCached(PositionIndex sr
   else
   {
         // translation not present in the cache translation table
+    DecProf::count(DEC_PROF_TRANS_OPT_CACHE_MISSES);
     std::vector<WordIndex> srcPhrase;
     for(unsigned int i=srcLeft;i<=srcRight;++i)
     {
       srcPhrase.push_back(pbtmInputVars.nsrcSentIdVec[i]);
     }
     getNbestTransForSrcPhrase(srcPhrase,nbt,N);
-    nbTransCacheData.cPhrNbestTransTable.insertEntry(std::make_pair(srcLeft,srcRight),nbt);
+    cacheHandle.get().nbTransCacheData.cPhrNbestTransTable.insertEntry(std::make_pair(srcLeft,srcRight),nbt);
     if(nbt.size()==0) return false;
     else return true;
   }
@@ -2057,6 +2162,7 @@ bool _pbTransModel<HYPOTHESIS>::getNbestTransForSrcPhrase(std::vector<WordIndex>
   BasePhraseModel::SrcTableNode srctn;
   BasePhraseModel::SrcTableNode::iterator srctnIter;
   bool ret;
+  DecProfPhaseTimer optCollectionTimer(DEC_PROF_OPT_COLLECTION);
 
       // Obtain the whole list of translations
   nbt.clear();
@@ -2214,7 +2320,7 @@ void _pbTransModel<HYPOTHESIS>::transUncovGapRefNoLastGapCached(const Hypothesis
      
       // Search the required translations in the cache translation
       // table    
-  NbestTableNode<PhraseTransTableNodeData>* transTableNodePtr=nbTransCacheData.cPhrNbestTransTableRef.getTranslationsForKey(pNbtRefKey);
+  NbestTableNode<PhraseTransTableNodeData>* transTableNodePtr=cacheHandle.get().nbTransCacheData.cPhrNbestTransTableRef.getTranslationsForKey(pNbtRefKey);
   if(transTableNodePtr!=NULL)
   {
         // translations present in the cache translation table
@@ -2241,7 +2347,7 @@ void _pbTransModel<HYPOTHESIS>::transUncovGapRefNoLastGapCached(const Hypothesis
       nbt.pruneGivenThreshold(bscr+(double)log(N));
     }
         // Store the list in cPhrNbestTransTableRef
-    nbTransCacheData.cPhrNbestTransTableRef.insertEntry(pNbtRefKey,nbt);
+    cacheHandle.get().nbTransCacheData.cPhrNbestTransTableRef.insertEntry(pNbtRefKey,nbt);
   }
 }
 
@@ -2334,7 +2440,7 @@ void _pbTransModel<HYPOTHESIS>::transUncovGapPrefNoGenCached(const Hypothesis& h
   
       // Search the required translations in the cache translation
       // table
-  NbestTableNode<PhraseTransTableNodeData>* transTableNodePtr=nbTransCacheData.cPhrNbestTransTablePref.getTranslationsForKey(pNbtPrefKey);
+  NbestTableNode<PhraseTransTableNodeData>* transTableNodePtr=cacheHandle.get().nbTransCacheData.cPhrNbestTransTablePref.getTranslationsForKey(pNbtPrefKey);
   if(transTableNodePtr!=NULL)
   {
         // translations present in the cache translation table
@@ -2354,7 +2460,7 @@ void _pbTransModel<HYPOTHESIS>::transUncovGapPrefNoGenCached(const Hypothesis& h
       nbt.pruneGivenThreshold(bscr+(double)log(N));
     }
         // Store the list in cPhrNbestTransTablePref
-    nbTransCacheData.cPhrNbestTransTablePref.insertEntry(pNbtPrefKey,nbt);
+    cacheHandle.get().nbTransCacheData.cPhrNbestTransTablePref.insertEntry(pNbtPrefKey,nbt);
   }
 }
 
@@ -2505,17 +2611,19 @@ Score _pbTransModel<HYPOTHESIS>::nbestTransScoreCached(const std::vector<WordInd
                                                        const std::vector<WordIndex>& trgPhrase)
 {
   PhrasePairCacheTable::iterator ppctIter;
-  ppctIter=nbTransCacheData.cnbestTransScore.find(std::make_pair(srcPhrase,trgPhrase));
-  if(ppctIter!=nbTransCacheData.cnbestTransScore.end())
+  ppctIter=cacheHandle.get().nbTransCacheData.cnbestTransScore.find(std::make_pair(srcPhrase,trgPhrase));
+  if(ppctIter!=cacheHandle.get().nbTransCacheData.cnbestTransScore.end())
   {
         // Score was previously stored in the cache table
+    DecProf::count(DEC_PROF_PHR_SCR_CACHE_HITS);
     return ppctIter->second;
   }
   else
   {
         // Score is not stored in the cache table
+    DecProf::count(DEC_PROF_PHR_SCR_CACHE_MISSES);
     Score scr=nbestTransScore(srcPhrase,trgPhrase);
-    nbTransCacheData.cnbestTransScore[std::make_pair(srcPhrase,trgPhrase)]=scr;
+    cacheHandle.get().nbTransCacheData.cnbestTransScore[std::make_pair(srcPhrase,trgPhrase)]=scr;
     return scr;
   }
 }
@@ -2526,17 +2634,19 @@ Score _pbTransModel<HYPOTHESIS>::nbestTransScoreLastCached(const std::vector<Wor
                                                            const std::vector<WordIndex>& trgPhrase)
 {
   PhrasePairCacheTable::iterator ppctIter;
-  ppctIter=nbTransCacheData.cnbestTransScoreLast.find(std::make_pair(srcPhrase,trgPhrase));
-  if(ppctIter!=nbTransCacheData.cnbestTransScoreLast.end())
+  ppctIter=cacheHandle.get().nbTransCacheData.cnbestTransScoreLast.find(std::make_pair(srcPhrase,trgPhrase));
+  if(ppctIter!=cacheHandle.get().nbTransCacheData.cnbestTransScoreLast.end())
   {
         // Score was previously stored in the cache table
+    DecProf::count(DEC_PROF_PHR_SCR_CACHE_HITS);
     return ppctIter->second;
   }
   else
   {
         // Score is not stored in the cache table
+    DecProf::count(DEC_PROF_PHR_SCR_CACHE_MISSES);
     Score scr=nbestTransScoreLast(srcPhrase,trgPhrase);
-    nbTransCacheData.cnbestTransScoreLast[std::make_pair(srcPhrase,trgPhrase)]=scr;
+    cacheHandle.get().nbTransCacheData.cnbestTransScoreLast[std::make_pair(srcPhrase,trgPhrase)]=scr;
     return scr;
   }
 }
@@ -48,14 +48,23 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "PhraseModelInfo.h"
 #include "LangModelInfo.h"
 #include "SourceSegmentation.h"
-#include "NbestTransCacheData.h"
+#include "PbTransModelCacheData.h"
+#include "DecProfiler.h"
 #include "PbTransModelInputVars.h"
 #include "PhrasePairCacheTable.h"
 #include "ScoreCompDefs.h"
 #include "Prob.h"
+#include "BitsetHashF.h"
 #include <math.h>
 #include <set>
 
+#if __GNUC__>2
+#include <ext/hash_map>
+using __gnu_cxx::hash_map;
+#else
+#include <hash_map>
+#endif
+
 //--------------- Constants ------------------------------------------
 
 #define NO_HEURISTIC            0
@@ -73,7 +82,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 /**
  * @brief The _phraseBasedTransModel class is a predecessor of the
- * BasePbTransModel class.
+ * BasePbTransModel class. It does not implement
+ * prepareForParallelExpansion(), so the decoder expands its hypotheses
+ * serially whatever the number of threads (parallel expansion is only
+ * available for the models derived from _pbTransModel).
  */
 
 template<class HYPOTHESIS>
@@ -140,6 +152,7 @@ class _phraseBasedTransModel: public BasePbTransModel<HYPOTHESIS>
   void expand_prefix(const Hypothesis& hyp,
                      std::vector<Hypothesis>& hypVec,
                      std::vector<std::vector<Score> >& scrCompVec);
+  void releaseSentenceCaches(void);
 
       // Heuristic-related functions
   void setHeuristic(unsigned int _heuristicId);
@@ -168,7 +181,7 @@ class _phraseBasedTransModel: public BasePbTransModel<HYPOTHESIS>
 
  protected:
 
-  typedef std::map<std::pair<std::vector<WordIndex>,std::vector<WordIndex> >,std::vector<Score> > PhrasePairVecScore;
+  typedef PbTransModelCacheData::PhrasePairVecScore PhrasePairVecScore;
 
       // Data structure to store input variables
   PbTransModelInputVars pbtmInputVars;
@@ -179,12 +192,10 @@ class _phraseBasedTransModel: public BasePbTransModel<HYPOTHESIS>
       // Phrase model members
   PhraseModelInfo* phrModelInfoPtr;
 
-      // Members useful for caching data
-  PhrasePairVecScore cachedDirectPhrScoreVecs;
-  PhrasePairVecScore cachedInversePhrScoreVecs;
-
-      // Data used to cache n-best translation scores
-  NbestTransCacheData nbTransCacheData;
+      // Per-sentence caches (phrase model scores, n-best translation
+      // data and heuristic scores), they are taken from a pool shared
+      // by all the model instances when they are first accessed
+  PbTransModelCacheHandle cacheHandle;
   
       // Set of unseen words
   std::set<std::string> unseenWordsSet;
@@ -196,6 +207,9 @@ class _phraseBasedTransModel: public BasePbTransModel<HYPOTHESIS>
   unsigned int heuristicId;
       // Heuristic probability vector
   std::vector<std::vector<Score> > heuristicScoreVec; 
+      // Type of the cache of local translation model heuristic scores
+      // indexed by hypothesis coverage
+  typedef PbTransModelCacheData::CoverageHeurScoreCache CoverageHeurScoreCache;
       // Additional data structures to store information about heuristics
   std::vector<LgProb> refHeurLmLgProb;
   std::vector<LgProb> prefHeurLmLgProb;
@@ -411,6 +425,10 @@ class _phraseBasedTransModel: public BasePbTransModel<HYPOTHESIS>
   Score calcRefLmHeurScore(const _phraseBasedTransModel::Hypothesis& hyp);
   Score calcPrefLmHeurScore(const _phraseBasedTransModel::Hypothesis& hyp);
   Score heuristicLocalt(const Hypothesis& hyp);
+  Score localTmHeurScoreForCoverage(const Bitset<MAX_SENTENCE_LENGTH_ALLOWED>& hypKey,
+                                    const std::vector<std::pair<PositionIndex,PositionIndex> >* gapsPtr=NULL);
+      // gapsPtr may point to the gaps of hypKey if they were already
+      // extracted by the caller
   void initHeuristicLocaltd(int maxSrcPhraseLength);
   Score heuristicLocaltd(const Hypothesis& hyp);
   std::vector<unsigned int> min_jumps(const std::vector<std::pair<PositionIndex,PositionIndex> >& gaps,
@@ -577,8 +595,8 @@ Score _phraseBasedTransModel<HYPOTHESIS>::nbestLmScoringFunc(const std::vector<W
       // translation options is large
   
   PhraseCacheTable::iterator pctIter;
-  pctIter=nbTransCacheData.cnbLmScores.find(target);
-  if(pctIter!=nbTransCacheData.cnbLmScores.end())
+  pctIter=cacheHandle.get().nbTransCacheData.cnbLmScores.find(target);
+  if(pctIter!=cacheHandle.get().nbTransCacheData.cnbLmScores.end())
   {
         // Score was previously stored in the cache table
     return pctIter->second;
@@ -590,7 +608,7 @@ Score _phraseBasedTransModel<HYPOTHESIS>::nbestLmScoringFunc(const std::vector<W
     LM_State state;    
     langModelInfoPtr->lModelPtr->getStateForWordSeq(hist,state);
     Score scr=getNgramScoreGivenState(target,state);
-    nbTransCacheData.cnbLmScores[target]=scr;
+    cacheHandle.get().nbTransCacheData.cnbLmScores[target]=scr;
     return scr;
   }
 }
@@ -610,16 +628,27 @@ Score _phraseBasedTransModel<HYPOTHESIS>::getNgramScoreGivenState(const std::vec
     target_lm.push_back(tmVocabToLmVocab(target[i]));
   }
       
+#ifdef WORK_WITH_ZERO_GRAM_PROB
   for(unsigned int i=0;i<target_lm.size();++i)
   {
-#ifdef WORK_WITH_ZERO_GRAM_PROB
     Score scr=log((double)langModelInfoPtr->lModelPtr->getZeroGramProb());
-#else
-    Score scr=(double)langModelInfoPtr->lModelPtr->getNgramLgProbGivenState(target_lm[i],state);
-#endif
         // Increase score
     unweighted_result+=scr;
   }
+#else
+  if(!target_lm.empty())
+  {
+        // Score all the words of the phrase with a single query
+    std::vector<LgProb> lgProbVec;
+    langModelInfoPtr->lModelPtr->getWordSeqLgProbGivenState(target_lm,state,lgProbVec);
+    for(unsigned int i=0;i<lgProbVec.size();++i)
+    {
+      Score scr=(double)lgProbVec[i];
+          // Increase score
+      unweighted_result+=scr;
+    }
+  }
+#endif
       // Return result
   return langModelInfoPtr->langModelPars.lmScaleFactor*unweighted_result;
 }
@@ -668,6 +697,8 @@ template<class HYPOTHESIS>
 std::vector<Score> _phraseBasedTransModel<HYPOTHESIS>::phrScoreVec_s_t_(const std::vector<WordIndex>& s_,
                                                                    const std::vector<WordIndex>& t_)
 {
+  PhrasePairVecScore& cachedInversePhrScoreVecs=cacheHandle.get().cachedInversePhrScoreVecs;
+
       // Check if score of phrase pair is stored in cache table
   PhrasePairVecScore::iterator ppctIter=cachedInversePhrScoreVecs.find(std::make_pair(s_,t_));
   if(ppctIter!=cachedInversePhrScoreVecs.end()) return ppctIter->second;
@@ -699,6 +730,8 @@ template<class HYPOTHESIS>
 std::vector<Score> _phraseBasedTransModel<HYPOTHESIS>::phrScoreVec_t_s_(const std::vector<WordIndex>& s_,
                                                                    const std::vector<WordIndex>& t_)
 {
+  PhrasePairVecScore& cachedDirectPhrScoreVecs=cacheHandle.get().cachedDirectPhrScoreVecs;
+
       // Check if score of phrase pair is stored in cache table
   PhrasePairVecScore::iterator ppctIter=cachedDirectPhrScoreVecs.find(std::make_pair(s_,t_));
   if(ppctIter!=cachedDirectPhrScoreVecs.end()) return ppctIter->second;
@@ -739,6 +772,13 @@ Score _phraseBasedTransModel<HYPOTHESIS>::trgSegmLenScore(unsigned int x_k,
   return this->phrModelInfoPtr->phraseModelPars.trgSegmLenWeight * (double)this->phrModelInfoPtr->invPbModelPtr->srcSegmLenLgProb(x_k,x_km1,trgLen);
 }
 
+//---------------------------------
+template<class HYPOTHESIS>
+void _phraseBasedTransModel<HYPOTHESIS>::releaseSentenceCaches(void)
+{
+  cacheHandle.release();
+}
+
 //---------------------------------
 template<class HYPOTHESIS>
 void _phraseBasedTransModel<HYPOTHESIS>::clearTempVars(void)
@@ -752,12 +792,8 @@ void _phraseBasedTransModel<HYPOTHESIS>::clearTempVars(void)
   // Clear data structures that are used 
   // for fast access.
   
-      // Clear phrase model caching data members
-  cachedDirectPhrScoreVecs.clear();
-  cachedInversePhrScoreVecs.clear();
-
-      // Clear n-best translation cache data
-  nbTransCacheData.clear();
+      // Return cached data to the pool
+  cacheHandle.release();
 
       // Init the map between TM and LM vocabularies
   initTmToLmVocabMap();
@@ -1079,17 +1115,7 @@ Score _phraseBasedTransModel<HYPOTHESIS>::heuristicLocalt(const Hypothesis& hyp)
 {
   if(state==MODEL_TRANS_STATE)
   {
-    LgProb result=0;
-    unsigned int J;
-    std::vector<std::pair<PositionIndex,PositionIndex> > gaps;
-    
-    J=pbtmInputVars.srcSentVec.size();
-    this->extract_gaps(hyp,gaps);
-    for(unsigned int i=0;i<gaps.size();++i)
-    {
-      result+=heuristicScoreVec[gaps[i].second-1][J-gaps[i].first];	
-    }
-    return result;
+    return localTmHeurScoreForCoverage(hyp.getKey());
   }
   else
   {
@@ -1098,6 +1124,40 @@ Score _phraseBasedTransModel<HYPOTHESIS>::heuristicLocalt(const Hypothesis& hyp)
   }
 }
 
+//---------------------------------
+template<class HYPOTHESIS>
+Score _phraseBasedTransModel<HYPOTHESIS>::localTmHeurScoreForCoverage(const Bitset<MAX_SENTENCE_LENGTH_ALLOWED>& hypKey,
+                                                                      const std::vector<std::pair<PositionIndex,PositionIndex> >* gapsPtr)
+{
+  CoverageHeurScoreCache& localTmHeurScoreCache=cacheHandle.get().localTmHeurScoreCache;
+
+      // Check if the score for this coverage was already computed
+  typename CoverageHeurScoreCache::const_iterator cacheIter=localTmHeurScoreCache.find(hypKey);
+  if(cacheIter!=localTmHeurScoreCache.end())
+  {
+    DecProf::count(DEC_PROF_HEUR_CACHE_HITS);
+    return cacheIter->second;
+  }
+  DecProf::count(DEC_PROF_HEUR_CACHE_MISSES);
+
+  std::vector<std::pair<PositionIndex,PositionIndex> > extractedGaps;
+  if(gapsPtr==NULL)
+  {
+    this->extract_gaps(hypKey,extractedGaps);
+    gapsPtr=&extractedGaps;
+  }
+  const std::vector<std::pair<PositionIndex,PositionIndex> >& gaps=*gapsPtr;
+
+  Score result=0;
+  unsigned int J=pbtmInputVars.srcSentVec.size();
+  for(unsigned int i=0;i<gaps.size();++i)
+  {
+    result+=heuristicScoreVec[gaps[i].second-1][J-gaps[i].first];	
+  }
+  localTmHeurScoreCache[hypKey]=result;
+  return result;
+}
+
 //---------------------------------
 template<class HYPOTHESIS>
 void _phraseBasedTransModel<HYPOTHESIS>::initHeuristicLocaltd(int maxSrcPhraseLength)
@@ -1112,16 +1172,11 @@ Score _phraseBasedTransModel<HYPOTHESIS>::heuristicLocaltd(const Hypothesis& hyp
 
   if(state==MODEL_TRANS_STATE)
   {
-    Score result=0;
-    
         // Get local t heuristic information
-    unsigned int J=pbtmInputVars.srcSentVec.size();
+    Bitset<MAX_SENTENCE_LENGTH_ALLOWED> hypKey=hyp.getKey();
     std::vector<std::pair<PositionIndex,PositionIndex> > gaps;
-    this->extract_gaps(hyp,gaps);
-    for(unsigned int i=0;i<gaps.size();++i)
-    {
-      result+=heuristicScoreVec[gaps[i].second-1][J-gaps[i].first];	
-    }
+    this->extract_gaps(hypKey,gaps);
+    Score result=localTmHeurScoreForCoverage(hypKey,&gaps);
 
         // Distortion heuristic information
     PositionIndex lastSrcPosCovered=getLastSrcPosCovered(hyp);
@@ -1905,30 +1960,19 @@ void _phraseBasedTransModel<HYPOTHESIS>::extract_gaps(const Bitset<MAX_SENTENCE_
 {
       // Extract all uncovered gaps
   std::pair<PositionIndex,PositionIndex> gap;
-  unsigned int srcSentLen=this->numberOfUncoveredSrcWordsHypData(this->nullHypothesisHypData());
-  unsigned int j;
+  size_t srcSentLen=this->numberOfUncoveredSrcWordsHypData(this->nullHypothesisHypData());
+  size_t j=1;
   
-      // Extract gaps
+      // Extract gaps, skipping whole words of covered or uncovered
+      // positions at a time
   gaps.clear();
-  bool crossing_a_gap=false;	
-	
-  for(j=1;j<=srcSentLen;++j)
-  {
-    if(crossing_a_gap==false && hypKey.test(j)==0)
-    {
-      crossing_a_gap=true;
-      gap.first=j;
-    }
-	
-    if(crossing_a_gap==true && hypKey.test(j)==1)
-    {
-      crossing_a_gap=false;
-      gap.second=j-1;
-      gaps.push_back(gap);	
-    }	
-  }
-  if(crossing_a_gap==true)
+  while(true)
   {
+    j=hypKey.find_next_unset(j);
+    if(j>srcSentLen) break;
+    gap.first=j;
+    j=hypKey.find_next_set(j);
+    if(j>srcSentLen+1) j=srcSentLen+1;
     gap.second=j-1;
     gaps.push_back(gap);
   }
@@ -1941,32 +1985,15 @@ _phraseBasedTransModel<HYPOTHESIS>::get_num_gaps(const Bitset<MAX_SENTENCE_LENGT
 {
       // Count all uncovered gaps
   unsigned int result=0;
-  unsigned int j;
-  bool crossing_a_gap;
-  unsigned int srcSentLen;
-  HypDataType nullHypData=this->nullHypothesisHypData();
+  size_t srcSentLen=this->numberOfUncoveredSrcWordsHypData(this->nullHypothesisHypData());
+  size_t j=1;
 
-  srcSentLen=this->numberOfUncoveredSrcWordsHypData(nullHypData);
-  
-      // count gaps	
-  crossing_a_gap=false;	
-	
-  for(j=1;j<=srcSentLen;++j)
-  {
-    if(crossing_a_gap==false && hypKey.test(j)==0)
-    {
-      crossing_a_gap=true;
-    }
-	
-    if(crossing_a_gap==true && hypKey.test(j)==1)
-    {
-      crossing_a_gap=false;
-      ++result;	
-    }	
-  }
-  if(crossing_a_gap==true)
+  while(true)
   {
+    j=hypKey.find_next_unset(j);
+    if(j>srcSentLen) break;
     ++result;
+    j=hypKey.find_next_set(j);
   }
   return result;
 }
@@ -2217,18 +2244,20 @@ bool _phraseBasedTransModel<HYPOTHESIS>::getTransForHypUncovGap(const Hypothesis
         s_.push_back(pbtmInputVars.nsrcSentIdVec[i]);
       }
     
-      transTableNodePtr=nbTransCacheData.cPhrNbestTransTable.getTranslationsForKey(std::make_pair(srcLeft,srcRight));
+      transTableNodePtr=cacheHandle.get().nbTransCacheData.cPhrNbestTransTable.getTranslationsForKey(std::make_pair(srcLeft,srcRight));
       if(transTableNodePtr!=NULL)
       {
             // translation present in the cache translation table
+        DecProf::count(DEC_PROF_TRANS_OPT_CACHE_HITS);
         nbt=*transTableNodePtr;
         if(nbt.size()==0) return false;
         else return true;
       }
       else
       {   
+        DecProf::count(DEC_PROF_TRANS_OPT_CACHE_MISSES);
         getNbestTransFor_s_(s_,nbt,N);
-        nbTransCacheData.cPhrNbestTransTable.insertEntry(std::make_pair(srcLeft,srcRight),nbt);
+        cacheHandle.get().nbTransCacheData.cPhrNbestTransTable.insertEntry(std::make_pair(srcLeft,srcRight),nbt);
         if(nbt.size()==0) return false;
         else return true;
       }
@@ -2288,7 +2317,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::getTransForHypUncovGapRef(const Hypothe
         // Search the required translations in the cache translation
         // table
     
-    transTableNodePtr=nbTransCacheData.cPhrNbestTransTableRef.getTranslationsForKey(pNbtRefKey);
+    transTableNodePtr=cacheHandle.get().nbTransCacheData.cPhrNbestTransTableRef.getTranslationsForKey(pNbtRefKey);
     if(transTableNodePtr!=NULL)
     {// translations present in the cache translation table
       nbt=*transTableNodePtr;
@@ -2313,7 +2342,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::getTransForHypUncovGapRef(const Hypothe
         nbt.pruneGivenThreshold(bscr+(double)log(N));
       }
           // Store the list in cPhrNbestTransTableRef
-      nbTransCacheData.cPhrNbestTransTableRef.insertEntry(pNbtRefKey,nbt);
+      cacheHandle.get().nbTransCacheData.cPhrNbestTransTableRef.insertEntry(pNbtRefKey,nbt);
     }
   }
   else
@@ -2367,7 +2396,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::getTransForHypUncovGapPref(const Hypoth
     
         // Search the required translations in the cache translation
         // table
-    transTableNodePtr=nbTransCacheData.cPhrNbestTransTablePref.getTranslationsForKey(pNbtPrefKey);
+    transTableNodePtr=cacheHandle.get().nbTransCacheData.cPhrNbestTransTablePref.getTranslationsForKey(pNbtPrefKey);
     if(transTableNodePtr!=NULL)
     {// translations present in the cache translation table
       nbt=*transTableNodePtr;
@@ -2386,7 +2415,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::getTransForHypUncovGapPref(const Hypoth
         nbt.pruneGivenThreshold(bscr+(double)log(N));
       }
           // Store the list in cPhrNbestTransTablePref
-      nbTransCacheData.cPhrNbestTransTablePref.insertEntry(pNbtPrefKey,nbt);
+      cacheHandle.get().nbTransCacheData.cPhrNbestTransTablePref.insertEntry(pNbtPrefKey,nbt);
     }
     if(nbt.size()==0) return false;
     else return true;
@@ -2567,6 +2596,7 @@ bool _phraseBasedTransModel<HYPOTHESIS>::getNbestTransFor_s_(std::vector<WordInd
 {
   BasePhraseModel::SrcTableNode srctn;
   BasePhraseModel::SrcTableNode::iterator srctnIter;
+  DecProfPhaseTimer optCollectionTimer(DEC_PROF_OPT_COLLECTION);
   bool ret;
 
       // Obtain the whole list of translations
@@ -2604,17 +2634,19 @@ Score _phraseBasedTransModel<HYPOTHESIS>::nbestTransScoreCached(const std::vecto
                                                                 const std::vector<WordIndex>& t_)
 {
   PhrasePairCacheTable::iterator ppctIter;
-  ppctIter=nbTransCacheData.cnbestTransScore.find(std::make_pair(s_,t_));
-  if(ppctIter!=nbTransCacheData.cnbestTransScore.end())
+  ppctIter=cacheHandle.get().nbTransCacheData.cnbestTransScore.find(std::make_pair(s_,t_));
+  if(ppctIter!=cacheHandle.get().nbTransCacheData.cnbestTransScore.end())
   {
         // Score was previously stored in the cache table
+    DecProf::count(DEC_PROF_PHR_SCR_CACHE_HITS);
     return ppctIter->second;
   }
   else
   {
         // Score is not stored in the cache table
+    DecProf::count(DEC_PROF_PHR_SCR_CACHE_MISSES);
     Score scr=nbestTransScore(s_,t_);
-    nbTransCacheData.cnbestTransScore[std::make_pair(s_,t_)]=scr;
+    cacheHandle.get().nbTransCacheData.cnbestTransScore[std::make_pair(s_,t_)]=scr;
     return scr;
   }
 }
@@ -2625,17 +2657,19 @@ Score _phraseBasedTransModel<HYPOTHESIS>::nbestTransScoreLastCached(const std::v
                                                                     const std::vector<WordIndex>& t_)
 {
   PhrasePairCacheTable::iterator ppctIter;
-  ppctIter=nbTransCacheData.cnbestTransScoreLast.find(std::make_pair(s_,t_));
-  if(ppctIter!=nbTransCacheData.cnbestTransScoreLast.end())
+  ppctIter=cacheHandle.get().nbTransCacheData.cnbestTransScoreLast.find(std::make_pair(s_,t_));
+  if(ppctIter!=cacheHandle.get().nbTransCacheData.cnbestTransScoreLast.end())
   {
         // Score was previously stored in the cache table
+    DecProf::count(DEC_PROF_PHR_SCR_CACHE_HITS);
     return ppctIter->second;
   }
   else
   {
         // Score is not stored in the cache table
+    DecProf::count(DEC_PROF_PHR_SCR_CACHE_MISSES);
     Score scr=nbestTransScoreLast(s_,t_);
-    nbTransCacheData.cnbestTransScoreLast[std::make_pair(s_,t_)]=scr;
+    cacheHandle.get().nbTransCacheData.cnbestTransScoreLast[std::make_pair(s_,t_)]=scr;
     return scr;
   }
 }
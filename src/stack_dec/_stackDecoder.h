@@ -57,6 +57,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "BaseSmtStack.h"
 #include "BaseSmtMultiStack.h"
 #include "_stack_decoder_statistics.h"
+#include "DecProfiler.h"
+#include "ThreadPool.h"
 #include "float.h"
 
 //--------------- Constants ------------------------------------------
@@ -100,6 +102,7 @@ class _stackDecoder: public BaseStackDecoder<SMT_MODEL>
       // Functions for setting the decoder parameters
   void set_S_par(unsigned int S_par);
   void set_I_par(unsigned int I_par);
+  void set_nt_par(unsigned int nt_par);
   void set_breadthFirst(bool b);
     
       // Basic services
@@ -166,6 +169,8 @@ class _stackDecoder: public BaseStackDecoder<SMT_MODEL>
   unsigned int S;                // Maximum stack size
   unsigned int I;                // Number of hypotheses to be expanded
                                  // at each iteration
+  unsigned int nt;               // Number of threads used to expand
+                                 // the hypotheses of each iteration
   
   bool useRef;                   // If useRef=true, the expand process
                                  // will be based on a target reference
@@ -185,6 +190,30 @@ class _stackDecoder: public BaseStackDecoder<SMT_MODEL>
   Score worstScoreAllowed;
   
   int verbosity;                 // Verbosity level
+
+      // Data members for parallel expansion of hypotheses
+  ThreadPool threadPool;
+  std::vector<SMT_MODEL*> workerSmtmPtrVec; // Copies of the model used
+                                            // by the workers (worker 0
+                                            // uses smtm_ptr). They are
+                                            // created once and updated
+                                            // for each sentence
+  bool workerSmtmReady;          // Copies updated for current sentence
+  bool parExpansionWarned;       // Warning about models not supporting
+                                 // parallel expansion already printed
+  struct ParallelExpansionData
+  {
+    _stackDecoder<SMT_MODEL>* decPtr;
+    const std::vector<Hypothesis>* hypsToExpandPtr;
+    std::vector<unsigned int> hypIdxVec;
+    std::vector<std::vector<Hypothesis> >* expandedHypsVecPtr;
+    std::vector<std::vector<std::vector<Score> > >* scrCompVecVecPtr;
+    bool profEnabled;
+    std::vector<DecProfData> workerProfDataVec; // Profiling data
+                                                // collected by the
+                                                // workers other than
+                                                // worker 0
+  };
     
   void addgToHyp(Hypothesis& hyp);
   void subtractgToHyp(Hypothesis& hyp);
@@ -219,8 +248,29 @@ class _stackDecoder: public BaseStackDecoder<SMT_MODEL>
       // function can be overridden by derived classes which use
       // hypotheses-recombination
     
+      // Functions related to parallel expansion of hypotheses
+  bool prepareWorkerSmtms(void);
+      // Creates the copies of the model used by the workers if
+      // required and updates them for the current sentence, returns
+      // false if parallel expansion is not possible
+  void resetWorkerSmtms(void);
+      // Makes the copies release the data of the previous sentence
+  void releaseWorkerSmtms(void);
+      // Deletes the copies
+  bool expandHypsInParallel(const std::vector<Hypothesis>& hypsToExpand,
+                            std::vector<std::vector<Hypothesis> >& expandedHypsVec,
+                            std::vector<std::vector<std::vector<Score> > >& scrCompVecVec);
+      // Expands the non-complete hypotheses contained in hypsToExpand
+      // using the thread pool. expandedHypsVec[i] and scrCompVecVec[i]
+      // store the expansions of hypsToExpand[i], so the results do not
+      // depend on the order in which the tasks are completed. Returns
+      // false if the hypotheses should be expanded serially
+  static void expandHypTask(void* taskData,
+                            unsigned int taskIdx,
+                            unsigned int workerIdx);
+
       // Implementation of decoding processes
-  Hypothesis decode(void);
+  virtual Hypothesis decode(void);
   Hypothesis decodeWithRef(void);
   Hypothesis decodeVer(void);
   Hypothesis decodeWithPrefix(void);
@@ -256,6 +306,9 @@ _stackDecoder<SMT_MODEL>::_stackDecoder(void)
   breadthFirst=false;
   S=10;
   I=1;
+  nt=1;
+  workerSmtmReady=false;
+  parExpansionWarned=false;
   smtm_ptr=NULL;
   stack_ptr=NULL;
   verbosity=0;
@@ -265,7 +318,8 @@ _stackDecoder<SMT_MODEL>::_stackDecoder(void)
 template<class SMT_MODEL>
 bool _stackDecoder<SMT_MODEL>::link_smt_model(BaseSmtModel<Hypothesis>* _smtm_ptr)
 {
-      // Link smt model
+      // Link smt model, the copies of the previous one are not valid
+  releaseWorkerSmtms();
   smtm_ptr=dynamic_cast<SMT_MODEL*>(_smtm_ptr);
   if(smtm_ptr)
     return THOT_OK;
@@ -295,6 +349,19 @@ void _stackDecoder<SMT_MODEL>::set_I_par(unsigned int I_par)
   I=I_par;
 }
 
+//---------------------------------------
+template<class SMT_MODEL>
+void _stackDecoder<SMT_MODEL>::set_nt_par(unsigned int nt_par)
+{
+  if(nt_par==0)
+    nt_par=1;
+  releaseWorkerSmtms();
+  if(threadPool.init(nt_par)==THOT_OK)
+    nt=nt_par;
+  else
+    nt=1;
+}
+
 //---------------------------------------
 template<class SMT_MODEL>
 void _stackDecoder<SMT_MODEL>::set_breadthFirst(bool b)
@@ -364,6 +431,7 @@ _stackDecoder<SMT_MODEL>::getNextTrans(void)
     bestCompleteHyp=smtm_ptr->nullHypothesis();
 
         // get next translation depending on the state of the decoder
+    DecProfPhaseTimer searchTimer(DEC_PROF_SEARCH);
     switch(state)
     {
       case DEC_TRANS_STATE: return decode();
@@ -419,6 +487,7 @@ _stackDecoder<SMT_MODEL>::translateWithSuggestion(std::string s,
         // Translate sentence
     if(verbosity>0)
       std::cerr<<"Decoding input..."<<std::endl;
+    DecProfPhaseTimer searchTimer(DEC_PROF_SEARCH);
     return decode();
   }
 }
@@ -471,6 +540,7 @@ _stackDecoder<SMT_MODEL>::translateWithRef(std::string s,
 
     if(verbosity>0)
       std::cerr<<"Decoding input..."<<std::endl;
+    DecProfPhaseTimer searchTimer(DEC_PROF_SEARCH);
     return decodeWithRef();
   }
 }
@@ -523,6 +593,7 @@ _stackDecoder<SMT_MODEL>::verifyCoverageForRef(std::string s,
 
     if(verbosity>0)
       std::cerr<<"Decoding input..."<<std::endl;
+    DecProfPhaseTimer searchTimer(DEC_PROF_SEARCH);
     return decodeVer();
   }
 }
@@ -575,6 +646,7 @@ _stackDecoder<SMT_MODEL>::translateWithPrefix(std::string s,
 
     if(verbosity>0)
       std::cerr<<"Decoding input..."<<std::endl;
+    DecProfPhaseTimer searchTimer(DEC_PROF_SEARCH);
     return decodeWithPrefix();
   }
 }
@@ -674,7 +746,9 @@ Score _stackDecoder<SMT_MODEL>::testHeuristic(std::string sentence,
 template<class SMT_MODEL>
 int _stackDecoder<SMT_MODEL>::pre_trans_actions(std::string srcsent)
 {
+  DecProfPhaseTimer preprocTimer(DEC_PROF_PREPROC);
   clear();
+  resetWorkerSmtms();
   state=DEC_TRANS_STATE;
   srcSentence=srcsent;
   smtm_ptr->pre_trans_actions(srcsent);
@@ -704,7 +778,9 @@ template<class SMT_MODEL>
 void _stackDecoder<SMT_MODEL>::pre_trans_actions_ref(std::string srcsent,
                                                      std::string refsent)
 {
+  DecProfPhaseTimer preprocTimer(DEC_PROF_PREPROC);
   clear();
+  resetWorkerSmtms();
   state=DEC_TRANSREF_STATE;
   srcSentence=srcsent;
   refSentence=refsent;
@@ -719,7 +795,9 @@ template<class SMT_MODEL>
 void _stackDecoder<SMT_MODEL>::pre_trans_actions_ver(std::string srcsent,
                                                      std::string refsent)
 {
+  DecProfPhaseTimer preprocTimer(DEC_PROF_PREPROC);
   clear();
+  resetWorkerSmtms();
   state=DEC_VER_STATE;
   srcSentence=srcsent;
   refSentence=refsent;
@@ -734,7 +812,9 @@ template<class SMT_MODEL>
 void _stackDecoder<SMT_MODEL>::pre_trans_actions_prefix(std::string srcsent,
                                                         std::string prefix)
 {
+  DecProfPhaseTimer preprocTimer(DEC_PROF_PREPROC);
   clear();
+  resetWorkerSmtms();
   state=DEC_TRANSPREFIX_STATE;
   srcSentence=srcsent;
   prefixSentence=prefix;
@@ -811,6 +891,9 @@ bool _stackDecoder<SMT_MODEL>::push(Hypothesis hyp)
     ++this->_stack_decoder_stats.totalPushNo;
     ++this->_stack_decoder_stats.pushPerIter;  
 #  endif
+    DecProf::count(DEC_PROF_HYPS_PUSHED);
+    if(!inserted)
+      DecProf::count(DEC_PROF_HYPS_DISCARDED);
   }
   return inserted;
 }
@@ -869,12 +952,158 @@ bool _stackDecoder<SMT_MODEL>::pushGivenPredHyp(const Hypothesis& /*pred_hyp*/,
   return push(succ_hyp);
 }
 
+//---------------------------------------
+template<class SMT_MODEL>
+bool _stackDecoder<SMT_MODEL>::prepareWorkerSmtms(void)
+{
+  if(!workerSmtmReady)
+  {
+        // Complete per-sentence data of the model before sharing it
+        // with the copies
+    if(!smtm_ptr->prepareForParallelExpansion())
+    {
+      if(!parExpansionWarned)
+      {
+        std::cerr<<"Warning: the translation model does not support parallel expansion of hypotheses, they will be expanded serially"<<std::endl;
+        parExpansionWarned=true;
+      }
+      return false;
+    }
+
+        // Create the copies the first time they are needed
+    while(workerSmtmPtrVec.size()+1<threadPool.getNumWorkers())
+    {
+      SMT_MODEL* workerSmtmPtr=dynamic_cast<SMT_MODEL*>(smtm_ptr->clone());
+      if(workerSmtmPtr==NULL)
+      {
+        releaseWorkerSmtms();
+        return false;
+      }
+      workerSmtmPtrVec.push_back(workerSmtmPtr);
+    }
+
+        // Update the copies for the current sentence
+    for(unsigned int w=0;w<workerSmtmPtrVec.size();++w)
+    {
+      if(!smtm_ptr->updateCopyForParallelExpansion(workerSmtmPtrVec[w]))
+      {
+        releaseWorkerSmtms();
+        return false;
+      }
+    }
+    workerSmtmReady=true;
+  }
+  return true;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+void _stackDecoder<SMT_MODEL>::resetWorkerSmtms(void)
+{
+  for(unsigned int w=0;w<workerSmtmPtrVec.size();++w)
+    workerSmtmPtrVec[w]->releaseSentenceCaches();
+  workerSmtmReady=false;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+void _stackDecoder<SMT_MODEL>::releaseWorkerSmtms(void)
+{
+  for(unsigned int w=0;w<workerSmtmPtrVec.size();++w)
+    delete workerSmtmPtrVec[w];
+  workerSmtmPtrVec.clear();
+  workerSmtmReady=false;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+bool _stackDecoder<SMT_MODEL>::expandHypsInParallel(const std::vector<Hypothesis>& hypsToExpand,
+                                                    std::vector<std::vector<Hypothesis> >& expandedHypsVec,
+                                                    std::vector<std::vector<std::vector<Score> > >& scrCompVecVec)
+{
+      // Only regular translation is supported
+  if(state!=DEC_TRANS_STATE)
+    return false;
+
+      // Obtain indices of hypotheses to be expanded
+  ParallelExpansionData parExpData;
+  for(unsigned int i=0;i<hypsToExpand.size();++i)
+  {
+    if(!smtm_ptr->isComplete(hypsToExpand[i]))
+      parExpData.hypIdxVec.push_back(i);
+  }
+  if(parExpData.hypIdxVec.size()<2)
+    return false;
+
+      // Make sure that the workers have their own model copies
+  if(!prepareWorkerSmtms())
+    return false;
+
+      // Execute expansion tasks
+  expandedHypsVec.clear();
+  expandedHypsVec.resize(hypsToExpand.size());
+  scrCompVecVec.clear();
+  scrCompVecVec.resize(hypsToExpand.size());
+  parExpData.decPtr=this;
+  parExpData.hypsToExpandPtr=&hypsToExpand;
+  parExpData.expandedHypsVecPtr=&expandedHypsVec;
+  parExpData.scrCompVecVecPtr=&scrCompVecVec;
+  parExpData.profEnabled=DecProf::enabled();
+  parExpData.workerProfDataVec.resize(threadPool.getNumWorkers());
+  for(unsigned int w=0;w<parExpData.workerProfDataVec.size();++w)
+    parExpData.workerProfDataVec[w].clear();
+  threadPool.run(&_stackDecoder<SMT_MODEL>::expandHypTask,(void*)&parExpData,parExpData.hypIdxVec.size());
+
+      // Add profiling data of the workers to the current thread
+  for(unsigned int w=0;w<parExpData.workerProfDataVec.size();++w)
+    DecProf::mergeIntoThread(parExpData.workerProfDataVec[w]);
+
+  return true;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+void _stackDecoder<SMT_MODEL>::expandHypTask(void* taskData,
+                                             unsigned int taskIdx,
+                                             unsigned int workerIdx)
+{
+  ParallelExpansionData* parExpDataPtr=(ParallelExpansionData*) taskData;
+  _stackDecoder<SMT_MODEL>* decPtr=parExpDataPtr->decPtr;
+  unsigned int i=parExpDataPtr->hypIdxVec[taskIdx];
+
+      // Choose model for worker
+  SMT_MODEL* smtmPtr;
+  if(workerIdx==0)
+    smtmPtr=decPtr->smtm_ptr;
+  else
+    smtmPtr=decPtr->workerSmtmPtrVec[workerIdx-1];
+
+      // Expand hypothesis (worker 0 is executed by the thread of the
+      // request, which is already collecting profiling data)
+  if(workerIdx==0)
+  {
+    smtmPtr->expand((*parExpDataPtr->hypsToExpandPtr)[i],
+                    (*parExpDataPtr->expandedHypsVecPtr)[i],
+                    (*parExpDataPtr->scrCompVecVecPtr)[i]);
+  }
+  else
+  {
+    DecProfWorkerScope profScope(parExpDataPtr->profEnabled,
+                                 parExpDataPtr->workerProfDataVec[workerIdx]);
+    smtmPtr->expand((*parExpDataPtr->hypsToExpandPtr)[i],
+                    (*parExpDataPtr->expandedHypsVecPtr)[i],
+                    (*parExpDataPtr->scrCompVecVecPtr)[i]);
+  }
+}
+
 //---------------------------------------
 template<class SMT_MODEL>
 typename _stackDecoder<SMT_MODEL>::Hypothesis _stackDecoder<SMT_MODEL>::decode(void)
 {
   bool end=false;
   std::vector<Hypothesis> hypsToExpand;
+  std::vector<std::vector<Hypothesis> > expandedHypsVec;
+  std::vector<std::vector<std::vector<Score> > > scrCompVecVec;
   Hypothesis result=smtm_ptr->nullHypothesis();
   unsigned int iterNo=1;
     
@@ -911,6 +1140,11 @@ typename _stackDecoder<SMT_MODEL>::Hypothesis _stackDecoder<SMT_MODEL>::decode(v
     if(hypsToExpand.empty()) end=true;
     else	   
     {
+          // Expand hypotheses in parallel if requested
+      bool expandedInParallel=false;
+      if(nt>1)
+        expandedInParallel=expandHypsInParallel(hypsToExpand,expandedHypsVec,scrCompVecVec);
+
           // There are hypotheses to be expanded
       for(unsigned int i=0;i<hypsToExpand.size();++i)
       {
@@ -934,6 +1168,7 @@ typename _stackDecoder<SMT_MODEL>::Hypothesis _stackDecoder<SMT_MODEL>::decode(v
 #        ifdef THOT_STATS
           ++this->_stack_decoder_stats.totalExpansionNo;
 #        endif  
+          DecProf::count(DEC_PROF_HYPS_EXPANDED);
 
           if(verbosity>1)
           {
@@ -944,7 +1179,15 @@ typename _stackDecoder<SMT_MODEL>::Hypothesis _stackDecoder<SMT_MODEL>::decode(v
           std::vector<Hypothesis> expandedHyps;
           std::vector<std::vector<Score> > scrCompVec;
           int numExpHyp=0;
-          smtm_ptr->expand(hypsToExpand[i],expandedHyps,scrCompVec);
+          if(expandedInParallel)
+          {
+                // Retrieve expansions generated by the workers, they
+                // are pushed in the same order as in serial mode
+            expandedHyps.swap(expandedHypsVec[i]);
+            scrCompVec.swap(scrCompVecVec[i]);
+          }
+          else
+            smtm_ptr->expand(hypsToExpand[i],expandedHyps,scrCompVec);
 
               // Update result variable (choose hypothesis further to
               // null hypothesis with a higher score)
@@ -1052,6 +1295,7 @@ typename _stackDecoder<SMT_MODEL>::Hypothesis _stackDecoder<SMT_MODEL>::decodeWi
 #        ifdef THOT_STATS
           ++this->_stack_decoder_stats.totalExpansionNo;
 #        endif  
+          DecProf::count(DEC_PROF_HYPS_EXPANDED);
 
           if(verbosity>1)
           {
@@ -1159,6 +1403,7 @@ typename _stackDecoder<SMT_MODEL>::Hypothesis _stackDecoder<SMT_MODEL>::decodeVe
 #        ifdef THOT_STATS
           ++this->_stack_decoder_stats.totalExpansionNo;
 #        endif  
+          DecProf::count(DEC_PROF_HYPS_EXPANDED);
 
           if(verbosity>1)
           {
@@ -1265,6 +1510,7 @@ typename _stackDecoder<SMT_MODEL>::Hypothesis _stackDecoder<SMT_MODEL>::decodeWi
 #        ifdef THOT_STATS
           ++this->_stack_decoder_stats.totalExpansionNo;
 #        endif  
+          DecProf::count(DEC_PROF_HYPS_EXPANDED);
 
           if(verbosity>1)
           {
@@ -1317,7 +1563,7 @@ void _stackDecoder<SMT_MODEL>::setVerbosity(int _verbosity)
 template<class SMT_MODEL>
 _stackDecoder<SMT_MODEL>::~_stackDecoder()
 {
-  
+  releaseWorkerSmtms();
 } 
 //---------------
 
@@ -190,6 +190,8 @@ void _stackDecoderRec<SMT_MODEL>::setWordGraphPtr(WordGraph* _wordGraphPtr)
 template<class SMT_MODEL>
 unsigned int _stackDecoderRec<SMT_MODEL>::pruneWordGraph(float threshold)
 {
+  DecProfPhaseTimer wgTimer(DEC_PROF_WG_OUTPUT);
+
       // Prune word graph
   unsigned int numPrunedArcs=wordGraphPtr->prune(threshold);
   return numPrunedArcs;
@@ -200,6 +202,7 @@ template<class SMT_MODEL>
 bool _stackDecoderRec<SMT_MODEL>::printWordGraph(const char* filename)
 {
   int ret;
+  DecProfPhaseTimer wgTimer(DEC_PROF_WG_OUTPUT);
 
   if(scoreCompsInWgIncluded)
   {
@@ -52,5 +52,29 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define PRINT_MODELS              9
 #define END_CLIENT_DIALOG        10
 #define END_SERVER               11
+#define TRANSLATE_BATCH          12    // The request carries the number
+                                       // of sentences followed by the
+                                       // sentences, the server returns
+                                       // a status followed by the
+                                       // translation and the
+                                       // hypothesis information of
+                                       // each one in sentence order. A
+                                       // THOT_ERROR status is not
+                                       // followed by any result and
+                                       // ends the batch
+#define GET_PROF_STATS           13    // The server returns the
+                                       // profiling data of the
+                                       // decoder in JSON format
+#define GET_OL_TRAIN_STATS       14    // The server returns the
+                                       // statistics of the online
+                                       // training queue in JSON
+                                       // format
+
+#define MAX_BATCH_SENTS      100000    // Maximum number of sentences
+                                       // of a batch translation request
+#define DEFAULT_BATCH_WORKERS     1
+#define DEFAULT_LONG_SENT_SEGM_LEN 0
+#define DEFAULT_PROF_SAMPLE_RATE  100
+#define DEFAULT_OL_TRAIN_BATCH_SIZE 16
 
 #endif
@@ -0,0 +1,424 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: cube_pruning_decoder_rec                                 */
+/*                                                                  */
+/* Prototypes file: cube_pruning_decoder_rec.h                      */
+/*                                                                  */
+/* Description: Declares the cube_pruning_decoder_rec template      */
+/*              class, this class is derived from the               */
+/*              multi_stack_decoder_rec class and implements a      */
+/*              multiple-stack decoder with hypothesis              */
+/*              recombination and cube pruning.                     */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file cube_pruning_decoder_rec.h
+ *
+ * @brief Declares the cube_pruning_decoder_rec template class, this
+ * class is derived from the multi_stack_decoder_rec class and
+ * implements a multiple-stack decoder with hypothesis recombination
+ * and cube pruning.
+ */
+
+#ifndef _cube_pruning_decoder_rec_h
+#define _cube_pruning_decoder_rec_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "multi_stack_decoder_rec.h"
+#include "BitsetHashF.h"
+#include <queue>
+#include <map>
+#include <set>
+#include <algorithm>
+
+#if __GNUC__>2
+#include <ext/hash_map>
+using __gnu_cxx::hash_map;
+#else
+#include <hash_map>
+#endif
+
+//--------------- Constants ------------------------------------------
+
+#define CUBE_PRUNING_POP_LIMIT_DEFAULT 0
+
+//--------------- Classes --------------------------------------------
+
+/**
+ * @brief The cube_pruning_decoder_rec template class is derived from
+ * the multi_stack_decoder_rec class and implements a multiple-stack
+ * decoder with hypothesis recombination and cube pruning.
+ *
+ * The hypotheses popped at each iteration are grouped by coverage and
+ * each group is combined with the translation options of each
+ * uncovered span (which are sorted by score). The resulting cubes are
+ * explored lazily in best-first order, so only the most promising
+ * extensions are scored. At most popLimit extensions are pushed into
+ * each stack at each iteration.
+ */
+
+//--------------- cube_pruning_decoder_rec template class
+
+template<class SMT_MODEL>
+class cube_pruning_decoder_rec: public multi_stack_decoder_rec<SMT_MODEL>
+{
+ public:
+
+  typedef typename BaseStackDecoder<SMT_MODEL>::Hypothesis Hypothesis;
+  typedef typename SMT_MODEL::HypDataType HypDataType;
+
+  cube_pruning_decoder_rec(void);
+      // Constructor.
+
+  void set_pop_limit(unsigned int _popLimit);
+      // Sets the maximum number of extensions that are pushed into
+      // each stack at each iteration. If _popLimit is zero, the
+      // maximum stack size is used
+
+      // Destructor
+  ~cube_pruning_decoder_rec();
+
+ protected:
+
+  typedef typename Hypothesis::EqClassFunc::EqClassType EqClassType;
+  typedef hash_map<Bitset<MAX_SENTENCE_LENGTH_ALLOWED>,unsigned int,BitsetHashF<MAX_SENTENCE_LENGTH_ALLOWED> > CoverageGroupMap;
+
+      // Cube defined by a group of hypotheses with the same coverage
+      // and a source span
+  struct Cube
+  {
+    unsigned int groupIdx;
+    PositionIndex srcLeft;
+    PositionIndex srcRight;
+    std::vector<std::vector<HypDataType> > hypDataVecs;
+    std::vector<bool> hypDataReady;
+  };
+
+      // Element of a cube
+  struct CubeItem
+  {
+    Score priority;
+    unsigned int cubeIdx;
+    unsigned int hypIdx;
+    unsigned int optIdx;
+    bool valid;
+    Hypothesis extHyp;
+    std::vector<Score> scrComps;
+  };
+
+      // Comparison function for the priority queue of cube items
+  struct CubeItemLess
+  {
+    bool operator()(const CubeItem& a,const CubeItem& b)const
+    {
+      if(a.priority!=b.priority)
+        return a.priority<b.priority;
+      if(a.cubeIdx!=b.cubeIdx)
+        return a.cubeIdx>b.cubeIdx;
+      if(a.hypIdx!=b.hypIdx)
+        return a.hypIdx>b.hypIdx;
+      return a.optIdx>b.optIdx;
+    }
+  };
+
+      // Comparison function used to sort the hypotheses of a group
+  struct HypScoreGreater
+  {
+    bool operator()(const Hypothesis& a,const Hypothesis& b)const
+    {
+      return a.getScore()>b.getScore();
+    }
+  };
+
+  unsigned int popLimit;
+
+  Hypothesis decode(void);
+  void expandHypsWithCubePruning(const std::vector<Hypothesis>& hypsToExpand);
+  bool getCubeItem(std::vector<std::vector<Hypothesis> >& groupVec,
+                   std::vector<Cube>& cubeVec,
+                   unsigned int cubeIdx,
+                   unsigned int hypIdx,
+                   unsigned int optIdx,
+                   CubeItem& cubeItem);
+      // Obtains the cube item given by its indices, returns false if
+      // the indices are out of range
+};
+
+//--------------- cube_pruning_decoder_rec template class function definitions
+
+
+//---------------------------------------
+template<class SMT_MODEL>
+cube_pruning_decoder_rec<SMT_MODEL>::cube_pruning_decoder_rec(void):multi_stack_decoder_rec<SMT_MODEL>()
+{
+  popLimit=CUBE_PRUNING_POP_LIMIT_DEFAULT;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+void cube_pruning_decoder_rec<SMT_MODEL>::set_pop_limit(unsigned int _popLimit)
+{
+  popLimit=_popLimit;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+typename cube_pruning_decoder_rec<SMT_MODEL>::Hypothesis cube_pruning_decoder_rec<SMT_MODEL>::decode(void)
+{
+      // Cube pruning is only applied to regular translation, it also
+      // requires the model to provide lazy expansion services
+  std::vector<std::pair<PositionIndex,PositionIndex> > spanVec;
+  if(this->state!=DEC_TRANS_STATE || !this->smtm_ptr->getSpansForExpansion(this->smtm_ptr->nullHypothesis(),spanVec))
+    return _stackDecoder<SMT_MODEL>::decode();
+
+  bool end=false;
+  std::vector<Hypothesis> hypsToExpand;
+  std::vector<Hypothesis> incompleteHyps;
+  Hypothesis result=this->smtm_ptr->nullHypothesis();
+  unsigned int iterNo=1;
+
+  while(!end && iterNo<MAX_NUM_OF_ITER)
+  {
+        // Select hypothesis to be expanded
+    hypsToExpand.clear();
+    while(!this->stack_ptr->empty() && hypsToExpand.size()<this->I)
+    {
+      hypsToExpand.push_back(this->pop());
+    }
+
+    if(this->verbosity>1)
+    {
+      std::cerr<<std::endl;
+      std::cerr<<"* IterNo: "<<iterNo<<std::endl;
+      std::cerr<<"  Number of queues/hypotheses: "<<this->stack_ptr->size()<<std::endl;
+      std::cerr<<"  hypsToExpand: "<<hypsToExpand.size()<<std::endl;
+    }
+
+#ifdef THOT_STATS
+    this->_stack_decoder_stats.pushPerIter=0;
+    ++this->_stack_decoder_stats.numIter;
+#endif
+        // Finish if there is not any hypothesis to be expanded
+    if(hypsToExpand.empty()) end=true;
+    else
+    {
+      incompleteHyps.clear();
+      for(unsigned int i=0;i<hypsToExpand.size();++i)
+      {
+            // If the hypothesis is complete, finish the decoding
+            // process, but keep the remaining hypotheses (required by
+            // getNextTrans)
+        if(this->smtm_ptr->isComplete(hypsToExpand[i]))
+        {
+          if(!end)
+          {
+                // Return the first complete hypothesis as the final
+                // translation
+            result=hypsToExpand[i];
+            end=true;
+          }
+          else this->push(hypsToExpand[i]);
+        }
+        else
+        {
+#        ifdef THOT_STATS
+          ++this->_stack_decoder_stats.totalExpansionNo;
+#        endif
+          DecProf::count(DEC_PROF_HYPS_EXPANDED);
+              // Update result variable (choose hypothesis further to
+              // null hypothesis with a higher score)
+          if(this->smtm_ptr->distToNullHyp(result) < this->smtm_ptr->distToNullHyp(hypsToExpand[i]))
+          {
+            result=hypsToExpand[i];
+          }
+          else
+          {
+            if(this->smtm_ptr->distToNullHyp(result) == this->smtm_ptr->distToNullHyp(hypsToExpand[i]) && result.getScore() < hypsToExpand[i].getScore())
+              result=hypsToExpand[i];
+          }
+          incompleteHyps.push_back(hypsToExpand[i]);
+        }
+      }
+          // Expand incomplete hypotheses
+      expandHypsWithCubePruning(incompleteHyps);
+    }
+    ++iterNo;
+  }
+
+  if(iterNo>=MAX_NUM_OF_ITER) std::cerr<<"Maximum number of iterations exceeded!\n";
+  return result;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+void cube_pruning_decoder_rec<SMT_MODEL>::expandHypsWithCubePruning(const std::vector<Hypothesis>& hypsToExpand)
+{
+  if(hypsToExpand.empty())
+    return;
+
+      // Group hypotheses by coverage
+  CoverageGroupMap coverageGroupMap;
+  std::vector<std::vector<Hypothesis> > groupVec;
+  for(unsigned int i=0;i<hypsToExpand.size();++i)
+  {
+    std::pair<typename CoverageGroupMap::iterator,bool> insRes=coverageGroupMap.insert(std::make_pair(hypsToExpand[i].getKey(),groupVec.size()));
+    if(insRes.second)
+      groupVec.push_back(std::vector<Hypothesis>());
+    groupVec[insRes.first->second].push_back(hypsToExpand[i]);
+  }
+
+      // Sort the hypotheses of each group and create the cubes
+  std::vector<Cube> cubeVec;
+  for(unsigned int g=0;g<groupVec.size();++g)
+  {
+    std::stable_sort(groupVec[g].begin(),groupVec[g].end(),HypScoreGreater());
+    std::vector<std::pair<PositionIndex,PositionIndex> > spanVec;
+    this->smtm_ptr->getSpansForExpansion(groupVec[g][0],spanVec);
+    for(unsigned int k=0;k<spanVec.size();++k)
+    {
+      Cube cube;
+      cube.groupIdx=g;
+      cube.srcLeft=spanVec[k].first;
+      cube.srcRight=spanVec[k].second;
+      cube.hypDataVecs.resize(groupVec[g].size());
+      cube.hypDataReady.resize(groupVec[g].size(),false);
+      cubeVec.push_back(cube);
+    }
+  }
+  if(this->verbosity>1)
+    std::cerr<<"  Coverage groups: "<<groupVec.size()<<" ; cubes: "<<cubeVec.size()<<std::endl;
+
+      // Initialize priority queue with the best item of each cube
+  std::priority_queue<CubeItem,std::vector<CubeItem>,CubeItemLess> cubeItemQueue;
+  std::set<std::pair<unsigned int,std::pair<unsigned int,unsigned int> > > visited;
+  for(unsigned int c=0;c<cubeVec.size();++c)
+  {
+    CubeItem cubeItem;
+    visited.insert(std::make_pair(c,std::make_pair(0,0)));
+    if(getCubeItem(groupVec,cubeVec,c,0,0,cubeItem))
+      cubeItemQueue.push(cubeItem);
+  }
+
+      // Pop items in best-first order
+  unsigned int stackLimit=(popLimit==0)? this->S : popLimit;
+  std::map<EqClassType,unsigned int> popCountMap;
+  unsigned int numPops=0;
+  while(!cubeItemQueue.empty())
+  {
+    CubeItem cubeItem=cubeItemQueue.top();
+    cubeItemQueue.pop();
+
+        // Check pop limit of the stack where the item is to be
+        // inserted
+    unsigned int& popCount=popCountMap[cubeItem.extHyp.getEqClass()];
+    if(popCount>=stackLimit)
+      continue;
+
+    const Cube& cube=cubeVec[cubeItem.cubeIdx];
+    if(cubeItem.valid)
+    {
+          // Push expanded hyp into the stack container
+      bool inserted=this->pushGivenPredHyp(groupVec[cube.groupIdx][cubeItem.hypIdx],cubeItem.scrComps,cubeItem.extHyp);
+      ++popCount;
+      ++numPops;
+      if(this->verbosity>2)
+      {
+        std::cerr<<"  Expanded hypothesis "<<numPops<<" : ";
+        this->smtm_ptr->printHyp(cubeItem.extHyp,std::cerr);
+        std::cerr<<"  (Inserted: "<<inserted<<")"<<std::endl;
+      }
+    }
+
+        // Add neighbours of the item
+    std::pair<unsigned int,unsigned int> neighbours[2]={std::make_pair(cubeItem.hypIdx+1,cubeItem.optIdx),
+                                                        std::make_pair(cubeItem.hypIdx,cubeItem.optIdx+1)};
+    for(unsigned int n=0;n<2;++n)
+    {
+      if(visited.insert(std::make_pair(cubeItem.cubeIdx,neighbours[n])).second)
+      {
+        CubeItem neighbourItem;
+        if(getCubeItem(groupVec,cubeVec,cubeItem.cubeIdx,neighbours[n].first,neighbours[n].second,neighbourItem))
+          cubeItemQueue.push(neighbourItem);
+      }
+    }
+  }
+  if(this->verbosity>1)
+    std::cerr<<"  Generated "<<numPops<<" expansions"<<std::endl;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+bool cube_pruning_decoder_rec<SMT_MODEL>::getCubeItem(std::vector<std::vector<Hypothesis> >& groupVec,
+                                                      std::vector<Cube>& cubeVec,
+                                                      unsigned int cubeIdx,
+                                                      unsigned int hypIdx,
+                                                      unsigned int optIdx,
+                                                      CubeItem& cubeItem)
+{
+  Cube& cube=cubeVec[cubeIdx];
+  if(hypIdx>=cube.hypDataVecs.size())
+    return false;
+
+      // Obtain translation options for the hypothesis if necessary
+  const Hypothesis& hyp=groupVec[cube.groupIdx][hypIdx];
+  if(!cube.hypDataReady[hypIdx])
+  {
+    this->smtm_ptr->getHypDataVecForSpan(hyp,cube.srcLeft,cube.srcRight,cube.hypDataVecs[hypIdx]);
+    cube.hypDataReady[hypIdx]=true;
+  }
+  if(optIdx>=cube.hypDataVecs[hypIdx].size())
+    return false;
+
+      // Score item
+  cubeItem.cubeIdx=cubeIdx;
+  cubeItem.hypIdx=hypIdx;
+  cubeItem.optIdx=optIdx;
+  cubeItem.valid=this->smtm_ptr->expandGivenHypData(hyp,cube.hypDataVecs[hypIdx][optIdx],cubeItem.extHyp,cubeItem.scrComps);
+  if((double)cubeItem.extHyp.getScore()<-FLT_MAX)
+  {
+        // Extensions with infinite cost are not inserted into the
+        // stacks
+    cubeItem.valid=false;
+    cubeItem.priority=cubeItem.extHyp.getScore();
+  }
+  else
+  {
+        // The priority of the item includes the heuristic score
+    Hypothesis auxHyp=cubeItem.extHyp;
+    this->smtm_ptr->addHeuristicToHyp(auxHyp);
+    cubeItem.priority=auxHyp.getScore();
+  }
+  return true;
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+cube_pruning_decoder_rec<SMT_MODEL>::~cube_pruning_decoder_rec()
+{
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: cube_pruning_decoder_rec__pbtm_factory                   */
+/*                                                                  */
+/* Definitions file: cube_pruning_decoder_rec__pbtm_factory.cc      */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "PhrHypNumcovJumps01EqClassF.h"
+#include "PbTransModel.h"
+#include "cube_pruning_decoder_rec.h"
+#include <string>
+#include <stdlib.h>
+
+//--------------- Function definitions
+
+extern "C" BaseStackDecoder<PbTransModel<PhrHypNumcovJumps01EqClassF> >* create(std::string str)
+{
+  cube_pruning_decoder_rec<PbTransModel<PhrHypNumcovJumps01EqClassF> >* decPtr=new cube_pruning_decoder_rec<PbTransModel<PhrHypNumcovJumps01EqClassF> >;
+
+      // The initialization string, if given, contains the pop limit
+  if(!str.empty())
+    decPtr->set_pop_limit(atoi(str.c_str()));
+  
+  return decPtr;
+}
+
+//---------------
+extern "C" std::string type_id(void)
+{
+  return "cube_pruning_decoder_rec<PbTransModel>";
+}
@@ -50,6 +50,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Function Declarations ------------------------------
 
 void process_request(const thot_client_pars& tdcPars);
+void readSentBatch(std::string fileName,
+                   std::vector<std::string>& sentVec);
 int TakeParameters(int argc,
                    char *argv[],
                    thot_client_pars& tdcPars);
@@ -94,6 +96,7 @@ void process_request(const thot_client_pars& tdcPars)
   std::vector<std::string> v;
   std::string translatedSentence;
   std::string bestHypInfo;
+  std::vector<std::string> sentVec;
   ThotDecoderClient thotDecoderClient;
   double elapsed_ant,elapsed,ucpu,scpu;
   double connection_latency,request_latency;
@@ -140,6 +143,14 @@ void process_request(const thot_client_pars& tdcPars)
       std::cout<<bestHypInfo<<std::endl;
       std::cout<<translatedSentence<<std::endl;
       break;
+    case TRANSLATE_BATCH: readSentBatch(tdcPars.batchFileName,sentVec);
+      thotDecoderClient.sendSentBatchToTranslate(tdcPars.user_id,sentVec);
+      for(unsigned int i=0;i<sentVec.size();++i)
+      {
+        thotDecoderClient.recvBatchTranslation(translatedSentence,bestHypInfo);
+        std::cout<<translatedSentence<<std::endl;
+      }
+      break;
     case VERIFY_COV: thotDecoderClient.sendSentPairVerCov(tdcPars.user_id,tdcPars.stlStringSrc.c_str(),tdcPars.stlStringRef.c_str(),translatedSentence);
       std::cout<<translatedSentence<<std::endl;
       break;
@@ -153,6 +164,12 @@ void process_request(const thot_client_pars& tdcPars)
       break;
     case PRINT_MODELS: thotDecoderClient.sendPrintRequest(tdcPars.user_id);
       break;
+    case GET_PROF_STATS: thotDecoderClient.getProfStats(tdcPars.user_id,translatedSentence);
+      std::cout<<translatedSentence<<std::endl;
+      break;
+    case GET_OL_TRAIN_STATS: thotDecoderClient.getOnlineTrainingStats(tdcPars.user_id,translatedSentence);
+      std::cout<<translatedSentence<<std::endl;
+      break;
     case END_SERVER: thotDecoderClient.sendEndServerRequest(tdcPars.user_id);
       break;
     default:
@@ -170,6 +187,20 @@ void process_request(const thot_client_pars& tdcPars)
       //                                   dispatch one request per client execution)
 }
 
+//---------------
+void readSentBatch(std::string fileName,
+                   std::vector<std::string>& sentVec)
+{
+  std::ifstream fin(fileName.c_str());
+  if(!fin)
+    throw std::runtime_error("Error while reading file with sentences to translate");
+
+  std::string line;
+  sentVec.clear();
+  while(std::getline(fin,line))
+    sentVec.push_back(line);
+}
+
 //---------------
 int TakeParameters(int argc,
                    char *argv[],
@@ -257,6 +288,14 @@ int TakeParameters(int argc,
    return THOT_OK;
  }
 
+     /* Take the file with the sentences to be translated */
+ err=readSTLstring(argc,argv, "-tb", &tdcPars.batchFileName);
+ if(err==0)
+ {
+   tdcPars.server_request_code=TRANSLATE_BATCH;
+   return THOT_OK;
+ }
+
      /* Take the sentence pair for coverage verifying */
  err=readTwoSTLstrings(argc,argv, "-c", &tdcPars.stlStringSrc,&tdcPars.stlStringRef);
  if(err==0)
@@ -298,6 +337,22 @@ int TakeParameters(int argc,
    return THOT_OK;
  }
 
+     /* Verify -ps option */
+ err=readOption(argc,argv, "-ps");
+ if(err==0)
+ {
+   tdcPars.server_request_code=GET_PROF_STATS;
+   return THOT_OK;
+ }
+
+     /* Verify -ts option */
+ err=readOption(argc,argv, "-ts");
+ if(err==0)
+ {
+   tdcPars.server_request_code=GET_OL_TRAIN_STATS;
+   return THOT_OK;
+ }
+
      /* Verify -e option */
  err=readOption(argc,argv, "-e");
  if(err==0)
@@ -324,9 +379,10 @@ void printUsage(void)
   std::cerr<<"                             { -tr <srcstring> <refstring> | \n";
   // std::cerr<<"                          | -tre <srcstring> <refstring> | \n";
   std::cerr<<"                             | -t <string> | -th <string> |\n";
+  std::cerr<<"                             | -tb <string> |\n";
   std::cerr<<"                             | -c <srcstring> <refstring> |\n";
   std::cerr<<"                             | -sc <string> | -ap <string> | -rp |\n";
-  std::cerr<<"                             | -o <string> | -e } [ -v ]\n";
+  std::cerr<<"                             | -o <string> | -ps | -ts | -e } [ -v ]\n";
   std::cerr<<"                             [--help] [--version]\n\n";
   std::cerr<<"-i <string>                  Set IP address of the server.\n";
   std::cerr<<"-p <int>                     Server port.\n";
@@ -336,12 +392,18 @@ void printUsage(void)
   std::cerr<<"-t <string>                  Translate sentence.\n";
   std::cerr<<"-th <string>                 Translate sentence (returns hypothesis\n";
   std::cerr<<"                             information).\n";
+  std::cerr<<"-tb <string>                 Translate the sentences contained in the given\n";
+  std::cerr<<"                             file using a single request.\n";
   std::cerr<<"-c <srcstring> <refstring>   Verify model coverage for reference sentence.\n";
   std::cerr<<"-sc <string>                 Start CAT system for the given sentence, using\n";
   std::cerr<<"                             the null string as prefix.\n";
   std::cerr<<"-ap <string>                 Add string to prefix.\n";
   std::cerr<<"-rp <string>                 Reset prefix.\n";
   std::cerr<<"-pr                          Print models.\n";
+  std::cerr<<"-ps                          Print the profiling data of the server in JSON\n";
+  std::cerr<<"                             format.\n";
+  std::cerr<<"-ts                          Print the statistics of the online training\n";
+  std::cerr<<"                             queue of the server in JSON format.\n";
   std::cerr<<"-e                           End server.\n";
   std::cerr<<"-v                           Verbose mode.\n";
   std::cerr<<"--help                       Display this help and exit.\n";
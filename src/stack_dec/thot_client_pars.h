@@ -41,6 +41,7 @@ struct thot_client_pars
   std::string stlStringSrc;
   std::string stlStringRef;
   std::string sentenceToTranslate;
+  std::string batchFileName;
   std::string strToAddToPref;
   std::string serverIP;
   std::vector<float> floatVec;
@@ -0,0 +1,340 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: thot_ll_weight_tune.cc                                   */
+/*                                                                  */
+/* Definitions file: thot_ll_weight_tune.cc                         */
+/*                                                                  */
+/* Description: Tunes the log-linear weights of a translation       */
+/*              system keeping its models loaded.                   */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file thot_ll_weight_tune.cc
+ *
+ * @brief Tunes the log-linear weights of a translation system keeping
+ * its models loaded.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ThotDecoder.h"
+#include "awkInputStream.h"
+#include "ErrorDefs.h"
+#include "options.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+
+//--------------- Constants ------------------------------------------
+
+#define TUNING_USER_ID 0
+
+struct thot_llwt_pars
+{
+  std::string cfgFile;
+  std::string fileWithSrcSents;
+  std::string fileWithReferences;
+  std::vector<std::string> includeVarStr;
+  LlWeightTuningPars tuningPars;
+  bool v_given;
+};
+
+//--------------- Function Declarations ------------------------------
+
+int handleParameters(int argc,
+                     char *argv[],
+                     thot_llwt_pars& pars);
+int takeParameters(int argc,
+                   char *argv[],
+                   thot_llwt_pars& pars);
+int checkParameters(thot_llwt_pars& pars);
+int read_sentences(std::string fileName,
+                   std::vector<std::string>& sentVec);
+int tune_ll_weights(const thot_llwt_pars& pars);
+void printUsage(void);
+void version(void);
+
+//--------------- Function Definitions -------------------------------
+
+//--------------------------------
+int main(int argc,char *argv[])
+{
+  thot_llwt_pars pars;
+  
+  if(handleParameters(argc,argv,pars)==THOT_ERROR)
+  {
+    return THOT_ERROR;
+  }
+  else
+  {
+        // Print parameters
+    std::cerr<<"-c option is "<<pars.cfgFile<<std::endl;
+    std::cerr<<"-t option is "<<pars.fileWithSrcSents<<std::endl;
+    std::cerr<<"-r option is "<<pars.fileWithReferences<<std::endl;
+    std::cerr<<"-va option is";
+    for(unsigned int i=0;i<pars.tuningPars.includeVarBool.size();++i)
+      std::cerr<<" "<<pars.tuningPars.includeVarBool[i];
+    std::cerr<<std::endl;
+    std::cerr<<"-n option is "<<pars.tuningPars.nbestSize<<std::endl;
+    std::cerr<<"-i option is "<<pars.tuningPars.maxIters<<std::endl;
+    std::cerr<<"-tr option is "<<pars.tuningPars.trustRadius<<std::endl;
+    std::cerr<<"-nt option is "<<pars.tuningPars.numWorkers<<std::endl;
+    std::cerr<<"-lat option is "<<pars.tuningPars.latticeMert<<std::endl;
+    
+    return tune_ll_weights(pars);
+  }
+}
+
+//--------------------------------
+int handleParameters(int argc,
+                     char *argv[],
+                     thot_llwt_pars& pars)
+{
+  if(argc==1 || readOption(argc,argv,"--version")!=-1)
+  {
+    version();
+    return THOT_ERROR;
+  }
+  if(readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;   
+  }
+  if(takeParameters(argc,argv,pars)==THOT_ERROR)
+  {
+    return THOT_ERROR;
+  }
+  else
+  {
+    if(checkParameters(pars)==THOT_OK)
+    {
+      return THOT_OK;
+    }
+    else
+    {
+      return THOT_ERROR;
+    }
+  }
+}
+
+//--------------------------------
+int takeParameters(int argc,
+                   char *argv[],
+                   thot_llwt_pars& pars)
+{
+      // Take -c parameter
+  readSTLstring(argc,argv, "-c", &pars.cfgFile);
+
+      // Take -t parameter
+  readSTLstring(argc,argv, "-t", &pars.fileWithSrcSents);
+
+      // Take -r parameter
+  readSTLstring(argc,argv, "-r", &pars.fileWithReferences);
+
+      // Obtain included variables
+  readStringSeq(argc,argv, "-va", pars.includeVarStr);
+  for(unsigned int i=0;i<pars.includeVarStr.size();++i)
+  {
+    pars.tuningPars.includeVarBool.push_back(atoi(pars.includeVarStr[i].c_str()));
+  }
+
+      // Take -n parameter
+  readUnsignedInt(argc,argv, "-n", &pars.tuningPars.nbestSize);
+
+      // Take -i parameter
+  readUnsignedInt(argc,argv, "-i", &pars.tuningPars.maxIters);
+
+      // Take -tr parameter
+  readFloat(argc,argv, "-tr", &pars.tuningPars.trustRadius);
+
+      // Take -nt parameter
+  readUnsignedInt(argc,argv, "-nt", &pars.tuningPars.numWorkers);
+
+      // Take -lat parameter
+  pars.tuningPars.latticeMert=(readOption(argc,argv,"-lat")!=-1);
+
+      // Take -v parameter
+  pars.v_given=(readOption(argc,argv,"-v")!=-1);
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int checkParameters(thot_llwt_pars& pars)
+{  
+  if(pars.cfgFile.empty())
+  {
+    std::cerr<<"Error: parameter -c not given!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  if(pars.fileWithSrcSents.empty())
+  {
+    std::cerr<<"Error: parameter -t not given!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  if(pars.fileWithReferences.empty())
+  {
+    std::cerr<<"Error: parameter -r not given!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  if(pars.tuningPars.nbestSize==0)
+  {
+    std::cerr<<"Error: the value of -n parameter should be greater than zero!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  if(pars.tuningPars.maxIters==0)
+  {
+    std::cerr<<"Error: the value of -i parameter should be greater than zero!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  if(pars.tuningPars.trustRadius<0)
+  {
+    std::cerr<<"Error: the value of -tr parameter should not be negative!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int read_sentences(std::string fileName,
+                   std::vector<std::string>& sentVec)
+{
+      // Clear output variable
+  sentVec.clear();
+
+      // Fill output variable
+  awkInputStream awk;
+  if(awk.open(fileName.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }  
+  while(awk.getln())
+  {
+    sentVec.push_back(awk.dollar(0));
+  }
+  return THOT_OK;
+}
+
+//--------------------------------
+int tune_ll_weights(const thot_llwt_pars& pars)
+{
+      // Read development corpus
+  std::vector<std::string> srcSentVec;
+  if(read_sentences(pars.fileWithSrcSents,srcSentVec)==THOT_ERROR)
+    return THOT_ERROR;
+  std::vector<std::string> refSentVec;
+  if(read_sentences(pars.fileWithReferences,refSentVec)==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Load models
+  ThotDecoder thotDecoder;
+  ThotDecoderUserPars tdup;
+  int ret=thotDecoder.initUsingCfgFile(pars.cfgFile,tdup,pars.v_given);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+  ret=thotDecoder.initUserPars(TUNING_USER_ID,tdup,pars.v_given);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Tune weights
+  std::vector<float> bestWeights;
+  double bestQuality;
+  ret=thotDecoder.tuneLogLinearWeights(TUNING_USER_ID,
+                                       srcSentVec,
+                                       refSentVec,
+                                       pars.tuningPars,
+                                       bestWeights,
+                                       bestQuality,
+                                       1);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Print result
+  std::vector<std::pair<std::string,float> > compWeights;
+  thotDecoder.getLogLinearWeights(compWeights);
+  std::cerr<<"* Best weights:";
+  for(unsigned int i=0;i<compWeights.size();++i)
+  {
+    std::cerr<<" "<<compWeights[i].first<<": "<<compWeights[i].second;
+    if(i!=compWeights.size()-1)
+      std::cerr<<" ,";
+  }
+  std::cerr<<std::endl;
+  for(unsigned int i=0;i<bestWeights.size();++i)
+  {
+    std::cout<<bestWeights[i];
+    if(i!=bestWeights.size()-1)
+      std::cout<<" ";
+  }
+  std::cout<<std::endl;
+  
+  return THOT_OK;
+}
+
+//--------------------------------
+void printUsage(void)
+{
+  std::cerr<<"thot_ll_weight_tune -c <string> -t <string> -r <string>"<<std::endl;
+  std::cerr<<"                    [-va <bool> ... <bool>] [-n <int>] [-i <int>]"<<std::endl;
+  std::cerr<<"                    [-tr <float>] [-nt <int>] [-lat] [-v]"<<std::endl;
+  std::cerr<<"                    [--help] [--version]"<<std::endl;
+  std::cerr<<std::endl;
+  std::cerr<<"-c <string>              Configuration file."<<std::endl;
+  std::cerr<<"-t <string>              File with source sentences."<<std::endl;
+  std::cerr<<"-r <string>              File with reference sentences."<<std::endl;
+  std::cerr<<"-va <bool>...<bool>      Set variable values to be excluded or included."<<std::endl;
+  std::cerr<<"                         Each value equal to 0 excludes the variable and values"<<std::endl;
+  std::cerr<<"                         equal to 1 include the variable."<<std::endl;
+  std::cerr<<"-n <int>                 Size of the n-best lists ("<<LLWT_DEFAULT_NBEST_SIZE<<" by default)."<<std::endl;
+  std::cerr<<"-i <int>                 Maximum number of iterations ("<<LLWT_DEFAULT_MAX_ITERS<<" by default)."<<std::endl;
+  std::cerr<<"-tr <float>              Trust region radius, the sentences are not translated"<<std::endl;
+  std::cerr<<"                         again if the relative distance between the new"<<std::endl;
+  std::cerr<<"                         weights and those used in the last translation does"<<std::endl;
+  std::cerr<<"                         not exceed it ("<<LLWT_DEFAULT_TRUST_RADIUS<<" by default)."<<std::endl;
+  std::cerr<<"-nt <int>                Number of translation threads (1 by default)."<<std::endl;
+  std::cerr<<"-lat                     Tune weights by means of lattice MERT over the word"<<std::endl;
+  std::cerr<<"                         graphs of the sentences instead of using n-best lists."<<std::endl;
+  std::cerr<<"                         Translation quality is then measured as the BLEU of"<<std::endl;
+  std::cerr<<"                         the preprocessed translations."<<std::endl;
+  std::cerr<<"-v                       Verbose mode."<<std::endl;
+  std::cerr<<"--help                   Display this help and exit."<<std::endl;
+  std::cerr<<"--version                Output version information and exit."<<std::endl;
+}
+
+//--------------------------------
+void version(void)
+{
+  std::cerr<<"thot_ll_weight_tune is part of the thot package"<<std::endl;
+  std::cerr<<"thot version "<<THOT_VERSION<<std::endl;
+  std::cerr<<"thot is GNU software written by Daniel Ortiz"<<std::endl;
+}
@@ -50,11 +50,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "BaseLogLinWeightUpdater.h"
 #include "ModelDescriptorUtils.h"
 #include "DynClassFactoryHandler.h"
+#include "ThreadPool.h"
 #include "ctimer.h"
 #include "options.h"
 #include "ErrorDefs.h"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <stdlib.h>
 #include <vector>
 #include <string>
@@ -77,6 +79,11 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define PALIG_G_DEFAULT 0
 #define PALIG_H_DEFAULT NO_HEURISTIC
 #define PALIG_NOMON_DEFAULT 0
+#define PALIG_NT_DEFAULT    1
+
+    // Number of sentence pairs read from the input files before
+    // distributing them among the alignment threads
+#define PALIG_CHUNK_SIZE    256
 
 //--------------- Type definitions -----------------------------------
 
@@ -86,7 +93,7 @@ struct thot_ms_alig_pars
   bool cov_option;
   bool be;
   float W;
-  int A,E,nomon,S,I,G,heuristic,verbosity;
+  int A,E,nomon,S,I,G,nt,heuristic,verbosity;
   std::string sourceSentencesFile;
   std::string refSentencesFile;
   std::string languageModelFileName;
@@ -106,6 +113,7 @@ struct thot_ms_alig_pars
       nomon=PALIG_NOMON_DEFAULT;
       I=PALIG_I_DEFAULT;
       G=PALIG_G_DEFAULT;
+      nt=PALIG_NT_DEFAULT;
       heuristic=PALIG_H_DEFAULT;
       be=0;
       wgPruningThreshold=DISABLE_WORDGRAPH;
@@ -114,6 +122,31 @@ struct thot_ms_alig_pars
     }
 };
 
+struct AligWorker
+{
+      // Decoder and model used by each alignment thread, the models
+      // of the workers other than the first one are clones of the main
+      // one
+  BasePbTransModel<SmtModel::Hypothesis>* smtModelPtr;
+  BaseTranslationConstraints* trConstraintsPtr;
+  BaseStackDecoder<SmtModel>* stackDecoderPtr;
+  _stackDecoderRec<SmtModel>* stackDecoderRecPtr;
+};
+
+struct AligChunkData
+{
+  const thot_ms_alig_pars* tapPtr;
+  unsigned int firstSentNo;
+  std::vector<std::string> srcSentVec;
+  std::vector<std::string> refSentVec;
+  std::vector<std::string> outputVec;
+  std::vector<std::string> verboseOutputVec;
+  std::vector<bool> doneVec;
+  unsigned int nextOutput;
+  double totalTime;
+  pthread_mutex_t output_mut;
+};
+
 //--------------- Function Declarations ------------------------------
 
 int init_translator_legacy_impl(const thot_ms_alig_pars& tap);
@@ -125,13 +158,23 @@ int init_translator(const thot_ms_alig_pars& tap);
 void release_translator_legacy_impl(void);
 void release_translator_feat_impl(void);
 void release_translator(void);
+void set_decoder_pars(BaseStackDecoder<SmtModel>* decoderPtr,
+                      _stackDecoderRec<SmtModel>* decoderRecPtr,
+                      const thot_ms_alig_pars& tap);
+int init_alig_workers(const thot_ms_alig_pars& tap);
+void release_alig_workers(void);
 int align_corpus(const thot_ms_alig_pars& tap);
+void align_sent_pair_task(void* taskData,
+                          unsigned int taskIdx,
+                          unsigned int workerIdx);
 std::vector<std::string> stringToStringVector(std::string s);
 void version(void);
 void print_alig_a3_final(std::string srcstr,
                          std::string trgstr,
                          SmtModel::Hypothesis hyp,
                          unsigned int sentNo,
+                         BasePbTransModel<SmtModel::Hypothesis>* modelPtr,
+                         std::ostream& outS,
                          const thot_ms_alig_pars& tap);
 int handleParameters(int argc,
                      char *argv[],
@@ -160,6 +203,10 @@ BasePbTransModel<SmtModel::Hypothesis>* smtModelPtr;
 BaseStackDecoder<SmtModel>* stackDecoderPtr;
 _stackDecoderRec<SmtModel>* stackDecoderRecPtr;
 
+    // Variables related to parallel alignment
+std::vector<AligWorker> aligWorkerVec;
+ThreadPool threadPool;
+
     // Variables related to feature-based implementation
 FeatureHandler featureHandler;
 bool featureBasedImplEnabled;
@@ -187,7 +234,10 @@ int main(int argc, char *argv[])
     {
       unsigned int ret;
 
-      ret=align_corpus(tap);
+      ret=init_alig_workers(tap);
+      if(ret==THOT_OK)
+        ret=align_corpus(tap);
+      release_alig_workers();
       release_translator();
       if(ret==THOT_ERROR) return THOT_ERROR;
       else return THOT_OK;
@@ -385,29 +435,7 @@ int init_translator_legacy_impl(const thot_ms_alig_pars& tap)
   }
   
       // Set translator parameters
-  stackDecoderPtr->set_S_par(tap.S);
-  stackDecoderPtr->set_I_par(tap.I);
-  stackDecoderPtr->set_G_par(tap.G);
-
-      // Enable best score pruning if the decoder is not going to obtain
-      // n-best translations or word-graphs
-  if(tap.wgPruningThreshold==DISABLE_WORDGRAPH)
-    stackDecoderPtr->useBestScorePruning(true);
-
-      // Set breadthFirst flag
-  stackDecoderPtr->set_breadthFirst(!tap.be);
-
-  if(stackDecoderRecPtr)
-  {
-        // Enable word graph according to wgPruningThreshold
-    if(tap.wordGraphFileName!="")
-    {
-      if(tap.wgPruningThreshold!=DISABLE_WORDGRAPH)
-        stackDecoderRecPtr->enableWordGraph();
-    }
-  }
-      // Set translator verbosity
-  stackDecoderPtr->setVerbosity(tap.verbosity);
+  set_decoder_pars(stackDecoderPtr,stackDecoderRecPtr,tap);
 
   return THOT_OK;
 }
@@ -530,31 +558,116 @@ int init_translator_feat_impl(const thot_ms_alig_pars& tap)
   }
 
       // Set translator parameters
-  stackDecoderPtr->set_S_par(tap.S);
-  stackDecoderPtr->set_I_par(tap.I);
-  stackDecoderPtr->set_G_par(tap.G);
+  set_decoder_pars(stackDecoderPtr,stackDecoderRecPtr,tap);
+  
+  return THOT_OK;
+}
+
+//---------------
+void set_decoder_pars(BaseStackDecoder<SmtModel>* decoderPtr,
+                      _stackDecoderRec<SmtModel>* decoderRecPtr,
+                      const thot_ms_alig_pars& tap)
+{
+  decoderPtr->set_S_par(tap.S);
+  decoderPtr->set_I_par(tap.I);
+  decoderPtr->set_G_par(tap.G);
 
       // Enable best score pruning if the decoder is not going to obtain
       // n-best translations or word-graphs
   if(tap.wgPruningThreshold==DISABLE_WORDGRAPH)
-    stackDecoderPtr->useBestScorePruning(true);
+    decoderPtr->useBestScorePruning(true);
 
       // Set breadthFirst flag
-  stackDecoderPtr->set_breadthFirst(!tap.be);
+  decoderPtr->set_breadthFirst(!tap.be);
 
-  if(stackDecoderRecPtr)
+  if(decoderRecPtr)
   {
         // Enable word graph according to wgPruningThreshold
     if(tap.wordGraphFileName!="")
     {
       if(tap.wgPruningThreshold!=DISABLE_WORDGRAPH)
-        stackDecoderRecPtr->enableWordGraph();
+        decoderRecPtr->enableWordGraph();
     }
   }
       // Set translator verbosity
-  stackDecoderPtr->setVerbosity(tap.verbosity);
-  
-  return THOT_OK;
+  decoderPtr->setVerbosity(tap.verbosity);
+}
+
+//---------------
+int init_alig_workers(const thot_ms_alig_pars& tap)
+{
+      // The first worker uses the main decoder and model
+  AligWorker aligWorker;
+  aligWorker.smtModelPtr=smtModelPtr;
+  aligWorker.trConstraintsPtr=trConstraintsPtr;
+  aligWorker.stackDecoderPtr=stackDecoderPtr;
+  aligWorker.stackDecoderRecPtr=stackDecoderRecPtr;
+  aligWorkerVec.push_back(aligWorker);
+
+      // The remaining workers use their own decoders and clones of the
+      // main model, which share the loaded models
+  for(int w=1;w<tap.nt;++w)
+  {
+    aligWorker.smtModelPtr=NULL;
+    aligWorker.trConstraintsPtr=NULL;
+    aligWorker.stackDecoderPtr=NULL;
+    aligWorker.stackDecoderRecPtr=NULL;
+    aligWorkerVec.push_back(aligWorker);
+    AligWorker& newWorker=aligWorkerVec.back();
+
+    newWorker.stackDecoderPtr=dynClassFactoryHandler.baseStackDecoderDynClassLoader.make_obj(dynClassFactoryHandler.baseStackDecoderInitPars);
+    if(newWorker.stackDecoderPtr==NULL)
+    {
+      std::cerr<<"Error: BaseStackDecoder pointer could not be instantiated"<<std::endl;
+      return THOT_ERROR;
+    }
+    newWorker.stackDecoderRecPtr=dynamic_cast<_stackDecoderRec<SmtModel>*>(newWorker.stackDecoderPtr);
+
+    newWorker.smtModelPtr=dynamic_cast<BasePbTransModel<SmtModel::Hypothesis>* >(smtModelPtr->clone());
+    if(newWorker.smtModelPtr==NULL)
+    {
+      std::cerr<<"Error: smt model could not be cloned"<<std::endl;
+      return THOT_ERROR;
+    }
+
+    newWorker.trConstraintsPtr=dynClassFactoryHandler.baseTranslationConstraintsDynClassLoader.make_obj(dynClassFactoryHandler.baseTranslationConstraintsInitPars);
+    if(newWorker.trConstraintsPtr==NULL)
+    {
+      std::cerr<<"Error: BaseTranslationConstraints pointer could not be instantiated"<<std::endl;
+      return THOT_ERROR;
+    }
+    newWorker.smtModelPtr->link_trans_constraints(newWorker.trConstraintsPtr);
+
+    int ret=newWorker.stackDecoderPtr->link_smt_model(newWorker.smtModelPtr);
+    if(ret==THOT_ERROR)
+    {
+      std::cerr<<"Error while linking smt model to decoder, revise master.ini file"<<std::endl;
+      return THOT_ERROR;
+    }
+    set_decoder_pars(newWorker.stackDecoderPtr,newWorker.stackDecoderRecPtr,tap);
+  }
+
+      // Start alignment threads
+  if(aligWorkerVec.size()>1)
+    return threadPool.init(aligWorkerVec.size());
+  else
+    return THOT_OK;
+}
+
+//---------------
+void release_alig_workers(void)
+{
+  threadPool.release();
+
+      // The objects of the first worker are released by
+      // release_translator()
+  for(unsigned int w=1;w<aligWorkerVec.size();++w)
+  {
+    delete aligWorkerVec[w].stackDecoderPtr;
+    delete aligWorkerVec[w].smtModelPtr;
+    delete aligWorkerVec[w].trConstraintsPtr;
+  }
+  aligWorkerVec.clear();
 }
 
 //---------------
@@ -606,14 +719,12 @@ void release_translator_feat_impl(void)
 //---------------
 int align_corpus(const thot_ms_alig_pars& tap)
 {
-  SmtModel::Hypothesis result;     // Results of the translation
-  SmtModel::Hypothesis anotherTrans;     // Another results of the translation
-  int sentNo=0;    
-  double elapsed_ant,elapsed,ucpu,scpu,total_time=0;
+  unsigned int sentNo=0;
+  double total_time=0;
       
   std::ifstream testCorpusFile;                // Test corpus file stream
   std::ifstream refCorpusFile;                 // reference corpus file stream
-  std::string srcSentenceString,trgSentenceString,s;
+  std::string srcSentenceString,trgSentenceString;
   
 
       // Open test corpus file
@@ -643,86 +754,63 @@ int align_corpus(const thot_ms_alig_pars& tap)
   }
   else
   {
-        // Align corpus sentences
-    while(!testCorpusFile.eof())
+    AligChunkData chunkData;
+    chunkData.tapPtr=&tap;
+    pthread_mutex_init(&chunkData.output_mut,NULL);
+
+        // Align corpus sentences, the sentence pairs are read in chunks
+        // that are distributed among the alignment threads
+    bool endOfInput=false;
+    while(!endOfInput)
     {
-      getline(testCorpusFile,srcSentenceString);
-      getline(refCorpusFile,trgSentenceString);
-
-          // Discard last sentence pair if it is empty
-      if(srcSentenceString=="" && trgSentenceString=="" && testCorpusFile.eof())
-        break;
-
-      ++sentNo;
-        
-      if(tap.verbosity)
+      chunkData.firstSentNo=sentNo+1;
+      chunkData.srcSentVec.clear();
+      chunkData.refSentVec.clear();
+      while(chunkData.srcSentVec.size()<PALIG_CHUNK_SIZE)
       {
-        std::cerr<<sentNo<<std::endl<<srcSentenceString<<std::endl;
-        ctimer(&elapsed_ant,&ucpu,&scpu);
-      }
-       
-          //------- Align sentence
-      if(tap.p_option)
-      {
-            // Translate with prefix
-        result=stackDecoderPtr->translateWithPrefix(srcSentenceString,trgSentenceString);
-      }
-      else
-      {
-        if(tap.cov_option)
+        if(testCorpusFile.eof())
         {
-              // Verify model coverage
-          result=stackDecoderPtr->verifyCoverageForRef(srcSentenceString,trgSentenceString);
+          endOfInput=true;
+          break;
         }
-        else
+        getline(testCorpusFile,srcSentenceString);
+        getline(refCorpusFile,trgSentenceString);
+
+            // Discard last sentence pair if it is empty
+        if(srcSentenceString=="" && trgSentenceString=="" && testCorpusFile.eof())
         {
-              // Translate with reference
-          result=stackDecoderPtr->translateWithRef(srcSentenceString,trgSentenceString);
+          endOfInput=true;
+          break;
         }
-      }
-          //--------------------------
-      if(tap.verbosity) ctimer(&elapsed,&ucpu,&scpu);
-               
-      print_alig_a3_final(srcSentenceString,trgSentenceString,result,sentNo,tap);
-          
-      if(tap.verbosity)
-      {
-        smtModelPtr->printHyp(result,std::cerr,tap.verbosity);
-#         ifdef THOT_STATS
-        stackDecoderPtr->printStats();
-#         endif
 
-        std::cerr<<"- Elapsed Time: "<<elapsed-elapsed_ant<<std::endl<<std::endl;
-        total_time+=elapsed-elapsed_ant;
+        chunkData.srcSentVec.push_back(srcSentenceString);
+        chunkData.refSentVec.push_back(trgSentenceString);
+        ++sentNo;
       }
 
-      if(stackDecoderRecPtr)
+          // Align the sentence pairs of the chunk, their alignments
+          // are printed in input order
+      unsigned int chunkSize=chunkData.srcSentVec.size();
+      chunkData.outputVec.clear();
+      chunkData.outputVec.resize(chunkSize);
+      chunkData.verboseOutputVec.clear();
+      chunkData.verboseOutputVec.resize(chunkSize);
+      chunkData.doneVec.clear();
+      chunkData.doneVec.resize(chunkSize,false);
+      chunkData.nextOutput=0;
+      chunkData.totalTime=0;
+      if(aligWorkerVec.size()==1)
       {
-            // Print wordgraph if the -wg option was given
-        if(tap.wordGraphFileName!="")
-        {
-          char wgFileNameForSent[256];
-          sprintf(wgFileNameForSent,"%s_%06d",tap.wordGraphFileName.c_str(),sentNo);
-          stackDecoderRecPtr->pruneWordGraph(tap.wgPruningThreshold);
-          stackDecoderRecPtr->printWordGraph(wgFileNameForSent);
-        }
+        for(unsigned int i=0;i<chunkSize;++i)
+          align_sent_pair_task((void*)&chunkData,i,0);
       }
-      
-#ifdef THOT_ENABLE_GRAPH
-      char printGraphFileName[256];
-      ofstream outS;
-      sprintf(printGraphFileName,"sent%d.graph_file",sentNo);
-      outS.open(printGraphFileName,ios::out);
-      if(!outS) std::cerr<<"Error while printing search graph to file."<<std::endl;
       else
       {
-        stackDecoderPtr->printSearchGraphStream(outS);
-        outS<<"Stack ID. Out\n";
-        stackDecoderPtr->printGraphForHyp(result,outS);
-        outS.close();        
+        threadPool.run(align_sent_pair_task,(void*)&chunkData,chunkSize);
       }
-#endif        
+      total_time+=chunkData.totalTime;
     }
+    pthread_mutex_destroy(&chunkData.output_mut);
     testCorpusFile.close(); 
   }
 
@@ -734,23 +822,134 @@ int align_corpus(const thot_ms_alig_pars& tap)
   return THOT_OK;
 }
 
+//---------------
+void align_sent_pair_task(void* taskData,
+                          unsigned int taskIdx,
+                          unsigned int workerIdx)
+{
+  AligChunkData* chunkDataPtr=(AligChunkData*) taskData;
+  const thot_ms_alig_pars& tap=*chunkDataPtr->tapPtr;
+  AligWorker& aligWorker=aligWorkerVec[workerIdx];
+  const std::string& srcSentenceString=chunkDataPtr->srcSentVec[taskIdx];
+  const std::string& trgSentenceString=chunkDataPtr->refSentVec[taskIdx];
+  unsigned int sentNo=chunkDataPtr->firstSentNo+taskIdx;
+  SmtModel::Hypothesis result;     // Results of the translation
+  double elapsed_ant=0,elapsed=0,ucpu,scpu;
+
+      // Verbose information is printed together with the alignment so
+      // as not to mix the output of different threads
+  std::ostringstream verboseStream;
+  if(tap.verbosity)
+  {
+    verboseStream<<sentNo<<std::endl<<srcSentenceString<<std::endl;
+    ctimer(&elapsed_ant,&ucpu,&scpu);
+  }
+       
+      //------- Align sentence
+  if(tap.p_option)
+  {
+        // Translate with prefix
+    result=aligWorker.stackDecoderPtr->translateWithPrefix(srcSentenceString,trgSentenceString);
+  }
+  else
+  {
+    if(tap.cov_option)
+    {
+          // Verify model coverage
+      result=aligWorker.stackDecoderPtr->verifyCoverageForRef(srcSentenceString,trgSentenceString);
+    }
+    else
+    {
+          // Translate with reference
+      result=aligWorker.stackDecoderPtr->translateWithRef(srcSentenceString,trgSentenceString);
+    }
+  }
+      //--------------------------
+  if(tap.verbosity) ctimer(&elapsed,&ucpu,&scpu);
+
+  std::ostringstream outStream;
+  print_alig_a3_final(srcSentenceString,trgSentenceString,result,sentNo,aligWorker.smtModelPtr,outStream,tap);
+          
+  if(tap.verbosity)
+  {
+    aligWorker.smtModelPtr->printHyp(result,verboseStream,tap.verbosity);
+#     ifdef THOT_STATS
+    aligWorker.stackDecoderPtr->printStats();
+#     endif
+
+    verboseStream<<"- Elapsed Time: "<<elapsed-elapsed_ant<<std::endl<<std::endl;
+  }
+
+  if(aligWorker.stackDecoderRecPtr)
+  {
+        // Print wordgraph if the -wg option was given
+    if(tap.wordGraphFileName!="")
+    {
+      char wgFileNameForSent[256];
+      sprintf(wgFileNameForSent,"%s_%06d",tap.wordGraphFileName.c_str(),sentNo);
+      aligWorker.stackDecoderRecPtr->pruneWordGraph(tap.wgPruningThreshold);
+      aligWorker.stackDecoderRecPtr->printWordGraph(wgFileNameForSent);
+    }
+  }
+      
+#ifdef THOT_ENABLE_GRAPH
+  char printGraphFileName[256];
+  ofstream outS;
+  sprintf(printGraphFileName,"sent%d.graph_file",sentNo);
+  outS.open(printGraphFileName,ios::out);
+  if(!outS) std::cerr<<"Error while printing search graph to file."<<std::endl;
+  else
+  {
+    aligWorker.stackDecoderPtr->printSearchGraphStream(outS);
+    outS<<"Stack ID. Out\n";
+    aligWorker.stackDecoderPtr->printGraphForHyp(result,outS);
+    outS.close();        
+  }
+#endif        
+
+  pthread_mutex_lock(&chunkDataPtr->output_mut);
+  /////////// begin of mutex 
+
+      // Store results
+  chunkDataPtr->outputVec[taskIdx]=outStream.str();
+  chunkDataPtr->verboseOutputVec[taskIdx]=verboseStream.str();
+  chunkDataPtr->doneVec[taskIdx]=true;
+  chunkDataPtr->totalTime+=elapsed-elapsed_ant;
+
+      // Print the results that are ready in sentence order
+  while(chunkDataPtr->nextOutput<chunkDataPtr->doneVec.size() && chunkDataPtr->doneVec[chunkDataPtr->nextOutput])
+  {
+    unsigned int i=chunkDataPtr->nextOutput;
+    std::cerr<<chunkDataPtr->verboseOutputVec[i];
+    std::cout<<chunkDataPtr->outputVec[i];
+    chunkDataPtr->verboseOutputVec[i].clear();
+    chunkDataPtr->outputVec[i].clear();
+    ++chunkDataPtr->nextOutput;
+  }
+
+  /////////// end of mutex 
+  pthread_mutex_unlock(&chunkDataPtr->output_mut);
+}
+
 //---------------------------------------
 void print_alig_a3_final(std::string srcstr,
                          std::string trgstr,
                          SmtModel::Hypothesis hyp,
                          unsigned int sentNo,
+                         BasePbTransModel<SmtModel::Hypothesis>* modelPtr,
+                         std::ostream& outS,
                          const thot_ms_alig_pars& tap)
 {
   SmtModel::Hypothesis::DataType dataType;
   std::vector<std::string> sysTrgVec;
   std::vector<std::string> trgVec;
     
-  sysTrgVec=smtModelPtr->getTransInPlainTextVec(hyp);
+  sysTrgVec=modelPtr->getTransInPlainTextVec(hyp);
   trgVec=stringToStringVector(trgstr);
   dataType=hyp.getData();
-  std::cout<<"# "<<sentNo <<" ; Align. score= "<<hyp.getScore()<<std::endl;
-  std::cout<<srcstr<<std::endl;
-  std::cout<<"NULL ({ })";
+  outS<<"# "<<sentNo <<" ; Align. score= "<<hyp.getScore()<<std::endl;
+  outS<<srcstr<<std::endl;
+  outS<<"NULL ({ })";
   if(sysTrgVec!=trgVec && !tap.p_option)
   {
         // If the alignment is incomplete, align each target word with
@@ -758,11 +957,11 @@ void print_alig_a3_final(std::string srcstr,
     unsigned int srcsize=stringToStringVector(srcstr).size();
     for(unsigned int i=0;i<trgVec.size();++i)
     {
-      std::cout<<" "<<trgVec[i]<<" ({ ";
-      for(unsigned int j=1;j<=srcsize;++j) std::cout<<j<<" ";
-      std::cout<<"})";
+      outS<<" "<<trgVec[i]<<" ({ ";
+      for(unsigned int j=1;j<=srcsize;++j) outS<<j<<" ";
+      outS<<"})";
     }
-    std::cout<<std::endl;
+    outS<<std::endl;
   }
   else
   {
@@ -772,15 +971,15 @@ void print_alig_a3_final(std::string srcstr,
     {
       for(;i<=dataType.targetSegmentCuts[k];++i)
       {
-        std::cout<<" "<<sysTrgVec[i-1]<<" ({ ";
+        outS<<" "<<sysTrgVec[i-1]<<" ({ ";
         for(unsigned int j=dataType.sourceSegmentation[k].first;j<=dataType.sourceSegmentation[k].second;++j)
         {
-          std::cout<<j<<" ";
+          outS<<j<<" ";
         }
-        std::cout<<"})";
+        outS<<"})";
       }
     }
-    std::cout<<std::endl;
+    outS<<std::endl;
   }
 }
 
@@ -910,6 +1109,9 @@ void takeParametersGivenArgcArgv(int argc,
      // Take I parameter 
  err=readInt(argc,argv, "-G", &tap.G);
 
+     // Take nt parameter 
+ err=readInt(argc,argv, "-nt", &tap.nt);
+
      // Take h parameter 
  err=readInt(argc,argv, "-h", &tap.heuristic);
 
@@ -1010,6 +1212,12 @@ int checkParameters(const thot_ms_alig_pars& tap)
      return THOT_ERROR;
   }
 
+  if(tap.nt<1)
+  {
+     std::cerr<<"Error: the value of the -nt parameter must be greater than zero"<<std::endl;
+     return THOT_ERROR;
+  }
+
   return THOT_OK;
 }
 
@@ -1026,6 +1234,7 @@ void printParameters(const thot_ms_alig_pars& tap)
 #ifdef MULTI_STACK_USE_GRAN
  std::cerr<<"G: "<<tap.G<<std::endl;
 #endif
+ std::cerr<<"nt: "<<tap.nt<<std::endl;
  std::cerr<<"h: "<<tap.heuristic<<std::endl;
  std::cerr<<"be: "<<tap.be<<std::endl;
  std::cerr<<"nomon: "<<tap.nomon<<std::endl;
@@ -1082,7 +1291,8 @@ void printUsage(void)
   std::cerr << "               -t <string> -r <string>"<<std::endl;
   std::cerr << "               [-p|-cov] [-W <float>]"<<std::endl;
   std::cerr << "               [-S <int>] [-A <int>] [-E <int>] [-I <int>]"<<std::endl;
-  std::cerr << "               [-G <int>] [-h <int>] [-be] [-nomon <int>]"<<std::endl;
+  std::cerr << "               [-G <int>] [-nt <int>] [-h <int>] [-be]"<<std::endl;
+  std::cerr << "               [-nomon <int>]"<<std::endl;
   std::cerr << "               [-tmw <float> ... <float>]"<<std::endl;
   std::cerr << "               [-wg <string> [-wgp <float>] ]"<<std::endl;
   std::cerr << "               [-v|-v1|-v2] [--help] [--version]"<<std::endl<<std::endl;
@@ -1111,6 +1321,9 @@ void printUsage(void)
 #else
   std::cerr << " -G <int>              : Parameter not available with the given configuration."<<std::endl;
 #endif
+  std::cerr << " -nt <int>             : Number of threads used to align the sentence pairs,"<<std::endl;
+  std::cerr << "                         the models are loaded once and shared by all of them"<<std::endl;
+  std::cerr << "                         ("<<PALIG_NT_DEFAULT<<" by default)."<<std::endl;
   std::cerr << " -h <int>              : Heuristic function used: "<<NO_HEURISTIC<<"->None, "<<LOCAL_T_HEURISTIC<<"->LOCAL_T, "<<std::endl;
   std::cerr << "                         "<<LOCAL_TD_HEURISTIC<<"->LOCAL_TD ("<<PALIG_H_DEFAULT<<" by default)."<<std::endl;
   std::cerr << " -be                   : Execute a best-first algorithm (breadth-first search"<<std::endl;
@@ -51,11 +51,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "BaseLogLinWeightUpdater.h"
 #include "ModelDescriptorUtils.h"
 #include "DynClassFactoryHandler.h"
+#include "DecProfiler.h"
 #include "ctimer.h"
 #include "options.h"
 #include "ErrorDefs.h"
 #include <iostream>
 #include <iomanip>
+#include <fstream>
 #include <stdlib.h>
 #include <vector>
 #include <string>
@@ -84,12 +86,13 @@ struct thot_ms_dec_pars
 {
   bool be;
   float W;
-  int A,nomon,S,I,G,heuristic,verbosity;
+  int A,nomon,S,I,G,nt,heuristic,verbosity,profSampleRate;
   std::string sourceSentencesFile;
   std::string languageModelFileName;
   std::string transModelPref;
   std::string wordGraphFileName;
   std::string outFile;
+  std::string profFile;
   float wgPruningThreshold;
   std::vector<float> weightVec;
 
@@ -101,11 +104,13 @@ struct thot_ms_dec_pars
       nomon=PMSTACK_NOMON_DEFAULT;
       I=PMSTACK_I_DEFAULT;
       G=PMSTACK_G_DEFAULT;
+      nt=1;
       heuristic=PMSTACK_H_DEFAULT;
       be=0;
       wgPruningThreshold=DISABLE_WORDGRAPH;
       wgPruningThreshold=UNLIMITED_DENSITY;
       verbosity=0;
+      profSampleRate=1;
     }
 };
 
@@ -121,6 +126,9 @@ void release_translator_legacy_impl(void);
 void release_translator_feat_impl(void);
 void release_translator(void);
 int translate_corpus(const thot_ms_dec_pars& tdp);
+int print_prof_data(const thot_ms_dec_pars& tdp,
+                    DecProfStats& decProfStats,
+                    const std::vector<std::pair<int,DecProfData> >& sentProfDataVec);
 std::vector<std::string> stringToStringVector(std::string s);
 void version(void);
 int handleParameters(int argc,
@@ -376,6 +384,7 @@ int init_translator_legacy_impl(const thot_ms_dec_pars& tdp)
   stackDecoderPtr->set_S_par(tdp.S);
   stackDecoderPtr->set_I_par(tdp.I);
   stackDecoderPtr->set_G_par(tdp.G);
+  stackDecoderPtr->set_nt_par(tdp.nt);
 
       // Enable best score pruning if the decoder is not going to obtain
       // n-best translations or word-graphs
@@ -521,6 +530,7 @@ int init_translator_feat_impl(const thot_ms_dec_pars& tdp)
   stackDecoderPtr->set_S_par(tdp.S);
   stackDecoderPtr->set_I_par(tdp.I);
   stackDecoderPtr->set_G_par(tdp.G);
+  stackDecoderPtr->set_nt_par(tdp.nt);
 
       // Enable best score pruning if the decoder is not going to obtain
       // n-best translations or word-graphs
@@ -601,6 +611,8 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
       
   std::ifstream testCorpusFile;                // Test corpus file stream
   std::string srcSentenceString,s;
+  DecProfStats decProfStats;
+  std::vector<std::pair<int,DecProfData> > sentProfDataVec;
   
     
       // Open test corpus file
@@ -623,6 +635,10 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
       outS.open(tdp.outFile.c_str(),std::ios::out);
       if(!outS) std::cerr<<"Error while opening output file."<<std::endl;
     }
+
+        // Enable profiling if required
+    if(!tdp.profFile.empty())
+      decProfStats.setSampleRate(tdp.profSampleRate);
     
         // Translate corpus sentences
     while(!testCorpusFile.eof())
@@ -640,6 +656,10 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
         std::cerr<<sentNo<<std::endl<<srcSentenceString<<std::endl;
         ctimer(&elapsed_ant,&ucpu,&scpu);
       }
+
+          // Profile the translation of the sentence (including the
+          // generation of its word graph) if required
+      DecProfRequestScope profScope(&decProfStats);
        
           //------- Translate sentence
       result=stackDecoderPtr->translate(srcSentenceString);
@@ -647,10 +667,13 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
           //--------------------------
       if(tdp.verbosity) ctimer(&elapsed,&ucpu,&scpu);
 
-      if(tdp.outFile.empty())
-        std::cout<<smtModelPtr->getTransInPlainText(result)<<std::endl;
-      else
-        outS<<smtModelPtr->getTransInPlainText(result)<<std::endl;
+      {
+        DecProfPhaseTimer postprocTimer(DEC_PROF_POSTPROC);
+        if(tdp.outFile.empty())
+          std::cout<<smtModelPtr->getTransInPlainText(result)<<std::endl;
+        else
+          outS<<smtModelPtr->getTransInPlainText(result)<<std::endl;
+      }
           
       if(tdp.verbosity)
       {
@@ -675,6 +698,14 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
         }
       }
 
+          // Store profiling data of the sentence
+      if(profScope.end())
+      {
+        DecProfData profData;
+        decProfStats.getLastSample(profData);
+        sentProfDataVec.push_back(std::make_pair(sentNo,profData));
+      }
+
 #ifdef THOT_ENABLE_GRAPH
       char printGraphFileName[256];
       ofstream graphOutS;
@@ -705,6 +736,45 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
     std::cerr<<"- Time per sentence: "<<total_time/sentNo<<std::endl;
   }
 
+      // Print profiling data if required
+  if(!tdp.profFile.empty())
+    return print_prof_data(tdp,decProfStats,sentProfDataVec);
+
+  return THOT_OK;
+}
+
+//---------------
+int print_prof_data(const thot_ms_dec_pars& tdp,
+                    DecProfStats& decProfStats,
+                    const std::vector<std::pair<int,DecProfData> >& sentProfDataVec)
+{
+  std::ofstream profS(tdp.profFile.c_str(),std::ios::out);
+  if(!profS)
+  {
+    std::cerr<<"Error while opening file with profiling data."<<std::endl;
+    return THOT_ERROR;
+  }
+
+  profS<<"{"<<std::endl;
+  profS<<"  \"summary\": ";
+  decProfStats.printJson(profS);
+  profS<<","<<std::endl;
+  profS<<"  \"sentences\": [";
+  for(unsigned int i=0;i<sentProfDataVec.size();++i)
+  {
+    if(i>0) profS<<",";
+    profS<<std::endl<<"    {\"sentence\": "<<sentProfDataVec[i].first<<", \"data\": ";
+    sentProfDataVec[i].second.printJson(profS);
+    profS<<"}";
+  }
+  profS<<std::endl<<"  ]"<<std::endl;
+  profS<<"}"<<std::endl;
+
+  if(profS.fail())
+  {
+    std::cerr<<"Error while writing profiling data."<<std::endl;
+    return THOT_ERROR;
+  }
   return THOT_OK;
 }
 
@@ -814,9 +884,12 @@ void takeParametersGivenArgcArgv(int argc,
      // Takes I parameter 
  err=readInt(argc,argv, "-I", &tdp.I);
 
-     // Takes I parameter 
+     // Takes G parameter 
  err=readInt(argc,argv, "-G", &tdp.G);
 
+     // Takes nt parameter 
+ err=readInt(argc,argv, "-nt", &tdp.nt);
+
      // Takes h parameter 
  err=readInt(argc,argv, "-h", &tdp.heuristic);
 
@@ -850,6 +923,14 @@ void takeParametersGivenArgcArgv(int argc,
    err=readFloat(argc,argv, "-wgp", &tdp.wgPruningThreshold);
  }
 
+     // Take -prof parameter
+ err=readSTLstring(argc,argv, "-prof", &tdp.profFile);
+ if(err!=-1)
+ {
+       // Take -profr parameter
+   err=readInt(argc,argv, "-profr", &tdp.profSampleRate);
+ }
+
      // Take verbosity parameter
  err=readOption(argc,argv,"-v");
  if(err==-1)
@@ -904,6 +985,12 @@ int checkParameters(const thot_ms_dec_pars& tdp)
     std::cerr<<"Error: parameter -t not given!"<<std::endl;
     return THOT_ERROR;   
   }
+
+  if(!tdp.profFile.empty() && tdp.profSampleRate<1)
+  {
+    std::cerr<<"Error: value of -profr parameter should be greater than zero!"<<std::endl;
+    return THOT_ERROR;   
+  }
   
   return THOT_OK;
 }
@@ -918,6 +1005,7 @@ void printParameters(const thot_ms_dec_pars& tdp)
 #ifdef MULTI_STACK_USE_GRAN
  std::cerr<<"G: "<<tdp.G<<std::endl;
 #endif
+ std::cerr<<"nt: "<<tdp.nt<<std::endl;
  std::cerr<<"h: "<<tdp.heuristic<<std::endl;
  std::cerr<<"be: "<<tdp.be<<std::endl;
  std::cerr<<"nomon: "<<tdp.nomon<<std::endl;
@@ -940,6 +1028,11 @@ void printParameters(const thot_ms_dec_pars& tdp)
  {
    std::cerr<<"word graph file prefix not given (wordgraphs will not be generated)"<<std::endl;
  }
+ if(!tdp.profFile.empty())
+ {
+   std::cerr<<"profiling data file: "<<tdp.profFile<<std::endl;
+   std::cerr<<"profiling sample rate: "<<tdp.profSampleRate<<std::endl;
+ }
  std::cerr<<"verbosity level: "<<tdp.verbosity<<std::endl;
 }
 
@@ -966,9 +1059,10 @@ void printUsage(void)
   std::cerr << "thot_ms_dec      [-c <string>] [-tm <string>] [-lm <string>]"<<std::endl;
   std::cerr << "                 -t <string> [-o <string>]"<<std::endl;
   std::cerr << "                 [-W <float>] [-S <int>] [-A <int>]"<<std::endl;
-  std::cerr << "                 [-I <int>] [-G <int>] [-h <int>]"<<std::endl;
+  std::cerr << "                 [-I <int>] [-G <int>] [-nt <int>] [-h <int>]"<<std::endl;
   std::cerr << "                 [-be] [ -nomon <int>] [-tmw <float> ... <float>]"<<std::endl;
   std::cerr << "                 [-wg <string> [-wgp <float>] ]"<<std::endl;
+  std::cerr << "                 [-prof <string> [-profr <int>] ]"<<std::endl;
   std::cerr << "                 [-v|-v1|-v2]"<<std::endl;
   std::cerr << "                 [--help] [--version]"<<std::endl<<std::endl;
   std::cerr << " -c <string>           : Configuration file (command-line options override"<<std::endl;
@@ -991,6 +1085,9 @@ void printUsage(void)
 #else
   std::cerr << " -G <int>              : Parameter not available with the given configuration."<<std::endl;
 #endif
+  std::cerr << " -nt <int>             : Number of threads used to expand the hypotheses of"<<std::endl;
+  std::cerr << "                         each iteration (1 by default). Only supported by"<<std::endl;
+  std::cerr << "                         the feature-based translation model implementation."<<std::endl;
   std::cerr << " -h <int>              : Heuristic function used: "<<NO_HEURISTIC<<"->None, "<<LOCAL_T_HEURISTIC<<"->LOCAL_T, "<<std::endl;
   std::cerr << "                         "<<LOCAL_TD_HEURISTIC<<"->LOCAL_TD ("<<PMSTACK_H_DEFAULT<<" by default)."<<std::endl;
   std::cerr << " -be                   : Execute a best-first algorithm (breadth-first search"<<std::endl;
@@ -1010,6 +1107,12 @@ void printUsage(void)
   std::cerr << "                                       state is retained.\n";
   std::cerr << "                         If not given, the number of arcs is not\n";
   std::cerr << "                         restricted.\n";
+  std::cerr << " -prof <string>        : Print to the given file the time spent in each phase"<<std::endl;
+  std::cerr << "                         of the translation process and the decoder counters"<<std::endl;
+  std::cerr << "                         in JSON format, for the whole corpus and for each"<<std::endl;
+  std::cerr << "                         profiled sentence."<<std::endl;
+  std::cerr << " -profr <int>          : Profile one out of every <int> sentences (1 by"<<std::endl;
+  std::cerr << "                         default)."<<std::endl;
   std::cerr << " -v|-v1|-v2            : verbose modes."<<std::endl;
   std::cerr << " --help                : Display this help and exit."<<std::endl;
   std::cerr << " --version             : Output version information and exit."<<std::endl;
@@ -53,6 +53,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <unistd.h>
 #include <signal.h>
 #include <string.h>
+#include <errno.h>
+#include <limits.h>
 #include <sys/wait.h>
 #include <signal.h>
 #include <pthread.h>
@@ -88,6 +90,10 @@ void process_request_switch(int sockd,
                             int user_id,
                             int server_request_type,
                             int verbose);
+int write_batch_result(void* sockd_ptr,
+                       unsigned int sentIdx,
+                       const std::string& result,
+                       const std::string& bestHypInfo);
 int init_user_pars_if_required(int user_id);
 void increase_num_threads_var(void);
 void decrease_num_threads_var(void);
@@ -97,6 +103,10 @@ int handleParameters(int argc,
                      char *argv[]);
 int takeParameters(int argc,
                    const std::vector<std::string>& argv_stl);
+int takeUnsignedPar(const char* parName,
+                    const std::string& valueStr,
+                    unsigned int minValue,
+                    unsigned int& value);
 int checkParameters(void);
 void printParameters(void);
 void printUsage(void);
@@ -154,6 +164,16 @@ int processParameters(void)
     delete thotDecoderPtr;
     return THOT_ERROR;
   }
+  thotDecoderPtr->setProfSampleRate(ts_pars.prof_sample_rate);
+  if(ts_pars.at_given && !ts_pars.w_given)
+  {
+    ret=thotDecoderPtr->startAsyncOnlineTraining(ts_pars.at_journal,ts_pars.at_batch_size,ts_pars.v_given);
+    if(ret==THOT_ERROR)
+    {
+      delete thotDecoderPtr;
+      return THOT_ERROR;
+    }
+  }
 
       // Parameters ok
   if(ts_pars.w_given)
@@ -431,8 +451,10 @@ void process_request_switch(int sockd,
   std::string bestHypInfo;
   std::string catResult;
   std::vector<float> floatVec;
+  std::vector<std::string> sentVec;
   RejectedWordsSet emptyRejWordsSet;
   int ret;
+  int numSents;
   
   switch(server_request_type)
   {
@@ -456,18 +478,41 @@ void process_request_switch(int sockd,
 
     case TRANSLATE_SENT:
       BasicSocketUtils::recvStlStr(sockd,stlStr);
-      thotDecoderPtr->translateSentence(user_id,stlStr.c_str(),result,bestHypInfo,verbose);
+      thotDecoderPtr->translateLongSentence(user_id,stlStr.c_str(),ts_pars.long_sent_segm_len,ts_pars.batch_workers,result,bestHypInfo,verbose);
       BasicSocketUtils::writeStr(sockd,result.c_str());
       BasicSocketUtils::writeStr(sockd,bestHypInfo.c_str());
       break;
 
     case TRANSLATE_SENT_HYPINFO:
       BasicSocketUtils::recvStlStr(sockd,stlStr);
-      thotDecoderPtr->translateSentence(user_id,stlStr.c_str(),result,bestHypInfo,verbose);
+      thotDecoderPtr->translateLongSentence(user_id,stlStr.c_str(),ts_pars.long_sent_segm_len,ts_pars.batch_workers,result,bestHypInfo,verbose);
       BasicSocketUtils::writeStr(sockd,result.c_str());
       BasicSocketUtils::writeStr(sockd,bestHypInfo.c_str());
       break;
 
+    case TRANSLATE_BATCH:
+      numSents=BasicSocketUtils::recvInt(sockd);
+      if(numSents<0 || numSents>MAX_BATCH_SENTS)
+      {
+        BasicSocketUtils::writeInt(sockd,THOT_ERROR);
+        throw std::runtime_error("Batch translation request with an invalid number of sentences");
+      }
+      for(int i=0;i<numSents;++i)
+      {
+        BasicSocketUtils::recvStlStr(sockd,stlStr);
+        sentVec.push_back(stlStr);
+      }
+          // Translations are written to the socket as they are
+          // obtained, an error status replaces the results that could
+          // not be written
+      ret=thotDecoderPtr->translateSentenceBatch(user_id,sentVec,ts_pars.batch_workers,write_batch_result,(void*)&sockd,verbose);
+      if(ret==THOT_ERROR)
+      {
+        BasicSocketUtils::writeInt(sockd,THOT_ERROR);
+        throw std::runtime_error("Batch translation request failed");
+      }
+      break;
+
     case VERIFY_COV:
       BasicSocketUtils::recvStlStr(sockd,stlStrSrc);
       BasicSocketUtils::recvStlStr(sockd,stlStrRef);
@@ -499,6 +544,16 @@ void process_request_switch(int sockd,
         throw std::runtime_error("Printing request failed");
       break;
 
+    case GET_PROF_STATS:
+      thotDecoderPtr->getProfStats(result);
+      BasicSocketUtils::writeStr(sockd,result.c_str());
+      break;
+
+    case GET_OL_TRAIN_STATS:
+      thotDecoderPtr->getOnlineTrainingStats(result);
+      BasicSocketUtils::writeStr(sockd,result.c_str());
+      break;
+
     case END_SERVER: // NOTE: this request only involves sending
                      // acknowledgement message to client and clearing
                      // data structures, end_server variable is not
@@ -509,6 +564,26 @@ void process_request_switch(int sockd,
   }
 }
 
+//---------------
+int write_batch_result(void* sockd_ptr,
+                       unsigned int /*sentIdx*/,
+                       const std::string& result,
+                       const std::string& bestHypInfo)
+{
+  int sockd=*(int*) sockd_ptr;
+  try
+  {
+    BasicSocketUtils::writeInt(sockd,THOT_OK);
+    BasicSocketUtils::writeStr(sockd,result.c_str());
+    BasicSocketUtils::writeStr(sockd,bestHypInfo.c_str());
+  }
+  catch(const std::exception& e)
+  {
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
 //---------------
 int init_user_pars_if_required(int user_id)
 {
@@ -665,6 +740,98 @@ int takeParameters(int argc,
       }
     }
 
+        // -t parameter
+    if(argv_stl[i]=="-t" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -t parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        if(takeUnsignedPar("-t",argv_stl[i+1],1,ts_pars.batch_workers)==THOT_ERROR)
+          return THOT_ERROR;
+        ++matched;
+        ++i;
+      }
+    }
+
+        // -ls parameter
+    if(argv_stl[i]=="-ls" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -ls parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        if(takeUnsignedPar("-ls",argv_stl[i+1],0,ts_pars.long_sent_segm_len)==THOT_ERROR)
+          return THOT_ERROR;
+        ++matched;
+        ++i;
+      }
+    }
+
+        // -prof parameter
+    if(argv_stl[i]=="-prof" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -prof parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        if(takeUnsignedPar("-prof",argv_stl[i+1],0,ts_pars.prof_sample_rate)==THOT_ERROR)
+          return THOT_ERROR;
+        ++matched;
+        ++i;
+      }
+    }
+
+        // -at parameter
+    if(argv_stl[i]=="-at" && !matched)
+    {
+      ts_pars.at_given=true;
+      ++matched;
+    }
+
+        // -atj parameter
+    if(argv_stl[i]=="-atj" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -atj parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        ts_pars.at_given=true;
+        ts_pars.at_journal=argv_stl[i+1];
+        ++matched;
+        ++i;
+      }
+    }
+
+        // -atb parameter
+    if(argv_stl[i]=="-atb" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -atb parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        if(takeUnsignedPar("-atb",argv_stl[i+1],0,ts_pars.at_batch_size)==THOT_ERROR)
+          return THOT_ERROR;
+        ++matched;
+        ++i;
+      }
+    }
+
         // -w parameter
     if(argv_stl[i]=="-w" && !matched)
     {
@@ -697,6 +864,24 @@ int takeParameters(int argc,
   return THOT_OK;
 }
 
+//---------------
+int takeUnsignedPar(const char* parName,
+                    const std::string& valueStr,
+                    unsigned int minValue,
+                    unsigned int& value)
+{
+  char* endPtr;
+  errno=0;
+  long longValue=strtol(valueStr.c_str(),&endPtr,10);
+  if(valueStr.empty() || *endPtr!='\0' || errno==ERANGE || longValue<(long)minValue || longValue>INT_MAX)
+  {
+    std::cerr<<"Error: value of "<<parName<<" parameter should be an integer greater than or equal to "<<minValue<<"!"<<std::endl;
+    return THOT_ERROR;
+  }
+  value=(unsigned int)longValue;
+  return THOT_OK;
+}
+
 //---------------
 int checkParameters(void)
 {
@@ -727,6 +912,12 @@ void printParameters(void)
   std::cerr<<"-i: "<<ts_pars.i_given<<std::endl;
   std::cerr<<"-c: "<<ts_pars.c_given<<std::endl;
   std::cerr<<"-p: "<<ts_pars.server_port<<std::endl;
+  std::cerr<<"-t: "<<ts_pars.batch_workers<<std::endl;
+  std::cerr<<"-ls: "<<ts_pars.long_sent_segm_len<<std::endl;
+  std::cerr<<"-prof: "<<ts_pars.prof_sample_rate<<std::endl;
+  std::cerr<<"-at: "<<ts_pars.at_given<<std::endl;
+  std::cerr<<"-atj: "<<ts_pars.at_journal<<std::endl;
+  std::cerr<<"-atb: "<<ts_pars.at_batch_size<<std::endl;
   std::cerr<<"-w: "<<ts_pars.w_given<<std::endl;
   std::cerr<<"-v: "<<ts_pars.v_given<<std::endl;
   std::cerr<<"-vd: "<<ts_pars.vd_given<<std::endl;
@@ -736,11 +927,35 @@ void printParameters(void)
 void printUsage(void)
 {
   std::cerr<<"Usage: thot_server    -i | -c <string>"<<std::endl;
-  std::cerr<<"                      [-p <int>] [ -w ] [ -v | -vd ] [--help] [--version]"<<std::endl;
+  std::cerr<<"                      [-p <int>] [-t <int>] [-ls <int>] [-prof <int>]"<<std::endl;
+  std::cerr<<"                      [-at] [-atj <string>] [-atb <int>]"<<std::endl;
+  std::cerr<<"                      [ -w ] [ -v | -vd ]"<<std::endl;
+  std::cerr<<"                      [--help] [--version]"<<std::endl;
   std::cerr<<std::endl;
   std::cerr<<"-i             Test server initialization and exit"<<std::endl<<std::endl;
   std::cerr<<"-c <string>    Configuration file"<<std::endl<<std::endl;
   std::cerr<<"-p <int>       Port used by the server"<<std::endl<<std::endl;
+  std::cerr<<"-t <int>       Number of threads used to translate the sentences of batch"<<std::endl;
+  std::cerr<<"               translation requests ("<<DEFAULT_BATCH_WORKERS<<" by default). Each thread"<<std::endl;
+  std::cerr<<"               uses its own decoder. The threads are also used to translate"<<std::endl;
+  std::cerr<<"               the segments of long sentences"<<std::endl<<std::endl;
+  std::cerr<<"-ls <int>      Maximum length in words of the segments in which long sentences"<<std::endl;
+  std::cerr<<"               are split before being translated (by default sentences"<<std::endl;
+  std::cerr<<"               are split only if they exceed the length allowed by the"<<std::endl;
+  std::cerr<<"               decoder)"<<std::endl<<std::endl;
+  std::cerr<<"-prof <int>    Profile one out of every <int> translation requests ("<<DEFAULT_PROF_SAMPLE_RATE<<" by"<<std::endl;
+  std::cerr<<"               default, 0 disables profiling). The profiling data can be"<<std::endl;
+  std::cerr<<"               obtained with the -ps option of thot_client"<<std::endl<<std::endl;
+  std::cerr<<"-at            Asynchronous online training. Training requests are queued"<<std::endl;
+  std::cerr<<"               and acknowledged immediately, a background thread trains the"<<std::endl;
+  std::cerr<<"               models with the queued sentence pairs in batches. The state"<<std::endl;
+  std::cerr<<"               of the queue can be obtained with the -ts option of"<<std::endl;
+  std::cerr<<"               thot_client"<<std::endl<<std::endl;
+  std::cerr<<"-atj <string>  Journal file where the queued sentence pairs are stored until"<<std::endl;
+  std::cerr<<"               they are trained (implies -at). Pending pairs of previous"<<std::endl;
+  std::cerr<<"               executions are loaded from it"<<std::endl<<std::endl;
+  std::cerr<<"-atb <int>     Maximum number of queued sentence pairs trained in each batch"<<std::endl;
+  std::cerr<<"               ("<<DEFAULT_OL_TRAIN_BATCH_SIZE<<" by default, 0 means no limit)"<<std::endl<<std::endl;
   std::cerr<<"-w             Print model weights and exit"<<std::endl<<std::endl;
   std::cerr<<"-v             Verbose mode"<<std::endl<<std::endl;
   std::cerr<<"-vd            Verbose mode for debugging. This mode displays more information"<<std::endl;
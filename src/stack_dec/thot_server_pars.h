@@ -36,6 +36,12 @@ struct thot_server_pars
   std::string c_str;
   bool p_given;
   unsigned int server_port;
+  unsigned int batch_workers;
+  unsigned int long_sent_segm_len;
+  unsigned int prof_sample_rate;
+  bool at_given;
+  std::string at_journal;
+  unsigned int at_batch_size;
   bool w_given;
   bool v_given;
   bool vd_given;
@@ -51,6 +57,12 @@ struct thot_server_pars
       c_given=false;
       p_given=false;
       server_port=DEFAULT_SERVER_PORT;
+      batch_workers=DEFAULT_BATCH_WORKERS;
+      long_sent_segm_len=DEFAULT_LONG_SENT_SEGM_LEN;
+      prof_sample_rate=DEFAULT_PROF_SAMPLE_RATE;
+      at_given=false;
+      at_journal="";
+      at_batch_size=DEFAULT_OL_TRAIN_BATCH_SIZE;
       w_given=false;
       v_given=false;
       vd_given=false;
@@ -0,0 +1,372 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+ 
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: thot_wg_mert.cc                                          */
+/*                                                                  */
+/* Definitions file: thot_wg_mert.cc                                */
+/*                                                                  */
+/* Description: Implements a log-linear weight updater given a set  */
+/*              of word graphs by means of lattice MERT.            */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file thot_wg_mert.cc
+ *
+ * @brief Implements a log-linear weight updater given a set of word
+ * graphs by means of lattice MERT.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "LatticeMert.h"
+#include "MertLattice.h"
+#include "WordGraph.h"
+#include "awkInputStream.h"
+#include "ErrorDefs.h"
+#include "options.h"
+#include <iostream>
+
+//--------------- Constants ------------------------------------------
+
+struct thot_wg_mert_pars
+{
+  std::vector<float> llWeightVec;
+  std::vector<std::string> includeVarStr;
+  std::vector<bool> includeVarBool;
+  std::string fileWithWordGraphs;
+  std::string fileWithReferences;
+  unsigned int numThreads;
+  unsigned int maxIters;
+  unsigned int numRandomDirs;
+  int verbose;
+};
+
+//--------------- Function Declarations ------------------------------
+
+int handleParameters(int argc,
+                     char *argv[],
+                     thot_wg_mert_pars& pars);
+int takeParameters(int argc,
+                   char *argv[],
+                   thot_wg_mert_pars& pars);
+int checkParameters(thot_wg_mert_pars& pars);
+
+int obtain_references(const thot_wg_mert_pars& pars,
+                      std::vector<std::string>& referenceVec);
+int obtain_lattices(const thot_wg_mert_pars& pars,
+                    std::vector<MertLattice>& latticeVec);
+int update_ll_weights(const thot_wg_mert_pars& pars);
+void printUsage(void);
+void version(void);
+
+//--------------- Function Definitions -------------------------------
+
+//--------------------------------
+int main(int argc,char *argv[])
+{
+  thot_wg_mert_pars pars;
+
+  if(handleParameters(argc,argv,pars)==THOT_ERROR)
+  {
+    return THOT_ERROR;
+  }
+  else
+  {
+        // Print parameters
+    std::cerr<<"-w option is";
+    for(unsigned int i=0;i<pars.llWeightVec.size();++i)
+      std::cerr<<" "<<pars.llWeightVec[i];
+    std::cerr<<std::endl;
+    std::cerr<<"-wg option is "<<pars.fileWithWordGraphs<<std::endl;
+    std::cerr<<"-r option is "<<pars.fileWithReferences<<std::endl;
+    std::cerr<<"-va option is";
+    for(unsigned int i=0;i<pars.includeVarBool.size();++i)
+      std::cerr<<" "<<pars.includeVarBool[i];
+    std::cerr<<std::endl;
+    std::cerr<<"-i option is "<<pars.maxIters<<std::endl;
+    std::cerr<<"-rd option is "<<pars.numRandomDirs<<std::endl;
+    std::cerr<<"-nt option is "<<pars.numThreads<<std::endl;
+
+        // Update log-linear weights
+    return update_ll_weights(pars);
+  }
+}
+
+//--------------------------------
+int handleParameters(int argc,
+                     char *argv[],
+                     thot_wg_mert_pars& pars)
+{
+  if(argc==1 || readOption(argc,argv,"--version")!=-1)
+  {
+    version();
+    return THOT_ERROR;
+  }
+  if(readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;   
+  }
+  if(takeParameters(argc,argv,pars)==THOT_ERROR)
+  {
+    return THOT_ERROR;
+  }
+  else
+  {
+    if(checkParameters(pars)==THOT_OK)
+    {
+      return THOT_OK;
+    }
+    else
+    {
+      return THOT_ERROR;
+    }
+  }
+}
+
+//--------------------------------
+int takeParameters(int argc,
+                   char *argv[],
+                   thot_wg_mert_pars& pars)
+{
+      // Take -wg parameter
+  readSTLstring(argc,argv, "-wg", &pars.fileWithWordGraphs);
+  
+      // Take -r parameter
+  readSTLstring(argc,argv, "-r", &pars.fileWithReferences);
+
+      // Obtain included variables
+  readStringSeq(argc,argv, "-va", pars.includeVarStr);
+  for(unsigned int i=0;i<pars.includeVarStr.size();++i)
+  {
+    pars.includeVarBool.push_back(atoi(pars.includeVarStr[i].c_str()));
+  }
+
+      // Obtain weight vector used to generate the word graphs
+  readFloatSeq(argc,argv, "-w", pars.llWeightVec);
+
+      // Take optional parameters
+  pars.maxIters=LATTICE_MERT_DEFAULT_MAX_ITERS;
+  readUnsignedInt(argc,argv, "-i", &pars.maxIters);
+  pars.numRandomDirs=LATTICE_MERT_DEFAULT_NUM_RANDOM_DIRS;
+  readUnsignedInt(argc,argv, "-rd", &pars.numRandomDirs);
+  pars.numThreads=1;
+  readUnsignedInt(argc,argv, "-nt", &pars.numThreads);
+  pars.verbose=(readOption(argc,argv,"-v")!=-1);
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int checkParameters(thot_wg_mert_pars& pars)
+{  
+  if(pars.fileWithWordGraphs.empty())
+  {
+    std::cerr<<"Error: parameter -wg not given!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  if(pars.fileWithReferences.empty())
+  {
+    std::cerr<<"Error: parameter -r not given!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  if(pars.llWeightVec.empty())
+  {
+    std::cerr<<"Error: parameter -w not given!"<<std::endl;
+    return THOT_ERROR;   
+  }
+
+  if(!pars.includeVarBool.empty() && pars.includeVarBool.size()!=pars.llWeightVec.size())
+  {
+    std::cerr<<"Error: number of weights provided by -w and -va options are not equal!"<<std::endl;
+    return THOT_ERROR;       
+  }
+
+  if(pars.numThreads==0)
+  {
+    std::cerr<<"Error: the number of threads should be greater than zero"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int obtain_references(const thot_wg_mert_pars& pars,
+                      std::vector<std::string>& referenceVec)
+{
+      // Clear output variable
+  referenceVec.clear();
+
+      // Fill output variable
+  awkInputStream awk;
+
+  if(awk.open(pars.fileWithReferences.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<pars.fileWithReferences<<std::endl;
+    return THOT_ERROR;
+  }  
+  
+  while(awk.getln())
+  {
+    referenceVec.push_back(awk.dollar(0));
+  }
+  
+  return THOT_OK;
+}
+
+//--------------------------------
+int obtain_lattices(const thot_wg_mert_pars& pars,
+                    std::vector<MertLattice>& latticeVec)
+{
+      // Clear output variable
+  latticeVec.clear();
+
+      // Fill output variable
+  awkInputStream awk;
+
+  if(awk.open(pars.fileWithWordGraphs.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<pars.fileWithWordGraphs<<std::endl;
+    return THOT_ERROR;
+  }
+  
+  while(awk.getln())
+  {
+        // Load word graph, only its compact copy is kept in memory
+    std::string wgFile=awk.dollar(0);
+    WordGraph wg;
+    if(wg.load(wgFile.c_str())==THOT_ERROR)
+    {
+      std::cerr<<"Error while loading word graph "<<wgFile<<std::endl;
+      return THOT_ERROR;
+    }
+    latticeVec.push_back(MertLattice());
+    latticeVec.back().build(wg);
+    if(pars.verbose)
+      std::cerr<<"Lattice for "<<wgFile<<" has "<<latticeVec.back().numArcs()<<" arcs"<<std::endl;
+  }
+  
+  return THOT_OK;
+}
+
+//--------------------------------
+int update_ll_weights(const thot_wg_mert_pars& pars)
+{
+  int retVal;
+  std::vector<std::string> referenceVec;
+  std::vector<MertLattice> latticeVec;
+  
+      // Obtain references
+  retVal=obtain_references(pars,referenceVec);
+  if(retVal==THOT_ERROR)
+    return THOT_ERROR;
+  
+      // Obtain lattices
+  retVal=obtain_lattices(pars,latticeVec);
+  if(retVal==THOT_ERROR)
+    return THOT_ERROR;
+
+  if(latticeVec.size()!=referenceVec.size())
+  {
+    std::cerr<<"Error: the number of word graphs and references are not equal!"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Each sentence has one lattice
+  std::vector<std::vector<const MertLattice*> > latticePtrVecs(latticeVec.size());
+  for(unsigned int i=0;i<latticeVec.size();++i)
+    latticePtrVecs[i].push_back(&latticeVec[i]);
+
+      // Excluded weights are set to zero
+  std::vector<double> currWeightsVec;
+  for(unsigned int i=0;i<pars.llWeightVec.size();++i)
+  {
+    if(pars.includeVarBool.empty() || pars.includeVarBool[i])
+      currWeightsVec.push_back(pars.llWeightVec[i]);
+    else
+      currWeightsVec.push_back(0);
+  }
+
+      // Update log-linear weights
+  LatticeMert latticeMert;
+  latticeMert.setNumThreads(pars.numThreads);
+  latticeMert.setMaxIters(pars.maxIters);
+  latticeMert.setNumRandomDirs(pars.numRandomDirs);
+  std::vector<double> newWeightsVec;
+  double quality;
+  latticeMert.optimize(referenceVec,
+                       latticePtrVecs,
+                       pars.includeVarBool,
+                       currWeightsVec,
+                       newWeightsVec,
+                       quality,
+                       pars.verbose);
+  std::cerr<<"Corpus BLEU of updated weights: "<<quality<<std::endl;
+
+      // Print result
+  std::cout<<"Updated weights:";
+  for(unsigned int i=0;i<newWeightsVec.size();++i)
+    std::cout<<" "<<newWeightsVec[i];
+  std::cout<<std::endl;
+  
+  return THOT_OK;
+}
+
+//--------------------------------
+void printUsage(void)
+{
+  std::cerr<<"thot_wg_mert -w <float> ... <float>"<<std::endl;
+  std::cerr<<"             [-va <bool> ... <bool>]"<<std::endl;
+  std::cerr<<"             -wg <string> -r <string>"<<std::endl;
+  std::cerr<<"             [-i <int>] [-rd <int>] [-nt <int>] [-v]"<<std::endl;
+  std::cerr<<"             [--help] [--version]"<<std::endl;
+  std::cerr<<std::endl;
+  std::cerr<<"-w <float>...<float>     Weights used to generate the word graphs."<<std::endl;
+  std::cerr<<"-va <bool>...<bool>      Set variable values to be excluded or included."<<std::endl;
+  std::cerr<<"                         Each value equal to 0 excludes the variable and values"<<std::endl;
+  std::cerr<<"                         equal to 1 include the variable."<<std::endl;
+  std::cerr<<"-wg <string>             File containing the names of files with word graphs"<<std::endl;
+  std::cerr<<"                         with score components, as generated by thot_ms_dec."<<std::endl;
+  std::cerr<<"-r <string>              File with reference sentences associated to each"<<std::endl;
+  std::cerr<<"                         word graph."<<std::endl;
+  std::cerr<<"-i <int>                 Maximum number of iterations ("<<LATTICE_MERT_DEFAULT_MAX_ITERS<<" by default)."<<std::endl;
+  std::cerr<<"-rd <int>                Number of random directions explored in each"<<std::endl;
+  std::cerr<<"                         iteration ("<<LATTICE_MERT_DEFAULT_NUM_RANDOM_DIRS<<" by default)."<<std::endl;
+  std::cerr<<"-nt <int>                Number of threads (1 by default)."<<std::endl;
+  std::cerr<<"-v                       Verbose mode."<<std::endl;
+  std::cerr<<"--help                   Display this help and exit."<<std::endl;
+  std::cerr<<"--version                Output version information and exit."<<std::endl;
+}
+
+//--------------------------------
+void version(void)
+{
+  std::cerr<<"thot_wg_mert is part of the thot package"<<std::endl;
+  std::cerr<<"thot version "<<THOT_VERSION<<std::endl;
+  std::cerr<<"thot is GNU software written by Daniel Ortiz"<<std::endl;
+}
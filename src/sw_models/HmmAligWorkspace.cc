@@ -0,0 +1,67 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: HmmAligWorkspace                                         */
+/*                                                                  */
+/* Definitions file: HmmAligWorkspace.cc                            */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "HmmAligWorkspace.h"
+#include <pthread.h>
+
+//--------------- Global variables -----------------------------------
+
+namespace
+{
+  pthread_once_t workspaceKeyOnce=PTHREAD_ONCE_INIT;
+  pthread_key_t workspaceKey;
+}
+
+//--------------- Function definitions
+
+//-------------------------
+void HmmAligWorkspace::createKey(void)
+{
+      // The workspace of a thread is deleted when the thread exits
+  pthread_key_create(&workspaceKey,HmmAligWorkspace::destroy);
+}
+
+//-------------------------
+void HmmAligWorkspace::destroy(void* workspacePtr)
+{
+  delete static_cast<HmmAligWorkspace*>(workspacePtr);
+}
+
+//-------------------------
+HmmAligWorkspace& HmmAligWorkspace::get(void)
+{
+  pthread_once(&workspaceKeyOnce,HmmAligWorkspace::createKey);
+  HmmAligWorkspace* workspacePtr=static_cast<HmmAligWorkspace*>(pthread_getspecific(workspaceKey));
+  if(workspacePtr==NULL)
+  {
+    workspacePtr=new HmmAligWorkspace;
+    pthread_setspecific(workspaceKey,workspacePtr);
+  }
+  return *workspacePtr;
+}
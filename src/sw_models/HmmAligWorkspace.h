@@ -0,0 +1,219 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: HmmAligWorkspace                                         */
+/*                                                                  */
+/* Prototype file: HmmAligWorkspace.h                               */
+/*                                                                  */
+/* Description: Scratch buffers used by the Viterbi and forward     */
+/*              algorithms of HMM-based alignment models. Each      */
+/*              thread owns a workspace whose buffers only grow, so */
+/*              that they are not reallocated for each sentence     */
+/*              pair.                                               */
+/*                                                                  */
+/********************************************************************/
+
+#ifndef _HmmAligWorkspace_h
+#define _HmmAligWorkspace_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "SwDefs.h"
+#include <vector>
+
+//--------------- typedefs -------------------------------------------
+
+    // Type of the scores stored in the Viterbi trellis. Single
+    // precision halves the memory traffic of the Viterbi kernel and
+    // doubles the number of scores per SIMD register, at the cost of
+    // rounding the log-probabilities of long sentence pairs
+#ifdef THOT_ENABLE_FLOAT_HMM_VITERBI
+typedef float HmmVitScore;
+#else
+typedef double HmmVitScore;
+#endif
+
+//--------------- Classes --------------------------------------------
+
+//--------------- HmmTrellis class
+
+/**
+ * @brief Matrix stored in a single contiguous buffer. Element (i,j) is
+ * stored at position j*numRows()+i, so that the cells of a given
+ * target position j (the ones visited by the inner loops of the HMM
+ * algorithms) are contiguous. The buffer never shrinks.
+ */
+template<class T>
+class HmmTrellis
+{
+ public:
+
+  HmmTrellis(void)
+    {
+      rows=0;
+      cols=0;
+    }
+
+  void init(size_t _rows,
+            size_t _cols,
+            T val)
+    {
+      rows=_rows;
+      cols=_cols;
+          // assign() does not release memory if the buffer is big enough
+      data.assign(rows*cols,val);
+    }
+      // Initializes the matrix with _rows x _cols elements set to val
+
+  T& operator()(size_t i,size_t j)
+    {
+      return data[j*rows+i];
+    }
+  const T& operator()(size_t i,size_t j)const
+    {
+      return data[j*rows+i];
+    }
+
+  T* column(size_t j)
+    {
+      return &data[j*rows];
+    }
+  const T* column(size_t j)const
+    {
+      return &data[j*rows];
+    }
+      // Returns a pointer to the elements of the j'th column
+
+  size_t numRows(void)const
+    {
+      return rows;
+    }
+  size_t numCols(void)const
+    {
+      return cols;
+    }
+
+ private:
+
+  std::vector<T> data;
+  size_t rows;
+  size_t cols;
+};
+
+//--------------- HmmAligWorkspace class
+
+/**
+ * @brief Buffers used by _incrHmmAligModel to compute the Viterbi
+ * alignment and the forward probability of a sentence pair. The
+ * workspace of the calling thread is obtained with get(), it is
+ * reused by all the models used by the thread.
+ */
+class HmmAligWorkspace
+{
+ public:
+
+      // Viterbi algorithm
+  HmmTrellis<HmmVitScore> vitMatrix;
+  HmmTrellis<PositionIndex> predMatrix;
+  HmmTrellis<HmmVitScore> vitLexLps;
+  HmmTrellis<HmmVitScore> vitAligLps;
+
+      // Forward algorithm
+  HmmTrellis<double> forwardMatrix;
+  HmmTrellis<double> fwdLexLps;
+  HmmTrellis<double> fwdAligLps;
+
+  static HmmAligWorkspace& get(void);
+      // Returns the workspace of the calling thread
+
+ private:
+
+  HmmAligWorkspace(void){}
+  HmmAligWorkspace(const HmmAligWorkspace&);
+  void operator=(const HmmAligWorkspace&);
+
+  static void destroy(void* workspacePtr);
+  static void createKey(void);
+};
+
+//--------------- Function definitions -------------------------------
+
+//--------------- hmmViterbiKernel function
+
+/**
+ * @brief Fills the Viterbi trellis of a sentence pair.
+ *
+ * aligLps(i_tilde,i) contains the log-probability of aligning with
+ * position i given that the previous word was aligned with position
+ * i_tilde (i_tilde=0 for the first target word) and lexLps(i,j) the
+ * lexical log-probability of the j'th target word given the i'th
+ * source word. vitMatrix and predMatrix must have been initialized
+ * with SMALL_LG_NUM and zero, respectively.
+ */
+template<class T>
+void hmmViterbiKernel(const HmmTrellis<T>& aligLps,
+                      const HmmTrellis<T>& lexLps,
+                      HmmTrellis<T>& vitMatrix,
+                      HmmTrellis<PositionIndex>& predMatrix)
+{
+  size_t nslen=vitMatrix.numRows()-1;
+  size_t tlen=vitMatrix.numCols()-1;
+  if(nslen==0 || tlen==0)
+    return;
+
+      // First target word
+  for(size_t i=1;i<=nslen;++i)
+  {
+    vitMatrix(i,1)=aligLps(0,i)+lexLps(i,1);
+    predMatrix(i,1)=0;
+  }
+
+      // Remaining target words
+  for(size_t j=2;j<=tlen;++j)
+  {
+    const T* prevVit=vitMatrix.column(j-1);
+    T* currVit=vitMatrix.column(j);
+    PositionIndex* currPred=predMatrix.column(j);
+    for(size_t i=1;i<=nslen;++i)
+    {
+      const T* transLps=aligLps.column(i);
+      T lexLp=lexLps(i,j);
+      T bestLp=currVit[i];
+      PositionIndex bestPred=currPred[i];
+      for(size_t i_tilde=1;i_tilde<=nslen;++i_tilde)
+      {
+        T lp=prevVit[i_tilde]+transLps[i_tilde]+lexLp;
+        if(lp>bestLp)
+        {
+          bestLp=lp;
+          bestPred=i_tilde;
+        }
+      }
+      currVit[i]=bestLp;
+      currPred[i]=bestPred;
+    }
+  }
+}
+
+#endif
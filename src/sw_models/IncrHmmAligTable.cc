@@ -178,11 +178,11 @@ bool IncrHmmAligTable::loadPlainText(const char* aligNumDenFile)
       if(awk.NF==5)
       {
         aSourceHmm asHmm;
-        asHmm.prev_i=atoi(awk.dollar(1).c_str());
-        asHmm.slen=atoi(awk.dollar(2).c_str());
-        PositionIndex i=atoi(awk.dollar(3).c_str());
-        float numer=atof(awk.dollar(4).c_str());
-        float denom=atof(awk.dollar(5).c_str());
+        asHmm.prev_i=awk.dollarAtoi(1);
+        asHmm.slen=awk.dollarAtoi(2);
+        PositionIndex i=awk.dollarAtoi(3);
+        float numer=awk.dollarAtof(4);
+        float denom=awk.dollarAtof(5);
         setAligNumDen(asHmm,i,numer,denom);
       }
     }
@@ -161,12 +161,12 @@ bool IncrIbm2AligTable::loadPlainText(const char* aligNumDenFile)
       if(awk.NF==6)
       {
         aSource as;
-        as.j=atoi(awk.dollar(1).c_str());
-        as.slen=atoi(awk.dollar(2).c_str());
-        as.tlen=atoi(awk.dollar(3).c_str());
-        PositionIndex i=atoi(awk.dollar(4).c_str());
-        float numer=atof(awk.dollar(5).c_str());
-        float denom=atof(awk.dollar(6).c_str());
+        as.j=awk.dollarAtoi(1);
+        as.slen=awk.dollarAtoi(2);
+        as.tlen=awk.dollarAtoi(3);
+        PositionIndex i=awk.dollarAtoi(4);
+        float numer=awk.dollarAtof(5);
+        float denom=awk.dollarAtof(6);
         setAligNumDen(as,i,numer,denom);
       }
     }
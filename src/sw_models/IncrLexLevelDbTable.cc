@@ -56,6 +56,7 @@ IncrLexLevelDbTable::IncrLexLevelDbTable(void)
     options.block_cache = leveldb::NewLRUCache(10 * 1048576);  // 10 MB for cache
     db = NULL;
     dbName = "";
+    bulkLoading = false;
 }
 
 //-------------------------
@@ -320,6 +321,113 @@ void IncrLexLevelDbTable::setLexNumDen(WordIndex s,
     setLexNumer(s, t, num);
 }
 
+//-------------------------
+bool IncrLexLevelDbTable::startBulkLoad(size_t maxMemBytes)
+{
+    if(db == NULL)
+    {
+        std::cerr << "Database must be initialized before bulk loading" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // A larger write buffer reduces the number of level-0 files. Since
+    // the keys are written in order, the files generated when flushing
+    // the buffer do not overlap and can be moved to the next level
+    // without merging them
+    options.write_buffer_size = LEVELDB_LEX_TABLE_BULK_WRITE_BUFFER_SIZE;
+    clear();
+
+    bulkSorter.init(dbName + ".bulk_tmp_", maxMemBytes, ExternalCountSorter::KEEP_LAST);
+    bulkLoading = true;
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool IncrLexLevelDbTable::bulkSetLexNumDen(WordIndex s,
+                                           WordIndex t,
+                                           float num,
+                                           float den)
+{
+    if(!bulkLoading)
+    {
+        std::cerr << "Bulk loading has not been started" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // Keys are the same as those used by setLexDenom() and
+    // setLexNumer()
+    std::vector<WordIndex> s_vec;
+    s_vec.push_back(s);
+    if(bulkSorter.add(vectorToString(s_vec), den) == THOT_ERROR)
+        return THOT_ERROR;
+
+    std::vector<WordIndex> st_vec;
+    st_vec.push_back(t);
+    st_vec.push_back(s);
+
+    return bulkSorter.add(vectorToString(st_vec), num);
+}
+
+//-------------------------
+bool IncrLexLevelDbTable::finishBulkLoad(void)
+{
+    if(!bulkLoading)
+    {
+        std::cerr << "Bulk loading has not been started" << std::endl;
+        return THOT_ERROR;
+    }
+    bulkLoading = false;
+
+    if(bulkSorter.sort() == THOT_ERROR)
+    {
+        bulkSorter.clear();
+        return THOT_ERROR;
+    }
+
+    // Write the entries in key order
+    leveldb::WriteBatch batch;
+    size_t batchSize = 0;
+    bool ret = THOT_OK;
+    std::string key;
+    double value;
+    while(ret == THOT_OK && bulkSorter.next(key, value))
+    {
+        std::string value_str = floatToString(value);
+        batch.Put(key, value_str);
+        batchSize += key.size() + value_str.size();
+
+        if(batchSize >= LEVELDB_LEX_TABLE_BULK_BATCH_SIZE)
+        {
+            leveldb::Status status = db->Write(leveldb::WriteOptions(), &batch);
+            if(!status.ok())
+            {
+                std::cerr << "Storing data status: " << status.ToString() << std::endl;
+                ret = THOT_ERROR;
+            }
+            batch.Clear();
+            batchSize = 0;
+        }
+    }
+    bulkSorter.clear();
+
+    if(ret == THOT_OK && batchSize > 0)
+    {
+        leveldb::Status status = db->Write(leveldb::WriteOptions(), &batch);
+        if(!status.ok())
+        {
+            std::cerr << "Storing data status: " << status.ToString() << std::endl;
+            ret = THOT_ERROR;
+        }
+    }
+
+    // Compact the database once all the data has been written
+    if(ret == THOT_OK)
+        db->CompactRange(NULL, NULL);
+
+    return ret;
+}
+
 //-------------------------
 bool IncrLexLevelDbTable::load(const char* lexNumDenFile)
 {
@@ -41,6 +41,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif /* HAVE_CONFIG_H */
 
 #include <_incrLexTable.h>
+#include <ExternalCountSorter.h>
 #include <ErrorDefs.h>
 #include <StatModelDefs.h>
 
@@ -56,6 +57,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Constants ------------------------------------------
 
+// Parameters of the bulk loading
+#define LEVELDB_LEX_TABLE_BULK_WRITE_BUFFER_SIZE (64 * 1048576)
+#define LEVELDB_LEX_TABLE_BULK_BATCH_SIZE (4 * 1048576)
+
 
 //--------------- typedefs -------------------------------------------
 
@@ -90,6 +95,10 @@ class IncrLexLevelDbTable : public _incrLexTable
     std::string vectorToKey(const std::vector<WordIndex>& vec)const;
     std::vector<WordIndex> keyToVector(const std::string key)const;
 
+        // Data of the bulk loading
+    ExternalCountSorter bulkSorter;
+    bool bulkLoading;
+
         // Binrary and LevelDB load functions
     bool loadBin(const char* lexNumDenFile);
     bool loadLevelDb(const char* lexNumDenFile);
@@ -124,6 +133,18 @@ class IncrLexLevelDbTable : public _incrLexTable
                           float num,
                           float den);
 
+            // Bulk loading. The values set between startBulkLoad() and
+            // finishBulkLoad() replace the contents of the table. They
+            // are sorted externally using at most maxMemBytes bytes of
+            // memory and written in key order in large batches
+        bool startBulkLoad(size_t maxMemBytes = EXT_SORTER_DEFAULT_MAX_MEM_BYTES);
+        bool bulkSetLexNumDen(WordIndex s,
+                              WordIndex t,
+                              float num,
+                              float den);
+            // Equivalent to setLexNumDen()
+        bool finishBulkLoad(void);
+
             // Functions to get translations for word
         bool getTransForTarget(WordIndex t,
                                std::set<WordIndex>& transSet);
@@ -219,10 +219,10 @@ bool IncrLexTable::loadPlainText(const char* lexNumDenFile)
     {
       if(awk.NF==4)
       {
-        WordIndex s=atoi(awk.dollar(1).c_str());
-        WordIndex t=atoi(awk.dollar(2).c_str());
-        float numer=atof(awk.dollar(3).c_str());
-        float denom=atof(awk.dollar(4).c_str());
+        WordIndex s=awk.dollarAtoi(1);
+        WordIndex t=awk.dollarAtoi(2);
+        float numer=awk.dollarAtof(3);
+        float denom=awk.dollarAtof(4);
         setLexNumDen(s,t,numer,denom);
       }
     }
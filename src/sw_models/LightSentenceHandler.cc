@@ -242,7 +242,7 @@ int LightSentenceHandler::nthSentPairFromFiles(unsigned int n,
 
   if(countFileExists)
   {
-    c=atof(awkSrcTrgC.dollar(1).c_str());
+    c=awkSrcTrgC.dollarAtof(1);
   }
   else
   {
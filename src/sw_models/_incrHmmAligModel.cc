@@ -538,6 +538,57 @@ void _incrHmmAligModel::initCachedLexicalLps(const std::vector<WordIndex>& nSrcS
   }
 }
 
+//-------------------------
+template<class T>
+void _incrHmmAligModel::initLexicalLps(const std::vector<WordIndex>& nSrcSentIndexVector,
+                                       const std::vector<WordIndex>& trgSentIndexVector,
+                                       HmmTrellis<T>& lexLps)
+{
+  lexLps.init(nSrcSentIndexVector.size()+1,trgSentIndexVector.size()+1,(T)SMALL_LG_NUM);
+  for(PositionIndex j=1;j<=trgSentIndexVector.size();++j)
+  {
+    T* lexLpsCol=lexLps.column(j);
+    for(PositionIndex i=1;i<=nSrcSentIndexVector.size();++i)
+    {
+      lexLpsCol[i]=(T)(double)logpts(nSrcSentIndexVector[i-1],trgSentIndexVector[j-1]);
+    }
+  }
+}
+
+//-------------------------
+template<class T>
+void _incrHmmAligModel::initAligLps(const std::vector<WordIndex>& nSrcSentIndexVector,
+                                    const std::vector<WordIndex>& trgSentIndexVector,
+                                    CachedHmmAligLgProb* cached_logap_ptr,
+                                    HmmTrellis<T>& aligLps)
+{
+  PositionIndex slen=getSrcLen(nSrcSentIndexVector);
+  PositionIndex nslen=nSrcSentIndexVector.size();
+  aligLps.init(nslen+1,nslen+1,(T)SMALL_LG_NUM);
+
+      // Only the transitions from prev_i=0 are needed if there is a
+      // single target word
+  PositionIndex last_prev_i=(trgSentIndexVector.size()>1)? nslen : 0;
+  for(PositionIndex i=1;i<=nslen;++i)
+  {
+    T* aligLpsCol=aligLps.column(i);
+    for(PositionIndex prev_i=0;prev_i<=last_prev_i;++prev_i)
+    {
+      if(cached_logap_ptr==NULL)
+      {
+        aligLpsCol[prev_i]=(T)(double)logaProb(prev_i,slen,i);
+      }
+      else
+      {
+            // Update cached alignment log-probs if required
+        if(!cached_logap_ptr->isDefined(prev_i,slen,i))
+          cached_logap_ptr->set_boundary_check(prev_i,slen,i,logaProb(prev_i,slen,i));
+        aligLpsCol[prev_i]=(T)cached_logap_ptr->get(prev_i,slen,i);
+      }
+    }
+  }
+}
+
 //-------------------------
 void _incrHmmAligModel::calcNewLocalSuffStats(std::pair<unsigned int,unsigned int> sentPairRange,
                                               int verbosity)
@@ -598,6 +649,9 @@ void _incrHmmAligModel::calcNewLocalSuffStatsVit(std::pair<unsigned int,unsigned
       // Define variable to cache alignment log probs
   CachedHmmAligLgProb cached_logap;
 
+      // Obtain Viterbi matrices buffers
+  HmmAligWorkspace& workspace=HmmAligWorkspace::get();
+
       // Iterate over the training samples
   for(unsigned int n=sentPairRange.first;n<=sentPairRange.second;++n)
   {
@@ -613,13 +667,11 @@ void _incrHmmAligModel::calcNewLocalSuffStatsVit(std::pair<unsigned int,unsigned
       sentenceHandler.getCount(n,weight);
 
           // Execute Viterbi algorithm
-      std::vector<std::vector<double> > vitMatrix;
-      std::vector<std::vector<PositionIndex> > predMatrix;
-      viterbiAlgorithmCached(nsrcSent,trgSent,cached_logap,vitMatrix,predMatrix);
+      viterbiAlgorithmCached(nsrcSent,trgSent,cached_logap,workspace);
 
           // Obtain Viterbi alignment
       std::vector<PositionIndex> bestAlig;
-      bestAligGivenVitMatricesRaw(vitMatrix,predMatrix,bestAlig);
+      bestAligGivenVitMatricesRaw(workspace.vitMatrix,workspace.predMatrix,bestAlig);
 
           // Calculate sufficient statistics for anji values
       calc_lanji_vit(n,nsrcSent,trgSent,bestAlig,weight);
@@ -1400,8 +1452,32 @@ LgProb _incrHmmAligModel::obtainBestAlignment(std::vector<WordIndex> srcSentInde
                                               std::vector<WordIndex> trgSentIndexVector,
                                               WordAligMatrix& bestWaMatrix)
 {
-  CachedHmmAligLgProb cached_logap;
-  return obtainBestAlignmentCached(srcSentIndexVector,trgSentIndexVector,cached_logap,bestWaMatrix);
+  if(sentenceLengthIsOk(srcSentIndexVector) && sentenceLengthIsOk(trgSentIndexVector))
+  {
+        // Obtain extended source vector
+    std::vector<WordIndex> nSrcSentIndexVector=extendWithNullWord(srcSentIndexVector);
+        // Call function to obtain best lgprob and viterbi alignment
+    HmmAligWorkspace& workspace=HmmAligWorkspace::get();
+    viterbiAlgorithm(nSrcSentIndexVector,
+                     trgSentIndexVector,
+                     workspace);
+    std::vector<PositionIndex> bestAlig;
+    LgProb vit_lp=bestAligGivenVitMatrices(srcSentIndexVector.size(),workspace.vitMatrix,workspace.predMatrix,bestAlig);
+        // Obtain best word alignment vector from the Viterbi matrices
+    bestWaMatrix.init(srcSentIndexVector.size(),trgSentIndexVector.size());
+    bestWaMatrix.putAligVec(bestAlig);
+
+        // Calculate sentence length model lgprob
+    LgProb slm_lp=sentLenLgProb(srcSentIndexVector.size(),
+                                trgSentIndexVector.size());
+
+    return slm_lp+vit_lp;
+  }
+  else
+  {
+    bestWaMatrix.init(srcSentIndexVector.size(),trgSentIndexVector.size());
+    return SMALL_LG_NUM;
+  }
 }
 
 //-------------------------
@@ -1415,15 +1491,13 @@ LgProb _incrHmmAligModel::obtainBestAlignmentCached(std::vector<WordIndex> srcSe
         // Obtain extended source vector
     std::vector<WordIndex> nSrcSentIndexVector=extendWithNullWord(srcSentIndexVector);
         // Call function to obtain best lgprob and viterbi alignment
-    std::vector<std::vector<double> > vitMatrix;
-    std::vector<std::vector<PositionIndex> > predMatrix;
+    HmmAligWorkspace& workspace=HmmAligWorkspace::get();
     viterbiAlgorithmCached(nSrcSentIndexVector,
                            trgSentIndexVector,
                            cached_logap,
-                           vitMatrix,
-                           predMatrix);
+                           workspace);
     std::vector<PositionIndex> bestAlig;
-    LgProb vit_lp=bestAligGivenVitMatrices(srcSentIndexVector.size(),vitMatrix,predMatrix,bestAlig);
+    LgProb vit_lp=bestAligGivenVitMatrices(srcSentIndexVector.size(),workspace.vitMatrix,workspace.predMatrix,bestAlig);
         // Obtain best word alignment vector from the Viterbi matrices
     bestWaMatrix.init(srcSentIndexVector.size(),trgSentIndexVector.size());
     bestWaMatrix.putAligVec(bestAlig);
@@ -1444,88 +1518,48 @@ LgProb _incrHmmAligModel::obtainBestAlignmentCached(std::vector<WordIndex> srcSe
 //-------------------------
 void _incrHmmAligModel::viterbiAlgorithm(const std::vector<WordIndex>& nSrcSentIndexVector,
                                          const std::vector<WordIndex>& trgSentIndexVector,
-                                         std::vector<std::vector<double> >& vitMatrix,
-                                         std::vector<std::vector<PositionIndex> >& predMatrix)
+                                         HmmAligWorkspace& workspace)
 {
-  CachedHmmAligLgProb cached_logap;
-  viterbiAlgorithmCached(nSrcSentIndexVector,trgSentIndexVector,cached_logap,vitMatrix,predMatrix);
+      // Initialize matrices
+  workspace.vitMatrix.init(nSrcSentIndexVector.size()+1,trgSentIndexVector.size()+1,(HmmVitScore)SMALL_LG_NUM);
+  workspace.predMatrix.init(nSrcSentIndexVector.size()+1,trgSentIndexVector.size()+1,0);
+
+      // Obtain lexical and alignment log-probs
+  initLexicalLps(nSrcSentIndexVector,trgSentIndexVector,workspace.vitLexLps);
+  initAligLps(nSrcSentIndexVector,trgSentIndexVector,NULL,workspace.vitAligLps);
+
+      // Fill matrices
+  hmmViterbiKernel(workspace.vitAligLps,workspace.vitLexLps,workspace.vitMatrix,workspace.predMatrix);
 }
 
 //-------------------------
 void _incrHmmAligModel::viterbiAlgorithmCached(const std::vector<WordIndex>& nSrcSentIndexVector,
                                                const std::vector<WordIndex>& trgSentIndexVector,
                                                CachedHmmAligLgProb& cached_logap,
-                                               std::vector<std::vector<double> >& vitMatrix,
-                                               std::vector<std::vector<PositionIndex> >& predMatrix)
+                                               HmmAligWorkspace& workspace)
 {
-      // Obtain slen
-  PositionIndex slen=getSrcLen(nSrcSentIndexVector);
-
-      // Clear matrices
-  vitMatrix.clear();
-  predMatrix.clear();
-
-      // Make room for matrices
-  std::vector<double> dVec;
-  dVec.insert(dVec.begin(),trgSentIndexVector.size()+1,SMALL_LG_NUM);
-  vitMatrix.insert(vitMatrix.begin(),nSrcSentIndexVector.size()+1,dVec);
-
-  std::vector<PositionIndex> pidxVec;
-  pidxVec.insert(pidxVec.begin(),trgSentIndexVector.size()+1,0);
-  predMatrix.insert(predMatrix.begin(),nSrcSentIndexVector.size()+1,pidxVec);
+      // Initialize matrices
+  workspace.vitMatrix.init(nSrcSentIndexVector.size()+1,trgSentIndexVector.size()+1,(HmmVitScore)SMALL_LG_NUM);
+  workspace.predMatrix.init(nSrcSentIndexVector.size()+1,trgSentIndexVector.size()+1,0);
 
-      // Initialize data structure to cache lexical log-probs
-  std::vector<std::vector<double> > cached_logpts;
-  initCachedLexicalLps(nSrcSentIndexVector,trgSentIndexVector,cached_logpts);
+      // Obtain lexical and alignment log-probs
+  initLexicalLps(nSrcSentIndexVector,trgSentIndexVector,workspace.vitLexLps);
+  initAligLps(nSrcSentIndexVector,trgSentIndexVector,&cached_logap,workspace.vitAligLps);
 
       // Fill matrices
-  for(PositionIndex j=1;j<=trgSentIndexVector.size();++j)
-  {
-    for(PositionIndex i=1;i<=nSrcSentIndexVector.size();++i)
-    {
-      if(j==1)
-      {
-            // Update cached alignment log-probs if required
-        if(!cached_logap.isDefined(0,slen,i))
-          cached_logap.set_boundary_check(0,slen,i,logaProb(0,slen,i));
-
-            // Update matrices
-        vitMatrix[i][j]=cached_logap.get(0,slen,i)+cached_logpts[i][j];
-        predMatrix[i][j]=0;
-      }
-      else
-      {
-        for(PositionIndex i_tilde=1;i_tilde<=nSrcSentIndexVector.size();++i_tilde)
-        {
-              // Update cached alignment log-probs if required
-          if(!cached_logap.isDefined(i_tilde,slen,i))
-            cached_logap.set_boundary_check(i_tilde,slen,i,logaProb(i_tilde,slen,i));
-
-              // Update matrices
-          double lp=vitMatrix[i_tilde][j-1]+
-                    cached_logap.get(i_tilde,slen,i)+
-                    cached_logpts[i][j];
-          if(lp>vitMatrix[i][j])
-          {
-            vitMatrix[i][j]=lp;
-            predMatrix[i][j]=i_tilde;
-          }
-        }
-      }
-    }
-  }
+  hmmViterbiKernel(workspace.vitAligLps,workspace.vitLexLps,workspace.vitMatrix,workspace.predMatrix);
 }
 
 //-------------------------
-double _incrHmmAligModel::bestAligGivenVitMatricesRaw(const std::vector<std::vector<double> >& vitMatrix,
-                                                      const std::vector<std::vector<PositionIndex> >& predMatrix,
+double _incrHmmAligModel::bestAligGivenVitMatricesRaw(const HmmTrellis<HmmVitScore>& vitMatrix,
+                                                      const HmmTrellis<PositionIndex>& predMatrix,
                                                       std::vector<PositionIndex>& bestAlig)
 {
-  if(vitMatrix.size()<=1 || predMatrix.size()<=1)
+  if(vitMatrix.numRows()<=1 || predMatrix.numCols()<=1)
   {
-        // if vitMatrix.size()==1 or predMatrix.size()==1, then the
-        // source or the target sentences respectively were empty, so
-        // there is no word alignment to be returned
+        // if vitMatrix.numRows()==1 or predMatrix.numCols()==1, then
+        // the source or the target sentences respectively were empty,
+        // so there is no word alignment to be returned
     bestAlig.clear();
     return 0;
   }
@@ -1533,17 +1567,17 @@ double _incrHmmAligModel::bestAligGivenVitMatricesRaw(const std::vector<std::vec
   {
         // Initialize bestAlig
     bestAlig.clear();
-    bestAlig.insert(bestAlig.begin(),predMatrix[0].size()-1,0);
+    bestAlig.insert(bestAlig.begin(),predMatrix.numCols()-1,0);
 
         // Find last word alignment
-    PositionIndex last_j=predMatrix[1].size()-1;
-    double bestLgProb=vitMatrix[1][last_j];
+    PositionIndex last_j=predMatrix.numCols()-1;
+    HmmVitScore bestLgProb=vitMatrix(1,last_j);
     bestAlig[last_j-1]=1;
-    for(unsigned int i=2;i<=vitMatrix.size()-1;++i)
+    for(unsigned int i=2;i<=vitMatrix.numRows()-1;++i)
     {
-      if(bestLgProb<vitMatrix[i][last_j])
+      if(bestLgProb<vitMatrix(i,last_j))
       {
-        bestLgProb=vitMatrix[i][last_j];
+        bestLgProb=vitMatrix(i,last_j);
         bestAlig[last_j-1]=i;
       }
     }
@@ -1551,7 +1585,7 @@ double _incrHmmAligModel::bestAligGivenVitMatricesRaw(const std::vector<std::vec
         // Retrieve remaining alignments
     for(unsigned int j=last_j;j>1;--j)
     {
-      bestAlig[j-2]=predMatrix[bestAlig[j-1]][j];
+      bestAlig[j-2]=predMatrix(bestAlig[j-1],j);
     }
       
         // Return best log-probability
@@ -1561,8 +1595,8 @@ double _incrHmmAligModel::bestAligGivenVitMatricesRaw(const std::vector<std::vec
 
 //-------------------------
 double _incrHmmAligModel::bestAligGivenVitMatrices(PositionIndex slen,
-                                                   const std::vector<std::vector<double> >& vitMatrix,
-                                                   const std::vector<std::vector<PositionIndex> >& predMatrix,
+                                                   const HmmTrellis<HmmVitScore>& vitMatrix,
+                                                   const HmmTrellis<PositionIndex>& predMatrix,
                                                    std::vector<PositionIndex>& bestAlig)
 {
   double LgProb=bestAligGivenVitMatricesRaw(vitMatrix,predMatrix,bestAlig);
@@ -1622,40 +1656,39 @@ double _incrHmmAligModel::forwardAlgorithm(const std::vector<WordIndex>& nSrcSen
                                            const std::vector<WordIndex>& trgSentIndexVector,
                                            int verbose)
 {
-      // Obtain slen
-  PositionIndex slen=getSrcLen(nSrcSentIndexVector);
-
-  
-      // Make room for matrix
-  std::vector<std::vector<double> > forwardMatrix;
-  std::vector<double> dVec;
-  dVec.insert(dVec.begin(),trgSentIndexVector.size()+1,0.0);
-  forwardMatrix.insert(forwardMatrix.begin(),nSrcSentIndexVector.size()+1,dVec);
+      // Obtain buffers of the calling thread
+  HmmAligWorkspace& workspace=HmmAligWorkspace::get();
+  HmmTrellis<double>& forwardMatrix=workspace.forwardMatrix;
+  forwardMatrix.init(nSrcSentIndexVector.size()+1,trgSentIndexVector.size()+1,0.0);
 
-      // Initialize data structure to cache lexical log-probs
-  std::vector<std::vector<double> > cached_logpts;
-  initCachedLexicalLps(nSrcSentIndexVector,trgSentIndexVector,cached_logpts);
+      // Obtain lexical and alignment log-probs
+  initLexicalLps(nSrcSentIndexVector,trgSentIndexVector,workspace.fwdLexLps);
+  initAligLps(nSrcSentIndexVector,trgSentIndexVector,NULL,workspace.fwdAligLps);
+  const HmmTrellis<double>& cached_logpts=workspace.fwdLexLps;
+  const HmmTrellis<double>& cached_logap=workspace.fwdAligLps;
 
       // Fill matrix
   for(PositionIndex j=1;j<=trgSentIndexVector.size();++j)
   {
+    double* currFwd=forwardMatrix.column(j);
     for(PositionIndex i=1;i<=nSrcSentIndexVector.size();++i)
     {
       if(j==1)
       {
-        forwardMatrix[i][j]=logaProb(0,slen,i)+cached_logpts[i][j];
+        currFwd[i]=cached_logap(0,i)+cached_logpts(i,j);
       }
       else
       {
+        const double* prevFwd=forwardMatrix.column(j-1);
+        const double* transLps=cached_logap.column(i);
+        double lexLp=cached_logpts(i,j);
         for(PositionIndex i_tilde=1;i_tilde<=nSrcSentIndexVector.size();++i_tilde)
         {
-          double lp=forwardMatrix[i_tilde][j-1]+
-            (double)logaProb(i_tilde,slen,i)+
-            cached_logpts[i][j];
+          double lp=prevFwd[i_tilde]+transLps[i_tilde]+lexLp;
           if(i_tilde==1)
-            forwardMatrix[i][j]=lp;
+            currFwd[i]=lp;
           else
-            forwardMatrix[i][j]=MathFuncs::lns_sumlog(lp,forwardMatrix[i][j]);
+            currFwd[i]=MathFuncs::lns_sumlog(lp,currFwd[i]);
         }
       }
     }
@@ -1672,7 +1705,7 @@ double _incrHmmAligModel::forwardAlgorithm(const std::vector<WordIndex>& nSrcSen
     {
       for(PositionIndex i=1;i<=nSrcSentIndexVector.size();++i)
       {
-        std::cerr<<"i="<<i<<",j="<<j<<" "<<forwardMatrix[i][j];
+        std::cerr<<"i="<<i<<",j="<<j<<" "<<forwardMatrix(i,j);
         if(i<nSrcSentIndexVector.size()) std::cerr<<" ; ";
       }
       std::cerr<<std::endl;
@@ -1684,20 +1717,20 @@ double _incrHmmAligModel::forwardAlgorithm(const std::vector<WordIndex>& nSrcSen
 }
 
 //-------------------------
-double _incrHmmAligModel::lgProbGivenForwardMatrix(const std::vector<std::vector<double> >& forwardMatrix)
+double _incrHmmAligModel::lgProbGivenForwardMatrix(const HmmTrellis<double>& forwardMatrix)
 {
       // Sum lgprob for each i
   double lp=SMALL_LG_NUM;
-  PositionIndex last_j=forwardMatrix[1].size()-1;
-  for(unsigned int i=1;i<=forwardMatrix.size()-1;++i)
+  PositionIndex last_j=forwardMatrix.numCols()-1;
+  for(unsigned int i=1;i<=forwardMatrix.numRows()-1;++i)
   {
     if(i==1)
     {
-      lp=forwardMatrix[i][last_j];
+      lp=forwardMatrix(i,last_j);
     }
     else
     {
-      lp=MathFuncs::lns_sumlog(lp,forwardMatrix[i][last_j]);
+      lp=MathFuncs::lns_sumlog(lp,forwardMatrix(i,last_j));
     }
   }
 
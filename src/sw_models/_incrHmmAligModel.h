@@ -47,6 +47,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "aSourceHmm.h"
 #include "HmmAligInfo.h"
 #include "CachedHmmAligLgProb.h"
+#include "HmmAligWorkspace.h"
 #include "DoubleMatrix.h"
 #include "_incrLexTable.h"
 #include "IncrHmmAligTable.h"
@@ -271,6 +272,18 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
    void initCachedLexicalLps(const std::vector<WordIndex>& nSrcSentIndexVector,
                              const std::vector<WordIndex>& trgSentIndexVector,
                              std::vector<std::vector<double> >& cachedLps);
+   template<class T>
+   void initLexicalLps(const std::vector<WordIndex>& nSrcSentIndexVector,
+                       const std::vector<WordIndex>& trgSentIndexVector,
+                       HmmTrellis<T>& lexLps);
+   template<class T>
+   void initAligLps(const std::vector<WordIndex>& nSrcSentIndexVector,
+                    const std::vector<WordIndex>& trgSentIndexVector,
+                    CachedHmmAligLgProb* cached_logap_ptr,
+                    HmmTrellis<T>& aligLps);
+       // Store the lexical and the alignment log-probs of a sentence
+       // pair in the given workspace buffers, alignment log-probs are
+       // taken from cached_logap_ptr if it is not NULL
    double unsmoothed_logpts(WordIndex s,
                             WordIndex t);
        // Returns log(p(t|s)) without smoothing
@@ -291,26 +304,25 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
 
    void viterbiAlgorithm(const std::vector<WordIndex>& nSrcSentIndexVector,
                          const std::vector<WordIndex>& trgSentIndexVector,
-                         std::vector<std::vector<double> >& vitMatrix,
-                         std::vector<std::vector<PositionIndex> >& predMatrix);
+                         HmmAligWorkspace& workspace);
        // Execute the Viterbi algorithm to obtain the best HMM word
-       // alignment
+       // alignment, the Viterbi matrices are stored in the vitMatrix
+       // and predMatrix buffers of the workspace
    void viterbiAlgorithmCached(const std::vector<WordIndex>& nSrcSentIndexVector,
                                const std::vector<WordIndex>& trgSentIndexVector,
                                CachedHmmAligLgProb& cached_logap,
-                               std::vector<std::vector<double> >& vitMatrix,
-                               std::vector<std::vector<PositionIndex> >& predMatrix);
+                               HmmAligWorkspace& workspace);
        // Cached version of viterbiAlgorithm()
 
-   double bestAligGivenVitMatricesRaw(const std::vector<std::vector<double> >& vitMatrix,
-                                      const std::vector<std::vector<PositionIndex> >& predMatrix,
+   double bestAligGivenVitMatricesRaw(const HmmTrellis<HmmVitScore>& vitMatrix,
+                                      const HmmTrellis<PositionIndex>& predMatrix,
                                       std::vector<PositionIndex>& bestAlig);
        // Obtain best alignment vector from Viterbi algorithm matrices,
        // index of null word depends on how the source index vector is
        // transformed
    double bestAligGivenVitMatrices(PositionIndex slen,
-                                   const std::vector<std::vector<double> >& vitMatrix,
-                                   const std::vector<std::vector<PositionIndex> >& predMatrix,
+                                   const HmmTrellis<HmmVitScore>& vitMatrix,
+                                   const HmmTrellis<PositionIndex>& predMatrix,
                                    std::vector<PositionIndex>& bestAlig);
        // Obtain best alignment vector from Viterbi algorithm matrices,
        // index of null word is zero
@@ -319,7 +331,7 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
                            int verbose=0);
        // Execute Forward algorithm to obtain the log-probability of a
        // sentence pair
-   double lgProbGivenForwardMatrix(const std::vector<std::vector<double> >& forwardMatrix);
+   double lgProbGivenForwardMatrix(const HmmTrellis<double>& forwardMatrix);
    LgProb calcVitIbm1LgProb(const std::vector<WordIndex>& srcSentIndexVector,
                             const std::vector<WordIndex>& trgSentIndexVector);
    virtual LgProb calcSumIBM1LgProb(const std::vector<WordIndex>& sSent,
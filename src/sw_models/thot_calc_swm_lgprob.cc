@@ -44,13 +44,32 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <options.h>
 #include <ctimer.h>
 #include <StrProcUtils.h>
+#include <ThreadPool.h>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <math.h>
 
 //--------------- Constants -------------------------------------------
 
+    // Number of sentence pairs read from the input before distributing
+    // them among the scoring threads
+#define SWM_LGPROB_CHUNK_SIZE 1024
+
+//--------------- Type definitions ------------------------------------
+
+struct SentPairChunk
+{
+  bool aligGiven;
+  std::vector<std::string> lineVec;
+  std::vector<std::vector<std::string> > srcSentStrVec;
+  std::vector<std::vector<std::string> > trgSentStrVec;
+  std::vector<std::vector<WordIndex> > srcSentIdxVec;
+  std::vector<std::vector<WordIndex> > trgSentIdxVec;
+  std::vector<std::vector<PositionIndex> > aligVec;
+  std::vector<std::string> outputVec;
+};
 
 //--------------- Function Declarations -------------------------------
 
@@ -62,11 +81,18 @@ int processPairAligFile(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
                         const char *pairPlusAligFile);
 int processSentPairFile(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
                         const char *sentPairFile);
+void addPairToChunk(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
+                    const std::string& line,
+                    const std::vector<std::string>& srcSentVec,
+                    const std::vector<std::string>& trgSentVec,
+                    const std::vector<PositionIndex>& aligVec,
+                    SentPairChunk& chunk);
+void processChunk(SentPairChunk& chunk);
+void scoreSentPairTask(void* taskData,
+                       unsigned int taskIdx,
+                       unsigned int workerIdx);
 void version(void);
 
-//--------------- Type definitions ------------------------------------
-
-
 //--------------- Global variables ------------------------------------
 
 SimpleDynClassLoader<BaseSwAligModel<std::vector<Prob> > > baseSwAligModelDynClassLoader;
@@ -82,6 +108,11 @@ std::string alig;
 int max_opt;
 int alig_given;
 int verbosity;
+int numThreads;
+
+    // Variables used to process sentence pair files in parallel
+ThreadPool threadPool;
+std::vector<CachedHmmAligLgProb> workerCachedLogapVec;
 
 //--------------- Function Definitions --------------------------------
 
@@ -98,6 +129,14 @@ int main(int argc,char *argv[])
   if(init_swm()==THOT_ERROR)
     return THOT_ERROR;
 
+      // Start scoring threads, they share the model instance
+  if(numThreads>1 && threadPool.init(numThreads)==THOT_ERROR)
+  {
+    release_swm();
+    return THOT_ERROR;
+  }
+  workerCachedLogapVec.resize(numThreads>1? numThreads : 1);
+
   if(pairPlusAligFile[0]==0 && sentPairFile[0]==0)
   {         
    std::cerr<<"s: "<<srcSent <<std::endl;
@@ -225,6 +264,7 @@ int init_swm(void)
 //---------------
 void release_swm(void)
 {
+  threadPool.release();
   delete swAligModelPtr;
   baseSwAligModelDynClassLoader.close_module();
 }
@@ -238,8 +278,8 @@ int processPairAligFile(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
  std::vector<std::string> fileSrcSentVec;
  std::vector<std::string> fileTrgSentVec;
  std::vector<PositionIndex> fileAligVec;
- WordAligMatrix waMatrix;
- LgProb lp;
+ SentPairChunk chunk;
+ chunk.aligGiven=true;
 
  if(strcmp(pairPlusAligFile,"-")==0)
  {
@@ -284,16 +324,14 @@ int processPairAligFile(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
      fileAligVec.push_back(atoi(awk.dollar(i).c_str()));
      ++i; 
    }
-   waMatrix.putAligVec(fileAligVec);
-   
-       // Process sentence pair plus alignment
-   lp=swAligModelPtr->calcLgProbForAligVecStr(fileSrcSentVec,
-                                      fileTrgSentVec,
-                                      waMatrix,
-                                      verbosity);
-   
-   std::cout<<awk.dollar(0)<<" ||| "<<lp<<std::endl;
- }   
+
+       // Add sentence pair plus alignment to the chunk being read
+   addPairToChunk(swAligModelPtr,awk.dollar(0),fileSrcSentVec,fileTrgSentVec,fileAligVec,chunk);
+   if(chunk.lineVec.size()>=SWM_LGPROB_CHUNK_SIZE)
+     processChunk(chunk);
+ }
+ processChunk(chunk);
+ 
  return THOT_OK;   
 }
 
@@ -306,12 +344,9 @@ int processSentPairFile(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
  awkInputStream awk;
  std::vector<std::string> srcSentVec;
  std::vector<std::string> trgSentVec;
- LgProb lp;
-
-     // Define variables required to speed up generation of best
-     // alignments for HMM alignment models
- CachedHmmAligLgProb cached_logap;
- IncrHmmAligModel* incrHmmAligModelPtr=dynamic_cast<IncrHmmAligModel*>(swAligModelPtr);
+ std::vector<PositionIndex> aligVec;
+ SentPairChunk chunk;
+ chunk.aligGiven=false;
  
  if(strcmp(sentPairFile,"-")==0)
  {
@@ -350,42 +385,141 @@ int processSentPairFile(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
      ++i; 
    }
 
+       // Add sentence pair to the chunk being read
+   addPairToChunk(swAligModelPtr,awk.dollar(0),srcSentVec,trgSentVec,aligVec,chunk);
+   if(chunk.lineVec.size()>=SWM_LGPROB_CHUNK_SIZE)
+     processChunk(chunk);
+ }
+ processChunk(chunk);
+ 
+ return THOT_OK;   
+}
+
+//---------------
+void addPairToChunk(BaseSwAligModel<std::vector<Prob> > *swAligModelPtr,
+                    const std::string& line,
+                    const std::vector<std::string>& srcSentVec,
+                    const std::vector<std::string>& trgSentVec,
+                    const std::vector<PositionIndex>& aligVec,
+                    SentPairChunk& chunk)
+{
+     // Words are mapped to indices here, since new words are added to
+     // the vocabularies of the model and the scoring threads must only
+     // read it. The smoothed lexical probabilities depend on the size of
+     // the vocabularies, so the pairs read before a pair with new words
+     // are scored first to obtain the same scores as a sequential run
+ if(!chunk.lineVec.empty())
+ {
+   bool newWords=false;
+   for(unsigned int i=0;i<srcSentVec.size() && !newWords;++i)
+     newWords=!swAligModelPtr->existSrcSymbol(srcSentVec[i]);
+   for(unsigned int j=0;j<trgSentVec.size() && !newWords;++j)
+     newWords=!swAligModelPtr->existTrgSymbol(trgSentVec[j]);
+   if(newWords)
+     processChunk(chunk);
+ }
+
+ chunk.lineVec.push_back(line);
+ chunk.srcSentStrVec.push_back(srcSentVec);
+ chunk.trgSentStrVec.push_back(trgSentVec);
+ chunk.srcSentIdxVec.push_back(swAligModelPtr->strVectorToSrcIndexVector(srcSentVec));
+ chunk.trgSentIdxVec.push_back(swAligModelPtr->strVectorToTrgIndexVector(trgSentVec));
+ chunk.aligVec.push_back(aligVec);
+}
+
+//---------------
+void processChunk(SentPairChunk& chunk)
+{
+ unsigned int numPairs=chunk.lineVec.size();
+ chunk.outputVec.clear();
+ chunk.outputVec.resize(numPairs);
+
+     // Score sentence pairs
+ if(numThreads<=1)
+ {
+   for(unsigned int n=0;n<numPairs;++n)
+     scoreSentPairTask((void*)&chunk,n,0);
+ }
+ else
+ {
+   threadPool.run(scoreSentPairTask,(void*)&chunk,numPairs);
+ }
+
+     // Print results in input order
+ for(unsigned int n=0;n<numPairs;++n)
+   std::cout<<chunk.outputVec[n];
+
+     // Clear chunk
+ chunk.lineVec.clear();
+ chunk.srcSentStrVec.clear();
+ chunk.trgSentStrVec.clear();
+ chunk.srcSentIdxVec.clear();
+ chunk.trgSentIdxVec.clear();
+ chunk.aligVec.clear();
+ chunk.outputVec.clear();
+}
+
+//---------------
+void scoreSentPairTask(void* taskData,
+                       unsigned int taskIdx,
+                       unsigned int workerIdx)
+{
+ SentPairChunk* chunkPtr=(SentPairChunk*) taskData;
+ const std::vector<WordIndex>& srcSentIdxVec=chunkPtr->srcSentIdxVec[taskIdx];
+ const std::vector<WordIndex>& trgSentIdxVec=chunkPtr->trgSentIdxVec[taskIdx];
+ std::ostringstream outS;
+ LgProb lp;
+
+ if(chunkPtr->aligGiven)
+ {
+       // Process sentence pair plus alignment
+   WordAligMatrix waMatrix;
+   waMatrix.putAligVec(chunkPtr->aligVec[taskIdx]);
+   lp=swAligModelPtr->calcLgProbForAlig(srcSentIdxVec,
+                                        trgSentIdxVec,
+                                        waMatrix,
+                                        verbosity);
+   outS<<chunkPtr->lineVec[taskIdx]<<" ||| "<<lp<<std::endl;
+ }
+ else
+ {
    if(max_opt)
    {
          // -max option was given
      WordAligMatrix waMatrix;
 
-         // Obtain best alignment
+         // Obtain best alignment, each thread uses its own cache of
+         // alignment log-probs for HMM alignment models
+     IncrHmmAligModel* incrHmmAligModelPtr=dynamic_cast<IncrHmmAligModel*>(swAligModelPtr);
      if(incrHmmAligModelPtr)
      {
-       lp=incrHmmAligModelPtr->obtainBestAlignmentVecStrCached(srcSentVec,
-                                                               trgSentVec,
-                                                               cached_logap,
-                                                               waMatrix);
+       lp=incrHmmAligModelPtr->obtainBestAlignmentCached(srcSentIdxVec,
+                                                         trgSentIdxVec,
+                                                         workerCachedLogapVec[workerIdx],
+                                                         waMatrix);
      }
      else
      {
-       lp=swAligModelPtr->obtainBestAlignmentVecStr(srcSentVec,
-                                                    trgSentVec,
-                                                    waMatrix);
+       lp=swAligModelPtr->obtainBestAlignment(srcSentIdxVec,
+                                              trgSentIdxVec,
+                                              waMatrix);
      }
      
          // Print alignment in GIZA format
      char header[256];
      sprintf(header,"# Alignment probability= %f",(double)lp);
-     printAlignmentInGIZAFormat(std::cout,swAligModelPtr->addNullWordToStrVec(srcSentVec),trgSentVec,waMatrix,header);
+     printAlignmentInGIZAFormat(outS,swAligModelPtr->addNullWordToStrVec(chunkPtr->srcSentStrVec[taskIdx]),chunkPtr->trgSentStrVec[taskIdx],waMatrix,header);
    }
    else
    {
          // -max option was not given
-     lp=swAligModelPtr->calcLgProbVecStr(srcSentVec,
-                                         trgSentVec,
-                                         verbosity);
-     std::cout<<awk.dollar(0)<<" ||| "<<lp<<std::endl;
+     lp=swAligModelPtr->calcLgProb(srcSentIdxVec,
+                                   trgSentIdxVec,
+                                   verbosity);
+     outS<<chunkPtr->lineVec[taskIdx]<<" ||| "<<lp<<std::endl;
    }
  }
- 
- return THOT_OK;   
+ chunkPtr->outputVec[taskIdx]=outS.str();
 }
 
 //---------------
@@ -470,6 +604,15 @@ int TakeParameters(int argc,char *argv[])
    max_opt=1;
  }
 
+     /* Take -nt parameter */
+ numThreads=1;
+ err=readInt(argc,argv,"-nt",&numThreads);
+ if(err!=-1 && numThreads<1)
+ {
+   std::cerr<<"Error: the value of the -nt parameter must be greater than zero"<<std::endl;
+   return THOT_ERROR;
+ }
+
      /* Verify -v option */
  verbosity=0;
  err=readOption(argc,argv,"-v");
@@ -495,8 +638,8 @@ void printUsage(void)
  std::cerr<<"Usage: thot_calc_swm_lgprob -sw <string>\n";
  std::cerr<<"                            {-ss <string> -ts <string>\n";
  std::cerr<<"                            [-a <string>] [-max] | -F <string>\n";
- std::cerr<<"                            | -P <string> [-max]} [-v|-v1] \n";
- std::cerr<<"                            [--help]\n\n";
+ std::cerr<<"                            | -P <string> [-max]} [-nt <int>]\n";
+ std::cerr<<"                            [-v|-v1] [--help]\n\n";
  std::cerr<<"-sw <string>                Prefix of the single-word model files\n";
  std::cerr<<"                            to load\n\n";
  std::cerr<<"-ss <string>                Source sentence\n\n";	
@@ -511,6 +654,9 @@ void printUsage(void)
  std::cerr<<"-P <string>                 File with sentence pairs without alignment.\n";
  std::cerr<<"                            If <string>=\"-\" then stdin is read.\n";
  std::cerr<<"                            Format: src ||| trg\n\n";
+ std::cerr<<"-nt <int>                   Number of threads used to process the sentence\n";
+ std::cerr<<"                            pairs given with -F or -P, the model is loaded\n";
+ std::cerr<<"                            once and shared by all of them (1 by default)\n\n";
  std::cerr<<"-v | -v1                    Verbose mode\n\n";
  std::cerr<<"--help                      Display this help and exit\n\n";
 }
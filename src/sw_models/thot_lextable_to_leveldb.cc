@@ -52,6 +52,8 @@ void printVersion(void);
 
 std::string inputFile;
 std::string outputPath;
+bool bulkLoad;
+int maxMemMb;
 
 //--------------- Function Definitions --------------------------------
 
@@ -71,6 +73,8 @@ int convert()
 {
     IncrLexLevelDbTable lexTable;
     lexTable.init(outputPath.c_str());
+    if(bulkLoad && lexTable.startBulkLoad((size_t) maxMemMb * 1048576) == THOT_ERROR)
+        return THOT_ERROR;
 
     std::ifstream inF (inputFile.c_str(), std::ios::in | std::ios::binary);
     if (!inF)
@@ -93,11 +97,23 @@ int convert()
                 inF.read((char*) &t, sizeof(WordIndex));
                 inF.read((char*) &numer, sizeof(float));
                 inF.read((char*) &denom, sizeof(float));
-                lexTable.setLexNumDen(s, t, numer, denom);
+                if(bulkLoad)
+                {
+                    if(lexTable.bulkSetLexNumDen(s, t, numer, denom) == THOT_ERROR)
+                        return THOT_ERROR;
+                }
+                else
+                    lexTable.setLexNumDen(s, t, numer, denom);
             }
             else end = true;
         }
 
+        if(bulkLoad && lexTable.finishBulkLoad() == THOT_ERROR)
+        {
+            std::cerr << "Error while writing database" << std::endl;
+            return THOT_ERROR;
+        }
+
         return THOT_OK;
     }
 }
@@ -139,6 +155,12 @@ int takeParameters(int argc, char *argv[])
         return THOT_ERROR;
     }
 
+        /* Bulk loading options */
+    bulkLoad = (readOption(argc, argv, "-b") != -1);
+    err = readInt(argc, argv, "-m", &maxMemMb);
+    if(err == -1)
+        maxMemMb = EXT_SORTER_DEFAULT_MAX_MEM_BYTES / 1048576;
+
     return THOT_OK;  
 }
 
@@ -146,9 +168,13 @@ int takeParameters(int argc, char *argv[])
 void printUsage(void)
 {
     std::cerr << "Usage: thot_lextable_to_leveldb -i <string> -o <string>" << std::endl;
-    std::cerr << "                   [-v] [--help] [--version]" << std::endl << std::endl;
+    std::cerr << "                   [-b [-m <int>]] [-v] [--help] [--version]" << std::endl << std::endl;
     std::cerr << "-i <string>        Input file with lex table in binary format" << std::endl;
     std::cerr << "-o <string>        Output path for LevelDB with lex table" << std::endl;
+    std::cerr << "-b                 Sort the entries externally and write them in key" << std::endl;
+    std::cerr << "                   order (bulk loading)" << std::endl;
+    std::cerr << "-m <int>           Memory in MB used to sort the entries when bulk" << std::endl;
+    std::cerr << "                   loading (" << EXT_SORTER_DEFAULT_MAX_MEM_BYTES / 1048576 << " by default)" << std::endl;
     std::cerr << "--help             Display this help and exit." << std::endl;
     std::cerr << "--version          Output version information and exit." << std::endl;
 }
@@ -0,0 +1,214 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: ArenaWordVocabTest                                       */
+/*                                                                  */
+/* Definitions file: ArenaWordVocabTest.cc                          */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "ArenaWordVocabTest.h"
+#include <sstream>
+#include <stdio.h>
+#include <unistd.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( ArenaWordVocabTest );
+
+//---------------------------------------
+void ArenaWordVocabTest::setUp()
+{
+}
+
+//---------------------------------------
+void ArenaWordVocabTest::tearDown()
+{
+}
+
+//---------------------------------------
+std::string ArenaWordVocabTest::tmpFileName(void)
+{
+    char fileName[] = "/tmp/thot_arenavocab_unit_test_XXXXXX";
+    int fd = mkstemp(fileName);
+    CPPUNIT_ASSERT( fd != -1 );
+    close(fd);
+    return fileName;
+}
+
+//---------------------------------------
+void ArenaWordVocabTest::testAddAndFind()
+{
+    /* TEST:
+       Words can be retrieved in both directions
+    */
+    ArenaWordVocab vocab;
+    WordIndex idx;
+
+    CPPUNIT_ASSERT( !vocab.find("house", idx) );
+    vocab.add("house", 3);
+    vocab.add("", 5);
+    vocab.add("casa", 0);
+
+    CPPUNIT_ASSERT_EQUAL(3, (int) vocab.size());
+    CPPUNIT_ASSERT_EQUAL(6, (int) vocab.getIdxRange());
+    CPPUNIT_ASSERT( vocab.find("house", idx) );
+    CPPUNIT_ASSERT_EQUAL(3, (int) idx);
+    CPPUNIT_ASSERT( vocab.find("", idx) );
+    CPPUNIT_ASSERT_EQUAL(5, (int) idx);
+    CPPUNIT_ASSERT( vocab.find("casa", idx) );
+    CPPUNIT_ASSERT_EQUAL(0, (int) idx);
+    CPPUNIT_ASSERT_EQUAL(std::string("house"), std::string(vocab.getWord(3)));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), std::string(vocab.getWord(5)));
+    CPPUNIT_ASSERT( vocab.getWord(1) == NULL );
+    CPPUNIT_ASSERT( vocab.getWord(6) == NULL );
+
+    std::vector<std::pair<std::string,WordIndex> > entries;
+    vocab.getEntries(entries);
+    CPPUNIT_ASSERT_EQUAL(3, (int) entries.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("casa"), entries[0].first);
+    CPPUNIT_ASSERT_EQUAL(std::string("house"), entries[1].first);
+    CPPUNIT_ASSERT_EQUAL(5, (int) entries[2].second);
+}
+
+//---------------------------------------
+void ArenaWordVocabTest::testPrefixesAreDifferentWords()
+{
+    /* TEST:
+       Words that are prefixes of other words, or that are stored at
+       the end of the arena, are not confused with longer words
+    */
+    ArenaWordVocab vocab;
+    WordIndex idx;
+
+    vocab.add("ab", 0);
+    vocab.add("abc", 1);
+    vocab.add("a", 2);
+
+    CPPUNIT_ASSERT( vocab.find("a", idx) );
+    CPPUNIT_ASSERT_EQUAL(2, (int) idx);
+    CPPUNIT_ASSERT( vocab.find("ab", idx) );
+    CPPUNIT_ASSERT_EQUAL(0, (int) idx);
+    CPPUNIT_ASSERT( vocab.find("abc", idx) );
+    CPPUNIT_ASSERT_EQUAL(1, (int) idx);
+    CPPUNIT_ASSERT( !vocab.find("abcd", idx) );
+    CPPUNIT_ASSERT( !vocab.find(std::string("a\0", 2), idx) );
+    CPPUNIT_ASSERT( !vocab.find(std::string(10000, 'a'), idx) );
+}
+
+//---------------------------------------
+void ArenaWordVocabTest::testReplacedEntries()
+{
+    /* TEST:
+       As with a pair of maps, adding an existing word replaces its
+       index without duplicating the word
+    */
+    ArenaWordVocab vocab;
+    WordIndex idx;
+
+    vocab.add("lake", 1);
+    vocab.add("lake", 4);
+
+    CPPUNIT_ASSERT_EQUAL(1, (int) vocab.size());
+    CPPUNIT_ASSERT( vocab.find("lake", idx) );
+    CPPUNIT_ASSERT_EQUAL(4, (int) idx);
+    CPPUNIT_ASSERT_EQUAL(std::string("lake"), std::string(vocab.getWord(4)));
+
+    vocab.add("jezioro", 4);
+    CPPUNIT_ASSERT_EQUAL(2, (int) vocab.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("jezioro"), std::string(vocab.getWord(4)));
+}
+
+//---------------------------------------
+void ArenaWordVocabTest::testGrowth()
+{
+    /* TEST:
+       Words are kept when the hash table grows
+    */
+    ArenaWordVocab vocab;
+    WordIndex idx;
+    unsigned int numWords = 10 * ARENA_VOCAB_INIT_BUCKETS;
+
+    for(unsigned int i = 0; i < numWords; ++i)
+    {
+        std::ostringstream word;
+        word << "w" << i;
+        vocab.add(word.str(), i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(numWords, (unsigned int) vocab.size());
+    for(unsigned int i = 0; i < numWords; ++i)
+    {
+        std::ostringstream word;
+        word << "w" << i;
+        CPPUNIT_ASSERT( vocab.find(word.str(), idx) );
+        CPPUNIT_ASSERT_EQUAL(i, (unsigned int) idx);
+        CPPUNIT_ASSERT_EQUAL(word.str(), std::string(vocab.getWord(i)));
+    }
+    CPPUNIT_ASSERT( !vocab.find("w", idx) );
+}
+
+//---------------------------------------
+void ArenaWordVocabTest::testCopy()
+{
+    /* TEST:
+       Copies are independent of the original vocabulary
+    */
+    ArenaWordVocab vocab;
+    WordIndex idx;
+
+    vocab.add("house", 0);
+    ArenaWordVocab vocabCopy(vocab);
+    vocabCopy.add("casa", 1);
+    vocab = vocabCopy;
+    vocabCopy.clear();
+
+    CPPUNIT_ASSERT_EQUAL(0, (int) vocabCopy.size());
+    CPPUNIT_ASSERT_EQUAL(2, (int) vocab.size());
+    CPPUNIT_ASSERT( vocab.find("casa", idx) );
+    CPPUNIT_ASSERT_EQUAL(1, (int) idx);
+}
+
+//---------------------------------------
+void ArenaWordVocabTest::testSingleWordVocabPrintAndLoad()
+{
+    /* TEST:
+       Vocabularies printed in GIZA format are read again when loading
+    */
+    std::string fileName = tmpFileName();
+    SingleWordVocab swVocab;
+    WordIndex idx = swVocab.addSrcSymbol("casa");
+
+    CPPUNIT_ASSERT( swVocab.printSrcVocab(fileName.c_str()) == THOT_OK );
+
+    SingleWordVocab loadedVocab;
+    CPPUNIT_ASSERT( loadedVocab.loadSrcVocab(fileName.c_str()) == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL(idx, loadedVocab.stringToSrcWordIndex("casa"));
+
+    std::vector<std::pair<std::string,WordIndex> > entries;
+    loadedVocab.getSrcVocabEntries(entries);
+    CPPUNIT_ASSERT_EQUAL(swVocab.getSrcVocabSize(), entries.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("casa"), entries.back().first);
+    CPPUNIT_ASSERT( swVocab.getSrcVocab() == loadedVocab.getSrcVocab() );
+
+    remove(fileName.c_str());
+}
@@ -0,0 +1,91 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: ArenaWordVocabTest                                       */
+/*                                                                  */
+/* Prototypes file: ArenaWordVocabTest.h                            */
+/*                                                                  */
+/* Description: Declares the ArenaWordVocabTest class implementing  */
+/*              unit tests for the ArenaWordVocab class.            */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file ArenaWordVocabTest.h
+ *
+ * @brief Declares the ArenaWordVocabTest class implementing unit tests
+ * for the ArenaWordVocab class.
+ */
+
+#ifndef _ArenaWordVocabTest_h
+#define _ArenaWordVocabTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "ArenaWordVocab.h"
+#include "SingleWordVocab.h"
+#include <string>
+
+//--------------- Constants ------------------------------------------
+
+//--------------- typedefs -------------------------------------------
+
+//--------------- Classes --------------------------------------------
+
+//--------------- ArenaWordVocabTest class
+
+/**
+ * @brief Class implementing tests for ArenaWordVocab.
+ */
+
+class ArenaWordVocabTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( ArenaWordVocabTest );
+    CPPUNIT_TEST( testAddAndFind );
+    CPPUNIT_TEST( testPrefixesAreDifferentWords );
+    CPPUNIT_TEST( testReplacedEntries );
+    CPPUNIT_TEST( testGrowth );
+    CPPUNIT_TEST( testCopy );
+    CPPUNIT_TEST( testSingleWordVocabPrintAndLoad );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        std::string tmpFileName(void);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testAddAndFind();
+        void testPrefixesAreDifferentWords();
+        void testReplacedEntries();
+        void testGrowth();
+        void testCopy();
+        void testSingleWordVocabPrintAndLoad();
+};
+
+#endif
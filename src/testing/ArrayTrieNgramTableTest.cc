@@ -0,0 +1,285 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: ArrayTrieNgramTableTest                                  */
+/*                                                                  */
+/* Definitions file: ArrayTrieNgramTableTest.cc                     */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "ArrayTrieNgramTableTest.h"
+#include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( ArrayTrieNgramTableTest );
+
+//--------------- ArrayTrieNgramTableTest class functions
+//
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::setUp()
+{
+    tab = new ArrayTrieNgramTable();
+    // Updates are only merged by explicit calls to freeze()
+    tab->setMaxDeltaSize(0);
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::tearDown()
+{
+    delete tab;
+}
+
+//---------------------------------------
+std::vector<WordIndex> ArrayTrieNgramTableTest::getVector(WordIndex w1,
+                                                          WordIndex w2,
+                                                          WordIndex w3)
+{
+    std::vector<WordIndex> v;
+    v.push_back(w1);
+    if(w2 != 0) v.push_back(w2);
+    if(w3 != 0) v.push_back(w3);
+    return v;
+}
+
+//---------------------------------------
+im_pair<Count, Count> ArrayTrieNgramTableTest::getInf(float c_s,
+                                                      float c_st)
+{
+    im_pair<Count, Count> inf;
+    inf.first = c_s;
+    inf.second = c_st;
+    return inf;
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::addNgrams()
+{
+    // Bigrams (1,2), (1,3), (4,2) and trigram (1,2,5)
+    tab->addTableEntry(getVector(1), 2, getInf(7, 4));
+    tab->addSrcTrgInfo(getVector(1), 3, Count(3));
+    tab->addTableEntry(getVector(4), 2, getInf(2, 2));
+    tab->addTableEntry(getVector(1, 2), 5, getInf(4, 1));
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testAddTableEntry()
+{
+    std::vector<WordIndex> s = getVector(10, 11);
+    WordIndex t = 12;
+    im_pair<Count, Count> ppi = getInf(7, 5);
+
+    tab->addTableEntry(s, t, ppi);
+    CPPUNIT_ASSERT_EQUAL(7, (int) tab->cSrc(s).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(5, (int) tab->cSrcTrg(s, t).get_c_st());
+
+    tab->freeze();
+    CPPUNIT_ASSERT_EQUAL(0, (int) tab->getDeltaSize());
+    CPPUNIT_ASSERT_EQUAL(7, (int) tab->cSrc(s).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(5, (int) tab->cSrcTrg(s, t).get_c_st());
+
+    // Overwrite the frozen counts
+    tab->addTableEntry(s, t, getInf(9, 6));
+    CPPUNIT_ASSERT_EQUAL(9, (int) tab->cSrc(s).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(6, (int) tab->cSrcTrg(s, t).get_c_st());
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testIncrCountsOfEntryLog()
+{
+    std::vector<WordIndex> s = getVector(3);
+    WordIndex t1 = 7;
+    WordIndex t2 = 8;
+
+    tab->incrCountsOfEntryLog(s, t1, LogCount(log(3)));
+    tab->incrCountsOfEntryLog(s, t2, LogCount(log(17)));
+    tab->freeze();
+    tab->incrCountsOfEntryLog(s, t1, LogCount(log(2)));
+
+    CPPUNIT_ASSERT_EQUAL(5, (int) (tab->cSrcTrg(s, t1).get_c_st() + 0.5));
+    CPPUNIT_ASSERT_EQUAL(17, (int) (tab->cSrcTrg(s, t2).get_c_st() + 0.5));
+    CPPUNIT_ASSERT_EQUAL(22, (int) (tab->cSrc(s).get_c_s() + 0.5));
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testGetEntriesForSource()
+{
+    ArrayTrieNgramTable::TrgTableNode node;
+
+    // Entries only stored in the delta table
+    addNgrams();
+    CPPUNIT_ASSERT( tab->getEntriesForSource(getVector(1), node) );
+    CPPUNIT_ASSERT_EQUAL(2, (int) node.size());
+    CPPUNIT_ASSERT_EQUAL(4, (int) node[2].second.get_c_st());
+    CPPUNIT_ASSERT_EQUAL(7, (int) node[2].first.get_c_s());
+
+    // Entries only stored in the frozen trie
+    tab->freeze();
+    CPPUNIT_ASSERT( tab->getEntriesForSource(getVector(1), node) );
+    CPPUNIT_ASSERT_EQUAL(2, (int) node.size());
+    CPPUNIT_ASSERT_EQUAL(3, (int) node[3].second.get_c_st());
+
+    // Entries stored in both of them
+    tab->addSrcTrgInfo(getVector(1), 6, Count(1));
+    tab->addSrcTrgInfo(getVector(1), 2, Count(8));
+    CPPUNIT_ASSERT( tab->getEntriesForSource(getVector(1), node) );
+    CPPUNIT_ASSERT_EQUAL(3, (int) node.size());
+    CPPUNIT_ASSERT_EQUAL(8, (int) node[2].second.get_c_st());
+    CPPUNIT_ASSERT_EQUAL(1, (int) node[6].second.get_c_st());
+
+    // Only the children of the source are returned
+    CPPUNIT_ASSERT( tab->getEntriesForSource(getVector(1, 2), node) );
+    CPPUNIT_ASSERT_EQUAL(1, (int) node.size());
+    CPPUNIT_ASSERT( !tab->getEntriesForSource(getVector(9), node) );
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testGetEntriesForSourceWithEmptySrc()
+{
+    // TEST:
+    //   No entries are returned for an empty source, as in
+    //   vecx_x_incr_cptable
+    ArrayTrieNgramTable::TrgTableNode node;
+    std::vector<WordIndex> empty;
+
+    tab->incrCountsOfEntryLog(empty, 1, LogCount(log(2)));
+    addNgrams();
+    CPPUNIT_ASSERT( !tab->getEntriesForSource(empty, node) );
+    tab->freeze();
+    CPPUNIT_ASSERT( !tab->getEntriesForSource(empty, node) );
+    CPPUNIT_ASSERT( node.empty() );
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testGetEntriesForTarget()
+{
+    ArrayTrieNgramTable::SrcTableNode node;
+
+    addNgrams();
+    CPPUNIT_ASSERT( tab->getEntriesForTarget(2, node) );
+    CPPUNIT_ASSERT_EQUAL(2, (int) node.size());
+
+    tab->freeze();
+    tab->addSrcTrgInfo(getVector(3, 1), 2, Count(1));
+    CPPUNIT_ASSERT( tab->getEntriesForTarget(2, node) );
+    CPPUNIT_ASSERT_EQUAL(3, (int) node.size());
+    CPPUNIT_ASSERT_EQUAL(2, (int) node[getVector(4)].second.get_c_st());
+    CPPUNIT_ASSERT_EQUAL(2, (int) node[getVector(4)].first.get_c_s());
+
+    CPPUNIT_ASSERT( tab->getEntriesForTarget(5, node) );
+    CPPUNIT_ASSERT_EQUAL(1, (int) node.size());
+    CPPUNIT_ASSERT( !tab->getEntriesForTarget(9, node) );
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testCTrg()
+{
+    // TEST:
+    //   cTrg() adds the counts of the n-grams starting with the given
+    //   word, as vecx_x_incr_cptable does
+    addNgrams();
+    float c1 = (float) tab->cTrg(1) - SMALL_LG_NUM;
+    CPPUNIT_ASSERT_EQUAL(8, (int) (c1 + 0.5));
+
+    tab->freeze();
+    c1 = (float) tab->cTrg(1) - SMALL_LG_NUM;
+    CPPUNIT_ASSERT_EQUAL(8, (int) (c1 + 0.5));
+    CPPUNIT_ASSERT( fabs((float) tab->lcTrg(1) - log(8)) < 1e-3 );
+
+    // Updates after freezing are taken into account
+    tab->addSrcTrgInfo(getVector(1), 3, Count(5));
+    tab->incrCountsOfEntryLog(getVector(4), 6, LogCount(log(3)));
+    c1 = (float) tab->cTrg(1) - SMALL_LG_NUM;
+    CPPUNIT_ASSERT_EQUAL(10, (int) (c1 + 0.5));
+    float c4 = (float) tab->cTrg(4) - SMALL_LG_NUM;
+    CPPUNIT_ASSERT_EQUAL(5, (int) (c4 + 0.5));
+
+    // Words without n-grams
+    CPPUNIT_ASSERT( (float) tab->cTrg(9) == SMALL_LG_NUM );
+    CPPUNIT_ASSERT( (float) tab->lcTrg(9) == SMALL_LG_NUM );
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testQueriesDoNotFreeze()
+{
+    // TEST:
+    //   Queries do not merge the delta table
+    ArrayTrieNgramTable::TrgTableNode trgNode;
+    ArrayTrieNgramTable::SrcTableNode srcNode;
+
+    addNgrams();
+    size_t deltaSize = tab->getDeltaSize();
+    CPPUNIT_ASSERT( deltaSize > 0 );
+
+    tab->getEntriesForSource(getVector(1), trgNode);
+    tab->getEntriesForTarget(2, srcNode);
+    tab->cTrg(1);
+    tab->lcTrg(1);
+    tab->logpSrcGivenTrg(getVector(1), 2);
+    CPPUNIT_ASSERT_EQUAL(deltaSize, tab->getDeltaSize());
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testSize()
+{
+    addNgrams();
+    CPPUNIT_ASSERT_EQUAL(4, (int) tab->size());
+    tab->freeze();
+    CPPUNIT_ASSERT_EQUAL(4, (int) tab->size());
+    tab->addSrcTrgInfo(getVector(1), 2, Count(1));
+    tab->addSrcTrgInfo(getVector(7), 2, Count(1));
+    CPPUNIT_ASSERT_EQUAL(5, (int) tab->size());
+    tab->clear();
+    CPPUNIT_ASSERT_EQUAL(0, (int) tab->size());
+}
+
+//---------------------------------------
+void ArrayTrieNgramTableTest::testPrintAndLoad()
+{
+    // TEST:
+    //   A table written in binary format is mapped with the same
+    //   contents
+    char fileName[] = "/tmp/thot_atrie_unit_test_XXXXXX";
+    int fd = mkstemp(fileName);
+    CPPUNIT_ASSERT( fd != -1 );
+    close(fd);
+
+    addNgrams();
+    CPPUNIT_ASSERT( tab->print(fileName) == THOT_OK );
+
+    ArrayTrieNgramTable loadedTab;
+    CPPUNIT_ASSERT( loadedTab.load(fileName) == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL(tab->size(), loadedTab.size());
+    CPPUNIT_ASSERT_EQUAL(7, (int) loadedTab.cSrc(getVector(1)).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(3, (int) loadedTab.cSrcTrg(getVector(1), 3).get_c_st());
+    CPPUNIT_ASSERT_EQUAL(1, (int) loadedTab.cSrcTrg(getVector(1, 2), 5).get_c_st());
+    CPPUNIT_ASSERT( (float) tab->cTrg(1) == (float) loadedTab.cTrg(1) );
+
+    // Updates are stored in the delta table of the mapped table
+    loadedTab.addSrcTrgInfo(getVector(4), 2, Count(6));
+    CPPUNIT_ASSERT_EQUAL(6, (int) loadedTab.cSrcTrg(getVector(4), 2).get_c_st());
+
+    remove(fileName);
+}
@@ -0,0 +1,108 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: ArrayTrieNgramTableTest                                  */
+/*                                                                  */
+/* Prototypes file: ArrayTrieNgramTableTest.h                       */
+/*                                                                  */
+/* Description: Declares the ArrayTrieNgramTableTest class          */
+/*              implementing unit tests for the ArrayTrieNgramTable */
+/*              class.                                              */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file ArrayTrieNgramTableTest.h
+ *
+ * @brief Declares the ArrayTrieNgramTableTest class implementing unit
+ * tests for the ArrayTrieNgramTable class.
+ */
+
+#ifndef _ArrayTrieNgramTableTest_h
+#define _ArrayTrieNgramTableTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ArrayTrieNgramTable.h"
+#include <cppunit/extensions/HelperMacros.h>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- typedefs -------------------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- ArrayTrieNgramTableTest class
+
+/**
+ * @brief Class implementing tests for ArrayTrieNgramTable. Most tests
+ * check that the same results are obtained before and after freezing
+ * the delta table.
+ */
+
+class ArrayTrieNgramTableTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( ArrayTrieNgramTableTest );
+    CPPUNIT_TEST( testAddTableEntry );
+    CPPUNIT_TEST( testIncrCountsOfEntryLog );
+    CPPUNIT_TEST( testGetEntriesForSource );
+    CPPUNIT_TEST( testGetEntriesForSourceWithEmptySrc );
+    CPPUNIT_TEST( testGetEntriesForTarget );
+    CPPUNIT_TEST( testCTrg );
+    CPPUNIT_TEST( testQueriesDoNotFreeze );
+    CPPUNIT_TEST( testSize );
+    CPPUNIT_TEST( testPrintAndLoad );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        ArrayTrieNgramTable *tab;
+
+        std::vector<WordIndex> getVector(WordIndex w1,
+                                         WordIndex w2=0,
+                                         WordIndex w3=0);
+            // Returns a vector with the non-zero words given
+        im_pair<Count, Count> getInf(float c_s,
+                                     float c_st);
+        void addNgrams(void);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testAddTableEntry();
+        void testIncrCountsOfEntryLog();
+        void testGetEntriesForSource();
+        void testGetEntriesForSourceWithEmptySrc();
+        void testGetEntriesForTarget();
+        void testCTrg();
+        void testQueriesDoNotFreeze();
+        void testSize();
+        void testPrintAndLoad();
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/*********************************************************************/
+/*                                                                   */
+/* Module: BenchReport                                               */
+/*                                                                   */
+/* Definitions file: BenchReport.cc                                  */
+/*                                                                   */
+/*********************************************************************/
+
+
+//--------------- Include files ---------------------------------------
+
+#include "BenchReport.h"
+#include <algorithm>
+#include <iomanip>
+#include <math.h>
+#include <stdio.h>
+
+//--------------- Function definitions
+
+//-------------------------
+BenchReport::BenchReport(void)
+{
+}
+
+//-------------------------
+void BenchReport::addInfo(const std::string& key,
+                          const std::string& value)
+{
+  infoVec.push_back(std::make_pair(key,value));
+}
+
+//-------------------------
+void BenchReport::addResult(const BenchResult& result)
+{
+  resultVec.push_back(result);
+}
+
+//-------------------------
+size_t BenchReport::numResults(void)const
+{
+  return resultVec.size();
+}
+
+//-------------------------
+bool BenchReport::print(std::ostream& outS)const
+{
+  outS<<"{"<<std::endl;
+  outS<<"  \"format_version\": "<<BENCH_REPORT_FORMAT_VERSION<<","<<std::endl;
+
+      // Print context information
+  outS<<"  \"info\": {";
+  for(unsigned int i=0;i<infoVec.size();++i)
+  {
+    if(i>0) outS<<",";
+    outS<<std::endl<<"    \""<<escapeJson(infoVec[i].first)<<"\": \""<<escapeJson(infoVec[i].second)<<"\"";
+  }
+  outS<<std::endl<<"  },"<<std::endl;
+
+      // Print results
+  outS<<"  \"benchmarks\": [";
+  for(unsigned int i=0;i<resultVec.size();++i)
+  {
+    const BenchResult& result=resultVec[i];
+    if(i>0) outS<<",";
+    outS<<std::endl<<"    {"<<std::endl;
+    outS<<"      \"group\": \""<<escapeJson(result.group)<<"\","<<std::endl;
+    outS<<"      \"name\": \""<<escapeJson(result.name)<<"\","<<std::endl;
+    outS<<"      \"params\": {";
+    for(unsigned int j=0;j<result.params.size();++j)
+    {
+      if(j>0) outS<<", ";
+      outS<<"\""<<escapeJson(result.params[j].first)<<"\": ";
+      printNumber(outS,result.params[j].second);
+    }
+    outS<<"},"<<std::endl;
+    outS<<"      \"reps\": "<<result.repSecs.size()<<","<<std::endl;
+    outS<<"      \"ops\": "<<result.numOps<<","<<std::endl;
+
+        // Obtain statistics of the repetitions
+    double minSecs=0;
+    double maxSecs=0;
+    double meanSecs=0;
+    double median=medianSecs(result.repSecs);
+    if(!result.repSecs.empty())
+    {
+      minSecs=*std::min_element(result.repSecs.begin(),result.repSecs.end());
+      maxSecs=*std::max_element(result.repSecs.begin(),result.repSecs.end());
+      for(unsigned int j=0;j<result.repSecs.size();++j)
+        meanSecs+=result.repSecs[j];
+      meanSecs/=result.repSecs.size();
+    }
+    outS<<"      \"secs\": {\"min\": ";
+    printNumber(outS,minSecs);
+    outS<<", \"median\": ";
+    printNumber(outS,median);
+    outS<<", \"mean\": ";
+    printNumber(outS,meanSecs);
+    outS<<", \"max\": ";
+    printNumber(outS,maxSecs);
+    outS<<"},"<<std::endl;
+    outS<<"      \"ops_per_sec\": ";
+    if(median>0)
+      printNumber(outS,result.numOps/median);
+    else
+      outS<<"null";
+    outS<<std::endl<<"    }";
+  }
+  outS<<std::endl<<"  ]"<<std::endl;
+  outS<<"}"<<std::endl;
+
+  if(outS.fail())
+    return THOT_ERROR;
+  else
+    return THOT_OK;
+}
+
+//-------------------------
+double BenchReport::medianSecs(const std::vector<double>& repSecs)
+{
+  if(repSecs.empty())
+    return 0;
+
+  std::vector<double> sortedSecs=repSecs;
+  std::sort(sortedSecs.begin(),sortedSecs.end());
+  size_t mid=sortedSecs.size()/2;
+  if(sortedSecs.size()%2==1)
+    return sortedSecs[mid];
+  else
+    return (sortedSecs[mid-1]+sortedSecs[mid])/2;
+}
+
+//-------------------------
+std::string BenchReport::escapeJson(const std::string& str)
+{
+  std::string result;
+  for(unsigned int i=0;i<str.size();++i)
+  {
+    unsigned char c=str[i];
+    switch(c)
+    {
+      case '"': result+="\\\"";
+        break;
+      case '\\': result+="\\\\";
+        break;
+      case '\n': result+="\\n";
+        break;
+      case '\t': result+="\\t";
+        break;
+      case '\r': result+="\\r";
+        break;
+      default:
+        if(c<0x20)
+        {
+          char buff[8];
+          snprintf(buff,sizeof(buff),"\\u%04x",c);
+          result+=buff;
+        }
+        else
+          result+=c;
+    }
+  }
+  return result;
+}
+
+//-------------------------
+void BenchReport::printNumber(std::ostream& outS,
+                              double value)const
+{
+      // JSON does not support infinite or NaN values
+  if(isnan(value) || isinf(value))
+    outS<<"null";
+  else
+    outS<<std::setprecision(9)<<value;
+}
+
+//-------------------------
+void BenchReport::clear(void)
+{
+  infoVec.clear();
+  resultVec.clear();
+}
@@ -0,0 +1,125 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+/*********************************************************************/
+/*                                                                   */
+/* Module: BenchReport                                               */
+/*                                                                   */
+/* Prototype file: BenchReport                                       */
+/*                                                                   */
+/* Description: Collects the timings of the benchmarks executed by   */
+/*              thot_bench and prints them in JSON format.           */
+/*                                                                   */
+/*********************************************************************/
+
+/**
+ * @file BenchReport.h
+ *
+ * @brief Collects the timings of the benchmarks executed by thot_bench
+ * and prints them in JSON format.
+ */
+
+#ifndef _BenchReport
+#define _BenchReport
+
+//--------------- Include files ---------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ErrorDefs.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+//--------------- Constants -------------------------------------------
+
+#define BENCH_REPORT_FORMAT_VERSION 1
+
+//--------------- Classes ---------------------------------------------
+
+//--------------- BenchResult struct
+
+struct BenchResult
+{
+  std::string group;
+  std::string name;
+      // Numeric parameters of the benchmark (size of the data, decoder
+      // parameters, etc.)
+  std::vector<std::pair<std::string,double> > params;
+      // Number of operations timed in each repetition
+  unsigned long long numOps;
+      // Elapsed time in seconds of each repetition
+  std::vector<double> repSecs;
+
+  BenchResult()
+  {
+    numOps=0;
+  }
+  void addParam(const std::string& paramName,
+                double value)
+  {
+    params.push_back(std::make_pair(paramName,value));
+  }
+};
+
+//--------------- BenchReport class
+
+/**
+ * @brief Stores the results of a set of benchmarks together with
+ * information about the context in which they were executed. The
+ * report is printed as a JSON object so that the results of different
+ * releases can be compared by external tools. For each benchmark, the
+ * minimum, median, mean and maximum time of the repetitions are
+ * printed, as well as the number of operations per second obtained
+ * from the median time.
+ */
+
+class BenchReport
+{
+ public:
+
+      // Constructor
+  BenchReport(void);
+
+      // Functions to add information
+  void addInfo(const std::string& key,
+               const std::string& value);
+      // Adds a string describing the context of the execution
+  void addResult(const BenchResult& result);
+  size_t numResults(void)const;
+
+      // Function to print the report
+  bool print(std::ostream& outS)const;
+
+      // Auxiliary functions
+  static double medianSecs(const std::vector<double>& repSecs);
+  static std::string escapeJson(const std::string& str);
+
+  void clear(void);
+
+ private:
+
+  std::vector<std::pair<std::string,std::string> > infoVec;
+  std::vector<BenchResult> resultVec;
+
+  void printNumber(std::ostream& outS,
+                   double value)const;
+};
+
+#endif
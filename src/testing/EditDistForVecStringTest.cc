@@ -0,0 +1,350 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: EditDistForVecStringTest                                 */
+/*                                                                  */
+/* Definitions file: EditDistForVecStringTest.cc                    */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "EditDistForVecStringTest.h"
+#include <StrProcUtils.h>
+#include <math.h>
+#include <pthread.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( EditDistForVecStringTest );
+
+//--------------- Constants
+
+#define EDVS_TEST_EPSILON   1e-4
+#define EDVS_TEST_THREADS   4
+#define EDVS_TEST_INSTANCES 1100
+
+//--------------- EditDistForVecStringTest class functions
+//
+
+//---------------------------------------
+void EditDistForVecStringTest::setUp()
+{
+    editDist = new EditDistForVecString();
+    // Costs similar to the ones used by PfsmEcm, hits have a non-zero
+    // cost
+    setErrorModel(0.22,2.3,2.1,2.5);
+
+    sentVec.push_back(getVector("the house is green"));
+    sentVec.push_back(getVector("the houses are green"));
+    sentVec.push_back(getVector("a green house"));
+    sentVec.push_back(getVector("the hose is grey"));
+    sentVec.push_back(getVector("tha house"));
+    sentVec.push_back(getVector("is"));
+    sentVec.push_back(getVector(""));
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::tearDown()
+{
+    delete editDist;
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::setErrorModel(Score _hitCost,
+                                             Score _insCost,
+                                             Score _substCost,
+                                             Score _delCost)
+{
+    hitCost=_hitCost;
+    insCost=_insCost;
+    substCost=_substCost;
+    delCost=_delCost;
+    editDist->setErrorModel(hitCost,insCost,substCost,delCost);
+    editDistForStr.setErrorModel(hitCost,insCost,substCost,delCost);
+}
+
+//---------------------------------------
+std::vector<std::string> EditDistForVecStringTest::getVector(std::string str)
+{
+    return StrProcUtils::stringToStringVector(str);
+}
+
+//---------------------------------------
+Score EditDistForVecStringTest::refSubstCost(const std::string& x,
+                                             const std::string& y,
+                                             bool yIsPrefix)
+{
+    unsigned int opCount[PREF_DEL_OP+1]={0,0,0,0,0};
+    if(yIsPrefix)
+    {
+        std::vector<unsigned int> ops;
+        editDistForStr.calculateEditDistPrefixOps(x,y,ops);
+        for(unsigned int i=0;i<ops.size();++i)
+            ++opCount[ops[i]];
+    }
+    else
+    {
+        editDistForStr.calculateEditDistOps(x,y,opCount[HIT_OP],opCount[INS_OP],opCount[SUBST_OP],opCount[DEL_OP]);
+    }
+    return hitCost*opCount[HIT_OP]+insCost*opCount[INS_OP]+substCost*opCount[SUBST_OP]+delCost*opCount[DEL_OP];
+}
+
+//---------------------------------------
+Score EditDistForVecStringTest::refEditDist(const std::vector<std::string>& x,
+                                            const std::vector<std::string>& y,
+                                            bool yIsPrefix,
+                                            bool usePrefDelOp)
+{
+    std::vector<std::vector<Score> > dm(x.size()+1,std::vector<Score>(y.size()+1,0));
+    for(unsigned int j=1;j<=y.size();++j)
+        dm[0][j]=dm[0][j-1]+insCost*y[j-1].size();
+    for(unsigned int i=1;i<=x.size();++i)
+    {
+        dm[i][0]=dm[i-1][0]+delCost*x[i-1].size();
+        for(unsigned int j=1;j<=y.size();++j)
+        {
+            Score subst=refSubstCost(x[i-1],y[j-1],yIsPrefix && j==y.size());
+            Score del=(usePrefDelOp && j==y.size())? 0: delCost*x[i-1].size();
+            Score ins=insCost*y[j-1].size();
+            dm[i][j]=std::min(dm[i-1][j-1]+subst,std::min(dm[i-1][j]+del,dm[i][j-1]+ins));
+        }
+    }
+    return dm[x.size()][y.size()];
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::testCalculateEditDist()
+{
+    // Pairs are processed twice, the second time the cached costs are
+    // used
+    for(unsigned int n=0;n<2;++n)
+    {
+        for(unsigned int i=0;i<sentVec.size();++i)
+        {
+            for(unsigned int j=0;j<sentVec.size();++j)
+            {
+                Score dist=editDist->calculateEditDist(sentVec[i],sentVec[j]);
+                Score refDist=refEditDist(sentVec[i],sentVec[j],false,false);
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(refDist,dist,EDVS_TEST_EPSILON);
+            }
+        }
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0,editDist->calculateEditDist(getVector(""),getVector("")),EDVS_TEST_EPSILON);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4*hitCost,editDist->calculateEditDist(getVector("a bcd"),getVector("a bcd")),EDVS_TEST_EPSILON);
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::testCalculateEditDistPrefix()
+{
+    for(unsigned int i=0;i<sentVec.size();++i)
+    {
+        for(unsigned int j=0;j<sentVec.size();++j)
+        {
+            if(sentVec[j].empty())
+                continue;
+
+            // The last word of the prefix is incomplete
+            std::vector<std::string> pref=sentVec[j];
+            pref.back()=pref.back().substr(0,(pref.back().size()+1)/2);
+            Score dist=editDist->calculateEditDistPrefix(sentVec[i],pref);
+            Score refDist=refEditDist(sentVec[i],pref,true,true);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(refDist,dist,EDVS_TEST_EPSILON);
+
+            // A blank character marks the last word as complete
+            pref=sentVec[j];
+            refDist=refEditDist(sentVec[i],pref,false,true);
+            pref.back()+=" ";
+            dist=editDist->calculateEditDistPrefix(sentVec[i],pref);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(refDist,dist,EDVS_TEST_EPSILON);
+        }
+    }
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::testPrefixOps()
+{
+    std::vector<unsigned int> opsWordLevel;
+    std::vector<unsigned int> opsCharLevel;
+
+    // "ho" is a prefix of "house" and the rest of the words are
+    // deleted at no cost
+    Score dist=editDist->calculateEditDistPrefixOps(getVector("the house is green"),
+                                                    getVector("the ho"),
+                                                    opsWordLevel,
+                                                    opsCharLevel);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5*hitCost,dist,EDVS_TEST_EPSILON);
+    CPPUNIT_ASSERT(opsWordLevel.size()==2);
+    CPPUNIT_ASSERT(opsWordLevel[0]==HIT_OP);
+    CPPUNIT_ASSERT(opsWordLevel[1]==HIT_OP);
+    CPPUNIT_ASSERT(opsCharLevel.size()==2);
+    CPPUNIT_ASSERT(opsCharLevel[0]==HIT_OP);
+    CPPUNIT_ASSERT(opsCharLevel[1]==HIT_OP);
+
+    // Without the special deletion operation the rest of the words
+    // have to be deleted
+    dist=editDist->calculateEditDistPrefixOpsNoPrefDel(getVector("the house is green"),
+                                                       getVector("the ho"),
+                                                       opsWordLevel,
+                                                       opsCharLevel);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5*hitCost+7*delCost,dist,EDVS_TEST_EPSILON);
+    CPPUNIT_ASSERT(opsWordLevel.size()==4);
+    CPPUNIT_ASSERT(opsWordLevel[2]==DEL_OP);
+    CPPUNIT_ASSERT(opsWordLevel[3]==DEL_OP);
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::testSetErrorModel()
+{
+    std::vector<std::string> x=getVector("the house is green");
+    std::vector<std::string> y=getVector("the hose is grey");
+    Score dist=editDist->calculateEditDist(x,y);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(refEditDist(x,y,false,false),dist,EDVS_TEST_EPSILON);
+
+    // The costs cached for the previous model cannot be used
+    setErrorModel(0.1,1,3,1.5);
+    Score newDist=editDist->calculateEditDist(x,y);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(refEditDist(x,y,false,false),newDist,EDVS_TEST_EPSILON);
+    CPPUNIT_ASSERT(fabs(dist-newDist)>EDVS_TEST_EPSILON);
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::testIncrEditDistPrefix()
+{
+    for(unsigned int i=0;i<sentVec.size();++i)
+    {
+        for(unsigned int j=0;j<sentVec.size();++j)
+        {
+            if(sentVec[j].empty())
+                continue;
+            std::vector<std::string> pref=sentVec[j];
+            pref.back()=pref.back().substr(0,(pref.back().size()+1)/2);
+
+            // Obtain the first row of the matrix, its first cell
+            // corresponds to the empty prefix
+            std::vector<Score> prevScoreVec(1,0);
+            std::vector<Score> scoreVec;
+            editDist->incrEditDistPrefixFirstRow(pref,prevScoreVec,scoreVec);
+            CPPUNIT_ASSERT(scoreVec.size()==pref.size()+1);
+
+            // Obtain the rest of rows, one per word of x
+            for(unsigned int k=0;k<sentVec[i].size();++k)
+            {
+                std::vector<Score> newScoreVec(1,scoreVec[0]+delCost*sentVec[i][k].size());
+                std::vector<int> opIdVec;
+                editDist->incrEditDistPrefix(sentVec[i][k],pref,scoreVec,newScoreVec,opIdVec);
+                CPPUNIT_ASSERT(opIdVec.size()==pref.size());
+                scoreVec.swap(newScoreVec);
+            }
+
+            Score refDist=refEditDist(sentVec[i],pref,true,false);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(refDist,scoreVec.back(),EDVS_TEST_EPSILON);
+        }
+    }
+}
+
+//---------------------------------------
+struct EdvsTestThreadData
+{
+    EditDistForVecString* editDist;
+    const std::vector<std::vector<std::string> >* sentVecPtr;
+    std::vector<Score> distVec;
+};
+
+//---------------------------------------
+void* EditDistForVecStringTest::threadEntry(void* arg)
+{
+    EdvsTestThreadData* dataPtr=(EdvsTestThreadData*) arg;
+    const std::vector<std::vector<std::string> >& sentVec=*dataPtr->sentVecPtr;
+    for(unsigned int n=0;n<50;++n)
+    {
+        for(unsigned int i=0;i<sentVec.size();++i)
+        {
+            for(unsigned int j=0;j<sentVec.size();++j)
+            {
+                Score dist=dataPtr->editDist->calculateEditDist(sentVec[i],sentVec[j]);
+                if(n==0)
+                    dataPtr->distVec.push_back(dist);
+                else if(dist!=dataPtr->distVec[i*sentVec.size()+j])
+                    dataPtr->distVec[i*sentVec.size()+j]=-1;
+            }
+        }
+    }
+    return NULL;
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::testThreads()
+{
+    // Each thread uses its own caches, the results should be the same
+    // obtained by a single thread
+    std::vector<EdvsTestThreadData> dataVec(EDVS_TEST_THREADS);
+    std::vector<pthread_t> threadVec(EDVS_TEST_THREADS);
+    for(unsigned int t=0;t<EDVS_TEST_THREADS;++t)
+    {
+        dataVec[t].editDist=editDist;
+        dataVec[t].sentVecPtr=&sentVec;
+        CPPUNIT_ASSERT(pthread_create(&threadVec[t],NULL,&EditDistForVecStringTest::threadEntry,(void*)&dataVec[t])==0);
+    }
+    for(unsigned int t=0;t<EDVS_TEST_THREADS;++t)
+        pthread_join(threadVec[t],NULL);
+
+    for(unsigned int t=0;t<EDVS_TEST_THREADS;++t)
+    {
+        CPPUNIT_ASSERT(dataVec[t].distVec.size()==sentVec.size()*sentVec.size());
+        for(unsigned int i=0;i<sentVec.size();++i)
+        {
+            for(unsigned int j=0;j<sentVec.size();++j)
+            {
+                Score refDist=refEditDist(sentVec[i],sentVec[j],false,false);
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(refDist,dataVec[t].distVec[i*sentVec.size()+j],EDVS_TEST_EPSILON);
+            }
+        }
+    }
+}
+
+//---------------------------------------
+void EditDistForVecStringTest::testManyInstances()
+{
+    // The number of live instances is not limited by the number of
+    // thread-specific keys, and the instances can still be used after
+    // another thread that used one of them exited
+    std::vector<EditDistForVecString*> editDistVec;
+    for(unsigned int n=0;n<EDVS_TEST_INSTANCES;++n)
+    {
+        editDistVec.push_back(new EditDistForVecString());
+        editDistVec.back()->setErrorModel(hitCost,insCost,substCost,delCost);
+    }
+
+    EdvsTestThreadData data;
+    data.editDist=editDistVec[EDVS_TEST_INSTANCES/2];
+    data.sentVecPtr=&sentVec;
+    pthread_t thread;
+    CPPUNIT_ASSERT(pthread_create(&thread,NULL,&EditDistForVecStringTest::threadEntry,(void*)&data)==0);
+    pthread_join(thread,NULL);
+
+    Score refDist=refEditDist(sentVec[0],sentVec[3],false,false);
+    for(unsigned int n=0;n<editDistVec.size();++n)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(refDist,editDistVec[n]->calculateEditDist(sentVec[0],sentVec[3]),EDVS_TEST_EPSILON);
+        delete editDistVec[n];
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(refDist,data.distVec[3],EDVS_TEST_EPSILON);
+}
@@ -0,0 +1,122 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: EditDistForVecStringTest                                 */
+/*                                                                  */
+/* Prototypes file: EditDistForVecStringTest.h                      */
+/*                                                                  */
+/* Description: Declares the EditDistForVecStringTest class         */
+/*              implementing unit tests for the                     */
+/*              EditDistForVecString class.                         */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file EditDistForVecStringTest.h
+ *
+ * @brief Declares the EditDistForVecStringTest class implementing unit
+ * tests for the EditDistForVecString class.
+ */
+
+#ifndef _EditDistForVecStringTest_h
+#define _EditDistForVecStringTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "EditDistForVecString.h"
+#include "EditDistForStr.h"
+#include <cppunit/extensions/HelperMacros.h>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- typedefs -------------------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- EditDistForVecStringTest class
+
+/**
+ * @brief Class implementing tests for EditDistForVecString. The
+ * distances are compared with the ones obtained by a word-level
+ * dynamic programming algorithm that uses EditDistForStr to obtain the
+ * cost of the substitutions.
+ */
+
+class EditDistForVecStringTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( EditDistForVecStringTest );
+    CPPUNIT_TEST( testCalculateEditDist );
+    CPPUNIT_TEST( testCalculateEditDistPrefix );
+    CPPUNIT_TEST( testPrefixOps );
+    CPPUNIT_TEST( testSetErrorModel );
+    CPPUNIT_TEST( testIncrEditDistPrefix );
+    CPPUNIT_TEST( testThreads );
+    CPPUNIT_TEST( testManyInstances );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        EditDistForVecString *editDist;
+        EditDistForStr editDistForStr;
+        Score hitCost;
+        Score insCost;
+        Score substCost;
+        Score delCost;
+        std::vector<std::vector<std::string> > sentVec;
+
+        void setErrorModel(Score hitCost,
+                           Score insCost,
+                           Score substCost,
+                           Score delCost);
+        Score refEditDist(const std::vector<std::string>& x,
+                          const std::vector<std::string>& y,
+                          bool yIsPrefix,
+                          bool usePrefDelOp);
+            // Reference implementation of the edit distance, the last
+            // word of y is taken as an incomplete prefix if yIsPrefix
+            // is true, and the words of x after y are deleted at no
+            // cost if usePrefDelOp is true
+        Score refSubstCost(const std::string& x,
+                           const std::string& y,
+                           bool yIsPrefix);
+        std::vector<std::string> getVector(std::string str);
+        static void* threadEntry(void* arg);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testCalculateEditDist();
+        void testCalculateEditDistPrefix();
+        void testPrefixOps();
+        void testSetErrorModel();
+        void testIncrEditDistPrefix();
+        void testThreads();
+        void testManyInstances();
+};
+
+#endif
@@ -202,3 +202,132 @@ void HatTriePhraseTableTest::testIteratorsOperatorsEqualNotEqual()
     CPPUNIT_ASSERT( !(iter1 == iter2) );
     CPPUNIT_ASSERT( iter1 != iter2 );
 }
+
+//---------------------------------------
+void HatTriePhraseTableTest::testBuildFromEntries()
+{
+    /* TEST:
+       Check that the table built in parallel from a list of entries
+       stores the same counts as the table built with addTableEntry()
+    */
+    std::vector<HatTriePhraseTable::TableEntry> entries(3);
+    entries[0].s = getVector("Uniwersytet Gdanski");
+    entries[0].t = getVector("Gdansk University");
+    entries[0].inf = PhrasePairInfo(Count(40), Count(30));
+    entries[1].s = getVector("Politechnika Gdanska");
+    entries[1].t = getVector("Gdansk University");
+    entries[1].inf = PhrasePairInfo(Count(60), Count(20));
+    entries[2].s = getVector("Uniwersytet Gdanski");
+    entries[2].t = getVector("University of Gdansk");
+    entries[2].inf = PhrasePairInfo(Count(40), Count(10));
+
+    HatTriePhraseTable refTab;
+    for(size_t i = 0; i < entries.size(); i++)
+        refTab.addTableEntry(entries[i].s, entries[i].t, entries[i].inf);
+
+    tabHatTrie->buildFromEntries(entries, 3);
+
+    CPPUNIT_ASSERT_EQUAL(3, (int) tabHatTrie->getNumShards());
+    CPPUNIT_ASSERT_EQUAL(refTab.size(), tab->size());
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        CPPUNIT_ASSERT_EQUAL((int) refTab.cSrc(entries[i].s).get_c_s(),
+                             (int) tab->cSrc(entries[i].s).get_c_s());
+        CPPUNIT_ASSERT_EQUAL((int) refTab.cTrg(entries[i].t).get_c_s(),
+                             (int) tab->cTrg(entries[i].t).get_c_s());
+        CPPUNIT_ASSERT_EQUAL((int) refTab.cSrcTrg(entries[i].s, entries[i].t).get_c_s(),
+                             (int) tab->cSrcTrg(entries[i].s, entries[i].t).get_c_s());
+    }
+    CPPUNIT_ASSERT_EQUAL(50, (int) tab->cTrg(entries[0].t).get_c_s());
+
+    // Iterators must visit the target phrases of every shard
+    int numTrgPhrases = 0;
+    for(HatTriePhraseTable::const_iterator iter = tabHatTrie->begin();
+        iter != tabHatTrie->end();
+        iter++)
+    {
+        numTrgPhrases++;
+    }
+    CPPUNIT_ASSERT_EQUAL(2, numTrgPhrases);
+}
+
+//---------------------------------------
+void HatTriePhraseTableTest::testWriteAndRead()
+{
+    /* TEST:
+       Check that a table written in binary format is restored with
+       the same contents
+    */
+    std::vector<WordIndex> s = getVector("Wyspa Sobieszewska");
+    std::vector<WordIndex> t = getVector("Sobieszewo Island");
+
+    std::vector<HatTriePhraseTable::TableEntry> entries(1);
+    entries[0].s = s;
+    entries[0].t = t;
+    entries[0].inf = PhrasePairInfo(Count(5), Count(4));
+    tabHatTrie->buildFromEntries(entries, 2);
+
+    FILE* file = tmpfile();
+    CPPUNIT_ASSERT(file != NULL);
+    CPPUNIT_ASSERT(tabHatTrie->write(file) == THOT_OK);
+    rewind(file);
+
+    HatTriePhraseTable restoredTab;
+    CPPUNIT_ASSERT(restoredTab.read(file, 2) == THOT_OK);
+    fclose(file);
+
+    CPPUNIT_ASSERT_EQUAL(2, (int) restoredTab.getNumShards());
+    CPPUNIT_ASSERT_EQUAL(tab->size(), restoredTab.size());
+    CPPUNIT_ASSERT_EQUAL(5, (int) restoredTab.cSrc(s).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(4, (int) restoredTab.cTrg(t).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(4, (int) restoredTab.cSrcTrg(s, t).get_c_s());
+}
+
+//---------------------------------------
+void HatTriePhraseTableTest::testReadCorruptedFile()
+{
+    /* TEST:
+       Check that truncated files and files with corrupted sizes are
+       rejected
+    */
+    std::vector<HatTriePhraseTable::TableEntry> entries(1);
+    entries[0].s = getVector("Wyspa Sobieszewska");
+    entries[0].t = getVector("Sobieszewo Island");
+    entries[0].inf = PhrasePairInfo(Count(5), Count(4));
+    tabHatTrie->buildFromEntries(entries, 1);
+
+    FILE* file = tmpfile();
+    CPPUNIT_ASSERT(file != NULL);
+    CPPUNIT_ASSERT(tabHatTrie->write(file) == THOT_OK);
+    std::vector<char> content(ftell(file));
+    rewind(file);
+    CPPUNIT_ASSERT(fread(&content[0], 1, content.size(), file) == content.size());
+    fclose(file);
+
+    // The size of the first shard follows the magic string, the
+    // version and the number of shards
+    size_t blobSizePos = 8 + 2 * sizeof(unsigned int);
+    std::vector<std::vector<char> > corruptedContents;
+    corruptedContents.push_back(std::vector<char>(content.begin(), content.end() - 1));
+    corruptedContents.push_back(content);
+    unsigned long long hugeBlobSize = 1ULL << 60;
+    memcpy(&corruptedContents.back()[blobSizePos], &hugeBlobSize, sizeof(hugeBlobSize));
+    corruptedContents.push_back(content);
+    unsigned long long shortBlobSize = 1;
+    memcpy(&corruptedContents.back()[blobSizePos], &shortBlobSize, sizeof(shortBlobSize));
+    corruptedContents.back().resize(blobSizePos + sizeof(shortBlobSize) + shortBlobSize);
+    corruptedContents.push_back(content);
+    corruptedContents.back()[0] = 'X';
+
+    for(size_t i = 0; i < corruptedContents.size(); i++)
+    {
+        file = tmpfile();
+        CPPUNIT_ASSERT(file != NULL);
+        CPPUNIT_ASSERT(fwrite(&corruptedContents[i][0], 1, corruptedContents[i].size(), file) == corruptedContents[i].size());
+        rewind(file);
+
+        HatTriePhraseTable restoredTab;
+        CPPUNIT_ASSERT(restoredTab.read(file, 1) == THOT_ERROR);
+        fclose(file);
+    }
+}
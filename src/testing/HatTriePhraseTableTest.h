@@ -79,6 +79,9 @@ class HatTriePhraseTableTest: public _phraseTableTest
     CPPUNIT_TEST( testIteratorsLoop );
     CPPUNIT_TEST( testIteratorsOperatorsPlusPlusStar );
     CPPUNIT_TEST( testIteratorsOperatorsEqualNotEqual );
+    CPPUNIT_TEST( testBuildFromEntries );
+    CPPUNIT_TEST( testWriteAndRead );
+    CPPUNIT_TEST( testReadCorruptedFile );
     CPPUNIT_TEST( testAddingSameSrcAndTrg );
     CPPUNIT_TEST( testSize );
     CPPUNIT_TEST( testSubkeys );
@@ -98,6 +101,9 @@ class HatTriePhraseTableTest: public _phraseTableTest
         void testIteratorsLoop();
         void testIteratorsOperatorsPlusPlusStar();
         void testIteratorsOperatorsEqualNotEqual();
+        void testBuildFromEntries();
+        void testWriteAndRead();
+        void testReadCorruptedFile();
 };
 
 #endif
\ No newline at end of file
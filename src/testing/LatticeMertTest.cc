@@ -0,0 +1,288 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: LatticeMertTest                                          */
+/*                                                                  */
+/* Definitions file: LatticeMertTest.cc                             */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "LatticeMertTest.h"
+#include "StrProcUtils.h"
+#include <cmath>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( LatticeMertTest );
+
+//---------------------------------------
+MertLattice::EnvelopeLine LatticeMertTest::line(double slope,
+                                                double intercept,
+                                                unsigned int idx)
+{
+    MertLattice::EnvelopeLine envLine;
+    envLine.slope = slope;
+    envLine.intercept = intercept;
+    envLine.x = 0;
+    envLine.idx = idx;
+    return envLine;
+}
+
+//---------------------------------------
+void LatticeMertTest::addArc(WordGraph& wg,
+                             HypStateIndex predStateIndex,
+                             HypStateIndex succStateIndex,
+                             const std::string& words,
+                             double h0,
+                             double h1)
+{
+    std::vector<Score> scrVec;
+    scrVec.push_back(h0);
+    scrVec.push_back(h1);
+    wg.addArcWithScrComps(predStateIndex, succStateIndex,
+                          StrProcUtils::stringToStringVector(words),
+                          h0, scrVec);
+}
+
+//---------------------------------------
+void LatticeMertTest::setUp()
+{
+    // Sentence 1, the score of each path along w+gamma*d is h0+gamma*h1:
+    //  "a cat"              -2*gamma     best for gamma<0.5
+    //  "the house is big"   -1           best for 0.5<gamma<1
+    //  "the house is small" -3+2*gamma   best for gamma>1
+    // The last path is split into two arcs sharing a state with the
+    // second one
+    WordGraph wg1;
+    addArc(wg1, 0, 3, "a cat", 0, -2);
+    addArc(wg1, 0, 1, "the house", -0.5, 0);
+    addArc(wg1, 1, 3, "is big", -0.5, 0);
+    addArc(wg1, 0, 2, "the house", -1, 1);
+    addArc(wg1, 2, 3, "is small", -2, 1);
+    wg1.addFinalState(3);
+    lattice1.build(wg1);
+
+    // Sentence 2:
+    //  "x y z w"   -gamma      best for gamma<2
+    //  "q q q q"   -4+gamma    best for gamma>2
+    WordGraph wg2;
+    addArc(wg2, 0, 1, "x y z w", 0, -1);
+    addArc(wg2, 0, 2, "q q q q", -4, 1);
+    wg2.addFinalState(1);
+    wg2.addFinalState(2);
+    lattice2.build(wg2);
+
+    refSentVec.clear();
+    refSentVec.push_back("the house is small");
+    refSentVec.push_back("x y z w");
+    latticePtrVecs.clear();
+    latticePtrVecs.resize(2);
+    latticePtrVecs[0].push_back(&lattice1);
+    latticePtrVecs[1].push_back(&lattice2);
+
+    weightVec.clear();
+    weightVec.push_back(1);
+    weightVec.push_back(0);
+    dirVec.clear();
+    dirVec.push_back(0);
+    dirVec.push_back(1);
+}
+
+//---------------------------------------
+void LatticeMertTest::tearDown()
+{
+}
+
+//---------------------------------------
+void LatticeMertTest::testUpperEnvelope()
+{
+    /* TEST:
+       Lines that are not maximum in any interval are removed and the
+       remaining ones are sorted by slope with the left end of their
+       intervals
+    */
+    std::vector<MertLattice::EnvelopeLine> lineVec;
+    lineVec.push_back(line(1, 0, 0));
+    lineVec.push_back(line(0, 1, 1));
+    lineVec.push_back(line(-1, 0, 2));
+    lineVec.push_back(line(0.5, 0.4, 3));   // Below the envelope
+    lineVec.push_back(line(0, 0.5, 4));     // Parallel to line 1
+    lineVec.push_back(line(-1, 0, 5));      // Repeated
+
+    MertLattice::upperEnvelope(lineVec);
+
+    CPPUNIT_ASSERT_EQUAL(3, (int) lineVec.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-1, lineVec[0].slope, 1e-12);
+    CPPUNIT_ASSERT( lineVec[0].x == -HUGE_VAL );
+    CPPUNIT_ASSERT_EQUAL(1, (int) lineVec[1].idx);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-1, lineVec[1].x, 1e-12);
+    CPPUNIT_ASSERT_EQUAL(0, (int) lineVec[2].idx);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1, lineVec[2].x, 1e-12);
+
+    // A single line is its own envelope
+    lineVec.clear();
+    lineVec.push_back(line(2, 3, 7));
+    MertLattice::upperEnvelope(lineVec);
+    CPPUNIT_ASSERT_EQUAL(1, (int) lineVec.size());
+    CPPUNIT_ASSERT( lineVec[0].x == -HUGE_VAL );
+}
+
+//---------------------------------------
+void LatticeMertTest::testObtainEnvelope()
+{
+    /* TEST:
+       The envelope of a lattice contains the best path of each
+       interval
+    */
+    std::vector<MertLattice::EnvelopeLine> envelope;
+    std::vector<std::vector<std::string> > hypVec;
+
+    CPPUNIT_ASSERT_EQUAL(2, (int) lattice1.getNumComps());
+    CPPUNIT_ASSERT_EQUAL(5, (int) lattice1.numArcs());
+    lattice1.obtainEnvelope(weightVec, dirVec, envelope, hypVec);
+
+    CPPUNIT_ASSERT_EQUAL(3, (int) envelope.size());
+    CPPUNIT_ASSERT( envelope[0].x == -HUGE_VAL );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, envelope[1].x, 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1, envelope[2].x, 1e-12);
+    CPPUNIT_ASSERT_EQUAL(std::string("a cat"), StrProcUtils::stringVectorToString(hypVec[envelope[0].idx]));
+    CPPUNIT_ASSERT_EQUAL(std::string("the house is big"), StrProcUtils::stringVectorToString(hypVec[envelope[1].idx]));
+    CPPUNIT_ASSERT_EQUAL(std::string("the house is small"), StrProcUtils::stringVectorToString(hypVec[envelope[2].idx]));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2, envelope[2].slope, 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-3, envelope[2].intercept, 1e-12);
+
+    // Empty lattices have empty envelopes
+    MertLattice emptyLattice;
+    CPPUNIT_ASSERT( emptyLattice.empty() );
+    emptyLattice.obtainEnvelope(weightVec, dirVec, envelope, hypVec);
+    CPPUNIT_ASSERT( envelope.empty() );
+}
+
+//---------------------------------------
+void LatticeMertTest::testObtainEnvelopeWithPaths()
+{
+    /* TEST:
+       Paths that are never the best one are not part of the envelope,
+       and unreachable states are ignored
+    */
+    WordGraph wg;
+    addArc(wg, 0, 2, "a", 0, 0);
+    addArc(wg, 0, 2, "b", -1, 0);    // Always worse than "a"
+    addArc(wg, 2, 3, "c", 0, 1);
+    addArc(wg, 2, 3, "d", 0, -1);
+    addArc(wg, 1, 3, "e", 10, 10);   // State 1 is not reachable
+    wg.addFinalState(3);
+    MertLattice lattice;
+    lattice.build(wg);
+    CPPUNIT_ASSERT_EQUAL(4, (int) lattice.numArcs());
+
+    std::vector<MertLattice::EnvelopeLine> envelope;
+    std::vector<std::vector<std::string> > hypVec;
+    lattice.obtainEnvelope(weightVec, dirVec, envelope, hypVec);
+    CPPUNIT_ASSERT_EQUAL(2, (int) envelope.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0, envelope[1].x, 1e-12);
+    CPPUNIT_ASSERT_EQUAL(std::string("a d"), StrProcUtils::stringVectorToString(hypVec[envelope[0].idx]));
+    CPPUNIT_ASSERT_EQUAL(std::string("a c"), StrProcUtils::stringVectorToString(hypVec[envelope[1].idx]));
+}
+
+//---------------------------------------
+void LatticeMertTest::testLineSearch()
+{
+    /* TEST:
+       The line search merges the envelopes of the sentences and
+       returns the middle of the interval where both translations are
+       correct, 1<gamma<2
+    */
+    for(unsigned int numThreads = 1; numThreads <= 2; ++numThreads)
+    {
+        LatticeMert latticeMert;
+        latticeMert.setNumThreads(numThreads);
+        double gamma;
+        double bestQuality;
+        double zeroQuality;
+        latticeMert.lineSearch(refSentVec, latticePtrVecs, weightVec, dirVec, gamma, bestQuality, zeroQuality);
+
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5, gamma, 1e-12);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, bestQuality, 1e-12);
+        CPPUNIT_ASSERT( zeroQuality < bestQuality );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(zeroQuality, latticeMert.obtainQuality(refSentVec, latticePtrVecs, weightVec), 1e-12);
+
+        std::vector<double> newWeightVec = weightVec;
+        newWeightVec[1] += gamma;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(bestQuality, latticeMert.obtainQuality(refSentVec, latticePtrVecs, newWeightVec), 1e-12);
+    }
+
+    // When the best interval is open, the step goes beyond its end
+    LatticeMert latticeMert;
+    std::vector<std::string> firstRefSentVec(1, refSentVec[0]);
+    std::vector<std::vector<const MertLattice*> > firstLatticePtrVecs(1, latticePtrVecs[0]);
+    double gamma;
+    double bestQuality;
+    double zeroQuality;
+    latticeMert.lineSearch(firstRefSentVec, firstLatticePtrVecs, weightVec, dirVec, gamma, bestQuality, zeroQuality);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1 + LATTICE_MERT_OPEN_INTERVAL_STEP, gamma, 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, bestQuality, 1e-12);
+}
+
+//---------------------------------------
+void LatticeMertTest::testLineSearchAtOptimum()
+{
+    /* TEST:
+       The step is zero when the current weights are already optimal
+    */
+    LatticeMert latticeMert;
+    std::vector<double> optWeightVec = weightVec;
+    optWeightVec[1] = 1.25;
+    double gamma;
+    double bestQuality;
+    double zeroQuality;
+    latticeMert.lineSearch(refSentVec, latticePtrVecs, optWeightVec, dirVec, gamma, bestQuality, zeroQuality);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0, gamma, 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, bestQuality, 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, zeroQuality, 1e-12);
+}
+
+//---------------------------------------
+void LatticeMertTest::testOptimize()
+{
+    /* TEST:
+       Optimization reaches the weights where both translations are
+       correct and does not modify excluded weights
+    */
+    LatticeMert latticeMert;
+    std::vector<bool> includeVarBool(2, true);
+    std::vector<double> newWeightVec;
+    double quality;
+    latticeMert.optimize(refSentVec, latticePtrVecs, includeVarBool, weightVec, newWeightVec, quality);
+
+    CPPUNIT_ASSERT_EQUAL(2, (int) newWeightVec.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, quality, 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(quality, latticeMert.obtainQuality(refSentVec, latticePtrVecs, newWeightVec), 1e-12);
+
+    // Only the first weight can be modified
+    includeVarBool[1] = false;
+    latticeMert.optimize(refSentVec, latticePtrVecs, includeVarBool, weightVec, newWeightVec, quality);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0, newWeightVec[1], 1e-12);
+    CPPUNIT_ASSERT( quality >= latticeMert.obtainQuality(refSentVec, latticePtrVecs, weightVec) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(quality, latticeMert.obtainQuality(refSentVec, latticePtrVecs, newWeightVec), 1e-12);
+}
@@ -0,0 +1,112 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: LatticeMertTest                                          */
+/*                                                                  */
+/* Prototypes file: LatticeMertTest.h                               */
+/*                                                                  */
+/* Description: Declares the LatticeMertTest class implementing     */
+/*              unit tests for the MertLattice and LatticeMert      */
+/*              classes.                                            */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file LatticeMertTest.h
+ *
+ * @brief Declares the LatticeMertTest class implementing unit tests
+ * for the MertLattice and LatticeMert classes.
+ */
+
+#ifndef _LatticeMertTest_h
+#define _LatticeMertTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "LatticeMert.h"
+#include "MertLattice.h"
+#include "WordGraph.h"
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+//--------------- typedefs -------------------------------------------
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LatticeMertTest class
+
+/**
+ * @brief Class implementing tests for MertLattice and LatticeMert.
+ * The lattices have two score components and are built so that the
+ * best path changes at known points of the line w+gamma*d, with
+ * w=(1,0) and d=(0,1).
+ */
+
+class LatticeMertTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( LatticeMertTest );
+    CPPUNIT_TEST( testUpperEnvelope );
+    CPPUNIT_TEST( testObtainEnvelope );
+    CPPUNIT_TEST( testObtainEnvelopeWithPaths );
+    CPPUNIT_TEST( testLineSearch );
+    CPPUNIT_TEST( testLineSearchAtOptimum );
+    CPPUNIT_TEST( testOptimize );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        MertLattice lattice1;
+        MertLattice lattice2;
+        std::vector<std::string> refSentVec;
+        std::vector<std::vector<const MertLattice*> > latticePtrVecs;
+        std::vector<double> weightVec;
+        std::vector<double> dirVec;
+
+        MertLattice::EnvelopeLine line(double slope,
+                                       double intercept,
+                                       unsigned int idx);
+        void addArc(WordGraph& wg,
+                    HypStateIndex predStateIndex,
+                    HypStateIndex succStateIndex,
+                    const std::string& words,
+                    double h0,
+                    double h1);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testUpperEnvelope();
+        void testObtainEnvelope();
+        void testObtainEnvelopeWithPaths();
+        void testLineSearch();
+        void testLineSearchAtOptimum();
+        void testOptimize();
+};
+
+#endif
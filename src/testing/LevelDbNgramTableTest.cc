@@ -192,7 +192,9 @@ void LevelDbNgramTableTest::testStoreFloatValues()
     Count st_count = tab->cSrcTrg(s, t);
 
     CPPUNIT_ASSERT( s_count.get_c_s() == s_count_val );
-    CPPUNIT_ASSERT( st_count.get_c_st() == st_count_val );
+    // Counts are stored as binary floats, so the value obtained from
+    // the log-domain increment is not rounded
+    CPPUNIT_ASSERT( fabs(st_count.get_c_st() - st_count_val) < 1e-5 );
 }
 
 //---------------------------------------
@@ -822,3 +824,51 @@ void LevelDbNgramTableTest::testLoadedDataNullCount()
     // Check count values
     CPPUNIT_ASSERT( tab->cSrc(s3).get_c_st() == 16 );
 }
+
+//---------------------------------------
+void LevelDbNgramTableTest::testBulkLoad()
+{
+    //  TEST:
+    //    Check if bulk loading produces the same table as adding
+    //    the entries one by one, also when the entries do not fit
+    //    in the memory of the sorter
+    //
+    std::vector<WordIndex> s1;
+    s1.push_back(1000);
+    s1.push_back(2000);
+    std::vector<WordIndex> s2;
+    s2.push_back(122000);
+    std::vector<WordIndex> s3;
+    WordIndex t1 = 22000;
+    WordIndex t2 = 66000;
+
+    im_pair<Count, Count> inf;
+
+    CPPUNIT_ASSERT( tab->startBulkLoad(64) == THOT_OK );
+    inf.first = 4; inf.second = 2;
+    tab->bulkAddTableEntry(s1, t1, inf);
+    inf.first = 8; inf.second = 3;
+    tab->bulkAddTableEntry(s2, t1, inf);
+    inf.first = 5; inf.second = 1;
+    tab->bulkAddTableEntry(s1, t2, inf);
+    inf.first = 16; inf.second = 8;
+    tab->bulkAddTableEntry(s3, t2, inf);
+    CPPUNIT_ASSERT( tab->finishBulkLoad() == THOT_OK );
+
+    // Same entries as above, the last counts of s1 are kept
+    CPPUNIT_ASSERT( tab->size() == 6 );
+    CPPUNIT_ASSERT( (int) tab->cSrc(s1).get_c_s() == 5 );
+    CPPUNIT_ASSERT( (int) tab->cSrc(s3).get_c_s() == 16 );
+    CPPUNIT_ASSERT( (int) tab->cSrcTrg(s2, t1).get_c_st() == 3 );
+    CPPUNIT_ASSERT( (int) tab->cTrg(t1).get_c_s() == 5 );
+    CPPUNIT_ASSERT( (int) tab->cTrg(t2).get_c_s() == 1 );
+
+    LevelDbNgramTable::SrcTableNode node;
+    CPPUNIT_ASSERT( tab->getEntriesForTarget(t1, node) );
+    CPPUNIT_ASSERT( node.size() == 2 );
+
+    // Restored null count
+    CPPUNIT_ASSERT( tab->load(dbName.c_str()) == THOT_OK );
+    CPPUNIT_ASSERT( tab->size() == 6 );
+    CPPUNIT_ASSERT( (int) tab->cSrc(s3).get_c_s() == 16 );
+}
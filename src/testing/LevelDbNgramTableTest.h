@@ -88,6 +88,7 @@ class LevelDbNgramTableTest: public CppUnit::TestFixture
         CPPUNIT_TEST( testLoadingLevelDb );
         CPPUNIT_TEST( testLoadedDataCorrectness );
         CPPUNIT_TEST( testLoadedDataNullCount );
+        CPPUNIT_TEST( testBulkLoad );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -121,6 +122,7 @@ class LevelDbNgramTableTest: public CppUnit::TestFixture
         void testLoadingLevelDb();
         void testLoadedDataCorrectness();
         void testLoadedDataNullCount();
+        void testBulkLoad();
 };
 
 #endif
@@ -0,0 +1,298 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: LineFieldReaderTest                                      */
+/*                                                                  */
+/* Definitions file: LineFieldReaderTest.cc                         */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "LineFieldReaderTest.h"
+#include <fstream>
+#include <stdio.h>
+#include <unistd.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( LineFieldReaderTest );
+
+//---------------------------------------
+void LineFieldReaderTest::setUp()
+{
+    char tmpFileName[] = "/tmp/thot_linefieldreader_unit_test_XXXXXX";
+    int fd = mkstemp(tmpFileName);
+    CPPUNIT_ASSERT( fd != -1 );
+    close(fd);
+    fileName = tmpFileName;
+}
+
+//---------------------------------------
+void LineFieldReaderTest::tearDown()
+{
+    remove(fileName.c_str());
+}
+
+//---------------------------------------
+void LineFieldReaderTest::writeFile(const std::string& contents)
+{
+    std::ofstream outS(fileName.c_str(), std::ios::binary);
+    outS << contents;
+    outS.close();
+    CPPUNIT_ASSERT( !outS.fail() );
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testFields()
+{
+    /* TEST:
+       Lines are split into fields separated by one or more
+       separators
+    */
+    writeFile("  la casa  verde \n\nhouse\n");
+    LineFieldReader reader;
+    CPPUNIT_ASSERT( reader.open(fileName.c_str()) == THOT_OK );
+
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT_EQUAL(1, (int) reader.lineNumber());
+    CPPUNIT_ASSERT_EQUAL(3, (int) reader.numFields());
+    CPPUNIT_ASSERT_EQUAL(std::string("  la casa  verde "), reader.fieldStr(0));
+    CPPUNIT_ASSERT_EQUAL(std::string("la"), reader.fieldStr(1));
+    CPPUNIT_ASSERT_EQUAL(std::string("casa"), reader.fieldStr(2));
+    CPPUNIT_ASSERT_EQUAL(std::string("verde"), reader.fieldStr(3));
+    CPPUNIT_ASSERT_EQUAL(std::string(""), reader.fieldStr(4));
+    CPPUNIT_ASSERT( reader.fieldEquals(2, "casa") );
+    CPPUNIT_ASSERT( !reader.fieldEquals(2, "cas") );
+    CPPUNIT_ASSERT( !reader.fieldEquals(2, "casas") );
+    CPPUNIT_ASSERT( reader.fieldEquals(4, "") );
+
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT_EQUAL(0, (int) reader.numFields());
+    CPPUNIT_ASSERT_EQUAL(0, (int) reader.lineLen());
+
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT_EQUAL(std::string("house"), std::string(reader.line()));
+    CPPUNIT_ASSERT( !reader.getln() );
+    CPPUNIT_ASSERT( !reader.getln() );
+    CPPUNIT_ASSERT_EQUAL(3, (int) reader.lineNumber());
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testLastLineWithoutEndOfLine()
+{
+    /* TEST:
+       The last line is complete even if it has no end of line
+       character
+    */
+    writeFile("a b\nc d");
+    LineFieldReader reader;
+    CPPUNIT_ASSERT( reader.open(fileName.c_str()) == THOT_OK );
+
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT_EQUAL(std::string("c d"), std::string(reader.line()));
+    CPPUNIT_ASSERT_EQUAL(std::string("d"), reader.fieldStr(2));
+    CPPUNIT_ASSERT( !reader.getln() );
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testFieldSeparator()
+{
+    /* TEST:
+       Fields can be separated by characters other than blanks
+    */
+    writeFile("la casa|||the house||0.5\n");
+    LineFieldReader reader;
+    reader.setFieldSep('|');
+    CPPUNIT_ASSERT_EQUAL('|', reader.getFieldSep());
+    CPPUNIT_ASSERT( reader.open(fileName.c_str()) == THOT_OK );
+
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT_EQUAL(3, (int) reader.numFields());
+    CPPUNIT_ASSERT_EQUAL(std::string("la casa"), reader.fieldStr(1));
+    CPPUNIT_ASSERT_EQUAL(std::string("the house"), reader.fieldStr(2));
+    float f;
+    CPPUNIT_ASSERT( reader.fieldToFloat(3, f) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, f, 1e-6);
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testNumbers()
+{
+    /* TEST:
+       Fields are converted to numbers in place, the conversion fails
+       if the whole field is not a number
+    */
+    writeFile("-3 2.5e-1 12 1x 7\n");
+    LineFieldReader reader;
+    CPPUNIT_ASSERT( reader.open(fileName.c_str()) == THOT_OK );
+    CPPUNIT_ASSERT( reader.getln() );
+
+    long l;
+    unsigned long ul;
+    double d;
+    CPPUNIT_ASSERT( reader.fieldToLong(1, l) );
+    CPPUNIT_ASSERT_EQUAL(-3L, l);
+    CPPUNIT_ASSERT( reader.fieldToDouble(2, d) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25, d, 1e-12);
+    CPPUNIT_ASSERT( !reader.fieldToLong(2, l) );
+    CPPUNIT_ASSERT( reader.fieldToULong(3, ul) );
+    CPPUNIT_ASSERT_EQUAL(12UL, ul);
+    CPPUNIT_ASSERT( !reader.fieldToDouble(4, d) );
+    CPPUNIT_ASSERT( reader.fieldToLong(5, l) );
+    CPPUNIT_ASSERT_EQUAL(7L, l);
+    CPPUNIT_ASSERT( !reader.fieldToDouble(6, d) );
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testLongLines()
+{
+    /* TEST:
+       Lines longer than the blocks used to read the file, and lines
+       crossing the blocks, are returned complete
+    */
+    std::string longLine(LINE_FIELD_READER_BLOCK_SIZE + 100, 'a');
+    std::string shortLine(LINE_FIELD_READER_BLOCK_SIZE / 3, 'b');
+    writeFile(shortLine + " x\n" + shortLine + " y\n" + longLine + " z\n" + shortLine + "\n");
+    LineFieldReader reader;
+    CPPUNIT_ASSERT( reader.open(fileName.c_str()) == THOT_OK );
+
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.fieldEquals(2, "x") );
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.fieldEquals(2, "y") );
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT_EQUAL(2, (int) reader.numFields());
+    CPPUNIT_ASSERT( reader.fieldStr(1) == longLine );
+    CPPUNIT_ASSERT( reader.fieldEquals(2, "z") );
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.fieldStr(1) == shortLine );
+    CPPUNIT_ASSERT( !reader.getln() );
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testRewind()
+{
+    /* TEST:
+       Files can be read again after rewinding them
+    */
+    writeFile("a\nb\n");
+    LineFieldReader reader;
+    CPPUNIT_ASSERT( reader.rwd() == THOT_ERROR );
+    CPPUNIT_ASSERT( reader.open(fileName.c_str()) == THOT_OK );
+
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( !reader.getln() );
+    CPPUNIT_ASSERT( reader.rwd() == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL(0, (int) reader.lineNumber());
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.fieldEquals(1, "a") );
+
+    reader.close();
+    CPPUNIT_ASSERT( !reader.isOpen() );
+    CPPUNIT_ASSERT( !reader.getln() );
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testSharedStream()
+{
+    /* TEST:
+       Streams given by the caller are not read beyond the current
+       line, so that they can be shared with other readers
+    */
+    writeFile("first line\nsecond line\nthird line\n");
+    FILE* stream = fopen(fileName.c_str(), "r");
+    CPPUNIT_ASSERT( stream != NULL );
+
+    LineFieldReader reader;
+    CPPUNIT_ASSERT( reader.open_stream(stream) == THOT_OK );
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.fieldEquals(1, "first") );
+
+    char buff[64];
+    CPPUNIT_ASSERT( fgets(buff, sizeof(buff), stream) != NULL );
+    CPPUNIT_ASSERT_EQUAL(std::string("second line\n"), std::string(buff));
+
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.fieldEquals(1, "third") );
+
+        // The stream is not closed by the reader
+    reader.close();
+    CPPUNIT_ASSERT( fgets(buff, sizeof(buff), stream) == NULL );
+    fclose(stream);
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testPipe()
+{
+    /* TEST:
+       Lines can be read from streams that are not regular files
+    */
+    int fds[2];
+    CPPUNIT_ASSERT( pipe(fds) == 0 );
+    const char contents[] = "1 2\n3 4";
+    CPPUNIT_ASSERT( write(fds[1], contents, sizeof(contents) - 1) == (ssize_t) (sizeof(contents) - 1) );
+    close(fds[1]);
+    FILE* stream = fdopen(fds[0], "r");
+    CPPUNIT_ASSERT( stream != NULL );
+
+    LineFieldReader reader;
+    CPPUNIT_ASSERT( reader.open_stream(stream) == THOT_OK );
+    long l;
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.fieldToLong(2, l) );
+    CPPUNIT_ASSERT_EQUAL(2L, l);
+    CPPUNIT_ASSERT( reader.getln() );
+    CPPUNIT_ASSERT( reader.fieldToLong(2, l) );
+    CPPUNIT_ASSERT_EQUAL(4L, l);
+    CPPUNIT_ASSERT( !reader.getln() );
+    fclose(stream);
+}
+
+//---------------------------------------
+void LineFieldReaderTest::testAwkInputStream()
+{
+    /* TEST:
+       awkInputStream gives the same fields as before being based on
+       LineFieldReader
+    */
+    writeFile("1 casa 0.5\n  2   house\t 3 \n");
+    awkInputStream awk;
+    CPPUNIT_ASSERT( awk.open(fileName.c_str()) == THOT_OK );
+
+    CPPUNIT_ASSERT( awk.getln() );
+    CPPUNIT_ASSERT_EQUAL(3, (int) awk.NF);
+    CPPUNIT_ASSERT_EQUAL(1, (int) awk.FNR);
+    CPPUNIT_ASSERT_EQUAL(std::string("1 casa 0.5"), awk.dollar(0));
+    CPPUNIT_ASSERT_EQUAL(std::string("casa"), awk.dollar(2));
+    CPPUNIT_ASSERT( awk.dollarEquals(2, "casa") );
+    CPPUNIT_ASSERT_EQUAL(1, awk.dollarAtoi(1));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, awk.dollarAtof(3), 1e-12);
+    CPPUNIT_ASSERT_EQUAL(0, awk.dollarAtoi(4));
+
+    CPPUNIT_ASSERT( awk.getln() );
+    CPPUNIT_ASSERT_EQUAL(3, (int) awk.NF);
+    CPPUNIT_ASSERT_EQUAL(std::string("house\t"), awk.dollar(2));
+    CPPUNIT_ASSERT_EQUAL(3, awk.dollarAtoi(3));
+    CPPUNIT_ASSERT( !awk.getln() );
+    awk.close();
+}
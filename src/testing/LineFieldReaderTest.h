@@ -0,0 +1,99 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: LineFieldReaderTest                                      */
+/*                                                                  */
+/* Prototypes file: LineFieldReaderTest.h                           */
+/*                                                                  */
+/* Description: Declares the LineFieldReaderTest class implementing */
+/*              unit tests for the LineFieldReader class.           */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file LineFieldReaderTest.h
+ *
+ * @brief Declares the LineFieldReaderTest class implementing unit tests
+ * for the LineFieldReader class.
+ */
+
+#ifndef _LineFieldReaderTest_h
+#define _LineFieldReaderTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "LineFieldReader.h"
+#include "awkInputStream.h"
+#include <string>
+
+//--------------- Constants ------------------------------------------
+
+//--------------- typedefs -------------------------------------------
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LineFieldReaderTest class
+
+/**
+ * @brief Class implementing tests for LineFieldReader.
+ */
+
+class LineFieldReaderTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( LineFieldReaderTest );
+    CPPUNIT_TEST( testFields );
+    CPPUNIT_TEST( testLastLineWithoutEndOfLine );
+    CPPUNIT_TEST( testFieldSeparator );
+    CPPUNIT_TEST( testNumbers );
+    CPPUNIT_TEST( testLongLines );
+    CPPUNIT_TEST( testRewind );
+    CPPUNIT_TEST( testSharedStream );
+    CPPUNIT_TEST( testPipe );
+    CPPUNIT_TEST( testAwkInputStream );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        std::string fileName;
+
+        void writeFile(const std::string& contents);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testFields();
+        void testLastLineWithoutEndOfLine();
+        void testFieldSeparator();
+        void testNumbers();
+        void testLongLines();
+        void testRewind();
+        void testSharedStream();
+        void testPipe();
+        void testAwkInputStream();
+};
+
+#endif
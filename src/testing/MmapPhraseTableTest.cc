@@ -0,0 +1,462 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: MmapPhraseTableTest                                      */
+/*                                                                  */
+/* Definitions file: MmapPhraseTableTest.cc                         */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "MmapPhraseTableTest.h"
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( MmapPhraseTableTest );
+
+//--------------- CompiledMmapPhraseTable class functions
+
+//---------------------------------------
+CompiledMmapPhraseTable::CompiledMmapPhraseTable(void)
+{
+    char fileName[] = "/tmp/thot_mmappt_unit_test_XXXXXX";
+    int fd = mkstemp(fileName);
+    if(fd != -1)
+        close(fd);
+    ttableFileName = fileName;
+    binFileName = ttableFileName + ".bin";
+    compiled = false;
+}
+
+//---------------------------------------
+void CompiledMmapPhraseTable::addTableEntry(const std::vector<WordIndex>& s,
+                                            const std::vector<WordIndex>& t,
+                                            PhrasePairInfo inf)
+{
+    stlTable.addTableEntry(s, t, inf);
+    pairSet.insert(std::make_pair(s, t));
+    compiled = false;
+}
+
+//---------------------------------------
+void CompiledMmapPhraseTable::addSrcInfo(const std::vector<WordIndex>& s,
+                                         Count s_inf)
+{
+    stlTable.addSrcInfo(s, s_inf);
+    compiled = false;
+}
+
+//---------------------------------------
+void CompiledMmapPhraseTable::addSrcTrgInfo(const std::vector<WordIndex>& s,
+                                            const std::vector<WordIndex>& t,
+                                            Count st_inf)
+{
+    stlTable.addSrcTrgInfo(s, t, st_inf);
+    pairSet.insert(std::make_pair(s, t));
+    compiled = false;
+}
+
+//---------------------------------------
+void CompiledMmapPhraseTable::incrCountsOfEntry(const std::vector<WordIndex>& s,
+                                                const std::vector<WordIndex>& t,
+                                                Count c)
+{
+    stlTable.incrCountsOfEntry(s, t, c);
+    pairSet.insert(std::make_pair(s, t));
+    compiled = false;
+}
+
+//---------------------------------------
+PhrasePairInfo CompiledMmapPhraseTable::infSrcTrg(const std::vector<WordIndex>& s,
+                                                  const std::vector<WordIndex>& t,
+                                                  bool& found)
+{
+    compileIfRequired();
+    return mmapTable.infSrcTrg(s, t, found);
+}
+
+//---------------------------------------
+Count CompiledMmapPhraseTable::getSrcInfo(const std::vector<WordIndex>& s,
+                                          bool &found)
+{
+    compileIfRequired();
+    return mmapTable.getSrcInfo(s, found);
+}
+
+//---------------------------------------
+Count CompiledMmapPhraseTable::getSrcTrgInfo(const std::vector<WordIndex>& s,
+                                             const std::vector<WordIndex>& t,
+                                             bool &found)
+{
+    compileIfRequired();
+    return mmapTable.getSrcTrgInfo(s, t, found);
+}
+
+//---------------------------------------
+Prob CompiledMmapPhraseTable::pTrgGivenSrc(const std::vector<WordIndex>& s,
+                                           const std::vector<WordIndex>& t)
+{
+    compileIfRequired();
+    return mmapTable.pTrgGivenSrc(s, t);
+}
+
+//---------------------------------------
+LgProb CompiledMmapPhraseTable::logpTrgGivenSrc(const std::vector<WordIndex>& s,
+                                                const std::vector<WordIndex>& t)
+{
+    compileIfRequired();
+    return mmapTable.logpTrgGivenSrc(s, t);
+}
+
+//---------------------------------------
+Prob CompiledMmapPhraseTable::pSrcGivenTrg(const std::vector<WordIndex>& s,
+                                           const std::vector<WordIndex>& t)
+{
+    compileIfRequired();
+    return mmapTable.pSrcGivenTrg(s, t);
+}
+
+//---------------------------------------
+LgProb CompiledMmapPhraseTable::logpSrcGivenTrg(const std::vector<WordIndex>& s,
+                                                const std::vector<WordIndex>& t)
+{
+    compileIfRequired();
+    return mmapTable.logpSrcGivenTrg(s, t);
+}
+
+//---------------------------------------
+bool CompiledMmapPhraseTable::getEntriesForTarget(const std::vector<WordIndex>& t,
+                                                  SrcTableNode& srctn)
+{
+    compileIfRequired();
+    return mmapTable.getEntriesForTarget(t, srctn);
+}
+
+//---------------------------------------
+bool CompiledMmapPhraseTable::getEntriesForSource(const std::vector<WordIndex>& s,
+                                                  TrgTableNode& trgtn)
+{
+    compileIfRequired();
+    return mmapTable.getEntriesForSource(s, trgtn);
+}
+
+//---------------------------------------
+bool CompiledMmapPhraseTable::getNbestForSrc(const std::vector<WordIndex>& s,
+                                             NbestTableNode<PhraseTransTableNodeData>& nbt)
+{
+    compileIfRequired();
+    return mmapTable.getNbestForSrc(s, nbt);
+}
+
+//---------------------------------------
+bool CompiledMmapPhraseTable::getNbestForTrg(const std::vector<WordIndex>& t,
+                                             NbestTableNode<PhraseTransTableNodeData>& nbt,
+                                             int N)
+{
+    compileIfRequired();
+    return mmapTable.getNbestForTrg(t, nbt, N);
+}
+
+//---------------------------------------
+Count CompiledMmapPhraseTable::cSrcTrg(const std::vector<WordIndex>& s,
+                                       const std::vector<WordIndex>& t)
+{
+    compileIfRequired();
+    return mmapTable.cSrcTrg(s, t);
+}
+
+//---------------------------------------
+Count CompiledMmapPhraseTable::cSrc(const std::vector<WordIndex>& s)
+{
+    compileIfRequired();
+    return mmapTable.cSrc(s);
+}
+
+//---------------------------------------
+Count CompiledMmapPhraseTable::cTrg(const std::vector<WordIndex>& t)
+{
+    compileIfRequired();
+    return mmapTable.cTrg(t);
+}
+
+//---------------------------------------
+size_t CompiledMmapPhraseTable::size(void)
+{
+    compileIfRequired();
+    return mmapTable.size();
+}
+
+//---------------------------------------
+void CompiledMmapPhraseTable::clear(void)
+{
+    stlTable.clear();
+    pairSet.clear();
+    mmapTable.clear();
+    compiled = false;
+}
+
+//---------------------------------------
+void CompiledMmapPhraseTable::setWordIndices(MmapPhraseTable& mmapTable)
+{
+    for(size_t pos = 0; pos < mmapTable.getSrcVocabSize(); ++pos)
+    {
+        std::string word = mmapTable.getSrcWord(pos);
+        if(!word.empty() && isdigit(word[0]))
+            mmapTable.setSrcWordIndex(pos, atoi(word.c_str()));
+    }
+    for(size_t pos = 0; pos < mmapTable.getTrgVocabSize(); ++pos)
+    {
+        std::string word = mmapTable.getTrgWord(pos);
+        if(!word.empty() && isdigit(word[0]))
+            mmapTable.setTrgWordIndex(pos, atoi(word.c_str()));
+    }
+}
+
+//---------------------------------------
+void CompiledMmapPhraseTable::compileIfRequired(void)
+{
+    if(compiled)
+        return;
+
+    // Print table in plain text format
+    std::ofstream outS(ttableFileName.c_str());
+    std::set<std::pair<std::vector<WordIndex>,std::vector<WordIndex> > >::const_iterator iter;
+    for(iter = pairSet.begin(); iter != pairSet.end(); ++iter)
+    {
+        for(unsigned int i = 0; i < iter->first.size(); ++i)
+            outS << iter->first[i] << " ";
+        outS << "|||";
+        for(unsigned int i = 0; i < iter->second.size(); ++i)
+            outS << " " << iter->second[i];
+        outS << " ||| " << (float) stlTable.cSrc(iter->first).get_c_s();
+        outS << " " << (float) stlTable.cSrcTrg(iter->first, iter->second).get_c_st() << std::endl;
+    }
+    outS.close();
+
+    // Compile and map table
+    CPPUNIT_ASSERT( MmapPhraseTable::build(ttableFileName.c_str(), binFileName.c_str()) == THOT_OK );
+    CPPUNIT_ASSERT( mmapTable.load(binFileName.c_str()) == THOT_OK );
+    setWordIndices(mmapTable);
+    compiled = true;
+}
+
+//---------------------------------------
+CompiledMmapPhraseTable::~CompiledMmapPhraseTable()
+{
+    mmapTable.clear();
+    remove(ttableFileName.c_str());
+    remove(binFileName.c_str());
+}
+
+//--------------- MmapPhraseTableTest class functions
+
+//---------------------------------------
+void MmapPhraseTableTest::setUp()
+{
+    tabCompiled = new CompiledMmapPhraseTable();
+    tab = tabCompiled;
+}
+
+//---------------------------------------
+void MmapPhraseTableTest::tearDown()
+{
+    delete tabCompiled;  // Removes also tab
+}
+
+//---------------------------------------
+std::string MmapPhraseTableTest::tmpFileName(void)
+{
+    char fileName[] = "/tmp/thot_mmappt_unit_test_XXXXXX";
+    int fd = mkstemp(fileName);
+    CPPUNIT_ASSERT( fd != -1 );
+    close(fd);
+    return fileName;
+}
+
+//---------------------------------------
+void MmapPhraseTableTest::writeFile(const std::string& fileName,
+                                    const std::string& contents)
+{
+    std::ofstream outS(fileName.c_str(), std::ios::binary);
+    outS << contents;
+    outS.close();
+    CPPUNIT_ASSERT( !outS.fail() );
+}
+
+//---------------------------------------
+void MmapPhraseTableTest::testRepeatedEntries()
+{
+    /* TEST:
+       Repeated phrase pairs are merged before obtaining the target
+       counts, the last occurrence of each pair is kept
+    */
+    std::string ttableFileName = tmpFileName();
+    std::string binFileName = ttableFileName + ".bin";
+    writeFile(ttableFileName,
+              "1 2 ||| 7 ||| 4 3\n"
+              "3 ||| 7 ||| 2 2\n"
+              "1 2 ||| 7 ||| 5 1\n"
+              "1 2 ||| 8 9 ||| 5 4\n");
+
+    CPPUNIT_ASSERT( MmapPhraseTable::build(ttableFileName.c_str(), binFileName.c_str()) == THOT_OK );
+    MmapPhraseTable mmapTable;
+    CPPUNIT_ASSERT( mmapTable.load(binFileName.c_str()) == THOT_OK );
+    CompiledMmapPhraseTable::setWordIndices(mmapTable);
+
+    std::vector<WordIndex> s1, s2, t1, t2;
+    s1.push_back(1);
+    s1.push_back(2);
+    s2.push_back(3);
+    t1.push_back(7);
+    t2.push_back(8);
+    t2.push_back(9);
+
+    CPPUNIT_ASSERT_EQUAL(5, (int) mmapTable.cSrc(s1).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(2, (int) mmapTable.cSrc(s2).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(1, (int) mmapTable.cSrcTrg(s1, t1).get_c_st());
+    CPPUNIT_ASSERT_EQUAL(4, (int) mmapTable.cSrcTrg(s1, t2).get_c_st());
+    CPPUNIT_ASSERT_EQUAL(1 + 2, (int) mmapTable.cTrg(t1).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(4, (int) mmapTable.cTrg(t2).get_c_s());
+    CPPUNIT_ASSERT_EQUAL(2 + 2 + 3, (int) mmapTable.size());
+
+    BasePhraseTable::SrcTableNode node;
+    CPPUNIT_ASSERT( mmapTable.getEntriesForTarget(t1, node) );
+    CPPUNIT_ASSERT_EQUAL(2, (int) node.size());
+
+    mmapTable.clear();
+    remove(ttableFileName.c_str());
+    remove(binFileName.c_str());
+}
+
+//---------------------------------------
+void MmapPhraseTableTest::testReadOnly()
+{
+    /* TEST:
+       Updates of mapped tables are ignored
+    */
+    std::vector<WordIndex> s = getVector("Narie lake");
+    std::vector<WordIndex> t = getVector("jezioro Narie");
+
+    tab->incrCountsOfEntry(s, t, Count(2));
+    CPPUNIT_ASSERT_EQUAL(2, (int) tab->cSrcTrg(s, t).get_c_st());
+
+    std::string ttableFileName = tmpFileName();
+    std::string binFileName = ttableFileName + ".bin";
+    writeFile(ttableFileName, "1 ||| 2 ||| 3 3\n");
+    CPPUNIT_ASSERT( MmapPhraseTable::build(ttableFileName.c_str(), binFileName.c_str()) == THOT_OK );
+    MmapPhraseTable mmapTable;
+    CPPUNIT_ASSERT( mmapTable.load(binFileName.c_str()) == THOT_OK );
+    CompiledMmapPhraseTable::setWordIndices(mmapTable);
+
+    std::vector<WordIndex> s1(1, 1);
+    std::vector<WordIndex> t1(1, 2);
+    mmapTable.incrCountsOfEntry(s1, t1, Count(5));
+    mmapTable.addTableEntry(s, t, PhrasePairInfo(Count(1), Count(1)));
+    CPPUNIT_ASSERT_EQUAL(3, (int) mmapTable.cSrcTrg(s1, t1).get_c_st());
+    CPPUNIT_ASSERT_EQUAL(0, (int) mmapTable.cSrcTrg(s, t).get_c_st());
+    CPPUNIT_ASSERT_EQUAL(3, (int) mmapTable.size());
+
+    mmapTable.clear();
+    remove(ttableFileName.c_str());
+    remove(binFileName.c_str());
+}
+
+//---------------------------------------
+void MmapPhraseTableTest::testInvalidFiles()
+{
+    /* TEST:
+       Truncated or corrupted binary files are rejected
+    */
+    std::string ttableFileName = tmpFileName();
+    std::string binFileName = ttableFileName + ".bin";
+    writeFile(ttableFileName,
+              "1 2 ||| 7 ||| 4 3\n"
+              "3 ||| 8 9 ||| 2 2\n");
+    CPPUNIT_ASSERT( MmapPhraseTable::build(ttableFileName.c_str(), binFileName.c_str()) == THOT_OK );
+
+    std::ifstream inS(binFileName.c_str(), std::ios::binary);
+    std::stringstream ss;
+    ss << inS.rdbuf();
+    inS.close();
+    std::string contents = ss.str();
+
+    MmapPhraseTable mmapTable;
+    CPPUNIT_ASSERT( mmapTable.load(binFileName.c_str()) == THOT_OK );
+
+    // Truncated file
+    writeFile(binFileName, contents.substr(0, contents.size() - 8));
+    CPPUNIT_ASSERT( mmapTable.load(binFileName.c_str()) == THOT_ERROR );
+    CPPUNIT_ASSERT_EQUAL(0, (int) mmapTable.size());
+
+    // Unknown format version
+    std::string corrupted = contents;
+    corrupted[8] = (char) (MMAP_PT_FORMAT_VERSION + 1);
+    writeFile(binFileName, corrupted);
+    CPPUNIT_ASSERT( mmapTable.load(binFileName.c_str()) == THOT_ERROR );
+
+    // The number of entries given in the header (its last field)
+    // makes the size of the arrays overflow
+    corrupted = contents;
+    unsigned long long numEntries = 0x2000000000000001ULL;
+    size_t headerSize = 16 + 9 * sizeof(unsigned long long);
+    memcpy(&corrupted[headerSize - sizeof(unsigned long long)], &numEntries, sizeof(numEntries));
+    writeFile(binFileName, corrupted);
+    CPPUNIT_ASSERT( mmapTable.load(binFileName.c_str()) == THOT_ERROR );
+
+    // Inconsistent offsets
+    corrupted = contents;
+    numEntries = 1;
+    memcpy(&corrupted[headerSize - sizeof(unsigned long long)], &numEntries, sizeof(numEntries));
+    writeFile(binFileName, corrupted);
+    CPPUNIT_ASSERT( mmapTable.load(binFileName.c_str()) == THOT_ERROR );
+
+    remove(ttableFileName.c_str());
+    remove(binFileName.c_str());
+}
+
+//---------------------------------------
+void MmapPhraseTableTest::testModelRequiresBinary()
+{
+    /* TEST:
+       Loading a model does not compile its translation table, the
+       binary file has to be obtained explicitly
+    */
+    std::string ttableFileName = tmpFileName();
+    std::string binFileName = ttableFileName + MMAP_PT_FILE_EXT;
+    writeFile(ttableFileName, "casa ||| house ||| 2 2\n");
+
+    MmapPhraseModel model;
+    CPPUNIT_ASSERT( model.load_ttable(ttableFileName.c_str()) == THOT_ERROR );
+    CPPUNIT_ASSERT( access(binFileName.c_str(), F_OK) != 0 );
+
+    CPPUNIT_ASSERT( MmapPhraseTable::build(ttableFileName.c_str(), binFileName.c_str()) == THOT_OK );
+    CPPUNIT_ASSERT( model.load_ttable(ttableFileName.c_str()) == THOT_OK );
+
+    model.clear();
+    remove(ttableFileName.c_str());
+    remove(binFileName.c_str());
+}
@@ -0,0 +1,187 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: MmapPhraseTableTest                                      */
+/*                                                                  */
+/* Prototypes file: MmapPhraseTableTest.h                           */
+/*                                                                  */
+/* Description: Declares the MmapPhraseTableTest class implementing */
+/*              unit tests for the MmapPhraseTable class.           */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file MmapPhraseTableTest.h
+ *
+ * @brief Declares the MmapPhraseTableTest class implementing unit tests
+ * for the MmapPhraseTable class.
+ */
+
+#ifndef _MmapPhraseTableTest_h
+#define _MmapPhraseTableTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "_phraseTableTest.h"
+#include "MmapPhraseTable.h"
+#include "MmapPhraseModel.h"
+#include "StlPhraseTable.h"
+#include <set>
+
+//--------------- Constants ------------------------------------------
+
+//--------------- typedefs -------------------------------------------
+
+//--------------- Classes --------------------------------------------
+
+//--------------- CompiledMmapPhraseTable class
+
+/**
+ * @brief Phrase table used to run the common phrase table tests on
+ * MmapPhraseTable, which is read-only. The updates are applied to a
+ * StlPhraseTable, which is printed in plain text format, compiled
+ * into a binary file and mapped before the next query. Words are
+ * printed as their word indices.
+ */
+
+class CompiledMmapPhraseTable: public BasePhraseTable
+{
+    public:
+        CompiledMmapPhraseTable(void);
+
+        void addTableEntry(const std::vector<WordIndex>& s,
+                           const std::vector<WordIndex>& t,
+                           PhrasePairInfo inf);
+        void addSrcInfo(const std::vector<WordIndex>& s, Count s_inf);
+        void addSrcTrgInfo(const std::vector<WordIndex>& s,
+                           const std::vector<WordIndex>& t,
+                           Count st_inf);
+        void incrCountsOfEntry(const std::vector<WordIndex>& s,
+                               const std::vector<WordIndex>& t,
+                               Count c);
+
+        PhrasePairInfo infSrcTrg(const std::vector<WordIndex>& s,
+                                 const std::vector<WordIndex>& t,
+                                 bool& found);
+        Count getSrcInfo(const std::vector<WordIndex>& s, bool &found);
+        Count getSrcTrgInfo(const std::vector<WordIndex>& s,
+                            const std::vector<WordIndex>& t,
+                            bool &found);
+        Prob pTrgGivenSrc(const std::vector<WordIndex>& s,
+                          const std::vector<WordIndex>& t);
+        LgProb logpTrgGivenSrc(const std::vector<WordIndex>& s,
+                               const std::vector<WordIndex>& t);
+        Prob pSrcGivenTrg(const std::vector<WordIndex>& s,
+                          const std::vector<WordIndex>& t);
+        LgProb logpSrcGivenTrg(const std::vector<WordIndex>& s,
+                               const std::vector<WordIndex>& t);
+        bool getEntriesForTarget(const std::vector<WordIndex>& t,
+                                 SrcTableNode& srctn);
+        bool getEntriesForSource(const std::vector<WordIndex>& s,
+                                 TrgTableNode& trgtn);
+        bool getNbestForSrc(const std::vector<WordIndex>& s,
+                            NbestTableNode<PhraseTransTableNodeData>& nbt);
+        bool getNbestForTrg(const std::vector<WordIndex>& t,
+                            NbestTableNode<PhraseTransTableNodeData>& nbt,
+                            int N=-1);
+        Count cSrcTrg(const std::vector<WordIndex>& s,
+                      const std::vector<WordIndex>& t);
+        Count cSrc(const std::vector<WordIndex>& s);
+        Count cTrg(const std::vector<WordIndex>& t);
+
+        size_t size(void);
+        void clear(void);
+
+        static void setWordIndices(MmapPhraseTable& mmapTable);
+            // Sets the word index of the words of the mapped table that
+            // are numbers to their value
+
+        ~CompiledMmapPhraseTable();
+
+    protected:
+        StlPhraseTable stlTable;
+        std::set<std::pair<std::vector<WordIndex>,std::vector<WordIndex> > > pairSet;
+        MmapPhraseTable mmapTable;
+        bool compiled;
+        std::string ttableFileName;
+        std::string binFileName;
+
+        void compileIfRequired(void);
+};
+
+//--------------- MmapPhraseTableTest class
+
+/**
+ * @brief Class implementing tests for MmapPhraseTable. The common
+ * tests are run on a CompiledMmapPhraseTable object (except those
+ * storing source phrases without entries or word indices greater than
+ * the size of the vocabulary, which cannot be represented by a
+ * compiled table, and testAddSrcTrgInfo, which checks an uninitialized
+ * flag).
+ */
+
+class MmapPhraseTableTest: public _phraseTableTest
+{
+    CPPUNIT_TEST_SUITE( MmapPhraseTableTest );
+    CPPUNIT_TEST( testAddTableEntry );
+    CPPUNIT_TEST( testIncCountsOfEntry );
+    CPPUNIT_TEST( testGetEntriesForTarget );
+    CPPUNIT_TEST( testRetrievingSubphrase );
+    CPPUNIT_TEST( testRetrieveNonLeafPhrase );
+    CPPUNIT_TEST( testGetEntriesForSource );
+    CPPUNIT_TEST( testRetrievingEntriesWithCountEqualZero );
+    CPPUNIT_TEST( testGetNbestForTrg );
+    CPPUNIT_TEST( testPSrcGivenTrg );
+    CPPUNIT_TEST( testPTrgGivenSrc );
+    CPPUNIT_TEST( testAddingSameSrcAndTrg );
+    CPPUNIT_TEST( testSize );
+    CPPUNIT_TEST( testSubkeys );
+    CPPUNIT_TEST( testByteMax );
+    CPPUNIT_TEST( testByteMin );
+    CPPUNIT_TEST( testRepeatedEntries );
+    CPPUNIT_TEST( testReadOnly );
+    CPPUNIT_TEST( testInvalidFiles );
+    CPPUNIT_TEST( testModelRequiresBinary );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        CompiledMmapPhraseTable* tabCompiled;
+
+        std::string tmpFileName(void);
+        void writeFile(const std::string& fileName,
+                       const std::string& contents);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testRepeatedEntries();
+        void testReadOnly();
+        void testInvalidFiles();
+        void testModelRequiresBinary();
+};
+
+#endif
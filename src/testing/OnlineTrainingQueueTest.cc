@@ -0,0 +1,307 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: OnlineTrainingQueueTest                                  */
+/*                                                                  */
+/* Definitions file: OnlineTrainingQueueTest.cc                     */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "OnlineTrainingQueueTest.h"
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( OnlineTrainingQueueTest );
+
+//---------------------------------------
+void OnlineTrainingQueueTest::setUp()
+{
+    char tmpDirName[] = "/tmp/thot_otqueue_unit_test_XXXXXX";
+    CPPUNIT_ASSERT( mkdtemp(tmpDirName) != NULL );
+    dirName = tmpDirName;
+    journalFileName = dirName + "/journal";
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::tearDown()
+{
+    remove(journalFileName.c_str());
+    remove((journalFileName + ".tmp").c_str());
+    rmdir(dirName.c_str());
+}
+
+//---------------------------------------
+std::vector<std::string> OnlineTrainingQueueTest::readJournal()
+{
+    std::vector<std::string> lines;
+    std::ifstream inS(journalFileName.c_str());
+    std::string line;
+    while(std::getline(inS, line))
+        lines.push_back(line);
+    return lines;
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::writeJournal(const std::string& contents)
+{
+    std::ofstream outS(journalFileName.c_str(), std::ios::binary);
+    outS << contents;
+    outS.close();
+    CPPUNIT_ASSERT( !outS.fail() );
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::testPushAndTakeBatch()
+{
+    /* TEST:
+       Pairs are taken in the order in which they were pushed, in
+       batches of the given maximum size
+    */
+    OnlineTrainingQueue queue;
+    CPPUNIT_ASSERT( !queue.isOpen() );
+    CPPUNIT_ASSERT( queue.push(1, "a", "A") == THOT_ERROR );
+
+    CPPUNIT_ASSERT( queue.open("") == THOT_OK );
+    CPPUNIT_ASSERT( queue.isOpen() );
+    CPPUNIT_ASSERT( queue.open("") == THOT_ERROR );
+    CPPUNIT_ASSERT( queue.push(1, "a\tb", "A\nB") == THOT_OK );
+    CPPUNIT_ASSERT( queue.push(2, "c", "C") == THOT_OK );
+    CPPUNIT_ASSERT( queue.push(3, "d", "D") == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL(3, (int) queue.depth());
+
+    std::vector<OnlineTrainingQueueEntry> batch;
+    CPPUNIT_ASSERT( queue.takeBatch(2, batch) );
+    CPPUNIT_ASSERT_EQUAL(2, (int) batch.size());
+    CPPUNIT_ASSERT_EQUAL(1, batch[0].user_id);
+    CPPUNIT_ASSERT_EQUAL(std::string("a b"), batch[0].srcSent);
+    CPPUNIT_ASSERT_EQUAL(std::string("A B"), batch[0].refSent);
+    CPPUNIT_ASSERT_EQUAL(2, batch[1].user_id);
+    CPPUNIT_ASSERT_EQUAL(1, (int) queue.depth());
+    CPPUNIT_ASSERT( queue.batchDone(batch, 0) == THOT_OK );
+
+    CPPUNIT_ASSERT( queue.takeBatch(0, batch) );
+    CPPUNIT_ASSERT_EQUAL(1, (int) batch.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("d"), batch[0].srcSent);
+    CPPUNIT_ASSERT_EQUAL(0, (int) queue.depth());
+    CPPUNIT_ASSERT( queue.batchDone(batch, 0) == THOT_OK );
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::testClose()
+{
+    /* TEST:
+       Once the queue is closed, no pairs are accepted, the pending ones
+       can still be taken and takeBatch() returns false without waiting
+       when there are no more pairs
+    */
+    OnlineTrainingQueue queue;
+    CPPUNIT_ASSERT( queue.open("") == THOT_OK );
+    CPPUNIT_ASSERT( queue.push(1, "a", "A") == THOT_OK );
+    queue.close();
+    CPPUNIT_ASSERT( !queue.isOpen() );
+    CPPUNIT_ASSERT( queue.push(2, "b", "B") == THOT_ERROR );
+
+    std::vector<OnlineTrainingQueueEntry> batch;
+    CPPUNIT_ASSERT( queue.takeBatch(0, batch) );
+    CPPUNIT_ASSERT_EQUAL(1, (int) batch.size());
+    CPPUNIT_ASSERT( queue.batchDone(batch, 0) == THOT_OK );
+    CPPUNIT_ASSERT( !queue.takeBatch(0, batch) );
+    CPPUNIT_ASSERT( batch.empty() );
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::testPrintJson()
+{
+    /* TEST:
+       The statistics count the pairs in each state
+    */
+    OnlineTrainingQueue queue;
+    std::ostringstream outS;
+    queue.printJson(outS);
+    CPPUNIT_ASSERT( outS.str().find("\"async\": false") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"oldest_pending_secs\": null") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"lag_secs\": {\"last\": null") != std::string::npos );
+
+    CPPUNIT_ASSERT( queue.open("") == THOT_OK );
+    for(int i = 0; i < 4; ++i)
+        CPPUNIT_ASSERT( queue.push(i, "a", "A") == THOT_OK );
+    std::vector<OnlineTrainingQueueEntry> batch;
+    CPPUNIT_ASSERT( queue.takeBatch(3, batch) );
+
+    outS.str("");
+    queue.printJson(outS);
+    CPPUNIT_ASSERT( outS.str().find("\"async\": true") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"depth\": 1,") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"in_progress\": 3,") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"enqueued\": 4,") != std::string::npos );
+
+    CPPUNIT_ASSERT( queue.batchDone(batch, 1) == THOT_OK );
+    outS.str("");
+    queue.printJson(outS);
+    CPPUNIT_ASSERT( outS.str().find("\"in_progress\": 0,") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"trained\": 2,") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"failed\": 1,") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"batches\": 1,") != std::string::npos );
+    CPPUNIT_ASSERT( outS.str().find("\"lag_secs\": {\"last\": null") == std::string::npos );
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::testJournalReplay()
+{
+    /* TEST:
+       Pairs that were pending or being trained when the queue was
+       destroyed are loaded again, trained ones are not
+    */
+    {
+        OnlineTrainingQueue queue;
+        CPPUNIT_ASSERT( queue.open(journalFileName) == THOT_OK );
+        CPPUNIT_ASSERT( queue.push(1, "a", "A") == THOT_OK );
+        CPPUNIT_ASSERT( queue.push(2, "b", "B") == THOT_OK );
+        CPPUNIT_ASSERT( queue.push(3, "c", "C") == THOT_OK );
+        std::vector<OnlineTrainingQueueEntry> batch;
+        CPPUNIT_ASSERT( queue.takeBatch(1, batch) );
+        CPPUNIT_ASSERT( queue.batchDone(batch, 0) == THOT_OK );
+
+            // Pairs are appended to the journal before push() returns,
+            // trained pairs are recorded when their batch is done
+        std::vector<std::string> lines = readJournal();
+        CPPUNIT_ASSERT_EQUAL(4, (int) lines.size());
+        CPPUNIT_ASSERT_EQUAL(std::string("1\ta\tA"), lines[0]);
+        CPPUNIT_ASSERT_EQUAL(std::string("3\tc\tC"), lines[2]);
+        CPPUNIT_ASSERT_EQUAL(std::string("done\t1"), lines[3]);
+
+            // The batch being trained is not finished
+        CPPUNIT_ASSERT( queue.takeBatch(1, batch) );
+        CPPUNIT_ASSERT_EQUAL(std::string("b"), batch[0].srcSent);
+    }
+
+    OnlineTrainingQueue queue;
+    CPPUNIT_ASSERT( queue.open(journalFileName) == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL(2, (int) queue.depth());
+    std::vector<std::string> lines = readJournal();
+    CPPUNIT_ASSERT_EQUAL(2, (int) lines.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("2\tb\tB"), lines[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("3\tc\tC"), lines[1]);
+
+    std::vector<OnlineTrainingQueueEntry> batch;
+    CPPUNIT_ASSERT( queue.takeBatch(0, batch) );
+    CPPUNIT_ASSERT_EQUAL(2, (int) batch.size());
+    CPPUNIT_ASSERT_EQUAL(2, batch[0].user_id);
+    CPPUNIT_ASSERT_EQUAL(std::string("B"), batch[0].refSent);
+    CPPUNIT_ASSERT_EQUAL(3, batch[1].user_id);
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::testLoadJournal()
+{
+    /* TEST:
+       Malformed lines are discarded and records of trained pairs
+       remove the oldest ones
+    */
+    writeJournal("1\ta\tA\n2\tb\tB\ndone\t1\nmalformed\n3\tc\tC\n4\td\tD\ndone\t2\n5\te\tE\n");
+    OnlineTrainingQueue queue;
+    CPPUNIT_ASSERT( queue.open(journalFileName) == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL(2, (int) queue.depth());
+    std::vector<OnlineTrainingQueueEntry> batch;
+    CPPUNIT_ASSERT( queue.takeBatch(0, batch) );
+    CPPUNIT_ASSERT_EQUAL(4, batch[0].user_id);
+    CPPUNIT_ASSERT_EQUAL(5, batch[1].user_id);
+
+        // Records referring to more pairs than those stored empty the
+        // queue
+    writeJournal("1\ta\tA\ndone\t5\n2\tb\tB\n");
+    OnlineTrainingQueue queue2;
+    CPPUNIT_ASSERT( queue2.open(journalFileName) == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL(1, (int) queue2.depth());
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::testJournalCompaction()
+{
+    /* TEST:
+       The journal is rewritten with the pending pairs once enough pairs
+       have been trained
+    */
+    OnlineTrainingQueue queue;
+    CPPUNIT_ASSERT( queue.open(journalFileName) == THOT_OK );
+    for(int i = 0; i < OTQ_JOURNAL_REWRITE_INTERVAL; ++i)
+        CPPUNIT_ASSERT( queue.push(i, "a", "A") == THOT_OK );
+
+    std::vector<OnlineTrainingQueueEntry> batch;
+    CPPUNIT_ASSERT( queue.takeBatch(OTQ_JOURNAL_REWRITE_INTERVAL - 1, batch) );
+    CPPUNIT_ASSERT( queue.batchDone(batch, 0) == THOT_OK );
+    CPPUNIT_ASSERT_EQUAL(OTQ_JOURNAL_REWRITE_INTERVAL + 1, (int) readJournal().size());
+
+    CPPUNIT_ASSERT( queue.push(OTQ_JOURNAL_REWRITE_INTERVAL, "b", "B") == THOT_OK );
+    CPPUNIT_ASSERT( queue.takeBatch(1, batch) );
+    CPPUNIT_ASSERT( queue.batchDone(batch, 0) == THOT_OK );
+    std::vector<std::string> lines = readJournal();
+    CPPUNIT_ASSERT_EQUAL(1, (int) lines.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("256\tb\tB"), lines[0]);
+
+        // New pairs are appended to the rewritten journal
+    CPPUNIT_ASSERT( queue.push(7, "c", "C") == THOT_OK );
+    lines = readJournal();
+    CPPUNIT_ASSERT_EQUAL(2, (int) lines.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("7\tc\tC"), lines[1]);
+}
+
+//---------------------------------------
+void OnlineTrainingQueueTest::testUnusableJournal()
+{
+    /* TEST:
+       If the journal cannot be written, batchDone() reports it and
+       push() fails until the journal can be rewritten
+    */
+    OnlineTrainingQueue queue;
+    CPPUNIT_ASSERT( queue.open(dirName + "/missing/journal") == THOT_ERROR );
+    CPPUNIT_ASSERT( !queue.isOpen() );
+
+    CPPUNIT_ASSERT( queue.open(journalFileName) == THOT_OK );
+    for(int i = 0; i <= OTQ_JOURNAL_REWRITE_INTERVAL; ++i)
+        CPPUNIT_ASSERT( queue.push(i, "a", "A") == THOT_OK );
+
+        // The journal cannot be rewritten once its directory is removed
+    CPPUNIT_ASSERT( remove(journalFileName.c_str()) == 0 );
+    CPPUNIT_ASSERT( rmdir(dirName.c_str()) == 0 );
+    std::vector<OnlineTrainingQueueEntry> batch;
+    CPPUNIT_ASSERT( queue.takeBatch(OTQ_JOURNAL_REWRITE_INTERVAL, batch) );
+    CPPUNIT_ASSERT( queue.batchDone(batch, 0) == THOT_ERROR );
+    CPPUNIT_ASSERT( queue.push(1000, "b", "B") == THOT_ERROR );
+    CPPUNIT_ASSERT_EQUAL(1, (int) queue.depth());
+
+        // Once the directory exists again, the journal is rewritten
+        // with the pending pairs before accepting new ones
+    CPPUNIT_ASSERT( mkdir(dirName.c_str(), 0700) == 0 );
+    CPPUNIT_ASSERT( queue.push(1000, "b", "B") == THOT_OK );
+    std::vector<std::string> lines = readJournal();
+    CPPUNIT_ASSERT_EQUAL(2, (int) lines.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("256\ta\tA"), lines[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("1000\tb\tB"), lines[1]);
+    CPPUNIT_ASSERT_EQUAL(2, (int) queue.depth());
+}
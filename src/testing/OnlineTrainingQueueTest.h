@@ -0,0 +1,98 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: OnlineTrainingQueueTest                                  */
+/*                                                                  */
+/* Prototypes file: OnlineTrainingQueueTest.h                       */
+/*                                                                  */
+/* Description: Declares the OnlineTrainingQueueTest class          */
+/*              implementing unit tests for the OnlineTrainingQueue */
+/*              class.                                              */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file OnlineTrainingQueueTest.h
+ *
+ * @brief Declares the OnlineTrainingQueueTest class implementing unit
+ * tests for the OnlineTrainingQueue class.
+ */
+
+#ifndef _OnlineTrainingQueueTest_h
+#define _OnlineTrainingQueueTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "OnlineTrainingQueue.h"
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+//--------------- typedefs -------------------------------------------
+
+//--------------- Classes --------------------------------------------
+
+//--------------- OnlineTrainingQueueTest class
+
+/**
+ * @brief Class implementing tests for OnlineTrainingQueue.
+ */
+
+class OnlineTrainingQueueTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( OnlineTrainingQueueTest );
+    CPPUNIT_TEST( testPushAndTakeBatch );
+    CPPUNIT_TEST( testClose );
+    CPPUNIT_TEST( testPrintJson );
+    CPPUNIT_TEST( testJournalReplay );
+    CPPUNIT_TEST( testLoadJournal );
+    CPPUNIT_TEST( testJournalCompaction );
+    CPPUNIT_TEST( testUnusableJournal );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        std::string dirName;
+        std::string journalFileName;
+
+        std::vector<std::string> readJournal();
+        void writeJournal(const std::string& contents);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testPushAndTakeBatch();
+        void testClose();
+        void testPrintJson();
+        void testJournalReplay();
+        void testLoadJournal();
+        void testJournalCompaction();
+        void testUnusableJournal();
+};
+
+#endif
@@ -0,0 +1,195 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: WgProcessorForAnlpTest                                   */
+/*                                                                  */
+/* Definitions file: WgProcessorForAnlpTest.cc                      */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "WgProcessorForAnlpTest.h"
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( WgProcessorForAnlpTest );
+
+//--------------- Constants
+
+#define WGPT_NBEST_SIZE   3
+#define WGPT_BEAM_WIDTH   4
+
+//--------------- WgProcessorForAnlpTest class functions
+//
+
+//---------------------------------------
+void WgProcessorForAnlpTest::setUp()
+{
+    // Arcs are added in topological order
+    std::vector<std::string> words;
+    words.push_back("the");
+    wg.addArc(0,1,words,-1.0);
+    words[0]="a";
+    wg.addArc(0,1,words,-1.5);
+    words[0]="this";
+    wg.addArc(0,2,words,-2.0);
+    words[0]="house";
+    wg.addArc(1,3,words,-0.5);
+    words[0]="home";
+    wg.addArc(1,3,words,-1.0);
+    words[0]="hose";
+    wg.addArc(1,3,words,-2.0);
+    words[0]="house";
+    words.push_back("is");
+    wg.addArc(2,4,words,-1.0);
+    words[0]="is";
+    words[1]="green";
+    wg.addArc(3,4,words,-0.7);
+    words[1]="red";
+    wg.addArc(3,4,words,-0.9);
+    words[0]="was";
+    words[1]="green";
+    wg.addArc(3,4,words,-1.2);
+    words.clear();
+    words.push_back("today");
+    wg.addArc(4,5,words,-0.3);
+    wg.addFinalState(4);
+    wg.addFinalState(5);
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::tearDown()
+{
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::initWgp(WgProcessorForAnlp<PfsmEcmForWg>& wgp,
+                                     float beamWidth)
+{
+    wgp.link_wg(&wg);
+    CPPUNIT_ASSERT(wgp.link_ecm_wg(&ecm));
+    wgp.set_beam(beamWidth);
+    wgp.set_wgw(1);
+    wgp.set_ecmw(1);
+}
+
+//---------------------------------------
+std::vector<std::string> WgProcessorForAnlpTest::typePrefix(const std::string& prefix)
+{
+    std::vector<std::string> prefixVec;
+    for(unsigned int i=1;i<=prefix.size();++i)
+        prefixVec.push_back(prefix.substr(0,i));
+    return prefixVec;
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::checkPrefixes(const std::vector<std::string>& prefixVec,
+                                           float beamWidth)
+{
+    RejectedWordsSet rejectedWords;
+    WgProcessorForAnlp<PfsmEcmForWg> wgp;
+    initWgp(wgp,beamWidth);
+
+    for(unsigned int i=0;i<prefixVec.size();++i)
+    {
+        // The weights are set before each keystroke, as done by the
+        // assisted translators
+        wgp.set_wgw(1);
+        wgp.set_ecmw(1);
+        NbestCorrections corrs=wgp.correct(prefixVec[i],WGPT_NBEST_SIZE,rejectedWords);
+
+        WgProcessorForAnlp<PfsmEcmForWg> newWgp;
+        initWgp(newWgp,beamWidth);
+        NbestCorrections refCorrs=newWgp.correct(prefixVec[i],WGPT_NBEST_SIZE,rejectedWords);
+
+        CPPUNIT_ASSERT(!corrs.empty());
+        CPPUNIT_ASSERT(corrs.size()==refCorrs.size());
+        NbestCorrections::const_iterator iter=corrs.begin();
+        NbestCorrections::const_iterator refIter=refCorrs.begin();
+        for(;iter!=corrs.end();++iter,++refIter)
+        {
+            CPPUNIT_ASSERT(iter->first==refIter->first);
+            CPPUNIT_ASSERT(iter->second==refIter->second);
+        }
+    }
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::testTyping()
+{
+    checkPrefixes(typePrefix("the hose is red today"),WGP_UNLIMITED_BEAM);
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::testBackspaces()
+{
+    // Characters of the last word are deleted and retyped, also after
+    // completing it
+    std::vector<std::string> prefixVec=typePrefix("the hou");
+    prefixVec.push_back("the ho");
+    prefixVec.push_back("the h");
+    prefixVec.push_back("the ho");
+    prefixVec.push_back("the hos");
+    prefixVec.push_back("the hose");
+    prefixVec.push_back("the hose ");
+    prefixVec.push_back("the hose");
+    prefixVec.push_back("the hos");
+    prefixVec.push_back("the hose");
+    prefixVec.push_back("the hose ");
+    prefixVec.push_back("the hose i");
+    prefixVec.push_back("the hose ");
+    prefixVec.push_back("the hose");
+    prefixVec.push_back("the hos");
+    prefixVec.push_back("the ho");
+    prefixVec.push_back("the hou");
+    checkPrefixes(prefixVec,WGP_UNLIMITED_BEAM);
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::testWordDeletion()
+{
+    // Several words are deleted or replaced at once
+    std::vector<std::string> prefixVec=typePrefix("the home is gr");
+    prefixVec.push_back("the ho");
+    prefixVec.push_back("the hou");
+    prefixVec.push_back("a hou");
+    prefixVec.push_back("a ho");
+    prefixVec.push_back("this house i");
+    prefixVec.push_back("th");
+    prefixVec.push_back("the house was");
+    prefixVec.push_back("the house wa");
+    checkPrefixes(prefixVec,WGP_UNLIMITED_BEAM);
+}
+
+//---------------------------------------
+void WgProcessorForAnlpTest::testBackspacesWithBeam()
+{
+    std::vector<std::string> prefixVec=typePrefix("a hou");
+    prefixVec.push_back("a ho");
+    prefixVec.push_back("a hom");
+    prefixVec.push_back("a ho");
+    prefixVec.push_back("a home is");
+    prefixVec.push_back("a home i");
+    prefixVec.push_back("a home");
+    prefixVec.push_back("a home ");
+    prefixVec.push_back("a home w");
+    checkPrefixes(prefixVec,WGPT_BEAM_WIDTH);
+}
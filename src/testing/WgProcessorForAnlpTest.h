@@ -0,0 +1,105 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: WgProcessorForAnlpTest                                   */
+/*                                                                  */
+/* Prototypes file: WgProcessorForAnlpTest.h                        */
+/*                                                                  */
+/* Description: Declares the WgProcessorForAnlpTest class           */
+/*              implementing unit tests for the WgProcessorForAnlp  */
+/*              class.                                              */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file WgProcessorForAnlpTest.h
+ *
+ * @brief Declares the WgProcessorForAnlpTest class implementing unit
+ * tests for the WgProcessorForAnlp class.
+ */
+
+#ifndef _WgProcessorForAnlpTest_h
+#define _WgProcessorForAnlpTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WgProcessorForAnlp.h"
+#include "PfsmEcmForWg.h"
+#include "WordGraph.h"
+#include <cppunit/extensions/HelperMacros.h>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- typedefs -------------------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WgProcessorForAnlpTest class
+
+/**
+ * @brief Class implementing tests for WgProcessorForAnlp. The
+ * corrections obtained by a processor that is reused across keystrokes
+ * (which restores cached positions) are compared with the ones obtained
+ * by a new processor for each prefix.
+ */
+
+class WgProcessorForAnlpTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( WgProcessorForAnlpTest );
+    CPPUNIT_TEST( testTyping );
+    CPPUNIT_TEST( testBackspaces );
+    CPPUNIT_TEST( testWordDeletion );
+    CPPUNIT_TEST( testBackspacesWithBeam );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        WordGraph wg;
+        PfsmEcmForWg ecm;
+
+        void initWgp(WgProcessorForAnlp<PfsmEcmForWg>& wgp,
+                     float beamWidth);
+        void checkPrefixes(const std::vector<std::string>& prefixVec,
+                           float beamWidth);
+            // Checks that the same corrections are obtained with and
+            // without reusing the processor for the given sequence of
+            // prefixes
+        std::vector<std::string> typePrefix(const std::string& prefix);
+            // Returns the prefixes generated when typing the given
+            // string character by character
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testTyping();
+        void testBackspaces();
+        void testWordDeletion();
+        void testBackspacesWithBeam();
+};
+
+#endif
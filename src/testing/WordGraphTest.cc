@@ -0,0 +1,204 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: WordGraphTest                                            */
+/*                                                                  */
+/* Definitions file: WordGraphTest.cc                               */
+/*                                                                  */
+/********************************************************************/
+
+
+//--------------- Include files --------------------------------------
+
+#include "WordGraphTest.h"
+#include "StrProcUtils.h"
+#include <algorithm>
+#include <functional>
+
+// Registers the fixture into the 'registry'
+CPPUNIT_TEST_SUITE_REGISTRATION( WordGraphTest );
+
+//--------------- Constants ------------------------------------------
+
+#define WG_TEST_EPSILON   1e-9
+
+//--------------- WordGraphTest class functions
+//
+
+//---------------------------------------
+void WordGraphTest::setUp()
+{
+    // Word graph with two final states, the final state 3 also has
+    // successors. The strings "a b c" and "a b c g" are generated by
+    // more than one path
+    initialStateScore=-0.0625;
+    wg.setInitialStateScore(initialStateScore);
+    addArc(0,1,"a");
+    addArc(0,1,"b");
+    addArc(0,2,"a b");
+    addArc(1,2,"b");
+    addArc(1,3,"c");
+    addArc(2,3,"c");
+    addArc(2,4,"d");
+    addArc(3,4,"e");
+    addArc(3,5,"f");
+    addArc(4,5,"g");
+    finalStateVec.push_back(3);
+    finalStateVec.push_back(5);
+    for(unsigned int i=0;i<finalStateVec.size();++i)
+        wg.addFinalState(finalStateVec[i]);
+}
+
+//---------------------------------------
+void WordGraphTest::tearDown()
+{
+    wg.clear();
+    arcVec.clear();
+    finalStateVec.clear();
+}
+
+//---------------------------------------
+void WordGraphTest::addArc(HypStateIndex predStateIndex,
+                           HypStateIndex succStateIndex,
+                           const std::string& words)
+{
+    // Arc scores are distinct powers of two, so the scores of the paths
+    // are different and exactly represented
+    TestArc testArc;
+    testArc.predStateIndex=predStateIndex;
+    testArc.succStateIndex=succStateIndex;
+    testArc.words=words;
+    testArc.arcScore=-0.125*(1<<arcVec.size());
+    arcVec.push_back(testArc);
+
+    std::vector<Score> scrVec;
+    scrVec.push_back(testArc.arcScore);
+    wg.addArcWithScrComps(predStateIndex,succStateIndex,StrProcUtils::stringToStringVector(words),testArc.arcScore,scrVec);
+}
+
+//---------------------------------------
+void WordGraphTest::enumPaths(HypStateIndex hypStateIndex,
+                              Score score,
+                              const std::string& str,
+                              std::vector<std::pair<Score,std::string> >& pathVec)
+{
+    if(!str.empty() && std::find(finalStateVec.begin(),finalStateVec.end(),hypStateIndex)!=finalStateVec.end())
+        pathVec.push_back(std::make_pair(score,str));
+
+    for(unsigned int i=0;i<arcVec.size();++i)
+    {
+        if(arcVec[i].predStateIndex==hypStateIndex)
+        {
+            std::string newStr=str.empty()? arcVec[i].words: str+" "+arcVec[i].words;
+            enumPaths(arcVec[i].succStateIndex,score+arcVec[i].arcScore,newStr,pathVec);
+        }
+    }
+}
+
+//---------------------------------------
+void WordGraphTest::obtainBruteForceNbestList(std::vector<std::pair<Score,std::string> >& nblist)
+{
+    nblist.clear();
+    enumPaths(INITIAL_STATE,initialStateScore,"",nblist);
+    std::sort(nblist.begin(),nblist.end(),std::greater<std::pair<Score,std::string> >());
+}
+
+//---------------------------------------
+void WordGraphTest::checkNbestList(unsigned int len)
+{
+    std::vector<std::pair<Score,std::string> > refNblist;
+    obtainBruteForceNbestList(refNblist);
+    if(refNblist.size()>len)
+        refNblist.resize(len);
+
+    std::vector<std::pair<Score,std::string> > nblist;
+    std::vector<std::vector<Score> > scoreCompsVec;
+    wg.obtainNbestList(len,nblist,scoreCompsVec);
+
+    CPPUNIT_ASSERT_EQUAL(refNblist.size(),nblist.size());
+    CPPUNIT_ASSERT_EQUAL(nblist.size(),scoreCompsVec.size());
+    for(unsigned int i=0;i<nblist.size();++i)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(refNblist[i].first,nblist[i].first,WG_TEST_EPSILON);
+        CPPUNIT_ASSERT_EQUAL(refNblist[i].second,nblist[i].second);
+
+        // The score components correspond to the arcs of the path
+        CPPUNIT_ASSERT(scoreCompsVec[i].size()==1);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(nblist[i].first-initialStateScore,scoreCompsVec[i][0],WG_TEST_EPSILON);
+
+        // Each path is returned once, since the scores of the paths
+        // are different
+        if(i>0)
+            CPPUNIT_ASSERT(nblist[i].first<nblist[i-1].first);
+    }
+}
+
+//---------------------------------------
+void WordGraphTest::testNbestListOrder()
+{
+    for(unsigned int len=1;len<=5;++len)
+        checkNbestList(len);
+}
+
+//---------------------------------------
+void WordGraphTest::testNbestListAllPaths()
+{
+    std::vector<std::pair<Score,std::string> > refNblist;
+    obtainBruteForceNbestList(refNblist);
+    CPPUNIT_ASSERT(refNblist.size()>5);
+
+    // The number of entries is limited by the number of paths when the
+    // requested size is equal or greater
+    checkNbestList(refNblist.size());
+    checkNbestList(refNblist.size()+1);
+    checkNbestList(refNblist.size()+100);
+}
+
+//---------------------------------------
+void WordGraphTest::testNbestListDuplicatedStrings()
+{
+    // Different paths generating the same string are different entries
+    // of the n-best list
+    std::vector<std::pair<Score,std::string> > nblist;
+    std::vector<std::vector<Score> > scoreCompsVec;
+    wg.obtainNbestList(1000,nblist,scoreCompsVec);
+    unsigned int numAbc=0;
+    for(unsigned int i=0;i<nblist.size();++i)
+    {
+        if(nblist[i].second=="a b c")
+            ++numAbc;
+    }
+    CPPUNIT_ASSERT_EQUAL(2u,numAbc);
+}
+
+//---------------------------------------
+void WordGraphTest::testNbestListEmpty()
+{
+    std::vector<std::pair<Score,std::string> > nblist;
+    std::vector<std::vector<Score> > scoreCompsVec;
+    wg.obtainNbestList(0,nblist,scoreCompsVec);
+    CPPUNIT_ASSERT(nblist.empty());
+
+    // Paths must reach a final state
+    WordGraph emptyWg;
+    emptyWg.addArc(0,1,StrProcUtils::stringToStringVector("a"),-1);
+    emptyWg.obtainNbestList(10,nblist,scoreCompsVec);
+    CPPUNIT_ASSERT(nblist.empty());
+}
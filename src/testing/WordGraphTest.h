@@ -0,0 +1,115 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+ 
+/********************************************************************/
+/*                                                                  */
+/* Module: WordGraphTest                                            */
+/*                                                                  */
+/* Prototypes file: WordGraphTest.h                                 */
+/*                                                                  */
+/* Description: Declares the WordGraphTest class implementing unit  */
+/*              tests for the n-best lists obtained from the        */
+/*              WordGraph class.                                    */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file WordGraphTest.h
+ *
+ * @brief Declares the WordGraphTest class implementing unit tests for
+ * the n-best lists obtained from the WordGraph class.
+ */
+
+#ifndef _WordGraphTest_h
+#define _WordGraphTest_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "WordGraph.h"
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+//--------------- typedefs -------------------------------------------
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WordGraphTest class
+
+/**
+ * @brief Class implementing tests for the n-best lists of WordGraph.
+ * The n-best lists are compared with the ones obtained by enumerating
+ * all the paths of a small word graph. The scores of the arcs are
+ * distinct powers of two, so that every path has a different score.
+ */
+
+class WordGraphTest: public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( WordGraphTest );
+    CPPUNIT_TEST( testNbestListOrder );
+    CPPUNIT_TEST( testNbestListAllPaths );
+    CPPUNIT_TEST( testNbestListDuplicatedStrings );
+    CPPUNIT_TEST( testNbestListEmpty );
+    CPPUNIT_TEST_SUITE_END();
+
+    private:
+        struct TestArc
+        {
+            HypStateIndex predStateIndex;
+            HypStateIndex succStateIndex;
+            std::string words;
+            Score arcScore;
+        };
+
+        WordGraph wg;
+        std::vector<TestArc> arcVec;
+        std::vector<HypStateIndex> finalStateVec;
+        Score initialStateScore;
+
+        void addArc(HypStateIndex predStateIndex,
+                    HypStateIndex succStateIndex,
+                    const std::string& words);
+        void enumPaths(HypStateIndex hypStateIndex,
+                       Score score,
+                       const std::string& str,
+                       std::vector<std::pair<Score,std::string> >& pathVec);
+        void obtainBruteForceNbestList(std::vector<std::pair<Score,std::string> >& nblist);
+            // Enumerates all the paths from the initial state to a final
+            // state containing at least one arc, and sorts them by
+            // decreasing score
+        void checkNbestList(unsigned int len);
+
+    public:
+        void setUp();
+        void tearDown();
+
+        void testNbestListOrder();
+        void testNbestListAllPaths();
+        void testNbestListDuplicatedStrings();
+        void testNbestListEmpty();
+};
+
+#endif
@@ -0,0 +1,1412 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/********************************************************************/
+/*                                                                  */
+/* Module: thot_bench.cc                                            */
+/*                                                                  */
+/* Definitions file: thot_bench.cc                                  */
+/*                                                                  */
+/* Description: Executes micro- and macro-benchmarks of the hot     */
+/*              paths of the package and prints the results in      */
+/*              JSON format.                                        */
+/*                                                                  */
+/********************************************************************/
+
+/**
+ * @file thot_bench.cc
+ *
+ * @brief Executes micro- and macro-benchmarks of the hot paths of the
+ * package and prints the results in JSON format. Micro-benchmarks use
+ * the toy corpus and synthetic data generated with a fixed seed, so
+ * that they are reproducible. Macro-benchmarks use the models given
+ * in a decoder configuration file.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BenchReport.h"
+#include "StlPhraseTable.h"
+#include "MmapPhraseTable.h"
+#ifdef THOT_HAVE_CXX11
+#include "HatTriePhraseTable.h"
+#endif
+#ifdef THOT_HAVE_LEVELDB_LIB
+#include "LevelDbPhraseTable.h"
+#include "IncrJelMerLevelDbNgramLM.h"
+#endif
+#ifdef THOT_KENLM_LIB_ENABLED
+#include "KenLm.h"
+#endif
+#include "IncrJelMerNgramLM.h"
+#include "IncrJelMerArrayTrieNgramLM.h"
+#include "IncrIbm1AligModel.h"
+#include "IncrIbm2AligModel.h"
+#include "IncrHmmAligModel.h"
+#include "IncrHmmP0AligModel.h"
+#include "WordGraph.h"
+#include "ThotDecoder.h"
+#include "StrProcUtils.h"
+#include "awkInputStream.h"
+#include "ctimer.h"
+#include "ErrorDefs.h"
+#include "options.h"
+#include <ctype.h>
+#include <ftw.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+//--------------- Constants ------------------------------------------
+
+#define BENCH_DEFAULT_NUM_REPS            3
+#define BENCH_DEFAULT_SEED            31415
+#define BENCH_DEFAULT_NUM_QUERIES     10000
+#define BENCH_DEFAULT_PT_SIZES  "10000 100000"
+#define BENCH_DEFAULT_CORPUS_SIZES "1000 5000"
+#define BENCH_DEFAULT_LM_ORDER            4
+#define BENCH_DEFAULT_EM_ITERS            2
+#define BENCH_DEFAULT_NUM_TEST_SENTS     20
+#define BENCH_DEFAULT_S_VALUES     "4 10 32"
+#define BENCH_DEFAULT_I_VALUES         "1 4"
+#define BENCH_DEFAULT_NBEST_SIZE       1000
+#define BENCH_DEFAULT_TMP_DIR        "/tmp"
+#define BENCH_SYN_VOCAB_SIZE          20000
+#define BENCH_SYN_MAX_PHRASE_LEN          4
+#define BENCH_SYN_MAX_TRANS_PER_SRC       5
+#define BENCH_SYN_MIN_SENT_LEN            5
+#define BENCH_SYN_MAX_SENT_LEN           25
+#define BENCH_QUERY_HIT_RATIO           0.8
+#define BENCH_MAX_SRC_QUERIES            20
+#define BENCH_MAX_LM_QUERY_SENTS       1000
+#define BENCH_USER_ID                     0
+
+//--------------- Type definitions -----------------------------------
+
+struct thot_bench_pars
+{
+  std::vector<unsigned int> ptSizeVec;
+  std::vector<unsigned int> corpusSizeVec;
+  unsigned int numQueries;
+  unsigned int numReps;
+  unsigned int seed;
+  std::string srcCorpusFile;
+  std::string trgCorpusFile;
+  unsigned int lmOrder;
+  unsigned int numEmIters;
+  std::string levelDbLmFile;
+  std::string kenLmFile;
+  std::string cfgFile;
+  std::string testFile;
+  std::string refFile;
+  unsigned int numTestSents;
+  std::vector<unsigned int> SVec;
+  std::vector<unsigned int> IVec;
+  std::string fileWithWordGraphs;
+  unsigned int nbestSize;
+  std::set<std::string> groupSet;
+  std::string tmpDir;
+  std::string outFile;
+  bool verbose;
+};
+
+struct BenchPhrEntry
+{
+  std::vector<WordIndex> s;
+  std::vector<WordIndex> t;
+  PhrasePairInfo inf;
+};
+
+struct BenchCorpus
+{
+  std::string name;
+  std::vector<std::vector<std::string> > srcSentVec;
+  std::vector<std::vector<std::string> > trgSentVec;
+};
+
+//--------------- Classes --------------------------------------------
+
+/**
+ * @brief Pseudo-random number generator (xorshift64*) used to generate
+ * the synthetic data. It does not depend on the C library, so that the
+ * data is the same in all platforms.
+ */
+
+class BenchRandGen
+{
+ public:
+  BenchRandGen(unsigned long long seed)
+  {
+    state=seed*2685821657736338717ULL+1;
+  }
+  unsigned long long next(void)
+  {
+    state^=state>>12;
+    state^=state<<25;
+    state^=state>>27;
+    return state*2685821657736338717ULL;
+  }
+  unsigned int uniform(unsigned int n)
+  {
+        // Returns a number in [0,n)
+    return next()%n;
+  }
+  double unit(void)
+  {
+        // Returns a number in [0,1)
+    return (next()>>11)*(1.0/9007199254740992.0);
+  }
+  unsigned int zipf(unsigned int n)
+  {
+        // Returns a number in [0,n) whose frequency approximately
+        // follows Zipf's law
+    unsigned int k=(unsigned int) exp(unit()*log((double)n));
+    return (k>0)? k-1: 0;
+  }
+ private:
+  unsigned long long state;
+};
+
+//--------------- Function Declarations ------------------------------
+
+int handleParameters(int argc,
+                     char *argv[],
+                     thot_bench_pars& pars);
+int takeParameters(int argc,
+                   char *argv[],
+                   thot_bench_pars& pars);
+int checkParameters(thot_bench_pars& pars);
+bool groupEnabled(const thot_bench_pars& pars,
+                  const std::string& group);
+
+double benchTime(void);
+void addRepTime(BenchResult& result,
+                double startTime);
+std::string createTmpDir(const thot_bench_pars& pars);
+void removeTmpDir(const std::string& tmpDir);
+
+void genSynPhrEntries(unsigned int numSrcPhrases,
+                      unsigned int seed,
+                      std::vector<BenchPhrEntry>& entryVec);
+void genSynPhrase(BenchRandGen& randGen,
+                  std::vector<WordIndex>& phrase);
+void genPhrQueries(const std::vector<BenchPhrEntry>& entryVec,
+                   unsigned int numQueries,
+                   unsigned int seed,
+                   std::vector<std::vector<WordIndex> >& trgQueryVec,
+                   std::vector<std::vector<WordIndex> >& srcQueryVec,
+                   std::vector<std::pair<std::vector<WordIndex>,std::vector<WordIndex> > >& pairQueryVec);
+bool printTextPhrTable(const std::vector<BenchPhrEntry>& entryVec,
+                       const std::string& fileName);
+void benchPhrTableQueries(const thot_bench_pars& pars,
+                          const std::string& backend,
+                          unsigned int size,
+                          BasePhraseTable& phrTable,
+                          const std::vector<std::vector<WordIndex> >& trgQueryVec,
+                          const std::vector<std::vector<WordIndex> >& srcQueryVec,
+                          const std::vector<std::pair<std::vector<WordIndex>,std::vector<WordIndex> > >& pairQueryVec,
+                          BenchReport& report);
+BenchResult newResult(const std::string& group,
+                      const std::string& name,
+                      const std::string& paramName,
+                      double paramValue);
+int benchPhraseTables(const thot_bench_pars& pars,
+                      const std::string& tmpDir,
+                      BenchReport& report);
+
+int readCorpusFile(const std::string& fileName,
+                   std::vector<std::vector<std::string> >& sentVec);
+void genSynCorpus(unsigned int numSents,
+                  unsigned int seed,
+                  BenchCorpus& corpus);
+int obtainCorpora(const thot_bench_pars& pars,
+                  std::vector<BenchCorpus>& corpusVec);
+void benchLmQueries(const thot_bench_pars& pars,
+                    const std::string& backend,
+                    const BenchCorpus& corpus,
+                    BaseNgramLM<std::vector<WordIndex> >& lm,
+                    BenchReport& report);
+int benchLanguageModels(const thot_bench_pars& pars,
+                        const std::string& tmpDir,
+                        const std::vector<BenchCorpus>& corpusVec,
+                        BenchReport& report);
+int writeCorpusFile(const std::vector<std::vector<std::string> >& sentVec,
+                    const std::string& fileName);
+int benchSwModels(const thot_bench_pars& pars,
+                  const std::string& tmpDir,
+                  const std::vector<BenchCorpus>& corpusVec,
+                  BenchReport& report);
+
+int readSentences(const std::string& fileName,
+                  unsigned int maxNumSents,
+                  std::vector<std::string>& sentVec);
+int benchDecoder(const thot_bench_pars& pars,
+                 BenchReport& report);
+int benchWordGraphs(const thot_bench_pars& pars,
+                    BenchReport& report);
+
+void printUsage(void);
+void version(void);
+
+//--------------- Function Definitions -------------------------------
+
+//--------------------------------
+int main(int argc,char *argv[])
+{
+  thot_bench_pars pars;
+
+  if(handleParameters(argc,argv,pars)==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Create directory for temporary files
+  std::string tmpDir=createTmpDir(pars);
+  if(tmpDir.empty())
+    return THOT_ERROR;
+
+      // Add context information
+  BenchReport report;
+  std::ostringstream oss;
+  report.addInfo("package","thot");
+  report.addInfo("version",THOT_VERSION);
+  oss<<pars.seed;
+  report.addInfo("seed",oss.str());
+  oss.str("");
+  oss<<pars.numReps;
+  report.addInfo("reps",oss.str());
+  if(!pars.srcCorpusFile.empty())
+  {
+    report.addInfo("src_corpus",pars.srcCorpusFile);
+    report.addInfo("trg_corpus",pars.trgCorpusFile);
+  }
+  if(!pars.cfgFile.empty())
+    report.addInfo("cfg",pars.cfgFile);
+
+      // Execute benchmarks
+  int ret=THOT_OK;
+  if(groupEnabled(pars,"phrase_table"))
+    ret=benchPhraseTables(pars,tmpDir,report);
+
+  if(ret==THOT_OK && (groupEnabled(pars,"lm") || groupEnabled(pars,"sw_models")))
+  {
+    std::vector<BenchCorpus> corpusVec;
+    ret=obtainCorpora(pars,corpusVec);
+    if(ret==THOT_OK && groupEnabled(pars,"lm"))
+      ret=benchLanguageModels(pars,tmpDir,corpusVec,report);
+    if(ret==THOT_OK && groupEnabled(pars,"sw_models"))
+      ret=benchSwModels(pars,tmpDir,corpusVec,report);
+  }
+
+  if(ret==THOT_OK && !pars.cfgFile.empty() && (groupEnabled(pars,"decoder") || groupEnabled(pars,"cat")))
+    ret=benchDecoder(pars,report);
+
+  if(ret==THOT_OK && !pars.fileWithWordGraphs.empty() && groupEnabled(pars,"word_graph"))
+    ret=benchWordGraphs(pars,report);
+
+  removeTmpDir(tmpDir);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Print report
+  if(pars.outFile.empty())
+  {
+    return report.print(std::cout);
+  }
+  else
+  {
+    std::ofstream outF(pars.outFile.c_str());
+    if(!outF)
+    {
+      std::cerr<<"Error while opening file "<<pars.outFile<<std::endl;
+      return THOT_ERROR;
+    }
+    return report.print(outF);
+  }
+}
+
+//--------------------------------
+int handleParameters(int argc,
+                     char *argv[],
+                     thot_bench_pars& pars)
+{
+  if(readOption(argc,argv,"--version")!=-1)
+  {
+    version();
+    return THOT_ERROR;
+  }
+  if(readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+  if(takeParameters(argc,argv,pars)==THOT_ERROR)
+  {
+    return THOT_ERROR;
+  }
+  else
+  {
+    if(checkParameters(pars)==THOT_OK)
+    {
+      return THOT_OK;
+    }
+    else
+    {
+      return THOT_ERROR;
+    }
+  }
+}
+
+//--------------------------------
+int takeParameters(int argc,
+                   char *argv[],
+                   thot_bench_pars& pars)
+{
+  std::vector<std::string> strVec;
+
+      // Take sizes of the synthetic data
+  strVec=StrProcUtils::stringToStringVector(BENCH_DEFAULT_PT_SIZES);
+  readStringSeq(argc,argv,"-sz",strVec);
+  for(unsigned int i=0;i<strVec.size();++i)
+    pars.ptSizeVec.push_back(atoi(strVec[i].c_str()));
+  strVec=StrProcUtils::stringToStringVector(BENCH_DEFAULT_CORPUS_SIZES);
+  readStringSeq(argc,argv,"-ns",strVec);
+  for(unsigned int i=0;i<strVec.size();++i)
+    pars.corpusSizeVec.push_back(atoi(strVec[i].c_str()));
+
+      // Take corpus files, the toy corpus is used by default
+  if(readTwoSTLstrings(argc,argv,"-tc",&pars.srcCorpusFile,&pars.trgCorpusFile)==-1)
+  {
+    std::string srcCorpusFile=THOT_TOY_CORPUS_PATH;
+    srcCorpusFile+="/sp_tok_lc.train";
+    std::string trgCorpusFile=THOT_TOY_CORPUS_PATH;
+    trgCorpusFile+="/en_tok_lc.train";
+    if(access(srcCorpusFile.c_str(),R_OK)==0 && access(trgCorpusFile.c_str(),R_OK)==0)
+    {
+      pars.srcCorpusFile=srcCorpusFile;
+      pars.trgCorpusFile=trgCorpusFile;
+    }
+  }
+
+      // Take model files
+  readSTLstring(argc,argv,"-ldblm",&pars.levelDbLmFile);
+  readSTLstring(argc,argv,"-klm",&pars.kenLmFile);
+  readSTLstring(argc,argv,"-c",&pars.cfgFile);
+  readSTLstring(argc,argv,"-t",&pars.testFile);
+  readSTLstring(argc,argv,"-r",&pars.refFile);
+  readSTLstring(argc,argv,"-wg",&pars.fileWithWordGraphs);
+
+      // Take decoder parameters
+  strVec=StrProcUtils::stringToStringVector(BENCH_DEFAULT_S_VALUES);
+  readStringSeq(argc,argv,"-S",strVec);
+  for(unsigned int i=0;i<strVec.size();++i)
+    pars.SVec.push_back(atoi(strVec[i].c_str()));
+  strVec=StrProcUtils::stringToStringVector(BENCH_DEFAULT_I_VALUES);
+  readStringSeq(argc,argv,"-I",strVec);
+  for(unsigned int i=0;i<strVec.size();++i)
+    pars.IVec.push_back(atoi(strVec[i].c_str()));
+
+      // Take groups of benchmarks
+  strVec.clear();
+  readStringSeq(argc,argv,"-g",strVec);
+  pars.groupSet.insert(strVec.begin(),strVec.end());
+
+      // Take optional parameters
+  pars.numQueries=BENCH_DEFAULT_NUM_QUERIES;
+  readUnsignedInt(argc,argv,"-q",&pars.numQueries);
+  pars.numReps=BENCH_DEFAULT_NUM_REPS;
+  readUnsignedInt(argc,argv,"-reps",&pars.numReps);
+  pars.seed=BENCH_DEFAULT_SEED;
+  readUnsignedInt(argc,argv,"-seed",&pars.seed);
+  pars.lmOrder=BENCH_DEFAULT_LM_ORDER;
+  readUnsignedInt(argc,argv,"-lmo",&pars.lmOrder);
+  pars.numEmIters=BENCH_DEFAULT_EM_ITERS;
+  readUnsignedInt(argc,argv,"-emi",&pars.numEmIters);
+  pars.numTestSents=BENCH_DEFAULT_NUM_TEST_SENTS;
+  readUnsignedInt(argc,argv,"-nts",&pars.numTestSents);
+  pars.nbestSize=BENCH_DEFAULT_NBEST_SIZE;
+  readUnsignedInt(argc,argv,"-nb",&pars.nbestSize);
+  pars.tmpDir=BENCH_DEFAULT_TMP_DIR;
+  readSTLstring(argc,argv,"-tmp",&pars.tmpDir);
+  readSTLstring(argc,argv,"-o",&pars.outFile);
+  pars.verbose=(readOption(argc,argv,"-v")!=-1);
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int checkParameters(thot_bench_pars& pars)
+{
+  const char* groups[]={"phrase_table","lm","sw_models","decoder","cat","word_graph"};
+  std::set<std::string> validGroupSet(groups,groups+6);
+  for(std::set<std::string>::const_iterator iter=pars.groupSet.begin();iter!=pars.groupSet.end();++iter)
+  {
+    if(validGroupSet.find(*iter)==validGroupSet.end())
+    {
+      std::cerr<<"Error: unknown group of benchmarks "<<*iter<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+
+  if(pars.numReps==0)
+  {
+    std::cerr<<"Error: the number of repetitions should be greater than zero"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  if(pars.lmOrder==0)
+  {
+    std::cerr<<"Error: the order of the language model should be greater than zero"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  if(!pars.cfgFile.empty() && pars.testFile.empty())
+  {
+    std::cerr<<"Error: parameter -t should be given together with -c"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  for(unsigned int i=0;i<pars.SVec.size();++i)
+  {
+    if(pars.SVec[i]==0)
+    {
+      std::cerr<<"Error: the values of S should be greater than zero"<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+
+  for(unsigned int i=0;i<pars.IVec.size();++i)
+  {
+    if(pars.IVec[i]==0)
+    {
+      std::cerr<<"Error: the values of I should be greater than zero"<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------------
+bool groupEnabled(const thot_bench_pars& pars,
+                  const std::string& group)
+{
+  return pars.groupSet.empty() || pars.groupSet.find(group)!=pars.groupSet.end();
+}
+
+//--------------------------------
+double benchTime(void)
+{
+  double elapsed,ucpu,scpu;
+  ctimer(&elapsed,&ucpu,&scpu);
+  return elapsed;
+}
+
+//--------------------------------
+void addRepTime(BenchResult& result,
+                double startTime)
+{
+  result.repSecs.push_back(benchTime()-startTime);
+}
+
+//--------------------------------
+std::string createTmpDir(const thot_bench_pars& pars)
+{
+  std::string tmpDirTemplate=pars.tmpDir+"/thot_bench_XXXXXX";
+  std::vector<char> buff(tmpDirTemplate.begin(),tmpDirTemplate.end());
+  buff.push_back('\0');
+  if(mkdtemp(&buff[0])==NULL)
+  {
+    std::cerr<<"Error while creating temporary directory in "<<pars.tmpDir<<std::endl;
+    return "";
+  }
+  return &buff[0];
+}
+
+//--------------------------------
+static int removeTmpEntry(const char* path,
+                          const struct stat* /*statPtr*/,
+                          int /*typeflag*/,
+                          struct FTW* /*ftwPtr*/)
+{
+  return remove(path);
+}
+
+//--------------------------------
+void removeTmpDir(const std::string& tmpDir)
+{
+  if(nftw(tmpDir.c_str(),removeTmpEntry,16,FTW_DEPTH|FTW_PHYS)!=0)
+    std::cerr<<"Warning: temporary directory "<<tmpDir<<" could not be removed"<<std::endl;
+}
+
+//--------------------------------
+void genSynPhrase(BenchRandGen& randGen,
+                  std::vector<WordIndex>& phrase)
+{
+      // Word indices start after the reserved ones
+  phrase.clear();
+  unsigned int len=1+randGen.uniform(BENCH_SYN_MAX_PHRASE_LEN);
+  for(unsigned int i=0;i<len;++i)
+    phrase.push_back(UNUSED_WORD+1+randGen.zipf(BENCH_SYN_VOCAB_SIZE));
+}
+
+//--------------------------------
+void genSynPhrEntries(unsigned int numSrcPhrases,
+                      unsigned int seed,
+                      std::vector<BenchPhrEntry>& entryVec)
+{
+  BenchRandGen randGen(seed);
+  std::set<std::vector<WordIndex> > srcPhraseSet;
+  std::vector<WordIndex> s;
+  std::vector<WordIndex> t;
+
+  entryVec.clear();
+  while(srcPhraseSet.size()<numSrcPhrases)
+  {
+    genSynPhrase(randGen,s);
+    if(srcPhraseSet.insert(s).second)
+    {
+          // Generate translations of the source phrase, the source
+          // count is the sum of the counts of the translations
+      std::set<std::vector<WordIndex> > trgPhraseSet;
+      unsigned int numTrans=1+randGen.uniform(BENCH_SYN_MAX_TRANS_PER_SRC);
+      size_t firstEntry=entryVec.size();
+      float srcCount=0;
+      for(unsigned int i=0;i<numTrans;++i)
+      {
+        genSynPhrase(randGen,t);
+        if(trgPhraseSet.insert(t).second)
+        {
+          BenchPhrEntry entry;
+          entry.s=s;
+          entry.t=t;
+          entry.inf.second=(float)(1+randGen.uniform(10));
+          srcCount+=(float)entry.inf.second;
+          entryVec.push_back(entry);
+        }
+      }
+      for(size_t i=firstEntry;i<entryVec.size();++i)
+        entryVec[i].inf.first=srcCount;
+    }
+  }
+}
+
+//--------------------------------
+void genPhrQueries(const std::vector<BenchPhrEntry>& entryVec,
+                   unsigned int numQueries,
+                   unsigned int seed,
+                   std::vector<std::vector<WordIndex> >& trgQueryVec,
+                   std::vector<std::vector<WordIndex> >& srcQueryVec,
+                   std::vector<std::pair<std::vector<WordIndex>,std::vector<WordIndex> > >& pairQueryVec)
+{
+  BenchRandGen randGen(seed+1);
+  std::vector<WordIndex> phrase;
+
+      // Phrases are taken from the table or generated at random (most
+      // of the latter are not contained in the table). The decoder
+      // looks up target phrases, since the phrase tables store
+      // inverse translation probabilities. Source phrases are scanned
+      // by some backends, so that their number is limited
+  trgQueryVec.clear();
+  srcQueryVec.clear();
+  pairQueryVec.clear();
+  for(unsigned int i=0;i<numQueries;++i)
+  {
+    if(randGen.unit()<BENCH_QUERY_HIT_RATIO)
+    {
+      trgQueryVec.push_back(entryVec[randGen.uniform(entryVec.size())].t);
+    }
+    else
+    {
+      genSynPhrase(randGen,phrase);
+      trgQueryVec.push_back(phrase);
+    }
+    if(srcQueryVec.size()<BENCH_MAX_SRC_QUERIES)
+    {
+      if(randGen.unit()<BENCH_QUERY_HIT_RATIO)
+      {
+        srcQueryVec.push_back(entryVec[randGen.uniform(entryVec.size())].s);
+      }
+      else
+      {
+        genSynPhrase(randGen,phrase);
+        srcQueryVec.push_back(phrase);
+      }
+    }
+    const BenchPhrEntry& entry=entryVec[randGen.uniform(entryVec.size())];
+    pairQueryVec.push_back(std::make_pair(entry.s,entry.t));
+  }
+}
+
+//--------------------------------
+bool printTextPhrTable(const std::vector<BenchPhrEntry>& entryVec,
+                       const std::string& fileName)
+{
+      // The words are printed as their word indices
+  std::ofstream outF(fileName.c_str());
+  if(!outF)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  for(unsigned int i=0;i<entryVec.size();++i)
+  {
+    for(unsigned int j=0;j<entryVec[i].s.size();++j)
+      outF<<entryVec[i].s[j]<<" ";
+    outF<<"|||";
+    for(unsigned int j=0;j<entryVec[i].t.size();++j)
+      outF<<" "<<entryVec[i].t[j];
+    outF<<" ||| "<<(float)entryVec[i].inf.first<<" "<<(float)entryVec[i].inf.second<<std::endl;
+  }
+  if(outF.fail())
+  {
+    std::cerr<<"Error while writing file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//--------------------------------
+BenchResult newResult(const std::string& group,
+                      const std::string& name,
+                      const std::string& paramName,
+                      double paramValue)
+{
+  BenchResult result;
+  result.group=group;
+  result.name=name;
+  result.addParam(paramName,paramValue);
+  return result;
+}
+
+//--------------------------------
+void benchPhrTableQueries(const thot_bench_pars& pars,
+                          const std::string& backend,
+                          unsigned int size,
+                          BasePhraseTable& phrTable,
+                          const std::vector<std::vector<WordIndex> >& trgQueryVec,
+                          const std::vector<std::vector<WordIndex> >& srcQueryVec,
+                          const std::vector<std::pair<std::vector<WordIndex>,std::vector<WordIndex> > >& pairQueryVec,
+                          BenchReport& report)
+{
+  BenchResult lookupResult=newResult("phrase_table",backend+"/lookup_trg","size",size);
+  BenchResult nbestResult=newResult("phrase_table",backend+"/nbest_trg","size",size);
+  BenchResult srcLookupResult=newResult("phrase_table",backend+"/lookup_src","size",size);
+  BenchResult pairResult=newResult("phrase_table",backend+"/pair_lgprob","size",size);
+  lookupResult.numOps=trgQueryVec.size();
+  nbestResult.numOps=trgQueryVec.size();
+  srcLookupResult.numOps=srcQueryVec.size();
+  pairResult.numOps=pairQueryVec.size();
+
+  BasePhraseTable::SrcTableNode srctn;
+  BasePhraseTable::TrgTableNode trgtn;
+  NbestTableNode<PhraseTransTableNodeData> nbt;
+  double lgProbSum=0;
+  unsigned int numHits=0;
+  for(unsigned int rep=0;rep<pars.numReps;++rep)
+  {
+        // Obtain the entries for each target phrase
+    numHits=0;
+    double startTime=benchTime();
+    for(unsigned int i=0;i<trgQueryVec.size();++i)
+    {
+      if(phrTable.getEntriesForTarget(trgQueryVec[i],srctn))
+        ++numHits;
+    }
+    addRepTime(lookupResult,startTime);
+
+        // Obtain the n-best translations for each target phrase
+    startTime=benchTime();
+    for(unsigned int i=0;i<trgQueryVec.size();++i)
+      phrTable.getNbestForTrg(trgQueryVec[i],nbt);
+    addRepTime(nbestResult,startTime);
+
+        // Obtain the entries for each source phrase
+    startTime=benchTime();
+    for(unsigned int i=0;i<srcQueryVec.size();++i)
+      phrTable.getEntriesForSource(srcQueryVec[i],trgtn);
+    addRepTime(srcLookupResult,startTime);
+
+        // Obtain the probabilities of phrase pairs
+    startTime=benchTime();
+    for(unsigned int i=0;i<pairQueryVec.size();++i)
+      lgProbSum+=(double)phrTable.logpSrcGivenTrg(pairQueryVec[i].first,pairQueryVec[i].second);
+    addRepTime(pairResult,startTime);
+  }
+  if(pars.verbose)
+    std::cerr<<backend<<": "<<numHits<<" of "<<trgQueryVec.size()<<" target phrases found, sum of log-probabilities: "<<lgProbSum<<std::endl;
+
+  report.addResult(lookupResult);
+  report.addResult(nbestResult);
+  report.addResult(srcLookupResult);
+  report.addResult(pairResult);
+}
+
+//--------------------------------
+int benchPhraseTables(const thot_bench_pars& pars,
+                      const std::string& tmpDir,
+                      BenchReport& report)
+{
+  for(unsigned int sizeIdx=0;sizeIdx<pars.ptSizeVec.size();++sizeIdx)
+  {
+    unsigned int size=pars.ptSizeVec[sizeIdx];
+    std::cerr<<"Benchmarking phrase tables with "<<size<<" source phrases..."<<std::endl;
+
+        // Generate table entries and queries
+    std::vector<BenchPhrEntry> entryVec;
+    genSynPhrEntries(size,pars.seed,entryVec);
+    if(entryVec.empty())
+      continue;
+    std::vector<std::vector<WordIndex> > trgQueryVec;
+    std::vector<std::vector<WordIndex> > srcQueryVec;
+    std::vector<std::pair<std::vector<WordIndex>,std::vector<WordIndex> > > pairQueryVec;
+    genPhrQueries(entryVec,pars.numQueries,pars.seed,trgQueryVec,srcQueryVec,pairQueryVec);
+
+        // StlPhraseTable
+    {
+      StlPhraseTable phrTable;
+      BenchResult buildResult=newResult("phrase_table","stl/build","size",size);
+      buildResult.numOps=entryVec.size();
+      for(unsigned int rep=0;rep<pars.numReps;++rep)
+      {
+        phrTable.clear();
+        double startTime=benchTime();
+        for(unsigned int i=0;i<entryVec.size();++i)
+          phrTable.addTableEntry(entryVec[i].s,entryVec[i].t,entryVec[i].inf);
+        addRepTime(buildResult,startTime);
+      }
+      report.addResult(buildResult);
+      benchPhrTableQueries(pars,"stl",size,phrTable,trgQueryVec,srcQueryVec,pairQueryVec,report);
+    }
+
+#ifdef THOT_HAVE_CXX11
+        // HatTriePhraseTable
+    {
+      HatTriePhraseTable phrTable;
+      BenchResult buildResult=newResult("phrase_table","hat_trie/build","size",size);
+      buildResult.numOps=entryVec.size();
+      for(unsigned int rep=0;rep<pars.numReps;++rep)
+      {
+        phrTable.clear();
+        double startTime=benchTime();
+        for(unsigned int i=0;i<entryVec.size();++i)
+          phrTable.addTableEntry(entryVec[i].s,entryVec[i].t,entryVec[i].inf);
+        phrTable.freeze();
+        addRepTime(buildResult,startTime);
+      }
+      report.addResult(buildResult);
+      benchPhrTableQueries(pars,"hat_trie",size,phrTable,trgQueryVec,srcQueryVec,pairQueryVec,report);
+    }
+#endif
+
+        // MmapPhraseTable
+    {
+      std::ostringstream oss;
+      oss<<tmpDir<<"/ttable_"<<size;
+      std::string ttableFileName=oss.str();
+      std::string binFileName=ttableFileName+".bin";
+      if(printTextPhrTable(entryVec,ttableFileName)==THOT_ERROR)
+        return THOT_ERROR;
+      MmapPhraseTable phrTable;
+      BenchResult buildResult=newResult("phrase_table","mmap/build","size",size);
+      buildResult.numOps=entryVec.size();
+      BenchResult loadResult=newResult("phrase_table","mmap/load","size",size);
+      loadResult.numOps=1;
+      for(unsigned int rep=0;rep<pars.numReps;++rep)
+      {
+        double startTime=benchTime();
+        if(MmapPhraseTable::build(ttableFileName.c_str(),binFileName.c_str())==THOT_ERROR)
+          return THOT_ERROR;
+        addRepTime(buildResult,startTime);
+        startTime=benchTime();
+        if(phrTable.load(binFileName.c_str())==THOT_ERROR)
+          return THOT_ERROR;
+        addRepTime(loadResult,startTime);
+      }
+          // The words of the text table are their word indices
+      for(size_t pos=0;pos<phrTable.getSrcVocabSize();++pos)
+      {
+        std::string word=phrTable.getSrcWord(pos);
+        if(!word.empty() && isdigit(word[0]))
+          phrTable.setSrcWordIndex(pos,atoi(word.c_str()));
+      }
+      for(size_t pos=0;pos<phrTable.getTrgVocabSize();++pos)
+      {
+        std::string word=phrTable.getTrgWord(pos);
+        if(!word.empty() && isdigit(word[0]))
+          phrTable.setTrgWordIndex(pos,atoi(word.c_str()));
+      }
+      report.addResult(buildResult);
+      report.addResult(loadResult);
+      benchPhrTableQueries(pars,"mmap",size,phrTable,trgQueryVec,srcQueryVec,pairQueryVec,report);
+    }
+
+#ifdef THOT_HAVE_LEVELDB_LIB
+        // LevelDbPhraseTable
+    {
+      std::ostringstream oss;
+      oss<<tmpDir<<"/ldb_ttable_"<<size;
+      LevelDbPhraseTable phrTable;
+      BenchResult buildResult=newResult("phrase_table","leveldb/build","size",size);
+      buildResult.numOps=entryVec.size();
+      for(unsigned int rep=0;rep<pars.numReps;++rep)
+      {
+        if(phrTable.init(oss.str())==THOT_ERROR)
+          return THOT_ERROR;
+        double startTime=benchTime();
+        for(unsigned int i=0;i<entryVec.size();++i)
+          phrTable.addTableEntry(entryVec[i].s,entryVec[i].t,entryVec[i].inf);
+        addRepTime(buildResult,startTime);
+      }
+      report.addResult(buildResult);
+      benchPhrTableQueries(pars,"leveldb",size,phrTable,trgQueryVec,srcQueryVec,pairQueryVec,report);
+      phrTable.drop();
+    }
+#endif
+  }
+  return THOT_OK;
+}
+
+//--------------------------------
+int readCorpusFile(const std::string& fileName,
+                   std::vector<std::vector<std::string> >& sentVec)
+{
+  awkInputStream awk;
+  if(awk.open(fileName.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  sentVec.clear();
+  while(awk.getln())
+  {
+    std::vector<std::string> sent;
+    for(unsigned int i=1;i<=awk.NF;++i)
+      sent.push_back(awk.dollar(i));
+    sentVec.push_back(sent);
+  }
+  return THOT_OK;
+}
+
+//--------------------------------
+void genSynCorpus(unsigned int numSents,
+                  unsigned int seed,
+                  BenchCorpus& corpus)
+{
+  BenchRandGen randGen(seed+numSents);
+  std::ostringstream oss;
+  oss<<"synthetic_"<<numSents;
+  corpus.name=oss.str();
+  corpus.srcSentVec.clear();
+  corpus.trgSentVec.clear();
+  for(unsigned int n=0;n<numSents;++n)
+  {
+        // Target sentences have a similar length to that of their
+        // source sentences
+    unsigned int srcLen=BENCH_SYN_MIN_SENT_LEN+randGen.uniform(BENCH_SYN_MAX_SENT_LEN-BENCH_SYN_MIN_SENT_LEN+1);
+    unsigned int trgLen=srcLen+randGen.uniform(5)-2;
+    std::vector<std::string> srcSent;
+    for(unsigned int i=0;i<srcLen;++i)
+    {
+      oss.str("");
+      oss<<"s"<<randGen.zipf(BENCH_SYN_VOCAB_SIZE);
+      srcSent.push_back(oss.str());
+    }
+    std::vector<std::string> trgSent;
+    for(unsigned int i=0;i<trgLen;++i)
+    {
+      oss.str("");
+      oss<<"t"<<randGen.zipf(BENCH_SYN_VOCAB_SIZE);
+      trgSent.push_back(oss.str());
+    }
+    corpus.srcSentVec.push_back(srcSent);
+    corpus.trgSentVec.push_back(trgSent);
+  }
+}
+
+//--------------------------------
+int obtainCorpora(const thot_bench_pars& pars,
+                  std::vector<BenchCorpus>& corpusVec)
+{
+  corpusVec.clear();
+
+      // Read parallel corpus
+  if(!pars.srcCorpusFile.empty())
+  {
+    BenchCorpus corpus;
+    corpus.name="corpus";
+    if(readCorpusFile(pars.srcCorpusFile,corpus.srcSentVec)==THOT_ERROR)
+      return THOT_ERROR;
+    if(readCorpusFile(pars.trgCorpusFile,corpus.trgSentVec)==THOT_ERROR)
+      return THOT_ERROR;
+    if(corpus.srcSentVec.size()!=corpus.trgSentVec.size())
+    {
+      std::cerr<<"Error: the number of source and target sentences of the corpus are not equal!"<<std::endl;
+      return THOT_ERROR;
+    }
+    corpusVec.push_back(corpus);
+  }
+  else
+    std::cerr<<"Warning: toy corpus not found, only synthetic corpora will be used"<<std::endl;
+
+      // Generate synthetic corpora
+  for(unsigned int i=0;i<pars.corpusSizeVec.size();++i)
+  {
+    corpusVec.push_back(BenchCorpus());
+    genSynCorpus(pars.corpusSizeVec[i],pars.seed,corpusVec.back());
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------------
+void benchLmQueries(const thot_bench_pars& pars,
+                    const std::string& backend,
+                    const BenchCorpus& corpus,
+                    BaseNgramLM<std::vector<WordIndex> >& lm,
+                    BenchReport& report)
+{
+      // The queries are the first sentences of the target side of the
+      // corpus
+  std::vector<std::vector<WordIndex> > sentVec;
+  unsigned int numWords=0;
+  for(unsigned int n=0;n<corpus.trgSentVec.size() && n<BENCH_MAX_LM_QUERY_SENTS;++n)
+  {
+    std::vector<WordIndex> sent;
+    for(unsigned int i=0;i<corpus.trgSentVec[n].size();++i)
+      sent.push_back(lm.stringToWordIndex(corpus.trgSentVec[n][i]));
+    sentVec.push_back(sent);
+    numWords+=sent.size()+1;
+  }
+
+  BenchResult result=newResult("lm",backend+"/query","train_sents",corpus.trgSentVec.size());
+  result.addParam("order",lm.getNgramOrder());
+  result.numOps=numWords;
+  std::vector<WordIndex> state;
+  double lgProbSum=0;
+  for(unsigned int rep=0;rep<pars.numReps;++rep)
+  {
+        // Score sentences word by word as done by the decoder
+    double startTime=benchTime();
+    for(unsigned int n=0;n<sentVec.size();++n)
+    {
+      lm.getStateForBeginOfSentence(state);
+      for(unsigned int i=0;i<sentVec[n].size();++i)
+        lgProbSum+=(double)lm.getNgramLgProbGivenState(sentVec[n][i],state);
+      lgProbSum+=(double)lm.getLgProbEndGivenState(state);
+    }
+    addRepTime(result,startTime);
+  }
+  if(pars.verbose)
+    std::cerr<<backend<<": sum of log-probabilities: "<<lgProbSum<<std::endl;
+  report.addResult(result);
+}
+
+//--------------------------------
+int benchLanguageModels(const thot_bench_pars& pars,
+                        const std::string& tmpDir,
+                        const std::vector<BenchCorpus>& corpusVec,
+                        BenchReport& report)
+{
+  for(unsigned int c=0;c<corpusVec.size();++c)
+  {
+    const BenchCorpus& corpus=corpusVec[c];
+    std::cerr<<"Benchmarking language models on "<<corpus.name<<"..."<<std::endl;
+
+        // IncrJelMerNgramLM
+    IncrJelMerNgramLM incrLm;
+    BenchResult trainResult=newResult("lm","incr_jel_mer/train","train_sents",corpus.trgSentVec.size());
+    trainResult.addParam("order",pars.lmOrder);
+    trainResult.numOps=corpus.trgSentVec.size();
+    for(unsigned int rep=0;rep<pars.numReps;++rep)
+    {
+      incrLm.clear();
+      incrLm.setNgramOrder(pars.lmOrder);
+      double startTime=benchTime();
+      for(unsigned int n=0;n<corpus.trgSentVec.size();++n)
+        incrLm.trainSentence(corpus.trgSentVec[n]);
+      addRepTime(trainResult,startTime);
+    }
+    report.addResult(trainResult);
+    benchLmQueries(pars,"incr_jel_mer",corpus,incrLm,report);
+
+        // IncrJelMerArrayTrieNgramLM, it is loaded from the model
+        // trained above
+    std::string lmFileName=tmpDir+"/lm_"+corpus.name;
+    if(incrLm.print(lmFileName.c_str())==THOT_ERROR)
+      return THOT_ERROR;
+    incrLm.clear();
+    IncrJelMerArrayTrieNgramLM arrayTrieLm;
+    BenchResult loadResult=newResult("lm","array_trie/load","train_sents",corpus.trgSentVec.size());
+    loadResult.addParam("order",pars.lmOrder);
+    loadResult.numOps=1;
+    for(unsigned int rep=0;rep<pars.numReps;++rep)
+    {
+      double startTime=benchTime();
+      if(arrayTrieLm.load(lmFileName.c_str())==THOT_ERROR)
+        return THOT_ERROR;
+      addRepTime(loadResult,startTime);
+    }
+    report.addResult(loadResult);
+    benchLmQueries(pars,"array_trie",corpus,arrayTrieLm,report);
+
+#ifdef THOT_HAVE_LEVELDB_LIB
+        // IncrJelMerLevelDbNgramLM
+    if(!pars.levelDbLmFile.empty())
+    {
+      IncrJelMerLevelDbNgramLM levelDbLm;
+      if(levelDbLm.load(pars.levelDbLmFile.c_str())==THOT_ERROR)
+        return THOT_ERROR;
+      benchLmQueries(pars,"leveldb",corpus,levelDbLm,report);
+    }
+#endif
+
+#ifdef THOT_KENLM_LIB_ENABLED
+        // KenLm
+    if(!pars.kenLmFile.empty())
+    {
+      KenLm kenLm;
+      if(kenLm.load(pars.kenLmFile.c_str())==THOT_ERROR)
+        return THOT_ERROR;
+      benchLmQueries(pars,"kenlm",corpus,kenLm,report);
+    }
+#endif
+  }
+  return THOT_OK;
+}
+
+//--------------------------------
+int writeCorpusFile(const std::vector<std::vector<std::string> >& sentVec,
+                    const std::string& fileName)
+{
+  std::ofstream outF(fileName.c_str());
+  if(!outF)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  for(unsigned int n=0;n<sentVec.size();++n)
+    outF<<StrProcUtils::stringVectorToString(sentVec[n])<<std::endl;
+  if(outF.fail())
+  {
+    std::cerr<<"Error while writing file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//--------------------------------
+int benchSwModels(const thot_bench_pars& pars,
+                  const std::string& tmpDir,
+                  const std::vector<BenchCorpus>& corpusVec,
+                  BenchReport& report)
+{
+  const char* modelNames[]={"ibm1","ibm2","hmm","hmm_p0"};
+
+  for(unsigned int c=0;c<corpusVec.size();++c)
+  {
+    const BenchCorpus& corpus=corpusVec[c];
+    std::cerr<<"Benchmarking single word models on "<<corpus.name<<"..."<<std::endl;
+
+        // Write corpus files, they are read by the models
+    std::string srcFileName=tmpDir+"/src_"+corpus.name;
+    std::string trgFileName=tmpDir+"/trg_"+corpus.name;
+    if(writeCorpusFile(corpus.srcSentVec,srcFileName)==THOT_ERROR)
+      return THOT_ERROR;
+    if(writeCorpusFile(corpus.trgSentVec,trgFileName)==THOT_ERROR)
+      return THOT_ERROR;
+
+    for(unsigned int m=0;m<4;++m)
+    {
+      BenchResult result=newResult("sw_models",std::string(modelNames[m])+"/em_iter","train_sents",corpus.srcSentVec.size());
+      result.numOps=corpus.srcSentVec.size();
+      for(unsigned int rep=0;rep<pars.numReps;++rep)
+      {
+        BaseSwAligModel<std::vector<Prob> >* swModelPtr;
+        switch(m)
+        {
+          case 0: swModelPtr=new IncrIbm1AligModel;
+            break;
+          case 1: swModelPtr=new IncrIbm2AligModel;
+            break;
+          case 2: swModelPtr=new IncrHmmAligModel;
+            break;
+          default: swModelPtr=new IncrHmmP0AligModel;
+            break;
+        }
+        std::pair<unsigned int,unsigned int> sentRange;
+        if(swModelPtr->readSentencePairs(srcFileName.c_str(),trgFileName.c_str(),"",sentRange)==THOT_ERROR)
+        {
+          delete swModelPtr;
+          return THOT_ERROR;
+        }
+
+            // Each EM iteration is a repetition of the benchmark
+        for(unsigned int iter=0;iter<pars.numEmIters;++iter)
+        {
+          double startTime=benchTime();
+          swModelPtr->trainAllSents();
+          addRepTime(result,startTime);
+        }
+        delete swModelPtr;
+      }
+      report.addResult(result);
+    }
+  }
+  return THOT_OK;
+}
+
+//--------------------------------
+int readSentences(const std::string& fileName,
+                  unsigned int maxNumSents,
+                  std::vector<std::string>& sentVec)
+{
+  awkInputStream awk;
+  if(awk.open(fileName.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  sentVec.clear();
+  while(sentVec.size()<maxNumSents && awk.getln())
+    sentVec.push_back(awk.dollar(0));
+  return THOT_OK;
+}
+
+//--------------------------------
+int benchDecoder(const thot_bench_pars& pars,
+                 BenchReport& report)
+{
+      // Read test sentences
+  std::vector<std::string> srcSentVec;
+  if(readSentences(pars.testFile,pars.numTestSents,srcSentVec)==THOT_ERROR)
+    return THOT_ERROR;
+  unsigned int numSrcWords=0;
+  for(unsigned int n=0;n<srcSentVec.size();++n)
+    numSrcWords+=StrProcUtils::stringToStringVector(srcSentVec[n]).size();
+
+      // Load models
+  std::cerr<<"Loading models for the decoder benchmarks..."<<std::endl;
+  ThotDecoder thotDecoder;
+  ThotDecoderUserPars tdup;
+  int ret=thotDecoder.initUsingCfgFile(pars.cfgFile,tdup,pars.verbose);
+  if(ret==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Translate test sentences for each pair of S and I values
+  if(groupEnabled(pars,"decoder"))
+  {
+    for(unsigned int i=0;i<pars.SVec.size();++i)
+    {
+      for(unsigned int j=0;j<pars.IVec.size();++j)
+      {
+        std::cerr<<"Benchmarking decoder with S="<<pars.SVec[i]<<" and I="<<pars.IVec[j]<<"..."<<std::endl;
+        tdup.S=pars.SVec[i];
+        tdup.I=pars.IVec[j];
+        ret=thotDecoder.initUserPars(BENCH_USER_ID,tdup,pars.verbose);
+        if(ret==THOT_ERROR)
+          return THOT_ERROR;
+
+        BenchResult result=newResult("decoder","stack_decoder/translate","S",pars.SVec[i]);
+        result.addParam("I",pars.IVec[j]);
+        result.addParam("src_words",numSrcWords);
+        result.numOps=srcSentVec.size();
+        for(unsigned int rep=0;rep<pars.numReps;++rep)
+        {
+          double startTime=benchTime();
+          for(unsigned int n=0;n<srcSentVec.size();++n)
+          {
+            std::string translation;
+            std::string bestHypInfo;
+            thotDecoder.translateSentence(BENCH_USER_ID,srcSentVec[n].c_str(),translation,bestHypInfo);
+          }
+          addRepTime(result,startTime);
+        }
+        report.addResult(result);
+      }
+    }
+  }
+
+      // Simulate a user that types the reference translations word by
+      // word in the CAT scenario
+  if(groupEnabled(pars,"cat") && !pars.refFile.empty())
+  {
+    std::vector<std::string> refSentVec;
+    if(readSentences(pars.refFile,srcSentVec.size(),refSentVec)==THOT_ERROR)
+      return THOT_ERROR;
+    if(refSentVec.size()!=srcSentVec.size())
+    {
+      std::cerr<<"Error: the number of test sentences and references are not equal!"<<std::endl;
+      return THOT_ERROR;
+    }
+
+    std::cerr<<"Benchmarking prefix updates..."<<std::endl;
+    tdup=ThotDecoderUserPars();
+    ret=thotDecoder.initUserPars(BENCH_USER_ID,tdup,pars.verbose);
+    if(ret==THOT_ERROR)
+      return THOT_ERROR;
+
+    BenchResult startResult=newResult("cat","start_cat","src_words",numSrcWords);
+    startResult.numOps=srcSentVec.size();
+    BenchResult prefResult=newResult("cat","add_str_to_pref","src_words",numSrcWords);
+    prefResult.numOps=0;
+    RejectedWordsSet emptyRejWordsSet;
+    for(unsigned int rep=0;rep<pars.numReps;++rep)
+    {
+      double startSecs=0;
+      double prefSecs=0;
+      unsigned int numPrefUpdates=0;
+      for(unsigned int n=0;n<srcSentVec.size();++n)
+      {
+        std::string catResult;
+        double startTime=benchTime();
+        thotDecoder.startCat(BENCH_USER_ID,srcSentVec[n].c_str(),catResult);
+        startSecs+=benchTime()-startTime;
+
+        std::vector<std::string> refWordVec=StrProcUtils::stringToStringVector(refSentVec[n]);
+        for(unsigned int i=0;i<refWordVec.size();++i)
+        {
+          std::string strToAdd=refWordVec[i]+" ";
+          startTime=benchTime();
+          thotDecoder.addStrToPref(BENCH_USER_ID,strToAdd.c_str(),emptyRejWordsSet,catResult);
+          prefSecs+=benchTime()-startTime;
+          ++numPrefUpdates;
+        }
+      }
+      startResult.repSecs.push_back(startSecs);
+      prefResult.repSecs.push_back(prefSecs);
+      prefResult.numOps=numPrefUpdates;
+    }
+    report.addResult(startResult);
+    report.addResult(prefResult);
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int benchWordGraphs(const thot_bench_pars& pars,
+                    BenchReport& report)
+{
+  std::vector<std::string> wgFileVec;
+  if(readSentences(pars.fileWithWordGraphs,UINT_MAX,wgFileVec)==THOT_ERROR)
+    return THOT_ERROR;
+
+  std::cerr<<"Benchmarking word graphs..."<<std::endl;
+  BenchResult loadResult=newResult("word_graph","load","num_word_graphs",wgFileVec.size());
+  loadResult.numOps=wgFileVec.size();
+  BenchResult nbestResult=newResult("word_graph","nbest","num_word_graphs",wgFileVec.size());
+  nbestResult.addParam("nbest_size",pars.nbestSize);
+  nbestResult.numOps=wgFileVec.size();
+
+  std::vector<WordGraph> wgVec(wgFileVec.size());
+  for(unsigned int rep=0;rep<pars.numReps;++rep)
+  {
+        // Load word graphs
+    double startTime=benchTime();
+    for(unsigned int n=0;n<wgFileVec.size();++n)
+    {
+      if(wgVec[n].load(wgFileVec[n].c_str())==THOT_ERROR)
+      {
+        std::cerr<<"Error while loading word graph "<<wgFileVec[n]<<std::endl;
+        return THOT_ERROR;
+      }
+    }
+    addRepTime(loadResult,startTime);
+
+        // Obtain n-best lists
+    startTime=benchTime();
+    for(unsigned int n=0;n<wgVec.size();++n)
+    {
+      std::vector<std::pair<Score,std::string> > nblist;
+      std::vector<std::vector<Score> > scoreCompsVec;
+      wgVec[n].obtainNbestList(pars.nbestSize,nblist,scoreCompsVec);
+    }
+    addRepTime(nbestResult,startTime);
+  }
+  report.addResult(loadResult);
+  report.addResult(nbestResult);
+
+  return THOT_OK;
+}
+
+//--------------------------------
+void printUsage(void)
+{
+  std::cerr<<"thot_bench [-g <string> ... <string>] [-o <string>]"<<std::endl;
+  std::cerr<<"           [-sz <int> ... <int>] [-q <int>]"<<std::endl;
+  std::cerr<<"           [-tc <string> <string>] [-ns <int> ... <int>]"<<std::endl;
+  std::cerr<<"           [-lmo <int>] [-ldblm <string>] [-klm <string>] [-emi <int>]"<<std::endl;
+  std::cerr<<"           [-c <string> -t <string> [-r <string>] [-nts <int>]"<<std::endl;
+  std::cerr<<"            [-S <int> ... <int>] [-I <int> ... <int>]]"<<std::endl;
+  std::cerr<<"           [-wg <string> [-nb <int>]]"<<std::endl;
+  std::cerr<<"           [-reps <int>] [-seed <int>] [-tmp <string>] [-v]"<<std::endl;
+  std::cerr<<"           [--help] [--version]"<<std::endl;
+  std::cerr<<std::endl;
+  std::cerr<<"-g <string>...<string>   Groups of benchmarks to be executed: phrase_table, lm,"<<std::endl;
+  std::cerr<<"                         sw_models, decoder, cat and word_graph (all by default)."<<std::endl;
+  std::cerr<<"-o <string>              Output file for the JSON report (standard output by"<<std::endl;
+  std::cerr<<"                         default)."<<std::endl;
+  std::cerr<<"-sz <int>...<int>        Number of source phrases of the synthetic phrase"<<std::endl;
+  std::cerr<<"                         tables ("<<BENCH_DEFAULT_PT_SIZES<<" by default)."<<std::endl;
+  std::cerr<<"-q <int>                 Number of phrase table queries ("<<BENCH_DEFAULT_NUM_QUERIES<<" by default), at"<<std::endl;
+  std::cerr<<"                         most "<<BENCH_MAX_SRC_QUERIES<<" of them are used to look up source phrases."<<std::endl;
+  std::cerr<<"-tc <string> <string>    Source and target files of the corpus used to train"<<std::endl;
+  std::cerr<<"                         language and single word models (the toy corpus by"<<std::endl;
+  std::cerr<<"                         default)."<<std::endl;
+  std::cerr<<"-ns <int>...<int>        Number of sentences of the synthetic corpora used to"<<std::endl;
+  std::cerr<<"                         train language and single word models"<<std::endl;
+  std::cerr<<"                         ("<<BENCH_DEFAULT_CORPUS_SIZES<<" by default)."<<std::endl;
+  std::cerr<<"-lmo <int>               Order of the language models ("<<BENCH_DEFAULT_LM_ORDER<<" by default)."<<std::endl;
+  std::cerr<<"-ldblm <string>          LevelDB language model to be queried."<<std::endl;
+  std::cerr<<"-klm <string>            KenLM language model to be queried."<<std::endl;
+  std::cerr<<"-emi <int>               Number of EM iterations ("<<BENCH_DEFAULT_EM_ITERS<<" by default)."<<std::endl;
+  std::cerr<<"-c <string>              Configuration file of the decoder."<<std::endl;
+  std::cerr<<"-t <string>              File with test sentences for the decoder."<<std::endl;
+  std::cerr<<"-r <string>              File with the references of the test sentences, they"<<std::endl;
+  std::cerr<<"                         are typed word by word in the CAT benchmarks."<<std::endl;
+  std::cerr<<"-nts <int>               Number of test sentences ("<<BENCH_DEFAULT_NUM_TEST_SENTS<<" by default)."<<std::endl;
+  std::cerr<<"-S <int>...<int>         Values of the S parameter of the decoder"<<std::endl;
+  std::cerr<<"                         ("<<BENCH_DEFAULT_S_VALUES<<" by default)."<<std::endl;
+  std::cerr<<"-I <int>...<int>         Values of the I parameter of the decoder"<<std::endl;
+  std::cerr<<"                         ("<<BENCH_DEFAULT_I_VALUES<<" by default)."<<std::endl;
+  std::cerr<<"-wg <string>             File containing the names of files with word graphs,"<<std::endl;
+  std::cerr<<"                         as generated by thot_ms_dec."<<std::endl;
+  std::cerr<<"-nb <int>                Size of the n-best lists ("<<BENCH_DEFAULT_NBEST_SIZE<<" by default)."<<std::endl;
+  std::cerr<<"-reps <int>              Number of repetitions of each benchmark ("<<BENCH_DEFAULT_NUM_REPS<<" by default)."<<std::endl;
+  std::cerr<<"-seed <int>              Seed used to generate the synthetic data ("<<BENCH_DEFAULT_SEED<<" by default)."<<std::endl;
+  std::cerr<<"-tmp <string>            Directory for temporary files ("<<BENCH_DEFAULT_TMP_DIR<<" by default)."<<std::endl;
+  std::cerr<<"-v                       Verbose mode."<<std::endl;
+  std::cerr<<"--help                   Display this help and exit."<<std::endl;
+  std::cerr<<"--version                Output version information and exit."<<std::endl;
+}
+
+//--------------------------------
+void version(void)
+{
+  std::cerr<<"thot_bench is part of the thot package"<<std::endl;
+  std::cerr<<"thot version "<<THOT_VERSION<<std::endl;
+  std::cerr<<"thot is GNU software written by Daniel Ortiz"<<std::endl;
+}
@@ -158,17 +158,17 @@ tok_corpus()
     echo "**** Tokenizing corpus" >&2
     suff="tok"
 
-    ${bindir}/thot_tokenize -f ${scorpus_train} \
+    ${bindir}/thot_tokenize -p ${pr_val} -f ${scorpus_train} \
         > ${outd}/${preproc_dir}/${srcbase}_${suff}.train 2>${outd}/${preproc_dir}/thot_tokenize.log || exit 1
-    ${bindir}/thot_tokenize -f ${scorpus_dev} \
+    ${bindir}/thot_tokenize -p ${pr_val} -f ${scorpus_dev} \
         > ${outd}/${preproc_dir}/${srcbase}_${suff}.dev 2>>${outd}/${preproc_dir}/thot_tokenize.log || exit 1
-    ${bindir}/thot_tokenize -f ${scorpus_test} \
+    ${bindir}/thot_tokenize -p ${pr_val} -f ${scorpus_test} \
         > ${outd}/${preproc_dir}/${srcbase}_${suff}.test 2>>${outd}/${preproc_dir}/thot_tokenize.log || exit 1
-    ${bindir}/thot_tokenize -f ${tcorpus_train} \
+    ${bindir}/thot_tokenize -p ${pr_val} -f ${tcorpus_train} \
         > ${outd}/${preproc_dir}/${trgbase}_${suff}.train 2>>${outd}/${preproc_dir}/thot_tokenize.log || exit 1
-    ${bindir}/thot_tokenize -f ${tcorpus_dev} \
+    ${bindir}/thot_tokenize -p ${pr_val} -f ${tcorpus_dev} \
         > ${outd}/${preproc_dir}/${trgbase}_${suff}.dev 2>>${outd}/${preproc_dir}/thot_tokenize.log || exit 1
-    ${bindir}/thot_tokenize -f ${tcorpus_test} \
+    ${bindir}/thot_tokenize -p ${pr_val} -f ${tcorpus_test} \
         > ${outd}/${preproc_dir}/${trgbase}_${suff}.test 2>>${outd}/${preproc_dir}/thot_tokenize.log || exit 1
     echo "" >&2
 
@@ -196,17 +196,17 @@ lowercase_corpus()
         suff="tok_lc"
     fi
 
-    ${bindir}/thot_lowercase -f ${scorpus_train} \
+    ${bindir}/thot_lowercase -p ${pr_val} -f ${scorpus_train} \
         > ${outd}/${preproc_dir}/${srcbase}_${suff}.train 2>${outd}/${preproc_dir}/thot_lowercase.log || exit 1
-    ${bindir}/thot_lowercase -f ${scorpus_dev} \
+    ${bindir}/thot_lowercase -p ${pr_val} -f ${scorpus_dev} \
         > ${outd}/${preproc_dir}/${srcbase}_${suff}.dev 2>>${outd}/${preproc_dir}/thot_lowercase.log || exit 1
-    ${bindir}/thot_lowercase -f ${scorpus_test} \
+    ${bindir}/thot_lowercase -p ${pr_val} -f ${scorpus_test} \
         > ${outd}/${preproc_dir}/${srcbase}_${suff}.test 2>>${outd}/${preproc_dir}/thot_lowercase.log || exit 1
-    ${bindir}/thot_lowercase -f ${tcorpus_train} \
+    ${bindir}/thot_lowercase -p ${pr_val} -f ${tcorpus_train} \
         > ${outd}/${preproc_dir}/${trgbase}_${suff}.train 2>>${outd}/${preproc_dir}/thot_lowercase.log || exit 1
-    ${bindir}/thot_lowercase -f ${tcorpus_dev} \
+    ${bindir}/thot_lowercase -p ${pr_val} -f ${tcorpus_dev} \
         > ${outd}/${preproc_dir}/${trgbase}_${suff}.dev 2>>${outd}/${preproc_dir}/thot_lowercase.log || exit 1
-    ${bindir}/thot_lowercase -f ${tcorpus_test} \
+    ${bindir}/thot_lowercase -p ${pr_val} -f ${tcorpus_test} \
         > ${outd}/${preproc_dir}/${trgbase}_${suff}.test 2>>${outd}/${preproc_dir}/thot_lowercase.log || exit 1
     echo "" >&2
 
@@ -257,7 +257,7 @@ estimate_ldb()
     remove_prev_ldb_files
     
     # Create leveldb model
-    cat ${thotlm_prefix} | ${bindir}/thot_ngram_to_leveldb -o $prefix 2> ${prefix}.ldb_err || return 1
+    cat ${thotlm_prefix} | ${bindir}/thot_ngram_to_leveldb -b -o $prefix 2> ${prefix}.ldb_err || return 1
 
     # Remove native thot language model files
     rm ${thotlm_prefix}*
@@ -600,11 +600,18 @@ loglin_upd()
 
     echo "NOTE: see file ${outd}/llweights_tune.log to track optimization progress" >&2
 
-    # Execute weight update algorithm
-    ${bindir}/thot_ll_weight_upd -pr ${pr_val} -va ${va_opt} \
-        -c ${outd}/tune_loglin.cfg -t $scorpus -r $tcorpus -i ${ll_wu_niters} \
-        ${qs_opt} "${qs_par}" -tdir $tdir -sdir $sdir ${debug_opt} \
-        > ${outd}/llweights_tune.out 2> ${outd}/llweights_tune.log || return 1
+    # Execute weight update algorithm (the models are kept loaded
+    # between iterations unless a PBS cluster is used)
+    if [ ${qs_given} -eq 0 ]; then
+        ${bindir}/thot_ll_weight_tune -nt ${pr_val} -va ${va_opt} \
+            -c ${outd}/tune_loglin.cfg -t $scorpus -r $tcorpus -i ${ll_wu_niters} \
+            > ${outd}/llweights_tune.out 2> ${outd}/llweights_tune.log || return 1
+    else
+        ${bindir}/thot_ll_weight_upd -pr ${pr_val} -va ${va_opt} \
+            -c ${outd}/tune_loglin.cfg -t $scorpus -r $tcorpus -i ${ll_wu_niters} \
+            ${qs_opt} "${qs_par}" -tdir $tdir -sdir $sdir ${debug_opt} \
+            > ${outd}/llweights_tune.out 2> ${outd}/llweights_tune.log || return 1
+    fi
 }
 
 ########
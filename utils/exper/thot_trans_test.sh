@@ -146,7 +146,7 @@ tok_corpus()
     suff="tok"
     filename=`add_suffix_to_name $basename $suff`
 
-    ${bindir}/thot_tokenize -f ${test_corpus} \
+    ${bindir}/thot_tokenize -p ${pr_val} -f ${test_corpus} \
         > ${thot_auto_smt_dir}/${preproc_dir}/${filename} 2>> ${thot_auto_smt_dir}/${preproc_dir}/thot_tokenize.log || exit 1
     echo "" >&2
 
@@ -164,7 +164,7 @@ lowercase_corpus()
     suff="lc"
     filename=`add_suffix_to_name $basename $suff`
 
-    ${bindir}/thot_lowercase -f ${test_corpus} \
+    ${bindir}/thot_lowercase -p ${pr_val} -f ${test_corpus} \
         > ${thot_auto_smt_dir}/${preproc_dir}/${filename} 2>> ${thot_auto_smt_dir}/${preproc_dir}/thot_lowercase.log || exit 1
     echo "" >&2
 
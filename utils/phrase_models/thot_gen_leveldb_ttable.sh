@@ -201,7 +201,7 @@ gen_leveldb_files()
         plain_ttable_to_id $srcv $trgv $table > $out.idttable
     fi
 
-    plain_ttable_to_id $srcv $trgv $table | ${bindir}/thot_ttable_to_leveldb -o ${out}_ldb_phrdict
+    plain_ttable_to_id $srcv $trgv $table | ${bindir}/thot_ttable_to_leveldb -b -o ${out}_ldb_phrdict
 }
 
 ########
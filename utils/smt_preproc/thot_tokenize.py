@@ -2,24 +2,36 @@
 # *- python -*
 
 # import modules
-import io, sys, getopt
+import io, sys, getopt, multiprocessing
 
 from thot_smt_preproc import tokenize
 
+# number of lines sent to each process at a time
+PROC_CHUNK_SIZE=1000
+
 ##################################################
 def print_help():
-    print >> sys.stderr, "thot_tokenize -f <string> [--help]"
+    print >> sys.stderr, "thot_tokenize -f <string> [-p <int>] [--help]"
     print >> sys.stderr, ""
     print >> sys.stderr, "-f <string>    File with text to be tokenized (can be read from stdin)"
+    print >> sys.stderr, "-p <int>       Number of processes (1 by default), the output keeps"
+    print >> sys.stderr, "               the order of the input lines"
     print >> sys.stderr, "--help         Print this help message"
 
+##################################################
+def tokenize_line(line):
+    line=line.strip("\n")
+    tokens = tokenize(line)
+    return u' '.join(tokens)
+
 ##################################################
 def main(argv):
     # take parameters
     f_given=False
     filename = ""
+    p_val=1
     try:
-        opts, args = getopt.getopt(sys.argv[1:],"hf:",["help","filename="])
+        opts, args = getopt.getopt(sys.argv[1:],"hf:p:",["help","filename=","processes="])
     except getopt.GetoptError:
         print_help()
         sys.exit(2)
@@ -30,10 +42,14 @@ def main(argv):
         elif opt in ("-f", "--filename"):
             filename = arg
             f_given=True
+        elif opt in ("-p", "--processes"):
+            p_val = int(arg)
 
     # print parameters
     if(f_given==True):
         print >> sys.stderr, "f is %s" % (filename)
+    if(p_val>1):
+        print >> sys.stderr, "p is %d" % (p_val)
 
     # open file
     if(f_given==True):
@@ -44,11 +60,18 @@ def main(argv):
         file = io.open(sys.stdin.fileno(), 'r', encoding='utf-8')
 
     # read file line by line
-    for line in file:
-        line=line.strip("\n")
-        tokens = tokenize(line)
-        tok_sent = u' '.join(tokens)
-        print tok_sent.encode("utf-8")
+    if(p_val>1):
+        # lines are processed in chunks by a pool of processes, imap
+        # returns the results in the order of the input
+        pool = multiprocessing.Pool(p_val)
+        for tok_sent in pool.imap(tokenize_line, file, PROC_CHUNK_SIZE):
+            print tok_sent.encode("utf-8")
+        pool.close()
+        pool.join()
+    else:
+        for line in file:
+            tok_sent = tokenize_line(line)
+            print tok_sent.encode("utf-8")
     file.close()
 
 if __name__ == "__main__":
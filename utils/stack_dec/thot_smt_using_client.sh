@@ -135,22 +135,37 @@ fi
 # parameters are ok
 
 # Translate corpus
-numSent=0
-while read -r s; do
-    numSent=`expr $numSent + 1`
-
-    if [ ${refs_given} -eq 1 ]; then
-        r=`head -${numSent} $reffile | tail -1`
-    fi
-
-    # Translate sentence
-    $bindir/thot_client -i $ip ${port_op} ${uid_op} -t "$s" || exit 1
-
-    if [ ${refs_given} -eq 1 ]; then
-        # train models after each translation
-        $bindir/thot_client -i $ip ${port_op} ${uid_op} -tr "$s" "$r" || exit 1
-    fi
-done < $testfile
+if [ ${refs_given} -eq 0 ]; then
+    # Translate the corpus using batch requests, the server does not
+    # accept requests with more than MAX_BATCH_SENTS sentences (see
+    # client_server_defs.h)
+    max_batch_sents=100000
+    numSents=`awk 'END{print NR}' ${testfile}`
+    first=1
+    while [ $first -le $numSents ]; do
+        last=`expr $first + $max_batch_sents - 1`
+        sed -n "${first},${last}p" ${testfile} | \
+            $bindir/thot_client -i $ip ${port_op} ${uid_op} -tb /dev/stdin || exit 1
+        first=`expr $last + 1`
+    done
+else
+    numSent=0
+    while read -r s; do
+        numSent=`expr $numSent + 1`
+
+        if [ ${refs_given} -eq 1 ]; then
+            r=`head -${numSent} $reffile | tail -1`
+        fi
+
+        # Translate sentence
+        $bindir/thot_client -i $ip ${port_op} ${uid_op} -t "$s" || exit 1
+
+        if [ ${refs_given} -eq 1 ]; then
+            # train models after each translation
+            $bindir/thot_client -i $ip ${port_op} ${uid_op} -tr "$s" "$r" || exit 1
+        fi
+    done < $testfile
+fi
 
 # Print server models if required
 if [ ${pm_given} -eq 1 ]; then